@@ -74,10 +74,12 @@ FreeMotionAnimationLoop::FreeMotionAnimationLoop() :
     , d_threadSafeVisitor(initData(&d_threadSafeVisitor, false, "threadSafeVisitor", "If true, do not use realloc and free visitors in fwdInteractionForceField."))
     , d_parallelCollisionDetectionAndFreeMotion(initData(&d_parallelCollisionDetectionAndFreeMotion, false, "parallelCollisionDetectionAndFreeMotion", "If true, executes free motion step and collision detection step in parallel."))
     , d_parallelODESolving(initData(&d_parallelODESolving, false, "parallelODESolving", "If true, solves all the ODEs in parallel during the free motion step."))
+    , d_parallelForceFields(initData(&d_parallelForceFields, false, "parallelForceFields", "If true, computes the force fields of a same node in parallel, each one accumulating in its own force vector."))
     , l_constraintSolver(initLink("constraintSolver", "The ConstraintSolver used in this animation loop (required)"))
 {
     d_parallelCollisionDetectionAndFreeMotion.setGroup("Multithreading");
     d_parallelODESolving.setGroup("Multithreading");
+    d_parallelForceFields.setGroup("Multithreading");
 
     m_solveVelocityConstraintFirst.setOriginalData(&d_solveVelocityConstraintFirst);
 }
@@ -132,7 +134,7 @@ void FreeMotionAnimationLoop::init()
 
     auto* taskScheduler = sofa::simulation::MainTaskSchedulerFactory::createInRegistry();
     assert(taskScheduler != nullptr);
-    if (d_parallelCollisionDetectionAndFreeMotion.getValue() || d_parallelODESolving.getValue())
+    if (d_parallelCollisionDetectionAndFreeMotion.getValue() || d_parallelODESolving.getValue() || d_parallelForceFields.getValue())
     {
         if (taskScheduler->getThreadCount() < 1)
         {
@@ -160,6 +162,11 @@ void FreeMotionAnimationLoop::step(const sofa::core::ExecParams* params, SReal d
     
     double startTime = node->getTime();
 
+    // the parameters given to the visitors of the step request the parallel computation of the force fields
+    core::ExecParams stepParams(*params);
+    stepParams.setParallelForceFields(d_parallelForceFields.getValue());
+    params = &stepParams;
+
     simulation::common::VectorOperations vop(params, node);
     simulation::common::MechanicalOperations mop(params, getContext());
 
@@ -51,6 +51,7 @@ public:
     Data<bool> d_threadSafeVisitor; ///< If true, do not use realloc and free visitors in fwdInteractionForceField.
     Data<bool> d_parallelCollisionDetectionAndFreeMotion; ///< If true, executes free motion step and collision detection step in parallel.
     Data<bool> d_parallelODESolving; ///< If true, solves all the ODEs in parallel during the free motion step.
+    Data<bool> d_parallelForceFields; ///< If true, computes the force fields of a same node in parallel.
 
 protected:
     FreeMotionAnimationLoop();
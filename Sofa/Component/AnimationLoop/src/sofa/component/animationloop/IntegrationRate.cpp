@@ -0,0 +1,50 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/component/animationloop/IntegrationRate.h>
+
+#include <sofa/core/ObjectFactory.h>
+#include <algorithm>
+
+namespace sofa::component::animationloop
+{
+
+void registerIntegrationRate(sofa::core::ObjectFactory* factory)
+{
+    factory->registerObjects(core::ObjectRegistrationData("Rate at which the ODE solvers of a subtree are integrated by MultiStepAnimationLoop.")
+        .add< IntegrationRate >());
+}
+
+IntegrationRate::IntegrationRate()
+    : d_stepRatio(initData(&d_stepRatio, 1u, "stepRatio", "Number of integration steps of the animation loop per integration step of the subtree"))
+{
+}
+
+unsigned int IntegrationRate::getStepRatio(core::objectmodel::BaseContext* context)
+{
+    if (const IntegrationRate* rate = context->get<IntegrationRate>(core::objectmodel::BaseContext::SearchUp))
+    {
+        return std::max(rate->d_stepRatio.getValue(), 1u);
+    }
+    return 1;
+}
+
+} // namespace sofa::component::animationloop
@@ -0,0 +1,52 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+
+#include <sofa/component/animationloop/config.h>
+
+#include <sofa/core/objectmodel/BaseObject.h>
+
+namespace sofa::component::animationloop
+{
+
+/**
+ * Rate at which the ODE solvers of a subtree are integrated by MultiStepAnimationLoop.
+ *
+ * The ODE solvers of the node and of its descendants are integrated once every stepRatio integration steps of the
+ * animation loop, with a time step stepRatio times larger. The closest IntegrationRate among the ancestors of an ODE
+ * solver applies. The ODE solvers without IntegrationRate are integrated at each integration step.
+ */
+class SOFA_COMPONENT_ANIMATIONLOOP_API IntegrationRate : public core::objectmodel::BaseObject
+{
+public:
+    SOFA_CLASS(IntegrationRate, core::objectmodel::BaseObject);
+
+    Data<unsigned int> d_stepRatio; ///< Number of integration steps of the animation loop per integration step of the subtree
+
+    /// Rate of the ODE solvers in a context: the step ratio of the closest IntegrationRate, 1 if there is none
+    static unsigned int getStepRatio(core::objectmodel::BaseContext* context);
+
+protected:
+    IntegrationRate();
+};
+
+} // namespace sofa::component::animationloop
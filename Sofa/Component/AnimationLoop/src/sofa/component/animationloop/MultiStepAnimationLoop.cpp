@@ -20,8 +20,12 @@
 * Contact information: contact@sofa-framework.org                             *
 ******************************************************************************/
 #include <sofa/component/animationloop/MultiStepAnimationLoop.h>
+#include <sofa/component/animationloop/IntegrationRate.h>
 
 #include <sofa/core/visual/VisualParams.h>
+#include <sofa/core/behavior/OdeSolver.h>
+#include <sofa/core/ConstraintParams.h>
+#include <sofa/core/MechanicalParams.h>
 #include <sofa/core/ObjectFactory.h>
 #include <sofa/simulation/MechanicalVisitor.h>
 #include <sofa/simulation/AnimateBeginEvent.h>
@@ -33,11 +37,40 @@
 #include <sofa/simulation/UpdateInternalDataVisitor.h>
 #include <sofa/simulation/UpdateContextVisitor.h>
 #include <sofa/simulation/UpdateMappingVisitor.h>
+#include <sofa/simulation/IntegrateBeginEvent.h>
+#include <sofa/simulation/IntegrateEndEvent.h>
+#include <sofa/simulation/MainTaskSchedulerFactory.h>
+#include <sofa/simulation/ParallelForEach.h>
+#include <sofa/simulation/TaskScheduler.h>
 #include <sofa/helper/ScopedAdvancedTimer.h>
 
 #include <sofa/simulation/mechanicalvisitor/MechanicalResetConstraintVisitor.h>
 using sofa::simulation::mechanicalvisitor::MechanicalResetConstraintVisitor;
 
+#include <sofa/simulation/mechanicalvisitor/MechanicalIntegrationVisitor.h>
+using sofa::simulation::mechanicalvisitor::MechanicalIntegrationVisitor;
+
+#include <sofa/simulation/mechanicalvisitor/MechanicalVOpVisitor.h>
+using sofa::simulation::mechanicalvisitor::MechanicalVOpVisitor;
+
+#include <sofa/simulation/mechanicalvisitor/MechanicalBeginIntegrationVisitor.h>
+using sofa::simulation::mechanicalvisitor::MechanicalBeginIntegrationVisitor;
+
+#include <sofa/simulation/mechanicalvisitor/MechanicalEndIntegrationVisitor.h>
+using sofa::simulation::mechanicalvisitor::MechanicalEndIntegrationVisitor;
+
+#include <sofa/simulation/mechanicalvisitor/MechanicalBuildConstraintMatrix.h>
+using sofa::simulation::mechanicalvisitor::MechanicalBuildConstraintMatrix;
+
+#include <sofa/simulation/mechanicalvisitor/MechanicalAccumulateMatrixDeriv.h>
+using sofa::simulation::mechanicalvisitor::MechanicalAccumulateMatrixDeriv;
+
+#include <sofa/simulation/mechanicalvisitor/MechanicalProjectPositionAndVelocityVisitor.h>
+using sofa::simulation::mechanicalvisitor::MechanicalProjectPositionAndVelocityVisitor;
+
+#include <sofa/simulation/mechanicalvisitor/MechanicalPropagateOnlyPositionAndVelocityVisitor.h>
+using sofa::simulation::mechanicalvisitor::MechanicalPropagateOnlyPositionAndVelocityVisitor;
+
 using namespace sofa::simulation;
 
 namespace sofa::component::animationloop
@@ -52,15 +85,187 @@ void registerMultiStepAnimationLoop(sofa::core::ObjectFactory* factory)
 MultiStepAnimationLoop::MultiStepAnimationLoop() :
       d_collisionSteps( initData(&d_collisionSteps,1,"collisionSteps", "number of collision steps between each frame rendering") )
     , d_integrationSteps( initData(&d_integrationSteps,1,"integrationSteps", "number of integration steps between each collision detection") )
+    , d_parallelODESolving(initData(&d_parallelODESolving, false, "parallelODESolving", "If true, the subtrees integrated at the same step are solved in parallel"))
 {
     collisionSteps.setOriginalData(&d_collisionSteps);
     integrationSteps.setOriginalData(&d_integrationSteps);
+
+    d_parallelODESolving.setGroup("Multithreading");
 }
 
 MultiStepAnimationLoop::~MultiStepAnimationLoop()
 {
 }
 
+void MultiStepAnimationLoop::init()
+{
+    Inherit::init();
+
+    if (d_parallelODESolving.getValue())
+    {
+        auto* taskScheduler = sofa::simulation::MainTaskSchedulerFactory::createInRegistry();
+        assert(taskScheduler != nullptr);
+        if (taskScheduler->getThreadCount() < 1)
+        {
+            taskScheduler->init(0);
+            msg_info() << "Task scheduler initialized on " << taskScheduler->getThreadCount() << " threads";
+        }
+    }
+}
+
+void MultiStepAnimationLoop::bwdInit()
+{
+    Inherit::bwdInit();
+
+    // the IntegrationRate components are searched once, the subtrees being initialized before the root
+    m_hasIntegrationRates = getContext()->get<IntegrationRate>(core::objectmodel::BaseContext::SearchDown) != nullptr;
+}
+
+void MultiStepAnimationLoop::reset()
+{
+    Inherit::reset();
+    m_subtreeSteps.clear();
+}
+
+namespace
+{
+
+/// Compute the interaction forces between the subtrees of the ODE solvers, and collect the ODE solvers instead of
+/// integrating them
+class CollectOdeSolversVisitor : public MechanicalIntegrationVisitor
+{
+public:
+    CollectOdeSolversVisitor(const sofa::core::ExecParams* params, SReal dt, sofa::type::vector<std::pair<Node*, core::behavior::OdeSolver*> >& odeSolvers)
+        : MechanicalIntegrationVisitor(params, dt)
+        , m_odeSolvers(odeSolvers)
+    {}
+
+    Result fwdOdeSolver(Node* node, core::behavior::OdeSolver* solver) override
+    {
+        m_odeSolvers.emplace_back(node, solver);
+        return RESULT_PRUNE;
+    }
+
+    const char* getClassName() const override { return "CollectOdeSolversVisitor"; }
+
+protected:
+    sofa::type::vector<std::pair<Node*, core::behavior::OdeSolver*> >& m_odeSolvers;
+};
+
+}
+
+void MultiStepAnimationLoop::integrate(const core::ExecParams* params, SReal dt)
+{
+    if (!d_parallelODESolving.getValue() && !m_hasIntegrationRates)
+    {
+        Inherit::integrate(params, dt);
+        return;
+    }
+
+    {
+        IntegrateBeginEvent evBegin;
+        PropagateEventVisitor eventPropagation( params, &evBegin);
+        eventPropagation.execute(getContext());
+    }
+
+    // The interaction forces between the subtrees are accumulated in their external forces, which are cleared at
+    // the end of their integration. A subtree waiting for its step keeps accumulating them.
+    sofa::type::vector<std::pair<Node*, core::behavior::OdeSolver*> > odeSolvers;
+    {
+        CollectOdeSolversVisitor collectOdeSolvers(params, dt, odeSolvers);
+        collectOdeSolvers.setTags(this->getTags());
+        collectOdeSolvers.execute(getContext());
+    }
+
+    // the counts of the nodes removed from the graph are dropped, so that a new node cannot inherit them
+    m_odeSolverSteps.clear();
+    m_nextSubtreeSteps.clear();
+    for (const auto& [node, solver] : odeSolvers)
+    {
+        SubtreeSteps subtreeSteps;
+        const auto it = m_subtreeSteps.find(node);
+        if (it != m_subtreeSteps.end())
+        {
+            subtreeSteps = it->second;
+        }
+        else
+        {
+            subtreeSteps.stepRatio = IntegrationRate::getStepRatio(node);
+        }
+
+        ++subtreeSteps.nbPendingSteps;
+        if (subtreeSteps.nbPendingSteps >= subtreeSteps.stepRatio)
+        {
+            m_odeSolverSteps.push_back({node, solver, subtreeSteps.nbPendingSteps});
+            subtreeSteps.nbPendingSteps = 0;
+        }
+        m_nextSubtreeSteps[node] = subtreeSteps;
+    }
+    std::swap(m_subtreeSteps, m_nextSubtreeSteps);
+
+    const simulation::ForEachExecutionPolicy execution = d_parallelODESolving.getValue() ?
+        simulation::ForEachExecutionPolicy::PARALLEL :
+        simulation::ForEachExecutionPolicy::SEQUENTIAL;
+
+    auto* taskScheduler = sofa::simulation::MainTaskSchedulerFactory::createInRegistry();
+    assert(taskScheduler != nullptr);
+
+    simulation::forEach(execution, *taskScheduler, m_odeSolverSteps.begin(), m_odeSolverSteps.end(),
+        [this, params, dt](const OdeSolverStep& odeSolverStep)
+        {
+            integrateOdeSolver(params, odeSolverStep, dt);
+        });
+
+    {
+        IntegrateEndEvent evEnd;
+        PropagateEventVisitor eventPropagation( params, &evEnd);
+        eventPropagation.execute(getContext());
+    }
+}
+
+void MultiStepAnimationLoop::integrateOdeSolver(const core::ExecParams* params, const OdeSolverStep& odeSolverStep, SReal dt)
+{
+    Node* node = odeSolverStep.node;
+
+    // the step of the subtree started nbSteps steps of the loop ago, and ends with the current step of the loop
+    const SReal subtreeDt = dt * odeSolverStep.nbSteps;
+    const SReal nextTime = node->getTime() + dt;
+
+    if (odeSolverStep.nbSteps > 1)
+    {
+        // the interaction forces are averaged over the step of the subtree
+        MechanicalVOpVisitor(params, core::vec_id::write_access::externalForce, core::ConstVecId::null(),
+            core::vec_id::read_access::externalForce, 1_sreal / odeSolverStep.nbSteps).setMapped(true).execute(node);
+    }
+
+    MechanicalBeginIntegrationVisitor beginVisitor(params, subtreeDt);
+    node->execute(&beginVisitor);
+
+    sofa::core::MechanicalParams mparams(*params);
+    mparams.setDt(subtreeDt);
+
+    core::ConstraintParams cparams;
+    {
+        unsigned int constraintId = 0;
+        MechanicalBuildConstraintMatrix buildConstraintMatrix(&cparams, core::vec_id::write_access::constraintJacobian, constraintId);
+        buildConstraintMatrix.execute(node);
+    }
+
+    {
+        MechanicalAccumulateMatrixDeriv accumulateMatrixDeriv(&cparams, core::vec_id::write_access::constraintJacobian);
+        accumulateMatrixDeriv.execute(node);
+    }
+
+    odeSolverStep.solver->solve(params, subtreeDt);
+
+    MechanicalProjectPositionAndVelocityVisitor(&mparams, nextTime, core::vec_id::write_access::position, core::vec_id::write_access::velocity).execute(node);
+
+    MechanicalPropagateOnlyPositionAndVelocityVisitor(&mparams, nextTime, core::vec_id::write_access::position, core::vec_id::write_access::velocity).execute(node);
+
+    MechanicalEndIntegrationVisitor endVisitor(params, subtreeDt);
+    node->execute(&endVisitor);
+}
+
 void MultiStepAnimationLoop::step(const sofa::core::ExecParams* params, SReal dt)
 {
     auto node = dynamic_cast<sofa::simulation::Node*>(this->l_node.get());
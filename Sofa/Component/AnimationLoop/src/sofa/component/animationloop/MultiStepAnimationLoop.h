@@ -26,10 +26,25 @@
 #include <sofa/core/behavior/BaseAnimationLoop.h>
 #include <sofa/simulation/CollisionAnimationLoop.h>
 #include <sofa/core/objectmodel/lifecycle/RenamedData.h>
+#include <sofa/type/vector.h>
+#include <unordered_map>
+
+namespace sofa::core::behavior
+{
+    class OdeSolver;
+}
 
 namespace sofa::component::animationloop
 {
 
+/**
+ * Animation loop running several collision steps per animation step, and several integration steps per collision step.
+ *
+ * The subtrees can be integrated at different rates, declared with IntegrationRate components: a subtree whose step
+ * ratio is N is integrated once every N integration steps, with a time step N times larger. Between two of its steps,
+ * its state is held, and the interaction forces applied to it by the other subtrees are accumulated. They are
+ * averaged over its step when it is integrated.
+ */
 class SOFA_COMPONENT_ANIMATIONLOOP_API MultiStepAnimationLoop : public sofa::simulation::CollisionAnimationLoop
 {
 public:
@@ -40,8 +55,15 @@ protected:
 
     ~MultiStepAnimationLoop() override;
 public:
+    void init() override;
+    void bwdInit() override;
+    void reset() override;
+
     void step (const sofa::core::ExecParams* params, SReal dt) override;
 
+    /// Integrate the subtrees whose step is over, at the rates of their IntegrationRate
+    void integrate(const core::ExecParams* params, SReal dt) override;
+
     SOFA_ATTRIBUTE_DEPRECATED__RENAME_DATA_IN_ANIMATIONLOOP()
     sofa::core::objectmodel::lifecycle::RenamedData<int> collisionSteps;
 
@@ -50,6 +72,37 @@ public:
 
     Data<int> d_collisionSteps; ///< number of collision steps between each frame rendering
     Data<int> d_integrationSteps; ///< number of integration steps between each collision detection
+    Data<bool> d_parallelODESolving; ///< If true, the subtrees integrated at the same step are solved in parallel
+
+protected:
+    /// An ODE solver whose subtree is integrated in the current integration step
+    struct OdeSolverStep
+    {
+        simulation::Node* node { nullptr };
+        core::behavior::OdeSolver* solver { nullptr };
+        unsigned int nbSteps { 1 }; ///< number of integration steps of the loop covered by the step of the subtree
+    };
+
+    /// Integrate the subtree of an ODE solver, ending at the end of the current integration step of the loop
+    void integrateOdeSolver(const core::ExecParams* params, const OdeSolverStep& odeSolverStep, SReal dt);
+
+    /// Progress of the step of the subtree of an ODE solver
+    struct SubtreeSteps
+    {
+        unsigned int nbPendingSteps { 0 }; ///< number of integration steps of the loop since the last integration of the subtree
+        unsigned int stepRatio { 1 }; ///< step ratio of the IntegrationRate of the subtree
+    };
+
+    /// Progress of the subtree of each ODE solver. Only the nodes whose ODE solver was collected in the last
+    /// integration step are kept. The step ratio is searched when the ODE solver is first collected, and again
+    /// after a reset.
+    std::unordered_map<simulation::Node*, SubtreeSteps> m_subtreeSteps;
+    std::unordered_map<simulation::Node*, SubtreeSteps> m_nextSubtreeSteps;
+
+    /// True if an IntegrationRate was found in the scene at initialization
+    bool m_hasIntegrationRates { false };
+
+    sofa::type::vector<OdeSolverStep> m_odeSolverSteps;
 };
 
 } // namespace sofa::component::animationloop
@@ -28,6 +28,7 @@ namespace sofa::component::animationloop
 
 extern void registerConstraintAnimationLoop(sofa::core::ObjectFactory* factory);
 extern void registerFreeMotionAnimationLoop(sofa::core::ObjectFactory* factory);
+extern void registerIntegrationRate(sofa::core::ObjectFactory* factory);
 extern void registerMultiStepAnimationLoop(sofa::core::ObjectFactory* factory);
 extern void registerMultiTagAnimationLoop(sofa::core::ObjectFactory* factory);
 
@@ -57,6 +58,7 @@ void registerObjects(sofa::core::ObjectFactory* factory)
 {
     registerConstraintAnimationLoop(factory);
     registerFreeMotionAnimationLoop(factory);
+    registerIntegrationRate(factory);
     registerMultiStepAnimationLoop(factory);
     registerMultiTagAnimationLoop(factory);
 }
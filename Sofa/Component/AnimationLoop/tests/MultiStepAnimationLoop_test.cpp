@@ -0,0 +1,296 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/testing/BaseSimulationTest.h>
+using sofa::testing::BaseSimulationTest;
+
+#include <sofa/component/animationloop/IntegrationRate.h>
+#include <sofa/component/animationloop/MultiStepAnimationLoop.h>
+#include <sofa/component/solidmechanics/spring/SpringForceField.h>
+#include <sofa/component/statecontainer/MechanicalObject.h>
+#include <sofa/core/behavior/OdeSolver.h>
+#include <sofa/defaulttype/VecTypes.h>
+#include <sofa/simulation/Node.h>
+#include <sofa/simulation/Simulation.h>
+#include <sofa/testing/ScopedTaskScheduler.h>
+
+#include <optional>
+
+namespace
+{
+
+using namespace sofa;
+using sofa::component::animationloop::IntegrationRate;
+using sofa::component::animationloop::MultiStepAnimationLoop;
+
+using MechanicalObject = component::statecontainer::MechanicalObject<defaulttype::Vec3Types>;
+using SpringForceField = component::solidmechanics::spring::SpringForceField<defaulttype::Vec3Types>;
+using Coord = defaulttype::Vec3Types::Coord;
+using Deriv = defaulttype::Vec3Types::Deriv;
+
+/// Explicit Euler integration of a constant acceleration and of the external forces on unit masses, recording the
+/// time steps it is called with and the external force on the first particle
+class ConstantAccelerationSolver : public core::behavior::OdeSolver
+{
+public:
+    SOFA_CLASS(ConstantAccelerationSolver, core::behavior::OdeSolver);
+
+    static constexpr SReal acceleration = -9.81;
+    std::vector<SReal> timeSteps;
+    std::vector<Deriv> externalForces;
+
+    void solve(const core::ExecParams* /*params*/, SReal dt, core::MultiVecCoordId /*xResult*/, core::MultiVecDerivId /*vResult*/) override
+    {
+        timeSteps.push_back(dt);
+
+        auto* state = dynamic_cast<MechanicalObject*>(getContext()->getMechanicalState());
+        auto x = sofa::helper::getWriteAccessor(*state->write(core::vec_id::write_access::position));
+        auto v = sofa::helper::getWriteAccessor(*state->write(core::vec_id::write_access::velocity));
+        const auto& f = state->read(core::vec_id::read_access::externalForce)->getValue();
+        externalForces.push_back(f.empty() ? Deriv() : f[0]);
+        for (std::size_t i = 0; i < x.size(); ++i)
+        {
+            v[i][1] += dt * acceleration;
+            if (i < f.size())
+            {
+                v[i] += f[i] * dt;
+            }
+            x[i] += v[i] * dt;
+        }
+    }
+};
+
+/// Two subtrees, each with its own ODE solver, integrated by a MultiStepAnimationLoop
+struct MultiStepAnimationLoop_test : public BaseSimulationTest
+{
+    static constexpr SReal dt = 0.01;
+
+    struct Subtree
+    {
+        ConstantAccelerationSolver::SPtr solver;
+        MechanicalObject::SPtr state;
+    };
+
+    simulation::Node::SPtr m_root;
+    Subtree m_fast;
+    Subtree m_slow;
+    std::optional<sofa::testing::ScopedTaskScheduler> m_taskScheduler;
+
+    /// @param slowStepRatio step ratio of the IntegrationRate of the slow subtree, 0 for no IntegrationRate
+    /// @param springStiffness stiffness of a spring between the two subtrees, 0 for no spring
+    void createScene(unsigned int slowStepRatio, bool parallelODESolving, SReal springStiffness = 0)
+    {
+        if (parallelODESolving)
+        {
+            // at least two threads, whatever the number of cores of the machine
+            m_taskScheduler.emplace(2);
+        }
+
+        m_root = simulation::getSimulation()->createNewGraph("root");
+        m_root->setDt(dt);
+
+        const auto loop = core::objectmodel::New<MultiStepAnimationLoop>();
+        loop->d_parallelODESolving.setValue(parallelODESolving);
+        m_root->addObject(loop);
+
+        m_fast = createSubtree("fast", Coord(0, 0, 0));
+        m_slow = createSubtree("slow", Coord(1, 0, 0));
+        if (slowStepRatio > 0)
+        {
+            const auto rate = core::objectmodel::New<IntegrationRate>();
+            rate->d_stepRatio.setValue(slowStepRatio);
+            m_slow.state->getContext()->addObject(rate);
+        }
+        if (springStiffness > 0)
+        {
+            // the spring is stretched, and not damped so that its force only depends on the positions
+            const auto spring = core::objectmodel::New<SpringForceField>(m_fast.state.get(), m_slow.state.get());
+            spring->addSpring(0, 0, springStiffness, 0, 0.5);
+            m_root->addObject(spring);
+        }
+
+        simulation::node::initRoot(m_root.get());
+    }
+
+    Subtree createSubtree(const std::string& name, const Coord& position)
+    {
+        const simulation::Node::SPtr node = m_root->createChild(name);
+        Subtree subtree { core::objectmodel::New<ConstantAccelerationSolver>(), core::objectmodel::New<MechanicalObject>() };
+        node->addObject(subtree.solver);
+        node->addObject(subtree.state);
+
+        subtree.state->resize(1);
+        sofa::helper::getWriteAccessor(*subtree.state->write(core::vec_id::write_access::position))[0] = position;
+        sofa::helper::getWriteAccessor(*subtree.state->write(core::vec_id::write_access::velocity))[0] = Coord(0, 1, 0);
+        return subtree;
+    }
+
+    static Coord getPosition(const Subtree& subtree)
+    {
+        return subtree.state->read(core::vec_id::read_access::position)->getValue()[0];
+    }
+
+    void doTearDown() override
+    {
+        if (m_root)
+        {
+            sofa::simulation::node::unload(m_root);
+        }
+    }
+
+    /// The slow subtree is integrated once every 4 steps, with a time step of 4*dt, and its state is held in between
+    void subtreeIntegratedAtItsRate(bool parallelODESolving)
+    {
+        constexpr unsigned int ratio = 4;
+        createScene(ratio, parallelODESolving);
+
+        Coord slowPosition = getPosition(m_slow);
+        SReal slowVelocity = 1;
+        for (unsigned int step = 1; step <= 2 * ratio; ++step)
+        {
+            sofa::simulation::node::animate(m_root.get(), dt);
+
+            ASSERT_EQ(m_fast.solver->timeSteps.size(), step);
+            EXPECT_DOUBLE_EQ(m_fast.solver->timeSteps.back(), dt);
+
+            ASSERT_EQ(m_slow.solver->timeSteps.size(), step / ratio);
+            if (step % ratio == 0)
+            {
+                EXPECT_DOUBLE_EQ(m_slow.solver->timeSteps.back(), ratio * dt);
+                slowVelocity += ratio * dt * ConstantAccelerationSolver::acceleration;
+                slowPosition[1] += ratio * dt * slowVelocity;
+            }
+            EXPECT_NEAR(getPosition(m_slow)[1], slowPosition[1], 1e-12) << "step " << step;
+        }
+        EXPECT_NEAR(m_root->getTime(), 2 * ratio * dt, 1e-12);
+    }
+
+    /// The slow subtree is integrated with the spring force averaged over its step, so that it receives the impulse
+    /// the fast subtree received from the spring, in the opposite direction
+    void interactionForceAveraged(bool parallelODESolving)
+    {
+        constexpr unsigned int ratio = 4;
+        createScene(ratio, parallelODESolving, 10);
+
+        for (unsigned int step = 1; step <= 3 * ratio; ++step)
+        {
+            sofa::simulation::node::animate(m_root.get(), dt);
+        }
+        ASSERT_EQ(m_fast.solver->externalForces.size(), 3 * ratio);
+        ASSERT_EQ(m_slow.solver->externalForces.size(), 3);
+
+        for (unsigned int slowStep = 0; slowStep < 3; ++slowStep)
+        {
+            Deriv fastImpulse;
+            for (unsigned int step = slowStep * ratio; step < (slowStep + 1) * ratio; ++step)
+            {
+                fastImpulse += m_fast.solver->externalForces[step] * dt;
+            }
+            // the fast subtree moves between the steps of the slow one, which changes the spring force
+            EXPECT_NE(m_fast.solver->externalForces[slowStep * ratio], m_fast.solver->externalForces[(slowStep + 1) * ratio - 1]);
+            EXPECT_GT(fastImpulse.norm(), 0);
+
+            const Deriv slowImpulse = m_slow.solver->externalForces[slowStep] * (ratio * dt);
+            for (int i = 0; i < 3; ++i)
+            {
+                EXPECT_NEAR(slowImpulse[i], -fastImpulse[i], 1e-12) << "step " << slowStep << ", axis " << i;
+            }
+        }
+    }
+
+    /// The step ratio is searched when the ODE solver is first collected: a new ratio applies after a reset
+    void stepRatioUpdatedAfterReset()
+    {
+        createScene(4, false);
+        auto* rate = m_slow.state->getContext()->get<IntegrationRate>();
+        ASSERT_NE(rate, nullptr);
+
+        for (unsigned int step = 0; step < 4; ++step)
+        {
+            sofa::simulation::node::animate(m_root.get(), dt);
+        }
+        ASSERT_EQ(m_slow.solver->timeSteps.size(), 1u);
+
+        rate->d_stepRatio.setValue(2);
+        sofa::simulation::node::animate(m_root.get(), dt);
+        sofa::simulation::node::animate(m_root.get(), dt);
+        EXPECT_EQ(m_slow.solver->timeSteps.size(), 1u);
+
+        sofa::simulation::node::reset(m_root.get());
+        sofa::simulation::node::animate(m_root.get(), dt);
+        sofa::simulation::node::animate(m_root.get(), dt);
+        ASSERT_EQ(m_slow.solver->timeSteps.size(), 2u);
+        EXPECT_DOUBLE_EQ(m_slow.solver->timeSteps.back(), 2 * dt);
+    }
+
+    /// Positions of the subtrees after a few steps
+    std::pair<Coord, Coord> simulate(unsigned int slowStepRatio, bool parallelODESolving)
+    {
+        createScene(slowStepRatio, parallelODESolving);
+        for (unsigned int step = 0; step < 10; ++step)
+        {
+            sofa::simulation::node::animate(m_root.get(), dt);
+        }
+        const std::pair<Coord, Coord> positions { getPosition(m_fast), getPosition(m_slow) };
+        sofa::simulation::node::unload(m_root);
+        m_root.reset();
+        return positions;
+    }
+};
+
+TEST_F(MultiStepAnimationLoop_test, subtreeIntegratedAtItsRate)
+{
+    subtreeIntegratedAtItsRate(false);
+}
+
+TEST_F(MultiStepAnimationLoop_test, subtreeIntegratedAtItsRateInParallel)
+{
+    subtreeIntegratedAtItsRate(true);
+}
+
+TEST_F(MultiStepAnimationLoop_test, interactionForceAveraged)
+{
+    interactionForceAveraged(false);
+}
+
+TEST_F(MultiStepAnimationLoop_test, interactionForceAveragedInParallel)
+{
+    interactionForceAveraged(true);
+}
+
+TEST_F(MultiStepAnimationLoop_test, stepRatioUpdatedAfterReset)
+{
+    stepRatioUpdatedAfterReset();
+}
+
+/// Without IntegrationRate and parallel solving, the loop integrates the scene as CollisionAnimationLoop does.
+/// A step ratio of 1 and the parallel solving give the same positions.
+TEST_F(MultiStepAnimationLoop_test, sameAsDefaultIntegration)
+{
+    const auto defaultPositions = simulate(0, false);
+    EXPECT_NE(defaultPositions.first, Coord(0, 0, 0));
+
+    EXPECT_EQ(simulate(1, false), defaultPositions);
+    EXPECT_EQ(simulate(0, true), defaultPositions);
+    EXPECT_EQ(simulate(1, true), defaultPositions);
+}
+
+}
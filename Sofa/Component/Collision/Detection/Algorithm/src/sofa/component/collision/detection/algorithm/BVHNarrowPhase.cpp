@@ -92,6 +92,11 @@ void BVHNarrowPhase::addCollisionPair(const std::pair<core::CollisionModel*, cor
     cm1 = nullptr; // force later init of intersector
     cm2 = nullptr;
 
+    // The final pairs are intersected by batches. The memory of the pairs is kept from a call to another.
+    // A buffer per thread is used, as the pairs of collision models can be processed in parallel.
+    thread_local core::collision::ElementIntersector::ElementPairs finalPairsBuffer;
+    FinalPairs finalPairs(finalPairsBuffer, outputs, intersectionMethod);
+
     while (!externalCells.empty())
     {
         TestPair root = externalCells.front();
@@ -101,8 +106,10 @@ void BVHNarrowPhase::addCollisionPair(const std::pair<core::CollisionModel*, cor
                             cm1, cm2,
                             intersector,
                             {finestCollisionModel1, finestCollisionModel2, finestIntersector, selfCollision},
-                            &mirror, externalCells, outputs);
+                            &mirror, externalCells, finalPairs);
     }
+
+    finalPairs.flush();
 }
 
 void BVHNarrowPhase::initializeExternalCells(
@@ -139,12 +146,15 @@ void BVHNarrowPhase::processExternalCell(const TestPair &externalCell,
                                               const FinestCollision &finest,
                                               MirrorIntersector *mirror,
                                               std::queue<TestPair> &externalCells,
-                                              sofa::core::collision::DetectionOutputVector *&outputs) const
+                                              FinalPairs &finalPairs) const
 {
     const auto [collisionModel1, collisionModel2] = getCollisionModelsFromTestPair(externalCell);
 
     if (cm1 != collisionModel1 || cm2 != collisionModel2)//if the CollisionElements do not belong to cm1 and cm2, update cm1 and cm2
     {
+        // the accumulated pairs may use the mirror intersector, which is about to change
+        finalPairs.flush();
+
         cm1 = collisionModel1;
         cm2 = collisionModel2;
         if (!cm1 || !cm2) return;
@@ -176,7 +186,7 @@ void BVHNarrowPhase::processExternalCell(const TestPair &externalCell,
         TestPair current = internalCells.top();
         internalCells.pop();
 
-        processInternalCell(current, coarseIntersector, finest, externalCells, internalCells, outputs, intersectionMethod);
+        processInternalCell(current, coarseIntersector, finest, externalCells, internalCells, finalPairs, intersectionMethod);
     }
 }
 
@@ -185,7 +195,7 @@ void BVHNarrowPhase::processInternalCell(const TestPair &internalCell,
                                          const FinestCollision &finest,
                                          std::queue<TestPair> &externalCells,
                                          std::stack<TestPair> &internalCells,
-                                         sofa::core::collision::DetectionOutputVector *&outputs,
+                                         FinalPairs &finalPairs,
                                          const sofa::core::collision::Intersection* currentIntersection)
 {
     const auto [collisionModel1, collisionModel2] = getCollisionModelsFromTestPair(internalCell);
@@ -193,11 +203,11 @@ void BVHNarrowPhase::processInternalCell(const TestPair &internalCell,
     if (collisionModel1 == finest.cm1 && collisionModel2 == finest.cm2) //the collision models are the finest ones
     {
         // Final collision pairs
-        finalCollisionPairs(internalCell, finest.selfCollision, coarseIntersector, outputs, currentIntersection);
+        finalCollisionPairs(internalCell, finest.selfCollision, coarseIntersector, finalPairs);
     }
     else
     {
-        visitCollisionElements(internalCell, coarseIntersector, finest, externalCells, internalCells, outputs, currentIntersection);
+        visitCollisionElements(internalCell, coarseIntersector, finest, externalCells, internalCells, finalPairs, currentIntersection);
     }
 }
 
@@ -206,7 +216,7 @@ void BVHNarrowPhase::visitCollisionElements(const TestPair &root,
                                             const FinestCollision &finest,
                                             std::queue<TestPair> &externalCells,
                                             std::stack<TestPair> &internalCells,
-                                            sofa::core::collision::DetectionOutputVector *&outputs,
+                                            FinalPairs &finalPairs,
                                             const sofa::core::collision::Intersection* currentIntersection)
 {
     const core::CollisionElementIterator begin1 = root.first.first;
@@ -253,7 +263,7 @@ void BVHNarrowPhase::visitCollisionElements(const TestPair &root,
                     {
                         // end of both internal tree of elements.
                         // need to test external children
-                        visitExternalChildren(it1, it2, coarseIntersector, finest, externalCells, outputs, currentIntersection);
+                        visitExternalChildren(it1, it2, coarseIntersector, finest, externalCells, finalPairs);
                     }
                 }
             }
@@ -266,8 +276,7 @@ void BVHNarrowPhase::visitExternalChildren(const core::CollisionElementIterator
                                            core::collision::ElementIntersector *coarseIntersector,
                                            const FinestCollision &finest,
                                            std::queue<TestPair> &externalCells,
-                                           sofa::core::collision::DetectionOutputVector *&outputs,
-                                           const sofa::core::collision::Intersection* currentIntersection)
+                                           FinalPairs &finalPairs)
 {
     const TestPair externalChildren(it1.getExternalChildren(), it2.getExternalChildren());
 
@@ -281,7 +290,7 @@ void BVHNarrowPhase::visitExternalChildren(const core::CollisionElementIterator
             const auto [collisionModel1, collisionModel2] = getCollisionModelsFromTestPair(externalChildren);
             if (collisionModel1 == finest.cm1 && collisionModel2 == finest.cm2) //the collision models are the finest ones
             {
-                finalCollisionPairs(externalChildren, finest.selfCollision, finest.intersector, outputs, currentIntersection);
+                finalCollisionPairs(externalChildren, finest.selfCollision, finest.intersector, finalPairs);
             }
             else
             {
@@ -305,15 +314,14 @@ void BVHNarrowPhase::visitExternalChildren(const core::CollisionElementIterator
     {
         // No child -> final collision pair
         if (!finest.selfCollision || it1.canCollideWith(it2))
-            coarseIntersector->intersect(it1, it2, outputs, currentIntersection);
+            finalPairs.add(coarseIntersector, it1, it2);
     }
 }
 
 void BVHNarrowPhase::finalCollisionPairs(const TestPair& pair,
                                          bool selfCollision,
                                          core::collision::ElementIntersector* intersector,
-                                         sofa::core::collision::DetectionOutputVector*& outputs,
-                                         const sofa::core::collision::Intersection* currentIntersection)
+                                         FinalPairs& finalPairs)
 {
     const core::CollisionElementIterator begin1 = pair.first.first;
     const core::CollisionElementIterator end1 = pair.first.second;
@@ -326,11 +334,43 @@ void BVHNarrowPhase::finalCollisionPairs(const TestPair& pair,
         {
             // Final collision pair
             if (!selfCollision || it1.canCollideWith(it2))
-                intersector->intersect(it1, it2, outputs, currentIntersection);
+                finalPairs.add(intersector, it1, it2);
         }
     }
 }
 
+BVHNarrowPhase::FinalPairs::FinalPairs(core::collision::ElementIntersector::ElementPairs& pairs,
+                                       sofa::core::collision::DetectionOutputVector* outputs,
+                                       const sofa::core::collision::Intersection* currentIntersection)
+    : m_pairs(pairs)
+    , m_outputs(outputs)
+    , m_currentIntersection(currentIntersection)
+{
+    m_pairs.clear();
+}
+
+void BVHNarrowPhase::FinalPairs::add(core::collision::ElementIntersector* intersector,
+                                     const core::CollisionElementIterator& it1, const core::CollisionElementIterator& it2)
+{
+    if (intersector != m_intersector || it1.getCollisionModel() != m_cm1 || it2.getCollisionModel() != m_cm2)
+    {
+        flush();
+        m_intersector = intersector;
+        m_cm1 = it1.getCollisionModel();
+        m_cm2 = it2.getCollisionModel();
+    }
+    m_pairs.emplace_back(it1.getIndex(), it2.getIndex());
+}
+
+void BVHNarrowPhase::FinalPairs::flush()
+{
+    if (!m_pairs.empty())
+    {
+        m_intersector->intersectPairs(m_cm1, m_cm2, m_pairs, m_outputs, m_currentIntersection);
+        m_pairs.clear();
+    }
+}
+
 std::pair<core::CollisionModel*, core::CollisionModel*> BVHNarrowPhase::getCollisionModelsFromTestPair(const TestPair& pair)
 {
     auto* collisionModel1 = pair.first.first.getCollisionModel(); //get the first collision model
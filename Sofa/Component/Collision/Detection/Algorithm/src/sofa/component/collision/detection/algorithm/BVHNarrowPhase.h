@@ -100,6 +100,31 @@ protected:
         bool selfCollision { false };
     };
 
+    /// Final pairs of elements, accumulated to be given together to their intersector (see ElementIntersector::intersectPairs)
+    class FinalPairs
+    {
+    public:
+        FinalPairs(core::collision::ElementIntersector::ElementPairs& pairs,
+                   sofa::core::collision::DetectionOutputVector* outputs,
+                   const sofa::core::collision::Intersection* currentIntersection);
+
+        /// Add a pair of elements to intersect. The accumulated pairs are intersected first if they
+        /// do not have the same intersector or the same collision models
+        void add(core::collision::ElementIntersector* intersector,
+                 const core::CollisionElementIterator& it1, const core::CollisionElementIterator& it2);
+
+        /// Compute the intersections of the accumulated pairs
+        void flush();
+
+    private:
+        core::collision::ElementIntersector::ElementPairs& m_pairs;
+        core::collision::ElementIntersector* m_intersector { nullptr };
+        core::CollisionModel* m_cm1 { nullptr };
+        core::CollisionModel* m_cm2 { nullptr };
+        sofa::core::collision::DetectionOutputVector* m_outputs { nullptr };
+        const sofa::core::collision::Intersection* m_currentIntersection { nullptr };
+    };
+
     void processExternalCell(const TestPair &externalCell,
                              core::CollisionModel *&cm1,
                              core::CollisionModel *&cm2,
@@ -107,7 +132,7 @@ protected:
                              const FinestCollision &finest,
                              MirrorIntersector *mirror,
                              std::queue<TestPair> &externalCells,
-                             sofa::core::collision::DetectionOutputVector *&outputs) const;
+                             FinalPairs &finalPairs) const;
 
     static void
     processInternalCell(const TestPair &internalCell,
@@ -115,7 +140,7 @@ protected:
                         const FinestCollision &finest,
                         std::queue<TestPair> &externalCells,
                         std::stack<TestPair> &internalCells,
-                        sofa::core::collision::DetectionOutputVector *&outputs,
+                        FinalPairs &finalPairs,
                         const sofa::core::collision::Intersection* currentIntersection);
 
     static void visitCollisionElements(const TestPair &root,
@@ -123,7 +148,7 @@ protected:
                                        const FinestCollision &finest,
                                        std::queue<TestPair> &externalCells,
                                        std::stack<TestPair> &internalCells,
-                                       sofa::core::collision::DetectionOutputVector *&outputs,
+                                       FinalPairs &finalPairs,
                                        const sofa::core::collision::Intersection* currentIntersection);
 
     static void
@@ -131,8 +156,7 @@ protected:
                           core::collision::ElementIntersector *coarseIntersector,
                           const FinestCollision &finest,
                           std::queue<TestPair> &externalCells,
-                          sofa::core::collision::DetectionOutputVector *&outputs,
-                          const sofa::core::collision::Intersection* currentIntersection);
+                          FinalPairs &finalPairs);
 
     /// Test intersection between two ranges of CollisionElement's
     /// The provided TestPair contains ranges of external CollisionElement's, which means that
@@ -140,8 +164,7 @@ protected:
     static void finalCollisionPairs(const TestPair& pair,
                                     bool selfCollision,
                                     core::collision::ElementIntersector* intersector,
-                                    sofa::core::collision::DetectionOutputVector*& outputs,
-                                    const sofa::core::collision::Intersection* currentIntersection);
+                                    FinalPairs& finalPairs);
 
 private:
 
@@ -111,7 +111,10 @@ void CollisionPipeline::doCollisionReset()
             << "CollisionPipeline::doCollisionReset" ;
 
     // clear all contacts
-    if (contactManager != nullptr)
+    // If the contact manager keeps the active responses and the collision groups are not rebuilt, the responses stay
+    // in their group: the contact manager removes the responses of the inactive contacts, and the graph is not
+    // modified for the contacts which are still active.
+    if (contactManager != nullptr && (groupManager != nullptr || !contactManager->keepActiveResponses()))
     {
         const type::vector<Contact::SPtr>& contacts = contactManager->getContacts();
         for (const auto& contact : contacts)
@@ -155,6 +158,9 @@ void CollisionPipeline::doCollisionDetection(const type::vector<core::CollisionM
         const type::vector<CollisionModel*>::const_iterator itEnd = collisionModels.end();
         int nActive = 0;
 
+        m_sleepingModels.clear();
+        m_nextFrozenBoundingTrees.clear();
+
         const int used_depth = (
                     (broadPhaseDetection && broadPhaseDetection->needsDeepBoundingTree()) ||
                     (narrowPhaseDetection && narrowPhaseDetection->needsDeepBoundingTree())
@@ -167,6 +173,20 @@ void CollisionPipeline::doCollisionDetection(const type::vector<core::CollisionM
 
             if (!(*it)->isActive()) continue;
 
+            if (isInSleepingNode(*it))
+            {
+                m_sleepingModels.insert((*it)->getFirst());
+                m_nextFrozenBoundingTrees.insert(*it);
+
+                // the positions of a sleeping model do not change: its bounding tree is only computed once
+                if (m_frozenBoundingTrees.count(*it))
+                {
+                    vectBoundingVolume.push_back((*it)->getFirst());
+                    ++nActive;
+                    continue;
+                }
+            }
+
             if (continuous)
             {
                 const std::string msg = "Compute Continuous BoundingTree: " + (*it)->getName();
@@ -184,6 +204,8 @@ void CollisionPipeline::doCollisionDetection(const type::vector<core::CollisionM
             ++nActive;
         }
 
+        m_frozenBoundingTrees.swap(m_nextFrozenBoundingTrees);
+
 #ifdef SOFA_DUMP_VISITOR_INFO
         simulation::Visitor::printCloseNode("ComputeBoundingTree");
 #endif
@@ -236,7 +258,26 @@ void CollisionPipeline::doCollisionDetection(const type::vector<core::CollisionM
         msg_info_when(d_doPrintInfoMessage.getValue())
                 << "doCollisionDetection, "<< vectCMPair.size()<<" colliding model pairs" ;
 
-        narrowPhaseDetection->addCollisionPairs(vectCMPair);
+        if (m_sleepingModels.empty())
+        {
+            narrowPhaseDetection->addCollisionPairs(vectCMPair);
+        }
+        else
+        {
+            // A sleeping model in a pair with an awake one may be woken up by the response of the contact, after the
+            // detection. Its pairs with the immobile models, such as the floor it rests on, are then kept too.
+            findDisturbedSleepingModels(vectCMPair);
+
+            m_awakeCollisionModelPairs.clear();
+            for (const auto& [collisionModel1, collisionModel2] : vectCMPair)
+            {
+                if (!isPairAsleep(collisionModel1, collisionModel2))
+                {
+                    m_awakeCollisionModelPairs.emplace_back(collisionModel1, collisionModel2);
+                }
+            }
+            narrowPhaseDetection->addCollisionPairs(m_awakeCollisionModelPairs);
+        }
         narrowPhaseDetection->endNarrowPhase();
         intersectionMethod->endNarrowPhase();
     }
@@ -246,6 +287,59 @@ void CollisionPipeline::doCollisionDetection(const type::vector<core::CollisionM
 
 }
 
+bool CollisionPipeline::isInSleepingNode(const core::CollisionModel* collisionModel)
+{
+    const auto* node = dynamic_cast<const simulation::Node*>(collisionModel->getContext());
+    while (node != nullptr)
+    {
+        if (node->isSleeping())
+        {
+            return true;
+        }
+        node = dynamic_cast<const simulation::Node*>(node->getFirstParent());
+    }
+    return false;
+}
+
+bool CollisionPipeline::isImmobile(core::CollisionModel* collisionModel)
+{
+    return !collisionModel->getLast()->isSimulated() && !collisionModel->getLast()->isMoving();
+}
+
+bool CollisionPipeline::isPairAsleep(core::CollisionModel* collisionModel1, core::CollisionModel* collisionModel2) const
+{
+    const bool isSleeping1 = m_sleepingModels.count(collisionModel1) > 0;
+    const bool isSleeping2 = m_sleepingModels.count(collisionModel2) > 0;
+    if (!isSleeping1 && !isSleeping2)
+    {
+        return false;
+    }
+    if (m_disturbedSleepingModels.count(collisionModel1) || m_disturbedSleepingModels.count(collisionModel2))
+    {
+        return false;
+    }
+
+    return (isSleeping1 || isImmobile(collisionModel1)) && (isSleeping2 || isImmobile(collisionModel2));
+}
+
+void CollisionPipeline::findDisturbedSleepingModels(const type::vector<std::pair<core::CollisionModel*, core::CollisionModel*> >& collisionModelPairs)
+{
+    m_disturbedSleepingModels.clear();
+    for (const auto& [collisionModel1, collisionModel2] : collisionModelPairs)
+    {
+        const bool isSleeping1 = m_sleepingModels.count(collisionModel1) > 0;
+        const bool isSleeping2 = m_sleepingModels.count(collisionModel2) > 0;
+        if (isSleeping1 && !isSleeping2 && !isImmobile(collisionModel2))
+        {
+            m_disturbedSleepingModels.insert(collisionModel1);
+        }
+        else if (isSleeping2 && !isSleeping1 && !isImmobile(collisionModel1))
+        {
+            m_disturbedSleepingModels.insert(collisionModel2);
+        }
+    }
+}
+
 void CollisionPipeline::doCollisionResponse()
 {
     core::objectmodel::BaseContext* scene = getContext();
@@ -23,6 +23,7 @@
 #include <sofa/component/collision/detection/algorithm/config.h>
 
 #include <sofa/simulation/PipelineImpl.h>
+#include <unordered_set>
 
 namespace sofa::component::collision::detection::algorithm
 {
@@ -53,6 +54,31 @@ protected:
 
     virtual void checkDataValues() ;
 
+    /// Return true if the node of the collision model or one of its ancestors is sleeping
+    static bool isInSleepingNode(const core::CollisionModel* collisionModel);
+
+    /// Return true if the collision model is neither simulated nor moving, such as a floor
+    static bool isImmobile(core::CollisionModel* collisionModel);
+
+    /// Return true if the elements of the two collision models cannot move, and at least one of them is sleeping
+    /// and not disturbed. The pair is then not given to the narrow phase.
+    bool isPairAsleep(core::CollisionModel* collisionModel1, core::CollisionModel* collisionModel2) const;
+
+    /// Sleeping collision models whose bounding tree has already been computed since they fell asleep
+    std::unordered_set<core::CollisionModel*> m_frozenBoundingTrees;
+    std::unordered_set<core::CollisionModel*> m_nextFrozenBoundingTrees;
+
+    /// First models of the bounding trees of the sleeping collision models
+    std::unordered_set<core::CollisionModel*> m_sleepingModels;
+
+    /// Find the sleeping models which are in a pair of the broad phase with an awake model that can move
+    void findDisturbedSleepingModels(const type::vector<std::pair<core::CollisionModel*, core::CollisionModel*> >& collisionModelPairs);
+
+    /// Pairs of the broad phase which are given to the narrow phase, when some pairs are asleep
+    type::vector<std::pair<core::CollisionModel*, core::CollisionModel*> > m_awakeCollisionModelPairs;
+    /// Sleeping models which may be woken up by a contact in the current step. All their pairs are kept.
+    std::unordered_set<core::CollisionModel*> m_disturbedSleepingModels;
+
 public:
     static const int defaultDepthValue;
 };
@@ -24,15 +24,38 @@
 #include <sofa/helper/ScopedAdvancedTimer.h>
 #include <sofa/core/visual/VisualParams.h>
 #include <sofa/core/ObjectFactory.h>
-#include <unordered_map>
+#include <algorithm>
+#include <array>
+#include <bit>
 
 namespace sofa::component::collision::detection::algorithm
 {
 using namespace sofa::component::collision::geometry;
 
+namespace
+{
+/// Below this number of end points per part, the computations are not split further
+constexpr std::size_t minNbEndPointsPerPart = 2048;
+
+constexpr unsigned int radixNbBits = 8;
+constexpr std::size_t radixNbBuckets = 1 << radixNbBits;
+constexpr unsigned int radixNbPasses = 64 / radixNbBits;
+
+/// Unsigned integer with the same order as the value of the end point.
+/// The binary representation of a positive double already has the order of the value, a negative one
+/// is reversed. -0 and 0 have the same key, as they are equal for the comparison of the end points.
+std::uint64_t radixKey(double value)
+{
+    constexpr std::uint64_t signBit = std::uint64_t(1) << 63;
+    const auto bits = std::bit_cast<std::uint64_t>(value + 0.0);
+    return (bits & signBit) ? ~bits : (bits | signBit);
+}
+}
+
 DirectSAPNarrowPhase::DirectSAPNarrowPhase()
         : d_showOnlyInvestigatedBoxes(initData(&d_showOnlyInvestigatedBoxes, true, "showOnlyInvestigatedBoxes", "Show only boxes which will be sent to narrow phase"))
         , d_nbPairs(initData(&d_nbPairs, 0, "nbPairs", "number of pairs of elements sent to narrow phase"))
+        , d_parallel(initData(&d_parallel, false, "parallel", "If true, the end points are sorted and swept in parallel"))
         , m_currentAxis(0)
         , m_alarmDist(0)
         , m_alarmDist_d2(0)
@@ -41,6 +64,13 @@ DirectSAPNarrowPhase::DirectSAPNarrowPhase()
     d_nbPairs.setReadOnly(true);
 }
 
+void DirectSAPNarrowPhase::init()
+{
+    NarrowPhaseDetection::init();
+
+    m_helper.initTaskScheduler(this, d_parallel.getValue());
+}
+
 void DirectSAPNarrowPhase::reset()
 {
     m_endPointContainer.clear();
@@ -50,6 +80,8 @@ void DirectSAPNarrowPhase::reset()
     m_addedCollisionModels.clear();
     m_newCollisionModels.clear();
     m_broadPhaseCollisionModels.clear();
+    m_helper.clear();
+    m_sortedAxis = -1;
 }
 
 void DirectSAPNarrowPhase::createBoxesFromCollisionModels()
@@ -242,28 +274,162 @@ void DirectSAPNarrowPhase::cacheData()
 void DirectSAPNarrowPhase::sortEndPoints()
 {
     SCOPED_TIMER_VARNAME(scopeTimer, "Direct SAP sort");
-    std::sort(m_sortedEndPoints.begin(), m_sortedEndPoints.end(), CompPEndPoint());
+
+    // From a step to another, the end points move a little along the same axis: their previous order is almost sorted
+    if (m_sortedAxis != m_currentAxis || !insertionSortEndPoints(m_sortedEndPoints.size()))
+    {
+        radixSortEndPoints();
+    }
+    m_sortedAxis = m_currentAxis;
 }
 
-void DirectSAPNarrowPhase::narrowCollisionDetectionFromSortedEndPoints()
+bool DirectSAPNarrowPhase::insertionSortEndPoints(std::size_t maxNbShifts)
 {
-    SCOPED_TIMER_VARNAME(scopeTimer, "Direct SAP intersection");
-    int nbInvestigatedPairs{ 0 };
+    const CompPEndPoint comp;
+    std::size_t nbShifts = 0;
+    for (std::size_t i = 1; i < m_sortedEndPoints.size(); ++i)
+    {
+        EndPoint* endPoint = m_sortedEndPoints[i];
+        std::size_t j = i;
+        for (; j > 0 && comp(endPoint, m_sortedEndPoints[j - 1]); --j)
+        {
+            m_sortedEndPoints[j] = m_sortedEndPoints[j - 1];
+        }
+        m_sortedEndPoints[j] = endPoint;
 
-    std::list<int> activeBoxes;//active boxes are the one that we encountered only their min (end point), so if there are two boxes b0 and b1,
-    //if we encounter b1_min as b0_min < b1_min, on the current axis, the two boxes intersect :  b0_min--------------------b0_max
-    //                                                                                                      b1_min---------------------b1_max
-    //once we encounter b0_max, b0 will not intersect with nothing (trivial), so we delete it from active_boxes.
-    //so the rule is : -every time we encounter a box min end point, we check if it is overlapping with other active_boxes and add the owner (a box) of this end point to
-    //                  the active boxes.
-    //                 -every time we encounter a max end point of a box, we are sure that we encountered min end point of a box because _end_points is sorted,
-    //                  so, we delete the owner box, of this max end point from the active boxes
+        nbShifts += i - j;
+        if (nbShifts > maxNbShifts)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void DirectSAPNarrowPhase::radixSortEndPoints()
+{
+    const std::size_t n = m_sortedEndPoints.size();
+    assert(n == 2 * m_boxes.size());
+
+    // The keys are in the order of the box ids, min before max. As the radix sort is stable, the end points with
+    // the same value stay in this order, which is the order of CompPEndPoint.
+    m_endPointKeys.resize(n);
+    m_endPointKeysBuffer.resize(n);
+    for (std::size_t i = 0; i < m_boxes.size(); ++i)
+    {
+        m_endPointKeys[2 * i] = { radixKey(m_boxes[i].min->value), m_boxes[i].min };
+        m_endPointKeys[2 * i + 1] = { radixKey(m_boxes[i].max->value), m_boxes[i].max };
+    }
+
+    const std::size_t nbBlocks = getNbParallelParts(n);
+    std::vector<std::array<std::size_t, radixNbBuckets> > histograms(nbBlocks);
+
+    for (unsigned int pass = 0; pass < radixNbPasses; ++pass)
+    {
+        const unsigned int shift = pass * radixNbBits;
+
+        m_helper.runParts(nbBlocks, [&](std::size_t block)
+        {
+            auto& histogram = histograms[block];
+            histogram.fill(0);
+            const auto [begin, end] = ParallelNarrowPhaseHelper::partRange(block, nbBlocks, n);
+            for (std::size_t i = begin; i < end; ++i)
+            {
+                ++histogram[(m_endPointKeys[i].key >> shift) & (radixNbBuckets - 1)];
+            }
+        });
+
+        // Turn the histograms into the first position of each digit in each block.
+        // If all the keys have the same digit, the pass does not change the order.
+        std::size_t position = 0;
+        bool isPassUseless = false;
+        for (std::size_t digit = 0; digit < radixNbBuckets && !isPassUseless; ++digit)
+        {
+            std::size_t digitCount = 0;
+            for (auto& histogram : histograms)
+            {
+                const std::size_t count = histogram[digit];
+                histogram[digit] = position;
+                position += count;
+                digitCount += count;
+            }
+            isPassUseless = (digitCount == n);
+        }
+        if (isPassUseless)
+        {
+            continue;
+        }
+
+        m_helper.runParts(nbBlocks, [&](std::size_t block)
+        {
+            auto& positions = histograms[block];
+            const auto [begin, end] = ParallelNarrowPhaseHelper::partRange(block, nbBlocks, n);
+            for (std::size_t i = begin; i < end; ++i)
+            {
+                const EndPointKey& key = m_endPointKeys[i];
+                m_endPointKeysBuffer[positions[(key.key >> shift) & (radixNbBuckets - 1)]++] = key;
+            }
+        });
+        std::swap(m_endPointKeys, m_endPointKeysBuffer);
+    }
+
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        m_sortedEndPoints[i] = m_endPointKeys[i].endPoint;
+    }
+}
 
-    // Iterators to activeBoxes are stored in a map for a fast access from a box id
-    std::unordered_map<int, decltype(activeBoxes)::const_iterator> activeBoxesIt;
+std::size_t DirectSAPNarrowPhase::getNbParallelParts(std::size_t nbEndPoints) const
+{
+    return m_helper.getNbParallelParts(nbEndPoints, minNbEndPointsPerPart, d_parallel.getValue());
+}
+
+void DirectSAPNarrowPhase::ActiveBoxes::clear(std::size_t nbBoxes)
+{
+    boxes.clear();
+    slots.assign(nbBoxes, -1);
+    nbRemovedBoxes = 0;
+}
+
+void DirectSAPNarrowPhase::ActiveBoxes::add(int boxId)
+{
+    slots[boxId] = static_cast<int>(boxes.size());
+    boxes.push_back(boxId);
+}
 
-    for (const auto* endPoint : m_sortedEndPoints)
+void DirectSAPNarrowPhase::ActiveBoxes::remove(int boxId)
+{
+    int& slot = slots[boxId];
+    if (slot < 0)
+    {
+        return;
+    }
+    boxes[slot] = -1;
+    slot = -1;
+
+    // Remove the holes, keeping the order of the remaining boxes
+    if (++nbRemovedBoxes > boxes.size() / 2)
     {
+        std::size_t nbBoxes = 0;
+        for (const int id : boxes)
+        {
+            if (id >= 0)
+            {
+                slots[id] = static_cast<int>(nbBoxes);
+                boxes[nbBoxes++] = id;
+            }
+        }
+        boxes.resize(nbBoxes);
+        nbRemovedBoxes = 0;
+    }
+}
+
+void DirectSAPNarrowPhase::sweepEndPoints(std::size_t begin, std::size_t end, SweepPart& part) const
+{
+    auto& activeBoxes = part.activeBoxes;
+    for (std::size_t i = begin; i < end; ++i)
+    {
+        const EndPoint* endPoint = m_sortedEndPoints[i];
         assert(endPoint != nullptr);
 
         const int boxId0 = endPoint->boxID();
@@ -275,66 +441,98 @@ void DirectSAPNarrowPhase::narrowCollisionDetectionFromSortedEndPoints()
 
         if (endPoint->max())
         {
-            const auto foundIt = activeBoxesIt.find(endPoint->boxID()); // complexity: Constant on average, worst case linear in the size of the container
-            if (foundIt != activeBoxesIt.end())
-            {
-                //erase the box with id endPoint->boxID() from the list of active boxes
-                //the iterator is found from a map
-                //with std::list, erasing an element does not invalidate the other iterators
-                activeBoxes.erase(foundIt->second);// complexity: Constant
-            }
+            activeBoxes.remove(boxId0);
         }
         else //we encounter a min possible intersection between it and active_boxes
         {
             const DSAPBox& box0 = m_boxes[boxId0];
-            core::CollisionModel *cm0 = data0.lastCollisionModel;
-            const auto collisionElement0 = data0.collisionElementIterator;
-
-            for (const int boxId1 : activeBoxes)
+            for (const int boxId1 : activeBoxes.boxes)
             {
-                const BoxData& data1 = m_boxData[boxId1];
-
-                if (!isPairFiltered(data0, data1, box0, boxId1))
+                if (boxId1 >= 0 && !isPairFiltered(data0, m_boxData[boxId1], box0, boxId1))
                 {
-                    core::CollisionModel *cm1 = data1.lastCollisionModel;
+                    part.pairs.emplace_back(boxId0, boxId1);
+                }
+            }
+            activeBoxes.add(boxId0);
+        }
+    }
+}
 
-                    bool swapModels = false;
-                    core::collision::ElementIntersector* finalintersector = intersectionMethod->findIntersector(cm0, cm1, swapModels);//find the method for the finnest CollisionModels
+void DirectSAPNarrowPhase::narrowCollisionDetectionFromSortedEndPoints()
+{
+    SCOPED_TIMER_VARNAME(scopeTimer, "Direct SAP intersection");
+    int nbInvestigatedPairs{ 0 };
 
-                    if (!swapModels && cm0->getClass() == cm1->getClass() && cm0 > cm1)//we do that to have only pair (p1,p2) without having (p2,p1)
-                        swapModels = true;
+    //active boxes are the one that we encountered only their min (end point), so if there are two boxes b0 and b1,
+    //if we encounter b1_min as b0_min < b1_min, on the current axis, the two boxes intersect :  b0_min--------------------b0_max
+    //                                                                                                      b1_min---------------------b1_max
+    //once we encounter b0_max, b0 will not intersect with nothing (trivial), so we delete it from active_boxes.
+    //so the rule is : -every time we encounter a box min end point, we check if it is overlapping with other active_boxes and add the owner (a box) of this end point to
+    //                  the active boxes.
+    //                 -every time we encounter a max end point of a box, we are sure that we encountered min end point of a box because _end_points is sorted,
+    //                  so, we delete the owner box, of this max end point from the active boxes
+    //
+    //The sorted end points are split into parts swept independently. A part starts with the boxes which are active
+    //at its beginning, in the order in which they would have been activated by a single sweep. Then, the pairs
+    //found in all the parts are in the same order as with a single sweep.
 
-                    if (finalintersector != nullptr)
-                    {
-                        auto collisionElement1 = data1.collisionElementIterator;
+    const std::size_t nbEndPoints = m_sortedEndPoints.size();
+    const std::size_t nbParts = getNbParallelParts(nbEndPoints);
+    m_sweepParts.resize(nbParts);
 
-                        auto swappableCm0 = cm0;
-                        auto swappableCollisionElement0 = collisionElement0;
+    if (nbParts > 1)
+    {
+        m_maxEndPointPositions.resize(m_boxes.size());
+        for (std::size_t i = 0; i < nbEndPoints; ++i)
+        {
+            if (m_sortedEndPoints[i]->max())
+            {
+                m_maxEndPointPositions[m_sortedEndPoints[i]->boxID()] = static_cast<int>(i);
+            }
+        }
+    }
 
-                        if (swapModels)
-                        {
-                            std::swap(swappableCm0, cm1);
-                            std::swap(swappableCollisionElement0, collisionElement1);
-                        }
+    m_helper.runParts(nbParts, [this, nbParts, nbEndPoints](std::size_t partId)
+    {
+        SweepPart& part = m_sweepParts[partId];
+        part.pairs.clear();
+        part.activeBoxes.clear(m_boxes.size());
 
-                        narrowCollisionDetectionForPair(finalintersector, swappableCm0, cm1, swappableCollisionElement0, collisionElement1);
+        const auto [begin, end] = ParallelNarrowPhaseHelper::partRange(partId, nbParts, nbEndPoints);
+        for (std::size_t i = 0; i < begin; ++i)
+        {
+            const EndPoint* endPoint = m_sortedEndPoints[i];
+            const int boxId = endPoint->boxID();
+            if (endPoint->min() && m_boxData[boxId].isInBroadPhase && m_maxEndPointPositions[boxId] >= static_cast<int>(begin))
+            {
+                part.activeBoxes.add(boxId);
+            }
+        }
 
-                        //used only for drawing
-                        m_isBoxInvestigated[boxId0] = true;
-                        m_isBoxInvestigated[boxId1] = true;
+        sweepEndPoints(begin, end, part);
+    });
 
-                        ++nbInvestigatedPairs;
-                    }
-                }
+    for (const SweepPart& part : m_sweepParts)
+    {
+        for (const auto& [boxId0, boxId1] : part.pairs)
+        {
+            const BoxData& data0 = m_boxData[boxId0];
+            const BoxData& data1 = m_boxData[boxId1];
+            if (m_helper.addCandidatePair(intersectionMethod,
+                                          data0.lastCollisionModel, data0.collisionElementIterator.getIndex(),
+                                          data1.lastCollisionModel, data1.collisionElementIterator.getIndex()))
+            {
+                //used only for drawing
+                m_isBoxInvestigated[boxId0] = true;
+                m_isBoxInvestigated[boxId1] = true;
 
+                ++nbInvestigatedPairs;
             }
-            activeBoxes.push_back(boxId0);// complexity: Constant
-            auto last = activeBoxes.end();
-            --last;//iterator the last element of the list
-            activeBoxesIt.insert({boxId0, last});// complexity: Average case: O(1), worst case O(size())
         }
     }
 
+    m_helper.intersectCandidatePairs(this, intersectionMethod);
+
     d_nbPairs.setValue(nbInvestigatedPairs);
     sofa::helper::AdvancedTimer::valSet("Direct SAP pairs", nbInvestigatedPairs);
 }
@@ -355,17 +553,6 @@ bool DirectSAPNarrowPhase::isPairFiltered(const BoxData &data0, const BoxData &d
     return true;
 }
 
-void DirectSAPNarrowPhase::narrowCollisionDetectionForPair(core::collision::ElementIntersector* intersector,
-                                                core::CollisionModel *collisionModel0,
-                                                core::CollisionModel *collisionModel1,
-                                                core::CollisionElementIterator collisionModelIterator0,
-                                                core::CollisionElementIterator collisionModelIterator1)
-{
-    sofa::core::collision::DetectionOutputVector*& outputs = this->getDetectionOutputs(collisionModel0, collisionModel1);
-    intersector->beginIntersect(collisionModel0, collisionModel1, outputs);//creates outputs if null
-    intersector->intersect(collisionModelIterator0, collisionModelIterator1, outputs, this->intersectionMethod);
-}
-
 void DirectSAPNarrowPhase::draw(const core::visual::VisualParams* vparams)
 {
     if (!vparams->displayFlags().getShowDetectionOutputs())
@@ -24,15 +24,13 @@
 #include <sofa/component/collision/detection/algorithm/config.h>
 
 #include <sofa/core/collision/NarrowPhaseDetection.h>
+#include <sofa/core/collision/Intersection.h>
 #include <sofa/component/collision/detection/algorithm/EndPoint.h>
 #include <sofa/component/collision/detection/algorithm/DSAPBox.h>
+#include <sofa/component/collision/detection/algorithm/ParallelNarrowPhaseHelper.h>
+#include <cstdint>
 #include <unordered_set>
 
-namespace sofa::core::collision
-{
-class ElementIntersector;
-}
-
 namespace sofa::component::collision::detection::algorithm
 {
 
@@ -40,6 +38,11 @@ namespace sofa::component::collision::detection::algorithm
  * This class is an implementation of sweep and prune in its "direct" version, i.e. at each step
  * it sorts all the primitives along an axis (not checking the moving ones) and computes overlapping pairs without
  * saving it. But the memory used to save these primitives is created just once, the first time we add CollisionModels.
+ *
+ * The end points are first sorted with an insertion sort starting from the order of the previous step, which is
+ * fast when the primitives moved a little. If the order changed too much, they are sorted with a radix sort.
+ * The sorted end points can be swept in several parts, each part starting with the boxes active at its beginning.
+ * The sort and the sweep are executed in parallel if the Data parallel is true. The pairs are the same in any case.
  */
 class SOFA_COMPONENT_COLLISION_DETECTION_ALGORITHM_API DirectSAPNarrowPhase : public core::collision::NarrowPhaseDetection
 {
@@ -65,6 +68,7 @@ private:
 
     Data<bool> d_showOnlyInvestigatedBoxes; ///< Show only boxes which will be sent to narrow phase
     Data<int> d_nbPairs; ///< number of pairs of elements sent to narrow phase
+    Data<bool> d_parallel; ///< If true, the end points are sorted and swept in parallel
 
     /// Store a permanent list of end points
     /// The container is a std::list to avoid invalidation of pointers after an insertion
@@ -74,6 +78,7 @@ private:
     sofa::type::vector<bool> m_isBoxInvestigated;
     EndPointList m_sortedEndPoints; ///< list of EndPoints dedicated to be sorted. Owner of pointers is m_endPointContainer
     int m_currentAxis;//the current greatest variance axis
+    int m_sortedAxis { -1 };///< axis along which m_sortedEndPoints is sorted, -1 if it has never been sorted
 
     std::unordered_set<core::CollisionModel *> m_addedCollisionModels;//used to check if a collision model is added
     sofa::type::vector<core::CollisionModel *> m_newCollisionModels;//eventual new collision models to add at a step
@@ -84,6 +89,39 @@ private:
 
     static bool isSquaredDistanceLessThan(const DSAPBox &a, const DSAPBox &b, double threshold);
 
+    /// An end point and its key for the radix sort
+    struct EndPointKey
+    {
+        std::uint64_t key;
+        EndPoint* endPoint;
+    };
+    sofa::type::vector<EndPointKey> m_endPointKeys;
+    sofa::type::vector<EndPointKey> m_endPointKeysBuffer;
+
+    /// Boxes whose min end point has been swept, but not their max end point, in the order of their min end point.
+    /// A removed box leaves a hole, the holes are removed when they are too many.
+    struct ActiveBoxes
+    {
+        sofa::type::vector<int> boxes;
+        sofa::type::vector<int> slots; ///< for each box, its index in boxes, -1 if it is not active
+        std::size_t nbRemovedBoxes { 0 };
+
+        void clear(std::size_t nbBoxes);
+        void add(int boxId);
+        void remove(int boxId);
+    };
+
+    /// A part of the sorted end points, swept independently
+    struct SweepPart
+    {
+        ActiveBoxes activeBoxes;
+        sofa::type::vector<std::pair<int, int> > pairs; ///< the pairs of boxes found in this part, in the order of the sweep
+    };
+    sofa::type::vector<SweepPart> m_sweepParts;
+    sofa::type::vector<int> m_maxEndPointPositions; ///< for each box, the position of its max end point in m_sortedEndPoints
+
+    ParallelNarrowPhaseHelper m_helper;
+
 protected:
     DirectSAPNarrowPhase();
 
@@ -104,22 +142,29 @@ protected:
 
     bool isPairFiltered(const BoxData &data0, const BoxData &data1, const DSAPBox &box0, int boxId1) const;
 
-    void narrowCollisionDetectionForPair(
-            core::collision::ElementIntersector *intersector,
-            core::CollisionModel *collisionModel0,
-            core::CollisionModel *collisionModel1,
-            core::CollisionElementIterator collisionModelIterator0,
-            core::CollisionElementIterator collisionModelIterator1);
-
     void createBoxesFromCollisionModels();
 
     void cacheData(); /// Cache data into vector to avoid overhead during access
     void sortEndPoints();
 
+    /// Sort the end points from their current order, if it requires less than maxNbShifts shifts.
+    /// Return false if the sort was stopped.
+    bool insertionSortEndPoints(std::size_t maxNbShifts);
+    void radixSortEndPoints();
+
+    /// Sweep the sorted end points in [begin, end), the sweep being already at begin.
+    /// The pairs of boxes which must be intersected are added to part.pairs.
+    void sweepEndPoints(std::size_t begin, std::size_t end, SweepPart& part) const;
+
+    /// Number of parts in which the computations on nbEndPoints end points are split, 1 if they are sequential
+    std::size_t getNbParallelParts(std::size_t nbEndPoints) const;
+
     void narrowCollisionDetectionFromSortedEndPoints();
 
 public:
 
+    void init() override;
+
     void reset() override;
 
     void beginNarrowPhase() override;
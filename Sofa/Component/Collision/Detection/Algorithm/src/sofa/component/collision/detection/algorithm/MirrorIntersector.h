@@ -54,6 +54,18 @@ public:
         return intersector->intersect(elem2, elem1, contacts, currentIntersection);
     }
 
+    /// Compute the intersections between pairs of elements. Return the number of contacts written in the contacts vector.
+    int intersectPairs(core::CollisionModel* model1, core::CollisionModel* model2, const ElementPairs& pairs, core::collision::DetectionOutputVector* contacts, const core::collision::Intersection* currentIntersection) override
+    {
+        assert(intersector != nullptr);
+        m_swappedPairs.resize(pairs.size());
+        for (std::size_t i = 0; i < pairs.size(); ++i)
+        {
+            m_swappedPairs[i] = { pairs[i].second, pairs[i].first };
+        }
+        return intersector->intersectPairs(model2, model1, m_swappedPairs, contacts, currentIntersection);
+    }
+
     /// End intersection tests between two collision models. Return the number of contacts written in the contacts vector.
     int endIntersect(core::CollisionModel* model1, core::CollisionModel* model2, core::collision::DetectionOutputVector* contacts) override
     {
@@ -71,6 +83,10 @@ public:
     bool canIntersect(core::CollisionElementIterator elem1, core::CollisionElementIterator elem2) override = delete;
     SOFA_ATTRIBUTE_DISABLED__CORE_INTERSECTION_AS_PARAMETER()
     int intersect(core::CollisionElementIterator elem1, core::CollisionElementIterator elem2, core::collision::DetectionOutputVector* contacts) override = delete;
+
+private:
+    /// Pairs given to the mirrored intersector, kept to reuse its memory
+    ElementPairs m_swappedPairs;
 };
 
 } // namespace sofa::component::collision::detection::algorithm
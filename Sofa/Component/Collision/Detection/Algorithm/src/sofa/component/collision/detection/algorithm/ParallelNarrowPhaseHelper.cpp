@@ -0,0 +1,126 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/component/collision/detection/algorithm/ParallelNarrowPhaseHelper.h>
+#include <sofa/simulation/CpuTaskStatus.h>
+#include <sofa/simulation/MainTaskSchedulerFactory.h>
+#include <sofa/simulation/TaskScheduler.h>
+#include <algorithm>
+
+namespace sofa::component::collision::detection::algorithm
+{
+
+std::pair<std::size_t, std::size_t> ParallelNarrowPhaseHelper::partRange(std::size_t i, std::size_t nbParts, std::size_t n)
+{
+    return { i * n / nbParts, (i + 1) * n / nbParts };
+}
+
+void ParallelNarrowPhaseHelper::initTaskScheduler(core::collision::NarrowPhaseDetection* narrowPhase, bool parallel)
+{
+    m_taskScheduler = nullptr;
+    if (parallel)
+    {
+        m_taskScheduler = sofa::simulation::MainTaskSchedulerFactory::createInRegistry();
+        assert(m_taskScheduler != nullptr);
+        if (m_taskScheduler->getThreadCount() < 1)
+        {
+            m_taskScheduler->init(0);
+            msg_info(narrowPhase) << "Task scheduler initialized on " << m_taskScheduler->getThreadCount() << " threads";
+        }
+    }
+}
+
+std::size_t ParallelNarrowPhaseHelper::getNbParallelParts(std::size_t n, std::size_t minNbElementsPerPart, bool parallel) const
+{
+    if (m_taskScheduler == nullptr || !parallel)
+    {
+        return 1;
+    }
+    const std::size_t nbThreads = std::max<std::size_t>(m_taskScheduler->getThreadCount(), 1);
+    return std::clamp<std::size_t>(n / minNbElementsPerPart, 1, nbThreads);
+}
+
+void ParallelNarrowPhaseHelper::runParts(std::size_t nbParts, const std::function<void(std::size_t)>& f) const
+{
+    if (nbParts == 1)
+    {
+        f(0);
+        return;
+    }
+
+    sofa::simulation::CpuTaskStatus status;
+    for (std::size_t i = 0; i < nbParts; ++i)
+    {
+        m_taskScheduler->addTask(status, [i, &f]() { f(i); });
+    }
+    m_taskScheduler->workUntilDone(&status);
+}
+
+bool ParallelNarrowPhaseHelper::addCandidatePair(core::collision::Intersection* intersectionMethod,
+                                                 core::CollisionModel* collisionModel0, sofa::Index elementIndex0,
+                                                 core::CollisionModel* collisionModel1, sofa::Index elementIndex1)
+{
+    bool swapModels = false;
+    core::collision::ElementIntersector* finalintersector = intersectionMethod->findIntersector(collisionModel0, collisionModel1, swapModels);//find the method for the finnest CollisionModels
+
+    if (finalintersector == nullptr)
+    {
+        return false;
+    }
+
+    if (!swapModels && collisionModel0->getClass() == collisionModel1->getClass() && collisionModel0 > collisionModel1)//we do that to have only pair (p1,p2) without having (p2,p1)
+        swapModels = true;
+
+    if (swapModels)
+    {
+        std::swap(collisionModel0, collisionModel1);
+        std::swap(elementIndex0, elementIndex1);
+    }
+
+    CandidatePairs& candidatePairs = m_candidatePairs[{collisionModel0, collisionModel1}];
+    candidatePairs.intersector = finalintersector;
+    candidatePairs.pairs.emplace_back(elementIndex0, elementIndex1);
+    return true;
+}
+
+void ParallelNarrowPhaseHelper::intersectCandidatePairs(core::collision::NarrowPhaseDetection* narrowPhase, core::collision::Intersection* intersectionMethod)
+{
+    for (auto& [collisionModels, candidatePairs] : m_candidatePairs)
+    {
+        if (candidatePairs.pairs.empty())
+        {
+            continue;
+        }
+
+        const auto [collisionModel0, collisionModel1] = collisionModels;
+        sofa::core::collision::DetectionOutputVector*& outputs = narrowPhase->getDetectionOutputs(collisionModel0, collisionModel1);
+        candidatePairs.intersector->beginIntersect(collisionModel0, collisionModel1, outputs);//creates outputs if null
+        candidatePairs.intersector->intersectPairs(collisionModel0, collisionModel1, candidatePairs.pairs, outputs, intersectionMethod);
+        candidatePairs.pairs.clear();
+    }
+}
+
+void ParallelNarrowPhaseHelper::clear()
+{
+    m_candidatePairs.clear();
+}
+
+}
@@ -0,0 +1,91 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+
+#include <sofa/component/collision/detection/algorithm/config.h>
+
+#include <sofa/core/collision/NarrowPhaseDetection.h>
+#include <sofa/core/collision/Intersection.h>
+#include <functional>
+#include <map>
+
+namespace sofa::simulation
+{
+class TaskScheduler;
+}
+
+namespace sofa::component::collision::detection::algorithm
+{
+
+/**
+ * Common part of the narrow phases which find the pairs of elements from their bounding boxes, such as
+ * DirectSAPNarrowPhase and SpatialHashNarrowPhase.
+ *
+ * The computations on the boxes are split in parts, executed on the main task scheduler if the narrow phase is
+ * parallel. The pairs of elements found are gathered by pair of collision models, and intersected together.
+ */
+class SOFA_COMPONENT_COLLISION_DETECTION_ALGORITHM_API ParallelNarrowPhaseHelper
+{
+public:
+
+    /// [begin, end) of the i-th of nbParts parts of n elements
+    static std::pair<std::size_t, std::size_t> partRange(std::size_t i, std::size_t nbParts, std::size_t n);
+
+    /// Get the main task scheduler, initialized if it is not, if the narrow phase is parallel
+    void initTaskScheduler(core::collision::NarrowPhaseDetection* narrowPhase, bool parallel);
+
+    /// Number of parts in which the computations on n elements are split, 1 if they are sequential.
+    /// A part has at least minNbElementsPerPart elements.
+    std::size_t getNbParallelParts(std::size_t n, std::size_t minNbElementsPerPart, bool parallel) const;
+
+    /// Call f(i) for i in [0, nbParts), in parallel if possible
+    void runParts(std::size_t nbParts, const std::function<void(std::size_t)>& f) const;
+
+    /// Add a pair of elements of two collision models, to be intersected by intersectCandidatePairs.
+    /// Return false if the intersection method has no intersector for the two models.
+    bool addCandidatePair(core::collision::Intersection* intersectionMethod,
+                          core::CollisionModel* collisionModel0, sofa::Index elementIndex0,
+                          core::CollisionModel* collisionModel1, sofa::Index elementIndex1);
+
+    /// Compute the intersections of the candidate pairs of elements of each pair of collision models, into the
+    /// detection outputs of the narrow phase
+    void intersectCandidatePairs(core::collision::NarrowPhaseDetection* narrowPhase, core::collision::Intersection* intersectionMethod);
+
+    void clear();
+
+private:
+
+    sofa::simulation::TaskScheduler* m_taskScheduler { nullptr };
+
+    /// Pairs of elements of two collision models, and their intersector
+    struct CandidatePairs
+    {
+        core::collision::ElementIntersector* intersector{nullptr};
+        core::collision::ElementIntersector::ElementPairs pairs;
+    };
+
+    /// Candidate pairs for each pair of collision models. The entries are kept from a step to another, to reuse
+    /// their memory.
+    std::map<std::pair<core::CollisionModel*, core::CollisionModel*>, CandidatePairs> m_candidatePairs;
+};
+
+}
@@ -0,0 +1,410 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/component/collision/detection/algorithm/SpatialHashNarrowPhase.h>
+#include <sofa/core/collision/Intersection.h>
+#include <sofa/helper/ScopedAdvancedTimer.h>
+#include <sofa/core/ObjectFactory.h>
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <numeric>
+
+namespace sofa::component::collision::detection::algorithm
+{
+using namespace sofa::component::collision::geometry;
+
+namespace
+{
+/// Below this number of boxes per part, the computations are not split further
+constexpr std::size_t minNbBoxesPerPart = 1024;
+
+/// Squared distance between two axis-aligned boxes
+double squaredDistance(const type::Vec3& min0, const type::Vec3& max0, const type::Vec3& min1, const type::Vec3& max1)
+{
+    double dist2 = 0.;
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        if (min0[axis] > max1[axis])
+        {
+            dist2 += (min0[axis] - max1[axis]) * (min0[axis] - max1[axis]);
+        }
+        else if (min1[axis] > max0[axis])
+        {
+            dist2 += (min1[axis] - max0[axis]) * (min1[axis] - max0[axis]);
+        }
+    }
+    return dist2;
+}
+}
+
+SpatialHashNarrowPhase::SpatialHashNarrowPhase()
+        : d_nbPairs(initData(&d_nbPairs, 0, "nbPairs", "number of pairs of elements sent to narrow phase"))
+        , d_cellSize(initData(&d_cellSize, 0_sreal, "cellSize", "size of the cells of the grid, computed from the largest element and the alarm distance"))
+        , d_parallel(initData(&d_parallel, false, "parallel", "If true, the grid is built and searched in parallel"))
+{
+    d_nbPairs.setReadOnly(true);
+    d_cellSize.setReadOnly(true);
+}
+
+void SpatialHashNarrowPhase::init()
+{
+    NarrowPhaseDetection::init();
+
+    m_helper.initTaskScheduler(this, d_parallel.getValue());
+}
+
+void SpatialHashNarrowPhase::reset()
+{
+    m_broadPhaseCollisionModels.clear();
+    m_addedCollisionModels.clear();
+    m_models.clear();
+    m_boxes.clear();
+    m_sortedBoxes.clear();
+    m_helper.clear();
+    m_modelsWithoutLeafCubes.clear();
+}
+
+void SpatialHashNarrowPhase::beginNarrowPhase()
+{
+    NarrowPhaseDetection::beginNarrowPhase();
+    m_broadPhaseCollisionModels.clear();
+    m_addedCollisionModels.clear();
+}
+
+void SpatialHashNarrowPhase::addCollisionPair(const std::pair<core::CollisionModel*, core::CollisionModel*>& cmPair)
+{
+    for (auto* cm : { cmPair.first, cmPair.second })
+    {
+        if (m_addedCollisionModels.insert(cm).second)
+        {
+            m_broadPhaseCollisionModels.push_back(cm);
+        }
+    }
+}
+
+void SpatialHashNarrowPhase::endNarrowPhase()
+{
+    assert(intersectionMethod != nullptr);
+    m_alarmDist = getIntersectionMethod()->getAlarmDistance();
+    m_sq_alarmDist = m_alarmDist * m_alarmDist;
+
+    collectBoxes();
+    computeCells();
+    sortBoxes();
+    findPairs();
+    intersectPairs();
+
+    NarrowPhaseDetection::endNarrowPhase();
+}
+
+void SpatialHashNarrowPhase::collectBoxes()
+{
+    m_models.clear();
+    std::size_t nbBoxes = 0;
+    for (auto* cm : m_broadPhaseCollisionModels)
+    {
+        auto* last = cm->getLast();
+        assert(last != nullptr);
+        auto* leafCubeModel = dynamic_cast<CubeCollisionModel*>(last->getPrevious());
+        if (leafCubeModel == nullptr)
+        {
+            if (m_modelsWithoutLeafCubes.insert(last).second)
+            {
+                msg_warning() << "The collision model " << last->getPathName() << " has no bounding box for each of "
+                              << "its elements: it is ignored. Use a narrow phase based on the bounding tree, such as "
+                              << "BVHNarrowPhase, to detect its collisions.";
+            }
+            continue;
+        }
+
+        ModelData& model = m_models.emplace_back();
+        model.lastCollisionModel = last;
+        model.leafCubeModel = leafCubeModel;
+        model.context = last->getContext();
+        model.isSimulated = last->isSimulated();
+        model.doesSelfCollide = last->getSelfCollision();
+        model.firstBoxId = nbBoxes;
+        nbBoxes += leafCubeModel->getSize();
+    }
+    m_boxes.resize(nbBoxes);
+}
+
+void SpatialHashNarrowPhase::computeCells()
+{
+    SCOPED_TIMER_VARNAME(scopeTimer, "Spatial hash cells");
+
+    const std::size_t nbBoxes = m_boxes.size();
+    const std::size_t nbBlocks = getNbParallelParts(nbBoxes);
+    sofa::type::vector<double> maxBoxSizes(nbBlocks, 0.);
+
+    m_helper.runParts(nbBlocks, [this, nbBlocks, nbBoxes, &maxBoxSizes](std::size_t block)
+    {
+        const auto [begin, end] = ParallelNarrowPhaseHelper::partRange(block, nbBlocks, nbBoxes);
+        if (begin == end)
+        {
+            return;
+        }
+
+        // the model of the first box of the block
+        auto model = std::upper_bound(m_models.begin(), m_models.end(), begin,
+            [](std::size_t boxId, const ModelData& m) { return boxId < m.firstBoxId; }) - 1;
+
+        double maxBoxSize = 0.;
+        for (std::size_t i = begin; i < end; ++i)
+        {
+            while (i >= model->firstBoxId + model->leafCubeModel->getSize())
+            {
+                ++model;
+            }
+
+            const Cube cube(model->leafCubeModel, static_cast<sofa::Index>(i - model->firstBoxId));
+            Box& box = m_boxes[i];
+            box.min = cube.minVect();
+            box.max = cube.maxVect();
+            box.id = static_cast<int>(i);
+            box.modelId = static_cast<int>(model - m_models.begin());
+            box.elementIndex = cube.getExternalChildren().first.getIndex();
+
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                maxBoxSize = std::max(maxBoxSize, box.max[axis] - box.min[axis]);
+            }
+        }
+        maxBoxSizes[block] = maxBoxSize;
+    });
+
+    // Two boxes closer than the alarm distance have centers closer than the size of a cell on each axis
+    m_cellSize = *std::max_element(maxBoxSizes.begin(), maxBoxSizes.end()) + m_alarmDist;
+    if (!(m_cellSize > 0.))
+    {
+        m_cellSize = 1.;
+    }
+    d_cellSize.setValue(m_cellSize);
+
+    // A table with at least as many buckets as boxes
+    const std::size_t nbBuckets = std::bit_ceil(std::max<std::size_t>(nbBoxes, 1));
+    m_bucketMask = nbBuckets - 1;
+    m_bucketBegins.resize(nbBuckets + 1);
+    m_boxBuckets.resize(nbBoxes);
+    m_histograms.resize(nbBlocks);
+
+    m_helper.runParts(nbBlocks, [this, nbBlocks, nbBoxes, nbBuckets](std::size_t block)
+    {
+        auto& histogram = m_histograms[block];
+        histogram.assign(nbBuckets, 0);
+
+        const double invCellSize = 1. / m_cellSize;
+        const auto [begin, end] = ParallelNarrowPhaseHelper::partRange(block, nbBlocks, nbBoxes);
+        for (std::size_t i = begin; i < end; ++i)
+        {
+            Box& box = m_boxes[i];
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                box.cell[axis] = static_cast<std::int64_t>(std::floor(0.5 * (box.min[axis] + box.max[axis]) * invCellSize));
+            }
+
+            const std::size_t bucket = getBucket(box.cell);
+            m_boxBuckets[i] = bucket;
+            ++histogram[bucket];
+        }
+    });
+}
+
+std::size_t SpatialHashNarrowPhase::getBucket(const Cell& cell) const
+{
+    const auto hash = static_cast<std::uint64_t>(cell[0]) * 73856093u
+                    ^ static_cast<std::uint64_t>(cell[1]) * 19349663u
+                    ^ static_cast<std::uint64_t>(cell[2]) * 83492791u;
+    return static_cast<std::size_t>(hash) & m_bucketMask;
+}
+
+void SpatialHashNarrowPhase::sortBoxes()
+{
+    SCOPED_TIMER_VARNAME(scopeTimer, "Spatial hash sort");
+
+    const std::size_t nbBoxes = m_boxes.size();
+    const std::size_t nbBuckets = m_bucketBegins.size() - 1;
+    const std::size_t nbBlocks = m_histograms.size();
+
+    // The buckets are split in ranges. The number of boxes of each range gives the position of its first box.
+    m_bucketRangeSizes.resize(nbBlocks);
+    m_helper.runParts(nbBlocks, [this, nbBlocks, nbBuckets](std::size_t range)
+    {
+        std::size_t rangeSize = 0;
+        const auto [begin, end] = ParallelNarrowPhaseHelper::partRange(range, nbBlocks, nbBuckets);
+        for (const auto& histogram : m_histograms)
+        {
+            for (std::size_t bucket = begin; bucket < end; ++bucket)
+            {
+                rangeSize += histogram[bucket];
+            }
+        }
+        m_bucketRangeSizes[range] = rangeSize;
+    });
+    std::exclusive_scan(m_bucketRangeSizes.begin(), m_bucketRangeSizes.end(), m_bucketRangeSizes.begin(), std::size_t(0));
+
+    // Turn the histograms into the first position of each bucket in each block
+    m_helper.runParts(nbBlocks, [this, nbBlocks, nbBuckets](std::size_t range)
+    {
+        std::size_t position = m_bucketRangeSizes[range];
+        const auto [begin, end] = ParallelNarrowPhaseHelper::partRange(range, nbBlocks, nbBuckets);
+        for (std::size_t bucket = begin; bucket < end; ++bucket)
+        {
+            m_bucketBegins[bucket] = position;
+            for (auto& histogram : m_histograms)
+            {
+                const std::size_t count = histogram[bucket];
+                histogram[bucket] = position;
+                position += count;
+            }
+        }
+    });
+    m_bucketBegins[nbBuckets] = nbBoxes;
+
+    // In a bucket, the boxes stay in the order of their ids
+    m_sortedBoxes.resize(nbBoxes);
+    m_helper.runParts(nbBlocks, [this, nbBlocks, nbBoxes](std::size_t block)
+    {
+        auto& positions = m_histograms[block];
+        const auto [begin, end] = ParallelNarrowPhaseHelper::partRange(block, nbBlocks, nbBoxes);
+        for (std::size_t i = begin; i < end; ++i)
+        {
+            m_sortedBoxes[positions[m_boxBuckets[i]]++] = m_boxes[i];
+        }
+    });
+}
+
+void SpatialHashNarrowPhase::findPairs()
+{
+    SCOPED_TIMER_VARNAME(scopeTimer, "Spatial hash search");
+
+    const std::size_t nbBoxes = m_sortedBoxes.size();
+    const std::size_t nbParts = getNbParallelParts(nbBoxes);
+    m_partPairs.resize(nbParts);
+
+    m_helper.runParts(nbParts, [this, nbParts, nbBoxes](std::size_t partId)
+    {
+        auto& pairs = m_partPairs[partId];
+        pairs.clear();
+
+        std::array<std::size_t, 27> neighbourBuckets;
+        const auto [begin, end] = ParallelNarrowPhaseHelper::partRange(partId, nbParts, nbBoxes);
+        for (std::size_t i = begin; i < end; ++i)
+        {
+            const Box& box0 = m_sortedBoxes[i];
+
+            // Several neighbouring cells can share a bucket: each bucket is visited once
+            std::size_t nbNeighbourBuckets = 0;
+            for (std::int64_t dx = -1; dx <= 1; ++dx)
+            {
+                for (std::int64_t dy = -1; dy <= 1; ++dy)
+                {
+                    for (std::int64_t dz = -1; dz <= 1; ++dz)
+                    {
+                        neighbourBuckets[nbNeighbourBuckets++] = getBucket({ box0.cell[0] + dx, box0.cell[1] + dy, box0.cell[2] + dz });
+                    }
+                }
+            }
+            std::sort(neighbourBuckets.begin(), neighbourBuckets.end());
+            const auto neighbourBucketsEnd = std::unique(neighbourBuckets.begin(), neighbourBuckets.end());
+
+            for (auto bucket = neighbourBuckets.begin(); bucket != neighbourBucketsEnd; ++bucket)
+            {
+                for (std::size_t j = m_bucketBegins[*bucket]; j < m_bucketBegins[*bucket + 1]; ++j)
+                {
+                    const Box& box1 = m_sortedBoxes[j];
+
+                    // each pair is found once, from its box with the lowest id
+                    if (box1.id <= box0.id
+                        || std::abs(box1.cell[0] - box0.cell[0]) > 1
+                        || std::abs(box1.cell[1] - box0.cell[1]) > 1
+                        || std::abs(box1.cell[2] - box0.cell[2]) > 1)
+                    {
+                        continue;
+                    }
+
+                    if (!isPairFiltered(box0, box1))
+                    {
+                        pairs.emplace_back(i, j);
+                    }
+                }
+            }
+        }
+    });
+}
+
+bool SpatialHashNarrowPhase::isPairFiltered(const Box& box0, const Box& box1) const
+{
+    const ModelData& model0 = m_models[box0.modelId];
+    const ModelData& model1 = m_models[box1.modelId];
+    if (model0.isSimulated || model1.isSimulated) //is any of the object simulated?
+    {
+        // do the models belong to the same object? Can both object collide?
+        if ((model0.context != model1.context) || model0.doesSelfCollide)
+        {
+            if (squaredDistance(box0.min, box0.max, box1.min, box1.max) <= m_sq_alarmDist)
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+void SpatialHashNarrowPhase::intersectPairs()
+{
+    SCOPED_TIMER_VARNAME(scopeTimer, "Spatial hash intersection");
+    int nbInvestigatedPairs{ 0 };
+
+    for (const auto& pairs : m_partPairs)
+    {
+        for (const auto& [position0, position1] : pairs)
+        {
+            const Box& box0 = m_sortedBoxes[position0];
+            const Box& box1 = m_sortedBoxes[position1];
+            if (m_helper.addCandidatePair(intersectionMethod,
+                                          m_models[box0.modelId].lastCollisionModel, box0.elementIndex,
+                                          m_models[box1.modelId].lastCollisionModel, box1.elementIndex))
+            {
+                ++nbInvestigatedPairs;
+            }
+        }
+    }
+
+    m_helper.intersectCandidatePairs(this, intersectionMethod);
+
+    d_nbPairs.setValue(nbInvestigatedPairs);
+    sofa::helper::AdvancedTimer::valSet("Spatial hash pairs", nbInvestigatedPairs);
+}
+
+std::size_t SpatialHashNarrowPhase::getNbParallelParts(std::size_t nbBoxes) const
+{
+    return m_helper.getNbParallelParts(nbBoxes, minNbBoxesPerPart, d_parallel.getValue());
+}
+
+void registerSpatialHashNarrowPhase(sofa::core::ObjectFactory* factory)
+{
+    factory->registerObjects(core::ObjectRegistrationData("Narrow phase of the collision detection hashing the elements into a uniform grid, suited to large populations of similar elements.")
+        .add< SpatialHashNarrowPhase >());
+}
+
+}
@@ -0,0 +1,155 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+
+#include <sofa/component/collision/detection/algorithm/config.h>
+
+#include <sofa/core/collision/NarrowPhaseDetection.h>
+#include <sofa/core/collision/Intersection.h>
+#include <sofa/component/collision/detection/algorithm/ParallelNarrowPhaseHelper.h>
+#include <sofa/component/collision/geometry/CubeModel.h>
+#include <array>
+#include <cstdint>
+#include <unordered_set>
+
+namespace sofa::component::collision::detection::algorithm
+{
+
+/**
+ * Narrow phase of the collision detection hashing the elements into a uniform grid.
+ *
+ * At each step, the bounding boxes of the elements of all the collision models given by the broad phase are
+ * placed in the cells of a grid, from the position of their center. The size of the cells is the size of the
+ * largest box plus the alarm distance, so that two elements close enough to collide are in neighbouring cells.
+ * The cells are hashed into a table, which is filled with a counting sort of the elements, keeping the elements
+ * of a cell contiguous in memory. Each element is then only tested against the elements of the 27 cells around it.
+ *
+ * The expected cost is linear in the number of elements, which suits large populations of elements of similar
+ * sizes, such as particles or spheres, better than a bounding volume hierarchy. A few elements much larger than
+ * the others make the cells large, and the detection slower.
+ * The grid is built and searched in parallel if the Data parallel is true. The pairs are the same in any case.
+ */
+class SOFA_COMPONENT_COLLISION_DETECTION_ALGORITHM_API SpatialHashNarrowPhase : public core::collision::NarrowPhaseDetection
+{
+public:
+    SOFA_CLASS(SpatialHashNarrowPhase, core::collision::NarrowPhaseDetection);
+
+    using Cell = std::array<std::int64_t, 3>;
+
+private:
+
+    Data<int> d_nbPairs; ///< number of pairs of elements sent to narrow phase
+    Data<SReal> d_cellSize; ///< size of the cells of the grid, computed from the largest element and the alarm distance
+    Data<bool> d_parallel; ///< If true, the grid is built and searched in parallel
+
+    /// Data of a collision model whose elements are placed in the grid
+    struct ModelData
+    {
+        core::CollisionModel* lastCollisionModel{nullptr};
+        collision::geometry::CubeCollisionModel* leafCubeModel{nullptr}; ///< one cube per element of lastCollisionModel
+        sofa::core::objectmodel::BaseContext* context{nullptr};
+        bool isSimulated{false};
+        bool doesSelfCollide{false};
+        std::size_t firstBoxId{0}; ///< id of the box of the first element of the model
+    };
+
+    /// Bounding box of an element, and its cell in the grid
+    struct Box
+    {
+        type::Vec3 min;
+        type::Vec3 max;
+        Cell cell{};
+        int id{0};
+        int modelId{0};
+        sofa::Index elementIndex{0}; ///< index of the element in the last collision model
+    };
+
+    /// The collision models of the broad phase, in the order in which they were added
+    sofa::type::vector<core::CollisionModel*> m_broadPhaseCollisionModels;
+    std::unordered_set<core::CollisionModel*> m_addedCollisionModels;
+
+    sofa::type::vector<ModelData> m_models;
+    sofa::type::vector<Box> m_boxes; ///< the boxes, in the order of the models and their elements
+    sofa::type::vector<Box> m_sortedBoxes; ///< the boxes, sorted by bucket of the hash table
+    sofa::type::vector<std::size_t> m_boxBuckets; ///< bucket of each box
+    std::size_t m_bucketMask{0}; ///< the number of buckets is a power of two, this mask gives the bucket of a hash
+    sofa::type::vector<std::size_t> m_bucketBegins; ///< position of the first box of each bucket in m_sortedBoxes
+    sofa::type::vector<sofa::type::vector<std::size_t> > m_histograms; ///< number of boxes per bucket, for each block of boxes
+    sofa::type::vector<std::size_t> m_bucketRangeSizes; ///< number of boxes in each range of buckets
+
+    /// Pairs of positions in m_sortedBoxes found by each part of the search
+    sofa::type::vector<sofa::type::vector<std::pair<std::size_t, std::size_t> > > m_partPairs;
+
+    double m_alarmDist{0};
+    double m_sq_alarmDist{0};
+    double m_cellSize{1};
+
+    ParallelNarrowPhaseHelper m_helper;
+
+    /// Collision models without leaf cubes, which have already been reported
+    std::unordered_set<core::CollisionModel*> m_modelsWithoutLeafCubes;
+
+protected:
+    SpatialHashNarrowPhase();
+
+    ~SpatialHashNarrowPhase() override = default;
+
+    /// Collect the models of the broad phase and the boxes of their elements.
+    /// The models without a leaf cube per element are ignored, with a warning.
+    void collectBoxes();
+
+    /// Compute the size of the cells, and place the boxes in the cells and the buckets of the hash table
+    void computeCells();
+
+    /// Counting sort of the boxes by bucket
+    void sortBoxes();
+
+    /// Test each box against the boxes of the neighbouring cells
+    void findPairs();
+
+    /// Send the pairs found to the intersection method
+    void intersectPairs();
+
+    bool isPairFiltered(const Box& box0, const Box& box1) const;
+
+    std::size_t getBucket(const Cell& cell) const;
+
+    /// Number of parts in which the computations on nbBoxes boxes are split, 1 if they are sequential
+    std::size_t getNbParallelParts(std::size_t nbBoxes) const;
+
+public:
+
+    void init() override;
+
+    void reset() override;
+
+    void beginNarrowPhase() override;
+
+    void addCollisionPair(const std::pair<core::CollisionModel *, core::CollisionModel *> &cmPair) override;
+
+    void endNarrowPhase() override;
+
+    /// Bounding tree is not required by this detection algorithm
+    bool needsDeepBoundingTree() const override { return false; }
+};
+
+}
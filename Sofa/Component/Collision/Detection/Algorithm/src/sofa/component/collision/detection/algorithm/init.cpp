@@ -35,6 +35,7 @@ extern void registerDirectSAPNarrowPhase(sofa::core::ObjectFactory* factory);
 extern void registerIncrSAP(sofa::core::ObjectFactory* factory);
 extern void registerRayTraceDetection(sofa::core::ObjectFactory* factory);
 extern void registerRayTraceNarrowPhase(sofa::core::ObjectFactory* factory);
+extern void registerSpatialHashNarrowPhase(sofa::core::ObjectFactory* factory);
 
 extern "C" {
     SOFA_EXPORT_DYNAMIC_LIBRARY void initExternalModule();
@@ -70,6 +71,7 @@ void registerObjects(sofa::core::ObjectFactory* factory)
     registerIncrSAP(factory);
     registerRayTraceDetection(factory);
     registerRayTraceNarrowPhase(factory);
+    registerSpatialHashNarrowPhase(factory);
 }
 
 void init()
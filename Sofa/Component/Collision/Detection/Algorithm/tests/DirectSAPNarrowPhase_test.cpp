@@ -0,0 +1,138 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include "NarrowPhase_test.h"
+
+namespace
+{
+
+using namespace sofa;
+
+/// The contacts found by DirectSAPNarrowPhase must be the ones found by testing all the pairs of spheres, must not
+/// depend on the parallelism, and must be the same when the end points are sorted from scratch or from the order of
+/// the previous step
+struct DirectSAPNarrowPhase_test : public NarrowPhase_test
+{
+    NarrowPhaseDetection* m_sequentialNarrowPhase { nullptr };
+    NarrowPhaseDetection* m_parallelNarrowPhase { nullptr };
+
+    void doSetUp() override
+    {
+        NarrowPhase_test::doSetUp();
+
+        createScene({
+            {"DirectSAPNarrowPhase", {{"name", "sequential"}}},
+            {"DirectSAPNarrowPhase", {{"name", "parallel"}, {"parallel", "true"}}}
+        }, 0.01, false);
+
+        m_sequentialNarrowPhase = getNarrowPhase("sequential");
+        m_parallelNarrowPhase = getNarrowPhase("parallel");
+        ASSERT_NE(m_sequentialNarrowPhase, nullptr);
+        ASSERT_NE(m_parallelNarrowPhase, nullptr);
+    }
+
+    /// The contacts between the two grids, found by testing all the pairs of spheres as MinProximityIntersection does
+    type::vector<Contact> getBruteForceContacts() const
+    {
+        const SReal alarmDistance = m_intersection->getAlarmDistance();
+        const SReal contactDistance = m_intersection->getContactDistance();
+        const SReal radius0 = std::stod(m_collisionModels[0]->findData("radius")->getValueString());
+        const SReal radius1 = std::stod(m_collisionModels[1]->findData("radius")->getValueString());
+
+        const auto& x0 = m_states[0]->read(core::vec_id::read_access::position)->getValue();
+        const auto& x1 = m_states[1]->read(core::vec_id::read_access::position)->getValue();
+
+        type::vector<Contact> contacts;
+        for (sofa::Index i = 0; i < x0.size(); ++i)
+        {
+            for (sofa::Index j = 0; j < x1.size(); ++j)
+            {
+                const SReal distance = (x1[j] - x0[i]).norm();
+                if (distance <= alarmDistance + radius0 + radius1)
+                {
+                    contacts.emplace_back(m_collisionModels[0], m_collisionModels[1], i, j, distance - radius0 - radius1 - contactDistance);
+                }
+            }
+        }
+        return contacts;
+    }
+
+    /// The contacts are compared to the brute force ones without their distances, which are compared separately
+    /// with a tolerance
+    void expectSameContacts(type::vector<Contact> contacts, const type::vector<Contact>& bruteForceContacts) const
+    {
+        // the brute force contacts are given from the first grid to the second one
+        for (auto& [model0, model1, element0, element1, value] : contacts)
+        {
+            if (model0 == m_collisionModels[1])
+            {
+                std::swap(model0, model1);
+                std::swap(element0, element1);
+            }
+        }
+
+        const auto sortedContacts = sorted(contacts);
+        const auto sortedBruteForceContacts = sorted(bruteForceContacts);
+        ASSERT_EQ(sortedContacts.size(), sortedBruteForceContacts.size());
+        for (std::size_t i = 0; i < sortedContacts.size(); ++i)
+        {
+            const auto& [model0, model1, element0, element1, value] = sortedContacts[i];
+            const auto& [bruteForceModel0, bruteForceModel1, bruteForceElement0, bruteForceElement1, bruteForceValue] = sortedBruteForceContacts[i];
+            ASSERT_EQ(std::tie(model0, model1, element0, element1),
+                      std::tie(bruteForceModel0, bruteForceModel1, bruteForceElement0, bruteForceElement1)) << "contact " << i;
+            EXPECT_NEAR(value, bruteForceValue, 1e-10) << "contact " << i;
+        }
+    }
+
+    void compareDetections()
+    {
+        computeBoundingTrees();
+
+        detect(m_sequentialNarrowPhase, false);
+        detect(m_parallelNarrowPhase, false);
+
+        expectSameNbPairs(m_sequentialNarrowPhase, m_parallelNarrowPhase);
+
+        const auto sequentialContacts = getContacts(m_sequentialNarrowPhase);
+        EXPECT_GT(sequentialContacts.size(), 0);
+        EXPECT_EQ(sequentialContacts, getContacts(m_parallelNarrowPhase));
+
+        expectSameContacts(sequentialContacts, getBruteForceContacts());
+    }
+};
+
+TEST_F(DirectSAPNarrowPhase_test, sameContactsInParallel)
+{
+    compareDetections();
+
+    // small motions: the end points are sorted from their previous order
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+        move(0.0002, 0.0004);
+        compareDetections();
+    }
+
+    // large motion: the end points are sorted from scratch
+    move(0.05, 0.0);
+    compareDetections();
+}
+
+}
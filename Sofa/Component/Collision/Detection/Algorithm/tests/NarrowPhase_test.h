@@ -0,0 +1,212 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+
+#include <sofa/testing/BaseSimulationTest.h>
+#include <sofa/testing/ScopedTaskScheduler.h>
+
+#include <sofa/core/CollisionModel.h>
+#include <sofa/core/behavior/MechanicalState.h>
+#include <sofa/core/collision/Intersection.h>
+#include <sofa/core/collision/NarrowPhaseDetection.h>
+#include <sofa/defaulttype/VecTypes.h>
+#include <sofa/simulation/Node.h>
+#include <sofa/simulation/Simulation.h>
+#include <sofa/simpleapi/SimpleApi.h>
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <optional>
+#include <sstream>
+#include <tuple>
+
+namespace sofa
+{
+
+/// Scene of two grids of spheres close to each other, in which the contacts found by several narrow phases
+/// are compared. The narrow phases run on a task scheduler of 4 threads.
+class NarrowPhase_test : public sofa::testing::BaseSimulationTest
+{
+public:
+    using MechanicalState = core::behavior::MechanicalState<defaulttype::Vec3Types>;
+    using NarrowPhaseDetection = core::collision::NarrowPhaseDetection;
+
+    /// Models and elements of a contact, and its distance
+    using Contact = std::tuple<core::CollisionModel*, core::CollisionModel*, sofa::Index, sofa::Index, SReal>;
+
+protected:
+    simulation::Node::SPtr m_root;
+    type::vector<core::CollisionModel*> m_collisionModels;
+    type::vector<MechanicalState*> m_states;
+    core::collision::Intersection* m_intersection { nullptr };
+    std::optional<sofa::testing::ScopedTaskScheduler> m_taskScheduler;
+
+    static constexpr int gridSize = 20;
+
+    /// Positions of the points of a grid, whose columns of 8 points are spaced by columnSpacing
+    static std::string gridPositions(double offset, double columnSpacing)
+    {
+        std::ostringstream positions;
+        for (int i = 0; i < gridSize; ++i)
+        {
+            for (int j = 0; j < gridSize; ++j)
+            {
+                for (int k = 0; k < 8; ++k)
+                {
+                    positions << 0.1 * i + offset << " " << 0.1 * j + columnSpacing * k << " " << 0.02 * std::sin(i + j + k + offset) << " ";
+                }
+            }
+        }
+        return positions.str();
+    }
+
+    void doSetUp() override
+    {
+        this->loadPlugins({
+            Sofa.Component.StateContainer,
+            Sofa.Component.Collision.Geometry,
+            Sofa.Component.Collision.Detection.Algorithm,
+            Sofa.Component.Collision.Detection.Intersection
+        });
+
+        m_taskScheduler.emplace(4);
+    }
+
+    void doTearDown() override
+    {
+        if (m_root != nullptr)
+        {
+            sofa::simulation::node::unload(m_root);
+        }
+        m_taskScheduler.reset();
+    }
+
+    /// Create the scene with the narrow phases given by their class and their Data, and two grids of spheres.
+    /// The first grid can collide with itself if selfCollision is true.
+    void createScene(const type::vector<std::pair<std::string, std::map<std::string, std::string> > >& narrowPhases, double columnSpacing, bool selfCollision)
+    {
+        m_root = simulation::getSimulation()->createNewGraph("root");
+        simpleapi::createObject(m_root, "DefaultAnimationLoop");
+        simpleapi::createObject(m_root, "MinProximityIntersection", {{"name", "intersection"}, {"alarmDistance", "0.02"}, {"contactDistance", "0.005"}});
+        for (const auto& [className, data] : narrowPhases)
+        {
+            simpleapi::createObject(m_root, className, data);
+        }
+
+        for (unsigned int i = 0; i < 2; ++i)
+        {
+            const auto node = simpleapi::createChild(m_root, "object" + std::to_string(i));
+            simpleapi::createObject(node, "MechanicalObject", {{"position", gridPositions(0.03 * i, columnSpacing)}});
+            simpleapi::createObject(node, "SphereCollisionModel", {{"radius", "0.01"}, {"selfCollision", selfCollision && i == 0 ? "true" : "false"}});
+        }
+
+        sofa::simulation::node::initRoot(m_root.get());
+
+        m_intersection = dynamic_cast<core::collision::Intersection*>(m_root->getObject("intersection"));
+        ASSERT_NE(m_intersection, nullptr);
+
+        m_root->getTreeObjects<core::CollisionModel>(&m_collisionModels);
+        m_root->getTreeObjects<MechanicalState>(&m_states);
+        ASSERT_EQ(m_collisionModels.size(), 2);
+        ASSERT_EQ(m_states.size(), 2);
+    }
+
+    NarrowPhaseDetection* getNarrowPhase(const std::string& name) const
+    {
+        return dynamic_cast<NarrowPhaseDetection*>(m_root->getObject(name));
+    }
+
+    /// Move the points of the second grid
+    void move(double dx, double dz)
+    {
+        auto x = sofa::helper::getWriteAccessor(*m_states[1]->write(core::vec_id::write_access::position));
+        for (std::size_t i = 0; i < x.size(); ++i)
+        {
+            x[i][0] += dx * std::cos(3.0 * i);
+            x[i][2] += dz * std::sin(1.0 * i);
+        }
+    }
+
+    void computeBoundingTrees()
+    {
+        for (auto* collisionModel : m_collisionModels)
+        {
+            collisionModel->computeBoundingTree(0);
+        }
+    }
+
+    /// Run the narrow phase on the pair of grids, and on the pair of the first grid with itself if selfCollision is true
+    void detect(NarrowPhaseDetection* narrowPhase, bool selfCollision) const
+    {
+        narrowPhase->setIntersectionMethod(m_intersection);
+        narrowPhase->beginNarrowPhase();
+        if (selfCollision)
+        {
+            narrowPhase->addCollisionPair({ m_collisionModels[0]->getFirst(), m_collisionModels[0]->getFirst() });
+        }
+        narrowPhase->addCollisionPair({ m_collisionModels[0]->getFirst(), m_collisionModels[1]->getFirst() });
+        narrowPhase->endNarrowPhase();
+    }
+
+    /// The contacts found by a narrow phase, in their order
+    static type::vector<Contact> getContacts(NarrowPhaseDetection* narrowPhase)
+    {
+        type::vector<Contact> contacts;
+        for (const auto& [collisionModels, outputs] : narrowPhase->getDetectionOutputs())
+        {
+            const auto* detectionOutputs = dynamic_cast<type::vector<core::collision::DetectionOutput>*>(outputs);
+            if (detectionOutputs == nullptr)
+            {
+                continue;
+            }
+            for (const auto& output : *detectionOutputs)
+            {
+                contacts.emplace_back(collisionModels.first, collisionModels.second,
+                    output.elem.first.getIndex(), output.elem.second.getIndex(), output.value);
+            }
+        }
+        return contacts;
+    }
+
+    /// The contacts, in an order independent of the narrow phase
+    static type::vector<Contact> sorted(type::vector<Contact> contacts)
+    {
+        for (auto& [model0, model1, element0, element1, value] : contacts)
+        {
+            if (model0 == model1 && element0 > element1)
+            {
+                std::swap(element0, element1);
+            }
+        }
+        std::sort(contacts.begin(), contacts.end());
+        return contacts;
+    }
+
+    static void expectSameNbPairs(NarrowPhaseDetection* narrowPhase0, NarrowPhaseDetection* narrowPhase1)
+    {
+        EXPECT_EQ(narrowPhase0->findData("nbPairs")->getValueString(),
+                  narrowPhase1->findData("nbPairs")->getValueString());
+    }
+};
+
+}
@@ -0,0 +1,110 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include "NarrowPhase_test.h"
+
+namespace
+{
+
+using namespace sofa;
+
+/// The contacts found by SpatialHashNarrowPhase must be the ones found by DirectSAPNarrowPhase, for pairs of
+/// elements of the same model and of different models, and must not depend on the parallelism
+struct SpatialHashNarrowPhase_test : public NarrowPhase_test
+{
+    NarrowPhaseDetection* m_referenceNarrowPhase { nullptr };
+    NarrowPhaseDetection* m_sequentialNarrowPhase { nullptr };
+    NarrowPhaseDetection* m_parallelNarrowPhase { nullptr };
+
+    void doSetUp() override
+    {
+        NarrowPhase_test::doSetUp();
+
+        createScene({
+            {"DirectSAPNarrowPhase", {{"name", "reference"}}},
+            {"SpatialHashNarrowPhase", {{"name", "sequential"}}},
+            {"SpatialHashNarrowPhase", {{"name", "parallel"}, {"parallel", "true"}}}
+        }, 0.019, true);
+
+        m_referenceNarrowPhase = getNarrowPhase("reference");
+        m_sequentialNarrowPhase = getNarrowPhase("sequential");
+        m_parallelNarrowPhase = getNarrowPhase("parallel");
+        ASSERT_NE(m_referenceNarrowPhase, nullptr);
+        ASSERT_NE(m_sequentialNarrowPhase, nullptr);
+        ASSERT_NE(m_parallelNarrowPhase, nullptr);
+    }
+
+    void compareDetections()
+    {
+        computeBoundingTrees();
+
+        detect(m_referenceNarrowPhase, true);
+        detect(m_sequentialNarrowPhase, true);
+        detect(m_parallelNarrowPhase, true);
+
+        expectSameNbPairs(m_referenceNarrowPhase, m_sequentialNarrowPhase);
+        expectSameNbPairs(m_sequentialNarrowPhase, m_parallelNarrowPhase);
+
+        const auto referenceContacts = getContacts(m_referenceNarrowPhase);
+        const auto sequentialContacts = getContacts(m_sequentialNarrowPhase);
+        const auto parallelContacts = getContacts(m_parallelNarrowPhase);
+
+        EXPECT_GT(referenceContacts.size(), 0);
+        EXPECT_EQ(sorted(referenceContacts), sorted(sequentialContacts));
+        EXPECT_EQ(sequentialContacts, parallelContacts);
+
+        const bool hasSelfContacts = std::any_of(sequentialContacts.begin(), sequentialContacts.end(),
+            [](const Contact& contact) { return std::get<0>(contact) == std::get<1>(contact); });
+        EXPECT_TRUE(hasSelfContacts);
+    }
+};
+
+TEST_F(SpatialHashNarrowPhase_test, sameContactsAsDirectSAP)
+{
+    compareDetections();
+
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+        move(0.002, 0.004);
+        compareDetections();
+    }
+
+    move(0.05, 0.0);
+    compareDetections();
+}
+
+TEST_F(SpatialHashNarrowPhase_test, warningForModelsWithoutLeafCubes)
+{
+    // without bounding tree, the collision models have no cube per element
+    {
+        EXPECT_MSG_EMIT(Warning);
+        detect(m_sequentialNarrowPhase, true);
+    }
+    EXPECT_TRUE(getContacts(m_sequentialNarrowPhase).empty());
+
+    // the warning is given once per model
+    {
+        EXPECT_MSG_NOEMIT(Warning);
+        detect(m_sequentialNarrowPhase, true);
+    }
+}
+
+}
@@ -0,0 +1,431 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/component/collision/detection/intersection/ContinuousProximityIntersection.h>
+#include <sofa/core/ObjectFactory.h>
+#include <sofa/core/collision/Intersection.inl>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+
+namespace sofa::component::collision::detection::intersection
+{
+
+using namespace sofa::type;
+using namespace sofa::defaulttype;
+using namespace sofa::core::collision;
+using namespace sofa::component::collision::geometry;
+
+void registerContinuousProximityIntersection(sofa::core::ObjectFactory* factory)
+{
+    factory->registerObjects(core::ObjectRegistrationData("A set of methods to compute the first time of impact of primitives moving during the time step, to avoid that they pass through each other.")
+        .add< ContinuousProximityIntersection >());
+}
+
+namespace
+{
+
+/// A polynomial of degree 3, the coefficients being sorted by increasing degree
+using Cubic = std::array<SReal, 4>;
+
+SReal evaluate(const Cubic& f, SReal t)
+{
+    return ((f[3] * t + f[2]) * t + f[1]) * t + f[0];
+}
+
+/// Coefficients of the triple product (u + t du) x (v + t dv) . (w + t dw)
+Cubic tripleProduct(const Vec3& u, const Vec3& du, const Vec3& v, const Vec3& dv, const Vec3& w, const Vec3& dw)
+{
+    const Vec3 c0 = u.cross(v);
+    const Vec3 c1 = u.cross(dv) + du.cross(v);
+    const Vec3 c2 = du.cross(dv);
+    return { c0 * w, c0 * dw + c1 * w, c1 * dw + c2 * w, c2 * dw };
+}
+
+/// Times in [0,1] at which the primitives can be in contact, sorted.
+/// f is zero when the primitives are coplanar, which is required to cross each other. The extrema of f are
+/// also candidates, as the primitives can be close without being exactly coplanar, as well as the end
+/// of the motion.
+struct CandidateTimes
+{
+    std::array<SReal, 6> times;
+    std::size_t size { 0 };
+
+    void add(SReal t)
+    {
+        if (t >= 0 && t <= 1)
+        {
+            times[size++] = t;
+        }
+    }
+
+    explicit CandidateTimes(const Cubic& f)
+    {
+        // extrema: roots of 3 f3 t^2 + 2 f2 t + f1, computed without cancellation
+        std::array<SReal, 4> bounds { 0, 0, 0, 1 };
+        std::size_t nbBounds = 1;
+        const SReal a = 3 * f[3];
+        const SReal b = 2 * f[2];
+        const SReal c = f[1];
+        const SReal discriminant = b * b - 4 * a * c;
+        if (discriminant >= 0)
+        {
+            const SReal q = -0.5 * (b + std::copysign(std::sqrt(discriminant), b));
+            for (const SReal extremum : { (a != 0) ? q / a : SReal(-1), (q != 0) ? c / q : SReal(-1) })
+            {
+                if (extremum > 0 && extremum < 1)
+                {
+                    bounds[nbBounds++] = extremum;
+                    add(extremum);
+                }
+            }
+        }
+        bounds[nbBounds++] = 1;
+        std::sort(bounds.begin(), bounds.begin() + nbBounds);
+
+        // roots: f is monotonic between two successive bounds, the roots are found by bisection
+        for (std::size_t i = 0; i + 1 < nbBounds; ++i)
+        {
+            SReal t0 = bounds[i];
+            SReal t1 = bounds[i + 1];
+            SReal f0 = evaluate(f, t0);
+            const SReal f1 = evaluate(f, t1);
+            if (f0 == 0)
+            {
+                add(t0);
+                continue;
+            }
+            if ((f0 < 0) == (f1 < 0) && f1 != 0)
+            {
+                continue;
+            }
+
+            for (unsigned int iteration = 0; iteration < 64 && t1 - t0 > 1e-12; ++iteration)
+            {
+                const SReal t = 0.5 * (t0 + t1);
+                const SReal ft = evaluate(f, t);
+                if ((ft < 0) == (f0 < 0) && ft != 0)
+                {
+                    t0 = t;
+                    f0 = ft;
+                }
+                else
+                {
+                    t1 = t;
+                }
+            }
+            add(t1);
+        }
+
+        add(1);
+        std::sort(times.begin(), times.begin() + size);
+    }
+};
+
+/// True if two points at the squared distance squaredDistance are within the distance. A zero distance still accepts
+/// the points in contact, up to the rounding errors relative to the squared size of the primitives.
+bool isWithinDistance(SReal squaredDistance, SReal distance, SReal squaredSize)
+{
+    return squaredDistance <= distance * distance + std::numeric_limits<SReal>::epsilon() * squaredSize;
+}
+
+/// Projection of p on the triangle abc: p - (a + ab * alpha + ac * beta) is orthogonal to the triangle
+bool projectOnTriangle(const Vec3& p, const Vec3& a, const Vec3& b, const Vec3& c, SReal distance, SReal& alpha, SReal& beta)
+{
+    const Vec3 AB = b - a;
+    const Vec3 AC = c - a;
+    const Vec3 AP = p - a;
+
+    const SReal A00 = AB * AB;
+    const SReal A11 = AC * AC;
+    const SReal A01 = AB * AC;
+    const SReal det = A00 * A11 - A01 * A01;
+    if (det <= 1e-18)
+    {
+        return false;
+    }
+
+    alpha = ((AP * AB) * A11 - (AP * AC) * A01) / det;
+    beta = ((AP * AC) * A00 - (AP * AB) * A01) / det;
+    if (alpha < 0 || beta < 0 || alpha + beta > 1)
+    {
+        return false;
+    }
+
+    return isWithinDistance((AP - AB * alpha - AC * beta).norm2(), distance, A00 + A11);
+}
+
+/// Closest points of the segments ab and cd, a + ab * alpha and c + cd * beta, if they are inside the segments
+bool projectSegments(const Vec3& a, const Vec3& b, const Vec3& c, const Vec3& d, SReal distance, SReal& alpha, SReal& beta)
+{
+    const Vec3 AB = b - a;
+    const Vec3 CD = d - c;
+    const Vec3 AC = c - a;
+
+    const SReal A00 = AB * AB;
+    const SReal A11 = CD * CD;
+    const SReal A01 = -(AB * CD);
+    const SReal det = A00 * A11 - A01 * A01;
+    if (det <= 1e-18)
+    {
+        return false;
+    }
+
+    alpha = ((AB * AC) * A11 + (CD * AC) * A01) / det;
+    beta = (-(CD * AC) * A00 - (AB * AC) * A01) / det;
+    if (alpha < 0 || alpha > 1 || beta < 0 || beta > 1)
+    {
+        return false;
+    }
+
+    return isWithinDistance((AC + CD * beta - AB * alpha).norm2(), distance, A00 + A11);
+}
+
+}
+
+ContinuousProximityIntersection::ContinuousProximityIntersection()
+    : BaseProximityIntersection()
+{
+}
+
+void ContinuousProximityIntersection::init()
+{
+    intersectors.add<CubeCollisionModel, CubeCollisionModel, ContinuousProximityIntersection>(this);
+    intersectors.add<TriangleCollisionModel<Vec3Types>, PointCollisionModel<Vec3Types>, ContinuousProximityIntersection>(this);
+    intersectors.add<LineCollisionModel<Vec3Types>, LineCollisionModel<Vec3Types>, ContinuousProximityIntersection>(this);
+
+    // the contacts of the other pairs of a mesh are found by the supported pairs
+    intersectors.ignore<PointCollisionModel<Vec3Types>, PointCollisionModel<Vec3Types>>();
+    intersectors.ignore<LineCollisionModel<Vec3Types>, PointCollisionModel<Vec3Types>>();
+    intersectors.ignore<TriangleCollisionModel<Vec3Types>, LineCollisionModel<Vec3Types>>();
+    intersectors.ignore<TriangleCollisionModel<Vec3Types>, TriangleCollisionModel<Vec3Types>>();
+
+    BaseProximityIntersection::init();
+}
+
+bool ContinuousProximityIntersection::testIntersection(Cube& cube1, Cube& cube2, const core::collision::Intersection* currentIntersection)
+{
+    return BaseProximityIntersection::testIntersection(cube1, cube2, currentIntersection);
+}
+
+int ContinuousProximityIntersection::computeIntersection(Cube& cube1, Cube& cube2, OutputVector* contacts, const core::collision::Intersection* currentIntersection)
+{
+    return BaseProximityIntersection::computeIntersection(cube1, cube2, contacts, currentIntersection);
+}
+
+bool ContinuousProximityIntersection::computeTimeOfImpactPointTriangle(const Vec3& p, const Vec3& dp,
+                                                                       const Vec3& a, const Vec3& da,
+                                                                       const Vec3& b, const Vec3& db,
+                                                                       const Vec3& c, const Vec3& dc,
+                                                                       SReal distance, SReal& t, SReal& alpha, SReal& beta)
+{
+    const CandidateTimes candidates(tripleProduct(b - a, db - da, c - a, dc - da, p - a, dp - da));
+    for (std::size_t i = 0; i < candidates.size; ++i)
+    {
+        t = candidates.times[i];
+        if (projectOnTriangle(p + dp * t, a + da * t, b + db * t, c + dc * t, distance, alpha, beta))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ContinuousProximityIntersection::computeTimeOfImpactEdgeEdge(const Vec3& a, const Vec3& da,
+                                                                  const Vec3& b, const Vec3& db,
+                                                                  const Vec3& c, const Vec3& dc,
+                                                                  const Vec3& d, const Vec3& dd,
+                                                                  SReal distance, SReal& t, SReal& alpha, SReal& beta)
+{
+    const CandidateTimes candidates(tripleProduct(b - a, db - da, d - c, dd - dc, c - a, dc - da));
+    for (std::size_t i = 0; i < candidates.size; ++i)
+    {
+        t = candidates.times[i];
+        if (projectSegments(a + da * t, b + db * t, c + dc * t, d + dd * t, distance, alpha, beta))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ContinuousProximityIntersection::computeContact(Triangle& triangle, Point& point, const core::collision::Intersection* currentIntersection, Contact& contact) const
+{
+    const SReal proximity = triangle.getProximity() + point.getProximity();
+    const SReal alarmDist = currentIntersection->getAlarmDistance() + proximity;
+    const SReal contactDist = currentIntersection->getContactDistance() + proximity;
+
+    const Vec3& p = point.p();
+    const Vec3& a = triangle.p1();
+    const Vec3& b = triangle.p2();
+    const Vec3& c = triangle.p3();
+
+    SReal alpha, beta;
+    if (projectOnTriangle(p, a, b, c, alarmDist, alpha, beta))
+    {
+        contact.point[0] = a + (b - a) * alpha + (c - a) * beta;
+        contact.point[1] = p;
+        contact.normal = contact.point[1] - contact.point[0];
+        const SReal norm = contact.normal.norm();
+        if (norm > 1e-15)
+        {
+            contact.normal /= norm;
+        }
+        else
+        {
+            contact.normal = triangle.n();
+        }
+        contact.value = norm - contactDist;
+        return true;
+    }
+
+    const SReal dt = this->getContext()->getDt();
+    SReal t;
+    if (!computeTimeOfImpactPointTriangle(p, point.v() * dt, a, triangle.v1() * dt, b, triangle.v2() * dt, c, triangle.v3() * dt,
+                                          contactDist, t, alpha, beta))
+    {
+        return false;
+    }
+
+    contact.normal = (b - a).cross(c - a);
+    const SReal norm = contact.normal.norm();
+    if (norm <= 1e-15)
+    {
+        return false;
+    }
+    contact.normal /= norm;
+
+    contact.point[0] = a + (b - a) * alpha + (c - a) * beta;
+    contact.point[1] = p;
+    if (contact.normal * (contact.point[1] - contact.point[0]) < 0)
+    {
+        contact.normal = -contact.normal;
+    }
+    contact.value = contact.normal * (contact.point[1] - contact.point[0]) - contactDist;
+    return true;
+}
+
+bool ContinuousProximityIntersection::computeContact(Line& line1, Line& line2, const core::collision::Intersection* currentIntersection, Contact& contact) const
+{
+    const SReal proximity = line1.getProximity() + line2.getProximity();
+    const SReal alarmDist = currentIntersection->getAlarmDistance() + proximity;
+    const SReal contactDist = currentIntersection->getContactDistance() + proximity;
+
+    const Vec3& a = line1.p1();
+    const Vec3& b = line1.p2();
+    const Vec3& c = line2.p1();
+    const Vec3& d = line2.p2();
+
+    SReal alpha, beta;
+    if (projectSegments(a, b, c, d, alarmDist, alpha, beta))
+    {
+        contact.point[0] = a + (b - a) * alpha;
+        contact.point[1] = c + (d - c) * beta;
+        contact.normal = contact.point[1] - contact.point[0];
+        const SReal norm = contact.normal.norm();
+        if (norm <= 1e-15)
+        {
+            return false;
+        }
+        contact.normal /= norm;
+        contact.value = norm - contactDist;
+        return true;
+    }
+
+    const SReal dt = this->getContext()->getDt();
+    SReal t;
+    if (!computeTimeOfImpactEdgeEdge(a, line1.v1() * dt, b, line1.v2() * dt, c, line2.v1() * dt, d, line2.v2() * dt,
+                                     contactDist, t, alpha, beta))
+    {
+        return false;
+    }
+
+    contact.normal = (b - a).cross(d - c);
+    const SReal norm = contact.normal.norm();
+    if (norm <= 1e-15)
+    {
+        return false;
+    }
+    contact.normal /= norm;
+
+    contact.point[0] = a + (b - a) * alpha;
+    contact.point[1] = c + (d - c) * beta;
+    if (contact.normal * (contact.point[1] - contact.point[0]) < 0)
+    {
+        contact.normal = -contact.normal;
+    }
+    contact.value = contact.normal * (contact.point[1] - contact.point[0]) - contactDist;
+    return true;
+}
+
+bool ContinuousProximityIntersection::testIntersection(Triangle& triangle, Point& point, const core::collision::Intersection* currentIntersection)
+{
+    Contact contact;
+    return computeContact(triangle, point, currentIntersection, contact);
+}
+
+int ContinuousProximityIntersection::computeIntersection(Triangle& triangle, Point& point, OutputVector* contacts, const core::collision::Intersection* currentIntersection)
+{
+    Contact contact;
+    if (!computeContact(triangle, point, currentIntersection, contact))
+    {
+        return 0;
+    }
+
+    contacts->resize(contacts->size() + 1);
+    DetectionOutput* detection = &*(contacts->end() - 1);
+    detection->elem = std::pair<core::CollisionElementIterator, core::CollisionElementIterator>(triangle, point);
+    detection->id = point.getIndex();
+    detection->point[0] = contact.point[0];
+    detection->point[1] = contact.point[1];
+    detection->normal = contact.normal;
+    detection->value = contact.value;
+    return 1;
+}
+
+bool ContinuousProximityIntersection::testIntersection(Line& line1, Line& line2, const core::collision::Intersection* currentIntersection)
+{
+    Contact contact;
+    return computeContact(line1, line2, currentIntersection, contact);
+}
+
+int ContinuousProximityIntersection::computeIntersection(Line& line1, Line& line2, OutputVector* contacts, const core::collision::Intersection* currentIntersection)
+{
+    Contact contact;
+    if (!computeContact(line1, line2, currentIntersection, contact))
+    {
+        return 0;
+    }
+
+    contacts->resize(contacts->size() + 1);
+    DetectionOutput* detection = &*(contacts->end() - 1);
+    detection->elem = std::pair<core::CollisionElementIterator, core::CollisionElementIterator>(line1, line2);
+    detection->id = (line1.getCollisionModel()->getSize() > line2.getCollisionModel()->getSize()) ? line1.getIndex() : line2.getIndex();
+    detection->point[0] = contact.point[0];
+    detection->point[1] = contact.point[1];
+    detection->normal = contact.normal;
+    detection->value = contact.value;
+    return 1;
+}
+
+} // namespace sofa::component::collision::detection::intersection
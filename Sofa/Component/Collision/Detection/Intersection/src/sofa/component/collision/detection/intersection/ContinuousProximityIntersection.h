@@ -0,0 +1,107 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+#include <sofa/component/collision/detection/intersection/config.h>
+
+#include <sofa/component/collision/detection/intersection/BaseProximityIntersection.h>
+#include <sofa/component/collision/geometry/TriangleModel.h>
+#include <sofa/component/collision/geometry/LineModel.h>
+#include <sofa/component/collision/geometry/PointModel.h>
+
+namespace sofa::component::collision::detection::intersection
+{
+
+/**
+ * Continuous intersection methods using proximities, to avoid that fast primitives pass through each other
+ * during a time step.
+ * The motion of a primitive during the time step goes from its current position x to x + v * dt, as in the
+ * bounding volumes computed by computeContinuousBoundingTree, which the collision pipeline uses when
+ * useContinuous() is true.
+ *
+ * A pair of primitives closer than the alarm distance gives a contact, as with MinProximityIntersection.
+ * Otherwise, the first time of impact during the motion is computed, i.e. the first time where the
+ * primitives are closer than the contact distance. Then, the contact is created at the current positions,
+ * at the barycentric coordinates of the impact, with the normal of the primitives oriented from their
+ * current configuration. The constraint response then prevents the crossing.
+ *
+ * Supported:
+ * - Cube/Cube
+ * - Triangle/Point
+ * - Line/Line
+ */
+class SOFA_COMPONENT_COLLISION_DETECTION_INTERSECTION_API ContinuousProximityIntersection : public BaseProximityIntersection
+{
+public:
+    SOFA_CLASS(ContinuousProximityIntersection, BaseProximityIntersection);
+
+protected:
+    ContinuousProximityIntersection();
+
+public:
+    void init() override;
+
+    /// Returns true: the bounding volumes must contain the motion of the primitives during the time step
+    bool useContinuous() const override { return true; }
+
+    bool testIntersection(collision::geometry::Cube& cube1, collision::geometry::Cube& cube2, const core::collision::Intersection* currentIntersection) override;
+    int computeIntersection(collision::geometry::Cube& cube1, collision::geometry::Cube& cube2, OutputVector* contacts, const core::collision::Intersection* currentIntersection) override;
+
+    bool testIntersection(collision::geometry::Triangle& triangle, collision::geometry::Point& point, const core::collision::Intersection* currentIntersection);
+    int computeIntersection(collision::geometry::Triangle& triangle, collision::geometry::Point& point, OutputVector* contacts, const core::collision::Intersection* currentIntersection);
+
+    bool testIntersection(collision::geometry::Line& line1, collision::geometry::Line& line2, const core::collision::Intersection* currentIntersection);
+    int computeIntersection(collision::geometry::Line& line1, collision::geometry::Line& line2, OutputVector* contacts, const core::collision::Intersection* currentIntersection);
+
+    /// First time of impact of a point with a triangle. The point moves from p to p + dp, and the vertices of
+    /// the triangle from a, b, c to a + da, b + db, c + dc, at a constant velocity.
+    /// Returns true if the point comes closer than distance to the inside of the triangle during the motion.
+    /// In this case, t in [0,1] is the first time of impact and (alpha, beta) are the barycentric coordinates
+    /// of the impact point on the triangle, relative to the edges ab and ac.
+    static bool computeTimeOfImpactPointTriangle(const type::Vec3& p, const type::Vec3& dp,
+                                                 const type::Vec3& a, const type::Vec3& da,
+                                                 const type::Vec3& b, const type::Vec3& db,
+                                                 const type::Vec3& c, const type::Vec3& dc,
+                                                 SReal distance, SReal& t, SReal& alpha, SReal& beta);
+
+    /// First time of impact of the edge ab with the edge cd, moving as in computeTimeOfImpactPointTriangle.
+    /// Returns true if the edges come closer than distance during the motion. In this case, t in [0,1] is the
+    /// first time of impact, and alpha and beta are the coordinates of the impact point on ab and cd.
+    static bool computeTimeOfImpactEdgeEdge(const type::Vec3& a, const type::Vec3& da,
+                                            const type::Vec3& b, const type::Vec3& db,
+                                            const type::Vec3& c, const type::Vec3& dc,
+                                            const type::Vec3& d, const type::Vec3& dd,
+                                            SReal distance, SReal& t, SReal& alpha, SReal& beta);
+
+protected:
+    /// Geometry of a contact between two primitives, at their current positions
+    struct Contact
+    {
+        type::Vec3 point[2];
+        type::Vec3 normal;
+        SReal value;
+    };
+
+    bool computeContact(collision::geometry::Triangle& triangle, collision::geometry::Point& point, const core::collision::Intersection* currentIntersection, Contact& contact) const;
+    bool computeContact(collision::geometry::Line& line1, collision::geometry::Line& line2, const core::collision::Intersection* currentIntersection, Contact& contact) const;
+};
+
+} // namespace sofa::component::collision::detection::intersection
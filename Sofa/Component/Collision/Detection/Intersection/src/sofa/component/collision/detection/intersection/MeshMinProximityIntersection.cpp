@@ -22,6 +22,7 @@
 #include <sofa/component/collision/detection/intersection/MeshMinProximityIntersection.h>
 
 #include <sofa/component/collision/detection/intersection/DiscreteIntersection.h>
+#include <sofa/component/collision/detection/intersection/ProximityBatch.h>
 #include <sofa/core/collision/Intersection.inl>
 #include <sofa/core/collision/IntersectorFactory.h>
 
@@ -209,6 +210,57 @@ int MeshMinProximityIntersection::computeIntersection(Line& e1, Line& e2, Output
     return 1;
 }
 
+int MeshMinProximityIntersection::computeIntersections(LineCollisionModel<Vec3Types>* model1, LineCollisionModel<Vec3Types>* model2, const ElementIntersector::ElementPairs& pairs, OutputVector* contacts, const core::collision::Intersection* currentIntersection)
+{
+    const SReal threshold = proximitybatch::squaredThreshold(currentIntersection->getAlarmDistance() + model1->getProximity() + model2->getProximity());
+
+    const auto& positions1 = model1->getMechanicalState()->read(core::vec_id::read_access::position)->getValue();
+    const auto& positions2 = model2->getMechanicalState()->read(core::vec_id::read_access::position)->getValue();
+
+    return proximitybatch::computeIntersections<proximitybatch::SegmentSegmentBatch>(pairs,
+        [&](proximitybatch::SegmentSegmentBatch& batch, std::size_t lane, const std::pair<Index, Index>& pair)
+        {
+            const Line e1(model1, pair.first);
+            const Line e2(model2, pair.second);
+            batch.p1.set(lane, positions1[e1.i1()]);
+            batch.q1.set(lane, positions1[e1.i2()]);
+            batch.p2.set(lane, positions2[e2.i1()]);
+            batch.q2.set(lane, positions2[e2.i2()]);
+            batch.thresholds[lane] = threshold;
+        },
+        [&](const std::pair<Index, Index>& pair)
+        {
+            Line e1(model1, pair.first);
+            Line e2(model2, pair.second);
+            return computeIntersection(e1, e2, contacts, currentIntersection);
+        });
+}
+
+int MeshMinProximityIntersection::computeIntersections(TriangleCollisionModel<Vec3Types>* model1, PointCollisionModel<Vec3Types>* model2, const ElementIntersector::ElementPairs& pairs, OutputVector* contacts, const core::collision::Intersection* currentIntersection)
+{
+    const SReal threshold = proximitybatch::squaredThreshold(currentIntersection->getAlarmDistance() + model1->getProximity() + model2->getProximity());
+
+    const auto& positions1 = model1->getMechanicalState()->read(core::vec_id::read_access::position)->getValue();
+    const auto& positions2 = model2->getMechanicalState()->read(core::vec_id::read_access::position)->getValue();
+
+    return proximitybatch::computeIntersections<proximitybatch::PointTriangleBatch>(pairs,
+        [&](proximitybatch::PointTriangleBatch& batch, std::size_t lane, const std::pair<Index, Index>& pair)
+        {
+            const Triangle e1(model1, pair.first);
+            batch.a.set(lane, positions1[e1.p1Index()]);
+            batch.b.set(lane, positions1[e1.p2Index()]);
+            batch.c.set(lane, positions1[e1.p3Index()]);
+            batch.p.set(lane, positions2[pair.second]);
+            batch.thresholds[lane] = threshold;
+        },
+        [&](const std::pair<Index, Index>& pair)
+        {
+            Triangle e1(model1, pair.first);
+            Point e2(model2, pair.second);
+            return computeIntersection(e1, e2, contacts, currentIntersection);
+        });
+}
+
 bool MeshMinProximityIntersection::testIntersection(Triangle& e2, Point& e1, const core::collision::Intersection* currentIntersection)
 {
     static_assert(std::is_same_v<Triangle::Coord, Point::Coord>, "Data mismatch");
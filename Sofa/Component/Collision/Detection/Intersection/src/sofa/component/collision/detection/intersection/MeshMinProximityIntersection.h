@@ -56,6 +56,9 @@ public:
     int computeIntersection(collision::geometry::Triangle&, collision::geometry::Point&, OutputVector*, const core::collision::Intersection* currentIntersection);
     template<class T> int computeIntersection(collision::geometry::Triangle&, collision::geometry::TSphere<T>&, OutputVector*, const core::collision::Intersection* currentIntersection);
 
+    /// Intersections between pairs of elements, discarded by batches before the exact computation (see ProximityBatch.h)
+    int computeIntersections(collision::geometry::LineCollisionModel<sofa::defaulttype::Vec3Types>*, collision::geometry::LineCollisionModel<sofa::defaulttype::Vec3Types>*, const core::collision::ElementIntersector::ElementPairs&, OutputVector*, const core::collision::Intersection* currentIntersection);
+    int computeIntersections(collision::geometry::TriangleCollisionModel<sofa::defaulttype::Vec3Types>*, collision::geometry::PointCollisionModel<sofa::defaulttype::Vec3Types>*, const core::collision::ElementIntersector::ElementPairs&, OutputVector*, const core::collision::Intersection* currentIntersection);
 
     SOFA_ATTRIBUTE_DISABLED__COLLISION_DETECTION_INTERSECTION_AS_PARAMETER()
     bool testIntersection(collision::geometry::Point&, collision::geometry::Point&) = delete;
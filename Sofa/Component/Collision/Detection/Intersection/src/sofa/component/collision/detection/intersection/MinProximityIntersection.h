@@ -23,6 +23,7 @@
 #include <sofa/component/collision/detection/intersection/config.h>
 
 #include <sofa/component/collision/detection/intersection/BaseProximityIntersection.h>
+#include <sofa/component/collision/detection/intersection/ProximityBatch.h>
 
 #include <sofa/core/objectmodel/lifecycle/RenamedData.h>
 
@@ -105,6 +106,32 @@ public:
         return DiscreteIntersection::computeIntersectionSphere(sph1, sph2, contacts, alarmDist, contactDist);
     }
 
+    /// Intersections between pairs of spheres, discarded by batches before the exact computation (see ProximityBatch.h)
+    template<typename DataTypes1, typename DataTypes2>
+    int computeIntersections(collision::geometry::SphereCollisionModel<DataTypes1>* model1, collision::geometry::SphereCollisionModel<DataTypes2>* model2,
+                             const core::collision::ElementIntersector::ElementPairs& pairs, OutputVector* contacts, const core::collision::Intersection* currentIntersection)
+    {
+        using Sphere1 = collision::geometry::TSphere<DataTypes1>;
+        using Sphere2 = collision::geometry::TSphere<DataTypes2>;
+        const SReal alarmDist = currentIntersection->getAlarmDistance() + model1->getProximity() + model2->getProximity();
+
+        return proximitybatch::computeIntersections<proximitybatch::PointPointBatch>(pairs,
+            [&](proximitybatch::PointPointBatch& batch, std::size_t lane, const std::pair<Index, Index>& pair)
+            {
+                const Sphere1 sph1(model1, pair.first);
+                const Sphere2 sph2(model2, pair.second);
+                batch.p1.set(lane, sph1.center());
+                batch.p2.set(lane, sph2.center());
+                batch.thresholds[lane] = proximitybatch::squaredThreshold(alarmDist + sph1.r() + sph2.r());
+            },
+            [&](const std::pair<Index, Index>& pair)
+            {
+                Sphere1 sph1(model1, pair.first);
+                Sphere2 sph2(model2, pair.second);
+                return computeIntersection(sph1, sph2, contacts, currentIntersection);
+            });
+    }
+
 
     SOFA_ATTRIBUTE_DISABLED__COLLISION_DETECTION_INTERSECTION_AS_PARAMETER()
     bool testIntersection(collision::geometry::Cube& cube1, collision::geometry::Cube& cube2) = delete;
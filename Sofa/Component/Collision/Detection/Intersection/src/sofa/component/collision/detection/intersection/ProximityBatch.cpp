@@ -0,0 +1,140 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/component/collision/detection/intersection/ProximityBatch.h>
+
+#include <limits>
+
+namespace sofa::component::collision::detection::intersection::proximitybatch
+{
+
+namespace
+{
+
+/// Smallest value used as a denominator, avoiding divisions by zero on degenerated elements
+constexpr SReal tinyValue = std::numeric_limits<SReal>::min() * static_cast<SReal>(1e4);
+
+inline SReal clamp01(SReal v)
+{
+    return std::min(std::max(v, static_cast<SReal>(0)), static_cast<SReal>(1));
+}
+
+/// Squared distance between the point p and the segment starting at a with direction ab, p being given by ap = p - a
+inline SReal pointSegmentSquaredDistance(SReal apx, SReal apy, SReal apz, SReal abx, SReal aby, SReal abz)
+{
+    const SReal t = clamp01((apx * abx + apy * aby + apz * abz) / std::max(abx * abx + aby * aby + abz * abz, tinyValue));
+    const SReal dx = apx - t * abx;
+    const SReal dy = apy - t * aby;
+    const SReal dz = apz - t * abz;
+    return dx * dx + dy * dy + dz * dz;
+}
+
+}
+
+void PointTriangleBatch::computeSquaredDistances(Lanes& squaredDistances) const
+{
+    for (std::size_t i = 0; i < BatchSize; ++i)
+    {
+        const SReal abx = b.x[i] - a.x[i], aby = b.y[i] - a.y[i], abz = b.z[i] - a.z[i];
+        const SReal bcx = c.x[i] - b.x[i], bcy = c.y[i] - b.y[i], bcz = c.z[i] - b.z[i];
+        const SReal cax = a.x[i] - c.x[i], cay = a.y[i] - c.y[i], caz = a.z[i] - c.z[i];
+        const SReal apx = p.x[i] - a.x[i], apy = p.y[i] - a.y[i], apz = p.z[i] - a.z[i];
+        const SReal bpx = p.x[i] - b.x[i], bpy = p.y[i] - b.y[i], bpz = p.z[i] - b.z[i];
+        const SReal cpx = p.x[i] - c.x[i], cpy = p.y[i] - c.y[i], cpz = p.z[i] - c.z[i];
+
+        // normal of the triangle
+        const SReal nx = aby * (-caz) - abz * (-cay);
+        const SReal ny = abz * (-cax) - abx * (-caz);
+        const SReal nz = abx * (-cay) - aby * (-cax);
+        const SReal nn = nx * nx + ny * ny + nz * nz;
+
+        // the projection of p is inside the triangle if it is on the inner side of the three edges
+        const SReal sideAB = (aby * apz - abz * apy) * nx + (abz * apx - abx * apz) * ny + (abx * apy - aby * apx) * nz;
+        const SReal sideBC = (bcy * bpz - bcz * bpy) * nx + (bcz * bpx - bcx * bpz) * ny + (bcx * bpy - bcy * bpx) * nz;
+        const SReal sideCA = (cay * cpz - caz * cpy) * nx + (caz * cpx - cax * cpz) * ny + (cax * cpy - cay * cpx) * nz;
+        const bool isInside = sideAB >= 0 && sideBC >= 0 && sideCA >= 0 && nn > tinyValue;
+
+        const SReal apn = apx * nx + apy * ny + apz * nz;
+        const SReal planeSquaredDistance = apn * apn / std::max(nn, tinyValue);
+
+        const SReal edgesSquaredDistance = std::min(
+            pointSegmentSquaredDistance(apx, apy, apz, abx, aby, abz),
+            std::min(pointSegmentSquaredDistance(bpx, bpy, bpz, bcx, bcy, bcz),
+                     pointSegmentSquaredDistance(cpx, cpy, cpz, cax, cay, caz)));
+
+        squaredDistances[i] = isInside ? planeSquaredDistance : edgesSquaredDistance;
+    }
+}
+
+void SegmentSegmentBatch::computeSquaredDistances(Lanes& squaredDistances) const
+{
+    // closest points of two segments, from Ericson, Real-Time Collision Detection, 5.1.9
+    for (std::size_t i = 0; i < BatchSize; ++i)
+    {
+        const SReal d1x = q1.x[i] - p1.x[i], d1y = q1.y[i] - p1.y[i], d1z = q1.z[i] - p1.z[i];
+        const SReal d2x = q2.x[i] - p2.x[i], d2y = q2.y[i] - p2.y[i], d2z = q2.z[i] - p2.z[i];
+        const SReal rx = p1.x[i] - p2.x[i], ry = p1.y[i] - p2.y[i], rz = p1.z[i] - p2.z[i];
+
+        const SReal a = std::max(d1x * d1x + d1y * d1y + d1z * d1z, tinyValue);
+        const SReal e = std::max(d2x * d2x + d2y * d2y + d2z * d2z, tinyValue);
+        const SReal b = d1x * d2x + d1y * d2y + d1z * d2z;
+        const SReal c = d1x * rx + d1y * ry + d1z * rz;
+        const SReal f = d2x * rx + d2y * ry + d2z * rz;
+        const SReal denominator = a * e - b * b;
+
+        // parallel segments: any point of the first segment can be chosen
+        SReal s = denominator > tinyValue ? clamp01((b * f - c * e) / std::max(denominator, tinyValue)) : static_cast<SReal>(0);
+        const SReal t = (b * s + f) / e;
+        s = t < 0 ? clamp01(-c / a) : (t > 1 ? clamp01((b - c) / a) : s);
+        const SReal tc = clamp01(t);
+
+        const SReal dx = rx + d1x * s - d2x * tc;
+        const SReal dy = ry + d1y * s - d2y * tc;
+        const SReal dz = rz + d1z * s - d2z * tc;
+        squaredDistances[i] = dx * dx + dy * dy + dz * dz;
+    }
+}
+
+void PointPointBatch::computeSquaredDistances(Lanes& squaredDistances) const
+{
+    for (std::size_t i = 0; i < BatchSize; ++i)
+    {
+        const SReal dx = p2.x[i] - p1.x[i];
+        const SReal dy = p2.y[i] - p1.y[i];
+        const SReal dz = p2.z[i] - p1.z[i];
+        squaredDistances[i] = dx * dx + dy * dy + dz * dz;
+    }
+}
+
+std::size_t selectLanes(const Lanes& squaredDistances, const Lanes& thresholds, std::size_t nbLanes,
+                        std::array<std::size_t, BatchSize>& selectedLanes)
+{
+    std::size_t nbSelectedLanes = 0;
+    for (std::size_t lane = 0; lane < nbLanes; ++lane)
+    {
+        // the lane is always written, the count only progresses if it is selected
+        selectedLanes[nbSelectedLanes] = lane;
+        nbSelectedLanes += static_cast<std::size_t>(squaredDistances[lane] <= thresholds[lane]);
+    }
+    return nbSelectedLanes;
+}
+
+} // namespace sofa::component::collision::detection::intersection::proximitybatch
@@ -0,0 +1,139 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+#include <sofa/component/collision/detection/intersection/config.h>
+
+#include <sofa/core/collision/Intersection.h>
+#include <sofa/type/Vec.h>
+
+#include <algorithm>
+#include <array>
+
+/**
+ * Proximity tests evaluated on batches of pairs of elements.
+ *
+ * The coordinates of the pairs of a batch are stored component by component, so that the squared distances
+ * of all the pairs of the batch are computed in loops without branches, which can be vectorized by the
+ * compiler. The pairs closer than their threshold are then compacted, and only them are given to the exact
+ * (scalar) intersection methods, which create the detection outputs. Thus, the distances computed on the
+ * batches are only used to discard pairs, and the detection outputs are the same as without batches.
+ */
+namespace sofa::component::collision::detection::intersection::proximitybatch
+{
+
+/// Number of pairs of elements evaluated together
+inline constexpr std::size_t BatchSize = 16;
+
+/// A value for each pair of a batch
+using Lanes = std::array<SReal, BatchSize>;
+
+/// Positions of a batch, stored component by component
+struct SOFA_COMPONENT_COLLISION_DETECTION_INTERSECTION_API Positions
+{
+    Lanes x {};
+    Lanes y {};
+    Lanes z {};
+
+    void set(std::size_t lane, const type::Vec3& p)
+    {
+        x[lane] = p[0];
+        y[lane] = p[1];
+        z[lane] = p[2];
+    }
+};
+
+/// Squared distances between points p and triangles (a, b, c)
+struct SOFA_COMPONENT_COLLISION_DETECTION_INTERSECTION_API PointTriangleBatch
+{
+    Positions p, a, b, c;
+    Lanes thresholds {};
+
+    void computeSquaredDistances(Lanes& squaredDistances) const;
+};
+
+/// Squared distances between segments [p1, q1] and segments [p2, q2]
+struct SOFA_COMPONENT_COLLISION_DETECTION_INTERSECTION_API SegmentSegmentBatch
+{
+    Positions p1, q1, p2, q2;
+    Lanes thresholds {};
+
+    void computeSquaredDistances(Lanes& squaredDistances) const;
+};
+
+/// Squared distances between points p1 and points p2, used for spheres
+struct SOFA_COMPONENT_COLLISION_DETECTION_INTERSECTION_API PointPointBatch
+{
+    Positions p1, p2;
+    Lanes thresholds {};
+
+    void computeSquaredDistances(Lanes& squaredDistances) const;
+};
+
+/// Threshold on the squared distance for a given distance. It is slightly enlarged, so that rounding
+/// errors in the batched computations do not discard a pair kept by the exact intersection method.
+inline SReal squaredThreshold(SReal distance)
+{
+    const SReal enlargedDistance = distance * static_cast<SReal>(1.001);
+    return enlargedDistance * enlargedDistance;
+}
+
+/// Write in selectedLanes the first nbLanes lanes whose squared distance is not greater than their threshold,
+/// compacted with a prefix sum. Return the number of selected lanes.
+SOFA_COMPONENT_COLLISION_DETECTION_INTERSECTION_API
+std::size_t selectLanes(const Lanes& squaredDistances, const Lanes& thresholds, std::size_t nbLanes,
+                        std::array<std::size_t, BatchSize>& selectedLanes);
+
+/**
+ * Compute the intersections between pairs of elements, by batches.
+ * gather(batch, lane, pair) sets the coordinates and the threshold of the pair in the batch,
+ * compute(pair) calls the exact intersection method on a pair which was not discarded.
+ * Return the number of contacts.
+ */
+template<class Batch, class GatherFunction, class ComputeFunction>
+int computeIntersections(const core::collision::ElementIntersector::ElementPairs& pairs,
+                         GatherFunction&& gather, ComputeFunction&& compute)
+{
+    Batch batch;
+    Lanes squaredDistances {};
+    std::array<std::size_t, BatchSize> selectedLanes {};
+
+    int nbContacts = 0;
+    for (std::size_t begin = 0; begin < pairs.size(); begin += BatchSize)
+    {
+        const std::size_t nbLanes = std::min(BatchSize, pairs.size() - begin);
+        for (std::size_t lane = 0; lane < nbLanes; ++lane)
+        {
+            gather(batch, lane, pairs[begin + lane]);
+        }
+
+        batch.computeSquaredDistances(squaredDistances);
+
+        const std::size_t nbSelectedLanes = selectLanes(squaredDistances, batch.thresholds, nbLanes, selectedLanes);
+        for (std::size_t i = 0; i < nbSelectedLanes; ++i)
+        {
+            nbContacts += compute(pairs[begin + selectedLanes[i]]);
+        }
+    }
+    return nbContacts;
+}
+
+} // namespace sofa::component::collision::detection::intersection::proximitybatch
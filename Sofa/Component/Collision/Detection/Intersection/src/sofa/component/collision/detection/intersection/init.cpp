@@ -26,6 +26,7 @@
 namespace sofa::component::collision::detection::intersection
 {
 
+extern void registerContinuousProximityIntersection(sofa::core::ObjectFactory* factory);
 extern void registerDiscreteIntersection(sofa::core::ObjectFactory* factory);
 extern void registerLocalMinDistance(sofa::core::ObjectFactory* factory);
 extern void registerMinProximityIntersection(sofa::core::ObjectFactory* factory);
@@ -55,6 +56,7 @@ const char* getModuleVersion()
 
 void registerObjects(sofa::core::ObjectFactory* factory)
 {
+    registerContinuousProximityIntersection(factory);
     registerDiscreteIntersection(factory);
     registerLocalMinDistance(factory);
     registerMinProximityIntersection(factory);
@@ -0,0 +1,343 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <gtest/gtest.h>
+
+#include <sofa/component/collision/detection/intersection/ContinuousProximityIntersection.h>
+#include <sofa/helper/RandomGenerator.h>
+
+#include <sofa/testing/BaseTest.h>
+using sofa::testing::BaseTest;
+#include <sofa/testing/BaseSimulationTest.h>
+using sofa::testing::BaseSimulationTest;
+
+#include <sofa/simulation/Node.h>
+#include <sofa/simulation/Simulation.h>
+#include <sofa/simpleapi/SimpleApi.h>
+
+namespace
+{
+
+using sofa::type::Vec3;
+using sofa::component::collision::detection::intersection::ContinuousProximityIntersection;
+
+struct ContinuousProximityIntersection_test : public BaseTest
+{
+    static constexpr SReal distance = 0.01;
+
+    static bool pointTriangle(const Vec3& p, const Vec3& dp, const Vec3& dTriangle, SReal& t, SReal& alpha, SReal& beta)
+    {
+        return ContinuousProximityIntersection::computeTimeOfImpactPointTriangle(p, dp,
+            Vec3(0, 0, 0), dTriangle, Vec3(1, 0, 0), dTriangle, Vec3(0, 1, 0), dTriangle, distance, t, alpha, beta);
+    }
+};
+
+TEST_F(ContinuousProximityIntersection_test, pointThroughTriangle)
+{
+    SReal t, alpha, beta;
+
+    // the point crosses the triangle in the middle of the motion
+    ASSERT_TRUE(pointTriangle(Vec3(0.2, 0.3, 1), Vec3(0, 0, -2), Vec3(0, 0, 0), t, alpha, beta));
+    EXPECT_NEAR(t, 0.5, 1e-6);
+    EXPECT_NEAR(alpha, 0.2, 1e-6);
+    EXPECT_NEAR(beta, 0.3, 1e-6);
+
+    // both primitives move, toward each other
+    ASSERT_TRUE(pointTriangle(Vec3(0.2, 0.3, 1), Vec3(0.1, 0, -1), Vec3(0, 0, 1), t, alpha, beta));
+    EXPECT_NEAR(t, 0.5, 1e-6);
+    EXPECT_NEAR(alpha, 0.25, 1e-6);
+    EXPECT_NEAR(beta, 0.3, 1e-6);
+
+    // the point crosses the plane of the triangle outside of the triangle
+    EXPECT_FALSE(pointTriangle(Vec3(0.8, 0.8, 1), Vec3(0, 0, -2), Vec3(0, 0, 0), t, alpha, beta));
+
+    // the point does not reach the triangle
+    EXPECT_FALSE(pointTriangle(Vec3(0.2, 0.3, 1), Vec3(0, 0, -0.9), Vec3(0, 0, 0), t, alpha, beta));
+
+    // the triangle moves with the point
+    EXPECT_FALSE(pointTriangle(Vec3(0.2, 0.3, 1), Vec3(0, 0, -2), Vec3(0, 0, -2), t, alpha, beta));
+
+    // the point slides above the triangle, closer than the distance
+    ASSERT_TRUE(pointTriangle(Vec3(-0.5, 0.3, 0.5 * distance), Vec3(1, 0, 0), Vec3(0, 0, 0), t, alpha, beta));
+    EXPECT_NEAR(alpha, 0.5, 1e-6);
+    EXPECT_NEAR(beta, 0.3, 1e-6);
+}
+
+TEST_F(ContinuousProximityIntersection_test, zeroDistance)
+{
+    SReal t, alpha, beta;
+    const Vec3 zero(0, 0, 0);
+
+    // the point crosses the triangle
+    ASSERT_TRUE(ContinuousProximityIntersection::computeTimeOfImpactPointTriangle(Vec3(0.2, 0.3, 1), Vec3(0, 0, -2),
+        Vec3(0, 0, 0), zero, Vec3(1, 0, 0), zero, Vec3(0, 1, 0), zero, 0, t, alpha, beta));
+    EXPECT_NEAR(t, 0.5, 1e-6);
+    EXPECT_NEAR(alpha, 0.2, 1e-6);
+    EXPECT_NEAR(beta, 0.3, 1e-6);
+
+    // the point stops on the triangle
+    ASSERT_TRUE(ContinuousProximityIntersection::computeTimeOfImpactPointTriangle(Vec3(0.2, 0.3, 1), Vec3(0, 0, -1),
+        Vec3(0, 0, 0), zero, Vec3(1, 0, 0), zero, Vec3(0, 1, 0), zero, 0, t, alpha, beta));
+    EXPECT_NEAR(t, 1, 1e-6);
+
+    // the point stops just above the triangle
+    EXPECT_FALSE(ContinuousProximityIntersection::computeTimeOfImpactPointTriangle(Vec3(0.2, 0.3, 1), Vec3(0, 0, -0.999),
+        Vec3(0, 0, 0), zero, Vec3(1, 0, 0), zero, Vec3(0, 1, 0), zero, 0, t, alpha, beta));
+
+    // ab moves down through cd
+    ASSERT_TRUE(ContinuousProximityIntersection::computeTimeOfImpactEdgeEdge(
+        Vec3(-1, 0.2, 1), Vec3(0, 0, -2), Vec3(1, 0.2, 1), Vec3(0, 0, -2),
+        Vec3(0.5, -1, 0), zero, Vec3(0.5, 1, 0), zero,
+        0, t, alpha, beta));
+    EXPECT_NEAR(t, 0.5, 1e-6);
+    EXPECT_NEAR(alpha, 0.75, 1e-6);
+    EXPECT_NEAR(beta, 0.6, 1e-6);
+
+    // ab stops on cd
+    EXPECT_TRUE(ContinuousProximityIntersection::computeTimeOfImpactEdgeEdge(
+        Vec3(-1, 0.2, 1), Vec3(0, 0, -1), Vec3(1, 0.2, 1), Vec3(0, 0, -1),
+        Vec3(0.5, -1, 0), zero, Vec3(0.5, 1, 0), zero,
+        0, t, alpha, beta));
+
+    // ab moves down beside cd
+    EXPECT_FALSE(ContinuousProximityIntersection::computeTimeOfImpactEdgeEdge(
+        Vec3(-1, 0.2, 1), Vec3(0, 0, -2), Vec3(1, 0.2, 1), Vec3(0, 0, -2),
+        Vec3(1.5, -1, 0), zero, Vec3(1.5, 1, 0), zero,
+        0, t, alpha, beta));
+}
+
+TEST_F(ContinuousProximityIntersection_test, randomPointThroughTriangle)
+{
+    sofa::helper::RandomGenerator random(123);
+
+    for (unsigned int i = 0; i < 100; ++i)
+    {
+        const auto randomVec3 = [&random]() { return Vec3(random.random<SReal>(-1, 1), random.random<SReal>(-1, 1), random.random<SReal>(-1, 1)); };
+
+        const Vec3 a = randomVec3(), b = randomVec3(), c = randomVec3();
+        const Vec3 da = randomVec3(), db = randomVec3(), dc = randomVec3();
+        if ((b - a).cross(c - a).norm() < 0.1)
+        {
+            continue;
+        }
+
+        // the point goes through the impact point of the moving triangle at time impactTime
+        const SReal impactTime = random.random<SReal>(0.05, 0.95);
+        const SReal impactAlpha = random.random<SReal>(0.05, 0.45);
+        const SReal impactBeta = random.random<SReal>(0.05, 0.45);
+        const Vec3 at = a + da * impactTime, bt = b + db * impactTime, ct = c + dc * impactTime;
+        const Vec3 impactPoint = at + (bt - at) * impactAlpha + (ct - at) * impactBeta;
+        const Vec3 dp = randomVec3() * 4;
+        const Vec3 p = impactPoint - dp * impactTime;
+
+        SReal t, alpha, beta;
+        ASSERT_TRUE(ContinuousProximityIntersection::computeTimeOfImpactPointTriangle(p, dp, a, da, b, db, c, dc, distance, t, alpha, beta))
+            << "at test " << i;
+        EXPECT_LE(t, impactTime + 1e-9) << "at test " << i;
+
+        // at the time of impact, the point is close to the triangle
+        const Vec3 pt = p + dp * t;
+        const Vec3 a2 = a + da * t, b2 = b + db * t, c2 = c + dc * t;
+        EXPECT_LT((pt - (a2 + (b2 - a2) * alpha + (c2 - a2) * beta)).norm(), distance) << "at test " << i;
+    }
+}
+
+TEST_F(ContinuousProximityIntersection_test, edgeThroughEdge)
+{
+    SReal t, alpha, beta;
+
+    // ab moves down through cd
+    ASSERT_TRUE(ContinuousProximityIntersection::computeTimeOfImpactEdgeEdge(
+        Vec3(-1, 0.2, 1), Vec3(0, 0, -2), Vec3(1, 0.2, 1), Vec3(0, 0, -2),
+        Vec3(0.5, -1, 0), Vec3(0, 0, 0), Vec3(0.5, 1, 0), Vec3(0, 0, 0),
+        distance, t, alpha, beta));
+    EXPECT_NEAR(t, 0.5, 1e-6);
+    EXPECT_NEAR(alpha, 0.75, 1e-6);
+    EXPECT_NEAR(beta, 0.6, 1e-6);
+
+    // ab moves down beside cd
+    EXPECT_FALSE(ContinuousProximityIntersection::computeTimeOfImpactEdgeEdge(
+        Vec3(-1, 0.2, 1), Vec3(0, 0, -2), Vec3(1, 0.2, 1), Vec3(0, 0, -2),
+        Vec3(1.5, -1, 0), Vec3(0, 0, 0), Vec3(1.5, 1, 0), Vec3(0, 0, 0),
+        distance, t, alpha, beta));
+
+    // ab moves down, but stops above cd
+    EXPECT_FALSE(ContinuousProximityIntersection::computeTimeOfImpactEdgeEdge(
+        Vec3(-1, 0.2, 1), Vec3(0, 0, -0.5), Vec3(1, 0.2, 1), Vec3(0, 0, -0.5),
+        Vec3(0.5, -1, 0), Vec3(0, 0, 0), Vec3(0.5, 1, 0), Vec3(0, 0, 0),
+        distance, t, alpha, beta));
+
+    // ab rotates around a and hits cd
+    ASSERT_TRUE(ContinuousProximityIntersection::computeTimeOfImpactEdgeEdge(
+        Vec3(-1, 0, 0), Vec3(0, 0, 0), Vec3(1, 0, 1), Vec3(0, 0, -2),
+        Vec3(0.8, -1, 0), Vec3(0, 0, 0), Vec3(0.8, 1, 0), Vec3(0, 0, 0),
+        distance, t, alpha, beta));
+    EXPECT_NEAR(t, 0.5, 1e-2);
+    EXPECT_NEAR(alpha, 0.9, 1e-2);
+    EXPECT_NEAR(beta, 0.5, 1e-2);
+}
+
+/// The contacts created by computeIntersection for pairs of collision models in a scene, one of them moving fast
+struct ContinuousProximityIntersectionScene_test : public BaseSimulationTest
+{
+    using DetectionOutput = sofa::core::collision::DetectionOutput;
+    using TriangleModel = sofa::component::collision::geometry::TriangleCollisionModel<sofa::defaulttype::Vec3Types>;
+    using LineModel = sofa::component::collision::geometry::LineCollisionModel<sofa::defaulttype::Vec3Types>;
+    using PointModel = sofa::component::collision::geometry::PointCollisionModel<sofa::defaulttype::Vec3Types>;
+
+    static constexpr SReal contactDistance = 0.002;
+
+    sofa::simulation::Node::SPtr m_root;
+    ContinuousProximityIntersection* m_intersection { nullptr };
+
+    void doSetUp() override
+    {
+        this->loadPlugins({
+            Sofa.Component.StateContainer,
+            Sofa.Component.Topology.Container.Constant,
+            Sofa.Component.Collision.Geometry,
+            Sofa.Component.Collision.Detection.Intersection
+        });
+
+        m_root = sofa::simulation::getSimulation()->createNewGraph("root");
+        m_root->setDt(0.01);
+        sofa::simpleapi::createObject(m_root, "ContinuousProximityIntersection", {{"name", "intersection"}, {"alarmDistance", "0.01"}, {"contactDistance", "0.002"}});
+    }
+
+    void doTearDown() override
+    {
+        sofa::simulation::node::unload(m_root);
+    }
+
+    /// Create a child node with a state, a topology and a collision model
+    sofa::simulation::Node::SPtr createObject(const std::string& name, const std::string& collisionModel,
+                                              const std::map<std::string, std::string>& stateData,
+                                              const std::map<std::string, std::string>& topologyData)
+    {
+        const auto node = sofa::simpleapi::createChild(m_root, name);
+        sofa::simpleapi::createObject(node, "MechanicalObject", stateData);
+        sofa::simpleapi::createObject(node, "MeshTopology", topologyData);
+        sofa::simpleapi::createObject(node, collisionModel);
+        return node;
+    }
+
+    void init()
+    {
+        sofa::simulation::node::initRoot(m_root.get());
+        m_intersection = dynamic_cast<ContinuousProximityIntersection*>(m_root->getObject("intersection"));
+        ASSERT_NE(m_intersection, nullptr);
+    }
+
+    static void expectVec3Near(const Vec3& value, const Vec3& expected)
+    {
+        for (int i = 0; i < 3; ++i)
+        {
+            EXPECT_NEAR(value[i], expected[i], 1e-9) << "axis " << i << " of " << value;
+        }
+    }
+
+    /// A point moving down through a triangle, or at rest close to it
+    void pointTriangle(const std::string& pointPosition, const std::string& pointVelocity, const Vec3& expectedPoint, SReal expectedValue)
+    {
+        const auto triangleNode = createObject("triangle", "TriangleCollisionModel", {{"position", "0 0 0  1 0 0  0 1 0"}}, {{"triangles", "0 1 2"}});
+        const auto pointNode = createObject("point", "PointCollisionModel", {{"position", pointPosition}, {"velocity", pointVelocity}}, {});
+        init();
+
+        auto* triangleModel = triangleNode->get<TriangleModel>();
+        auto* pointModel = pointNode->get<PointModel>();
+        ASSERT_NE(triangleModel, nullptr);
+        ASSERT_NE(pointModel, nullptr);
+
+        sofa::component::collision::geometry::Triangle triangle(triangleModel, 0);
+        sofa::component::collision::geometry::Point point(pointModel, 0);
+
+        sofa::type::vector<DetectionOutput> outputs;
+        ASSERT_EQ(m_intersection->computeIntersection(triangle, point, &outputs, m_intersection), 1);
+        ASSERT_EQ(outputs.size(), 1u);
+
+        const DetectionOutput& output = outputs[0];
+        EXPECT_EQ(output.elem.first, triangle);
+        EXPECT_EQ(output.elem.second, point);
+        EXPECT_EQ(output.id, point.getIndex());
+        expectVec3Near(output.normal, Vec3(0, 0, 1));
+        expectVec3Near(output.point[0], Vec3(0.2, 0.3, 0));
+        expectVec3Near(output.point[1], expectedPoint);
+        EXPECT_NEAR(output.value, expectedValue, 1e-9);
+    }
+};
+
+TEST_F(ContinuousProximityIntersectionScene_test, pointThroughTriangle)
+{
+    // the point crosses the triangle during the time step: the contact is created at the current positions
+    pointTriangle("0.2 0.3 1", "0 0 -200", Vec3(0.2, 0.3, 1), 1 - contactDistance);
+}
+
+TEST_F(ContinuousProximityIntersectionScene_test, pointCloseToTriangle)
+{
+    // the point is closer than the alarm distance
+    pointTriangle("0.2 0.3 0.005", "0 0 0", Vec3(0.2, 0.3, 0.005), 0.005 - contactDistance);
+}
+
+TEST_F(ContinuousProximityIntersectionScene_test, pointMissesTriangle)
+{
+    const auto triangleNode = createObject("triangle", "TriangleCollisionModel", {{"position", "0 0 0  1 0 0  0 1 0"}}, {{"triangles", "0 1 2"}});
+    const auto pointNode = createObject("point", "PointCollisionModel", {{"position", "0.2 0.3 1"}, {"velocity", "0 0 -90"}}, {});
+    init();
+
+    sofa::component::collision::geometry::Triangle triangle(triangleNode->get<TriangleModel>(), 0);
+    sofa::component::collision::geometry::Point point(pointNode->get<PointModel>(), 0);
+
+    // the point stops above the triangle at the end of the time step
+    sofa::type::vector<DetectionOutput> outputs;
+    EXPECT_EQ(m_intersection->computeIntersection(triangle, point, &outputs, m_intersection), 0);
+    EXPECT_TRUE(outputs.empty());
+}
+
+TEST_F(ContinuousProximityIntersectionScene_test, edgeThroughEdge)
+{
+    // the first edge moves down through the second one during the time step
+    const auto movingNode = createObject("moving", "LineCollisionModel", {{"position", "-1 0.2 1  1 0.2 1"}, {"velocity", "0 0 -200  0 0 -200"}}, {{"edges", "0 1"}});
+    const auto staticNode = createObject("static", "LineCollisionModel", {{"position", "0.5 -1 0  0.5 1 0"}}, {{"edges", "0 1"}});
+    init();
+
+    auto* movingModel = movingNode->get<LineModel>();
+    auto* staticModel = staticNode->get<LineModel>();
+    ASSERT_NE(movingModel, nullptr);
+    ASSERT_NE(staticModel, nullptr);
+
+    sofa::component::collision::geometry::Line moving(movingModel, 0);
+    sofa::component::collision::geometry::Line fixed(staticModel, 0);
+
+    sofa::type::vector<DetectionOutput> outputs;
+    ASSERT_EQ(m_intersection->computeIntersection(moving, fixed, &outputs, m_intersection), 1);
+    ASSERT_EQ(outputs.size(), 1u);
+
+    // the contact is at the impact coordinates on the current edges, oriented from the moving edge to the static one
+    const DetectionOutput& output = outputs[0];
+    EXPECT_EQ(output.elem.first, moving);
+    EXPECT_EQ(output.elem.second, fixed);
+    expectVec3Near(output.normal, Vec3(0, 0, -1));
+    expectVec3Near(output.point[0], Vec3(0.5, 0.2, 1));
+    expectVec3Near(output.point[1], Vec3(0.5, 0.2, 0));
+    EXPECT_NEAR(output.value, 1 - contactDistance, 1e-9);
+}
+
+}
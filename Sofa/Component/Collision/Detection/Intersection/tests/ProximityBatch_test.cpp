@@ -0,0 +1,179 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/component/collision/detection/intersection/ProximityBatch.h>
+
+#include <sofa/testing/BaseTest.h>
+using sofa::testing::BaseTest;
+
+#include <random>
+
+namespace
+{
+
+using sofa::type::Vec3;
+namespace proximitybatch = sofa::component::collision::detection::intersection::proximitybatch;
+
+struct ProximityBatch_test : public BaseTest
+{
+    std::mt19937 m_generator { 42 };
+
+    Vec3 randomPoint()
+    {
+        std::uniform_real_distribution<SReal> distribution(-1, 1);
+        return { distribution(m_generator), distribution(m_generator), distribution(m_generator) };
+    }
+
+    /// Minimal squared distance between p and points sampled on the triangle (a, b, c)
+    static SReal sampledPointTriangleSquaredDistance(const Vec3& p, const Vec3& a, const Vec3& b, const Vec3& c)
+    {
+        constexpr int nbSamples = 200;
+        SReal minDistance = std::numeric_limits<SReal>::max();
+        for (int i = 0; i <= nbSamples; ++i)
+        {
+            for (int j = 0; i + j <= nbSamples; ++j)
+            {
+                const SReal u = static_cast<SReal>(i) / nbSamples;
+                const SReal v = static_cast<SReal>(j) / nbSamples;
+                minDistance = std::min(minDistance, (a + (b - a) * u + (c - a) * v - p).norm2());
+            }
+        }
+        return minDistance;
+    }
+
+    /// Minimal squared distance between points sampled on the segments [p1, q1] and [p2, q2]
+    static SReal sampledSegmentSegmentSquaredDistance(const Vec3& p1, const Vec3& q1, const Vec3& p2, const Vec3& q2)
+    {
+        constexpr int nbSamples = 400;
+        SReal minDistance = std::numeric_limits<SReal>::max();
+        for (int i = 0; i <= nbSamples; ++i)
+        {
+            for (int j = 0; j <= nbSamples; ++j)
+            {
+                const SReal s = static_cast<SReal>(i) / nbSamples;
+                const SReal t = static_cast<SReal>(j) / nbSamples;
+                minDistance = std::min(minDistance, (p1 + (q1 - p1) * s - p2 - (q2 - p2) * t).norm2());
+            }
+        }
+        return minDistance;
+    }
+};
+
+TEST_F(ProximityBatch_test, pointTriangle)
+{
+    proximitybatch::PointTriangleBatch batch;
+    proximitybatch::Lanes squaredDistances {};
+
+    // projection inside the triangle, closest to an edge, closest to a vertex
+    batch.a.set(0, {0, 0, 0}); batch.b.set(0, {1, 0, 0}); batch.c.set(0, {0, 1, 0}); batch.p.set(0, {0.2, 0.2, 0.5});
+    batch.a.set(1, {0, 0, 0}); batch.b.set(1, {1, 0, 0}); batch.c.set(1, {0, 1, 0}); batch.p.set(1, {0.5, -1, 0});
+    batch.a.set(2, {0, 0, 0}); batch.b.set(2, {1, 0, 0}); batch.c.set(2, {0, 1, 0}); batch.p.set(2, {2, 2, 0});
+    // degenerated triangle
+    batch.a.set(3, {0, 0, 0}); batch.b.set(3, {1, 0, 0}); batch.c.set(3, {2, 0, 0}); batch.p.set(3, {0.5, 1, 0});
+
+    batch.computeSquaredDistances(squaredDistances);
+    EXPECT_NEAR(squaredDistances[0], 0.25, 1e-12);
+    EXPECT_NEAR(squaredDistances[1], 1.0, 1e-12);
+    EXPECT_NEAR(squaredDistances[2], 1.5 * 1.5 * 2, 1e-12);
+    EXPECT_NEAR(squaredDistances[3], 1.0, 1e-12);
+
+    std::array<Vec3, proximitybatch::BatchSize> p, a, b, c;
+    for (std::size_t lane = 0; lane < proximitybatch::BatchSize; ++lane)
+    {
+        p[lane] = randomPoint(); a[lane] = randomPoint(); b[lane] = randomPoint(); c[lane] = randomPoint();
+        batch.p.set(lane, p[lane]); batch.a.set(lane, a[lane]); batch.b.set(lane, b[lane]); batch.c.set(lane, c[lane]);
+    }
+    batch.computeSquaredDistances(squaredDistances);
+    for (std::size_t lane = 0; lane < proximitybatch::BatchSize; ++lane)
+    {
+        EXPECT_NEAR(std::sqrt(squaredDistances[lane]), std::sqrt(sampledPointTriangleSquaredDistance(p[lane], a[lane], b[lane], c[lane])), 2e-2) << "lane " << lane;
+    }
+}
+
+TEST_F(ProximityBatch_test, segmentSegment)
+{
+    proximitybatch::SegmentSegmentBatch batch;
+    proximitybatch::Lanes squaredDistances {};
+
+    // crossing segments, parallel segments, degenerated segment
+    batch.p1.set(0, {-1, 0, 0}); batch.q1.set(0, {1, 0, 0}); batch.p2.set(0, {0, -1, 1}); batch.q2.set(0, {0, 1, 1});
+    batch.p1.set(1, {0, 0, 0}); batch.q1.set(1, {1, 0, 0}); batch.p2.set(1, {2, 1, 0}); batch.q2.set(1, {3, 1, 0});
+    batch.p1.set(2, {0, 0, 0}); batch.q1.set(2, {0, 0, 0}); batch.p2.set(2, {-1, 2, 0}); batch.q2.set(2, {1, 2, 0});
+
+    batch.computeSquaredDistances(squaredDistances);
+    EXPECT_NEAR(squaredDistances[0], 1.0, 1e-12);
+    EXPECT_NEAR(squaredDistances[1], 2.0, 1e-12);
+    EXPECT_NEAR(squaredDistances[2], 4.0, 1e-12);
+
+    std::array<Vec3, proximitybatch::BatchSize> p1, q1, p2, q2;
+    for (std::size_t lane = 0; lane < proximitybatch::BatchSize; ++lane)
+    {
+        p1[lane] = randomPoint(); q1[lane] = randomPoint(); p2[lane] = randomPoint(); q2[lane] = randomPoint();
+        batch.p1.set(lane, p1[lane]); batch.q1.set(lane, q1[lane]); batch.p2.set(lane, p2[lane]); batch.q2.set(lane, q2[lane]);
+    }
+    batch.computeSquaredDistances(squaredDistances);
+    for (std::size_t lane = 0; lane < proximitybatch::BatchSize; ++lane)
+    {
+        EXPECT_NEAR(std::sqrt(squaredDistances[lane]), std::sqrt(sampledSegmentSegmentSquaredDistance(p1[lane], q1[lane], p2[lane], q2[lane])), 2e-2) << "lane " << lane;
+    }
+}
+
+TEST_F(ProximityBatch_test, computeIntersections)
+{
+    // pairs of points on a line, the pairs (i, j) are selected if |i - j| <= 2
+    constexpr unsigned int nbPoints = 20;
+    sofa::core::collision::ElementIntersector::ElementPairs pairs;
+    for (unsigned int i = 0; i < nbPoints; ++i)
+    {
+        for (unsigned int j = 0; j < nbPoints; ++j)
+        {
+            pairs.emplace_back(i, j);
+        }
+    }
+
+    std::vector<std::pair<sofa::Index, sofa::Index>> computedPairs;
+    const int nbContacts = proximitybatch::computeIntersections<proximitybatch::PointPointBatch>(pairs,
+        [](proximitybatch::PointPointBatch& batch, std::size_t lane, const std::pair<sofa::Index, sofa::Index>& pair)
+        {
+            batch.p1.set(lane, Vec3(pair.first, 0, 0));
+            batch.p2.set(lane, Vec3(pair.second, 0, 0));
+            batch.thresholds[lane] = proximitybatch::squaredThreshold(2);
+        },
+        [&computedPairs](const std::pair<sofa::Index, sofa::Index>& pair)
+        {
+            computedPairs.push_back(pair);
+            return 1;
+        });
+
+    std::vector<std::pair<sofa::Index, sofa::Index>> expectedPairs;
+    for (const auto& [i, j] : pairs)
+    {
+        if (std::abs(static_cast<int>(i) - static_cast<int>(j)) <= 2)
+        {
+            expectedPairs.emplace_back(i, j);
+        }
+    }
+
+    EXPECT_EQ(nbContacts, static_cast<int>(expectedPairs.size()));
+    EXPECT_EQ(computedPairs, expectedPairs);
+}
+
+}
@@ -161,6 +161,150 @@ void CubeCollisionModel::updateCubes()
         updateCube(i);
 }
 
+bool CubeCollisionModel::updateLeaves(const sofa::type::vector<sofa::Index>& previousIndices, sofa::type::vector<sofa::Index>& modifiedChildren)
+{
+    modifiedChildren.clear();
+
+    const sofa::Size oldSize = size;
+    const auto newSize = sofa::Size(previousIndices.size());
+    if (newSize == 0 || parentOf.size() != oldSize || getPrevious() == nullptr)
+        return false;
+
+    // Upper levels of the tree, they must only contain cubes. The deepest ones are empty when all
+    // their parent cells were small enough not to be split, but the root must exist.
+    std::vector<CubeCollisionModel*> levels;
+    for (core::CollisionModel* m = getPrevious(); m != nullptr; m = m->getPrevious())
+    {
+        auto* level = dynamic_cast<CubeCollisionModel*>(m);
+        if (level == nullptr)
+            return false;
+        levels.push_back(level);
+    }
+    if (levels.back()->empty())
+        return false;
+
+    // Find the new child element stored in each existing leaf
+    sofa::type::vector<sofa::Index> leafChild(oldSize, sofa::InvalidID);
+    sofa::type::vector<sofa::Index> newChildren;
+    for (sofa::Index c = 0; c < newSize; ++c)
+    {
+        const sofa::Index prev = previousIndices[c];
+        if (prev == sofa::InvalidID)
+        {
+            newChildren.push_back(c);
+            continue;
+        }
+        if (prev >= oldSize)
+            return false;
+        const sofa::Index leaf = parentOf[prev];
+        if (leaf >= oldSize || leafChild[leaf] != sofa::InvalidID || elems[leaf].children.first.getIndex() != prev)
+            return false;
+        leafChild[leaf] = c;
+        if (prev != c)
+            modifiedChildren.push_back(c);
+    }
+
+    // New elements reuse the leaves of the removed ones, the others are appended
+    std::size_t n = 0;
+    for (sofa::Index leaf = 0; leaf < oldSize && n < newChildren.size(); ++leaf)
+    {
+        if (leafChild[leaf] == sofa::InvalidID)
+            leafChild[leaf] = newChildren[n++];
+    }
+    for (; n < newChildren.size(); ++n)
+        leafChild.push_back(newChildren[n]);
+    modifiedChildren.insert(modifiedChildren.end(), newChildren.begin(), newChildren.end());
+
+    // Index of each leaf once the empty ones are removed
+    const auto nbLeaves = sofa::Size(leafChild.size());
+    sofa::type::vector<sofa::Index> newLeafIndex(nbLeaves + 1);
+    sofa::Index nbRemoved = 0;
+    for (sofa::Index leaf = 0; leaf < nbLeaves; ++leaf)
+    {
+        newLeafIndex[leaf] = leaf - nbRemoved;
+        if (leafChild[leaf] == sofa::InvalidID)
+            ++nbRemoved;
+    }
+    newLeafIndex[nbLeaves] = nbLeaves - nbRemoved;
+    if (newLeafIndex[nbLeaves] != newSize)
+        return false;
+
+    // Patch the ranges of leaves stored in the upper levels, the cells ending with the last leaf
+    // also receive the appended ones
+    for (CubeCollisionModel* level : levels)
+    {
+        for (CubeData& cube : level->elems)
+        {
+            if (cube.subcells.first.getCollisionModel() != this)
+                continue;
+            const sofa::Index first = cube.subcells.first.getIndex();
+            const sofa::Index last = cube.subcells.second.getIndex();
+            cube.subcells.first = Cube(this, newLeafIndex[first]);
+            cube.subcells.second = Cube(this, newLeafIndex[(last == oldSize) ? nbLeaves : last]);
+        }
+    }
+
+    // Remove the upper cells left without any leaf, starting from the bottom, so that their
+    // bounding box is not merged in the boxes of their parents
+    for (std::size_t l = 0; l + 1 < levels.size(); ++l)
+    {
+        CubeCollisionModel* level = levels[l];
+        const auto nbCells = sofa::Size(level->elems.size());
+        sofa::type::vector<sofa::Index> newCellIndex(nbCells + 1);
+        sofa::Index nbEmpty = 0;
+        for (sofa::Index cell = 0; cell < nbCells; ++cell)
+        {
+            newCellIndex[cell] = cell - nbEmpty;
+            const CubeData& cube = level->elems[cell];
+            if (cube.subcells.first == cube.subcells.second)
+                ++nbEmpty;
+        }
+        newCellIndex[nbCells] = nbCells - nbEmpty;
+        if (nbEmpty == 0)
+            continue;
+
+        sofa::type::vector<CubeData> cells;
+        cells.reserve(nbCells - nbEmpty);
+        for (const CubeData& cube : level->elems)
+        {
+            if (cube.subcells.first != cube.subcells.second)
+                cells.push_back(cube);
+        }
+        level->elems.swap(cells);
+        level->core::CollisionModel::resize(nbCells - nbEmpty);
+
+        for (std::size_t p = l + 1; p < levels.size(); ++p)
+        {
+            for (CubeData& cube : levels[p]->elems)
+            {
+                if (cube.subcells.first.getCollisionModel() != level)
+                    continue;
+                cube.subcells.first = Cube(level, newCellIndex[cube.subcells.first.getIndex()]);
+                cube.subcells.second = Cube(level, newCellIndex[cube.subcells.second.getIndex()]);
+            }
+        }
+    }
+
+    // Compact the leaves and link them to their child element
+    sofa::type::vector<CubeData> newElems;
+    newElems.reserve(newSize);
+    parentOf.resize(newSize);
+    for (sofa::Index leaf = 0; leaf < nbLeaves; ++leaf)
+    {
+        const sofa::Index c = leafChild[leaf];
+        if (c == sofa::InvalidID)
+            continue;
+        newElems.push_back((leaf < oldSize) ? elems[leaf] : CubeData());
+        newElems.back().children.first = core::CollisionElementIterator(getNext(), c);
+        newElems.back().children.second = core::CollisionElementIterator(getNext(), c+1);
+        parentOf[c] = sofa::Index(newElems.size() - 1);
+    }
+    elems.swap(newElems);
+    this->core::CollisionModel::resize(newSize);
+
+    return true;
+}
+
 void CubeCollisionModel::draw(const core::visual::VisualParams* vparams)
 {
     if (!isActive() || !((getNext()==nullptr)?vparams->displayFlags().getShowCollisionModels():vparams->displayFlags().getShowBoundingCollisionModels())) return;
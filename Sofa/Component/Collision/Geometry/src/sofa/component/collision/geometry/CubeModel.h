@@ -143,6 +143,19 @@ public:
     sofa::Index addCube(Cube subcellsBegin, Cube subcellsEnd);
     void updateCube(sofa::Index index);
     void updateCubes();
+
+    /**
+      *Update the leaves of an existing tree after elements of the child model were removed, added or renumbered,
+      *without sorting the elements again. This model must be the leaf level of the tree (one cube per child element).
+      *The leaves of the removed elements are first reused for the new elements, the remaining ones are removed and
+      *the remaining new elements are appended to the last cell. Only the ranges of the upper levels are patched, and
+      *their cells left without any element are removed.
+      *@param previousIndices for each child element, its index before the change, or sofa::InvalidID if it is new
+      *@param modifiedChildren filled with the child elements whose leaf bounding box must be set again (new or renumbered)
+      *@return false if the tree could not be updated and must be rebuilt
+      *The bounding boxes of the upper levels are not updated, computeBoundingTree must be called once the leaves are set.
+      */
+    bool updateLeaves(const sofa::type::vector<sofa::Index>& previousIndices, sofa::type::vector<sofa::Index>& modifiedChildren);
 };
 
 inline Cube::Cube(CubeCollisionModel* model, Index index)
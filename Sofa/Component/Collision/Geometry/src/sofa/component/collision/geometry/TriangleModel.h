@@ -27,8 +27,11 @@
 #include <sofa/core/CollisionModel.h>
 #include <sofa/core/VecId.h>
 #include <sofa/core/topology/BaseMeshTopology.h>
+#include <sofa/core/topology/TopologyData.h>
 #include <sofa/core/behavior/MechanicalState.h>
 
+#include <memory>
+
 namespace sofa::component::collision::geometry
 {
 
@@ -138,6 +141,7 @@ public:
     Data<bool> d_bothSide; ///< activate collision on both side of the triangle model
     Data<bool> d_computeNormals; ///< set to false to disable computation of triangles normal
     Data<bool> d_useCurvature; ///< use the curvature of the mesh to avoid some self-intersection test
+    Data<bool> d_localTopologyUpdate; ///< update the bounding tree locally after topological changes instead of rebuilding it (read at init)
     
     /// Link to be set to the topology container in the component graph.
     SingleLink<TriangleCollisionModel<DataTypes>, sofa::core::topology::BaseMeshTopology, BaseLink::FLAG_STOREPATH | BaseLink::FLAG_STRONGLINK> l_topology;
@@ -160,6 +164,13 @@ protected:
     bool m_needsUpdate; ///< parameter storing the info boundingTree has to be recomputed.
     int m_topologyRevision; ///< internal revision number to check if topology has changed.
 
+    /// Index of each triangle at the last update from the topology, InvalidID for triangles added since.
+    /// Kept up to date by its topology handler, it is used to update the bounding tree locally. It is only
+    /// created at init if localTopologyUpdate is enabled, and is not exposed as a Data of the component.
+    std::unique_ptr<core::topology::TriangleData<sofa::type::vector<sofa::Index> > > m_previousIndices;
+    sofa::type::vector<sofa::Index> m_modifiedTriangles; ///< triangles whose leaf of the bounding tree must be updated
+    sofa::Size m_nbLocalChanges; ///< number of triangles changed by local updates since the bounding tree was built
+
     PointCollisionModel<sofa::defaulttype::Vec3Types>* m_pointModels;
 
 protected:
@@ -169,6 +180,12 @@ protected:
     virtual void updateFromTopology();
     virtual void updateNormals();
 
+    /// Update the leaves of the bounding tree after triangles were removed or added, and recompute the normals of the
+    /// modified triangles. Return false if the tree must be rebuilt.
+    bool updateBoundingTreeFromTopology(sofa::Size previousSize);
+    /// Reset the previous index of each triangle to its current index.
+    void resetPreviousIndices();
+
 public:
     void init() override;
 
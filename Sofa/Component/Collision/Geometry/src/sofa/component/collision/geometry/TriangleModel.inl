@@ -29,6 +29,7 @@
 #include <sofa/simulation/Node.h>
 #include <sofa/core/topology/TopologyChange.h>
 #include <vector>
+#include <numeric>
 
 namespace sofa::component::collision::geometry
 {
@@ -38,11 +39,13 @@ TriangleCollisionModel<DataTypes>::TriangleCollisionModel()
     : d_bothSide(initData(&d_bothSide, false, "bothSide", "activate collision on both side of the triangle model") )
     , d_computeNormals(initData(&d_computeNormals, true, "computeNormals", "set to false to disable computation of triangles normal"))
     , d_useCurvature(initData(&d_useCurvature, false, "useCurvature", "use the curvature of the mesh to avoid some self-intersection test"))
+    , d_localTopologyUpdate(initData(&d_localTopologyUpdate, false, "localTopologyUpdate", "update the bounding tree locally when triangles are removed or added instead of rebuilding it"))
     , l_topology(initLink("topology", "link to the topology container"))
     , m_mstate(nullptr)
     , m_topology(nullptr)
     , m_needsUpdate(true)
     , m_topologyRevision(-1)
+    , m_nbLocalChanges(0)
     , m_pointModels(nullptr)
 {
     m_triangles = &m_internalTriangles;
@@ -108,6 +111,24 @@ void TriangleCollisionModel<DataTypes>::init()
         resize(m_topology->getNbTriangles());
         updateNormals();
     }
+
+    // follow the renumbering of the triangles to update the bounding tree locally on topological changes
+    if (d_localTopologyUpdate.getValue())
+    {
+        typename core::topology::TriangleData<sofa::type::vector<sofa::Index> >::InitData previousIndicesData;
+        previousIndicesData.name = "previousIndices";
+        m_previousIndices = std::make_unique<core::topology::TriangleData<sofa::type::vector<sofa::Index> > >(previousIndicesData);
+        m_previousIndices->setOwner(this);
+        m_previousIndices->createTopologyHandler(m_topology);
+        m_previousIndices->setCreationCallback([](sofa::Index, sofa::Index& previousIndex,
+                                                  const core::topology::BaseMeshTopology::Triangle&,
+                                                  const sofa::type::vector<sofa::Index>&,
+                                                  const sofa::type::vector<SReal>&)
+        {
+            previousIndex = sofa::InvalidID;
+        });
+    }
+    resetPreviousIndices();
 }
 
 template<class DataTypes>
@@ -134,6 +155,7 @@ void TriangleCollisionModel<DataTypes>::updateFromTopology()
 
     m_topologyRevision = revision;
 
+    const sofa::Size previousSize = size;
     const sofa::Size nquads = m_topology->getNbQuads();
     const sofa::Size ntris = m_topology->getNbTriangles();
 
@@ -141,6 +163,12 @@ void TriangleCollisionModel<DataTypes>::updateFromTopology()
     {
         resize(ntris);
         m_triangles = &m_topology->getTriangles();
+
+        if (updateBoundingTreeFromTopology(previousSize))
+        {
+            resetPreviousIndices();
+            return;
+        }
     }
     else
     {
@@ -187,9 +215,60 @@ void TriangleCollisionModel<DataTypes>::updateFromTopology()
         }
     }
     updateNormals();
+    resetPreviousIndices();
 
     // topology has changed, force boudingTree recomputation
     m_needsUpdate = true;
+    m_nbLocalChanges = 0;
+    m_modifiedTriangles.clear();
+}
+
+template<class DataTypes>
+bool TriangleCollisionModel<DataTypes>::updateBoundingTreeFromTopology(sofa::Size previousSize)
+{
+    if (!m_previousIndices)
+        return false;
+
+    auto* cubeModel = dynamic_cast<CubeCollisionModel*>(getPrevious());
+    const auto& previousIndices = m_previousIndices->getValue();
+
+    // the tree must be built, and the leaves of the last local update already applied
+    if (m_needsUpdate || cubeModel == nullptr || !m_modifiedTriangles.empty()
+        || previousIndices.size() != size || cubeModel->getSize() != previousSize)
+        return false;
+
+    if (!cubeModel->updateLeaves(previousIndices, m_modifiedTriangles))
+    {
+        m_modifiedTriangles.clear();
+        return false;
+    }
+
+    // the tree gets less balanced with each local update, rebuild it once a quarter of the triangles changed
+    m_nbLocalChanges += sofa::Size(m_modifiedTriangles.size()) + (previousSize > size ? previousSize - size : 0);
+    if (m_nbLocalChanges > size / 4)
+    {
+        m_modifiedTriangles.clear();
+        return false;
+    }
+
+    for (const sofa::Index i : m_modifiedTriangles)
+    {
+        Element t(this,i);
+        t.n() = cross(t.p2()-t.p1(),t.p3()-t.p1());
+        t.n().normalize();
+    }
+    return true;
+}
+
+template<class DataTypes>
+void TriangleCollisionModel<DataTypes>::resetPreviousIndices()
+{
+    if (!m_previousIndices)
+        return;
+
+    auto previousIndices = sofa::helper::getWriteOnlyAccessor(*m_previousIndices);
+    previousIndices.resize(m_topology->getNbTriangles());
+    std::iota(previousIndices.begin(), previousIndices.end(), sofa::Index(0));
 }
 
 
@@ -225,52 +304,66 @@ void TriangleCollisionModel<DataTypes>::computeBoundingTree(int maxDepth)
     if (m_needsUpdate && !cubeModel->empty())
         cubeModel->resize(0);
 
+    const VecCoord& x = this->m_mstate->read(core::vec_id::read_access::position)->getValue();
+    const bool calcNormals = d_computeNormals.getValue();
+    const SReal distance = (SReal)this->proximity.getValue();
+
+    const auto updateLeaf = [&](sofa::Index i)
+    {
+        type::Vec3 minElem, maxElem;
+        Element t(this,i);
+
+        const type::Vec3& pt1 = x[t.p1Index()];
+        const type::Vec3& pt2 = x[t.p2Index()];
+        const type::Vec3& pt3 = x[t.p3Index()];
+
+        for (int c = 0; c < 3; c++)
+        {
+            minElem[c] = pt1[c];
+            maxElem[c] = pt1[c];
+            if (pt2[c] > maxElem[c]) maxElem[c] = pt2[c];
+            else if (pt2[c] < minElem[c]) minElem[c] = pt2[c];
+            if (pt3[c] > maxElem[c]) maxElem[c] = pt3[c];
+            else if (pt3[c] < minElem[c]) minElem[c] = pt3[c];
+            minElem[c] -= distance;
+            maxElem[c] += distance;
+        }
+        if (calcNormals)
+        {
+            // Also recompute normal vector
+            t.n() = cross(pt2-pt1,pt3-pt1);
+            t.n().normalize();
+        }
+
+        if(d_useCurvature.getValue())
+            cubeModel->setParentOf(i, minElem, maxElem, t.n()); // define the bounding box of the current triangle
+        else
+            cubeModel->setParentOf(i, minElem, maxElem);
+    };
+
     if (!isMoving() && !cubeModel->empty() && !m_needsUpdate)
-        return; // No need to recompute BBox if immobile nor if mesh didn't change.
+    {
+        // No need to recompute BBox if immobile nor if mesh didn't change,
+        // except for the triangles modified by a local update of the tree.
+        if (!m_modifiedTriangles.empty())
+        {
+            for (const sofa::Index i : m_modifiedTriangles)
+                updateLeaf(i);
+            m_modifiedTriangles.clear();
+            cubeModel->computeBoundingTree(maxDepth);
+        }
+        return;
+    }
 
     // set to false to avoid excessive loop
     m_needsUpdate=false;
-
-    type::Vec3 minElem, maxElem;
-    const VecCoord& x = this->m_mstate->read(core::vec_id::read_access::position)->getValue();
-
-    const bool calcNormals = d_computeNormals.getValue();
+    m_modifiedTriangles.clear();
 
     cubeModel->resize(size);  // size = number of triangles
     if (!empty())
     {
-        const SReal distance = (SReal)this->proximity.getValue();
         for (sofa::Size i=0; i<size; i++)
-        {
-            Element t(this,i);
-
-            const type::Vec3& pt1 = x[t.p1Index()];
-            const type::Vec3& pt2 = x[t.p2Index()];
-            const type::Vec3& pt3 = x[t.p3Index()];
-
-            for (int c = 0; c < 3; c++)
-            {
-                minElem[c] = pt1[c];
-                maxElem[c] = pt1[c];
-                if (pt2[c] > maxElem[c]) maxElem[c] = pt2[c];
-                else if (pt2[c] < minElem[c]) minElem[c] = pt2[c];
-                if (pt3[c] > maxElem[c]) maxElem[c] = pt3[c];
-                else if (pt3[c] < minElem[c]) minElem[c] = pt3[c];
-                minElem[c] -= distance;
-                maxElem[c] += distance;
-            }
-            if (calcNormals)
-            {
-                // Also recompute normal vector
-                t.n() = cross(pt2-pt1,pt3-pt1);
-                t.n().normalize();
-            }
-
-            if(d_useCurvature.getValue())
-                cubeModel->setParentOf(i, minElem, maxElem, t.n()); // define the bounding box of the current triangle
-            else
-                cubeModel->setParentOf(i, minElem, maxElem);
-        }
+            updateLeaf(i);
         cubeModel->computeBoundingTree(maxDepth);
     }
 }
@@ -285,9 +378,10 @@ void TriangleCollisionModel<DataTypes>::computeContinuousBoundingTree(SReal dt,
         updateFromTopology();
 
     if (m_needsUpdate) cubeModel->resize(0);
-    if (!isMoving() && !cubeModel->empty() && !m_needsUpdate) return; // No need to recompute BBox if immobile nor if mesh didn't change.
+    if (!isMoving() && !cubeModel->empty() && !m_needsUpdate && m_modifiedTriangles.empty()) return; // No need to recompute BBox if immobile nor if mesh didn't change.
 
     m_needsUpdate=false;
+    m_modifiedTriangles.clear();
     type::Vec3 minElem, maxElem;
 
     cubeModel->resize(size);
@@ -0,0 +1,247 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+
+#include <sofa/component/collision/geometry/CubeModel.h>
+using sofa::component::collision::geometry::Cube;
+using sofa::component::collision::geometry::CubeCollisionModel;
+
+#include <sofa/testing/BaseTest.h>
+using sofa::testing::BaseTest;
+
+#include <algorithm>
+#include <functional>
+#include <numeric>
+
+namespace
+{
+
+using sofa::type::Vec3;
+
+struct CubeModel_test : public BaseTest
+{
+    static constexpr int maxDepth = 4;
+
+    /// Elements of the model on which the tree is built, only their indices are used
+    CubeCollisionModel::SPtr m_children;
+    /// Leaf level of the tree
+    CubeCollisionModel* m_leaves { nullptr };
+    /// Bounding box of each child element, indexed by their original index
+    sofa::type::vector<std::pair<Vec3, Vec3> > m_boxes;
+
+    /// Build a tree over n boxes spread along the x axis
+    void build(sofa::Size n)
+    {
+        m_children = sofa::core::objectmodel::New<CubeCollisionModel>();
+        m_children->resize(n);
+        m_leaves = m_children->createPrevious<CubeCollisionModel>();
+        m_leaves->resize(n);
+        m_boxes.clear();
+        for (sofa::Index i = 0; i < n; ++i)
+        {
+            m_boxes.emplace_back(Vec3(i, 0, 0), Vec3(i + 1, 1, 1));
+            m_leaves->setParentOf(i, m_boxes[i].first, m_boxes[i].second);
+        }
+        m_leaves->computeBoundingTree(maxDepth);
+    }
+
+    static bool contains(const Cube& parent, const Vec3& min, const Vec3& max)
+    {
+        for (int c = 0; c < 3; ++c)
+        {
+            if (min[c] < parent.minVect()[c] || max[c] > parent.maxVect()[c])
+                return false;
+        }
+        return true;
+    }
+
+    /// Check that each child element is reached exactly once from the root, and that its
+    /// bounding box is contained in the boxes of all its ancestors
+    void checkTree(const sofa::type::vector<Vec3>& expectedMin, const sofa::type::vector<Vec3>& expectedMax)
+    {
+        const sofa::Size n = m_leaves->getSize();
+        ASSERT_EQ(n, m_children->getSize());
+        ASSERT_EQ(n, expectedMin.size());
+
+        sofa::type::vector<int> reached(n, 0);
+        std::vector<Cube> ancestors;
+        std::function<void(Cube)> visit = [&](Cube cube)
+        {
+            if (cube.getCollisionModel() == m_leaves)
+            {
+                const sofa::Index child = m_leaves->getLeafIndex(cube.getIndex());
+                ASSERT_LT(child, n);
+                ++reached[child];
+                EXPECT_EQ(cube.minVect(), expectedMin[child]);
+                EXPECT_EQ(cube.maxVect(), expectedMax[child]);
+                for (const Cube& a : ancestors)
+                    EXPECT_TRUE(contains(a, cube.minVect(), cube.maxVect())) << "child " << child;
+                return;
+            }
+            // the cells of the upper levels are not empty and their box is the union of the boxes of their subcells
+            ASSERT_NE(cube.subcells().first, cube.subcells().second);
+            Vec3 min = cube.subcells().first.minVect();
+            Vec3 max = cube.subcells().first.maxVect();
+            for (Cube c = cube.subcells().first; c != cube.subcells().second; ++c)
+            {
+                for (int i = 0; i < 3; ++i)
+                {
+                    min[i] = std::min(min[i], c.minVect()[i]);
+                    max[i] = std::max(max[i], c.maxVect()[i]);
+                }
+            }
+            EXPECT_EQ(cube.minVect(), min);
+            EXPECT_EQ(cube.maxVect(), max);
+
+            ancestors.push_back(cube);
+            for (Cube c = cube.subcells().first; c != cube.subcells().second; ++c)
+                visit(c);
+            ancestors.pop_back();
+        };
+        CubeCollisionModel* root = dynamic_cast<CubeCollisionModel*>(m_leaves->getFirst());
+        ASSERT_NE(root, nullptr);
+        ASSERT_EQ(root->getSize(), 1u);
+        visit(Cube(root, 0));
+
+        for (sofa::Index i = 0; i < n; ++i)
+            EXPECT_EQ(reached[i], 1) << "child " << i;
+    }
+
+    /// Remove the given children as the topology does (swap with the last one and pop),
+    /// add nbAdded new ones, update the leaves and check the tree
+    void removeAndAdd(const sofa::type::vector<sofa::Index>& removed, sofa::Size nbAdded)
+    {
+        sofa::type::vector<sofa::Index> previousIndices(m_leaves->getSize());
+        std::iota(previousIndices.begin(), previousIndices.end(), sofa::Index(0));
+        for (const sofa::Index i : removed)
+        {
+            std::swap(previousIndices[i], previousIndices.back());
+            previousIndices.pop_back();
+        }
+        previousIndices.resize(previousIndices.size() + nbAdded, sofa::InvalidID);
+
+        sofa::type::vector<sofa::Index> modified;
+        ASSERT_TRUE(m_leaves->updateLeaves(previousIndices, modified));
+
+        const sofa::Size n = sofa::Size(previousIndices.size());
+        // resize the elements only, as a triangle model does: CubeCollisionModel::resize would reset the tree
+        m_children->sofa::core::CollisionModel::resize(n);
+
+        // only the renumbered and new elements must be reported, the other leaves are kept
+        sofa::type::vector<Vec3> expectedMin(n), expectedMax(n);
+        sofa::type::vector<bool> isModified(n, false);
+        for (const sofa::Index c : modified)
+            isModified[c] = true;
+        for (sofa::Index c = 0; c < n; ++c)
+        {
+            EXPECT_EQ(isModified[c], previousIndices[c] != c) << "child " << c;
+            if (previousIndices[c] == sofa::InvalidID)
+            {
+                // new elements are put close to the removed ones
+                previousIndices[c] = sofa::Index(m_boxes.size());
+                m_boxes.emplace_back(Vec3(50.5, 0, 1), Vec3(51.5, 1, 2));
+            }
+            expectedMin[c] = m_boxes[previousIndices[c]].first;
+            expectedMax[c] = m_boxes[previousIndices[c]].second;
+            if (isModified[c])
+                m_leaves->setParentOf(c, expectedMin[c], expectedMax[c]);
+        }
+
+        // rebuild the original index of each child for the next change
+        sofa::type::vector<std::pair<Vec3, Vec3> > boxes(n);
+        for (sofa::Index c = 0; c < n; ++c)
+            boxes[c] = m_boxes[previousIndices[c]];
+        m_boxes = boxes;
+
+        const CubeCollisionModel* root = dynamic_cast<CubeCollisionModel*>(m_leaves->getFirst());
+        m_leaves->computeBoundingTree(maxDepth);
+        EXPECT_EQ(root, m_leaves->getFirst());
+
+        checkTree(expectedMin, expectedMax);
+    }
+};
+
+TEST_F(CubeModel_test, buildTree)
+{
+    build(100);
+    sofa::type::vector<Vec3> expectedMin, expectedMax;
+    for (const auto& box : m_boxes)
+    {
+        expectedMin.push_back(box.first);
+        expectedMax.push_back(box.second);
+    }
+    checkTree(expectedMin, expectedMax);
+}
+
+TEST_F(CubeModel_test, updateLeavesNeedsTree)
+{
+    m_children = sofa::core::objectmodel::New<CubeCollisionModel>();
+    m_children->resize(10);
+    m_leaves = m_children->createPrevious<CubeCollisionModel>();
+    m_leaves->resize(10);
+
+    sofa::type::vector<sofa::Index> previousIndices(9);
+    std::iota(previousIndices.begin(), previousIndices.end(), sofa::Index(0));
+    sofa::type::vector<sofa::Index> modified;
+    EXPECT_FALSE(m_leaves->updateLeaves(previousIndices, modified));
+}
+
+TEST_F(CubeModel_test, updateLeavesRemove)
+{
+    build(100);
+    removeAndAdd({ 97, 50, 10, 3 }, 0);
+    removeAndAdd({ 95, 0 }, 0);
+}
+
+TEST_F(CubeModel_test, updateLeavesRemoveAndAdd)
+{
+    build(100);
+    // less elements added than removed
+    removeAndAdd({ 20, 21, 22, 23 }, 2);
+    // as many elements added as removed
+    removeAndAdd({ 40, 41 }, 2);
+    // more elements added than removed
+    removeAndAdd({ 60 }, 5);
+    removeAndAdd({}, 3);
+}
+
+TEST_F(CubeModel_test, updateLeavesRemoveCells)
+{
+    build(100);
+    // remove the 30 first elements, which empties whole cells of the upper levels
+    sofa::type::vector<sofa::Index> removed(30);
+    std::iota(removed.begin(), removed.end(), sofa::Index(0));
+    removeAndAdd(removed, 0);
+
+    const Cube root(dynamic_cast<CubeCollisionModel*>(m_leaves->getFirst()), 0);
+    EXPECT_EQ(root.minVect(), Vec3(30, 0, 0));
+    EXPECT_EQ(root.maxVect(), Vec3(100, 1, 1));
+}
+
+TEST_F(CubeModel_test, updateLeavesInvalidIndices)
+{
+    build(20);
+    sofa::type::vector<sofa::Index> previousIndices(20, 0);
+    sofa::type::vector<sofa::Index> modified;
+    EXPECT_FALSE(m_leaves->updateLeaves(previousIndices, modified));
+}
+
+} // namespace
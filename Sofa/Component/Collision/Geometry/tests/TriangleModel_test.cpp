@@ -0,0 +1,222 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+
+#include <sofa/component/collision/geometry/TriangleModel.h>
+#include <sofa/component/collision/geometry/CubeModel.h>
+using sofa::component::collision::geometry::Cube;
+using sofa::component::collision::geometry::CubeCollisionModel;
+using sofa::component::collision::geometry::TriangleCollisionModel;
+
+#include <sofa/component/statecontainer/MechanicalObject.h>
+#include <sofa/component/topology/container/dynamic/TriangleSetTopologyContainer.h>
+#include <sofa/component/topology/container/dynamic/TriangleSetTopologyModifier.h>
+using sofa::component::topology::container::dynamic::TriangleSetTopologyContainer;
+using sofa::component::topology::container::dynamic::TriangleSetTopologyModifier;
+
+#include <sofa/simulation/graph/DAGNode.h>
+#include <sofa/testing/BaseTest.h>
+using sofa::testing::BaseTest;
+
+#include <functional>
+#include <numeric>
+
+namespace
+{
+
+using sofa::type::Vec3;
+using sofa::defaulttype::Vec3Types;
+
+/// Give access to the number of triangles changed by local updates since the tree was last built
+class TriangleModelWithLocalChanges : public TriangleCollisionModel<Vec3Types>
+{
+public:
+    SOFA_CLASS(TriangleModelWithLocalChanges, SOFA_TEMPLATE(TriangleCollisionModel, Vec3Types));
+    sofa::Size getNbLocalChanges() const { return m_nbLocalChanges; }
+};
+
+struct TriangleModel_test : public BaseTest
+{
+    static constexpr int maxDepth = 6;
+
+    sofa::simulation::Node::SPtr m_root;
+    TriangleSetTopologyContainer::SPtr m_container;
+    TriangleSetTopologyModifier::SPtr m_modifier;
+    TriangleModelWithLocalChanges::SPtr m_model;
+
+    /// Create a strip of 2*n triangles along the x axis, the triangles 2i and 2i+1 spanning [i,i+1]
+    void build(sofa::Size n, bool localTopologyUpdate)
+    {
+        m_root = sofa::core::objectmodel::New<sofa::simulation::graph::DAGNode>();
+
+        const auto mstate = sofa::core::objectmodel::New<sofa::component::statecontainer::MechanicalObject<Vec3Types> >();
+        mstate->resize(2 * (n + 1));
+        {
+            auto x = sofa::helper::getWriteOnlyAccessor(*mstate->write(sofa::core::vec_id::write_access::position));
+            for (sofa::Index i = 0; i <= n; ++i)
+            {
+                x[2 * i] = Vec3(i, 0, 0);
+                x[2 * i + 1] = Vec3(i, 1, 0);
+            }
+        }
+        m_root->addObject(mstate);
+
+        m_container = sofa::core::objectmodel::New<TriangleSetTopologyContainer>();
+        m_container->setNbPoints(2 * (n + 1));
+        for (sofa::Index i = 0; i < n; ++i)
+        {
+            m_container->addTriangle(2 * i, 2 * i + 2, 2 * i + 1);
+            m_container->addTriangle(2 * i + 1, 2 * i + 2, 2 * i + 3);
+        }
+        m_root->addObject(m_container);
+
+        m_modifier = sofa::core::objectmodel::New<TriangleSetTopologyModifier>();
+        m_root->addObject(m_modifier);
+
+        m_model = sofa::core::objectmodel::New<TriangleModelWithLocalChanges>();
+        m_model->d_localTopologyUpdate.setValue(localTopologyUpdate);
+        m_root->addObject(m_model);
+
+        m_root->init(sofa::core::execparams::defaultInstance());
+        m_model->computeBoundingTree(maxDepth);
+    }
+
+    /// Check that each triangle is reached exactly once from the root, that its leaf has the bounding box
+    /// of the triangle, and that the cells of the upper levels are not empty and fit their subcells
+    void checkTree()
+    {
+        const sofa::Size n = m_model->getSize();
+        ASSERT_EQ(n, m_container->getNbTriangles());
+        const auto& x = m_model->getMechanicalState()->read(sofa::core::vec_id::read_access::position)->getValue();
+
+        const auto* leaves = dynamic_cast<CubeCollisionModel*>(m_model->getPrevious());
+        ASSERT_NE(leaves, nullptr);
+        sofa::type::vector<int> reached(n, 0);
+        std::function<void(Cube)> visit = [&](Cube cube)
+        {
+            if (cube.getCollisionModel() == leaves)
+            {
+                const sofa::Index t = leaves->getLeafIndex(cube.getIndex());
+                ASSERT_LT(t, n);
+                ++reached[t];
+                Vec3 min = x[m_container->getTriangle(t)[0]];
+                Vec3 max = min;
+                for (const auto p : m_container->getTriangle(t))
+                {
+                    for (int i = 0; i < 3; ++i)
+                    {
+                        min[i] = std::min(min[i], x[p][i]);
+                        max[i] = std::max(max[i], x[p][i]);
+                    }
+                }
+                EXPECT_EQ(cube.minVect(), min) << "triangle " << t;
+                EXPECT_EQ(cube.maxVect(), max) << "triangle " << t;
+                return;
+            }
+
+            ASSERT_NE(cube.subcells().first, cube.subcells().second);
+            Vec3 min = cube.subcells().first.minVect();
+            Vec3 max = cube.subcells().first.maxVect();
+            for (Cube c = cube.subcells().first; c != cube.subcells().second; ++c)
+            {
+                for (int i = 0; i < 3; ++i)
+                {
+                    min[i] = std::min(min[i], c.minVect()[i]);
+                    max[i] = std::max(max[i], c.maxVect()[i]);
+                }
+                visit(c);
+            }
+            EXPECT_EQ(cube.minVect(), min);
+            EXPECT_EQ(cube.maxVect(), max);
+        };
+        CubeCollisionModel* root = dynamic_cast<CubeCollisionModel*>(m_model->getFirst());
+        ASSERT_NE(root, nullptr);
+        ASSERT_EQ(root->getSize(), 1u);
+        visit(Cube(root, 0));
+
+        for (sofa::Index t = 0; t < n; ++t)
+            EXPECT_EQ(reached[t], 1) << "triangle " << t;
+    }
+
+    void removeTriangles(sofa::type::vector<sofa::Index> triangles)
+    {
+        m_modifier->removeTriangles(triangles, false, false);
+        m_model->computeBoundingTree(maxDepth);
+    }
+};
+
+TEST_F(TriangleModel_test, localTopologyUpdateIsDisabledByDefault)
+{
+    const auto model = sofa::core::objectmodel::New<TriangleCollisionModel<Vec3Types> >();
+    EXPECT_FALSE(model->d_localTopologyUpdate.getValue());
+
+    // the tracking of the triangle indices is internal, it does not add a Data to the component
+    EXPECT_EQ(model->findData("previousIndices"), nullptr);
+}
+
+TEST_F(TriangleModel_test, removeTriangles)
+{
+    build(50, true);
+    checkTree();
+
+    removeTriangles({ 97, 50, 10, 3 });
+    EXPECT_GT(m_model->getNbLocalChanges(), 0u);
+    checkTree();
+
+    removeTriangles({ 0, 20 });
+    EXPECT_GT(m_model->getNbLocalChanges(), 0u);
+    checkTree();
+}
+
+TEST_F(TriangleModel_test, removeTrianglesEmptyingCells)
+{
+    build(200, true);
+
+    // remove the triangles spanning [0,15], which empties whole cells of the upper levels
+    sofa::type::vector<sofa::Index> removed(30);
+    std::iota(removed.begin(), removed.end(), sofa::Index(0));
+    removeTriangles(removed);
+    EXPECT_GT(m_model->getNbLocalChanges(), 0u);
+    checkTree();
+
+    const Cube root(dynamic_cast<CubeCollisionModel*>(m_model->getFirst()), 0);
+    EXPECT_EQ(root.minVect(), Vec3(15, 0, 0));
+    EXPECT_EQ(root.maxVect(), Vec3(200, 1, 0));
+}
+
+TEST_F(TriangleModel_test, removeTrianglesRebuildsTree)
+{
+    // without local update, the tree is built again after each change
+    build(50, false);
+    removeTriangles({ 97, 50, 10, 3 });
+    EXPECT_EQ(m_model->getNbLocalChanges(), 0u);
+    checkTree();
+
+    // once a quarter of the triangles changed, the tree is built again too
+    build(50, true);
+    sofa::type::vector<sofa::Index> removed(30);
+    std::iota(removed.begin(), removed.end(), sofa::Index(0));
+    removeTriangles(removed);
+    EXPECT_EQ(m_model->getNbLocalChanges(), 0u);
+    checkTree();
+}
+
+} // namespace
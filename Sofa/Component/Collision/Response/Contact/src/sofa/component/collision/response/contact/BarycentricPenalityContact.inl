@@ -192,16 +192,19 @@ void BarycentricPenalityContact<TCollisionModel1,TCollisionModel2,ResponseDataTy
 {
     if (ff!=nullptr)
     {
-        if (parent!=nullptr)
-        {
-            parent->removeObject(this);
-            parent->removeObject(ff);
-        }
-        parent = group;
-        if (parent!=nullptr)
+        if (parent != group)
         {
-            parent->addObject(this);
-            parent->addObject(ff);
+            if (parent!=nullptr)
+            {
+                parent->removeObject(this);
+                parent->removeObject(ff);
+            }
+            parent = group;
+            if (parent!=nullptr)
+            {
+                parent->addObject(this);
+                parent->addObject(ff);
+            }
         }
     }
 }
@@ -211,6 +214,9 @@ void BarycentricPenalityContact<TCollisionModel1,TCollisionModel2,ResponseDataTy
 {
     if (ff!=nullptr)
     {
+        // the mapped points are kept with their memory, but no longer computed
+        mapper1.resize(0);
+        mapper2.resize(0);
         if (parent!=nullptr)
         {
             parent->removeObject(this);
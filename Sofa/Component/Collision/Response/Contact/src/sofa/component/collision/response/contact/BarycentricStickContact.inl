@@ -190,16 +190,19 @@ void BarycentricStickContact<TCollisionModel1,TCollisionModel2,ResponseDataTypes
 {
     if (ff!=nullptr)
     {
-        if (parent!=nullptr)
-        {
-            parent->removeObject(this);
-            parent->removeObject(ff);
-        }
-        parent = group;
-        if (parent!=nullptr)
+        if (parent != group)
         {
-            parent->addObject(this);
-            parent->addObject(ff);
+            if (parent!=nullptr)
+            {
+                parent->removeObject(this);
+                parent->removeObject(ff);
+            }
+            parent = group;
+            if (parent!=nullptr)
+            {
+                parent->addObject(this);
+                parent->addObject(ff);
+            }
         }
     }
 }
@@ -209,6 +212,9 @@ void BarycentricStickContact<TCollisionModel1,TCollisionModel2,ResponseDataTypes
 {
     if (ff!=nullptr)
     {
+        // the mapped points are kept with their memory, but no longer computed
+        mapper1.resize(0);
+        mapper2.resize(0);
         if (parent!=nullptr)
         {
             parent->removeObject(this);
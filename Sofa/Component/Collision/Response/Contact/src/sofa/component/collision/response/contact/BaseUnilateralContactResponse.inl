@@ -225,17 +225,19 @@ void BaseUnilateralContactResponse<TCollisionModel1, TCollisionModel2, Constrain
             m_constraint->addContact(params, o->normal, distance, index1, index2, index, o->id);
         }
 
-        if (parent!=nullptr)
-        {
-            parent->removeObject(this);
-            parent->removeObject(m_constraint);
-        }
-
-        parent = group;
-        if (parent!=nullptr)
+        if (parent != group)
         {
-            parent->addObject(this);
-            parent->addObject(m_constraint);
+            if (parent!=nullptr)
+            {
+                parent->removeObject(this);
+                parent->removeObject(m_constraint);
+            }
+            parent = group;
+            if (parent!=nullptr)
+            {
+                parent->addObject(this);
+                parent->addObject(m_constraint);
+            }
         }
     }
 }
@@ -27,6 +27,8 @@
 #include <sofa/simulation/Node.h>
 #include <sofa/core/collision/Pipeline.h>
 
+#include <algorithm>
+
 namespace sofa::component::collision::response::contact
 {
 
@@ -39,6 +41,7 @@ void registerCollisionResponse(sofa::core::ObjectFactory* factory)
 CollisionResponse::CollisionResponse()
     : d_response(initData(&d_response, "response", "contact response class"))
     , d_responseParams(initData(&d_responseParams, "responseParams", "contact response parameters (syntax: name1=value1&name2=value2&...)"))
+    , d_contactPoolSize(initData(&d_contactPoolSize, 0u, "contactPoolSize", "Maximum number of inactive contacts kept, with their response components and mapped nodes, to be reused if their collision models collide again. If not 0, the responses of the active contacts also stay in the graph from one step to the next (0 to destroy the inactive contacts and to remove all the responses at each step)"))
 {
     response.setOriginalData(&d_response);
     responseParams.setOriginalData(&d_responseParams);
@@ -90,6 +93,7 @@ void CollisionResponse::cleanup()
     }
     contacts.clear();
     contactMap.clear();
+    shrinkContactPool(0);
 }
 
 void CollisionResponse::reset()
@@ -97,6 +101,11 @@ void CollisionResponse::reset()
     cleanup();
 }
 
+bool CollisionResponse::keepActiveResponses() const
+{
+    return d_contactPoolSize.getValue() > 0;
+}
+
 void CollisionResponse::setDefaultResponseType(const std::string &responseT)
 {
     if (d_response.getValue().size() == 0)
@@ -117,6 +126,7 @@ void CollisionResponse::setDefaultResponseType(const std::string &responseT)
 void CollisionResponse::changeInstance(Instance inst)
 {
     core::collision::ContactManager::changeInstance(inst);
+    shrinkContactPool(0);
     storedContactMap[instance].swap(contactMap);
     contactMap.swap(storedContactMap[inst]);
 }
@@ -124,6 +134,10 @@ void CollisionResponse::changeInstance(Instance inst)
 void CollisionResponse::createContacts(const DetectionOutputMap& outputsMap)
 {
     Size nbContacts = 0;
+    ++m_nbCreateContactsSteps;
+
+    // a pooled contact must not be reused for a new collision model allocated at the address of a removed one
+    removeDetachedInactiveContacts();
 
     // First iterate on the collision detection outputs and look for existing or new contacts
     createNewContacts(outputsMap, nbContacts);
@@ -166,6 +180,13 @@ void CollisionResponse::createNewContacts(const core::collision::ContactManager:
             {
                 contactMap.erase(contactIt);
             }
+            else if (auto inactiveContact = reuseInactiveContact(models, responseUsed))
+            {
+                // the contact was active during a previous step: it is already initialized
+                contactIt->second = inactiveContact;
+                inactiveContact->setDetectionOutputs(output);
+                ++nbContact;
+            }
             else
             {
                 auto contact = core::collision::Contact::Create(responseUsed, model1, model2, intersectionMethod,notMuted());
@@ -223,9 +244,7 @@ CollisionResponse::removeInactiveContacts(const core::collision::ContactManager:
             }
             else
             {
-                contact->removeResponse();
-                contact->cleanup();
-                contact.reset();
+                deactivateContact(contactIt->first, contact);
                 contactIt = contactMap.erase(contactIt);
             }
         }
@@ -234,6 +253,95 @@ CollisionResponse::removeInactiveContacts(const core::collision::ContactManager:
             ++contactIt;
         }
     }
+
+    shrinkContactPool(d_contactPoolSize.getValue());
+}
+
+void CollisionResponse::deactivateContact(const std::pair<core::CollisionModel*, core::CollisionModel*>& models,
+                                          core::collision::Contact::SPtr contact)
+{
+    contact->removeResponse();
+
+    if (d_contactPoolSize.getValue() == 0)
+    {
+        destroyContact(contact);
+        return;
+    }
+
+    InactiveContact& inactiveContact = m_inactiveContacts[models];
+    if (inactiveContact.contact != nullptr && inactiveContact.contact != contact)
+    {
+        destroyContact(inactiveContact.contact);
+    }
+    inactiveContact.contact = contact;
+    inactiveContact.model1 = models.first;
+    inactiveContact.model2 = models.second;
+    inactiveContact.response = getContactResponse(models.first, models.second);
+    inactiveContact.deactivationStep = m_nbCreateContactsSteps;
+}
+
+core::collision::Contact::SPtr CollisionResponse::reuseInactiveContact(const std::pair<core::CollisionModel*, core::CollisionModel*>& models,
+                                                                       const std::string& response)
+{
+    const auto inactiveContactIt = m_inactiveContacts.find(models);
+    if (inactiveContactIt == m_inactiveContacts.end())
+    {
+        return nullptr;
+    }
+
+    core::collision::Contact::SPtr contact = inactiveContactIt->second.contact;
+    if (inactiveContactIt->second.response != response)
+    {
+        // the response of the collision models changed: the contact cannot be reused
+        destroyContact(contact);
+    }
+    m_inactiveContacts.erase(inactiveContactIt);
+    return contact;
+}
+
+void CollisionResponse::shrinkContactPool(std::size_t nbContacts)
+{
+    removeDetachedInactiveContacts();
+
+    while (m_inactiveContacts.size() > nbContacts)
+    {
+        const auto oldest = std::min_element(m_inactiveContacts.begin(), m_inactiveContacts.end(),
+            [](const auto& a, const auto& b) { return a.second.deactivationStep < b.second.deactivationStep; });
+        destroyContact(oldest->second.contact);
+        m_inactiveContacts.erase(oldest);
+    }
+}
+
+void CollisionResponse::removeDetachedInactiveContacts()
+{
+    for (auto inactiveIt = m_inactiveContacts.begin(); inactiveIt != m_inactiveContacts.end();)
+    {
+        if (!isInGraph(inactiveIt->second.model1.get()) || !isInGraph(inactiveIt->second.model2.get()))
+        {
+            // the models are still alive: the contact can remove its mapped nodes from them
+            destroyContact(inactiveIt->second.contact);
+            inactiveIt = m_inactiveContacts.erase(inactiveIt);
+        }
+        else
+        {
+            ++inactiveIt;
+        }
+    }
+}
+
+bool CollisionResponse::isInGraph(const core::CollisionModel* model) const
+{
+    return model != nullptr && model->getContext() != nullptr
+        && model->getContext()->getRootContext() == this->getContext()->getRootContext();
+}
+
+void CollisionResponse::destroyContact(core::collision::Contact::SPtr& contact)
+{
+    if (contact != nullptr)
+    {
+        contact->cleanup();
+        contact.reset();
+    }
 }
 
 void
@@ -372,6 +480,20 @@ void CollisionResponse::removeContacts(const ContactVector &c)
             }
         }
 
+        // Inactive contacts
+        for (auto inactiveIt = m_inactiveContacts.begin(); inactiveIt != m_inactiveContacts.end();)
+        {
+            if (inactiveIt->second.contact == *remove_it)
+            {
+                destroyContact(inactiveIt->second.contact);
+                inactiveIt = m_inactiveContacts.erase(inactiveIt);
+            }
+            else
+            {
+                ++inactiveIt;
+            }
+        }
+
         ++remove_it;
     }
 }
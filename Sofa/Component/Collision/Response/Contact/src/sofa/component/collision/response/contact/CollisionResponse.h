@@ -46,6 +46,7 @@ public :
 
     Data<sofa::helper::OptionsGroup> d_response; ///< contact response class
     Data<std::string> d_responseParams; ///< contact response parameters (syntax: name1=value1&name2=value2&...)
+    Data<unsigned int> d_contactPoolSize; ///< maximum number of inactive contacts kept to be reused if their collision models collide again
 
     /// outputsVec fixes the reproducibility problems by storing contacts in the collision detection saved order
     /// if not given, it is still working but with eventual reproducibility problems
@@ -82,6 +83,9 @@ public :
      */
     void removeContacts(const ContactVector &/*c*/) override;
 
+    /// The responses of the active contacts stay in the graph only if the contact pool is enabled
+    bool keepActiveResponses() const override;
+
     void setDefaultResponseType(const std::string &responseT);
 
     std::string getDefaultResponseType() const { return d_response.getValue().getSelectedItem(); }
@@ -101,6 +105,26 @@ protected:
     ContactMap contactMap;
     std::map<Instance,ContactMap> storedContactMap;
 
+    /// A contact which is no longer active. Its response is removed from the graph, but it keeps its response
+    /// components and its mapped nodes, to be reused without modifying the graph structure.
+    struct InactiveContact
+    {
+        core::collision::Contact::SPtr contact;
+        /// the collision models of the contact, kept alive as long as the contact which refers to them
+        core::CollisionModel::SPtr model1;
+        core::CollisionModel::SPtr model2;
+        std::string response; ///< the response of the collision models when the contact became inactive
+        std::size_t deactivationStep { 0 };
+    };
+    typedef sofa::helper::map_ptr_stable_compare<
+                /* key */  std::pair<core::CollisionModel*, core::CollisionModel*>,
+                /* value */InactiveContact
+            > InactiveContactMap;
+
+    /// The inactive contacts, at most d_contactPoolSize
+    InactiveContactMap m_inactiveContacts;
+    std::size_t m_nbCreateContactsSteps { 0 };
+
     void changeInstance(Instance inst) override ;
 
     static sofa::helper::OptionsGroup initializeResponseOptions(sofa::core::objectmodel::BaseContext *pipeline);
@@ -117,6 +141,25 @@ protected:
 
     void removeInactiveContacts(const DetectionOutputMap &outputsMap, Size& nbContact);
 
+    /// Remove the response of a contact which is no longer active, and keep it in the pool if possible
+    void deactivateContact(const std::pair<core::CollisionModel*, core::CollisionModel*>& models,
+                           core::collision::Contact::SPtr contact);
+
+    /// Take the inactive contact between two collision models out of the pool, if it has the given response
+    core::collision::Contact::SPtr reuseInactiveContact(const std::pair<core::CollisionModel*, core::CollisionModel*>& models,
+                                                         const std::string& response);
+
+    /// Destroy the oldest inactive contacts, to keep at most nbContacts of them
+    void shrinkContactPool(std::size_t nbContacts);
+
+    /// Destroy the inactive contacts of which a collision model was removed from the graph
+    void removeDetachedInactiveContacts();
+
+    /// True if the collision model is in the same graph as this component
+    bool isInGraph(const core::CollisionModel* model) const;
+
+    static void destroyContact(core::collision::Contact::SPtr& contact);
+
     /// compute and set the number of contacts attached to each collision model
     /// The number of contacts corresponds to the number of collision models
     /// currently in contact with a collision model.
@@ -203,16 +203,19 @@ void StickContactConstraint<TCollisionModel1,TCollisionModel2>::createResponse(c
 
     if (m_constraint!=nullptr)
     {
-        if (parent!=nullptr)
-        {
-            parent->removeObject(this);
-            parent->removeObject(m_constraint);
-        }
-        parent = group;
-        if (parent!=nullptr)
+        if (parent != group)
         {
-            parent->addObject(this);
-            parent->addObject(m_constraint);
+            if (parent!=nullptr)
+            {
+                parent->removeObject(this);
+                parent->removeObject(m_constraint);
+            }
+            parent = group;
+            if (parent!=nullptr)
+            {
+                parent->addObject(this);
+                parent->addObject(m_constraint);
+            }
         }
     }
 }
@@ -220,9 +223,11 @@ void StickContactConstraint<TCollisionModel1,TCollisionModel2>::createResponse(c
 template < class TCollisionModel1, class TCollisionModel2 >
 void StickContactConstraint<TCollisionModel1,TCollisionModel2>::removeResponse()
 {
-    msg_info() << "->removeResponse()";
     if (m_constraint)
     {
+        // the mapped points are kept with their memory, but no longer computed
+        mapper1.resize(0);
+        mapper2.resize(0);
         if (parent!=nullptr)
         {
             parent->removeObject(this);
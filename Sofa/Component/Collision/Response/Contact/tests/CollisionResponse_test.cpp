@@ -0,0 +1,228 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/testing/BaseSimulationTest.h>
+using sofa::testing::BaseSimulationTest;
+
+#include <sofa/core/behavior/MechanicalState.h>
+#include <sofa/core/collision/ContactManager.h>
+#include <sofa/defaulttype/VecTypes.h>
+#include <sofa/simulation/Node.h>
+#include <sofa/simulation/Simulation.h>
+#include <sofa/simpleapi/SimpleApi.h>
+
+namespace
+{
+
+using namespace sofa;
+
+/// An object without behavior, added to the graph to detect if the responses are added to the graph again
+class MarkerObject : public core::objectmodel::BaseObject
+{
+public:
+    SOFA_CLASS(MarkerObject, core::objectmodel::BaseObject);
+};
+
+/// The contacts which become inactive are kept in the pool of the CollisionResponse, with their mapped nodes, and
+/// reused when their collision models collide again. The graph is not modified while a contact stays active.
+struct CollisionResponse_test : public BaseSimulationTest
+{
+    using MechanicalState = core::behavior::MechanicalState<defaulttype::Vec3Types>;
+
+    simulation::Node::SPtr m_root;
+    simulation::Node::SPtr m_object0;
+    simulation::Node::SPtr m_object1;
+    core::collision::ContactManager* m_contactManager { nullptr };
+
+    void createScene(unsigned int contactPoolSize)
+    {
+        this->loadPlugins({
+            Sofa.Component.StateContainer,
+            Sofa.Component.Collision.Geometry,
+            Sofa.Component.Collision.Detection.Algorithm,
+            Sofa.Component.Collision.Detection.Intersection,
+            Sofa.Component.Collision.Response.Contact
+        });
+
+        m_root = simulation::getSimulation()->createNewGraph("root");
+        simpleapi::createObject(m_root, "DefaultAnimationLoop");
+        simpleapi::createObject(m_root, "CollisionPipeline");
+        simpleapi::createObject(m_root, "BruteForceBroadPhase");
+        simpleapi::createObject(m_root, "BVHNarrowPhase");
+        simpleapi::createObject(m_root, "MinProximityIntersection", {{"alarmDistance", "0.3"}, {"contactDistance", "0.1"}});
+        simpleapi::createObject(m_root, "CollisionResponse", {{"name", "response"}, {"response", "PenalityContactForceField"},
+                                                              {"contactPoolSize", std::to_string(contactPoolSize)}});
+
+        m_object0 = simpleapi::createChild(m_root, "object0");
+        // the contact points on a rigid sphere are mapped in a child node of the sphere
+        simpleapi::createObject(m_object0, "MechanicalObject", {{"template", "Rigid3"}, {"position", "0 0 0 0 0 0 1"}});
+        simpleapi::createObject(m_object0, "SphereCollisionModel", {{"template", "Rigid3"}, {"radius", "0.5"}});
+
+        m_object1 = simpleapi::createChild(m_root, "object1");
+        simpleapi::createObject(m_object1, "MechanicalObject", {{"position", "3 0 0"}});
+        simpleapi::createObject(m_object1, "SphereCollisionModel", {{"radius", "0.5"}});
+
+        sofa::simulation::node::initRoot(m_root.get());
+
+        m_contactManager = dynamic_cast<core::collision::ContactManager*>(m_root->getObject("response"));
+        ASSERT_NE(m_contactManager, nullptr);
+    }
+
+    void doTearDown() override
+    {
+        sofa::simulation::node::unload(m_root);
+    }
+
+    /// Move the second sphere along the x axis, and compute a step
+    void stepAt(SReal x)
+    {
+        auto* state = dynamic_cast<MechanicalState*>(m_object1->getMechanicalState());
+        ASSERT_NE(state, nullptr);
+        {
+            auto positions = sofa::helper::getWriteAccessor(*state->write(core::vec_id::write_access::position));
+            positions[0] = { x, 0, 0 };
+        }
+        sofa::simulation::node::animate(m_root.get(), 0.01_sreal);
+    }
+
+    /// Add a marker object to the root, compute a step with an active contact, and return true if the response
+    /// of the contact was added to the graph again, i.e. after the marker
+    bool isActiveResponseAddedAgain()
+    {
+        const MarkerObject::SPtr marker = core::objectmodel::New<MarkerObject>();
+        m_root->addObject(marker);
+        stepAt(0.9);
+        return m_root->getNodeObjects<core::objectmodel::BaseObject>().back() != marker.get();
+    }
+
+    std::size_t getNbMappedNodes() const
+    {
+        return m_object0->getChildren().size() + m_object1->getChildren().size();
+    }
+};
+
+TEST_F(CollisionResponse_test, inactiveContactIsReused)
+{
+    createScene(1);
+    const std::size_t nbRootObjects = m_root->getNodeObjects<core::objectmodel::BaseObject>().size();
+
+    stepAt(3);
+    EXPECT_TRUE(m_contactManager->getContacts().empty());
+    EXPECT_EQ(getNbMappedNodes(), 0);
+
+    stepAt(0.95);
+    ASSERT_EQ(m_contactManager->getContacts().size(), 1);
+    const core::collision::Contact::SPtr contact = m_contactManager->getContacts()[0];
+    const std::size_t nbMappedNodes = getNbMappedNodes();
+    EXPECT_GT(nbMappedNodes, 0);
+
+    // the response is attached to the root, with its force field
+    const auto rootObjects = m_root->getNodeObjects<core::objectmodel::BaseObject>();
+    EXPECT_EQ(rootObjects.size(), nbRootObjects + 2);
+
+    // the contact stays active: the graph is not modified
+    stepAt(0.9);
+    ASSERT_EQ(m_contactManager->getContacts().size(), 1);
+    EXPECT_EQ(m_contactManager->getContacts()[0], contact);
+    EXPECT_EQ(m_root->getNodeObjects<core::objectmodel::BaseObject>(), rootObjects);
+    EXPECT_EQ(getNbMappedNodes(), nbMappedNodes);
+
+    // the contact becomes inactive: its response is removed, its mapped nodes are kept
+    stepAt(3);
+    EXPECT_TRUE(m_contactManager->getContacts().empty());
+    EXPECT_EQ(m_root->getNodeObjects<core::objectmodel::BaseObject>().size(), nbRootObjects);
+    EXPECT_EQ(getNbMappedNodes(), nbMappedNodes);
+
+    // the contact is reused
+    stepAt(0.95);
+    ASSERT_EQ(m_contactManager->getContacts().size(), 1);
+    EXPECT_EQ(m_contactManager->getContacts()[0], contact);
+    EXPECT_EQ(m_root->getNodeObjects<core::objectmodel::BaseObject>().size(), nbRootObjects + 2);
+    EXPECT_EQ(getNbMappedNodes(), nbMappedNodes);
+}
+
+TEST_F(CollisionResponse_test, inactiveContactIsDestroyedWithoutPool)
+{
+    createScene(0);
+
+    stepAt(0.95);
+    ASSERT_EQ(m_contactManager->getContacts().size(), 1);
+    const core::collision::Contact::SPtr contact = m_contactManager->getContacts()[0];
+    EXPECT_GT(getNbMappedNodes(), 0);
+
+    stepAt(3);
+    EXPECT_TRUE(m_contactManager->getContacts().empty());
+    EXPECT_EQ(getNbMappedNodes(), 0);
+
+    stepAt(0.95);
+    ASSERT_EQ(m_contactManager->getContacts().size(), 1);
+    EXPECT_NE(m_contactManager->getContacts()[0], contact);
+}
+
+TEST_F(CollisionResponse_test, inactiveContactIsDestroyedWithItsModel)
+{
+    createScene(1);
+
+    stepAt(0.95);
+    ASSERT_EQ(m_contactManager->getContacts().size(), 1);
+    stepAt(3);
+    EXPECT_TRUE(m_contactManager->getContacts().empty());
+    EXPECT_GT(m_object0->getChildren().size(), 0);
+
+    // the node of a pooled model leaves the graph: the contact and its mapped nodes are destroyed at the next step
+    m_root->removeChild(m_object1);
+    sofa::simulation::node::animate(m_root.get(), 0.01_sreal);
+    EXPECT_TRUE(m_contactManager->getContacts().empty());
+    EXPECT_EQ(m_object0->getChildren().size(), 0);
+
+    // a new model colliding with the remaining one gets a new contact
+    const auto object2 = simpleapi::createChild(m_root, "object2");
+    simpleapi::createObject(object2, "MechanicalObject", {{"position", "0.95 0 0"}});
+    simpleapi::createObject(object2, "SphereCollisionModel", {{"radius", "0.5"}});
+    sofa::simulation::node::init(object2.get());
+    sofa::simulation::node::animate(m_root.get(), 0.01_sreal);
+    ASSERT_EQ(m_contactManager->getContacts().size(), 1);
+    const auto models = m_contactManager->getContacts()[0]->getCollisionModels();
+    ASSERT_EQ(object2->collisionModel.size(), 1);
+    EXPECT_TRUE(models.first == object2->collisionModel[0] || models.second == object2->collisionModel[0]);
+}
+
+TEST_F(CollisionResponse_test, activeResponseStaysInGraphWithPool)
+{
+    createScene(1);
+
+    stepAt(0.95);
+    ASSERT_EQ(m_contactManager->getContacts().size(), 1);
+    EXPECT_TRUE(m_contactManager->keepActiveResponses());
+    EXPECT_FALSE(isActiveResponseAddedAgain());
+}
+
+TEST_F(CollisionResponse_test, activeResponseIsAddedAgainWithoutPool)
+{
+    createScene(0);
+
+    stepAt(0.95);
+    ASSERT_EQ(m_contactManager->getContacts().size(), 1);
+    EXPECT_FALSE(m_contactManager->keepActiveResponses());
+    EXPECT_TRUE(isActiveResponseAddedAgain());
+}
+
+}
@@ -28,6 +28,7 @@
 #include <sofa/core/behavior/ConstraintSolver.h>
 #include <sofa/core/behavior/LinearSolver.h>
 #include <sofa/core/ConstraintParams.h>
+#include <sofa/helper/ScopedAdvancedTimer.h>
 
 using sofa::core::execparams::defaultInstance; 
 
@@ -167,6 +168,7 @@ void GenericConstraintCorrection::addComplianceInConstraintSpace(const Constrain
 
     factor *= complianceFactor;
     // use the Linear solver to compute J*inv(M)*Jt, where M is the mechanical linear system matrix
+    SCOPED_TIMER("buildComplianceMatrix");
     l_linearSolver.get()->buildComplianceMatrix(cparams, W, factor, d_regularizationTerm.getValue());
 
 }
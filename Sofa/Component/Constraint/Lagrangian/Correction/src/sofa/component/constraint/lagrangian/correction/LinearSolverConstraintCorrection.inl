@@ -219,7 +219,10 @@ void LinearSolverConstraintCorrection<DataTypes>::addComplianceInConstraintSpace
 
     // use the Linear solver to compute J*inv(M)*Jt, where M is the mechanical linear system matrix
     l_linearSolver->setSystemLHVector(sofa::core::MultiVecDerivId::null());
-    l_linearSolver->addJMInvJt(W, &m_constraintJacobian, factor);
+    {
+        SCOPED_TIMER("addJMInvJt");
+        l_linearSolver->addJMInvJt(W, &m_constraintJacobian, factor);
+    }
 
     addRegularization(W);
 }
@@ -758,7 +761,10 @@ void LinearSolverConstraintCorrection<DataTypes>::getBlockDiagonalCompliance(lin
     }
 
     // use the Linear solver to compute J*inv(M)*Jt, where M is the mechanical linear system matrix
-    l_linearSolver->addJMInvJt(W, &m_constraintJacobian, factor);
+    {
+        SCOPED_TIMER("addJMInvJt");
+        l_linearSolver->addJMInvJt(W, &m_constraintJacobian, factor);
+    }
 
     // construction of  Vec_I_list_dof : vector containing, for each constraint block, the list of dof concerned
 
@@ -26,12 +26,15 @@
 #include <sofa/core/objectmodel/DataFileName.h>
 
 #include <sofa/linearalgebra/FullMatrix.h>
+#include <sofa/linearalgebra/BlockLowRankMatrix.h>
 
 #include <sofa/type/Mat.h>
 #include <sofa/type/Vec.h>
 
 #include <sofa/core/objectmodel/lifecycle/RenamedData.h>
 
+#include <memory>
+
 namespace sofa::component::constraint::lagrangian::correction
 {
 
@@ -86,6 +89,11 @@ public:
     Data<SReal> d_debugViewFrameScale; ///< Scale on computed node's frame
     sofa::core::objectmodel::DataFileName d_fileCompliance; ///< Precomputed compliance matrix data file
     Data<std::string> d_fileDir; ///< If not empty, the compliance will be saved in this repertory
+    Data<bool> d_compressCompliance; ///< If true, the compliance is stored in a compressed format, and the saved file is memory-mapped when loaded
+    Data<bool> d_singlePrecisionStorage; ///< Store the compressed compliance in single precision
+    Data<bool> d_symmetricStorage; ///< Only store the lower part of the compressed compliance
+    Data<SReal> d_compressionTolerance; ///< Relative tolerance of the low-rank approximation of the off-diagonal tiles of the compressed compliance. If 0, all the tiles are stored dense
+    Data<unsigned int> d_compressionTileSize; ///< Number of nodes in the tiles of the compressed compliance
     
 protected:
     PrecomputedConstraintCorrection(sofa::core::behavior::MechanicalState<DataTypes> *mm = nullptr);
@@ -141,6 +149,7 @@ public:
     struct InverseStorage
     {
         Real* data;
+        std::unique_ptr<linearalgebra::BlockLowRankMatrix> compressed; ///< set instead of data if the compliance is compressed
         int nbref;
         InverseStorage() : data(nullptr), nbref(0) {}
     };
@@ -183,6 +192,8 @@ public:
     {
         if (invM->data)
             return invM->data;
+        else if (invM->compressed)
+            msg_error() << "Inverse is compressed, it can only be read with getComplianceMatrix";
         else
             msg_error() << "Inverse is not computed yet";
         return nullptr;
@@ -211,6 +222,21 @@ protected:
      */
     void computeDx(Data<VecDeriv>& dx, const Data< VecDeriv > &f, const std::list< int > &activeDofs);
 
+    /**
+     * @brief Block of the compliance coupling the dofs of rowNode to the ones of colNode.
+     *
+     * The element (i,j) of the block is at block[i * stride + j]. If the compliance is compressed,
+     * the returned pointer is only valid until the next call.
+     */
+    const Real* getComplianceBlock(unsigned int rowNode, unsigned int colNode, unsigned int& stride);
+
+    /**
+     * @brief Replace the dense compliance by its compressed representation.
+     */
+    void compressCompliance();
+
+    type::vector<Real> m_complianceBlock;
+
     std::list< int > m_activeDofs;
 };
 
@@ -60,6 +60,12 @@ PrecomputedConstraintCorrection<DataTypes>::PrecomputedConstraintCorrection(sofa
     , d_debugViewFrameScale(initData(&d_debugViewFrameScale, 1.0_sreal, "debugViewFrameScale", "Scale on computed node's frame"))
     , d_fileCompliance(initData(&d_fileCompliance, "fileCompliance", "Precomputed compliance matrix data file"))
     , d_fileDir(initData(&d_fileDir, "fileDir", "If not empty, the compliance will be saved in this repertory"))
+    , d_compressCompliance(initData(&d_compressCompliance, false, "compressCompliance", "If true, the compliance is stored in a compressed format, and the saved file is memory-mapped when loaded, "
+                                                                                        "so that all the processes using the same file share the same memory. Compressed files are always loaded this way."))
+    , d_singlePrecisionStorage(initData(&d_singlePrecisionStorage, true, "singlePrecisionStorage", "Store the compressed compliance in single precision"))
+    , d_symmetricStorage(initData(&d_symmetricStorage, true, "symmetricStorage", "Only store the lower part of the compressed compliance, which is symmetrized"))
+    , d_compressionTolerance(initData(&d_compressionTolerance, 0.0_sreal, "compressionTolerance", "Relative tolerance of the low-rank approximation of the off-diagonal tiles of the compressed compliance. If 0, all the tiles are stored dense"))
+    , d_compressionTileSize(initData(&d_compressionTileSize, 32u, "compressionTileSize", "Number of nodes in the tiles of the compressed compliance"))
     , invM(nullptr)
     , appCompliance(nullptr)
     , nbRows(0), nbCols(0), dof_on_node(0), nbNodes(0)
@@ -134,7 +140,31 @@ bool PrecomputedConstraintCorrection<DataTypes>::loadCompliance(std::string file
     invM = getInverse(fileName);
     dimensionAppCompliance = nbRows;
 
-    if (invM->data == nullptr)
+    // Read the file, using a memory mapping if it contains a compressed compliance
+    const auto readFile = [this](const std::string& path)
+    {
+        if (linearalgebra::BlockLowRankMatrix::isBlockLowRankFile(path))
+        {
+            auto compressed = std::make_unique<linearalgebra::BlockLowRankMatrix>();
+            if (!compressed->load(path) || compressed->size() != nbRows)
+            {
+                msg_error() << "File " << path << " does not contain a compressed compliance of size " << nbRows;
+                return false;
+            }
+            invM->compressed = std::move(compressed);
+            return true;
+        }
+
+        invM->data = new Real[nbRows * nbCols];
+
+        std::ifstream compFileIn(path, std::ifstream::binary);
+        compFileIn.read((char*)invM->data, nbCols * nbRows * sizeof(Real));
+        compFileIn.close();
+
+        return true;
+    };
+
+    if (invM->data == nullptr && invM->compressed == nullptr)
     {
         // Try to load from file
         msg_info() << "Try to load compliance from : " << fileName ;
@@ -143,17 +173,11 @@ bool PrecomputedConstraintCorrection<DataTypes>::loadCompliance(std::string file
         if (!dir.empty())
         {
             const std::string path = helper::system::FileSystem::append(dir, fileName);
-            std::ifstream compFileIn(path, std::ifstream::binary);
-            if (compFileIn.is_open())
+            if (helper::system::FileSystem::exists(path))
             {
-                invM->data = new Real[nbRows * nbCols];
-
                 msg_info() << "File " << path << " found. Loading..." ;
 
-                compFileIn.read((char*)invM->data, nbCols * nbRows * sizeof(Real));
-                compFileIn.close();
-
-                return true;
+                return readFile(path);
             }
             else
                 return false;
@@ -163,16 +187,9 @@ bool PrecomputedConstraintCorrection<DataTypes>::loadCompliance(std::string file
             std::stringstream ss;
             if (sofa::helper::system::DataRepository.findFile(fileName, "", &ss))
             {
-                invM->data = new Real[nbRows * nbCols];
-
-                std::ifstream compFileIn(fileName.c_str(), std::ifstream::binary);
-
                 msg_info() << "File " << fileName << " found. Loading..." ;
 
-                compFileIn.read((char*)invM->data, nbCols * nbRows * sizeof(Real));
-                compFileIn.close();
-
-                return true;
+                return readFile(fileName);
             }
             else
             {
@@ -209,11 +226,59 @@ void PrecomputedConstraintCorrection<DataTypes>::saveCompliance(const std::strin
     msg_info() << "Compliance file has been saved in " << filePathInSofaShare << ". Load this file using fileCompliance if you don't want to recompute the compliance matrice at next start.";
     this->f_printLog.setValue(printLog);
 
+    if (invM->compressed)
+    {
+        invM->compressed->save(filePathInSofaShare);
+        return;
+    }
+
     std::ofstream compFileOut(filePathInSofaShare.c_str(), std::fstream::out | std::fstream::binary);
     compFileOut.write((char*)invM->data, nbCols * nbRows * sizeof(Real));
     compFileOut.close();
 }
 
+template<class DataTypes>
+void PrecomputedConstraintCorrection<DataTypes>::compressCompliance()
+{
+    if (invM->data == nullptr || invM->compressed != nullptr)
+        return;
+
+    if (invM->nbref > 1)
+    {
+        msg_warning() << "The compliance is shared with other components, it is kept uncompressed";
+        return;
+    }
+
+    linearalgebra::BlockLowRankMatrix::Options options;
+    options.singlePrecision = d_singlePrecisionStorage.getValue();
+    options.symmetric = d_symmetricStorage.getValue();
+    options.tolerance = d_compressionTolerance.getValue();
+    options.tileSize = std::max(1u, d_compressionTileSize.getValue()) * dof_on_node;
+
+    invM->compressed = std::make_unique<linearalgebra::BlockLowRankMatrix>();
+    invM->compressed->compress(invM->data, nbRows, options);
+
+    msg_info() << "Compliance compressed from " << nbRows * nbCols * sizeof(Real) << " to " << invM->compressed->memorySize()
+               << " bytes (" << invM->compressed->getNbLowRankTiles() << " low-rank tiles)";
+
+    delete[] invM->data;
+    invM->data = nullptr;
+}
+
+template<class DataTypes>
+auto PrecomputedConstraintCorrection<DataTypes>::getComplianceBlock(unsigned int rowNode, unsigned int colNode, unsigned int& stride) -> const Real*
+{
+    if (appCompliance)
+    {
+        stride = nbCols;
+        return appCompliance + dof_on_node * (rowNode * nbCols + colNode);
+    }
+
+    stride = dof_on_node;
+    invM->compressed->getBlock(rowNode * dof_on_node, colNode * dof_on_node, dof_on_node, dof_on_node, m_complianceBlock.data());
+    return m_complianceBlock.data();
+}
+
 
 
 template<class DataTypes>
@@ -385,6 +450,9 @@ void PrecomputedConstraintCorrection<DataTypes>::bwdInit()
         if (linearSolver)
             linearSolver->freezeSystemMatrix();
 
+        if (d_compressCompliance.getValue())
+            compressCompliance();
+
         saveCompliance(invName);
 
         // Restore gravity
@@ -410,7 +478,12 @@ void PrecomputedConstraintCorrection<DataTypes>::bwdInit()
             pos[i] = prev_pos[i];
     }
 
+    // a dense compliance loaded from a file is compressed in memory only
+    if (complianceLoaded && d_compressCompliance.getValue())
+        compressCompliance();
+
     appCompliance = invM->data;
+    m_complianceBlock.resize(dof_on_node * dof_on_node);
 
     // Optimisation for the computation of W
     _indexNodeSparseCompliance.resize(v0.size());
@@ -483,7 +556,7 @@ void PrecomputedConstraintCorrection< DataTypes >::addComplianceInConstraintSpac
     m_activeDofs.sort();
     m_activeDofs.unique();
 
-    unsigned int offset, offset2;
+    unsigned int stride;
     unsigned int ii,jj, it;
     Deriv Vbuf;
     it = 0;
@@ -506,15 +579,13 @@ void PrecomputedConstraintCorrection< DataTypes >::addComplianceInConstraintSpac
             for (MatrixDerivColConstIterator colIt = rowIt.begin(); colIt != colItEnd; ++colIt)
             {
                 const Deriv n2 = colIt.val();
-                offset = dof_on_node * (NodeIdx * nbCols +  colIt.index());
+                const Real* block = getComplianceBlock(NodeIdx, colIt.index(), stride);
 
                 for (ii = 0; ii < dof_on_node; ii++)
                 {
-                    offset2 = offset + ii * nbCols;
-
                     for (jj = 0; jj < dof_on_node; jj++)
                     {
-                        Vbuf[ii] += appCompliance[offset2 + jj] * n2[jj];
+                        Vbuf[ii] += block[ii * stride + jj] * n2[jj];
                     }
                 }
             }
@@ -578,7 +649,7 @@ void PrecomputedConstraintCorrection<DataTypes>::computeDx(Data<VecDeriv>& dx_d
     dx.resize(force.size());
 
     std::list<int>::const_iterator IterateurListe;
-    unsigned int i, offset, offset2;
+    unsigned int i, stride;
 
     for (IterateurListe = activeDofs.begin(); IterateurListe != activeDofs.end(); ++IterateurListe)
     {
@@ -591,15 +662,14 @@ void PrecomputedConstraintCorrection<DataTypes>::computeDx(Data<VecDeriv>& dx_d
 
         for (unsigned int v = 0 ; v < dx.size() ; v++)
         {
-            offset =  v * dof_on_node * nbCols + f * dof_on_node;
+            const Real* block = getComplianceBlock(v, f, stride);
             for (unsigned int j = 0; j < dof_on_node; j++)
             {
-                offset2 = offset + j * nbCols;
                 DXbuf = 0.0;
 
                 for (i = 0; i < dof_on_node; i++)
                 {
-                    DXbuf += appCompliance[ offset2 + i ] * Fbuf[i];
+                    DXbuf += block[j * stride + i] * Fbuf[i];
                 }
 
                 dx[v][j] += DXbuf;
@@ -744,7 +814,7 @@ void PrecomputedConstraintCorrection<DataTypes>::applyContactForce(const lineara
     activeDofs.sort();
     activeDofs.unique();
 
-    unsigned int offset, offset2;
+    unsigned int stride;
     for (const auto dofId : activeDofs)
     {
         for (unsigned int i=0; i< dof_on_node; i++)
@@ -754,14 +824,13 @@ void PrecomputedConstraintCorrection<DataTypes>::applyContactForce(const lineara
 
         for(unsigned int i = 0 ; i < dx.size() ; i++)
         {
-            offset =  i * dof_on_node * nbCols + dofId * dof_on_node;
+            const Real* block = getComplianceBlock(i, dofId, stride);
             for (unsigned int j=0; j< dof_on_node; j++)
             {
-                offset2 = offset+ j*nbCols;
                 DXbuf=0.0;
                 for (unsigned int k = 0; k < dof_on_node; k++)
                 {
-                    DXbuf += appCompliance[ offset2 + k ] * Fbuf[k];
+                    DXbuf += block[j * stride + k] * Fbuf[k];
                 }
                 dx[i][j]+=DXbuf;
             }
@@ -794,7 +863,7 @@ void PrecomputedConstraintCorrection<DataTypes>::getComplianceMatrix(linearalgeb
     {
         for (unsigned int c = 0; c < dimensionAppCompliance; ++c)
         {
-            m->set(l, c, appCompliance[l * dimensionAppCompliance + c]);
+            m->set(l, c, appCompliance ? appCompliance[l * dimensionAppCompliance + c] : invM->compressed->element(l, c));
         }
     }
 }
@@ -1050,7 +1119,7 @@ void PrecomputedConstraintCorrection<DataTypes>::resetForUnbuiltResolution(SReal
 
 #ifndef NEW_METHOD_UNBUILT
 
-    unsigned int offset, offset2;
+    unsigned int stride;
     Deriv Vbuf;
     unsigned int it = 0;
 
@@ -1071,15 +1140,13 @@ void PrecomputedConstraintCorrection<DataTypes>::resetForUnbuiltResolution(SReal
 
             for (MatrixDerivColConstIterator colIt = rowIt.begin(); colIt != colItEnd; ++colIt)
             {
-                offset = dof_on_node * (NodeIdx * nbCols +  colIt.index());
+                const Real* block = getComplianceBlock(NodeIdx, colIt.index(), stride);
 
                 for (unsigned int ii = 0; ii < dof_on_node; ii++)
                 {
-                    offset2 = offset + ii *nbCols;
-
                     for (unsigned int jj = 0; jj < dof_on_node; jj++)
                     {
-                        Vbuf[ii] += appCompliance[offset2 + jj] * colIt.val()[jj];
+                        Vbuf[ii] += block[ii * stride + jj] * colIt.val()[jj];
                     }
                 }
             }
@@ -1196,7 +1263,7 @@ void PrecomputedConstraintCorrection<DataTypes>::setConstraintDForce(SReal * /*d
     if (!update)
         return;
 
-    unsigned int offset, offset2;
+    unsigned int stride;
 
     for (int i = begin; i <= end; i++)
     {
@@ -1225,15 +1292,14 @@ void PrecomputedConstraintCorrection<DataTypes>::setConstraintDForce(SReal * /*d
                 for (std::list< int >::const_iterator dofsIt = constraint_dofs.begin(); dofsIt != dofsItEnd; ++dofsIt)
                 {
                     int dof2 = *dofsIt;
-                    offset = dof2 * dof_on_node * nbCols + dof * dof_on_node;
+                    const Real* block = getComplianceBlock(dof2, dof, stride);
 
                     for (unsigned int j = 0; j < dof_on_node; j++)
                     {
-                        offset2 = offset + j * nbCols;
                         DXbuf = 0.0;
                         for (unsigned int k = 0; k < dof_on_node; k++)
                         {
-                            DXbuf += appCompliance[ offset2 + k ] * Fbuf[k];
+                            DXbuf += block[j * stride + k] * Fbuf[k];
                         }
 
                         constraint_D[dof2][j] += DXbuf;
@@ -1290,7 +1356,7 @@ void PrecomputedConstraintCorrection<DataTypes>::getBlockDiagonalCompliance(line
     localActiveDof.sort();
     localActiveDof.unique();
 
-    unsigned int offset, offset2;
+    unsigned int stride;
     Deriv Vbuf;
     int it = 0;
     int it_localActiveDof = 0;
@@ -1321,15 +1387,13 @@ void PrecomputedConstraintCorrection<DataTypes>::getBlockDiagonalCompliance(line
                 {
                     const Deriv n2 = colIt.val();
 
-                    offset = dof_on_node * (dof1 * nbCols +  colIt.index());
+                    const Real* block = getComplianceBlock(dof1, colIt.index(), stride);
 
                     for (unsigned int ii = 0; ii < dof_on_node; ii++)
                     {
-                        offset2 = offset + ii * nbCols;
-
                         for (unsigned int jj = 0; jj < dof_on_node; jj++)
                         {
-                            Vbuf[ii] += appCompliance[offset2 + jj] * n2[jj];
+                            Vbuf[ii] += block[ii * stride + jj] * n2[jj];
                         }
                     }
                 }
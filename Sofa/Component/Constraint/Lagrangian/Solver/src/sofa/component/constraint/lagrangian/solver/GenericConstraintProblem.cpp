@@ -37,11 +37,25 @@ void GenericConstraintProblem::clear(int nbC)
     _d.resize(nbC);
 }
 
+void GenericConstraintProblem::clearWithoutCompliance(int nbC)
+{
+    clear(0);
+
+    dimension = nbC;
+    dFree.resize(nbC);
+    f.resize(nbC);
+    constraintsResolutions.resize(nbC);
+    _d.resize(nbC);
+}
+
 void GenericConstraintProblem::freeConstraintResolutions()
 {
     for(auto*& constraintsResolution : constraintsResolutions)
     {
-        delete constraintsResolution;
+        if (!isIsland)
+        {
+            delete constraintsResolution;
+        }
         constraintsResolution = nullptr;
     }
 }
@@ -125,7 +139,10 @@ void GenericConstraintProblem::gaussSeidel(SReal timeout, GenericConstraintSolve
             msg_error(solver) << "Bad size of constraintsResolutions in GenericConstraintProblem" ;
             break;
         }
-        constraintsResolutions[i]->init(i, w, force);
+        if(!isIsland)
+        {
+            constraintsResolutions[i]->init(i, w, force);
+        }
         i += constraintsResolutions[i]->getNbLines();
     }
 
@@ -553,7 +570,10 @@ void GenericConstraintProblem::NNCG(GenericConstraintSolver* solver, int iterati
             msg_error(solver) << "Bad size of constraintsResolutions in GenericConstraintProblem" ;
             break;
         }
-        constraintsResolutions[i]->init(i, w, force);
+        if(!isIsland)
+        {
+            constraintsResolutions[i]->init(i, w, force);
+        }
         i += constraintsResolutions[i]->getNbLines();
     }
 
@@ -718,6 +738,7 @@ void GenericConstraintProblem::result_output(GenericConstraintSolver *solver, SR
 {
     currentError = error;
     currentIterations = iterCount+1;
+    hasConverged = convergence;
 
     sofa::helper::AdvancedTimer::valSet("GS iterations", currentIterations);
 
@@ -730,6 +751,11 @@ void GenericConstraintProblem::result_output(GenericConstraintSolver *solver, SR
         msg_info(solver) << "Convergence after " << currentIterations << " iterations " ;
     }
 
+    if(isIsland)
+    {
+        return;
+    }
+
     for(int i=0; i<dimension; i += constraintsResolutions[i]->getNbLines())
     {
         constraintsResolutions[i]->store(i, force, convergence);
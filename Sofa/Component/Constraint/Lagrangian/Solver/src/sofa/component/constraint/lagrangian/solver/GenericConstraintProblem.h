@@ -51,6 +51,13 @@ public:
 
     std::vector< ConstraintCorrections > cclist_elems;
 
+    /// True if this problem is an island of a larger problem. Its constraint resolutions belong to the larger
+    /// problem, which initializes and stores them in the order of its own constraints.
+    bool isIsland { false };
+
+    /// True if the last resolution converged
+    bool hasConverged { false };
+
 
     GenericConstraintProblem() : scaleTolerance(true), allVerified(false), sor(1.0)
       , sceneTime(0.0), currentError(0.0), currentIterations(0)
@@ -58,6 +65,8 @@ public:
     ~GenericConstraintProblem() override { freeConstraintResolutions(); }
 
     void clear(int nbConstraints) override;
+    /// Same as clear, but the compliance matrix W is left empty, as it is not assembled for the whole problem
+    void clearWithoutCompliance(int nbConstraints);
     void freeConstraintResolutions();
     void solveTimed(SReal tol, int maxIt, SReal timeout) override;
 
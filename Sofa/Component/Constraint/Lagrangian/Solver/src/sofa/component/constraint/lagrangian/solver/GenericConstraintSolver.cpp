@@ -33,6 +33,7 @@
 #include <sofa/helper/ScopedAdvancedTimer.h>
 #include <sofa/simulation/MainTaskSchedulerFactory.h>
 #include <sofa/simulation/ParallelForEach.h>
+#include <numeric>
 
 #include <sofa/simulation/mechanicalvisitor/MechanicalVOpVisitor.h>
 using sofa::simulation::mechanicalvisitor::MechanicalVOpVisitor;
@@ -40,6 +41,9 @@ using sofa::simulation::mechanicalvisitor::MechanicalVOpVisitor;
 #include <sofa/simulation/mechanicalvisitor/MechanicalProjectJacobianMatrixVisitor.h>
 using sofa::simulation::mechanicalvisitor::MechanicalProjectJacobianMatrixVisitor;
 
+#include <sofa/simulation/mechanicalvisitor/MechanicalGetConstraintJacobianVisitor.h>
+using sofa::simulation::mechanicalvisitor::MechanicalGetConstraintJacobianVisitor;
+
 namespace sofa::component::constraint::lagrangian::solver
 {
 
@@ -58,6 +62,87 @@ void clearMultiVecId(sofa::core::objectmodel::BaseContext* ctx, const sofa::core
     ctx->executeVisitor(&clearVisitor);
 }
 
+/// Matrix only recording the rows in which entries are added: used to find the constraints acting on some DOFs
+class ConstraintRowsCollector : public sofa::linearalgebra::BaseMatrix
+{
+public:
+    explicit ConstraintRowsCollector(Index nbRows) : m_nbRows(nbRows) {}
+
+    Index rowSize() const override { return m_nbRows; }
+    Index colSize() const override { return 0; }
+    SReal element(Index /*i*/, Index /*j*/) const override { return 0; }
+    void resize(Index /*nbRow*/, Index /*nbCol*/) override {}
+    void clear() override { m_rows.clear(); }
+    void set(Index i, Index /*j*/, double /*v*/) override { addRow(i); }
+    void add(Index i, Index /*j*/, double /*v*/) override { addRow(i); }
+
+    const sofa::type::vector<Index>& rows() const { return m_rows; }
+
+private:
+    void addRow(Index i)
+    {
+        if (i >= 0 && i < m_nbRows && (m_rows.empty() || m_rows.back() != i))
+        {
+            m_rows.push_back(i);
+        }
+    }
+
+    Index m_nbRows;
+    sofa::type::vector<Index> m_rows;
+};
+
+/// Compliance matrix of an island, indexed by the constraints of the whole problem. The entries between constraints
+/// of the island are stored in the compliance matrix of the island, the other ones are expected to be zero.
+class IslandComplianceMatrix : public sofa::linearalgebra::BaseMatrix
+{
+public:
+    IslandComplianceMatrix(sofa::linearalgebra::BaseMatrix& islandMatrix, Index nbConstraints, int island,
+                           const sofa::type::vector<int>& constraintIslands, const sofa::type::vector<int>& localIndices)
+        : m_islandMatrix(islandMatrix), m_nbConstraints(nbConstraints), m_island(island)
+        , m_constraintIslands(constraintIslands), m_localIndices(localIndices) {}
+
+    Index rowSize() const override { return m_nbConstraints; }
+    Index colSize() const override { return m_nbConstraints; }
+
+    SReal element(Index i, Index j) const override
+    {
+        return isInIsland(i) && isInIsland(j) ? m_islandMatrix.element(m_localIndices[i], m_localIndices[j]) : 0;
+    }
+
+    // the size is the one of the whole problem
+    void resize(Index /*nbRow*/, Index /*nbCol*/) override {}
+    void clear() override { m_islandMatrix.clear(); }
+
+    void set(Index i, Index j, double v) override
+    {
+        if (isInIsland(i) && isInIsland(j))
+            m_islandMatrix.set(m_localIndices[i], m_localIndices[j], v);
+        else if (v != 0)
+            m_hasForeignEntries = true;
+    }
+
+    void add(Index i, Index j, double v) override
+    {
+        if (isInIsland(i) && isInIsland(j))
+            m_islandMatrix.add(m_localIndices[i], m_localIndices[j], v);
+        else if (v != 0)
+            m_hasForeignEntries = true;
+    }
+
+    /// True if a non-zero entry involving a constraint of another island was given
+    bool hasForeignEntries() const { return m_hasForeignEntries; }
+
+private:
+    bool isInIsland(Index i) const { return m_constraintIslands[i] == m_island; }
+
+    sofa::linearalgebra::BaseMatrix& m_islandMatrix;
+    Index m_nbConstraints;
+    int m_island;
+    const sofa::type::vector<int>& m_constraintIslands;
+    const sofa::type::vector<int>& m_localIndices;
+    bool m_hasForeignEntries { false };
+};
+
 }
 
 static constexpr GenericConstraintSolver::ResolutionMethod defaultResolutionMethod("ProjectedGaussSeidel");
@@ -71,7 +156,8 @@ GenericConstraintSolver::GenericConstraintSolver()
     , d_scaleTolerance(initData(&d_scaleTolerance, true, "scaleTolerance", "Scale the error tolerance with the number of constraints"))
     , d_allVerified(initData(&d_allVerified, false, "allVerified", "All constraints must be verified (each constraint's error < tolerance)"))
     , d_newtonIterations(initData(&d_newtonIterations, 100, "newtonIterations", "Maximum iteration number of Newton (for the NonsmoothNonlinearConjugateGradient solver only)"))
-    , d_multithreading(initData(&d_multithreading, false, "multithreading", "Build compliances concurrently"))
+    , d_multithreading(initData(&d_multithreading, false, "multithreading", "Build compliances concurrently, and solve the islands concurrently if islandDecomposition is true"))
+    , d_islandDecomposition(initData(&d_islandDecomposition, false, "islandDecomposition", "Assemble and solve separately the groups of constraints which are not coupled by the compliance matrix, as they act on disjoint DOFs. The compliance matrix of the whole problem is then not assembled (for the ProjectedGaussSeidel and NonsmoothNonlinearConjugateGradient solvers only)"))
     , d_computeGraphs(initData(&d_computeGraphs, false, "computeGraphs", "Compute graphs of errors and forces during resolution"))
     , d_graphErrors(initData(&d_graphErrors, "graphErrors", "Sum of the constraints' errors at each iteration"))
     , d_graphConstraints(initData(&d_graphConstraints, "graphConstraints", "Graph of each constraint's error at the end of the resolution"))
@@ -80,6 +166,7 @@ GenericConstraintSolver::GenericConstraintSolver()
     , d_currentNumConstraints(initData(&d_currentNumConstraints, 0, "currentNumConstraints", "OUTPUT: current number of constraints"))
     , d_currentNumConstraintGroups(initData(&d_currentNumConstraintGroups, 0, "currentNumConstraintGroups", "OUTPUT: current number of constraints"))
     , d_currentIterations(initData(&d_currentIterations, 0, "currentIterations", "OUTPUT: current number of constraint groups"))
+    , d_currentNumIslands(initData(&d_currentNumIslands, 0, "currentNumIslands", "OUTPUT: current number of islands solved separately"))
     , d_currentError(initData(&d_currentError, 0.0_sreal, "currentError", "OUTPUT: current error"))
     , d_reverseAccumulateOrder(initData(&d_reverseAccumulateOrder, false, "reverseAccumulateOrder", "True to accumulate constraints from nodes in reversed order (can be necessary when using multi-mappings or interaction constraints not following the node hierarchy)"))
     , d_constraintForces(initData(&d_constraintForces,"constraintForces","OUTPUT: constraint forces (stored only if computeConstraintForces=True)"))
@@ -109,6 +196,8 @@ GenericConstraintSolver::GenericConstraintSolver()
     d_currentNumConstraintGroups.setGroup("Stats");
     d_currentIterations.setReadOnly(true);
     d_currentIterations.setGroup("Stats");
+    d_currentNumIslands.setReadOnly(true);
+    d_currentNumIslands.setGroup("Stats");
     d_currentError.setReadOnly(true);
     d_currentError.setGroup("Stats");
 
@@ -156,6 +245,12 @@ void GenericConstraintSolver::init()
         simulation::MainTaskSchedulerFactory::createInRegistry()->init();
     }
 
+    if(d_islandDecomposition.getValue())
+    {
+        static constexpr ResolutionMethod UnbuiltGaussSeidel("UnbuiltGaussSeidel");
+        msg_warning_when(d_resolutionMethod.getValue() == UnbuiltGaussSeidel) << "data \"islandDecomposition\" is not taken into account when using the UnbuiltGaussSeidel solver";
+    }
+
     if(d_newtonIterations.isSet())
     {
         static constexpr ResolutionMethod NonsmoothNonlinearConjugateGradient("NonsmoothNonlinearConjugateGradient");
@@ -213,7 +308,17 @@ bool GenericConstraintSolver::buildSystem(const core::ConstraintParams *cParams,
     // suppress the constraints that are on DOFS currently concerned by projective constraint
     applyProjectiveConstraintOnConstraintMatrix(cParams);
 
-    current_cp->clear(numConstraints);
+    // the compliance matrix of the whole problem is not assembled if the islands are solved separately
+    const bool islandDecomposition = canDecomposeIslands();
+    if (islandDecomposition)
+    {
+        current_cp->clearWithoutCompliance(numConstraints);
+    }
+    else
+    {
+        current_cp->clear(numConstraints);
+    }
+    m_solveIslands = false;
 
     getConstraintViolation(cParams, &current_cp->dFree);
 
@@ -230,7 +335,18 @@ bool GenericConstraintSolver::buildSystem(const core::ConstraintParams *cParams,
         case ResolutionMethod("ProjectedGaussSeidel"):
         case ResolutionMethod("NonsmoothNonlinearConjugateGradient"):
         {
-            buildSystem_matrixAssembly(cParams);
+            if (islandDecomposition)
+            {
+                m_solveIslands = computeIslands(cParams) > 1 && buildSystem_islands(cParams);
+                if (!m_solveIslands)
+                {
+                    current_cp->W.resize(numConstraints, numConstraints);
+                }
+            }
+            if (!m_solveIslands)
+            {
+                buildSystem_matrixAssembly(cParams);
+            }
             break;
         }
         case ResolutionMethod("UnbuiltGaussSeidel"):
@@ -453,12 +569,15 @@ bool GenericConstraintSolver::solveSystem(const core::ConstraintParams * /*cPara
             {
                 std::stringstream tmp;
                 tmp << "---> Before Resolution" << msgendl  ;
-                printLCP(tmp, current_cp->getDfree(), current_cp->getW(), current_cp->getF(), current_cp->getDimension(), true);
+                printLCP(tmp, current_cp->getDfree(), current_cp->getW(), current_cp->getF(), current_cp->getDimension(), !m_solveIslands);
 
                 msg_info() << tmp.str() ;
             }
             SCOPED_TIMER_VARNAME(gaussSeidelTimer, "ConstraintsGaussSeidel");
-            current_cp->gaussSeidel(0, this);
+            if (!solveIslands())
+            {
+                current_cp->gaussSeidel(0, this);
+            }
             break;
         }
         case ResolutionMethod("UnbuiltGaussSeidel"): {
@@ -467,7 +586,10 @@ bool GenericConstraintSolver::solveSystem(const core::ConstraintParams * /*cPara
             break;
         }
         case ResolutionMethod("NonsmoothNonlinearConjugateGradient"): {
-            current_cp->NNCG(this, d_newtonIterations.getValue());
+            if (!solveIslands())
+            {
+                current_cp->NNCG(this, d_newtonIterations.getValue());
+            }
             break;
         }
         default:
@@ -479,6 +601,7 @@ bool GenericConstraintSolver::solveSystem(const core::ConstraintParams * /*cPara
     this->d_currentIterations.setValue(current_cp->currentIterations);
     this->d_currentNumConstraints.setValue(current_cp->getNumConstraints());
     this->d_currentNumConstraintGroups.setValue(current_cp->getNumConstraintGroups());
+    this->d_currentNumIslands.setValue(m_solveIslands ? static_cast<int>(m_islandConstraints.size()) : 0);
 
     if(notMuted())
     {
@@ -501,6 +624,269 @@ bool GenericConstraintSolver::solveSystem(const core::ConstraintParams * /*cPara
     return true;
 }
 
+bool GenericConstraintSolver::canDecomposeIslands() const
+{
+    static constexpr ResolutionMethod UnbuiltGaussSeidel("UnbuiltGaussSeidel");
+
+    // the graphs are computed on the whole problem
+    return d_islandDecomposition.getValue() && !d_computeGraphs.getValue()
+        && d_resolutionMethod.getValue() != UnbuiltGaussSeidel;
+}
+
+std::size_t GenericConstraintSolver::computeIslands(const core::ConstraintParams* cParams)
+{
+    SCOPED_TIMER("ComputeIslands");
+
+    const int dimension = current_cp->getDimension();
+
+    m_islandConstraints.clear();
+    m_islandCorrections.clear();
+    m_constraintIslands.clear();
+    m_constraintLocalIndices.clear();
+    m_constraintParents.resize(dimension);
+    std::iota(m_constraintParents.begin(), m_constraintParents.end(), 0);
+
+    // union-find: the root of a group is its first constraint
+    const auto findRoot = [this](int i)
+    {
+        while (m_constraintParents[i] != i)
+        {
+            m_constraintParents[i] = m_constraintParents[m_constraintParents[i]];
+            i = m_constraintParents[i];
+        }
+        return i;
+    };
+    const auto unite = [this, &findRoot](int i, int j)
+    {
+        i = findRoot(i);
+        j = findRoot(j);
+        if (i != j)
+        {
+            m_constraintParents[std::max(i, j)] = std::min(i, j);
+        }
+    };
+
+    // the lines of a constraint resolution are solved together
+    for (int i = 0; i < dimension; )
+    {
+        if (!current_cp->constraintsResolutions[i])
+        {
+            return 0;
+        }
+        const int nbLines = static_cast<int>(current_cp->constraintsResolutions[i]->getNbLines());
+        for (int l = 1; l < nbLines && i + l < dimension; ++l)
+        {
+            unite(i, i + l);
+        }
+        i += nbLines;
+    }
+
+    // the constraints acting on the DOFs of a constraint correction are coupled by its compliance
+    std::vector<std::pair<core::behavior::BaseConstraintCorrection*, int> > correctionConstraints;
+    for (const auto& cc : l_constraintCorrections)
+    {
+        if (!cc || !cc->isActive()) continue;
+
+        ConstraintRowsCollector rows(dimension);
+        MechanicalGetConstraintJacobianVisitor(cParams, &rows).execute(cc->getContext());
+        if (rows.rows().empty()) continue;
+
+        for (const auto row : rows.rows())
+        {
+            unite(rows.rows().front(), row);
+        }
+        correctionConstraints.emplace_back(cc, rows.rows().front());
+    }
+
+    m_constraintIslands.resize(dimension);
+    m_constraintLocalIndices.resize(dimension);
+    for (int i = 0; i < dimension; ++i)
+    {
+        const int root = findRoot(i);
+        if (root == i)
+        {
+            m_constraintIslands[i] = static_cast<int>(m_islandConstraints.size());
+            m_islandConstraints.emplace_back();
+        }
+        else
+        {
+            m_constraintIslands[i] = m_constraintIslands[root];
+        }
+        auto& islandConstraints = m_islandConstraints[m_constraintIslands[i]];
+        m_constraintLocalIndices[i] = static_cast<int>(islandConstraints.size());
+        islandConstraints.push_back(i);
+    }
+
+    m_islandCorrections.resize(m_islandConstraints.size());
+    for (const auto& [cc, constraint] : correctionConstraints)
+    {
+        m_islandCorrections[m_constraintIslands[constraint]].push_back(cc);
+    }
+
+    return m_islandConstraints.size();
+}
+
+bool GenericConstraintSolver::buildSystem_islands(const core::ConstraintParams* cParams)
+{
+    SCOPED_TIMER_VARNAME(getComplianceTimer, "Get Compliance");
+
+    const std::size_t nbIslands = m_islandConstraints.size();
+    const int dimension = current_cp->getDimension();
+
+    while (m_islands.size() < nbIslands)
+    {
+        m_islands.push_back(std::make_unique<GenericConstraintProblem>());
+        m_islands.back()->isIsland = true;
+    }
+
+    sofa::type::vector<char> hasForeignEntries(nbIslands, false);
+
+    const auto buildIsland = [this, cParams, dimension, &hasForeignEntries](const std::size_t islandId)
+    {
+        const sofa::type::vector<int>& constraints = m_islandConstraints[islandId];
+        GenericConstraintProblem& island = *m_islands[islandId];
+        const int islandDimension = static_cast<int>(constraints.size());
+
+        island.clear(islandDimension);
+        for (int a = 0; a < islandDimension; ++a)
+        {
+            const int i = constraints[a];
+            island.dFree[a] = current_cp->dFree[i];
+            // the lines of a resolution are contiguous in the island too
+            island.constraintsResolutions[a] = current_cp->constraintsResolutions[i];
+        }
+
+        IslandComplianceMatrix compliance(island.W, dimension, static_cast<int>(islandId), m_constraintIslands, m_constraintLocalIndices);
+        for (auto* cc : m_islandCorrections[islandId])
+        {
+            cc->addComplianceInConstraintSpace(cParams, &compliance);
+        }
+        hasForeignEntries[islandId] = compliance.hasForeignEntries();
+
+        addRegularization(island.W);
+    };
+
+    const simulation::ForEachExecutionPolicy execution = d_multithreading.getValue() ?
+        simulation::ForEachExecutionPolicy::PARALLEL :
+        simulation::ForEachExecutionPolicy::SEQUENTIAL;
+
+    simulation::TaskScheduler* taskScheduler = simulation::MainTaskSchedulerFactory::createInRegistry();
+    assert(taskScheduler);
+
+    simulation::forEachRange(execution, *taskScheduler, std::size_t{ 0 }, nbIslands,
+        [&buildIsland](const auto& range)
+        {
+            for (auto islandId = range.start; islandId != range.end; ++islandId)
+            {
+                buildIsland(islandId);
+            }
+        });
+
+    if (std::find(hasForeignEntries.begin(), hasForeignEntries.end(), true) != hasForeignEntries.end())
+    {
+        msg_warning() << "A constraint correction couples constraints acting on DOFs it does not own: "
+                         "the constraint problem is solved as a whole";
+        for (std::size_t islandId = 0; islandId < nbIslands; ++islandId)
+        {
+            m_islands[islandId]->freeConstraintResolutions();
+        }
+        return false;
+    }
+
+    return true;
+}
+
+bool GenericConstraintSolver::solveIslands()
+{
+    if (!m_solveIslands)
+    {
+        return false;
+    }
+
+    SCOPED_TIMER("SolveIslands");
+
+    const std::size_t nbIslands = m_islandConstraints.size();
+    const int dimension = current_cp->getDimension();
+
+    // The constraint resolutions are initialized and stored in the order of the constraints of the whole problem,
+    // as some of them share data from a step to another.
+    for (int i = 0; i < dimension; i += current_cp->constraintsResolutions[i]->getNbLines())
+    {
+        GenericConstraintProblem& island = *m_islands[m_constraintIslands[i]];
+        current_cp->constraintsResolutions[i]->init(m_constraintLocalIndices[i], island.getW(), island.getF());
+    }
+
+    static constexpr ResolutionMethod NonsmoothNonlinearConjugateGradient("NonsmoothNonlinearConjugateGradient");
+    const bool useNNCG = d_resolutionMethod.getValue() == NonsmoothNonlinearConjugateGradient;
+    const int newtonIterations = d_newtonIterations.getValue();
+
+    const auto solveIsland = [this, useNNCG, newtonIterations](const std::size_t islandId)
+    {
+        GenericConstraintProblem& island = *m_islands[islandId];
+        island.tolerance = current_cp->tolerance;
+        island.maxIterations = current_cp->maxIterations;
+        island.scaleTolerance = current_cp->scaleTolerance;
+        island.allVerified = current_cp->allVerified;
+        island.sor = current_cp->sor;
+
+        if (useNNCG)
+        {
+            island.NNCG(this, newtonIterations);
+        }
+        else
+        {
+            island.gaussSeidel(0, this);
+        }
+    };
+
+    const simulation::ForEachExecutionPolicy execution = d_multithreading.getValue() ?
+        simulation::ForEachExecutionPolicy::PARALLEL :
+        simulation::ForEachExecutionPolicy::SEQUENTIAL;
+
+    simulation::TaskScheduler* taskScheduler = simulation::MainTaskSchedulerFactory::createInRegistry();
+    assert(taskScheduler);
+
+    simulation::forEachRange(execution, *taskScheduler, std::size_t{ 0 }, nbIslands,
+        [&solveIsland](const auto& range)
+        {
+            for (auto islandId = range.start; islandId != range.end; ++islandId)
+            {
+                solveIsland(islandId);
+            }
+        });
+
+    SReal error = 0;
+    int iterations = 0;
+    for (std::size_t islandId = 0; islandId < nbIslands; ++islandId)
+    {
+        error += m_islands[islandId]->currentError;
+        iterations = std::max(iterations, m_islands[islandId]->currentIterations);
+    }
+    current_cp->currentError = error;
+    current_cp->currentIterations = iterations;
+
+    for (int i = 0; i < dimension; i += current_cp->constraintsResolutions[i]->getNbLines())
+    {
+        GenericConstraintProblem& island = *m_islands[m_constraintIslands[i]];
+        current_cp->constraintsResolutions[i]->store(m_constraintLocalIndices[i], island.getF(), island.hasConverged);
+    }
+
+    for (int i = 0; i < dimension; ++i)
+    {
+        const GenericConstraintProblem& island = *m_islands[m_constraintIslands[i]];
+        current_cp->f[i] = island.f[m_constraintLocalIndices[i]];
+        current_cp->_d[i] = island._d[m_constraintLocalIndices[i]];
+    }
+
+    // the resolutions are only borrowed
+    for (std::size_t islandId = 0; islandId < nbIslands; ++islandId)
+    {
+        m_islands[islandId]->freeConstraintResolutions();
+    }
+
+    return true;
+}
+
 void GenericConstraintSolver::computeResidual(const core::ExecParams* eparam)
 {
     for (const auto& cc : l_constraintCorrections)
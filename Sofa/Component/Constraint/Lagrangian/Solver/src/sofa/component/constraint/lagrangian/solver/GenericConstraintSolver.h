@@ -35,6 +35,8 @@
 #include <sofa/core/objectmodel/lifecycle/RenamedData.h>
 #include <sofa/helper/SelectableItem.h>
 
+#include <memory>
+
 
 namespace sofa::component::constraint::lagrangian::solver
 {
@@ -123,7 +125,8 @@ public:
     Data<bool> d_scaleTolerance; ///< Scale the error tolerance with the number of constraints
     Data<bool> d_allVerified; ///< All constraints must be verified (each constraint's error < tolerance)
     Data<int> d_newtonIterations; ///< Maximum iteration number of Newton (for the NonsmoothNonlinearConjugateGradient solver only)
-    Data<bool> d_multithreading; ///< Build compliances concurrently
+    Data<bool> d_multithreading; ///< Build compliances concurrently, and solve the islands concurrently if islandDecomposition is true
+    Data<bool> d_islandDecomposition; ///< Assemble and solve separately the groups of constraints which are not coupled by the compliance matrix
     Data<bool> d_computeGraphs; ///< Compute graphs of errors and forces during resolution
     Data<std::map < std::string, sofa::type::vector<SReal> > > d_graphErrors; ///< Sum of the constraints' errors at each iteration
     Data<std::map < std::string, sofa::type::vector<SReal> > > d_graphConstraints; ///< Graph of each constraint's error at the end of the resolution
@@ -133,6 +136,7 @@ public:
     Data<int> d_currentNumConstraints; ///< OUTPUT: current number of constraints
     Data<int> d_currentNumConstraintGroups; ///< OUTPUT: current number of constraints
     Data<int> d_currentIterations; ///< OUTPUT: current number of constraint groups
+    Data<int> d_currentNumIslands; ///< OUTPUT: current number of islands solved separately
     Data<SReal> d_currentError; ///< OUTPUT: current error
     Data<bool> d_reverseAccumulateOrder; ///< True to accumulate constraints from nodes in reversed order (can be necessary when using multi-mappings or interaction constraints not following the node hierarchy)
     Data<type::vector< SReal >> d_constraintForces; ///< OUTPUT: constraint forces (stored only if computeConstraintForces=True)
@@ -158,6 +162,32 @@ protected:
     // Explicitly compute the compliance matrix projected in the constraint space
     void buildSystem_matrixAssembly(const core::ConstraintParams *cParams);
 
+    /// Islands of the current constraint problem: groups of constraints which are not coupled by the compliance
+    /// matrix, as they act on disconnected sets of DOFs. Each island is assembled and solved as an independent problem.
+    std::vector<std::unique_ptr<GenericConstraintProblem> > m_islands;
+    sofa::type::vector<sofa::type::vector<int> > m_islandConstraints; ///< constraints of each island, in increasing order
+    sofa::type::vector<sofa::type::vector<core::behavior::BaseConstraintCorrection*> > m_islandCorrections; ///< active constraint corrections of each island
+    sofa::type::vector<int> m_constraintIslands; ///< island of each constraint
+    sofa::type::vector<int> m_constraintLocalIndices; ///< index of each constraint in its island
+    sofa::type::vector<int> m_constraintParents; ///< union-find structure used to group the constraints
+    bool m_solveIslands { false }; ///< true if the islands of the current constraint problem are solved separately
+
+    /// True if the constraint problem is split into islands when islandDecomposition is set
+    bool canDecomposeIslands() const;
+
+    /// Find the islands of the current constraint problem, from the lines of the constraint resolutions and the
+    /// constraint Jacobian of the DOFs of each active constraint correction. Return the number of islands, 0 if the
+    /// constraint resolutions do not cover the problem.
+    std::size_t computeIslands(const core::ConstraintParams* cParams);
+
+    /// Assemble the compliance matrix of each island separately. Return false if a constraint correction couples
+    /// constraints of different islands.
+    bool buildSystem_islands(const core::ConstraintParams* cParams);
+
+    /// Solve each island of the current constraint problem separately, with its assembled compliance matrix.
+    /// Return false if the problem was not solved, because it is not split into several islands.
+    bool solveIslands();
+
 private:
 
     struct ComplianceWrapper
@@ -37,6 +37,10 @@ using sofa::simulation::mechanicalvisitor::MechanicalGetConstraintInfoVisitor;
 #include <sofa/simulation/mechanicalvisitor/MechanicalVOpVisitor.h>
 using sofa::simulation::mechanicalvisitor::MechanicalVOpVisitor;
 
+#include <cstdint>
+#include <istream>
+#include <ostream>
+
 using sofa::core::VecId;
 
 namespace sofa::component::constraint::lagrangian::solver
@@ -748,6 +752,96 @@ void LCPConstraintSolver::keepContactForcesValue()
 }
 
 
+namespace
+{
+template<class T>
+void writeValue(std::ostream& out, const T& value)
+{
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template<class T>
+bool readValue(std::istream& in, T& value)
+{
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+}
+
+void LCPConstraintSolver::writeWarmStart(std::ostream& out) const
+{
+    writeValue(out, static_cast<std::uint64_t>(_previousForces.size()));
+    out.write(reinterpret_cast<const char*>(_previousForces.data()), static_cast<std::streamsize>(_previousForces.size() * sizeof(SReal)));
+
+    // the constraints are identified by their path, as their address differs from a graph to another
+    writeValue(out, static_cast<std::uint64_t>(_previousConstraints.size()));
+    for (const auto& [constraint, buf] : _previousConstraints)
+    {
+        const std::string path = constraint->getPathName();
+        writeValue(out, static_cast<std::uint64_t>(path.size()));
+        out.write(path.data(), static_cast<std::streamsize>(path.size()));
+        writeValue(out, buf.nbLines);
+        writeValue(out, static_cast<std::uint64_t>(buf.persistentToConstraintIdMap.size()));
+        for (const auto& [id, index] : buf.persistentToConstraintIdMap)
+        {
+            writeValue(out, id);
+            writeValue(out, index);
+        }
+    }
+}
+
+bool LCPConstraintSolver::readWarmStart(std::istream& in)
+{
+    _previousForces.clear();
+    _previousConstraints.clear();
+
+    std::uint64_t nbForces = 0;
+    if (!readValue(in, nbForces))
+        return false;
+    _previousForces.resize(nbForces);
+    if (!in.read(reinterpret_cast<char*>(_previousForces.data()), static_cast<std::streamsize>(nbForces * sizeof(SReal))))
+        return false;
+
+    std::map<std::string, core::behavior::BaseConstraint*> constraintsByPath;
+    type::vector<core::behavior::BaseConstraint*> constraints;
+    this->getContext()->getRootContext()->get<core::behavior::BaseConstraint>(&constraints, core::objectmodel::BaseContext::SearchDown);
+    for (auto* constraint : constraints)
+        constraintsByPath.emplace(constraint->getPathName(), constraint);
+
+    std::uint64_t nbConstraints = 0;
+    if (!readValue(in, nbConstraints))
+        return false;
+    std::string path;
+    for (std::uint64_t i = 0; i < nbConstraints; ++i)
+    {
+        std::uint64_t pathSize = 0;
+        if (!readValue(in, pathSize))
+            return false;
+        path.resize(pathSize);
+        if (!in.read(path.data(), static_cast<std::streamsize>(pathSize)))
+            return false;
+
+        ConstraintBlockBuf buf;
+        std::uint64_t nbIds = 0;
+        if (!readValue(in, buf.nbLines) || !readValue(in, nbIds))
+            return false;
+        for (std::uint64_t j = 0; j < nbIds; ++j)
+        {
+            PersistentID id;
+            int index;
+            if (!readValue(in, id) || !readValue(in, index))
+                return false;
+            buf.persistentToConstraintIdMap[id] = index;
+        }
+
+        // the forces of a constraint missing in this graph are not used as initial guess
+        const auto it = constraintsByPath.find(path);
+        if (it != constraintsByPath.end())
+            _previousConstraints[it->second] = std::move(buf);
+    }
+    return true;
+}
+
+
 int LCPConstraintSolver::nlcp_gaussseidel_unbuilt(SReal *dfree, SReal *f, std::vector<SReal>* residuals)
 {
     if(!_numConstraints)
@@ -74,6 +74,10 @@ public:
 
     void draw(const core::visual::VisualParams* vparams) override;
 
+    /// The forces of the previous resolution, used as initial guess, with the persistent ids of their constraints
+    void writeWarmStart(std::ostream& out) const override;
+    bool readWarmStart(std::istream& in) override;
+
     SOFA_ATTRIBUTE_DEPRECATED__RENAME_DATA_IN_CONSTRAINT_LAGRANGIAN_SOLVER()
     sofa::core::objectmodel::lifecycle::RenamedData<bool> displayDebug;
 
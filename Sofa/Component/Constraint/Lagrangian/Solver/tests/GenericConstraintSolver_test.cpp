@@ -0,0 +1,256 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/testing/BaseSimulationTest.h>
+using sofa::testing::BaseSimulationTest;
+
+#include <sofa/simpleapi/SimpleApi.h>
+using namespace sofa::simpleapi;
+
+#include <sofa/component/constraint/lagrangian/solver/GenericConstraintSolver.h>
+using sofa::component::constraint::lagrangian::solver::GenericConstraintSolver;
+
+#include <sofa/component/constraint/lagrangian/correction/UncoupledConstraintCorrection.h>
+#include <sofa/component/statecontainer/MechanicalObject.h>
+#include <sofa/core/behavior/Constraint.h>
+#include <sofa/core/behavior/ConstraintResolution.h>
+#include <sofa/core/ConstraintParams.h>
+#include <sofa/simulation/Node.h>
+#include <sofa/simulation/Simulation.h>
+#include <sofa/testing/ScopedTaskScheduler.h>
+
+namespace
+{
+
+using sofa::defaulttype::Vec1Types;
+
+/// Unilateral constraint on one line: the force is positive, and the violation is zero if the force is not
+struct UnilateralResolution : public sofa::core::behavior::ConstraintResolution
+{
+    UnilateralResolution() : sofa::core::behavior::ConstraintResolution(1) {}
+
+    void resolution(int line, SReal** w, SReal* d, SReal* force, SReal* /*dfree*/) override
+    {
+        force[line] -= d[line] / w[line][line];
+        if (force[line] < 0)
+            force[line] = 0;
+    }
+};
+
+/// Unilateral constraints on the DOFs of a state: each constraint line sums some DOFs, with a given free violation
+class UnilateralDofsConstraint : public sofa::core::behavior::Constraint<Vec1Types>
+{
+public:
+    SOFA_CLASS(UnilateralDofsConstraint, SOFA_TEMPLATE(sofa::core::behavior::Constraint, Vec1Types));
+
+    std::vector<std::vector<sofa::Index> > lineDofs;
+    std::vector<SReal> lineViolations;
+
+    void buildConstraintMatrix(const sofa::core::ConstraintParams* /*cParams*/, DataMatrixDeriv& c, unsigned int& cIndex, const DataVecCoord& /*x*/) override
+    {
+        auto matrix = sofa::helper::getWriteAccessor(c);
+        d_constraintIndex.setValue(cIndex);
+        for (const auto& dofs : lineDofs)
+        {
+            auto row = matrix->writeLine(cIndex++);
+            for (const auto dof : dofs)
+            {
+                row.addCol(dof, Deriv(1));
+            }
+        }
+    }
+
+    void getConstraintViolation(const sofa::core::ConstraintParams* /*cParams*/, sofa::linearalgebra::BaseVector* resV, const DataVecCoord& /*x*/, const DataVecDeriv& /*v*/) override
+    {
+        for (std::size_t l = 0; l < lineViolations.size(); ++l)
+        {
+            resV->set(d_constraintIndex.getValue() + l, lineViolations[l]);
+        }
+    }
+
+    void getConstraintResolution(const sofa::core::ConstraintParams* /*cParams*/, std::vector<sofa::core::behavior::ConstraintResolution*>& resTab, unsigned int& offset) override
+    {
+        for (std::size_t l = 0; l < lineDofs.size(); ++l)
+        {
+            resTab[offset++] = new UnilateralResolution;
+        }
+    }
+};
+
+/// Constraint problem made of two groups of DOFs, each one with its own constraint correction: the constraints on
+/// the first group are coupled by the compliance, as are the ones on the second group, but not the ones of different groups
+class IslandsScene
+{
+public:
+    sofa::simulation::Node::SPtr root;
+    GenericConstraintSolver::SPtr solver;
+
+    IslandsScene()
+    {
+        root = sofa::simulation::getSimulation()->createNewNode("root");
+        solver = sofa::core::objectmodel::New<GenericConstraintSolver>();
+        solver->d_tolerance.setValue(1e-12);
+        solver->d_maxIt.setValue(10000);
+        solver->d_computeConstraintForces.setValue(true);
+        root->addObject(solver);
+
+        addGroup("group0", {1.0, 2.0, 0.5}, {{0}, {0, 1}, {1, 2}}, {-1.0, 0.5, -2.0});
+        addGroup("group1", {3.0, 1.0}, {{0}, {0, 1}}, {-2.0, -1.0});
+
+        sofa::simulation::node::initRoot(root.get());
+    }
+
+    ~IslandsScene()
+    {
+        sofa::simulation::node::unload(root);
+    }
+
+    std::vector<SReal> solve(bool islandDecomposition, bool multithreading)
+    {
+        solver->d_islandDecomposition.setValue(islandDecomposition);
+        solver->d_multithreading.setValue(multithreading);
+
+        sofa::core::ConstraintParams cParams;
+        solver->buildSystem(&cParams, sofa::core::MultiVecId::null());
+        solver->solveSystem(&cParams, sofa::core::MultiVecId::null());
+
+        const auto& forces = solver->d_constraintForces.getValue();
+        return std::vector<SReal>(forces.begin(), forces.end());
+    }
+
+private:
+    void addGroup(const std::string& name, const std::vector<SReal>& compliance,
+                  const std::vector<std::vector<sofa::Index> >& lineDofs, const std::vector<SReal>& lineViolations)
+    {
+        const auto node = root->createChild(name);
+
+        const auto dofs = sofa::core::objectmodel::New<sofa::component::statecontainer::MechanicalObject<Vec1Types> >();
+        dofs->resize(compliance.size());
+        node->addObject(dofs);
+
+        const auto correction = sofa::core::objectmodel::New<sofa::component::constraint::lagrangian::correction::UncoupledConstraintCorrection<Vec1Types> >();
+        correction->d_compliance.setValue(sofa::type::vector<SReal>(compliance.begin(), compliance.end()));
+        correction->d_useOdeSolverIntegrationFactors.setValue(false);
+        node->addObject(correction);
+
+        const auto constraint = sofa::core::objectmodel::New<UnilateralDofsConstraint>();
+        constraint->lineDofs = lineDofs;
+        constraint->lineViolations = lineViolations;
+        node->addObject(constraint);
+    }
+};
+
+/** Test the UncoupledConstraintCorrection class
+*/
+struct GenericConstraintSolver_test : BaseSimulationTest
+{
+    void doSetUp() override
+    {
+        sofa::simpleapi::importPlugin("Sofa.Component");
+        sofa::simpleapi::importPlugin("Sofa.Component.Collision.Geometry");
+        sofa::simpleapi::importPlugin("Sofa.Component.Collision.Detection.Intersection");
+        sofa::simpleapi::importPlugin("Sofa.Component.Collision.Response.Contact");
+    }
+
+    void enableConstraintForce()
+    {
+        SceneInstance sceneinstance("xml",
+                    "<Node>\n"
+                    "   <RequiredPlugin name='Sofa.Component'/>"
+                    "   <RequiredPlugin name='Sofa.Component.Collision.Geometry'/>"
+                    "   <RequiredPlugin name='Sofa.Component.Collision.Detection.Intersection'/>"
+                    "   <RequiredPlugin name='Sofa.Component.Collision.Response.Contact'/>"
+                    "   <FreeMotionAnimationLoop />\n"
+                    "   <GenericConstraintSolver name='solver' constraintForces='-1 -1 -1' computeConstraintForces='True' maxIt='1000' tolerance='0.001' />\n"
+                    "   <Node name='collision'>\n"
+                    "         <MechanicalObject />\n"
+                    "         <UncoupledConstraintCorrection useOdeSolverIntegrationFactors='0' />\n"
+                    "   </Node>\n"
+                    "</Node>\n"
+                    );
+
+        sceneinstance.initScene();
+        sceneinstance.simulate(0.01);
+        auto solver = sceneinstance.root->getObject("solver");
+        ASSERT_NE(solver, nullptr);
+        ASSERT_STREQ(solver->findData("constraintForces")->getValueString().c_str(), "");
+    }
+
+    void islandDecomposition(const std::string& resolutionMethod)
+    {
+        IslandsScene scene;
+        scene.solver->d_resolutionMethod.setValue(GenericConstraintSolver::ResolutionMethod(resolutionMethod));
+
+        const auto globalForces = scene.solve(false, false);
+        EXPECT_EQ(scene.solver->d_currentNumIslands.getValue(), 0);
+        ASSERT_EQ(globalForces.size(), 5);
+
+        const auto islandForces = scene.solve(true, false);
+        EXPECT_EQ(scene.solver->d_currentNumIslands.getValue(), 2);
+        ASSERT_EQ(islandForces.size(), 5);
+
+        std::vector<SReal> parallelIslandForces;
+        {
+            sofa::testing::ScopedTaskScheduler taskScheduler(2);
+            parallelIslandForces = scene.solve(true, true);
+            EXPECT_EQ(scene.solver->d_currentNumIslands.getValue(), 2);
+        }
+        ASSERT_EQ(parallelIslandForces.size(), 5);
+
+        for (std::size_t i = 0; i < globalForces.size(); ++i)
+        {
+            EXPECT_NEAR(islandForces[i], globalForces[i], 1e-9) << "constraint " << i;
+            EXPECT_EQ(parallelIslandForces[i], islandForces[i]) << "constraint " << i;
+        }
+
+        // the islands are not solved separately when the graphs are computed on the whole problem
+        scene.solver->d_computeGraphs.setValue(true);
+        scene.solve(true, false);
+        EXPECT_EQ(scene.solver->d_currentNumIslands.getValue(), 0);
+    }
+};
+
+/// run the tests
+TEST_F(GenericConstraintSolver_test, checkConstraintForce)
+{
+    EXPECT_MSG_NOEMIT(Error);
+    enableConstraintForce();
+}
+
+TEST_F(GenericConstraintSolver_test, islandDecompositionProjectedGaussSeidel)
+{
+    islandDecomposition("ProjectedGaussSeidel");
+}
+
+TEST_F(GenericConstraintSolver_test, islandDecompositionNonsmoothNonlinearConjugateGradient)
+{
+    islandDecomposition("NonsmoothNonlinearConjugateGradient");
+}
+
+
+} /// namespace sofa
+
+
+
+
+
+
+
@@ -0,0 +1,408 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/component/controller/SleepManager.h>
+
+#include <sofa/core/ObjectFactory.h>
+#include <sofa/core/behavior/BaseForceField.h>
+#include <sofa/core/behavior/BaseInteractionConstraint.h>
+#include <sofa/core/behavior/BaseInteractionForceField.h>
+#include <sofa/core/behavior/BaseMechanicalState.h>
+#include <sofa/simulation/CollisionEndEvent.h>
+#include <sofa/simulation/Node.h>
+#include <algorithm>
+
+
+namespace sofa::component::controller
+{
+
+void registerSleepManager(sofa::core::ObjectFactory* factory)
+{
+    factory->registerObjects(core::ObjectRegistrationData("Puts the quiescent subtrees to sleep and wakes them up when they are disturbed.")
+        .add< SleepManager >());
+}
+
+SleepManager::SleepManager()
+    : d_velocityThreshold(initData(&d_velocityThreshold, 1e-3_sreal, "velocityThreshold", "Velocity under which a body is at rest"))
+    , d_nbQuietSteps(initData(&d_nbQuietSteps, 10u, "nbQuietSteps", "Number of consecutive steps at rest before a subtree falls asleep"))
+    , d_nbSleepingNodes(initData(&d_nbSleepingNodes, 0u, "nbSleepingNodes", "Number of managed subtrees currently sleeping"))
+{
+    d_nbSleepingNodes.setReadOnly(true);
+    this->f_listening.setValue(true);
+}
+
+SleepManager::~SleepManager()
+{
+    stopListening();
+}
+
+void SleepManager::init()
+{
+    Controller::init();
+
+    stopListening();
+    m_managedNodes.clear();
+    m_managedNodeIds.clear();
+    m_nbSleepingNodes = 0;
+    m_interactionsOutdated = true;
+
+    if (auto* root = dynamic_cast<simulation::Node*>(getContext()->getRootContext()))
+    {
+        collectManagedNodes(root);
+        root->addListener(&m_graphListener);
+        m_listenedRoot = root;
+    }
+
+    for (std::size_t i = 0; i < m_managedNodes.size(); ++i)
+    {
+        if (m_managedNodes[i].node->isSleeping())
+        {
+            watchInputs(i);
+            ++m_nbSleepingNodes;
+        }
+    }
+    d_nbSleepingNodes.setValue(static_cast<unsigned int>(m_nbSleepingNodes));
+
+    msg_warning_when(m_managedNodes.empty()) << "No node can change its sleeping state: set canChangeSleepingState "
+                                                "on the nodes of the bodies which are allowed to sleep.";
+
+    d_componentState.setValue(core::objectmodel::ComponentState::Valid);
+}
+
+void SleepManager::cleanup()
+{
+    stopListening();
+    Controller::cleanup();
+}
+
+void SleepManager::stopListening()
+{
+    if (m_listenedRoot != nullptr)
+    {
+        m_listenedRoot->removeListener(&m_graphListener);
+        m_listenedRoot = nullptr;
+    }
+}
+
+void SleepManager::GraphListener::onEndAddChild(simulation::Node*, simulation::Node*)
+{
+    m_sleepManager->m_interactionsOutdated = true;
+}
+
+void SleepManager::GraphListener::onEndRemoveChild(simulation::Node*, simulation::Node*)
+{
+    m_sleepManager->m_interactionsOutdated = true;
+}
+
+void SleepManager::GraphListener::onEndAddObject(simulation::Node*, core::objectmodel::BaseObject* object)
+{
+    if (dynamic_cast<core::behavior::BaseInteractionForceField*>(object) || dynamic_cast<core::behavior::BaseInteractionConstraint*>(object))
+    {
+        m_sleepManager->m_interactionsOutdated = true;
+    }
+}
+
+void SleepManager::GraphListener::onEndRemoveObject(simulation::Node*, core::objectmodel::BaseObject* object)
+{
+    if (dynamic_cast<core::behavior::BaseInteractionForceField*>(object) || dynamic_cast<core::behavior::BaseInteractionConstraint*>(object))
+    {
+        m_sleepManager->m_interactionsOutdated = true;
+    }
+}
+
+void SleepManager::collectManagedNodes(simulation::Node* node)
+{
+    if (m_managedNodeIds.find(node) != m_managedNodeIds.end())
+    {
+        return; // already in a managed subtree
+    }
+
+    if (node->canChangeSleepingState())
+    {
+        ManagedNode managedNode;
+        managedNode.node = node;
+        m_managedNodes.push_back(std::move(managedNode));
+        collectSubtree(node, m_managedNodes.size() - 1);
+        return;
+    }
+
+    for (const auto& child : node->child)
+    {
+        collectManagedNodes(child.get());
+    }
+}
+
+void SleepManager::collectSubtree(simulation::Node* node, std::size_t managedNodeId)
+{
+    if (!m_managedNodeIds.emplace(node, managedNodeId).second)
+    {
+        return; // already visited through another parent
+    }
+
+    ManagedNode& managedNode = m_managedNodes[managedNodeId];
+    if (core::behavior::BaseMechanicalState* state = node->mechanicalState)
+    {
+        managedNode.states.push_back(state);
+        if (node->mechanicalMapping == nullptr)
+        {
+            managedNode.independentStates.push_back(state);
+        }
+    }
+    for (core::behavior::BaseForceField* forceField : node->forceField)
+    {
+        managedNode.forceFields.push_back(forceField);
+    }
+
+    for (const auto& child : node->child)
+    {
+        collectSubtree(child.get(), managedNodeId);
+    }
+}
+
+SleepManager::ManagedNode* SleepManager::getManagedNode(const core::objectmodel::BaseContext* context)
+{
+    // the nodes created in a managed subtree after the initialization, such as the nodes of the contacts, are found
+    // from their parents
+    auto* node = dynamic_cast<const simulation::Node*>(context);
+    while (node != nullptr)
+    {
+        const auto it = m_managedNodeIds.find(node);
+        if (it != m_managedNodeIds.end())
+        {
+            return &m_managedNodes[it->second];
+        }
+        node = dynamic_cast<const simulation::Node*>(node->getFirstParent());
+    }
+    return nullptr;
+}
+
+void SleepManager::handleEvent(core::objectmodel::Event* event)
+{
+    Controller::handleEvent(event);
+
+    if (simulation::CollisionEndEvent::checkEventType(event))
+    {
+        wakeUpDisturbedNodes();
+        m_checkedAfterCollision = true;
+    }
+}
+
+void SleepManager::onBeginAnimationStep(const double /*dt*/)
+{
+    // before the collision detection, so that the subtrees woken up keep their contacts with the static bodies
+    m_checkedAfterCollision = false;
+    wakeUpDisturbedNodes();
+}
+
+void SleepManager::onEndAnimationStep(const double /*dt*/)
+{
+    // the animation loop may not send the collision events
+    if (!m_checkedAfterCollision)
+    {
+        wakeUpDisturbedNodes();
+    }
+
+    const SReal threshold = d_velocityThreshold.getValue();
+    const unsigned int nbQuietSteps = d_nbQuietSteps.getValue();
+
+    for (ManagedNode& managedNode : m_managedNodes)
+    {
+        if (managedNode.node->isSleeping())
+        {
+            continue;
+        }
+
+        managedNode.maxVelocity = 0;
+        for (core::behavior::BaseMechanicalState* state : managedNode.independentStates)
+        {
+            managedNode.maxVelocity = std::max(managedNode.maxVelocity,
+                state->vMax(core::execparams::defaultInstance(), core::vec_id::read_access::velocity));
+        }
+
+        if (managedNode.maxVelocity > threshold)
+        {
+            managedNode.nbQuietSteps = 0;
+        }
+        else if (++managedNode.nbQuietSteps >= nbQuietSteps)
+        {
+            fallAsleep(managedNode);
+        }
+    }
+
+    d_nbSleepingNodes.setValue(static_cast<unsigned int>(m_nbSleepingNodes));
+}
+
+bool SleepManager::wakeUp(simulation::Node* node)
+{
+    ManagedNode* managedNode = getManagedNode(node);
+    if (managedNode == nullptr)
+    {
+        return false;
+    }
+
+    if (managedNode->node->isSleeping())
+    {
+        wakeUp(*managedNode);
+        d_nbSleepingNodes.setValue(static_cast<unsigned int>(m_nbSleepingNodes));
+    }
+    return true;
+}
+
+void SleepManager::wakeUpDisturbedNodes()
+{
+    if (m_nbSleepingNodes == 0)
+    {
+        return;
+    }
+
+    // modified inputs
+    for (ManagedNode& managedNode : m_managedNodes)
+    {
+        if (managedNode.node->isSleeping() && managedNode.inputModified)
+        {
+            wakeUp(managedNode);
+        }
+    }
+
+    // interactions with moving bodies
+    updateInteractions();
+    for (core::behavior::BaseInteractionForceField* forceField : m_interactionForceFields)
+    {
+        wakeUpInteraction(forceField->getMechModel1(), forceField->getMechModel2());
+    }
+    for (core::behavior::BaseInteractionConstraint* constraint : m_interactionConstraints)
+    {
+        wakeUpInteraction(constraint->getMechModel1(), constraint->getMechModel2());
+    }
+
+    d_nbSleepingNodes.setValue(static_cast<unsigned int>(m_nbSleepingNodes));
+}
+
+void SleepManager::updateInteractions()
+{
+    if (!m_interactionsOutdated)
+    {
+        return;
+    }
+
+    core::objectmodel::BaseContext* root = getContext()->getRootContext();
+    m_interactionForceFields.clear();
+    root->getObjects(m_interactionForceFields, core::objectmodel::BaseContext::SearchDown);
+    m_interactionConstraints.clear();
+    root->getObjects(m_interactionConstraints, core::objectmodel::BaseContext::SearchDown);
+    m_interactionsOutdated = false;
+}
+
+void SleepManager::wakeUpInteraction(core::behavior::BaseMechanicalState* state1, core::behavior::BaseMechanicalState* state2)
+{
+    if (state1 == nullptr || state2 == nullptr)
+    {
+        return;
+    }
+
+    ManagedNode* managedNode1 = getManagedNode(state1->getContext());
+    ManagedNode* managedNode2 = getManagedNode(state2->getContext());
+    if (managedNode1 == managedNode2)
+    {
+        return; // interaction inside a subtree
+    }
+
+    if (managedNode1 != nullptr && managedNode1->node->isSleeping() && isMoving(state2))
+    {
+        wakeUp(*managedNode1);
+    }
+    else if (managedNode2 != nullptr && managedNode2->node->isSleeping() && isMoving(state1))
+    {
+        wakeUp(*managedNode2);
+    }
+}
+
+bool SleepManager::isMoving(core::behavior::BaseMechanicalState* state)
+{
+    if (const ManagedNode* managedNode = getManagedNode(state->getContext()))
+    {
+        return !managedNode->node->isSleeping() && managedNode->maxVelocity > d_velocityThreshold.getValue();
+    }
+
+    if (state->getContext()->isSleeping())
+    {
+        return false;
+    }
+
+    return state->vMax(core::execparams::defaultInstance(), core::vec_id::read_access::velocity) > d_velocityThreshold.getValue();
+}
+
+void SleepManager::fallAsleep(ManagedNode& managedNode)
+{
+    for (core::behavior::BaseMechanicalState* state : managedNode.states)
+    {
+        state->vOp(core::execparams::defaultInstance(), core::vec_id::write_access::velocity); // v = 0
+    }
+
+    managedNode.maxVelocity = 0;
+    managedNode.nbQuietSteps = 0;
+    watchInputs(static_cast<std::size_t>(&managedNode - m_managedNodes.data()));
+    managedNode.node->setSleeping(true);
+    ++m_nbSleepingNodes;
+
+    msg_info() << "Node " << managedNode.node->getPathName() << " falls asleep";
+}
+
+void SleepManager::wakeUp(ManagedNode& managedNode)
+{
+    managedNode.node->setSleeping(false);
+    managedNode.nbQuietSteps = 0;
+    managedNode.inputCallback.reset();
+    --m_nbSleepingNodes;
+
+    msg_info() << "Node " << managedNode.node->getPathName() << " wakes up";
+}
+
+void SleepManager::watchInputs(std::size_t managedNodeId)
+{
+    ManagedNode& managedNode = m_managedNodes[managedNodeId];
+    managedNode.inputModified = false;
+    managedNode.inputCallback = std::make_unique<core::objectmodel::DataCallback>();
+
+    for (core::behavior::BaseForceField* forceField : managedNode.forceFields)
+    {
+        for (core::objectmodel::BaseData* data : forceField->getDataFields())
+        {
+            if (!data->isReadOnly())
+            {
+                managedNode.inputCallback->addInput(data);
+            }
+        }
+    }
+    for (core::behavior::BaseMechanicalState* state : managedNode.independentStates)
+    {
+        managedNode.inputCallback->addInput(state->baseWrite(core::vec_id::write_access::position));
+        managedNode.inputCallback->addInput(state->baseWrite(core::vec_id::write_access::velocity));
+    }
+
+    // the subtrees are stored by value, they are found again from their index
+    managedNode.inputCallback->addCallback([this, managedNodeId]()
+    {
+        m_managedNodes[managedNodeId].inputModified = true;
+    });
+}
+
+} // namespace sofa::component::controller
@@ -0,0 +1,170 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+#include <sofa/component/controller/config.h>
+
+#include <sofa/component/controller/Controller.h>
+#include <sofa/core/objectmodel/DataCallback.h>
+#include <sofa/simulation/MutationListener.h>
+#include <sofa/type/vector.h>
+#include <memory>
+#include <unordered_map>
+
+namespace sofa::core::behavior
+{
+    class BaseMechanicalState;
+    class BaseForceField;
+    class BaseInteractionForceField;
+    class BaseInteractionConstraint;
+}
+
+namespace sofa::simulation
+{
+    class Node;
+}
+
+namespace sofa::component::controller
+{
+
+/**
+ * @brief Put the quiescent subtrees of the scene to sleep, and wake them up when they are disturbed.
+ *
+ * The subtrees managed are the nodes whose Data canChangeSleepingState is true (a managed node inside another one
+ * is part of the outer subtree). A subtree falls asleep when the velocities of its independent mechanical states
+ * stay below velocityThreshold during nbQuietSteps steps. Its velocities are then set to zero and its node is set
+ * sleeping: the mechanical visitors, the solvers and the collision detection between sleeping bodies skip it.
+ *
+ * A sleeping subtree is woken up when:
+ * - it is linked to a moving body by an interaction force field or an interaction constraint, which includes the
+ *   responses of the contacts,
+ * - an input Data of one of its force fields, or the positions or velocities of one of its independent states,
+ *   are modified.
+ * A body is moving if its velocity is above velocityThreshold. These conditions are checked at the beginning of the
+ * step, before the collision detection, and again after it (or at the end of the step if the animation loop does not
+ * send the collision events), so that a subtree woken up by a new contact is solved in the same step. The collision
+ * pipeline then also detects the contacts of this subtree with the static bodies.
+ *
+ * The cost of a sleeping subtree does not depend on its size: the modifications of its inputs are notified through
+ * Data callbacks, and the interactions of the scene are gathered again only when the graph changes.
+ */
+class SOFA_COMPONENT_CONTROLLER_API SleepManager : public Controller
+{
+public:
+    SOFA_CLASS(SleepManager, Controller);
+
+    Data<SReal> d_velocityThreshold; ///< Velocity under which a body is at rest
+    Data<unsigned int> d_nbQuietSteps; ///< Number of consecutive steps at rest before a subtree falls asleep
+    Data<unsigned int> d_nbSleepingNodes; ///< Number of managed subtrees currently sleeping
+
+    ~SleepManager() override;
+
+    void init() override;
+
+    void cleanup() override;
+
+    void handleEvent(core::objectmodel::Event* event) override;
+
+    void onBeginAnimationStep(const double dt) override;
+
+    void onEndAnimationStep(const double dt) override;
+
+    /// Wake up the managed subtree containing the node. Return false if the node is not in a managed subtree.
+    bool wakeUp(simulation::Node* node);
+
+protected:
+    SleepManager();
+
+    /// A subtree which can fall asleep
+    struct ManagedNode
+    {
+        simulation::Node* node { nullptr };
+        type::vector<core::behavior::BaseMechanicalState*> states; ///< all the mechanical states of the subtree
+        type::vector<core::behavior::BaseMechanicalState*> independentStates; ///< the states which are not mapped
+        type::vector<core::behavior::BaseForceField*> forceFields;
+        unsigned int nbQuietSteps { 0 };
+        SReal maxVelocity { 0 }; ///< maximum velocity of the independent states at the end of the last awake step
+        /// Connected to the inputs of the subtree while it sleeps, it records that one of them was modified
+        std::unique_ptr<core::objectmodel::DataCallback> inputCallback;
+        bool inputModified { false };
+    };
+
+    /// Mark the gathered interactions as outdated when the graph changes, e.g. when the contact manager adds or
+    /// removes the responses of the contacts
+    class GraphListener : public simulation::MutationListener
+    {
+    public:
+        explicit GraphListener(SleepManager* sleepManager) : m_sleepManager(sleepManager) {}
+
+        void onEndAddChild(simulation::Node* parent, simulation::Node* child) override;
+        void onEndRemoveChild(simulation::Node* parent, simulation::Node* child) override;
+        void onEndAddObject(simulation::Node* parent, core::objectmodel::BaseObject* object) override;
+        void onEndRemoveObject(simulation::Node* parent, core::objectmodel::BaseObject* object) override;
+
+    private:
+        SleepManager* m_sleepManager;
+    };
+
+    type::vector<ManagedNode> m_managedNodes;
+
+    /// Index in m_managedNodes of the subtree containing each node, when the subtrees were collected
+    std::unordered_map<const core::objectmodel::BaseContext*, std::size_t> m_managedNodeIds;
+
+    std::size_t m_nbSleepingNodes { 0 };
+
+    /// Interactions of the scene, gathered again at the first check following a change of the graph
+    type::vector<core::behavior::BaseInteractionForceField*> m_interactionForceFields;
+    type::vector<core::behavior::BaseInteractionConstraint*> m_interactionConstraints;
+    bool m_interactionsOutdated { true };
+
+    GraphListener m_graphListener { this };
+    simulation::Node* m_listenedRoot { nullptr };
+
+    /// The disturbed subtrees were already checked after the collision detection in the current step
+    bool m_checkedAfterCollision { false };
+
+    void collectManagedNodes(simulation::Node* node);
+    void collectSubtree(simulation::Node* node, std::size_t managedNodeId);
+
+    ManagedNode* getManagedNode(const core::objectmodel::BaseContext* context);
+
+    void stopListening();
+
+    /// Wake up the sleeping subtrees which are disturbed
+    void wakeUpDisturbedNodes();
+
+    /// Gather the interactions of the scene if the graph changed since they were last gathered
+    void updateInteractions();
+
+    /// Wake up the subtree of one state of an interaction if the other state is moving
+    void wakeUpInteraction(core::behavior::BaseMechanicalState* state1, core::behavior::BaseMechanicalState* state2);
+
+    bool isMoving(core::behavior::BaseMechanicalState* state);
+
+    void fallAsleep(ManagedNode& managedNode);
+    void wakeUp(ManagedNode& managedNode);
+
+    /// Connect a callback to the input Data of the force fields and to the positions and velocities of the
+    /// independent states of a sleeping subtree
+    void watchInputs(std::size_t managedNodeId);
+};
+
+} // namespace sofa::component::controller
@@ -27,6 +27,7 @@ namespace sofa::component::controller
 {
 
 extern void registerMechanicalStateController(sofa::core::ObjectFactory* factory);
+extern void registerSleepManager(sofa::core::ObjectFactory* factory);
 
 extern "C" {
     SOFA_EXPORT_DYNAMIC_LIBRARY void initExternalModule();
@@ -53,6 +54,7 @@ const char* getModuleVersion()
 void registerObjects(sofa::core::ObjectFactory* factory)
 {
     registerMechanicalStateController(factory);
+    registerSleepManager(factory);
 }
 
 void init()
@@ -0,0 +1,359 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/testing/BaseSimulationTest.h>
+using sofa::testing::BaseSimulationTest;
+
+#include <sofa/component/controller/SleepManager.h>
+#include <sofa/core/behavior/MechanicalState.h>
+#include <sofa/core/collision/ContactManager.h>
+#include <sofa/defaulttype/VecTypes.h>
+#include <sofa/simulation/Node.h>
+#include <sofa/simulation/Simulation.h>
+#include <sofa/simpleapi/SimpleApi.h>
+
+namespace
+{
+
+using namespace sofa;
+using sofa::component::controller::SleepManager;
+
+/// Two spheres without solver: their velocities are only modified by the test and by the SleepManager.
+/// The first sphere can sleep, the second one can sleep only if requested.
+struct SleepManager_test : public BaseSimulationTest
+{
+    using MechanicalState = core::behavior::MechanicalState<defaulttype::Vec3Types>;
+
+    simulation::Node::SPtr m_root;
+    simulation::Node::SPtr m_body0;
+    simulation::Node::SPtr m_body1;
+    SleepManager* m_sleepManager { nullptr };
+    core::collision::ContactManager* m_contactManager { nullptr };
+
+    void createScene(bool canBody1Sleep)
+    {
+        this->loadPlugins({
+            Sofa.Component.StateContainer,
+            Sofa.Component.Controller,
+            Sofa.Component.Collision.Geometry,
+            Sofa.Component.Collision.Detection.Algorithm,
+            Sofa.Component.Collision.Detection.Intersection,
+            Sofa.Component.Collision.Response.Contact
+        });
+
+        m_root = simulation::getSimulation()->createNewGraph("root");
+        simpleapi::createObject(m_root, "DefaultAnimationLoop");
+        simpleapi::createObject(m_root, "SleepManager", {{"name", "sleepManager"}, {"velocityThreshold", "0.01"}, {"nbQuietSteps", "3"}});
+        simpleapi::createObject(m_root, "CollisionPipeline");
+        simpleapi::createObject(m_root, "BruteForceBroadPhase");
+        simpleapi::createObject(m_root, "BVHNarrowPhase");
+        simpleapi::createObject(m_root, "MinProximityIntersection", {{"alarmDistance", "0.3"}, {"contactDistance", "0.1"}});
+        simpleapi::createObject(m_root, "CollisionResponse", {{"name", "response"}, {"response", "PenalityContactForceField"}});
+
+        m_body0 = simpleapi::createChild(m_root, "body0", {{"canChangeSleepingState", "true"}});
+        simpleapi::createObject(m_body0, "MechanicalObject", {{"position", "0 0 0"}});
+        simpleapi::createObject(m_body0, "SphereCollisionModel", {{"radius", "0.5"}});
+
+        m_body1 = simpleapi::createChild(m_root, "body1", {{"canChangeSleepingState", canBody1Sleep ? "true" : "false"}});
+        simpleapi::createObject(m_body1, "MechanicalObject", {{"position", "3 0 0"}});
+        simpleapi::createObject(m_body1, "SphereCollisionModel", {{"radius", "0.5"}});
+
+        sofa::simulation::node::initRoot(m_root.get());
+
+        m_sleepManager = dynamic_cast<SleepManager*>(m_root->getObject("sleepManager"));
+        ASSERT_NE(m_sleepManager, nullptr);
+        m_contactManager = dynamic_cast<core::collision::ContactManager*>(m_root->getObject("response"));
+        ASSERT_NE(m_contactManager, nullptr);
+    }
+
+    void doTearDown() override
+    {
+        sofa::simulation::node::unload(m_root);
+    }
+
+    static MechanicalState* getState(const simulation::Node::SPtr& node)
+    {
+        return dynamic_cast<MechanicalState*>(node->getMechanicalState());
+    }
+
+    static void setPosition(const simulation::Node::SPtr& node, SReal x)
+    {
+        auto positions = sofa::helper::getWriteAccessor(*getState(node)->write(core::vec_id::write_access::position));
+        positions[0] = { x, 0, 0 };
+    }
+
+    static void setVelocity(const simulation::Node::SPtr& node, SReal v)
+    {
+        auto velocities = sofa::helper::getWriteAccessor(*getState(node)->write(core::vec_id::write_access::velocity));
+        velocities[0] = { v, 0, 0 };
+    }
+
+    void step()
+    {
+        sofa::simulation::node::animate(m_root.get(), 0.01_sreal);
+    }
+};
+
+TEST_F(SleepManager_test, quietBodyFallsAsleep)
+{
+    createScene(false);
+    setVelocity(m_body1, 1);
+
+    step();
+    step();
+    EXPECT_FALSE(m_body0->isSleeping());
+
+    step();
+    EXPECT_TRUE(m_body0->isSleeping());
+    EXPECT_EQ(m_sleepManager->d_nbSleepingNodes.getValue(), 1);
+
+    // a body which cannot sleep stays awake
+    EXPECT_FALSE(m_body1->isSleeping());
+}
+
+TEST_F(SleepManager_test, modifiedVelocityWakesUp)
+{
+    createScene(false);
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+        step();
+    }
+    ASSERT_TRUE(m_body0->isSleeping());
+
+    step();
+    EXPECT_TRUE(m_body0->isSleeping());
+
+    setVelocity(m_body0, 1);
+    step();
+    EXPECT_FALSE(m_body0->isSleeping());
+    EXPECT_EQ(m_sleepManager->d_nbSleepingNodes.getValue(), 0);
+}
+
+TEST_F(SleepManager_test, contactWithMovingBodyWakesUp)
+{
+    createScene(false);
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+        step();
+    }
+    ASSERT_TRUE(m_body0->isSleeping());
+
+    // a body at rest does not wake the sleeping body up
+    setPosition(m_body1, 0.95);
+    step();
+    EXPECT_EQ(m_contactManager->getContacts().size(), 1);
+    EXPECT_TRUE(m_body0->isSleeping());
+
+    setVelocity(m_body1, -1);
+    step();
+    EXPECT_FALSE(m_body0->isSleeping());
+}
+
+TEST_F(SleepManager_test, sleepingBodiesAreNotIntersected)
+{
+    createScene(true);
+    setPosition(m_body1, 0.95);
+
+    step();
+    EXPECT_EQ(m_contactManager->getContacts().size(), 1);
+
+    step();
+    step();
+    ASSERT_TRUE(m_body0->isSleeping());
+    ASSERT_TRUE(m_body1->isSleeping());
+    EXPECT_EQ(m_sleepManager->d_nbSleepingNodes.getValue(), 2);
+
+    step();
+    EXPECT_TRUE(m_contactManager->getContacts().empty());
+    EXPECT_TRUE(m_body0->isSleeping());
+    EXPECT_TRUE(m_body1->isSleeping());
+
+    // waking a body up restores the contact
+    m_sleepManager->wakeUp(m_body1.get());
+    step();
+    EXPECT_EQ(m_contactManager->getContacts().size(), 1);
+}
+
+/// A sphere falling with gravity on a static floor, and a sphere without solver which can hit it
+struct SleepManagerFloor_test : public BaseSimulationTest
+{
+    using MechanicalState = core::behavior::MechanicalState<defaulttype::Vec3Types>;
+
+    simulation::Node::SPtr m_root;
+    simulation::Node::SPtr m_ball;
+    simulation::Node::SPtr m_hitter;
+    SleepManager* m_sleepManager { nullptr };
+    core::collision::ContactManager* m_contactManager { nullptr };
+
+    void doSetUp() override
+    {
+        this->loadPlugins({
+            Sofa.Component.StateContainer,
+            Sofa.Component.Controller,
+            Sofa.Component.Topology.Container.Constant,
+            Sofa.Component.Mass,
+            Sofa.Component.ODESolver.Backward,
+            Sofa.Component.LinearSolver.Iterative,
+            Sofa.Component.Collision.Geometry,
+            Sofa.Component.Collision.Detection.Algorithm,
+            Sofa.Component.Collision.Detection.Intersection,
+            Sofa.Component.Collision.Response.Contact
+        });
+
+        m_root = simulation::getSimulation()->createNewGraph("root");
+        m_root->setGravity({ 0, 0, -10 });
+        simpleapi::createObject(m_root, "DefaultAnimationLoop");
+        simpleapi::createObject(m_root, "SleepManager", {{"name", "sleepManager"}, {"velocityThreshold", "0.01"}, {"nbQuietSteps", "5"}});
+        simpleapi::createObject(m_root, "CollisionPipeline");
+        simpleapi::createObject(m_root, "BruteForceBroadPhase");
+        simpleapi::createObject(m_root, "BVHNarrowPhase");
+        simpleapi::createObject(m_root, "MinProximityIntersection", {{"alarmDistance", "0.3"}, {"contactDistance", "0.1"}});
+        simpleapi::createObject(m_root, "CollisionResponse", {{"name", "response"}, {"response", "PenalityContactForceField"}});
+
+        const auto floor = simpleapi::createChild(m_root, "floor");
+        simpleapi::createObject(floor, "MeshTopology", {{"position", "-10 -10 0  10 -10 0  10 10 0  -10 10 0"}, {"triangles", "0 1 2  0 2 3"}});
+        simpleapi::createObject(floor, "MechanicalObject");
+        simpleapi::createObject(floor, "TriangleCollisionModel", {{"moving", "false"}, {"simulated", "false"}});
+
+        m_ball = simpleapi::createChild(m_root, "ball", {{"canChangeSleepingState", "true"}});
+        simpleapi::createObject(m_ball, "EulerImplicitSolver", {{"rayleighMass", "2"}});
+        simpleapi::createObject(m_ball, "CGLinearSolver", {{"iterations", "25"}, {"tolerance", "1e-9"}, {"threshold", "1e-9"}});
+        simpleapi::createObject(m_ball, "MechanicalObject", {{"position", "2 3 0.6"}});
+        simpleapi::createObject(m_ball, "UniformMass", {{"totalMass", "1"}});
+        simpleapi::createObject(m_ball, "SphereCollisionModel", {{"radius", "0.5"}, {"contactStiffness", "1000"}});
+
+        m_hitter = simpleapi::createChild(m_root, "hitter");
+        simpleapi::createObject(m_hitter, "MechanicalObject", {{"position", "50 0 5"}});
+        simpleapi::createObject(m_hitter, "SphereCollisionModel", {{"radius", "0.5"}});
+
+        sofa::simulation::node::initRoot(m_root.get());
+
+        m_sleepManager = dynamic_cast<SleepManager*>(m_root->getObject("sleepManager"));
+        ASSERT_NE(m_sleepManager, nullptr);
+        m_contactManager = dynamic_cast<core::collision::ContactManager*>(m_root->getObject("response"));
+        ASSERT_NE(m_contactManager, nullptr);
+    }
+
+    void doTearDown() override
+    {
+        sofa::simulation::node::unload(m_root);
+    }
+
+    static MechanicalState* getState(const simulation::Node::SPtr& node)
+    {
+        return dynamic_cast<MechanicalState*>(node->getMechanicalState());
+    }
+
+    SReal getBallHeight() const
+    {
+        return getState(m_ball)->read(core::vec_id::read_access::position)->getValue()[0][2];
+    }
+
+    /// Number of contacts between the ball and another body
+    std::size_t getNbBallContacts() const
+    {
+        std::size_t nbContacts = 0;
+        for (const auto& contact : m_contactManager->getContacts())
+        {
+            const auto [model1, model2] = contact->getCollisionModels();
+            if (model1->getContext() == m_ball.get() || model2->getContext() == m_ball.get())
+            {
+                ++nbContacts;
+            }
+        }
+        return nbContacts;
+    }
+
+    void step()
+    {
+        sofa::simulation::node::animate(m_root.get(), 0.01_sreal);
+    }
+
+    /// Let the ball fall on the floor until it falls asleep
+    void settle()
+    {
+        for (unsigned int i = 0; i < 500 && !m_ball->isSleeping(); ++i)
+        {
+            step();
+        }
+        ASSERT_TRUE(m_ball->isSleeping());
+        EXPECT_GT(getBallHeight(), 0.4);
+    }
+};
+
+TEST_F(SleepManagerFloor_test, ballFallsAsleepOnFloor)
+{
+    settle();
+
+    // the floor does not wake the sleeping ball up, and their contact is not detected anymore
+    const SReal height = getBallHeight();
+    step();
+    EXPECT_TRUE(m_ball->isSleeping());
+    EXPECT_TRUE(m_contactManager->getContacts().empty());
+    EXPECT_EQ(getBallHeight(), height);
+}
+
+TEST_F(SleepManagerFloor_test, hitBallKeepsContactWithFloor)
+{
+    settle();
+    const SReal height = getBallHeight();
+
+    // the ball is woken up by the new contact with the hitter, and its contact with the floor is detected in the
+    // same step: the ball does not fall through the floor
+    {
+        auto positions = sofa::helper::getWriteAccessor(*getState(m_hitter)->write(core::vec_id::write_access::position));
+        positions[0] = { 2.95, 3, height };
+        auto velocities = sofa::helper::getWriteAccessor(*getState(m_hitter)->write(core::vec_id::write_access::velocity));
+        velocities[0] = { -1, 0, 0 };
+    }
+    step();
+    EXPECT_FALSE(m_ball->isSleeping());
+    EXPECT_EQ(getNbBallContacts(), 2);
+
+    for (unsigned int i = 0; i < 20; ++i)
+    {
+        step();
+        EXPECT_GT(getBallHeight(), height - 0.05) << "step " << i;
+    }
+}
+
+TEST_F(SleepManagerFloor_test, modifiedVelocityKeepsContactWithFloor)
+{
+    settle();
+    const SReal height = getBallHeight();
+
+    // the ball is woken up before the collision detection, and its contact with the floor is detected in the same step
+    {
+        auto velocities = sofa::helper::getWriteAccessor(*getState(m_ball)->write(core::vec_id::write_access::velocity));
+        velocities[0] = { 0.5, 0, 0 };
+    }
+    step();
+    EXPECT_FALSE(m_ball->isSleeping());
+    EXPECT_EQ(getNbBallContacts(), 1);
+
+    for (unsigned int i = 0; i < 20; ++i)
+    {
+        step();
+        EXPECT_GT(getBallHeight(), height - 0.05) << "step " << i;
+    }
+}
+
+}
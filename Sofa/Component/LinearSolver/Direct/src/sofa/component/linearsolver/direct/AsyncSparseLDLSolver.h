@@ -72,6 +72,10 @@ public:
     bool hasUpdatedMatrix() override;
     void updateSystemMatrix() override;
 
+    /// The pending factorization is dropped, and the next solve waits for the factorization of the next system
+    /// matrix, as after the initialization
+    void requestRefactorization() override;
+
     ~AsyncSparseLDLSolver() override;
 
 protected:
@@ -32,6 +32,13 @@ template <class TMatrix, class TVector, class TThreadManager>
 void AsyncSparseLDLSolver<TMatrix, TVector, TThreadManager>::init()
 {
     Inherit1::init();
+
+    if (this->d_mixedPrecision.getValue())
+    {
+        msg_warning() << "Mixed precision is not supported by the asynchronous factorization: it is disabled.";
+        this->d_mixedPrecision.setValue(false);
+    }
+
     waitForAsyncTask = true;
     m_asyncThreadInvertData = &m_secondInvertData;
     m_mainThreadInvertData = static_cast<InvertData*>(this->invertData.get());
@@ -131,6 +138,17 @@ void AsyncSparseLDLSolver<TMatrix, TVector, TThreadManager>::updateSystemMatrix(
     m_hasUpdatedMatrix = false;
 }
 
+template <class TMatrix, class TVector, class TThreadManager>
+void AsyncSparseLDLSolver<TMatrix, TVector, TThreadManager>::requestRefactorization()
+{
+    if (m_asyncResult.valid())
+        m_asyncResult.get();
+    newInvertDataReady = false;
+
+    Inherit1::requestRefactorization();
+    waitForAsyncTask = true;
+}
+
 template <class TMatrix, class TVector, class TThreadManager>
 AsyncSparseLDLSolver<TMatrix, TVector, TThreadManager>::~AsyncSparseLDLSolver()
 {
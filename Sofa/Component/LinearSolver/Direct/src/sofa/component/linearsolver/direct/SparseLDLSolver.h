@@ -55,6 +55,7 @@ public :
     typedef typename Inherit::ResMatrixType ResMatrixType;
     typedef typename Inherit::JMatrixType JMatrixType;
     typedef SparseLDLImplInvertData<type::vector<int>, type::vector<Real> > InvertData;
+    typedef SparseLDLImplInvertData<type::vector<int>, type::vector<float> > LowPrecisionInvertData;
 
     void init() override;
     void parse( sofa::core::objectmodel::BaseObjectDescription* arg ) override;
@@ -68,6 +69,12 @@ public :
         return new InvertData();
     }
 
+    Data<bool> d_mixedPrecision; ///< If true, the factorization is stored in single precision and the solution is improved by iterative refinement in the precision of the system
+    Data<unsigned int> d_maxRefinementIterations; ///< Maximum number of iterative refinement steps in mixed precision
+    Data<Real> d_refinementTolerance; ///< Relative residual below which the iterative refinement stops in mixed precision
+    Data<Real> d_residual; ///< Output: relative residual ||b - Ax|| / ||b|| reached by the last solve in mixed precision
+    Data<bool> d_sparseInverseProduct; ///< If true, J * A^-1 * J^T is computed with sparse solves restricted to the elimination tree paths reached by the rows of J
+
 protected :
     SparseLDLSolver();
 
@@ -77,6 +84,40 @@ protected :
 
     bool factorize(Matrix& M, InvertData * invertData);
 
+    template<class TInvertData>
+    bool addJMInvJtLocalImpl(ResMatrixType* result, const JMatrixType* J, SReal fact, TInvertData* data);
+
+    /// Compute J * A^-1 * J^T exploiting the sparsity of the rows of J:
+    /// L^-1 J^T is only computed on the elimination tree paths starting from the columns of each row,
+    /// and the blocks of the result are only computed for the rows whose paths intersect.
+    template<class TInvertData>
+    bool addJMInvJtLocalSparseImpl(ResMatrixType* result, const JMatrixType* J, SReal fact, TInvertData* data);
+
+    /// Rows of J sharing the same columns, hence the same paths in the elimination tree
+    struct RowGroup
+    {
+        type::vector<int> columns; ///< sorted permuted columns of the rows
+        type::vector<int> reach; ///< sorted permuted indices reached from the columns in the elimination tree
+        type::vector<sofa::Index> rows; ///< local indices of the rows in J
+        std::size_t offset {}; ///< position of the values of the first row in m_sparseJLinv
+    };
+    type::vector<RowGroup> m_rowGroups;
+    /// Values of L^-1 * J^T for each row, restricted to the reach of its group
+    type::vector<Real> m_sparseJLinv;
+
+    /// Solve the system with the single precision factorization, then refine the solution using
+    /// residuals computed with the filtered system matrix
+    void solveWithIterativeRefinement(Vector& x, const Vector& b);
+
+    /// Factorization used when d_mixedPrecision is enabled
+    LowPrecisionInvertData m_lowPrecisionInvertData;
+    /// Precision of the current factorization. It follows d_mixedPrecision at each call to invert, and only
+    /// changes with it, so that the factorization used to solve is always the one computed last.
+    bool m_isMixedPrecisionFactorization { false };
+    /// Factorize M again if d_mixedPrecision was changed since the last factorization
+    void factorizeIfPrecisionChanged(Matrix& M);
+    Vector m_refinementResidual, m_refinementCorrection;
+
     void showInvalidSystemMessage(const std::string& reason) const;
 
     using Triplet = std::tuple<sofa::SignedIndex, sofa::SignedIndex, Real>;
@@ -31,6 +31,7 @@
 #include <fstream>
 #include <iomanip>      // std::setprecision
 #include <string>
+#include <map>
 #include <sofa/simulation/MainTaskSchedulerFactory.h>
 #include <sofa/simulation/ParallelForEach.h>
 
@@ -41,6 +42,14 @@ namespace sofa::component::linearsolver::direct
 template<class TMatrix, class TVector, class TThreadManager>
 SparseLDLSolver<TMatrix,TVector,TThreadManager>::SparseLDLSolver()
     : numStep(0)
+    , d_mixedPrecision(initData(&d_mixedPrecision, false, "mixedPrecision", "If true, the factorization is computed and stored in single precision, halving its memory footprint. "
+                                                                            "The solution is then improved by iterative refinement, with residuals computed in the precision of the system. "
+                                                                            "Changing it at runtime factorizes the matrix again before the next solve."))
+    , d_maxRefinementIterations(initData(&d_maxRefinementIterations, 3u, "maxRefinementIterations", "Maximum number of iterative refinement steps in mixed precision"))
+    , d_refinementTolerance(initData(&d_refinementTolerance, static_cast<Real>(1e-10), "refinementTolerance", "Relative residual below which the iterative refinement stops in mixed precision"))
+    , d_residual(initData(&d_residual, static_cast<Real>(0), "residual", "Output: relative residual ||b - Ax|| / ||b|| reached by the last solve in mixed precision", true, true))
+    , d_sparseInverseProduct(initData(&d_sparseInverseProduct, false, "sparseInverseProduct", "If true, J * A^-1 * J^T (used by the constraint corrections) is computed with sparse triangular solves restricted to the elimination tree paths reached by each row of J, "
+                                                                                             "and only for the pairs of rows whose paths intersect. Efficient when each constraint row involves a few DOFs."))
 {}
 
 template <class TMatrix, class TVector, class TThreadManager>
@@ -87,9 +96,53 @@ template<class TMatrix, class TVector, class TThreadManager>
 void SparseLDLSolver<TMatrix,TVector,TThreadManager>::solve (Matrix& M, Vector& z, Vector& r)
 {
     SCOPED_TIMER_VARNAME(solveTimer, "solve");
+    factorizeIfPrecisionChanged(M);
+    if (m_isMixedPrecisionFactorization)
+    {
+        solveWithIterativeRefinement(z, r);
+        return;
+    }
     Inherit::solve_cpu(z.ptr(), r.ptr(), (InvertData *) this->getMatrixInvertData(&M));
 }
 
+template<class TMatrix, class TVector, class TThreadManager>
+void SparseLDLSolver<TMatrix,TVector,TThreadManager>::solveWithIterativeRefinement(Vector& x, const Vector& b)
+{
+    Inherit::solve_cpu(x.ptr(), b.ptr(), &m_lowPrecisionInvertData);
+
+    const auto rhsNorm = b.norm();
+    if (rhsNorm == 0)
+    {
+        d_residual.setValue(0);
+        return;
+    }
+
+    const auto maxIterations = d_maxRefinementIterations.getValue();
+    const auto tolerance = d_refinementTolerance.getValue();
+
+    Real relativeResidual = 0;
+    unsigned int iteration = 0;
+    while (true)
+    {
+        // r = b - A x, computed in the precision of the system
+        Mfiltered.mul(m_refinementResidual, x);
+        m_refinementResidual.eq(b, m_refinementResidual, -1);
+        relativeResidual = static_cast<Real>(m_refinementResidual.norm() / rhsNorm);
+
+        if (relativeResidual <= tolerance || iteration >= maxIterations)
+        {
+            break;
+        }
+
+        m_refinementCorrection.resize(m_refinementResidual.size());
+        Inherit::solve_cpu(m_refinementCorrection.ptr(), m_refinementResidual.ptr(), &m_lowPrecisionInvertData);
+        x += m_refinementCorrection;
+        ++iteration;
+    }
+
+    d_residual.setValue(relativeResidual);
+}
+
 template <class TMatrix, class TVector, class TThreadManager>
 bool SparseLDLSolver<TMatrix, TVector, TThreadManager>::factorize(
     Matrix& M, InvertData * invertData)
@@ -121,7 +174,14 @@ bool SparseLDLSolver<TMatrix, TVector, TThreadManager>::factorize(
         return true;
     }
 
-    Inherit::factorize(n,M_colptr,M_rowind,M_values, invertData);
+    if (m_isMixedPrecisionFactorization)
+    {
+        Inherit::factorize(n,M_colptr,M_rowind,M_values, &m_lowPrecisionInvertData);
+    }
+    else
+    {
+        Inherit::factorize(n,M_colptr,M_rowind,M_values, invertData);
+    }
 
     numStep++;
 
@@ -137,11 +197,33 @@ void SparseLDLSolver<TMatrix, TVector, TThreadManager>::showInvalidSystemMessage
 template<class TMatrix, class TVector, class TThreadManager>
 void SparseLDLSolver<TMatrix,TVector,TThreadManager>::invert(Matrix& M)
 {
+    m_isMixedPrecisionFactorization = d_mixedPrecision.getValue();
     factorize(M, (InvertData *) this->getMatrixInvertData(&M));
 }
 
+template<class TMatrix, class TVector, class TThreadManager>
+void SparseLDLSolver<TMatrix,TVector,TThreadManager>::factorizeIfPrecisionChanged(Matrix& M)
+{
+    if (d_mixedPrecision.getValue() != m_isMixedPrecisionFactorization)
+    {
+        msg_info() << "The precision of the factorization changed: the matrix is factorized again.";
+        invert(M);
+    }
+}
+
 template <class TMatrix, class TVector, class TThreadManager>
 bool SparseLDLSolver<TMatrix, TVector, TThreadManager>::doAddJMInvJtLocal(ResMatrixType* result, const JMatrixType* J, SReal fact, InvertData* data)
+{
+    if (m_isMixedPrecisionFactorization)
+    {
+        return addJMInvJtLocalImpl(result, J, fact, &m_lowPrecisionInvertData);
+    }
+    return addJMInvJtLocalImpl(result, J, fact, data);
+}
+
+template <class TMatrix, class TVector, class TThreadManager>
+template <class TInvertData>
+bool SparseLDLSolver<TMatrix, TVector, TThreadManager>::addJMInvJtLocalImpl(ResMatrixType* result, const JMatrixType* J, SReal fact, TInvertData* data)
 {
     if (!this->isComponentStateValid())
     {
@@ -159,6 +241,11 @@ bool SparseLDLSolver<TMatrix, TVector, TThreadManager>::doAddJMInvJtLocal(ResMat
         return true;
     }
 
+    if (d_sparseInverseProduct.getValue())
+    {
+        return addJMInvJtLocalSparseImpl(result, J, fact, data);
+    }
+
     Jlocal2global.clear();
     Jlocal2global.reserve(J->rowSize());
     for (auto jit = J->begin(), jitend = J->end(); jit != jitend; ++jit)
@@ -279,11 +366,223 @@ bool SparseLDLSolver<TMatrix, TVector, TThreadManager>::doAddJMInvJtLocal(ResMat
     return true;
 }
 
+template <class TMatrix, class TVector, class TThreadManager>
+template <class TInvertData>
+bool SparseLDLSolver<TMatrix, TVector, TThreadManager>::addJMInvJtLocalSparseImpl(ResMatrixType* result, const JMatrixType* J, SReal fact, TInvertData* data)
+{
+    /*
+    J * M^-1 * J^T = (L^-1 * J^T)^T * D^-1 * (L^-1 * J^T)
+
+    The solution of L y = b, with b sparse, is non-zero only on the paths of the elimination tree
+    going from the non-zero entries of b to the root. Each row of J is solved on its paths only,
+    and two rows contribute to the result only if their paths intersect.
+    */
+
+    const int n = data->n;
+    if (n == 0)
+    {
+        return true;
+    }
+
+    const simulation::ForEachExecutionPolicy execution = this->d_parallelInverseProduct.getValue() ?
+        simulation::ForEachExecutionPolicy::PARALLEL :
+        simulation::ForEachExecutionPolicy::SEQUENTIAL;
+
+    simulation::TaskScheduler* taskScheduler = simulation::MainTaskSchedulerFactory::createInRegistry();
+    assert(taskScheduler);
+
+    Jlocal2global.clear();
+    m_rowGroups.clear();
+    std::vector<const typename JMatrixType::Line*> rows;
+
+    {
+        SCOPED_TIMER("GroupRows");
+
+        // group the rows having the same (permuted) columns
+        std::map<type::vector<int>, sofa::Index> groupOfColumns;
+        type::vector<int> columns;
+        for (auto jit = J->begin(), jitend = J->end(); jit != jitend; ++jit)
+        {
+            columns.clear();
+            for (auto it = jit->second.begin(), itend = jit->second.end(); it != itend; ++it)
+            {
+                columns.push_back(data->invperm[it->first]);
+            }
+            std::sort(columns.begin(), columns.end());
+            columns.erase(std::unique(columns.begin(), columns.end()), columns.end());
+
+            const auto [group, inserted] = groupOfColumns.emplace(columns, static_cast<sofa::Index>(m_rowGroups.size()));
+            if (inserted)
+            {
+                m_rowGroups.emplace_back();
+                m_rowGroups.back().columns = columns;
+            }
+            m_rowGroups[group->second].rows.push_back(static_cast<sofa::Index>(Jlocal2global.size()));
+            Jlocal2global.push_back(jit->first);
+            rows.push_back(&jit->second);
+        }
+    }
+
+    if (Jlocal2global.empty())
+    {
+        return true;
+    }
+
+    const auto nbGroups = static_cast<sofa::Index>(m_rowGroups.size());
+
+    {
+        SCOPED_TIMER("Reach");
+        simulation::forEachRange(execution, *taskScheduler, 0u, nbGroups,
+            [&data, n, this](const auto& range)
+            {
+                type::vector<int> flag(n, -1);
+                for (auto g = range.start; g != range.end; ++g)
+                {
+                    RowGroup& group = m_rowGroups[g];
+                    group.reach.clear();
+                    for (int i : group.columns)
+                    {
+                        for (; i != -1 && flag[i] != static_cast<int>(g); i = data->Parent[i])
+                        {
+                            flag[i] = static_cast<int>(g);
+                            group.reach.push_back(i);
+                        }
+                    }
+                    std::sort(group.reach.begin(), group.reach.end());
+                }
+            });
+    }
+
+    std::size_t nbValues = 0;
+    for (RowGroup& group : m_rowGroups)
+    {
+        group.offset = nbValues;
+        nbValues += group.rows.size() * group.reach.size();
+    }
+    m_sparseJLinv.resize(nbValues);
+
+    {
+        SCOPED_TIMER("SparseLowerSystem");
+        simulation::forEachRange(execution, *taskScheduler, 0u, nbGroups,
+            [&data, n, &rows, this](const auto& range)
+            {
+                type::vector<Real> y(n, 0);
+                for (auto g = range.start; g != range.end; ++g)
+                {
+                    const RowGroup& group = m_rowGroups[g];
+                    Real* values = m_sparseJLinv.data() + group.offset;
+                    for (const sofa::Index localRow : group.rows)
+                    {
+                        for (auto it = rows[localRow]->begin(), itend = rows[localRow]->end(); it != itend; ++it)
+                        {
+                            y[data->invperm[it->first]] += it->second;
+                        }
+
+                        // column oriented forward substitution, restricted to the reach
+                        for (const int j : group.reach)
+                        {
+                            const Real yj = y[j];
+                            if (yj == 0)
+                            {
+                                continue;
+                            }
+                            for (int p = data->L_colptr[j]; p < data->L_colptr[j + 1]; ++p)
+                            {
+                                y[data->L_rowind[p]] -= static_cast<Real>(data->L_values[p]) * yj;
+                            }
+                        }
+
+                        for (const int j : group.reach)
+                        {
+                            *values++ = y[j];
+                            y[j] = 0;
+                        }
+                    }
+                }
+            });
+    }
+
+    const auto nbPairs = nbGroups * (nbGroups + 1) / 2;
+
+    SCOPED_TIMER("SparseUpperSystem");
+    std::mutex mutex;
+
+    simulation::forEachRange(execution, *taskScheduler, 0u, nbPairs,
+        [&data, this, fact, &mutex, result](const auto& range)
+        {
+            std::vector<Triplet> triplets;
+            type::vector<std::pair<sofa::Index, sofa::Index> > common;
+            type::vector<Real> commonInvD;
+            {
+                SCOPED_TIMER("BlockRange");
+                for (auto r = range.start; r != range.end; ++r)
+                {
+                    sofa::Index gi, gj;
+                    linearalgebra::computeRowColumnCoordinateFromIndexInLowerTriangularMatrix(r, gi, gj);
+                    const RowGroup& groupI = m_rowGroups[gi];
+                    const RowGroup& groupJ = m_rowGroups[gj];
+
+                    // intersection of the paths of both groups
+                    common.clear();
+                    commonInvD.clear();
+                    for (sofa::Index a = 0, b = 0; a < groupI.reach.size() && b < groupJ.reach.size();)
+                    {
+                        if (groupI.reach[a] < groupJ.reach[b]) ++a;
+                        else if (groupJ.reach[b] < groupI.reach[a]) ++b;
+                        else
+                        {
+                            common.emplace_back(a, b);
+                            commonInvD.push_back(static_cast<Real>(data->invD[groupI.reach[a]]));
+                            ++a;
+                            ++b;
+                        }
+                    }
+                    if (common.empty())
+                    {
+                        continue;
+                    }
+
+                    for (std::size_t ri = 0; ri < groupI.rows.size(); ++ri)
+                    {
+                        const Real* lineI = m_sparseJLinv.data() + groupI.offset + ri * groupI.reach.size();
+                        const std::size_t rjEnd = (gi == gj) ? ri + 1 : groupJ.rows.size();
+                        for (std::size_t rj = 0; rj < rjEnd; ++rj)
+                        {
+                            const Real* lineJ = m_sparseJLinv.data() + groupJ.offset + rj * groupJ.reach.size();
+                            Real value = 0;
+                            for (std::size_t k = 0; k < common.size(); ++k)
+                            {
+                                value += lineI[common[k].first] * commonInvD[k] * lineJ[common[k].second];
+                            }
+                            triplets.emplace_back(Jlocal2global[groupI.rows[ri]], Jlocal2global[groupJ.rows[rj]], value * fact);
+                        }
+                    }
+                }
+            }
+
+            std::lock_guard guard(mutex);
+
+            SCOPED_TIMER("Assembling");
+            for (const auto& [row, col, value] : triplets)
+            {
+                result->add(row, col, value);
+                if (row != col)
+                {
+                    result->add(col, row, value);
+                }
+            }
+        });
+
+    return true;
+}
+
 // Default implementation of Multiply the inverse of the system matrix by the transpose of the given matrix, and multiply the result with the given matrix J
 template<class TMatrix, class TVector, class TThreadManager>
 bool SparseLDLSolver<TMatrix,TVector,TThreadManager>::addJMInvJtLocal(TMatrix * M, ResMatrixType * result,const JMatrixType * J, SReal fact) 
 {
 
+    factorizeIfPrecisionChanged(*M);
+
     InvertData* data = (InvertData*)this->getMatrixInvertData(M);
 
     return doAddJMInvJtLocal(result, J, fact, data);
@@ -94,10 +94,12 @@ inline void CSPARSE_symbolic (int n,int * M_colptr,int * M_rowind,int * colptr,i
     for (int k = 0 ; k < n ; k++) colptr[k+1] = colptr[k] + Lnz[k] ;
 }
 
-template<class Real>
-inline void CSPARSE_numeric(int n,int * M_colptr,int * M_rowind,Real * M_values,int * colptr,int * rowind,Real * values,Real * D,int * perm,int * invperm,int * Parent, int * Flag, int * Lnz, int * Pattern, Real * Y)
+// The factor (values and D) can be stored with a lower precision than the input matrix: the
+// numerical factorization is still accumulated in the precision of the input matrix.
+template<class Real, class FactorReal = Real>
+inline void CSPARSE_numeric(int n,int * M_colptr,int * M_rowind,Real * M_values,int * colptr,int * rowind,FactorReal * values,FactorReal * D,int * perm,int * invperm,int * Parent, int * Flag, int * Lnz, int * Pattern, Real * Y)
 {
-    Real yi, l_ki ;
+    Real yi, l_ki, dk ;
     int i, p, kk, len, top ;
 
     for (int k = 0 ; k < n ; k++)
@@ -122,7 +124,7 @@ inline void CSPARSE_numeric(int n,int * M_colptr,int * M_rowind,Real * M_values,
             }
         }
         // compute numerical values kth row of L (a sparse triangular solve) 
-        D[k] = Y [k] ;		    // get D(k,k) and clear Y(k) 
+        dk = Y [k] ;		    // get D(k,k) and clear Y(k) 
         Y[k] = 0.0 ;
         for ( ; top < n ; top++)
         {
@@ -131,15 +133,16 @@ inline void CSPARSE_numeric(int n,int * M_colptr,int * M_rowind,Real * M_values,
             Y [i] = 0.0 ;
             for (p = colptr[i] ; p < colptr[i] + Lnz [i] ; p++)
             {
-                Y[rowind[p]] -= values[p] * yi ;
+                Y[rowind[p]] -= static_cast<Real>(values[p]) * yi ;
             }
-            l_ki = yi / D[i] ;	    // the nonzero entry L(k,i) 
-            D[k] -= l_ki * yi ;
+            l_ki = yi / static_cast<Real>(D[i]) ;	    // the nonzero entry L(k,i) 
+            dk -= l_ki * yi ;
             rowind[p] = k ;	    // store L(k,i) in column form of L 
-            values[p] = l_ki ;
+            values[p] = static_cast<FactorReal>(l_ki) ;
             Lnz[i]++ ;		    // increment count of nonzeros in col i 
         }
 
+        D[k] = static_cast<FactorReal>(dk) ;
         if (D[k] == 0.0)
         {
             msg_error("SparseLDLSolver") << "Failed to factorize, D(k,k) is zero" ;
@@ -252,14 +255,15 @@ protected :
         CSPARSE_symbolic(n,M_colptr,M_rowind,colptr,perm,invperm,Parent,Flag.data(),Lnz.data());
     }
 
+    template<class FactorReal>
     void LDL_numeric(int n,
                      int* M_colptr, int* M_rowind, Real* M_values,
-                     int* colptr, int* rowind, Real* values,
-                     Real* D, int* perm, int* invperm, int* Parent)
+                     int* colptr, int* rowind, FactorReal* values,
+                     FactorReal* D, int* perm, int* invperm, int* Parent)
     {
         Y.resize(n);
 
-        CSPARSE_numeric<Real>(n,M_colptr,M_rowind,M_values,colptr,rowind,values,D,perm,invperm,Parent,Flag.data(),Lnz.data(),Pattern.data(),Y.data());
+        CSPARSE_numeric<Real, FactorReal>(n,M_colptr,M_rowind,M_values,colptr,rowind,values,D,perm,invperm,Parent,Flag.data(),Lnz.data(),Pattern.data(),Y.data());
     }
 
     template<class VecInt,class VecReal>
@@ -274,7 +278,7 @@ protected :
         data->P_nnz = M_colptr[data->n];
         data->P_values.clear();
         data->P_values.fastResize(data->P_nnz);
-        memcpy(data->P_values.data(), M_values, data->P_nnz * sizeof(Real));
+        std::copy_n(M_values, data->P_nnz, data->P_values.data());
 
         // we test if the matrix has the same struct as previous factorized matrix
         if (data->new_factorization_needed  || !d_precomputeSymbolicDecomposition.getValue() )
@@ -312,13 +316,13 @@ protected :
             data->LT_values.clear();data->LT_values.fastResize(data->L_nnz);
         }
 
-        Real * D = data->invD.data();
+        auto * D = data->invD.data();
         int * rowind = data->L_rowind.data();
         int * colptr = data->L_colptr.data();
-        Real * values = data->L_values.data();
+        auto * values = data->L_values.data();
         int * tran_rowind = data->LT_rowind.data();
         int * tran_colptr = data->LT_colptr.data();
-        Real * tran_values = data->LT_values.data();
+        auto * tran_values = data->LT_values.data();
 
         //Numeric Factorization
         {
@@ -140,3 +140,133 @@ TEST(SparseLDLSolver, AssociatedLinearSystem)
 
     EXPECT_EQ(MatrixSystem::GetCustomTemplateName(), MatrixType::Name());
 }
+
+TEST(SparseLDLSolver, MixedPrecisionRefinement)
+{
+    using MatrixType = sofa::linearalgebra::CompressedRowSparseMatrix<SReal>;
+    using VectorType = sofa::linearalgebra::FullVector<SReal>;
+    using Solver = sofa::component::linearsolver::direct::SparseLDLSolver<MatrixType, VectorType>;
+
+    // symmetric positive definite tridiagonal matrix with a wide range of values
+    constexpr sofa::Index n = 50;
+    MatrixType matrix;
+    matrix.resize(n, n);
+    for (sofa::Index i = 0; i < n; ++i)
+    {
+        matrix.add(i, i, 4 + static_cast<SReal>(i) * 1e3);
+        if (i + 1 < n)
+        {
+            matrix.add(i, i + 1, -1);
+            matrix.add(i + 1, i, -1);
+        }
+    }
+    matrix.compress();
+
+    VectorType b(n);
+    for (sofa::Index i = 0; i < n; ++i)
+    {
+        b[i] = std::sin(static_cast<SReal>(i)) + 1;
+    }
+
+    const auto solve = [&matrix, &b](bool mixedPrecision)
+    {
+        const Solver::SPtr solver = sofa::core::objectmodel::New<Solver>();
+        solver->d_mixedPrecision.setValue(mixedPrecision);
+        solver->init();
+        solver->invert(matrix);
+
+        VectorType x(n);
+        solver->solve(matrix, x, b);
+        return std::make_pair(x, solver->d_residual.getValue());
+    };
+
+    const VectorType reference = solve(false).first;
+    const auto [mixed, mixedResidual] = solve(true);
+
+    EXPECT_LT(mixedResidual, 1e-10);
+    for (sofa::Index i = 0; i < n; ++i)
+    {
+        EXPECT_NEAR(mixed[i], reference[i], 1e-10);
+    }
+
+    // changing the precision after the factorization factorizes the matrix again before solving
+    const Solver::SPtr solver = sofa::core::objectmodel::New<Solver>();
+    solver->init();
+    solver->invert(matrix);
+    for (const bool mixedPrecision : { true, false, true })
+    {
+        solver->d_mixedPrecision.setValue(mixedPrecision);
+        solver->d_residual.setValue(1);
+
+        VectorType x(n);
+        solver->solve(matrix, x, b);
+        EXPECT_EQ(solver->d_residual.getValue() < 1e-10, mixedPrecision);
+        for (sofa::Index i = 0; i < n; ++i)
+        {
+            EXPECT_NEAR(x[i], reference[i], 1e-10);
+        }
+    }
+}
+
+TEST(SparseLDLSolver, SparseInverseProduct)
+{
+    using MatrixType = sofa::linearalgebra::CompressedRowSparseMatrix<SReal>;
+    using VectorType = sofa::linearalgebra::FullVector<SReal>;
+    using Solver = sofa::component::linearsolver::direct::SparseLDLSolver<MatrixType, VectorType>;
+
+    // two independent chains of springs, so that the elimination tree is a forest
+    constexpr sofa::Index n = 60;
+    MatrixType matrix;
+    matrix.resize(n, n);
+    for (sofa::Index i = 0; i < n; ++i)
+    {
+        matrix.add(i, i, 4 + static_cast<SReal>(i % 7));
+        if (i + 2 < n)
+        {
+            matrix.add(i, i + 2, -1);
+            matrix.add(i + 2, i, -1);
+        }
+    }
+    matrix.compress();
+
+    // constraint rows touching a few columns, some of them sharing the same columns
+    Solver::JMatrixType J(30, n);
+    for (sofa::Index r = 0; r < 30; ++r)
+    {
+        const sofa::Index c = (r / 3) * 5 % n;
+        J.set(r, c, 1 + static_cast<SReal>(r % 3));
+        J.set(r, (c + 1) % n, -0.5 * static_cast<SReal>(r % 3));
+        if (r % 4 == 0)
+        {
+            J.set(r, (c + 17) % n, 0.25);
+        }
+    }
+
+    // FullMatrix does not own a copy of its values when copied, so the result is given by the caller
+    const auto compliance = [&matrix, &J](bool sparse, bool parallel, sofa::linearalgebra::FullMatrix<SReal>& W)
+    {
+        const Solver::SPtr solver = sofa::core::objectmodel::New<Solver>();
+        solver->d_sparseInverseProduct.setValue(sparse);
+        solver->d_parallelInverseProduct.setValue(parallel);
+        solver->init();
+        solver->invert(matrix);
+
+        W.resize(J.rowSize(), J.rowSize());
+        W.clear();
+        solver->addJMInvJtLocal(&matrix, &W, &J, 0.5);
+    };
+
+    sofa::linearalgebra::FullMatrix<SReal> dense, sparse;
+    compliance(false, false, dense);
+    for (const bool parallel : { false, true })
+    {
+        compliance(true, parallel, sparse);
+        for (sofa::linearalgebra::BaseMatrix::Index i = 0; i < J.rowSize(); ++i)
+        {
+            for (sofa::linearalgebra::BaseMatrix::Index j = 0; j < J.rowSize(); ++j)
+            {
+                EXPECT_NEAR(sparse.element(i, j), dense.element(i, j), 1e-12) << "(" << i << ", " << j << ")";
+            }
+        }
+    }
+}
@@ -76,6 +76,13 @@ void registerCGLinearSolver(sofa::core::ObjectFactory* factory)
         .add< CGLinearSolver< CompressedRowSparseMatrix<Mat<4, 4, SReal> >, FullVector<SReal> > >()
         .add< CGLinearSolver< CompressedRowSparseMatrix<Mat<6, 6, SReal> >, FullVector<SReal> > >()
         .add< CGLinearSolver< CompressedRowSparseMatrix<Mat<8, 8, SReal> >, FullVector<SReal> > >());
+
+#ifndef SOFA_FLOAT
+    // Matrix stored in single precision with vectors in double precision. With SReal=float, its template
+    // name is the one of CompressedRowSparseMatrix<Mat<3, 3, SReal> > registered above.
+    factory->registerObjects(core::ObjectRegistrationData("")
+        .add< CGLinearSolver< CompressedRowSparseMatrix<Mat<3, 3, float> >, FullVector<double> > >());
+#endif
 }
 
 template class SOFA_COMPONENT_LINEARSOLVER_ITERATIVE_API CGLinearSolver< GraphScatteredMatrix, GraphScatteredVector >;
@@ -87,6 +94,7 @@ template class SOFA_COMPONENT_LINEARSOLVER_ITERATIVE_API CGLinearSolver< Compres
 template class SOFA_COMPONENT_LINEARSOLVER_ITERATIVE_API CGLinearSolver< CompressedRowSparseMatrix<type::Mat<4,4,SReal> >, FullVector<SReal> >;
 template class SOFA_COMPONENT_LINEARSOLVER_ITERATIVE_API CGLinearSolver< CompressedRowSparseMatrix<type::Mat<6,6,SReal> >, FullVector<SReal> >;
 template class SOFA_COMPONENT_LINEARSOLVER_ITERATIVE_API CGLinearSolver< CompressedRowSparseMatrix<type::Mat<8,8,SReal> >, FullVector<SReal> >;
+template class SOFA_COMPONENT_LINEARSOLVER_ITERATIVE_API CGLinearSolver< CompressedRowSparseMatrix<type::Mat<3,3,float> >, FullVector<double> >;
 
 
 } // namespace sofa::component::linearsolver::iterative
@@ -0,0 +1,113 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/testing/BaseTest.h>
+#include <sofa/component/linearsolver/iterative/CGLinearSolver.h>
+#include <sofa/linearalgebra/CompressedRowSparseMatrix.h>
+#include <sofa/linearalgebra/FullVector.h>
+
+#include <cmath>
+
+namespace
+{
+
+using sofa::linearalgebra::CompressedRowSparseMatrix;
+using sofa::linearalgebra::FullVector;
+
+/// Symmetric positive definite matrix made of 3x3 blocks coupling each node to its neighbours.
+/// All the entries are exactly representable in single precision.
+template<class TBlock>
+void buildMatrix(CompressedRowSparseMatrix<TBlock>& matrix, sofa::Index nbNodes)
+{
+    matrix.resize(3 * nbNodes, 3 * nbNodes);
+    for (sofa::Index n = 0; n < nbNodes; ++n)
+    {
+        for (sofa::Index i = 0; i < 3; ++i)
+        {
+            const sofa::Index row = 3 * n + i;
+            matrix.add(row, row, 4.5 + 0.25 * ((n + i) % 5));
+            if (i + 1 < 3)
+            {
+                matrix.add(row, row + 1, 0.5);
+                matrix.add(row + 1, row, 0.5);
+            }
+            if (n + 1 < nbNodes)
+            {
+                matrix.add(row, row + 3, -1.0);
+                matrix.add(row + 3, row, -1.0);
+            }
+        }
+    }
+    matrix.compress();
+}
+
+/// Right-hand side whose entries differ below the single precision resolution
+FullVector<double> buildRHS(sofa::Index nbNodes)
+{
+    FullVector<double> b(3 * nbNodes);
+    for (sofa::Index i = 0; i < b.size(); ++i)
+    {
+        b[i] = 1.0 + 1e-9 * i + 0.1 * std::sin(static_cast<double>(i));
+    }
+    return b;
+}
+
+template<class TBlock>
+FullVector<double> solveCG(sofa::Index nbNodes)
+{
+    using Solver = sofa::component::linearsolver::iterative::CGLinearSolver<CompressedRowSparseMatrix<TBlock>, FullVector<double> >;
+    const typename Solver::SPtr solver = sofa::core::objectmodel::New<Solver>();
+    solver->d_maxIter.setValue(1000);
+    solver->d_tolerance.setValue(1e-14);
+    solver->d_smallDenominatorThreshold.setValue(1e-40);
+
+    CompressedRowSparseMatrix<TBlock> A;
+    buildMatrix(A, nbNodes);
+    FullVector<double> b = buildRHS(nbNodes);
+    FullVector<double> x(b.size());
+    solver->solve(A, x, b);
+    return x;
+}
+
+/// A matrix stored in single precision, applied to double precision vectors, gives the same CG solution as the
+/// same matrix stored in double precision: the products accumulate in double precision
+TEST(CGLinearSolver, mixedPrecisionMatchesDoublePrecision)
+{
+    constexpr sofa::Index nbNodes = 50;
+    const FullVector<double> xDouble = solveCG<sofa::type::Mat<3, 3, double> >(nbNodes);
+    const FullVector<double> xMixed = solveCG<sofa::type::Mat<3, 3, float> >(nbNodes);
+
+    ASSERT_EQ(xMixed.size(), xDouble.size());
+    for (sofa::Index i = 0; i < xDouble.size(); ++i)
+    {
+        EXPECT_NEAR(xMixed[i], xDouble[i], 1e-12 * (1 + std::abs(xDouble[i]))) << "at " << i;
+    }
+
+    // the solution solves the system in double precision
+    CompressedRowSparseMatrix<sofa::type::Mat<3, 3, double> > A;
+    buildMatrix(A, nbNodes);
+    const FullVector<double> b = buildRHS(nbNodes);
+    FullVector<double> r = A * xMixed;
+    r.eq(b, r, -1.0);
+    EXPECT_LT(r.norm(), 1e-12 * b.norm());
+}
+
+}
@@ -86,6 +86,9 @@ public:
 
     void updateSystemMatrix() override;
 
+    /// The rotations and the system matrix of the main solver are computed again at the next step, as at the first one
+    void requestRefactorization() override;
+
 protected:
 
     void checkLinearSystem() override;
@@ -211,6 +211,14 @@ void WarpPreconditioner<TMatrix,TVector,ThreadManager >::updateSystemMatrix() {
     l_linearSolver.get()->updateSystemMatrix();
 }
 
+template<class TMatrix, class TVector,class ThreadManager>
+void WarpPreconditioner<TMatrix,TVector,ThreadManager >::requestRefactorization() {
+    Inherit::requestRefactorization();
+    first = true;
+    if (l_linearSolver.get())
+        l_linearSolver.get()->requestRefactorization();
+}
+
 template <class TMatrix, class TVector, class ThreadManager>
 void WarpPreconditioner<TMatrix, TVector, ThreadManager>::checkLinearSystem()
 {
@@ -25,4 +25,8 @@
 namespace sofa::component::linearsystem
 {
 template class SOFA_COMPONENT_LINEARSYSTEM_API BaseMatrixProjectionMethod<linearalgebra::CompressedRowSparseMatrix<SReal> >;
+#ifndef SOFA_FLOAT
+// used by the linear systems of matrices stored in single precision
+template class SOFA_COMPONENT_LINEARSYSTEM_API BaseMatrixProjectionMethod<linearalgebra::CompressedRowSparseMatrix<float> >;
+#endif
 }
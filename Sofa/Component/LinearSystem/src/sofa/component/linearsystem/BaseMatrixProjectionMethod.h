@@ -75,6 +75,9 @@ protected:
 
 #if !defined(SOFA_COMPONENT_LINEARSYSTEM_MATRIXMAPPING_CPP)
 extern template class SOFA_COMPONENT_LINEARSYSTEM_API BaseMatrixProjectionMethod<sofa::linearalgebra::CompressedRowSparseMatrix<SReal> >;
+#ifndef SOFA_FLOAT
+extern template class SOFA_COMPONENT_LINEARSYSTEM_API BaseMatrixProjectionMethod<sofa::linearalgebra::CompressedRowSparseMatrix<float> >;
+#endif
 #endif
 
 } // namespace sofa::component::linearsystem
@@ -41,6 +41,7 @@ public:
     ~ConstantSparsityProjectionMethod() override;
 
     Data<bool> d_parallelProduct; ///< Compute the matrix product in parallel
+    Data<bool> d_fusedProduct; ///< Compute J^T.K.J in a single pass, without the intermediate matrix K.J
 
     void init() override;
     void reinit() override;
@@ -59,6 +60,7 @@ protected:
 
     std::unique_ptr<linearalgebra::SparseMatrixProduct< K_Type, J_Type, KJ_Type> > m_matrixProductKJ;
     std::unique_ptr<linearalgebra::SparseMatrixProduct< JT_Type, KJ_Type, JTKJ_Type> > m_matrixProductJTKJ;
+    std::unique_ptr<linearalgebra::SparseMatrixTripleProduct< JT_Type, K_Type, J_Type, KJ_Type, JTKJ_Type> > m_matrixTripleProduct;
 };
 
 #if !defined(SOFA_COMPONENT_LINEARSYSTEM_CONSTANTSPARSITYPROJECTIONMETHOD_CPP)
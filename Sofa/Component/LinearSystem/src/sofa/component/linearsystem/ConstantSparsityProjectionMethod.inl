@@ -33,6 +33,9 @@ namespace sofa::component::linearsystem
 template <class TMatrix>
 ConstantSparsityProjectionMethod<TMatrix>::ConstantSparsityProjectionMethod()
     : d_parallelProduct(initData(&d_parallelProduct, true, "parallelProduct", "Compute the matrix product in parallel"))
+    , d_fusedProduct(initData(&d_fusedProduct, false, "fusedProduct", "Compute J^T.K.J in a single pass, without the intermediate matrix K.J. "
+                                                                      "It avoids writing and reading the intermediate matrix, but requires more memory "
+                                                                      "and more operations when the mapping matrices are dense."))
 {}
 
 template <class TMatrix>
@@ -65,6 +68,15 @@ void ConstantSparsityProjectionMethod<TMatrix>::init()
             JT_Type, KJ_Type, JTKJ_Type>>(matrixPrductJTKJ);
 
         matrixPrductJTKJ->taskScheduler = taskScheduler;
+
+
+        auto* matrixTripleProduct = new sofa::simulation::ParallelSparseMatrixTripleProduct<
+            JT_Type, K_Type, J_Type, KJ_Type, JTKJ_Type>();
+
+        m_matrixTripleProduct = std::unique_ptr<sofa::simulation::ParallelSparseMatrixTripleProduct<
+            JT_Type, K_Type, J_Type, KJ_Type, JTKJ_Type>>(matrixTripleProduct);
+
+        matrixTripleProduct->taskScheduler = taskScheduler;
     }
     else
     {
@@ -73,6 +85,9 @@ void ConstantSparsityProjectionMethod<TMatrix>::init()
 
         m_matrixProductJTKJ = std::make_unique<sofa::linearalgebra::SparseMatrixProduct<
             JT_Type, KJ_Type, JTKJ_Type>>();
+
+        m_matrixTripleProduct = std::make_unique<sofa::linearalgebra::SparseMatrixTripleProduct<
+            JT_Type, K_Type, J_Type, KJ_Type, JTKJ_Type>>();
     }
 }
 
@@ -84,6 +99,7 @@ void ConstantSparsityProjectionMethod<TMatrix>::reinit()
     //cached products are invalidated
     m_matrixProductKJ->invalidateIntersection();
     m_matrixProductJTKJ->invalidateIntersection();
+    m_matrixTripleProduct->invalidateIntersection();
 }
 
 template <class TMatrix>
@@ -96,12 +112,23 @@ void ConstantSparsityProjectionMethod<TMatrix>::computeProjection(
     {
         const auto JMap0 = this->makeEigenMap(*J[0]);
         const auto JMap1 = this->makeEigenMap(*J[1]);
+        const JT_Type JMap0T = JMap0.transpose();
+
+        if (d_fusedProduct.getValue())
+        {
+            m_matrixTripleProduct->m_a = &JMap0T;
+            m_matrixTripleProduct->m_b = &KMap;
+            m_matrixTripleProduct->m_c = &JMap1;
+            m_matrixTripleProduct->computeProduct();
+
+            JT_K_J = m_matrixTripleProduct->getProductResult();
+            return;
+        }
 
         m_matrixProductKJ->m_lhs = &KMap;
         m_matrixProductKJ->m_rhs = &JMap1;
         m_matrixProductKJ->computeProduct();
 
-        const JT_Type JMap0T = JMap0.transpose();
         m_matrixProductJTKJ->m_lhs = &JMap0T;
         m_matrixProductJTKJ->m_rhs = &m_matrixProductKJ->getProductResult();
         m_matrixProductJTKJ->computeProduct();
@@ -26,4 +26,8 @@
 namespace sofa::component::linearsystem
 {
 template struct SOFA_COMPONENT_LINEARSYSTEM_API MappedMassMatrixObserver<SReal>;
+#ifndef SOFA_FLOAT
+// used by the linear systems of matrices stored in single precision
+template struct SOFA_COMPONENT_LINEARSYSTEM_API MappedMassMatrixObserver<float>;
+#endif
 }
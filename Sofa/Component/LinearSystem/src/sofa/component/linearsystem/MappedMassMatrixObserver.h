@@ -74,6 +74,9 @@ protected:
 
 #if !defined(SOFA_COMPONENT_LINEARSYSTEM_MAPPEDMASSMATRIXOBSERVER_CPP)
 extern template struct SOFA_COMPONENT_LINEARSYSTEM_API MappedMassMatrixObserver<SReal>;
+#ifndef SOFA_FLOAT
+extern template struct SOFA_COMPONENT_LINEARSYSTEM_API MappedMassMatrixObserver<float>;
+#endif
 #endif
 
 }
@@ -45,6 +45,7 @@ template class SOFA_COMPONENT_LINEARSYSTEM_API MatrixLinearSystem< CompressedRow
 template class SOFA_COMPONENT_LINEARSYSTEM_API MatrixLinearSystem< CompressedRowSparseMatrix<type::Mat<4,4,SReal> >, FullVector<SReal> >;
 template class SOFA_COMPONENT_LINEARSYSTEM_API MatrixLinearSystem< CompressedRowSparseMatrix<type::Mat<6,6,SReal> >, FullVector<SReal> >;
 template class SOFA_COMPONENT_LINEARSYSTEM_API MatrixLinearSystem< CompressedRowSparseMatrix<type::Mat<8,8,SReal> >, FullVector<SReal> >;
+template class SOFA_COMPONENT_LINEARSYSTEM_API MatrixLinearSystem< CompressedRowSparseMatrix<type::Mat<3,3,float> >, FullVector<double> >;
 template class SOFA_COMPONENT_LINEARSYSTEM_API MatrixLinearSystem< DiagonalMatrix<SReal>, FullVector<SReal> >;
 template class SOFA_COMPONENT_LINEARSYSTEM_API MatrixLinearSystem< BlockDiagonalMatrix<3,SReal>, FullVector<SReal> >;
 template class SOFA_COMPONENT_LINEARSYSTEM_API MatrixLinearSystem< RotationMatrix<SReal>, FullVector<SReal> >;
@@ -60,6 +61,13 @@ void registerMatrixLinearSystem(sofa::core::ObjectFactory* factory)
         .add<MatrixLinearSystem< CompressedRowSparseMatrix<type::Mat<4, 4, SReal> >, FullVector<SReal> > >()
         .add<MatrixLinearSystem< CompressedRowSparseMatrix<type::Mat<6, 6, SReal> >, FullVector<SReal> > >()
         .add<MatrixLinearSystem< CompressedRowSparseMatrix<type::Mat<8, 8, SReal> >, FullVector<SReal> > >());
+
+#ifndef SOFA_FLOAT
+    // Matrix stored in single precision with vectors in double precision. With SReal=float, its template
+    // name is the one of CompressedRowSparseMatrix<type::Mat<3, 3, SReal> > registered above.
+    factory->registerObjects(core::ObjectRegistrationData("")
+        .add<MatrixLinearSystem< CompressedRowSparseMatrix<type::Mat<3, 3, float> >, FullVector<double> > >());
+#endif
 }
 
 } //namespace sofa::component::linearsystem
@@ -26,6 +26,10 @@
 namespace sofa::component::linearsystem
 {
 template class SOFA_COMPONENT_LINEARSYSTEM_API MatrixProjectionMethod<sofa::linearalgebra::CompressedRowSparseMatrix<SReal> >;
+#ifndef SOFA_FLOAT
+// used by the linear systems of matrices stored in single precision
+template class SOFA_COMPONENT_LINEARSYSTEM_API MatrixProjectionMethod<sofa::linearalgebra::CompressedRowSparseMatrix<float> >;
+#endif
 
 void registerMatrixProjectionMethod(sofa::core::ObjectFactory* factory)
 {
@@ -41,6 +41,7 @@ template class SOFA_COMPONENT_LINEARSYSTEM_API TypedMatrixLinearSystem< Compress
 template class SOFA_COMPONENT_LINEARSYSTEM_API TypedMatrixLinearSystem< CompressedRowSparseMatrix<type::Mat<2,2,float> >, FullVector<float> >;
 template class SOFA_COMPONENT_LINEARSYSTEM_API TypedMatrixLinearSystem< CompressedRowSparseMatrix<type::Mat<3,3,double> >, FullVector<double> >;
 template class SOFA_COMPONENT_LINEARSYSTEM_API TypedMatrixLinearSystem< CompressedRowSparseMatrix<type::Mat<3,3,float> >, FullVector<float> >;
+template class SOFA_COMPONENT_LINEARSYSTEM_API TypedMatrixLinearSystem< CompressedRowSparseMatrix<type::Mat<3,3,float> >, FullVector<double> >;
 template class SOFA_COMPONENT_LINEARSYSTEM_API TypedMatrixLinearSystem< CompressedRowSparseMatrix<type::Mat<4,4,double> >, FullVector<double> >;
 template class SOFA_COMPONENT_LINEARSYSTEM_API TypedMatrixLinearSystem< CompressedRowSparseMatrix<type::Mat<4,4,float> >, FullVector<float> >;
 template class SOFA_COMPONENT_LINEARSYSTEM_API TypedMatrixLinearSystem< CompressedRowSparseMatrix<type::Mat<6,6,double> >, FullVector<double> >;
@@ -0,0 +1,198 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/testing/BaseSimulationTest.h>
+using sofa::testing::BaseSimulationTest;
+
+#include <sofa/component/statecontainer/MechanicalObject.h>
+#include <sofa/component/mechanicalload/ConstantForceField.h>
+#include <sofa/component/solidmechanics/spring/SpringForceField.h>
+#include <sofa/simulation/mechanicalvisitor/MechanicalComputeDfVisitor.h>
+#include <sofa/simulation/mechanicalvisitor/MechanicalComputeForceVisitor.h>
+#include <sofa/simulation/mechanicalvisitor/MechanicalResetForceVisitor.h>
+#include <sofa/simulation/Simulation.h>
+#include <sofa/simulation/Node.h>
+#include <sofa/core/MechanicalParams.h>
+#include <sofa/testing/ScopedTaskScheduler.h>
+
+namespace
+{
+
+using namespace sofa;
+using sofa::defaulttype::Vec3Types;
+
+/// The forces and the force differentials computed in parallel must be the same as the ones computed sequentially
+struct ParallelForceAccumulation_test : public BaseSimulationTest
+{
+    using MechanicalObject = component::statecontainer::MechanicalObject<Vec3Types>;
+    using ConstantForceField = component::mechanicalload::ConstantForceField<Vec3Types>;
+    using SpringForceField = component::solidmechanics::spring::SpringForceField<Vec3Types>;
+    using VecDeriv = Vec3Types::VecDeriv;
+
+    /// Forces and force differentials of the two states
+    struct Forces
+    {
+        VecDeriv f;
+        VecDeriv otherF;
+        VecDeriv df;
+        VecDeriv otherDf;
+    };
+
+    simulation::Node::SPtr m_root;
+    MechanicalObject::SPtr m_mstate;
+    MechanicalObject::SPtr m_otherMstate;
+
+    void doSetUp() override
+    {
+        this->loadPlugins({
+            Sofa.Component.StateContainer,
+            Sofa.Component.MechanicalLoad,
+            Sofa.Component.SolidMechanics.Spring
+        });
+
+        m_root = simulation::getSimulation()->createNewGraph("root");
+        m_mstate = createState(m_root.get(), 6);
+        m_otherMstate = createState(m_root->createChild("other").get(), 3);
+
+        // force fields computed in the same node: constant forces, springs between the points of the state of the
+        // node, and springs between this state and the state of the child node
+        for (unsigned int i = 0; i < 3; ++i)
+        {
+            const ConstantForceField::SPtr forceField = core::objectmodel::New<ConstantForceField>();
+            forceField->d_totalForce.setValue(Vec3Types::Deriv(1.0 + i, 0.1 * i, -0.7 / (1.0 + i)));
+            m_root->addObject(forceField);
+        }
+
+        const auto springs = core::objectmodel::New<SpringForceField>(m_mstate.get(), m_mstate.get());
+        for (unsigned int i = 0; i + 1 < 6; ++i)
+        {
+            springs->addSpring(i, i + 1, 10.0 + i, 0.3, 0.5);
+        }
+        m_root->addObject(springs);
+
+        const auto interactionSprings = core::objectmodel::New<SpringForceField>(m_mstate.get(), m_otherMstate.get());
+        for (unsigned int i = 0; i < 6; ++i)
+        {
+            interactionSprings->addSpring(i, i % 3, 7.0 + 2 * i, 0.2, 1.5);
+        }
+        m_root->addObject(interactionSprings);
+
+        sofa::simulation::node::initRoot(m_root.get());
+    }
+
+    static MechanicalObject::SPtr createState(simulation::Node* node, unsigned int nbPoints)
+    {
+        const MechanicalObject::SPtr mstate = core::objectmodel::New<MechanicalObject>();
+        mstate->resize(nbPoints);
+        {
+            auto x = sofa::helper::getWriteAccessor(*mstate->write(core::vec_id::write_access::position));
+            auto v = sofa::helper::getWriteAccessor(*mstate->write(core::vec_id::write_access::velocity));
+            auto dx = sofa::helper::getWriteAccessor(*mstate->write(core::vec_id::write_access::dx));
+            dx.resize(nbPoints);
+            for (unsigned int i = 0; i < nbPoints; ++i)
+            {
+                x[i] = Vec3Types::Coord(i + 0.1 * nbPoints, 0.3 * i * i, -0.2 * i);
+                v[i] = Vec3Types::Deriv(0.1, -0.05 * i, 0.02 * i * i);
+                dx[i] = Vec3Types::Deriv(0.01 * i, 0.02, -0.03 * nbPoints);
+            }
+        }
+        node->addObject(mstate);
+        return mstate;
+    }
+
+    void doTearDown() override
+    {
+        sofa::simulation::node::unload(m_root);
+    }
+
+    /// @param nbThreads number of threads of the task scheduler, 0 to compute the force fields sequentially
+    Forces computeForces(unsigned int nbThreads)
+    {
+        const sofa::testing::ScopedTaskScheduler taskScheduler(std::max(nbThreads, 1u));
+
+        // the request of the parallel computation is kept by the mechanical parameters built from the parameters
+        core::ExecParams params;
+        params.setParallelForceFields(nbThreads > 0);
+        core::MechanicalParams mparams(params);
+        EXPECT_EQ(mparams.parallelForceFields(), nbThreads > 0);
+        mparams.setKFactor(1.0);
+        mparams.setBFactor(0.1);
+
+        simulation::mechanicalvisitor::MechanicalResetForceVisitor(&mparams, core::vec_id::write_access::force).execute(m_root.get());
+        simulation::mechanicalvisitor::MechanicalComputeForceVisitor(&mparams, core::vec_id::write_access::force).execute(m_root.get());
+
+        simulation::mechanicalvisitor::MechanicalResetForceVisitor(&mparams, core::vec_id::write_access::dforce).execute(m_root.get());
+        simulation::mechanicalvisitor::MechanicalComputeDfVisitor(&mparams, core::vec_id::write_access::dforce).execute(m_root.get());
+
+        return {
+            m_mstate->read(core::vec_id::read_access::force)->getValue(),
+            m_otherMstate->read(core::vec_id::read_access::force)->getValue(),
+            m_mstate->read(core::vec_id::read_access::dforce)->getValue(),
+            m_otherMstate->read(core::vec_id::read_access::dforce)->getValue()
+        };
+    }
+
+    /// The forces are added in a different order, so they may differ by rounding errors
+    static void expectNear(const VecDeriv& parallel, const VecDeriv& sequential, const std::string& name)
+    {
+        ASSERT_EQ(parallel.size(), sequential.size()) << name;
+        for (std::size_t i = 0; i < sequential.size(); ++i)
+        {
+            EXPECT_LT((parallel[i] - sequential[i]).norm(), 1e-12 * (1 + sequential[i].norm())) << name << " at point " << i;
+        }
+    }
+};
+
+TEST_F(ParallelForceAccumulation_test, sameForces)
+{
+    const Forces sequential = computeForces(0);
+    ASSERT_EQ(sequential.f.size(), 6);
+    ASSERT_EQ(sequential.otherF.size(), 3);
+    EXPECT_GT(sequential.f[0].norm(), 0.0);
+    EXPECT_GT(sequential.otherF[0].norm(), 0.0);
+    ASSERT_EQ(sequential.df.size(), 6);
+    ASSERT_EQ(sequential.otherDf.size(), 3);
+    EXPECT_GT(sequential.df[1].norm(), 0.0);
+    EXPECT_GT(sequential.otherDf[1].norm(), 0.0);
+
+    // the temporary vectors are reused from an accumulation to another
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+        const Forces parallel = computeForces(4);
+        expectNear(parallel.f, sequential.f, "force");
+        expectNear(parallel.otherF, sequential.otherF, "force of the other state");
+        expectNear(parallel.df, sequential.df, "dforce");
+        expectNear(parallel.otherDf, sequential.otherDf, "dforce of the other state");
+    }
+}
+
+/// The force fields are accumulated in their order, whatever the number of threads
+TEST_F(ParallelForceAccumulation_test, independentOfNumberOfThreads)
+{
+    const Forces forces2 = computeForces(2);
+    const Forces forces4 = computeForces(4);
+    EXPECT_EQ(forces2.f, forces4.f);
+    EXPECT_EQ(forces2.otherF, forces4.otherF);
+    EXPECT_EQ(forces2.df, forces4.df);
+    EXPECT_EQ(forces2.otherDf, forces4.otherDf);
+}
+
+}
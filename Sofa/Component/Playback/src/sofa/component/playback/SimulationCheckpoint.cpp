@@ -0,0 +1,440 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/component/playback/SimulationCheckpoint.h>
+#include <sofa/core/ObjectFactory.h>
+#include <sofa/core/behavior/BaseMechanicalState.h>
+#include <sofa/core/behavior/ConstraintSolver.h>
+#include <sofa/core/behavior/LinearSolver.h>
+#include <sofa/defaulttype/AbstractTypeInfo.h>
+#include <sofa/helper/ScopedAdvancedTimer.h>
+#include <sofa/simulation/AnimateEndEvent.h>
+#include <sofa/simulation/Node.h>
+#include <sofa/simulation/events/SimulationInitDoneEvent.h>
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <unordered_map>
+
+namespace sofa::component::playback
+{
+
+namespace
+{
+
+constexpr char checkpointMagic[8] = { 'S', 'O', 'F', 'A', 'C', 'K', 'P', 'T' };
+constexpr std::uint32_t checkpointVersion = 2;
+
+/// A Data is either stored as a raw memory block, or as its string value
+enum class DataEncoding : std::uint8_t
+{
+    Raw = 0,
+    Text = 1
+};
+
+/// Marker used for components which are not states
+constexpr std::uint64_t noStateSize = std::numeric_limits<std::uint64_t>::max();
+
+template<class T>
+void writePOD(std::ostream& out, const T& value)
+{
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template<class T>
+bool readPOD(std::istream& in, T& value)
+{
+    in.read(reinterpret_cast<char*>(&value), sizeof(T));
+    return static_cast<bool>(in);
+}
+
+void writeString(std::ostream& out, const std::string& str)
+{
+    writePOD(out, static_cast<std::uint64_t>(str.size()));
+    out.write(str.data(), static_cast<std::streamsize>(str.size()));
+}
+
+bool readString(std::istream& in, std::string& str)
+{
+    std::uint64_t size {};
+    if (!readPOD(in, size))
+        return false;
+    str.resize(size);
+    in.read(str.data(), static_cast<std::streamsize>(size));
+    return static_cast<bool>(in);
+}
+
+/// Data whose values can be copied with a memcpy: containers of fixed-size numeric values
+bool hasRawLayout(const defaulttype::AbstractTypeInfo* typeInfo)
+{
+    return typeInfo->ValidInfo() && typeInfo->SimpleLayout() && !typeInfo->Text()
+        && typeInfo->BaseType()->FixedSize() && typeInfo->ValueType()->SimpleCopy();
+}
+
+/// The Data saved in a checkpoint: the persistent containers which are not linked to another Data
+bool isCheckpointed(const core::objectmodel::BaseData* data)
+{
+    if (!data->isPersistent() || data->getParent() != nullptr)
+        return false;
+    const defaulttype::AbstractTypeInfo* typeInfo = data->getValueTypeInfo();
+    return typeInfo != nullptr && typeInfo->ValidInfo() && typeInfo->Container();
+}
+
+void writeData(std::ostream& out, const core::objectmodel::BaseData* data)
+{
+    writeString(out, data->getName());
+
+    const defaulttype::AbstractTypeInfo* typeInfo = data->getValueTypeInfo();
+    const void* value = data->getValueVoidPtr();
+    const std::uint64_t nbValues = typeInfo->size(value);
+    const void* rawPtr = hasRawLayout(typeInfo) ? typeInfo->getValuePtr(value) : nullptr;
+
+    if (rawPtr != nullptr || (hasRawLayout(typeInfo) && nbValues == 0))
+    {
+        const std::uint32_t valueSize = typeInfo->byteSize();
+        writePOD(out, DataEncoding::Raw);
+        writePOD(out, valueSize);
+        writePOD(out, nbValues);
+        out.write(static_cast<const char*>(rawPtr), static_cast<std::streamsize>(nbValues * valueSize));
+    }
+    else
+    {
+        writePOD(out, DataEncoding::Text);
+        writeString(out, data->getValueString());
+    }
+}
+
+/// Read the next Data record into @p data, or skip it if @p data is null
+bool readData(std::istream& in, core::objectmodel::BaseData* data, std::string& buffer)
+{
+    DataEncoding encoding {};
+    if (!readPOD(in, encoding))
+        return false;
+
+    if (encoding == DataEncoding::Text)
+    {
+        if (!readString(in, buffer))
+            return false;
+        if (data)
+            data->read(buffer);
+        return true;
+    }
+
+    std::uint32_t valueSize {};
+    std::uint64_t nbValues {};
+    if (!readPOD(in, valueSize) || !readPOD(in, nbValues))
+        return false;
+    const auto nbBytes = static_cast<std::streamsize>(nbValues * valueSize);
+
+    const defaulttype::AbstractTypeInfo* typeInfo = data ? data->getValueTypeInfo() : nullptr;
+    if (!typeInfo || !hasRawLayout(typeInfo) || typeInfo->byteSize() != valueSize)
+    {
+        if (data)
+        {
+            msg_warning(data->getOwner()) << "Data '" << data->getName()
+                << "' does not match the type stored in the checkpoint: it is not restored.";
+        }
+        in.ignore(nbBytes);
+        return static_cast<bool>(in);
+    }
+
+    // the values are read directly into the Data memory
+    void* value = data->beginEditVoidPtr();
+    typeInfo->setSize(value, static_cast<sofa::Size>(nbValues));
+    if (typeInfo->size(value) == nbValues)
+    {
+        if (nbBytes > 0)
+            in.read(static_cast<char*>(typeInfo->getValuePtr(value)), nbBytes);
+    }
+    else
+    {
+        msg_warning(data->getOwner()) << "Data '" << data->getName()
+            << "' cannot be resized to the size stored in the checkpoint: it is not restored.";
+        in.ignore(nbBytes);
+    }
+    data->endEditVoidPtr();
+    return static_cast<bool>(in);
+}
+
+} // anonymous namespace
+
+bool writeCheckpoint(simulation::Node* root, std::ostream& out)
+{
+    if (!root)
+        return false;
+
+    SCOPED_TIMER("writeCheckpoint");
+
+    std::vector<core::objectmodel::BaseObject*> objects;
+    root->getTreeObjects<core::objectmodel::BaseObject>(&objects);
+
+    out.write(checkpointMagic, sizeof(checkpointMagic));
+    writePOD(out, checkpointVersion);
+    writePOD(out, static_cast<double>(root->getTime()));
+    writePOD(out, static_cast<std::uint64_t>(objects.size()));
+
+    std::vector<const core::objectmodel::BaseData*> datas;
+    for (const core::objectmodel::BaseObject* object : objects)
+    {
+        writeString(out, object->getPathName());
+
+        const auto* state = dynamic_cast<const core::BaseState*>(object);
+        writePOD(out, state ? static_cast<std::uint64_t>(state->getSize()) : noStateSize);
+
+        datas.clear();
+        if (!dynamic_cast<const SimulationCheckpoint*>(object))
+        {
+            for (const core::objectmodel::BaseData* data : object->getDataFields())
+            {
+                if (isCheckpointed(data))
+                    datas.push_back(data);
+            }
+        }
+
+        writePOD(out, static_cast<std::uint64_t>(datas.size()));
+        for (const core::objectmodel::BaseData* data : datas)
+        {
+            writeData(out, data);
+        }
+
+        // internal state of the solvers, such as the warm start of the constraint solvers, empty for the others
+        std::ostringstream solverState;
+        if (const auto* constraintSolver = dynamic_cast<const core::behavior::ConstraintSolver*>(object))
+        {
+            constraintSolver->writeWarmStart(solverState);
+        }
+        writeString(out, solverState.str());
+    }
+
+    return static_cast<bool>(out);
+}
+
+bool readCheckpoint(simulation::Node* root, std::istream& in)
+{
+    if (!root)
+        return false;
+
+    SCOPED_TIMER("readCheckpoint");
+
+    char magic[sizeof(checkpointMagic)] {};
+    in.read(magic, sizeof(magic));
+    std::uint32_t version {};
+    if (!in || std::memcmp(magic, checkpointMagic, sizeof(magic)) != 0 || !readPOD(in, version))
+    {
+        msg_error(root) << "Invalid checkpoint: wrong file signature";
+        return false;
+    }
+    if (version != checkpointVersion)
+    {
+        msg_error(root) << "Unsupported checkpoint version " << version << " (expected " << checkpointVersion << ")";
+        return false;
+    }
+
+    double time {};
+    std::uint64_t nbObjects {};
+    if (!readPOD(in, time) || !readPOD(in, nbObjects))
+        return false;
+
+    std::unordered_map<std::string, core::objectmodel::BaseObject*> objectsByPath;
+    for (core::objectmodel::BaseObject* object : root->getTreeObjects<core::objectmodel::BaseObject>())
+    {
+        objectsByPath.emplace(object->getPathName(), object);
+    }
+
+    std::string path, dataName, buffer, solverState;
+    sofa::Size nbSkipped = 0;
+    for (std::uint64_t i = 0; i < nbObjects; ++i)
+    {
+        std::uint64_t stateSize {}, nbDatas {};
+        if (!readString(in, path) || !readPOD(in, stateSize) || !readPOD(in, nbDatas))
+        {
+            msg_error(root) << "Invalid checkpoint: unexpected end of stream";
+            return false;
+        }
+
+        const auto it = objectsByPath.find(path);
+        core::objectmodel::BaseObject* object = it != objectsByPath.end() ? it->second : nullptr;
+        if (!object)
+        {
+            ++nbSkipped;
+        }
+
+        // states are resized first, so that all their vectors stay consistent
+        if (auto* state = dynamic_cast<core::BaseState*>(object);
+            state && stateSize != noStateSize && state->getSize() != stateSize)
+        {
+            state->resize(static_cast<sofa::Size>(stateSize));
+        }
+
+        for (std::uint64_t j = 0; j < nbDatas; ++j)
+        {
+            if (!readString(in, dataName))
+                return false;
+
+            core::objectmodel::BaseData* data = object ? object->findData(dataName) : nullptr;
+            if (object && !data)
+            {
+                ++nbSkipped;
+            }
+            if (!readData(in, data, buffer))
+            {
+                msg_error(root) << "Invalid checkpoint: unexpected end of stream";
+                return false;
+            }
+        }
+
+        if (!readString(in, solverState))
+        {
+            msg_error(root) << "Invalid checkpoint: unexpected end of stream";
+            return false;
+        }
+        if (auto* constraintSolver = dynamic_cast<core::behavior::ConstraintSolver*>(object);
+            constraintSolver && !solverState.empty())
+        {
+            std::istringstream solverStateStream(solverState);
+            msg_warning_when(!constraintSolver->readWarmStart(solverStateStream), constraintSolver)
+                << "The warm start stored in the checkpoint cannot be restored: the next constraint resolution starts from other forces.";
+        }
+    }
+
+    // the factorizations computed before the restore do not correspond to the restored state
+    for (auto* linearSolver : root->getTreeObjects<core::behavior::LinearSolver>())
+    {
+        linearSolver->requestRefactorization();
+    }
+
+    msg_warning_when(nbSkipped > 0, root) << nbSkipped << " checkpoint entries do not match any component "
+        "or Data in the current graph and have been skipped";
+
+    root->setTime(time);
+    return true;
+}
+
+bool saveCheckpoint(simulation::Node* root, const std::string& filename)
+{
+    std::ofstream out(filename, std::ios::binary);
+    if (!out.is_open())
+    {
+        msg_error("SimulationCheckpoint") << "Cannot create checkpoint file " << filename;
+        return false;
+    }
+    return writeCheckpoint(root, out);
+}
+
+bool loadCheckpoint(simulation::Node* root, const std::string& filename)
+{
+    std::ifstream in(filename, std::ios::binary);
+    if (!in.is_open())
+    {
+        msg_error("SimulationCheckpoint") << "Cannot open checkpoint file " << filename;
+        return false;
+    }
+    return readCheckpoint(root, in);
+}
+
+void registerSimulationCheckpoint(sofa::core::ObjectFactory* factory)
+{
+    factory->registerObjects(core::ObjectRegistrationData("Save and restore the whole simulation state to/from a binary checkpoint file.")
+        .add< SimulationCheckpoint >());
+}
+
+SimulationCheckpoint::SimulationCheckpoint()
+    : d_filename(initData(&d_filename, "filename", "checkpoint file name"))
+    , d_restoreAtInit(initData(&d_restoreAtInit, false, "restoreAtInit", "restore the checkpoint file once the scene is initialized"))
+    , d_time(initData(&d_time, type::vector<double>(0), "time", "set time to write the checkpoint"))
+    , d_period(initData(&d_period, 0.0, "period", "period between checkpoints after the last time instant (0 to disable)"))
+{
+    this->f_listening.setValue(true);
+}
+
+void SimulationCheckpoint::init()
+{
+    if (!d_filename.isSet())
+    {
+        msg_warning() << "a filename must be specified to save or restore a checkpoint";
+    }
+    msg_warning_when(this->getContext() != this->getContext()->getRootContext())
+        << "this component should be placed in the root node to save the whole simulation";
+
+    reset();
+}
+
+void SimulationCheckpoint::reset()
+{
+    m_nextTime = 0;
+    m_lastTime = 0.0;
+}
+
+bool SimulationCheckpoint::save()
+{
+    auto* root = dynamic_cast<simulation::Node*>(this->getContext()->getRootContext());
+    const bool success = saveCheckpoint(root, d_filename.getFullPath());
+    msg_info_when(success) << "checkpoint written to " << d_filename.getFullPath() << " at time " << this->getTime();
+    return success;
+}
+
+bool SimulationCheckpoint::restore()
+{
+    auto* root = dynamic_cast<simulation::Node*>(this->getContext()->getRootContext());
+    const bool success = loadCheckpoint(root, d_filename.getFullPath());
+    msg_info_when(success) << "checkpoint restored from " << d_filename.getFullPath() << " at time " << this->getTime();
+    return success;
+}
+
+void SimulationCheckpoint::handleEvent(sofa::core::objectmodel::Event* event)
+{
+    if (simulation::SimulationInitDoneEvent::checkEventType(event))
+    {
+        if (d_restoreAtInit.getValue())
+        {
+            restore();
+        }
+    }
+    else if (simulation::AnimateEndEvent::checkEventType(event))
+    {
+        const double time = this->getTime();
+        const double halfDt = 0.5 * this->getContext()->getDt();
+        const auto& times = d_time.getValue();
+
+        bool mustSave = false;
+        while (m_nextTime < times.size() && times[m_nextTime] <= time + halfDt)
+        {
+            mustSave = true;
+            m_lastTime = times[m_nextTime++];
+        }
+        const double period = d_period.getValue();
+        if (!mustSave && period > 0 && m_nextTime == times.size() && m_lastTime + period <= time + halfDt)
+        {
+            mustSave = true;
+            m_lastTime += period;
+        }
+
+        if (mustSave)
+        {
+            save();
+        }
+    }
+}
+
+} // namespace sofa::component::playback
@@ -0,0 +1,95 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+#include <sofa/component/playback/config.h>
+
+#include <sofa/core/objectmodel/BaseObject.h>
+#include <sofa/core/objectmodel/DataFileName.h>
+#include <sofa/simulation/fwd.h>
+
+#include <iosfwd>
+
+namespace sofa::component::playback
+{
+
+/// Write a binary checkpoint of the dynamic state of the graph rooted at @p root.
+///
+/// The checkpoint contains the animation time and, for every component of the graph,
+/// the content of its persistent, non-linked container Data: the MechanicalObject vectors,
+/// the topology arrays and the TopologyData are saved this way. Data with a simple memory
+/// layout are written as raw blocks, the other ones fall back on their string value.
+/// The warm start of the constraint solvers is saved too, so that the steps following a
+/// restore give the same results as the steps following the checkpoint.
+/// Returns false if the stream could not be written.
+SOFA_COMPONENT_PLAYBACK_API bool writeCheckpoint(simulation::Node* root, std::ostream& out);
+
+/// Restore a checkpoint written by writeCheckpoint onto the graph rooted at @p root.
+///
+/// Components are matched by their path in the graph and Data by their name, so the graph
+/// is expected to be loaded from the same scene as the one used to write the checkpoint.
+/// Entries which do not match any component or Data are skipped with a warning.
+/// The linear solvers of the graph are asked to factorize their system again at the next step,
+/// as their factorization was computed for the state before the restore.
+/// Returns false if the stream is not a valid checkpoint.
+SOFA_COMPONENT_PLAYBACK_API bool readCheckpoint(simulation::Node* root, std::istream& in);
+
+/// Same as writeCheckpoint, to the file @p filename
+SOFA_COMPONENT_PLAYBACK_API bool saveCheckpoint(simulation::Node* root, const std::string& filename);
+
+/// Same as readCheckpoint, from the file @p filename
+SOFA_COMPONENT_PLAYBACK_API bool loadCheckpoint(simulation::Node* root, const std::string& filename);
+
+/** Save and restore the whole simulation state to/from a binary checkpoint file.
+ *
+ * When restoreAtInit is enabled, the checkpoint is loaded once the scene is initialized, which allows
+ * a freshly loaded scene to skip its settling steps. The checkpoint is written at the given time
+ * instants (and periodically after the last one if a period is set), or on demand with save().
+ * The component must be placed in the root node so that the whole graph is covered.
+ */
+class SOFA_COMPONENT_PLAYBACK_API SimulationCheckpoint : public core::objectmodel::BaseObject
+{
+public:
+    SOFA_CLASS(SimulationCheckpoint, core::objectmodel::BaseObject);
+
+    sofa::core::objectmodel::DataFileName d_filename; ///< checkpoint file name
+    Data<bool> d_restoreAtInit; ///< restore the checkpoint file once the scene is initialized
+    Data<type::vector<double> > d_time; ///< set time to write the checkpoint
+    Data<double> d_period; ///< period between checkpoints after the last time instant (0 to disable)
+
+    void init() override;
+    void reset() override;
+    void handleEvent(sofa::core::objectmodel::Event* event) override;
+
+    /// Write the checkpoint file now. Returns false in case of failure.
+    bool save();
+
+    /// Restore the checkpoint file now. Returns false in case of failure.
+    bool restore();
+
+protected:
+    SimulationCheckpoint();
+
+    std::size_t m_nextTime { 0 };
+    double m_lastTime { 0.0 };
+};
+
+} // namespace sofa::component::playback
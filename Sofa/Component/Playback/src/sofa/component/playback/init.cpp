@@ -31,6 +31,7 @@ extern void registerCompareTopology(sofa::core::ObjectFactory* factory);
 extern void registerInputEventReader(sofa::core::ObjectFactory* factory);
 extern void registerReadState(sofa::core::ObjectFactory* factory);
 extern void registerReadTopology(sofa::core::ObjectFactory* factory);
+extern void registerSimulationCheckpoint(sofa::core::ObjectFactory* factory);
 extern void registerWriteState(sofa::core::ObjectFactory* factory);
 extern void registerWriteTopology(sofa::core::ObjectFactory* factory);
 
@@ -63,6 +64,7 @@ void registerObjects(sofa::core::ObjectFactory* factory)
     registerInputEventReader(factory);
     registerReadState(factory);
     registerReadTopology(factory);
+    registerSimulationCheckpoint(factory);
     registerWriteState(factory);
     registerWriteTopology(factory);
 }
@@ -0,0 +1,221 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/testing/BaseSimulationTest.h>
+using sofa::testing::BaseSimulationTest;
+
+#include <sofa/simpleapi/SimpleApi.h>
+using sofa::simulation::Node;
+
+#include <sofa/component/playback/SimulationCheckpoint.h>
+#include <sofa/type/Vec.h>
+using sofa::type::Vec3;
+
+#include <sstream>
+#include <vector>
+
+class SimulationCheckpoint_test : public BaseSimulationTest
+{
+public:
+    Node::SPtr createScene()
+    {
+        const auto simulation = sofa::simpleapi::createSimulation();
+        const Node::SPtr root = sofa::simpleapi::createRootNode(simulation, "root");
+        sofa::simpleapi::createObject(root, "RequiredPlugin", { { "name",Sofa.Component.Playback } });
+        sofa::simpleapi::createObject(root, "RequiredPlugin", { { "name",Sofa.Component.StateContainer } });
+        sofa::simpleapi::createObject(root, "RequiredPlugin", { { "name",Sofa.Component.ODESolver.Backward } });
+        sofa::simpleapi::createObject(root, "RequiredPlugin", { { "name",Sofa.Component.LinearSolver.Iterative } });
+        sofa::simpleapi::createObject(root, "RequiredPlugin", { { "name",Sofa.Component.Mass } });
+
+        root->setGravity(Vec3(0.0, 0.0, -9.81));
+        root->setDt(0.01);
+
+        sofa::simpleapi::createObject(root, "EulerImplicitSolver");
+        sofa::simpleapi::createObject(root, "CGLinearSolver", { { "iterations", "25" }, { "tolerance", "1e-5" }, { "threshold", "1e-5" } });
+
+        const Node::SPtr childNode = sofa::simpleapi::createChild(root, "Particles");
+        sofa::simpleapi::createObject(childNode, "MechanicalObject", { { "name", "dofs" }, { "position", "0 0 0  1 0 0" } });
+        sofa::simpleapi::createObject(childNode, "UniformMass", { { "totalMass", "1" } });
+
+        sofa::simulation::node::initRoot(root.get());
+        return root;
+    }
+
+    /// A ball resting on a fixed sphere: the contact is solved by an LCPConstraintSolver using the forces of the
+    /// previous step as initial guess, and the ball by a direct linear solver
+    Node::SPtr createContactScene()
+    {
+        const auto simulation = sofa::simpleapi::createSimulation();
+        const Node::SPtr root = sofa::simpleapi::createRootNode(simulation, "root");
+        sofa::simpleapi::createObject(root, "RequiredPlugin", { { "name",Sofa.Component.Playback } });
+        sofa::simpleapi::createObject(root, "RequiredPlugin", { { "name",Sofa.Component.StateContainer } });
+        sofa::simpleapi::createObject(root, "RequiredPlugin", { { "name",Sofa.Component.ODESolver.Backward } });
+        sofa::simpleapi::createObject(root, "RequiredPlugin", { { "name",Sofa.Component.LinearSolver.Direct } });
+        sofa::simpleapi::createObject(root, "RequiredPlugin", { { "name",Sofa.Component.Mass } });
+        sofa::simpleapi::createObject(root, "RequiredPlugin", { { "name",Sofa.Component.AnimationLoop } });
+        sofa::simpleapi::createObject(root, "RequiredPlugin", { { "name",Sofa.Component.Constraint.Lagrangian.Solver } });
+        sofa::simpleapi::createObject(root, "RequiredPlugin", { { "name",Sofa.Component.Constraint.Lagrangian.Correction } });
+        sofa::simpleapi::createObject(root, "RequiredPlugin", { { "name",Sofa.Component.Collision.Geometry } });
+        sofa::simpleapi::createObject(root, "RequiredPlugin", { { "name",Sofa.Component.Collision.Detection.Algorithm } });
+        sofa::simpleapi::createObject(root, "RequiredPlugin", { { "name",Sofa.Component.Collision.Detection.Intersection } });
+        sofa::simpleapi::createObject(root, "RequiredPlugin", { { "name",Sofa.Component.Collision.Response.Contact } });
+
+        root->setGravity(Vec3(0.0, 0.0, -9.81));
+        root->setDt(0.01);
+
+        sofa::simpleapi::createObject(root, "FreeMotionAnimationLoop");
+        sofa::simpleapi::createObject(root, "LCPConstraintSolver", { { "maxIt", "1000" }, { "tolerance", "1e-3" }, { "initial_guess", "true" } });
+        sofa::simpleapi::createObject(root, "CollisionPipeline");
+        sofa::simpleapi::createObject(root, "BruteForceBroadPhase");
+        sofa::simpleapi::createObject(root, "BVHNarrowPhase");
+        sofa::simpleapi::createObject(root, "MinProximityIntersection", { { "alarmDistance", "0.3" }, { "contactDistance", "0.1" } });
+        sofa::simpleapi::createObject(root, "CollisionResponse", { { "response", "FrictionContactConstraint" } });
+
+        const Node::SPtr ball = sofa::simpleapi::createChild(root, "Ball");
+        sofa::simpleapi::createObject(ball, "EulerImplicitSolver");
+        sofa::simpleapi::createObject(ball, "SparseLDLSolver", { { "template", "CompressedRowSparseMatrixMat3x3" } });
+        sofa::simpleapi::createObject(ball, "MechanicalObject", { { "name", "dofs" }, { "position", "0 0 2.05" } });
+        sofa::simpleapi::createObject(ball, "UniformMass", { { "totalMass", "1" } });
+        sofa::simpleapi::createObject(ball, "SphereCollisionModel", { { "radius", "1" } });
+        sofa::simpleapi::createObject(ball, "LinearSolverConstraintCorrection");
+
+        const Node::SPtr obstacle = sofa::simpleapi::createChild(root, "Obstacle");
+        sofa::simpleapi::createObject(obstacle, "MechanicalObject", { { "position", "0 0 0" } });
+        sofa::simpleapi::createObject(obstacle, "SphereCollisionModel", { { "radius", "1" }, { "simulated", "false" }, { "moving", "false" } });
+
+        sofa::simulation::node::initRoot(root.get());
+        return root;
+    }
+
+    /// Save a checkpoint in the middle of a simulation, keep simulating, then come back to the checkpoint
+    void testRoundTrip()
+    {
+        const Node::SPtr root = createScene();
+        const auto dofs = root->getChild("Particles")->getObject("dofs");
+        ASSERT_NE(dofs, nullptr);
+
+        for (int i = 0; i < 5; i++)
+        {
+            sofa::simulation::node::animate(root.get(), 0.01);
+        }
+
+        std::stringstream checkpoint;
+        ASSERT_TRUE(sofa::component::playback::writeCheckpoint(root.get(), checkpoint));
+
+        const double savedTime = root->getTime();
+        const std::string savedPosition = dofs->findData("position")->getValueString();
+        const std::string savedVelocity = dofs->findData("velocity")->getValueString();
+
+        for (int i = 0; i < 5; i++)
+        {
+            sofa::simulation::node::animate(root.get(), 0.01);
+        }
+        ASSERT_NE(dofs->findData("position")->getValueString(), savedPosition);
+
+        ASSERT_TRUE(sofa::component::playback::readCheckpoint(root.get(), checkpoint));
+
+        EXPECT_DOUBLE_EQ(root->getTime(), savedTime);
+        EXPECT_EQ(dofs->findData("position")->getValueString(), savedPosition);
+        EXPECT_EQ(dofs->findData("velocity")->getValueString(), savedVelocity);
+    }
+
+    /// Restore a checkpoint written by another instance of the same scene
+    void testRestoreInFreshGraph()
+    {
+        std::stringstream checkpoint;
+        std::string savedPosition;
+        {
+            const Node::SPtr root = createScene();
+            for (int i = 0; i < 5; i++)
+            {
+                sofa::simulation::node::animate(root.get(), 0.01);
+            }
+            ASSERT_TRUE(sofa::component::playback::writeCheckpoint(root.get(), checkpoint));
+            savedPosition = root->getChild("Particles")->getObject("dofs")->findData("position")->getValueString();
+        }
+
+        const Node::SPtr root = createScene();
+        ASSERT_TRUE(sofa::component::playback::readCheckpoint(root.get(), checkpoint));
+        EXPECT_EQ(root->getChild("Particles")->getObject("dofs")->findData("position")->getValueString(), savedPosition);
+    }
+
+    /// The steps following a restored checkpoint are the same as the steps following the checkpoint in the
+    /// uninterrupted simulation, which requires the initial guess of the constraint solver to be restored and the
+    /// linear solver to be factorized again
+    void testRestoredStepsMatchUninterruptedRun()
+    {
+        const Node::SPtr root = createContactScene();
+        const auto position = root->getChild("Ball")->getObject("dofs")->findData("position");
+        ASSERT_NE(position, nullptr);
+
+        for (int i = 0; i < 20; i++)
+        {
+            sofa::simulation::node::animate(root.get(), 0.01);
+        }
+
+        std::stringstream checkpoint;
+        ASSERT_TRUE(sofa::component::playback::writeCheckpoint(root.get(), checkpoint));
+
+        std::vector<std::string> uninterruptedPositions;
+        for (int i = 0; i < 10; i++)
+        {
+            sofa::simulation::node::animate(root.get(), 0.01);
+            uninterruptedPositions.push_back(position->getValueString());
+        }
+
+        ASSERT_TRUE(sofa::component::playback::readCheckpoint(root.get(), checkpoint));
+
+        for (int i = 0; i < 10; i++)
+        {
+            sofa::simulation::node::animate(root.get(), 0.01);
+            EXPECT_EQ(position->getValueString(), uninterruptedPositions[i]) << "step " << i;
+        }
+    }
+
+    void testInvalidStream()
+    {
+        const Node::SPtr root = createScene();
+        std::stringstream checkpoint("not a checkpoint");
+
+        EXPECT_MSG_EMIT(Error);
+        EXPECT_FALSE(sofa::component::playback::readCheckpoint(root.get(), checkpoint));
+    }
+};
+
+TEST_F(SimulationCheckpoint_test, roundTrip)
+{
+    this->testRoundTrip();
+}
+
+TEST_F(SimulationCheckpoint_test, restoreInFreshGraph)
+{
+    this->testRestoreInFreshGraph();
+}
+
+TEST_F(SimulationCheckpoint_test, restoredStepsMatchUninterruptedRun)
+{
+    this->testRestoredStepsMatchUninterruptedRun();
+}
+
+TEST_F(SimulationCheckpoint_test, invalidStream)
+{
+    this->testInvalidStream();
+}
@@ -190,6 +190,9 @@ protected:
 public:
     bool insertInNode( objectmodel::BaseNode* node ) override;
     bool removeInNode( objectmodel::BaseNode* node ) override;
+
+    /// The init() of the mappings only reads their input and output states
+    bool isInitThreadSafe() const override { return true; }
 };
 
 } // namespace sofa::core
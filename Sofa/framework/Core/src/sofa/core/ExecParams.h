@@ -67,6 +67,9 @@ private:
 
     ExecParamsThreadStorage* storage;
 
+    /// Compute the force fields of a same node in parallel
+    bool m_parallelForceFields { false };
+
     ExecParams(ExecParamsThreadStorage* s)
         : storage(s)
     {
@@ -97,6 +100,9 @@ public:
     /// Number of threads currently known to Sofa
     int nbThreads() const { return g_nbThreads; }
 
+    /// Are the force fields of a same node computed in parallel by the force visitors
+    bool parallelForceFields() const { return m_parallelForceFields; }
+
     ExecParams()
         : storage(threadStorage())
     {
@@ -128,6 +134,13 @@ public:
         return *this;
     }
 
+    /// Request the force visitors to compute the force fields of a same node in parallel
+    ExecParams& setParallelForceFields(bool v)
+    {
+        m_parallelForceFields = v;
+        return *this;
+    }
+
 };
 } // namespace sofa::core
 
@@ -32,7 +32,12 @@ BaseAnimationLoop::BaseAnimationLoop()
     : l_node(initLink("targetNode","Link to the scene's node that will be processed by the loop"))
     , m_resetTime(0.)
     , d_computeBoundingBox(initData(&d_computeBoundingBox, !SOFA_NO_UPDATE_BBOX, "computeBoundingBox", "If true, compute the global bounding box of the scene at each time step. Used mostly for rendering."))
-{}
+    , d_parallelInit(initData(&d_parallelInit, false, "parallelInit", "If true, the nodes of the scene which do not depend on each other are initialized in parallel. "
+                                                                     "Two nodes depend on each other if one is the ancestor of the other, or if their components are connected by a Data or a Link. "
+                                                                     "The nodes containing a component which is not thread-safe at initialization are initialized sequentially."))
+{
+    d_parallelInit.setGroup("Multithreading");
+}
 
 BaseAnimationLoop::~BaseAnimationLoop()
 {}
@@ -80,6 +80,7 @@ public:
     bool removeInNode( objectmodel::BaseNode* node ) override;
 
     Data<bool> d_computeBoundingBox; ///< If true, compute the global bounding box of the scene at each time step. Used mostly for rendering.
+    Data<bool> d_parallelInit; ///< If true, the nodes of the scene which do not depend on each other are initialized in parallel
 
 };
 
@@ -222,6 +222,9 @@ public:
 
     bool insertInNode( objectmodel::BaseNode* node ) override;
     bool removeInNode( objectmodel::BaseNode* node ) override;
+
+    /// The init() of the force fields only reads their context and precomputes their own data
+    bool isInitThreadSafe() const override { return true; }
 };
 
 } // namespace sofa::core::behavior
@@ -39,6 +39,9 @@ public:
     bool insertInNode( objectmodel::BaseNode* node ) override;
     bool removeInNode( objectmodel::BaseNode* node ) override;
 
+    /// The init() of the linear solvers only reads their context and allocates their own matrices
+    bool isInitThreadSafe() const override { return true; }
+
 }; // class BaseLinearSolver
 
 } //namespace sofa::core::behavior
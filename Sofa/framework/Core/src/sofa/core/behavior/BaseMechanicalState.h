@@ -377,6 +377,9 @@ public:
     bool insertInNode( objectmodel::BaseNode* node ) override;
     bool removeInNode( objectmodel::BaseNode* node ) override;
 
+    /// The init() of the states only allocates their own vectors
+    bool isInitThreadSafe() const override { return true; }
+
 };
 
 } // namespace sofa::core::behavior
@@ -24,6 +24,8 @@
 #include <sofa/core/objectmodel/BaseObject.h>
 #include <sofa/core/behavior/BaseConstraintSet.h>
 
+#include <iosfwd>
+
 namespace sofa::core::behavior
 {
 
@@ -113,6 +115,14 @@ public:
     /// @param c is the ConstraintCorrection
     virtual void removeConstraintCorrection(BaseConstraintCorrection *s) = 0;
 
+    /// Write the data kept from a resolution to the next one to start from the previous solution (warm start)
+    /// Solvers without such data write nothing
+    virtual void writeWarmStart(std::ostream& /*out*/) const {}
+
+    /// Read the data written by writeWarmStart
+    /// @return false if the data cannot be read
+    virtual bool readWarmStart(std::istream& /*in*/) { return true; }
+
     bool insertInNode( objectmodel::BaseNode* node ) override;
     bool removeInNode( objectmodel::BaseNode* node ) override;
 
@@ -66,6 +66,10 @@ public:
     /// This function is use for the preconditioner it must be called at each time step event if setSystemMBKMatrix is not called
     virtual void updateSystemMatrix() {}
 
+    /// Discard the current factorization (or any data computed from the system matrix), so that it is computed again
+    /// at the next solve, for instance after the state of the simulation has been restored
+    virtual void requestRefactorization() {}
+
     /// Set the linear system right-hand term vector, from the values contained in the (Mechanical/Physical)State objects
     virtual void setSystemRHVector(core::MultiVecDerivId v) = 0;
 
@@ -124,6 +124,9 @@ public:
     bool insertInNode( objectmodel::BaseNode* node ) override;
     bool removeInNode( objectmodel::BaseNode* node ) override;
 
+    /// The init() of the ODE solvers only reads their context
+    bool isInitThreadSafe() const override { return true; }
+
 };
 
 } // namespace sofa::core::behavior
@@ -65,6 +65,12 @@ public:
      */
     virtual void removeContacts(const ContactVector& c) { SOFA_UNUSED(c); }
 
+    /// Return true if the responses of the active contacts can stay in the graph from one step to the next.
+    /// Otherwise, the collision pipeline removes all the responses before creating them again.
+    /// In createResponse, a contact only moves its response if its group changed, so that an active contact does
+    /// not modify the graph at each step.
+    virtual bool keepActiveResponses() const { return false; }
+
     /// virtual because subclasses might do precomputations based on intersection algorithms
     virtual void setIntersectionMethod(Intersection* v) { intersectionMethod = v;    }
     Intersection* getIntersectionMethod() const         { return intersectionMethod; }
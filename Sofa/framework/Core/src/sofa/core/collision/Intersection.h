@@ -76,7 +76,23 @@ public:
 
     /// Compute the intersection between 2 elements. Return the number of contacts written in the contacts vector.
     virtual int intersect(core::CollisionElementIterator elem1, core::CollisionElementIterator elem2, DetectionOutputVector* contacts, const core::collision::Intersection* currentIntersection) = 0;
-    
+
+    /// Pairs of indices of elements of two collision models
+    typedef sofa::type::vector< std::pair<sofa::Index, sofa::Index> > ElementPairs;
+
+    /// Compute the intersections between the given pairs of elements of model1 and model2, in their order.
+    /// Return the number of contacts written in the contacts vector.
+    /// The default implementation calls intersect for each pair, intersectors can test the pairs by batches.
+    virtual int intersectPairs(core::CollisionModel* model1, core::CollisionModel* model2, const ElementPairs& pairs, DetectionOutputVector* contacts, const core::collision::Intersection* currentIntersection)
+    {
+        int nbContacts = 0;
+        for (const auto& [index1, index2] : pairs)
+        {
+            nbContacts += intersect(core::CollisionElementIterator(model1, index1), core::CollisionElementIterator(model2, index2), contacts, currentIntersection);
+        }
+        return nbContacts;
+    }
+
     /// End intersection tests between two collision models. Return the number of contacts written in the contacts vector.
     virtual int endIntersect(core::CollisionModel* model1, core::CollisionModel* model2, DetectionOutputVector* contacts) = 0;
 
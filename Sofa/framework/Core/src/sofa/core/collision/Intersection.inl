@@ -71,6 +71,32 @@ public:
         return impl->computeIntersection(e1, e2, impl->getOutputVector(e1.getCollisionModel(), e2.getCollisionModel(), contacts), currentIntersection);
     }
 
+    /// Compute the intersections between pairs of elements.
+    /// The implementation can provide a computeIntersections method testing all the pairs of two models, otherwise
+    /// computeIntersection is called on each pair, without a virtual call per pair.
+    int intersectPairs(core::CollisionModel* model1, core::CollisionModel* model2, const ElementPairs& pairs, DetectionOutputVector* contacts, const core::collision::Intersection* currentIntersection) override
+    {
+        Model1* m1 = static_cast<Model1*>(model1);
+        Model2* m2 = static_cast<Model2*>(model2);
+        auto* outputs = impl->getOutputVector(m1, m2, contacts);
+
+        if constexpr (requires { impl->computeIntersections(m1, m2, pairs, outputs, currentIntersection); })
+        {
+            return impl->computeIntersections(m1, m2, pairs, outputs, currentIntersection);
+        }
+        else
+        {
+            int nbContacts = 0;
+            for (const auto& [index1, index2] : pairs)
+            {
+                Elem1 e1(core::CollisionElementIterator(m1, index1));
+                Elem2 e2(core::CollisionElementIterator(m2, index2));
+                nbContacts += impl->computeIntersection(e1, e2, outputs, currentIntersection);
+            }
+            return nbContacts;
+        }
+    }
+
     std::string name() const override
     {
         return sofa::helper::gettypename(typeid(Elem1))+std::string("-")+sofa::helper::gettypename(typeid(Elem2));
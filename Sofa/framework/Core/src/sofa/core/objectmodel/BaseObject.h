@@ -94,6 +94,12 @@ public:
     /// Initialization method called at graph creation and modification, during bottom-up traversal.
     virtual void bwdInit();
 
+    /// Specify whether init() can be called concurrently with the init() of components located in
+    /// independent subgraphs (see the parallelInit option of the animation loops).
+    /// False by default: only the base classes whose components are known not to modify the scene graph,
+    /// global registries or shared caches in init() opt in (states, force fields, mappings and solvers).
+    virtual bool isInitThreadSafe() const { return false; }
+
     /// Update method called when variables used in precomputation are modified.
     virtual void reinit();
 
@@ -0,0 +1,668 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#define SOFA_HELPER_BATCHEDDECOMPOSE_CPP
+#include <sofa/helper/BatchedDecompose.h>
+#include <sofa/helper/decompose.h>
+#include <sofa/helper/logging/Messaging.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define SOFA_HELPER_BATCHED_X86_DISPATCH
+#endif
+
+// The kernels are written once and inlined into entry points compiled for each instruction set
+#if defined(_MSC_VER)
+#define SOFA_HELPER_BATCHED_INLINE __forceinline
+#else
+#define SOFA_HELPER_BATCHED_INLINE inline __attribute__((always_inline))
+#endif
+
+namespace sofa::helper
+{
+
+namespace
+{
+
+/// Number of matrices processed together: the working arrays of a chunk remain in the L1 cache,
+/// and, being local, they do not alias, which lets the compiler vectorize the loops on the chunk.
+constexpr std::size_t ChunkSize = 64;
+
+template<Size N, class Real>
+struct Chunk
+{
+    alignas(64) Real e[N][ChunkSize];
+};
+
+template<class Real> using Mat3x3Chunk = Chunk<9, Real>;
+template<class Real> using Vec3Chunk = Chunk<3, Real>;
+
+/// Index of the entry (i,j) of a symmetric 3x3 matrix stored as (00, 01, 02, 11, 12, 22)
+template<Size I, Size J>
+constexpr Size sym()
+{
+    if constexpr (I > J) return sym<J, I>();
+    else return I == 0 ? J : I + J + 1;
+}
+
+template<class Real>
+SOFA_HELPER_BATCHED_INLINE void load(const Mat3x3Batch<Real>& M, std::size_t begin, std::size_t count, Mat3x3Chunk<Real>& chunk)
+{
+    for (Size k = 0; k < 9; ++k)
+    {
+        const Real* src = M.entry(k / 3, k % 3) + begin;
+        for (std::size_t l = 0; l < count; ++l)
+            chunk.e[k][l] = src[l];
+    }
+}
+
+template<class Real>
+SOFA_HELPER_BATCHED_INLINE void store(const Mat3x3Chunk<Real>& chunk, std::size_t begin, std::size_t count, Mat3x3Batch<Real>& M)
+{
+    for (Size k = 0; k < 9; ++k)
+    {
+        Real* dst = M.entry(k / 3, k % 3) + begin;
+        for (std::size_t l = 0; l < count; ++l)
+            dst[l] = chunk.e[k][l];
+    }
+}
+
+template<class Real>
+SOFA_HELPER_BATCHED_INLINE void load(const Vec3Batch<Real>& v, std::size_t begin, std::size_t count, Vec3Chunk<Real>& chunk)
+{
+    for (Size k = 0; k < 3; ++k)
+    {
+        const Real* src = v.coord(k) + begin;
+        for (std::size_t l = 0; l < count; ++l)
+            chunk.e[k][l] = src[l];
+    }
+}
+
+template<class Real>
+SOFA_HELPER_BATCHED_INLINE void store(const Vec3Chunk<Real>& chunk, std::size_t begin, std::size_t count, Vec3Batch<Real>& v)
+{
+    for (Size k = 0; k < 3; ++k)
+    {
+        Real* dst = v.coord(k) + begin;
+        for (std::size_t l = 0; l < count; ++l)
+            dst[l] = chunk.e[k][l];
+    }
+}
+
+/// Inverse of a norm, or 1 if the norm is too small to be inverted (same as Vec::normalize)
+template<class Real>
+SOFA_HELPER_BATCHED_INLINE Real safeInverseNorm(Real squaredNorm)
+{
+    const Real norm = std::sqrt(squaredNorm);
+    return norm > std::numeric_limits<Real>::epsilon() ? 1 / norm : static_cast<Real>(1);
+}
+
+template<class Real>
+SOFA_HELPER_BATCHED_INLINE Real oneNorm(const Real a[9])
+{
+    return std::max({std::abs(a[0]) + std::abs(a[3]) + std::abs(a[6]),
+                     std::abs(a[1]) + std::abs(a[4]) + std::abs(a[7]),
+                     std::abs(a[2]) + std::abs(a[5]) + std::abs(a[8])});
+}
+
+template<class Real>
+SOFA_HELPER_BATCHED_INLINE Real infNorm(const Real a[9])
+{
+    return std::max({std::abs(a[0]) + std::abs(a[1]) + std::abs(a[2]),
+                     std::abs(a[3]) + std::abs(a[4]) + std::abs(a[5]),
+                     std::abs(a[6]) + std::abs(a[7]) + std::abs(a[8])});
+}
+
+template<class Real>
+SOFA_HELPER_BATCHED_INLINE void QRDecompositionKernel(const Mat3x3Batch<Real>& M, Mat3x3Batch<Real>& R)
+{
+    const std::size_t size = M.size();
+    R.resize(size);
+
+    Mat3x3Chunk<Real> m, r;
+    for (std::size_t begin = 0; begin < size; begin += ChunkSize)
+    {
+        const std::size_t count = std::min(ChunkSize, size - begin);
+        load(M, begin, count, m);
+
+        for (std::size_t l = 0; l < count; ++l)
+        {
+            // x: first column, normalized
+            Real x0 = m.e[0][l], x1 = m.e[3][l], x2 = m.e[6][l];
+            const Real invNx = safeInverseNorm(x0 * x0 + x1 * x1 + x2 * x2);
+            x0 *= invNx; x1 *= invNx; x2 *= invNx;
+
+            // z = x ^ second column, normalized
+            const Real y0 = m.e[1][l], y1 = m.e[4][l], y2 = m.e[7][l];
+            Real z0 = x1 * y2 - x2 * y1;
+            Real z1 = x2 * y0 - x0 * y2;
+            Real z2 = x0 * y1 - x1 * y0;
+            const Real invNz = safeInverseNorm(z0 * z0 + z1 * z1 + z2 * z2);
+            z0 *= invNz; z1 *= invNz; z2 *= invNz;
+
+            // y = z ^ x
+            r.e[0][l] = x0; r.e[1][l] = z1 * x2 - z2 * x1; r.e[2][l] = z0;
+            r.e[3][l] = x1; r.e[4][l] = z2 * x0 - z0 * x2; r.e[5][l] = z1;
+            r.e[6][l] = x2; r.e[7][l] = z0 * x1 - z1 * x0; r.e[8][l] = z2;
+        }
+
+        store(r, begin, count, R);
+    }
+}
+
+template<class Real>
+SOFA_HELPER_BATCHED_INLINE std::size_t polarDecompositionKernel(const Mat3x3Batch<Real>& M, Mat3x3Batch<Real>& Q)
+{
+    constexpr unsigned int maxIterations = 100;
+    const Real tolerance = Decompose<Real>::zeroTolerance();
+
+    const std::size_t size = M.size();
+    Q.resize(size);
+    std::size_t nbSingular = 0;
+
+    Mat3x3Chunk<Real> m, mk;
+    alignas(64) Real active[ChunkSize];
+    alignas(64) Real singular[ChunkSize];
+
+    for (std::size_t begin = 0; begin < size; begin += ChunkSize)
+    {
+        const std::size_t count = std::min(ChunkSize, size - begin);
+        load(M, begin, count, m);
+
+        // Mk = M^T
+        for (Size i = 0; i < 3; ++i)
+            for (Size j = 0; j < 3; ++j)
+                for (std::size_t l = 0; l < count; ++l)
+                    mk.e[3 * i + j][l] = m.e[3 * j + i][l];
+
+        for (std::size_t l = 0; l < count; ++l)
+        {
+            active[l] = 1;
+            singular[l] = 0;
+        }
+
+        // All the matrices of the chunk iterate together. A matrix which has converged, or with a
+        // null determinant, is not updated anymore.
+        for (unsigned int iteration = 0; iteration < maxIterations; ++iteration)
+        {
+            Real nbActive = 0;
+            for (std::size_t l = 0; l < count; ++l)
+            {
+                Real a[9];
+                for (Size k = 0; k < 9; ++k)
+                    a[k] = mk.e[k][l];
+
+                // rows of the adjoint transpose
+                Real c[9];
+                c[0] = a[4] * a[8] - a[5] * a[7]; c[1] = a[5] * a[6] - a[3] * a[8]; c[2] = a[3] * a[7] - a[4] * a[6];
+                c[3] = a[7] * a[2] - a[8] * a[1]; c[4] = a[8] * a[0] - a[6] * a[2]; c[5] = a[6] * a[1] - a[7] * a[0];
+                c[6] = a[1] * a[5] - a[2] * a[4]; c[7] = a[2] * a[3] - a[0] * a[5]; c[8] = a[0] * a[4] - a[1] * a[3];
+
+                const Real det = a[0] * c[0] + a[1] * c[1] + a[2] * c[2];
+                const bool isSingular = (det == 0);
+                const Real safeDet = isSingular ? static_cast<Real>(1) : det;
+
+                const Real gamma = std::sqrt(std::sqrt((oneNorm(c) * infNorm(c)) / (oneNorm(a) * infNorm(a))) / std::abs(safeDet));
+                const Real g1 = gamma * static_cast<Real>(0.5);
+                const Real g2 = static_cast<Real>(0.5) / (gamma * safeDet);
+
+                Real next[9], e[9];
+                for (Size k = 0; k < 9; ++k)
+                {
+                    next[k] = a[k] * g1 + c[k] * g2;
+                    e[k] = a[k] - next[k];
+                }
+
+                const bool update = active[l] != 0 && !isSingular;
+                for (Size k = 0; k < 9; ++k)
+                    mk.e[k][l] = update ? next[k] : a[k];
+
+                singular[l] = (active[l] != 0 && isSingular) ? static_cast<Real>(1) : singular[l];
+                active[l] = (update && oneNorm(e) > oneNorm(next) * tolerance) ? static_cast<Real>(1) : static_cast<Real>(0);
+                nbActive += active[l];
+            }
+
+            if (nbActive == 0)
+            {
+                break;
+            }
+        }
+
+        // Q = Mk^T
+        for (Size i = 0; i < 3; ++i)
+            for (Size j = 0; j < 3; ++j)
+                for (std::size_t l = 0; l < count; ++l)
+                    m.e[3 * i + j][l] = mk.e[3 * j + i][l];
+        for (std::size_t l = 0; l < count; ++l)
+            nbSingular += singular[l] != 0;
+
+        store(m, begin, count, Q);
+    }
+
+    return nbSingular;
+}
+
+/// Jacobi rotation in the plane (P,Q) cancelling the entry (P,Q) of the symmetric matrix A,
+/// accumulated in the columns of V
+template<Size P, Size Q, Size R, class Real>
+SOFA_HELPER_BATCHED_INLINE void jacobiRotation(Chunk<6, Real>& A, Mat3x3Chunk<Real>& V, std::size_t count)
+{
+    constexpr Real tiny = std::numeric_limits<Real>::min();
+
+    for (std::size_t l = 0; l < count; ++l)
+    {
+        const Real app = A.e[sym<P, P>()][l];
+        const Real aqq = A.e[sym<Q, Q>()][l];
+        const Real apq = A.e[sym<P, Q>()][l];
+        const Real arp = A.e[sym<R, P>()][l];
+        const Real arq = A.e[sym<R, Q>()][l];
+
+        const bool rotate = std::abs(apq) > tiny;
+        const Real theta = (aqq - app) / (2 * (rotate ? apq : static_cast<Real>(1)));
+        const Real sign = theta < 0 ? static_cast<Real>(-1) : static_cast<Real>(1);
+        const Real t = rotate ? sign / (std::abs(theta) + std::sqrt(theta * theta + 1)) : static_cast<Real>(0);
+        const Real c = 1 / std::sqrt(t * t + 1);
+        const Real s = t * c;
+
+        A.e[sym<P, P>()][l] = app - t * apq;
+        A.e[sym<Q, Q>()][l] = aqq + t * apq;
+        A.e[sym<P, Q>()][l] = 0;
+        A.e[sym<R, P>()][l] = c * arp - s * arq;
+        A.e[sym<R, Q>()][l] = s * arp + c * arq;
+
+        for (Size k = 0; k < 3; ++k)
+        {
+            const Real vkp = V.e[3 * k + P][l];
+            const Real vkq = V.e[3 * k + Q][l];
+            V.e[3 * k + P][l] = c * vkp - s * vkq;
+            V.e[3 * k + Q][l] = s * vkp + c * vkq;
+        }
+    }
+}
+
+/// Sort the eigenvalues P and Q in decreasing order, swapping the columns of V accordingly.
+/// One column is negated so that V remains a rotation.
+template<Size P, Size Q, class Real>
+SOFA_HELPER_BATCHED_INLINE void sortEigenvalues(Vec3Chunk<Real>& eigenvalues, Mat3x3Chunk<Real>& V, std::size_t count)
+{
+    for (std::size_t l = 0; l < count; ++l)
+    {
+        const Real ep = eigenvalues.e[P][l];
+        const Real eq = eigenvalues.e[Q][l];
+        const bool swap = ep < eq;
+        eigenvalues.e[P][l] = swap ? eq : ep;
+        eigenvalues.e[Q][l] = swap ? ep : eq;
+        for (Size k = 0; k < 3; ++k)
+        {
+            const Real vkp = V.e[3 * k + P][l];
+            const Real vkq = V.e[3 * k + Q][l];
+            V.e[3 * k + P][l] = swap ? vkq : vkp;
+            V.e[3 * k + Q][l] = swap ? -vkp : vkq;
+        }
+    }
+}
+
+/// Givens rotation in the rows (P,Q) of B cancelling the entry (Q,C), accumulated in the columns of U
+template<Size P, Size Q, Size C, class Real>
+SOFA_HELPER_BATCHED_INLINE void givensRotation(Mat3x3Chunk<Real>& B, Mat3x3Chunk<Real>& U, std::size_t count)
+{
+    constexpr Real tiny = std::numeric_limits<Real>::min();
+
+    for (std::size_t l = 0; l < count; ++l)
+    {
+        const Real a1 = B.e[3 * P + C][l];
+        const Real a2 = B.e[3 * Q + C][l];
+        const Real rho = std::sqrt(a1 * a1 + a2 * a2);
+        const bool rotate = rho > tiny;
+        const Real c = rotate ? a1 / rho : static_cast<Real>(1);
+        const Real s = rotate ? a2 / rho : static_cast<Real>(0);
+
+        for (Size k = 0; k < 3; ++k)
+        {
+            const Real bp = B.e[3 * P + k][l];
+            const Real bq = B.e[3 * Q + k][l];
+            B.e[3 * P + k][l] = c * bp + s * bq;
+            B.e[3 * Q + k][l] = c * bq - s * bp;
+
+            const Real up = U.e[3 * k + P][l];
+            const Real uq = U.e[3 * k + Q][l];
+            U.e[3 * k + P][l] = c * up + s * uq;
+            U.e[3 * k + Q][l] = c * uq - s * up;
+        }
+    }
+}
+
+template<class Real>
+SOFA_HELPER_BATCHED_INLINE void SVDKernel(const Mat3x3Batch<Real>& F, Mat3x3Batch<Real>& U, Vec3Batch<Real>& S, Mat3x3Batch<Real>& V)
+{
+    // Jacobi sweeps converge quadratically: a few sweeps reach the machine precision on 3x3 matrices
+    constexpr unsigned int nbSweeps = std::is_same_v<Real, float> ? 4 : 6;
+
+    const std::size_t size = F.size();
+    U.resize(size);
+    S.resize(size);
+    V.resize(size);
+
+    Mat3x3Chunk<Real> f, u, v, b;
+    Chunk<6, Real> a;
+    Vec3Chunk<Real> s;
+
+    for (std::size_t begin = 0; begin < size; begin += ChunkSize)
+    {
+        const std::size_t count = std::min(ChunkSize, size - begin);
+        load(F, begin, count, f);
+
+        // A = F^T F, V = I
+        for (Size i = 0; i < 3; ++i)
+            for (Size j = i; j < 3; ++j)
+            {
+                Real* aij = a.e[i == 0 ? j : i + j + 1];
+                for (std::size_t l = 0; l < count; ++l)
+                    aij[l] = f.e[i][l] * f.e[j][l] + f.e[3 + i][l] * f.e[3 + j][l] + f.e[6 + i][l] * f.e[6 + j][l];
+            }
+        for (std::size_t l = 0; l < count; ++l)
+            for (Size k = 0; k < 9; ++k)
+                v.e[k][l] = (k % 4 == 0) ? static_cast<Real>(1) : static_cast<Real>(0);
+
+        // eigen decomposition of F^T F
+        for (unsigned int sweep = 0; sweep < nbSweeps; ++sweep)
+        {
+            jacobiRotation<0, 1, 2>(a, v, count);
+            jacobiRotation<0, 2, 1>(a, v, count);
+            jacobiRotation<1, 2, 0>(a, v, count);
+        }
+
+        for (std::size_t l = 0; l < count; ++l)
+        {
+            s.e[0][l] = a.e[sym<0, 0>()][l];
+            s.e[1][l] = a.e[sym<1, 1>()][l];
+            s.e[2][l] = a.e[sym<2, 2>()][l];
+        }
+        sortEigenvalues<0, 1>(s, v, count);
+        sortEigenvalues<0, 2>(s, v, count);
+        sortEigenvalues<1, 2>(s, v, count);
+
+        // B = F V
+        for (Size i = 0; i < 3; ++i)
+            for (Size j = 0; j < 3; ++j)
+                for (std::size_t l = 0; l < count; ++l)
+                    b.e[3 * i + j][l] = f.e[3 * i][l] * v.e[j][l] + f.e[3 * i + 1][l] * v.e[3 + j][l] + f.e[3 * i + 2][l] * v.e[6 + j][l];
+
+        // QR decomposition of B with Givens rotations: B = U R, and R is diagonal up to the numerical precision
+        for (std::size_t l = 0; l < count; ++l)
+            for (Size k = 0; k < 9; ++k)
+                u.e[k][l] = (k % 4 == 0) ? static_cast<Real>(1) : static_cast<Real>(0);
+        givensRotation<0, 1, 0>(b, u, count);
+        givensRotation<0, 2, 0>(b, u, count);
+        givensRotation<1, 2, 1>(b, u, count);
+
+        for (std::size_t l = 0; l < count; ++l)
+        {
+            s.e[0][l] = b.e[0][l];
+            s.e[1][l] = b.e[4][l];
+            s.e[2][l] = b.e[8][l];
+        }
+
+        store(u, begin, count, U);
+        store(s, begin, count, S);
+        store(v, begin, count, V);
+    }
+}
+
+template<class Real>
+SOFA_HELPER_BATCHED_INLINE void determinantKernel(const Mat3x3Batch<Real>& M, std::vector<Real>& det)
+{
+    const std::size_t size = M.size();
+    det.resize(size);
+
+    Mat3x3Chunk<Real> m;
+    for (std::size_t begin = 0; begin < size; begin += ChunkSize)
+    {
+        const std::size_t count = std::min(ChunkSize, size - begin);
+        load(M, begin, count, m);
+
+        Real* d = det.data() + begin;
+        for (std::size_t l = 0; l < count; ++l)
+        {
+            d[l] = m.e[0][l] * (m.e[4][l] * m.e[8][l] - m.e[5][l] * m.e[7][l])
+                 - m.e[1][l] * (m.e[3][l] * m.e[8][l] - m.e[5][l] * m.e[6][l])
+                 + m.e[2][l] * (m.e[3][l] * m.e[7][l] - m.e[4][l] * m.e[6][l]);
+        }
+    }
+}
+
+template<class Real>
+SOFA_HELPER_BATCHED_INLINE bool inverseKernel(const Mat3x3Batch<Real>& M, Mat3x3Batch<Real>& Minv)
+{
+    const std::size_t size = M.size();
+    Minv.resize(size);
+    Real nbSingular = 0;
+
+    Mat3x3Chunk<Real> m, r;
+    for (std::size_t begin = 0; begin < size; begin += ChunkSize)
+    {
+        const std::size_t count = std::min(ChunkSize, size - begin);
+        load(M, begin, count, m);
+
+        for (std::size_t l = 0; l < count; ++l)
+        {
+            const Real c00 = m.e[4][l] * m.e[8][l] - m.e[5][l] * m.e[7][l];
+            const Real c01 = m.e[5][l] * m.e[6][l] - m.e[3][l] * m.e[8][l];
+            const Real c02 = m.e[3][l] * m.e[7][l] - m.e[4][l] * m.e[6][l];
+            const Real det = m.e[0][l] * c00 + m.e[1][l] * c01 + m.e[2][l] * c02;
+
+            const bool isSingular = std::abs(det) <= std::numeric_limits<Real>::min();
+            nbSingular += isSingular ? 1 : 0;
+            const Real invDet = 1 / (isSingular ? static_cast<Real>(1) : det);
+
+            r.e[0][l] = c00 * invDet;
+            r.e[3][l] = c01 * invDet;
+            r.e[6][l] = c02 * invDet;
+            r.e[1][l] = (m.e[2][l] * m.e[7][l] - m.e[1][l] * m.e[8][l]) * invDet;
+            r.e[4][l] = (m.e[0][l] * m.e[8][l] - m.e[2][l] * m.e[6][l]) * invDet;
+            r.e[7][l] = (m.e[1][l] * m.e[6][l] - m.e[0][l] * m.e[7][l]) * invDet;
+            r.e[2][l] = (m.e[1][l] * m.e[5][l] - m.e[2][l] * m.e[4][l]) * invDet;
+            r.e[5][l] = (m.e[2][l] * m.e[3][l] - m.e[0][l] * m.e[5][l]) * invDet;
+            r.e[8][l] = (m.e[0][l] * m.e[4][l] - m.e[1][l] * m.e[3][l]) * invDet;
+        }
+
+        store(r, begin, count, Minv);
+    }
+
+    return nbSingular == 0;
+}
+
+template<class Real>
+SOFA_HELPER_BATCHED_INLINE void mulKernel(const Mat3x3Batch<Real>& M, const Vec3Batch<Real>& v, Vec3Batch<Real>& result)
+{
+    const std::size_t size = M.size();
+    result.resize(size);
+
+    Mat3x3Chunk<Real> m;
+    Vec3Chunk<Real> x, y;
+    for (std::size_t begin = 0; begin < size; begin += ChunkSize)
+    {
+        const std::size_t count = std::min(ChunkSize, size - begin);
+        load(M, begin, count, m);
+        load(v, begin, count, x);
+
+        for (Size i = 0; i < 3; ++i)
+            for (std::size_t l = 0; l < count; ++l)
+                y.e[i][l] = m.e[3 * i][l] * x.e[0][l] + m.e[3 * i + 1][l] * x.e[1][l] + m.e[3 * i + 2][l] * x.e[2][l];
+
+        store(y, begin, count, result);
+    }
+}
+
+/// Entry points of the kernels for one instruction set
+template<class Real>
+struct KernelTable
+{
+    void (*QRDecomposition)(const Mat3x3Batch<Real>&, Mat3x3Batch<Real>&);
+    std::size_t (*polarDecomposition)(const Mat3x3Batch<Real>&, Mat3x3Batch<Real>&);
+    void (*SVD)(const Mat3x3Batch<Real>&, Mat3x3Batch<Real>&, Vec3Batch<Real>&, Mat3x3Batch<Real>&);
+    void (*determinant)(const Mat3x3Batch<Real>&, std::vector<Real>&);
+    bool (*inverse)(const Mat3x3Batch<Real>&, Mat3x3Batch<Real>&);
+    void (*mul)(const Mat3x3Batch<Real>&, const Vec3Batch<Real>&, Vec3Batch<Real>&);
+};
+
+#define SOFA_HELPER_DEFINE_BATCHED_KERNELS(Name, TargetAttribute)                                              \
+struct Name                                                                                                     \
+{                                                                                                               \
+    template<class Real> TargetAttribute static void QRDecomposition(const Mat3x3Batch<Real>& M, Mat3x3Batch<Real>& R) \
+    { QRDecompositionKernel(M, R); }                                                                            \
+    template<class Real> TargetAttribute static std::size_t polarDecomposition(const Mat3x3Batch<Real>& M, Mat3x3Batch<Real>& Q) \
+    { return polarDecompositionKernel(M, Q); }                                                                  \
+    template<class Real> TargetAttribute static void SVD(const Mat3x3Batch<Real>& F, Mat3x3Batch<Real>& U, Vec3Batch<Real>& S, Mat3x3Batch<Real>& V) \
+    { SVDKernel(F, U, S, V); }                                                                                  \
+    template<class Real> TargetAttribute static void determinant(const Mat3x3Batch<Real>& M, std::vector<Real>& det) \
+    { determinantKernel(M, det); }                                                                              \
+    template<class Real> TargetAttribute static bool inverse(const Mat3x3Batch<Real>& M, Mat3x3Batch<Real>& Minv) \
+    { return inverseKernel(M, Minv); }                                                                          \
+    template<class Real> TargetAttribute static void mul(const Mat3x3Batch<Real>& M, const Vec3Batch<Real>& v, Vec3Batch<Real>& result) \
+    { mulKernel(M, v, result); }                                                                                \
+    template<class Real> static KernelTable<Real> table()                                                       \
+    { return { &QRDecomposition<Real>, &polarDecomposition<Real>, &SVD<Real>, &determinant<Real>, &inverse<Real>, &mul<Real> }; } \
+};
+
+SOFA_HELPER_DEFINE_BATCHED_KERNELS(GenericKernels, )
+#if defined(SOFA_HELPER_BATCHED_X86_DISPATCH)
+SOFA_HELPER_DEFINE_BATCHED_KERNELS(AVX2Kernels, __attribute__((target("avx2,fma"))))
+SOFA_HELPER_DEFINE_BATCHED_KERNELS(AVX512Kernels, __attribute__((target("avx512f,avx512dq,avx512vl,avx2,fma"))))
+#endif
+
+#undef SOFA_HELPER_DEFINE_BATCHED_KERNELS
+
+template<class Real>
+const KernelTable<Real>& getKernelTable()
+{
+    static const KernelTable<Real> generic = GenericKernels::table<Real>();
+#if defined(SOFA_HELPER_BATCHED_X86_DISPATCH)
+    static const KernelTable<Real> avx2 = AVX2Kernels::table<Real>();
+    static const KernelTable<Real> avx512 = AVX512Kernels::table<Real>();
+    switch (getBatchedInstructionSet())
+    {
+        case BatchedInstructionSet::AVX512: return avx512;
+        case BatchedInstructionSet::AVX2: return avx2;
+        default: break;
+    }
+#endif
+    return generic;
+}
+
+std::atomic<BatchedInstructionSet>& currentInstructionSet()
+{
+    static std::atomic<BatchedInstructionSet> instructionSet { detectBatchedInstructionSet() };
+    return instructionSet;
+}
+
+} // anonymous namespace
+
+BatchedInstructionSet detectBatchedInstructionSet()
+{
+#if defined(SOFA_HELPER_BATCHED_X86_DISPATCH)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512dq") && __builtin_cpu_supports("avx512vl"))
+    {
+        return BatchedInstructionSet::AVX512;
+    }
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+    {
+        return BatchedInstructionSet::AVX2;
+    }
+#endif
+    return BatchedInstructionSet::Generic;
+}
+
+BatchedInstructionSet getBatchedInstructionSet()
+{
+    return currentInstructionSet().load();
+}
+
+void setBatchedInstructionSet(BatchedInstructionSet instructionSet)
+{
+    const auto supported = detectBatchedInstructionSet();
+    if (static_cast<unsigned char>(instructionSet) > static_cast<unsigned char>(supported))
+    {
+        msg_warning("BatchedDecompose") << toString(instructionSet) << " is not supported on this CPU: "
+                                        << toString(supported) << " is used instead.";
+        instructionSet = supported;
+    }
+    currentInstructionSet().store(instructionSet);
+}
+
+const char* toString(BatchedInstructionSet instructionSet)
+{
+    switch (instructionSet)
+    {
+        case BatchedInstructionSet::AVX2: return "AVX2";
+        case BatchedInstructionSet::AVX512: return "AVX512";
+        default: return "Generic";
+    }
+}
+
+template<class Real>
+void BatchedDecompose<Real>::QRDecomposition(const Mat3x3Batch<Real>& M, Mat3x3Batch<Real>& R)
+{
+    getKernelTable<Real>().QRDecomposition(M, R);
+}
+
+template<class Real>
+void BatchedDecompose<Real>::polarDecomposition(const Mat3x3Batch<Real>& M, Mat3x3Batch<Real>& Q)
+{
+    if (const auto nbSingular = getKernelTable<Real>().polarDecomposition(M, Q))
+    {
+        msg_warning("BatchedDecompose") << "polarDecomposition: zero determinant encountered in " << nbSingular << " matrices.";
+    }
+}
+
+template<class Real>
+void BatchedDecompose<Real>::SVD(const Mat3x3Batch<Real>& F, Mat3x3Batch<Real>& U, Vec3Batch<Real>& S, Mat3x3Batch<Real>& V)
+{
+    getKernelTable<Real>().SVD(F, U, S, V);
+}
+
+template<class Real>
+void BatchedDecompose<Real>::determinant(const Mat3x3Batch<Real>& M, std::vector<Real>& det)
+{
+    getKernelTable<Real>().determinant(M, det);
+}
+
+template<class Real>
+bool BatchedDecompose<Real>::inverse(const Mat3x3Batch<Real>& M, Mat3x3Batch<Real>& Minv)
+{
+    return getKernelTable<Real>().inverse(M, Minv);
+}
+
+template<class Real>
+void BatchedDecompose<Real>::mul(const Mat3x3Batch<Real>& M, const Vec3Batch<Real>& v, Vec3Batch<Real>& result)
+{
+    getKernelTable<Real>().mul(M, v, result);
+}
+
+template class SOFA_HELPER_API BatchedDecompose<double>;
+template class SOFA_HELPER_API BatchedDecompose<float>;
+
+} // namespace sofa::helper
@@ -0,0 +1,178 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+#include <sofa/helper/config.h>
+
+#include <sofa/type/Mat.h>
+#include <vector>
+
+namespace sofa::helper
+{
+
+/**
+ * Structure-of-arrays storage of a batch of NL x NC matrices.
+ *
+ * The entry (i,j) of all the matrices of the batch is stored contiguously, so that the batched
+ * kernels process several matrices per SIMD instruction.
+ */
+template<Size NL, Size NC, class Real>
+class MatBatch
+{
+public:
+    static constexpr Size nbEntries = NL * NC;
+
+    explicit MatBatch(std::size_t size = 0) { resize(size); }
+
+    void resize(std::size_t size)
+    {
+        m_size = size;
+        m_data.resize(nbEntries * size);
+    }
+
+    std::size_t size() const { return m_size; }
+
+    /// Contiguous array of the entry (i,j) of all the matrices
+    Real* entry(Size i, Size j) { return m_data.data() + (i * NC + j) * m_size; }
+    const Real* entry(Size i, Size j) const { return m_data.data() + (i * NC + j) * m_size; }
+
+    void set(std::size_t index, const type::Mat<NL, NC, Real>& m)
+    {
+        for (Size i = 0; i < NL; ++i)
+            for (Size j = 0; j < NC; ++j)
+                entry(i, j)[index] = m(i, j);
+    }
+
+    type::Mat<NL, NC, Real> get(std::size_t index) const
+    {
+        type::Mat<NL, NC, Real> m;
+        for (Size i = 0; i < NL; ++i)
+            for (Size j = 0; j < NC; ++j)
+                m(i, j) = entry(i, j)[index];
+        return m;
+    }
+
+private:
+    std::size_t m_size { 0 };
+    std::vector<Real> m_data;
+};
+
+/// Structure-of-arrays storage of a batch of 3D vectors
+template<class Real>
+class Vec3Batch
+{
+public:
+    explicit Vec3Batch(std::size_t size = 0) { resize(size); }
+
+    void resize(std::size_t size)
+    {
+        m_size = size;
+        m_data.resize(3 * size);
+    }
+
+    std::size_t size() const { return m_size; }
+
+    /// Contiguous array of the coordinate i of all the vectors
+    Real* coord(Size i) { return m_data.data() + i * m_size; }
+    const Real* coord(Size i) const { return m_data.data() + i * m_size; }
+
+    void set(std::size_t index, const type::Vec<3, Real>& v)
+    {
+        for (Size i = 0; i < 3; ++i)
+            coord(i)[index] = v[i];
+    }
+
+    type::Vec<3, Real> get(std::size_t index) const
+    {
+        return type::Vec<3, Real>(coord(0)[index], coord(1)[index], coord(2)[index]);
+    }
+
+private:
+    std::size_t m_size { 0 };
+    std::vector<Real> m_data;
+};
+
+template<class Real>
+using Mat3x3Batch = MatBatch<3, 3, Real>;
+
+/// Instruction sets for which the batched kernels are compiled
+enum class BatchedInstructionSet : unsigned char
+{
+    Generic, ///< compiled with the default flags of the build (SSE2 on x86-64, NEON on aarch64)
+    AVX2,
+    AVX512
+};
+
+/// Best instruction set supported both by the build and by the CPU running the program
+SOFA_HELPER_API BatchedInstructionSet detectBatchedInstructionSet();
+
+/// Instruction set used by the batched kernels. Defaults to detectBatchedInstructionSet().
+SOFA_HELPER_API BatchedInstructionSet getBatchedInstructionSet();
+
+/// Force the instruction set used by the batched kernels, e.g. to compare the results of the
+/// generic kernels with the specialized ones. A set not supported by the CPU is ignored.
+SOFA_HELPER_API void setBatchedInstructionSet(BatchedInstructionSet instructionSet);
+
+SOFA_HELPER_API const char* toString(BatchedInstructionSet instructionSet);
+
+/**
+ * Batched versions of some of the Decompose functions on 3x3 matrices.
+ *
+ * The matrices are processed by chunks, in branchless code which is vectorized by the compiler.
+ * The kernel is chosen at runtime according to getBatchedInstructionSet().
+ * Results are equivalent to the scalar versions of Decompose, up to the numerical tolerance.
+ */
+template<class Real>
+class BatchedDecompose
+{
+public:
+    /** Rotation of the local frame built from the two first columns of each matrix, using
+      * Gram-Schmidt orthogonalization. Batched version of Decompose::QRDecomposition.
+      */
+    static void QRDecomposition(const Mat3x3Batch<Real>& M, Mat3x3Batch<Real>& R);
+
+    /** Orthogonal factor Q of the polar decomposition M = QS of each matrix, using the scaled
+      * Newton iterations of Decompose::polarDecomposition.
+      */
+    static void polarDecomposition(const Mat3x3Batch<Real>& M, Mat3x3Batch<Real>& Q);
+
+    /** Singular value decomposition F = U.diag(S).V^T of each matrix, where U and V are rotations.
+      * The singular values are sorted in decreasing order. The last one is negative if F is a reflection.
+      * The symmetric eigen problem F^T.F is solved with cyclic Jacobi sweeps, and U is extracted
+      * from F.V with Givens rotations (McAdams et al., 2011).
+      */
+    static void SVD(const Mat3x3Batch<Real>& F, Mat3x3Batch<Real>& U, Vec3Batch<Real>& S, Mat3x3Batch<Real>& V);
+
+    static void determinant(const Mat3x3Batch<Real>& M, std::vector<Real>& det);
+
+    /// @return false if at least one of the matrices is not invertible
+    static bool inverse(const Mat3x3Batch<Real>& M, Mat3x3Batch<Real>& Minv);
+
+    /// result = M * v
+    static void mul(const Mat3x3Batch<Real>& M, const Vec3Batch<Real>& v, Vec3Batch<Real>& result);
+};
+
+#if !defined(SOFA_HELPER_BATCHEDDECOMPOSE_CPP)
+extern template class SOFA_HELPER_API BatchedDecompose<double>;
+extern template class SOFA_HELPER_API BatchedDecompose<float>;
+#endif
+
+} // namespace sofa::helper
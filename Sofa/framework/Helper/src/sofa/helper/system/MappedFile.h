@@ -0,0 +1,77 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+
+#include <sofa/helper/config.h>
+#include <cstddef>
+#include <string>
+
+namespace sofa::helper::system
+{
+
+/**
+   @brief Read-only mapping of a whole file in memory.
+
+   The pages are loaded on demand by the operating system and shared between all the
+   processes mapping the same file, so large precomputed data can be used by several
+   simulations running on the same machine with a single physical copy.
+   The mapping is released when the object is destroyed.
+*/
+class SOFA_HELPER_API MappedFile
+{
+public:
+    MappedFile() = default;
+    explicit MappedFile(const std::string& filename);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /// @brief Map the given file, releasing the previous mapping if any.
+    ///
+    /// @return false if the file could not be opened or mapped.
+    bool open(const std::string& filename);
+
+    /// Release the mapping.
+    void close();
+
+    bool isOpen() const { return m_data != nullptr; }
+
+    /// Address of the first byte of the file, nullptr if no file is mapped.
+    const char* data() const { return m_data; }
+
+    /// Size of the file in bytes.
+    std::size_t size() const { return m_size; }
+
+    const std::string& filename() const { return m_filename; }
+
+private:
+    const char* m_data { nullptr };
+    std::size_t m_size { 0 };
+    std::string m_filename;
+#ifdef WIN32
+    void* m_file { nullptr };
+    void* m_mapping { nullptr };
+#endif
+};
+
+} // namespace sofa::helper::system
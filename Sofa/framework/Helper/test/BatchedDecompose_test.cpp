@@ -0,0 +1,229 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/helper/BatchedDecompose.h>
+#include <sofa/helper/decompose.h>
+#include <sofa/testing/BaseTest.h>
+
+#include <random>
+
+namespace sofa
+{
+
+using helper::BatchedDecompose;
+using helper::BatchedInstructionSet;
+using helper::Decompose;
+using helper::Mat3x3Batch;
+using helper::Vec3Batch;
+
+template<class Real>
+class BatchedDecompose_test : public testing::BaseTest
+{
+public:
+    using Mat3 = type::Mat<3, 3, Real>;
+    using Vec3 = type::Vec<3, Real>;
+
+    /// Number of matrices, not a multiple of the size of the chunks processed by the kernels
+    static constexpr std::size_t nbMatrices = 1001;
+
+    Mat3x3Batch<Real> M;
+    Vec3Batch<Real> v;
+
+    static Real tolerance() { return std::is_same_v<Real, float> ? static_cast<Real>(1e-4) : static_cast<Real>(1e-10); }
+
+    void doSetUp() override
+    {
+        std::mt19937 generator(42);
+        std::uniform_real_distribution<Real> distribution(-1, 1);
+
+        M.resize(nbMatrices);
+        v.resize(nbMatrices);
+        for (std::size_t i = 0; i < nbMatrices; ++i)
+        {
+            Mat3 m;
+            for (Size r = 0; r < 3; ++r)
+                for (Size c = 0; c < 3; ++c)
+                    m(r, c) = distribution(generator) + (r == c ? 2 : 0);
+
+            // some reflections
+            if (i % 7 == 0)
+            {
+                m(0, 0) = -m(0, 0) - 5;
+            }
+            M.set(i, m);
+            v.set(i, Vec3(distribution(generator), distribution(generator), distribution(generator)));
+        }
+    }
+
+    void doTearDown() override
+    {
+        helper::setBatchedInstructionSet(helper::detectBatchedInstructionSet());
+    }
+
+    static void expectNear(const Mat3& a, const Mat3& b, Real tolerance)
+    {
+        for (Size r = 0; r < 3; ++r)
+            for (Size c = 0; c < 3; ++c)
+                EXPECT_NEAR(a(r, c), b(r, c), tolerance);
+    }
+
+    /// Compare the batched kernels with the scalar versions, for all the instruction sets supported by the CPU
+    template<class Test>
+    void forEachInstructionSet(const Test& test)
+    {
+        const auto supported = static_cast<unsigned char>(helper::detectBatchedInstructionSet());
+        for (unsigned char instructionSet = 0; instructionSet <= supported; ++instructionSet)
+        {
+            helper::setBatchedInstructionSet(static_cast<BatchedInstructionSet>(instructionSet));
+            SCOPED_TRACE(helper::toString(helper::getBatchedInstructionSet()));
+            test();
+        }
+    }
+};
+
+using RealTypes = ::testing::Types<float, double>;
+TYPED_TEST_SUITE(BatchedDecompose_test, RealTypes);
+
+TYPED_TEST(BatchedDecompose_test, polarDecomposition)
+{
+    this->forEachInstructionSet([this]()
+    {
+        Mat3x3Batch<TypeParam> Q;
+        BatchedDecompose<TypeParam>::polarDecomposition(this->M, Q);
+        ASSERT_EQ(Q.size(), this->M.size());
+
+        for (std::size_t i = 0; i < this->M.size(); ++i)
+        {
+            typename TestFixture::Mat3 expected;
+            Decompose<TypeParam>::polarDecomposition(this->M.get(i), expected);
+            this->expectNear(Q.get(i), expected, this->tolerance());
+        }
+    });
+}
+
+TYPED_TEST(BatchedDecompose_test, QRDecomposition)
+{
+    this->forEachInstructionSet([this]()
+    {
+        Mat3x3Batch<TypeParam> R;
+        BatchedDecompose<TypeParam>::QRDecomposition(this->M, R);
+
+        for (std::size_t i = 0; i < this->M.size(); ++i)
+        {
+            typename TestFixture::Mat3 expected;
+            Decompose<TypeParam>::QRDecomposition(this->M.get(i), expected);
+            this->expectNear(R.get(i), expected, this->tolerance());
+        }
+    });
+}
+
+TYPED_TEST(BatchedDecompose_test, SVD)
+{
+    using Mat3 = typename TestFixture::Mat3;
+    using Vec3 = typename TestFixture::Vec3;
+
+    this->forEachInstructionSet([this]()
+    {
+        Mat3x3Batch<TypeParam> U, V;
+        Vec3Batch<TypeParam> S;
+        BatchedDecompose<TypeParam>::SVD(this->M, U, S, V);
+
+        for (std::size_t i = 0; i < this->M.size(); ++i)
+        {
+            const Mat3 m = this->M.get(i);
+            const Mat3 u = U.get(i);
+            const Mat3 v = V.get(i);
+            const Vec3 s = S.get(i);
+
+            // U and V are rotations, and F = U.diag(S).V^T
+            EXPECT_NEAR(type::determinant(u), 1, this->tolerance());
+            EXPECT_NEAR(type::determinant(v), 1, this->tolerance());
+            this->expectNear(u.multTranspose(u), Mat3::Identity(), this->tolerance());
+            this->expectNear(u.multDiagonal(s) * v.transposed(), m, this->tolerance());
+
+            // same singular values as the scalar version, up to the sign of the last one
+            Mat3 scalarU, scalarV;
+            Vec3 scalarS;
+            Decompose<TypeParam>::SVD(m, scalarU, scalarS, scalarV);
+            std::sort(scalarS.begin(), scalarS.end(), std::greater<TypeParam>());
+
+            EXPECT_GE(s[0], s[1]);
+            EXPECT_GE(s[1], std::abs(s[2]));
+            EXPECT_NEAR(s[0], scalarS[0], this->tolerance());
+            EXPECT_NEAR(s[1], scalarS[1], this->tolerance());
+            EXPECT_NEAR(std::abs(s[2]), scalarS[2], this->tolerance());
+        }
+    });
+}
+
+TYPED_TEST(BatchedDecompose_test, determinantAndInverse)
+{
+    using Mat3 = typename TestFixture::Mat3;
+
+    this->forEachInstructionSet([this]()
+    {
+        std::vector<TypeParam> det;
+        BatchedDecompose<TypeParam>::determinant(this->M, det);
+
+        Mat3x3Batch<TypeParam> Minv;
+        EXPECT_TRUE(BatchedDecompose<TypeParam>::inverse(this->M, Minv));
+
+        for (std::size_t i = 0; i < this->M.size(); ++i)
+        {
+            const Mat3 m = this->M.get(i);
+            EXPECT_NEAR(det[i], type::determinant(m), this->tolerance() * 100);
+
+            Mat3 expected;
+            ASSERT_TRUE(expected.invert(m));
+            this->expectNear(Minv.get(i), expected, this->tolerance());
+        }
+    });
+}
+
+TYPED_TEST(BatchedDecompose_test, singularInverse)
+{
+    Mat3x3Batch<TypeParam> M(3);
+    M.set(0, TestFixture::Mat3::Identity());
+    M.set(1, typename TestFixture::Mat3());
+    M.set(2, TestFixture::Mat3::Identity());
+
+    Mat3x3Batch<TypeParam> Minv;
+    EXPECT_FALSE(BatchedDecompose<TypeParam>::inverse(M, Minv));
+    this->expectNear(Minv.get(2), TestFixture::Mat3::Identity(), this->tolerance());
+}
+
+TYPED_TEST(BatchedDecompose_test, mul)
+{
+    this->forEachInstructionSet([this]()
+    {
+        Vec3Batch<TypeParam> result;
+        BatchedDecompose<TypeParam>::mul(this->M, this->v, result);
+
+        for (std::size_t i = 0; i < this->M.size(); ++i)
+        {
+            const auto expected = this->M.get(i) * this->v.get(i);
+            for (Size k = 0; k < 3; ++k)
+                EXPECT_NEAR(result.get(i)[k], expected[k], this->tolerance());
+        }
+    });
+}
+
+} // namespace sofa
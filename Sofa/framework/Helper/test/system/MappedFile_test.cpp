@@ -0,0 +1,62 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/helper/system/MappedFile.h>
+#include <sofa/helper/system/FileRepository.h>
+#include <sofa/helper/system/FileSystem.h>
+#include <gtest/gtest.h>
+#include <fstream>
+#include <string>
+
+using sofa::helper::system::MappedFile;
+using sofa::helper::system::FileSystem;
+
+TEST(MappedFileTest, readContent)
+{
+    const std::string filename = FileSystem::append(sofa::helper::system::FileRepository().getTempPath(), "MappedFile_test.bin");
+    const std::string content = "mapped file content";
+    {
+        std::ofstream out(filename, std::ios::binary);
+        out.write(content.data(), content.size());
+    }
+
+    {
+        MappedFile file(filename);
+        ASSERT_TRUE(file.isOpen());
+        EXPECT_EQ(file.size(), content.size());
+        EXPECT_EQ(std::string(file.data(), file.size()), content);
+        EXPECT_EQ(file.filename(), filename);
+
+        file.close();
+        EXPECT_FALSE(file.isOpen());
+        EXPECT_EQ(file.data(), nullptr);
+    }
+
+    FileSystem::removeFile(filename);
+}
+
+TEST(MappedFileTest, missingFile)
+{
+    MappedFile file;
+    EXPECT_FALSE(file.open("this/file/does/not/exist.bin"));
+    EXPECT_FALSE(file.isOpen());
+    EXPECT_EQ(file.size(), 0u);
+}
@@ -0,0 +1,364 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/linearalgebra/BlockLowRankMatrix.h>
+#include <sofa/helper/logging/Messaging.h>
+
+#include <Eigen/Dense>
+#include <Eigen/SVD>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <limits>
+
+namespace sofa::linearalgebra
+{
+
+namespace
+{
+constexpr char blrMagic[8] = { 'S', 'O', 'F', 'A', 'B', 'L', 'R', '\0' };
+constexpr std::uint32_t blrVersion = 1;
+
+/// Append the values to the buffer, converted to T, at an offset aligned on 8 bytes
+template<class T, class Iterator>
+std::uint64_t appendValues(std::vector<char>& buffer, Iterator begin, Iterator end)
+{
+    const std::size_t offset = (buffer.size() + 7) & ~std::size_t(7);
+    buffer.resize(offset + sizeof(T) * std::distance(begin, end));
+    T* values = reinterpret_cast<T*>(buffer.data() + offset);
+    for (Iterator it = begin; it != end; ++it)
+    {
+        *values++ = static_cast<T>(*it);
+    }
+    return offset;
+}
+}
+
+sofa::Size BlockLowRankMatrix::tileDimension(sofa::Index t) const
+{
+    return std::min(m_tileSize, m_n - t * m_tileSize);
+}
+
+std::size_t BlockLowRankMatrix::tileIndex(sofa::Index ti, sofa::Index tj) const
+{
+    if (isSymmetric())
+    {
+        return std::size_t(ti) * (ti + 1) / 2 + tj;
+    }
+    return std::size_t(ti) * nbTileRows() + tj;
+}
+
+template<class Real>
+void BlockLowRankMatrix::compress(const Real* dense, sofa::Size n, const Options& options)
+{
+    clear();
+
+    m_n = n;
+    m_tileSize = std::max<sofa::Size>(1, options.tileSize);
+    m_flags = (options.singlePrecision ? std::uint32_t(SinglePrecision) : 0u) | (options.symmetric ? std::uint32_t(Symmetric) : 0u);
+
+    const sofa::Size nbTiles = nbTileRows();
+    const std::size_t nbStoredTiles = options.symmetric ? std::size_t(nbTiles) * (nbTiles + 1) / 2 : std::size_t(nbTiles) * nbTiles;
+
+    std::vector<char> buffer(sizeof(Header) + nbStoredTiles * sizeof(Tile));
+    Header header {};
+    std::memcpy(header.magic, blrMagic, sizeof(blrMagic));
+    header.version = blrVersion;
+    header.flags = m_flags;
+    header.n = m_n;
+    header.tileSize = m_tileSize;
+    std::memcpy(buffer.data(), &header, sizeof(Header));
+
+    std::vector<Tile> tiles(nbStoredTiles);
+    const auto append = [this, &buffer](const auto* begin, const auto* end)
+    {
+        return isSinglePrecision() ? appendValues<float>(buffer, begin, end) : appendValues<double>(buffer, begin, end);
+    };
+
+    using Matrix = Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+    Matrix A;
+    const auto value = [dense, n, &options](sofa::Index i, sofa::Index j)
+    {
+        if (options.symmetric)
+        {
+            return 0.5 * (static_cast<double>(dense[std::size_t(i) * n + j]) + static_cast<double>(dense[std::size_t(j) * n + i]));
+        }
+        return static_cast<double>(dense[std::size_t(i) * n + j]);
+    };
+
+    for (sofa::Index ti = 0; ti < nbTiles; ++ti)
+    {
+        const sofa::Size rows = tileDimension(ti);
+        const sofa::Index tjEnd = options.symmetric ? ti + 1 : nbTiles;
+        for (sofa::Index tj = 0; tj < tjEnd; ++tj)
+        {
+            const sofa::Size cols = tileDimension(tj);
+            Tile& tile = tiles[tileIndex(ti, tj)];
+
+            A.resize(rows, cols);
+            for (sofa::Index a = 0; a < rows; ++a)
+            {
+                for (sofa::Index b = 0; b < cols; ++b)
+                {
+                    A(a, b) = value(ti * m_tileSize + a, tj * m_tileSize + b);
+                }
+            }
+
+            if (ti == tj && options.symmetric)
+            {
+                std::vector<double> packed;
+                packed.reserve(std::size_t(rows) * (rows + 1) / 2);
+                for (sofa::Index a = 0; a < rows; ++a)
+                {
+                    for (sofa::Index b = 0; b <= a; ++b)
+                    {
+                        packed.push_back(A(a, b));
+                    }
+                }
+                tile.rank = PackedTile;
+                tile.offset = append(packed.data(), packed.data() + packed.size());
+                continue;
+            }
+
+            if (ti != tj && options.tolerance > 0)
+            {
+                const Eigen::BDCSVD<Eigen::MatrixXd> svd(A, Eigen::ComputeThinU | Eigen::ComputeThinV);
+                const Eigen::VectorXd& sigma = svd.singularValues();
+
+                // smallest rank such that the discarded part is below the tolerance
+                const double threshold = options.tolerance * options.tolerance * sigma.squaredNorm();
+                Eigen::Index rank = sigma.size();
+                double discarded = 0;
+                while (rank > 0 && discarded + sigma[rank - 1] * sigma[rank - 1] <= threshold)
+                {
+                    --rank;
+                    discarded += sigma[rank] * sigma[rank];
+                }
+
+                if (std::size_t(rank) * (rows + cols) < std::size_t(rows) * cols)
+                {
+                    const Matrix U = svd.matrixU().leftCols(rank) * sigma.head(rank).asDiagonal();
+                    const Matrix V = svd.matrixV().leftCols(rank);
+                    tile.rank = static_cast<std::uint32_t>(rank);
+                    tile.offset = append(U.data(), U.data() + U.size());
+                    append(V.data(), V.data() + V.size());
+                    continue;
+                }
+            }
+
+            tile.rank = DenseTile;
+            tile.offset = append(A.data(), A.data() + A.size());
+        }
+    }
+
+    std::memcpy(buffer.data() + sizeof(Header), tiles.data(), tiles.size() * sizeof(Tile));
+    m_buffer.swap(buffer);
+    setBuffer(m_buffer.data(), m_buffer.size());
+}
+
+template SOFA_LINEARALGEBRA_API void BlockLowRankMatrix::compress<float>(const float*, sofa::Size, const Options&);
+template SOFA_LINEARALGEBRA_API void BlockLowRankMatrix::compress<double>(const double*, sofa::Size, const Options&);
+
+void BlockLowRankMatrix::clear()
+{
+    m_file.close();
+    m_buffer.clear();
+    m_buffer.shrink_to_fit();
+    m_data = nullptr;
+    m_size = 0;
+    m_tiles = nullptr;
+    m_n = 0;
+    m_tileSize = 1;
+    m_flags = 0;
+}
+
+bool BlockLowRankMatrix::setBuffer(const char* data, std::size_t size)
+{
+    if (data == nullptr || size < sizeof(Header))
+    {
+        return false;
+    }
+
+    Header header;
+    std::memcpy(&header, data, sizeof(Header));
+    if (std::memcmp(header.magic, blrMagic, sizeof(blrMagic)) != 0 || header.version != blrVersion || header.tileSize == 0
+        || header.n > std::numeric_limits<sofa::Size>::max() || header.tileSize > std::numeric_limits<sofa::Size>::max())
+    {
+        return false;
+    }
+
+    m_n = static_cast<sofa::Size>(header.n);
+    m_tileSize = static_cast<sofa::Size>(header.tileSize);
+    m_flags = header.flags;
+
+    const sofa::Size nbTiles = nbTileRows();
+    const std::size_t nbStoredTiles = isSymmetric() ? std::size_t(nbTiles) * (nbTiles + 1) / 2 : std::size_t(nbTiles) * nbTiles;
+    if (nbStoredTiles > (size - sizeof(Header)) / sizeof(Tile))
+    {
+        return false;
+    }
+
+    // the values of each tile must be in the buffer, so that a truncated or corrupted file is never read out of bounds
+    const Tile* tiles = reinterpret_cast<const Tile*>(data + sizeof(Header));
+    const std::size_t valuesBegin = sizeof(Header) + nbStoredTiles * sizeof(Tile);
+    const std::size_t valueSize = isSinglePrecision() ? sizeof(float) : sizeof(double);
+    for (sofa::Index ti = 0; ti < nbTiles; ++ti)
+    {
+        for (sofa::Index tj = 0; tj < (isSymmetric() ? ti + 1 : nbTiles); ++tj)
+        {
+            const Tile& tile = tiles[tileIndex(ti, tj)];
+            const std::size_t rows = tileDimension(ti);
+            const std::size_t cols = tileDimension(tj);
+
+            std::size_t nbValues = 0;
+            switch (tile.rank)
+            {
+            case DenseTile:
+                nbValues = rows * cols;
+                break;
+            case PackedTile:
+                if (ti != tj)
+                {
+                    return false;
+                }
+                nbValues = rows * (rows + 1) / 2;
+                break;
+            default:
+                if (tile.rank > std::min(rows, cols))
+                {
+                    return false;
+                }
+                nbValues = tile.rank * (rows + cols);
+            }
+
+            if (tile.offset < valuesBegin || tile.offset > size || tile.offset % valueSize != 0
+                || nbValues > (size - tile.offset) / valueSize)
+            {
+                return false;
+            }
+        }
+    }
+
+    m_data = data;
+    m_size = size;
+    m_tiles = reinterpret_cast<const Tile*>(data + sizeof(Header));
+    return true;
+}
+
+sofa::Size BlockLowRankMatrix::getNbLowRankTiles() const
+{
+    if (empty())
+    {
+        return 0;
+    }
+    const sofa::Size nbTiles = nbTileRows();
+    const std::size_t nbStoredTiles = isSymmetric() ? std::size_t(nbTiles) * (nbTiles + 1) / 2 : std::size_t(nbTiles) * nbTiles;
+    return static_cast<sofa::Size>(std::count_if(m_tiles, m_tiles + nbStoredTiles, [](const Tile& tile)
+    {
+        return tile.rank != DenseTile && tile.rank != PackedTile;
+    }));
+}
+
+template<class T>
+SReal BlockLowRankMatrix::tileElement(const Tile& tile, sofa::Index ti, sofa::Index tj, sofa::Index a, sofa::Index b) const
+{
+    const T* values = reinterpret_cast<const T*>(m_data + tile.offset);
+    switch (tile.rank)
+    {
+    case DenseTile:
+        return values[std::size_t(a) * tileDimension(tj) + b];
+    case PackedTile:
+        return values[std::size_t(a) * (a + 1) / 2 + b];
+    default:
+    {
+        const std::size_t rank = tile.rank;
+        const T* u = values + a * rank;
+        const T* v = values + tileDimension(ti) * rank + b * rank;
+        SReal sum = 0;
+        for (std::size_t k = 0; k < rank; ++k)
+        {
+            sum += static_cast<SReal>(u[k]) * static_cast<SReal>(v[k]);
+        }
+        return sum;
+    }
+    }
+}
+
+SReal BlockLowRankMatrix::element(sofa::Index i, sofa::Index j) const
+{
+    if (isSymmetric() && j > i)
+    {
+        std::swap(i, j);
+    }
+
+    const sofa::Index ti = i / m_tileSize;
+    const sofa::Index tj = j / m_tileSize;
+    const Tile& tile = m_tiles[tileIndex(ti, tj)];
+    const sofa::Index a = i - ti * m_tileSize;
+    const sofa::Index b = j - tj * m_tileSize;
+
+    return isSinglePrecision() ? tileElement<float>(tile, ti, tj, a, b) : tileElement<double>(tile, ti, tj, a, b);
+}
+
+bool BlockLowRankMatrix::save(const std::string& filename) const
+{
+    if (empty())
+    {
+        return false;
+    }
+
+    std::ofstream out(filename, std::ofstream::binary);
+    if (!out.is_open())
+    {
+        msg_error("BlockLowRankMatrix") << "Cannot write file " << filename;
+        return false;
+    }
+    out.write(m_data, static_cast<std::streamsize>(m_size));
+    return out.good();
+}
+
+bool BlockLowRankMatrix::load(const std::string& filename)
+{
+    clear();
+
+    if (!m_file.open(filename))
+    {
+        return false;
+    }
+    if (!setBuffer(m_file.data(), m_file.size()))
+    {
+        msg_error("BlockLowRankMatrix") << "File " << filename << " is not a valid compressed matrix";
+        clear();
+        return false;
+    }
+    return true;
+}
+
+bool BlockLowRankMatrix::isBlockLowRankFile(const std::string& filename)
+{
+    std::ifstream in(filename, std::ifstream::binary);
+    char magic[sizeof(blrMagic)] {};
+    in.read(magic, sizeof(magic));
+    return in.good() && std::memcmp(magic, blrMagic, sizeof(blrMagic)) == 0;
+}
+
+} // namespace sofa::linearalgebra
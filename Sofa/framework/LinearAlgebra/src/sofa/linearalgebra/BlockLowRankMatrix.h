@@ -0,0 +1,159 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+#include <sofa/linearalgebra/config.h>
+#include <sofa/helper/system/MappedFile.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace sofa::linearalgebra
+{
+
+/**
+ * \brief Read-only compressed storage of a dense square matrix.
+ *
+ * The matrix is split into square tiles of tileSize rows and columns (block low-rank format,
+ * a flat variant of hierarchical matrices). Diagonal tiles are stored dense, the other tiles are
+ * stored either dense or as a product U V^T computed with a truncated SVD, when it is smaller.
+ * In addition:
+ * - the values can be stored in single precision,
+ * - a symmetric matrix can be stored packed: only the lower part is kept, and the input is
+ *   symmetrized.
+ *
+ * All the values are stored in a single contiguous buffer, having the same layout in memory and
+ * in files. A saved matrix is loaded with a read-only memory mapping, so that several processes
+ * loading the same file share the same physical memory.
+ */
+class SOFA_LINEARALGEBRA_API BlockLowRankMatrix
+{
+public:
+    struct Options
+    {
+        /// Store the values as float instead of double
+        bool singlePrecision { true };
+        /// Only store the lower part of the matrix, which is symmetrized
+        bool symmetric { true };
+        /// Relative error (Frobenius norm of each tile) allowed by the low-rank approximation of
+        /// the off-diagonal tiles. If 0, all the tiles are stored dense.
+        SReal tolerance { 0 };
+        /// Number of rows and columns of the tiles
+        sofa::Size tileSize { 96 };
+    };
+
+    BlockLowRankMatrix() = default;
+    BlockLowRankMatrix(const BlockLowRankMatrix&) = delete;
+    BlockLowRankMatrix& operator=(const BlockLowRankMatrix&) = delete;
+
+    /// Build the compressed matrix from the dense n x n matrix, stored by rows
+    template<class Real>
+    void compress(const Real* dense, sofa::Size n, const Options& options);
+
+    /// Release the values (or the memory mapping)
+    void clear();
+
+    bool empty() const { return m_data == nullptr; }
+    sofa::Size size() const { return m_n; }
+    sofa::Size getTileSize() const { return m_tileSize; }
+    bool isSinglePrecision() const { return m_flags & SinglePrecision; }
+    bool isSymmetric() const { return m_flags & Symmetric; }
+
+    /// Number of tiles stored as a low-rank product
+    sofa::Size getNbLowRankTiles() const;
+
+    /// Number of bytes used to store the matrix
+    std::size_t memorySize() const { return m_size; }
+
+    /// True if the values are read from a memory-mapped file
+    bool isMapped() const { return m_file.isOpen(); }
+
+    /// Value of the element at row i, column j
+    SReal element(sofa::Index i, sofa::Index j) const;
+
+    /// Copy the nbRows x nbCols block starting at row i, column j into block, stored by rows
+    template<class Real>
+    void getBlock(sofa::Index i, sofa::Index j, sofa::Size nbRows, sofa::Size nbCols, Real* block) const
+    {
+        for (sofa::Index r = 0; r < nbRows; ++r)
+        {
+            for (sofa::Index c = 0; c < nbCols; ++c)
+            {
+                block[r * nbCols + c] = static_cast<Real>(element(i + r, j + c));
+            }
+        }
+    }
+
+    /// Save the matrix in a binary file, in the same layout as in memory
+    bool save(const std::string& filename) const;
+
+    /// Map a file written by save() in memory
+    bool load(const std::string& filename);
+
+    /// Check if the file starts with the header of a file written by save()
+    static bool isBlockLowRankFile(const std::string& filename);
+
+protected:
+    enum Flags : std::uint32_t { SinglePrecision = 1, Symmetric = 2 };
+
+    struct Header
+    {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t flags;
+        std::uint64_t n;
+        std::uint64_t tileSize;
+    };
+
+    struct Tile
+    {
+        /// position of the values in the buffer, in bytes
+        std::uint64_t offset;
+        /// rank of the low-rank tiles (U is stored first, then V, both by rows), or one of the special values below
+        std::uint32_t rank;
+        std::uint32_t padding;
+    };
+    static constexpr std::uint32_t DenseTile = 0xFFFFFFFF; ///< values stored by rows
+    static constexpr std::uint32_t PackedTile = 0xFFFFFFFE; ///< lower part of a diagonal tile stored by rows
+
+    /// Set the pointers to the buffer after it was built or mapped
+    bool setBuffer(const char* data, std::size_t size);
+
+    sofa::Size nbTileRows() const { return (m_n + m_tileSize - 1) / m_tileSize; }
+    sofa::Size tileDimension(sofa::Index t) const;
+    std::size_t tileIndex(sofa::Index ti, sofa::Index tj) const;
+
+    template<class T>
+    SReal tileElement(const Tile& tile, sofa::Index ti, sofa::Index tj, sofa::Index a, sofa::Index b) const;
+
+    std::vector<char> m_buffer;
+    helper::system::MappedFile m_file;
+
+    const char* m_data { nullptr };
+    std::size_t m_size { 0 };
+    const Tile* m_tiles { nullptr };
+    sofa::Size m_n { 0 };
+    sofa::Size m_tileSize { 1 };
+    std::uint32_t m_flags { 0 };
+};
+
+} // namespace sofa::linearalgebra
@@ -957,22 +957,22 @@ protected:
 /// @name setter/getter & product methods on template vector types
 /// @{
 
-    template<class Vec> static Real vget(const Vec& vec, Index i, Index j, Index k) { return vget( vec, i*j+k ); }
-    template<class Vec> static Real vget(const type::vector<Vec>&vec, Index i, Index /*j*/, Index k) { return vec[i][k]; }
+    template<class Vec> static auto vget(const Vec& vec, Index i, Index j, Index k) { return vget( vec, i*j+k ); }
+    template<class Vec> static auto vget(const type::vector<Vec>&vec, Index i, Index /*j*/, Index k) { return vec[i][k]; }
 
                           static Real  vget(const BaseVector& vec, Index i) { return static_cast<Real>(vec.element(i)); }
     template<class Real2> static Real2 vget(const FullVector<Real2>& vec, Index i) { return vec[i]; }
 
 
-    template<class Vec> static void vset(Vec& vec, Index i, Index j, Index k, Real v) { vset( vec, i*j+k, v ); }
-    template<class Vec> static void vset(type::vector<Vec>&vec, Index i, Index /*j*/, Index k, Real v) { vec[i][k] = v; }
+    template<class Vec, class Real2> static void vset(Vec& vec, Index i, Index j, Index k, Real2 v) { vset( vec, i*j+k, v ); }
+    template<class Vec, class Real2> static void vset(type::vector<Vec>&vec, Index i, Index /*j*/, Index k, Real2 v) { vec[i][k] = v; }
 
                           static void vset(BaseVector& vec, Index i, Real v) { vec.set(i, v); }
     template<class Real2> static void vset(FullVector<Real2>& vec, Index i, Real2 v) { vec[i] = v; }
 
 
-    template<class Vec> static void vadd(Vec& vec, Index i, Index j, Index k, Real v) { vadd( vec, i*j+k, v ); }
-    template<class Vec> static void vadd(type::vector<Vec>&vec, Index i, Index /*j*/, Index k, Real v) { vec[i][k] += v; }
+    template<class Vec, class Real2> static void vadd(Vec& vec, Index i, Index j, Index k, Real2 v) { vadd( vec, i*j+k, v ); }
+    template<class Vec, class Real2> static void vadd(type::vector<Vec>&vec, Index i, Index /*j*/, Index k, Real2 v) { vec[i][k] += v; }
 
                           static void vadd(BaseVector& vec, Index i, Real v) { vec.add(i, v); }
     template<class Real2> static void vadd(FullVector<Real2>& vec, Index i, Real2 v) { vec[i] += v; }
@@ -980,6 +980,12 @@ protected:
     template<class Vec> static void vresize(Vec& vec, Index /*blockSize*/, Index totalSize) { vec.resize( totalSize ); }
     template<class Vec> static void vresize(type::vector<Vec>&vec, Index blockSize, Index /*totalSize*/) { vec.resize( blockSize ); }
 
+    /// Scalar type used to accumulate the block-vector products written in a vector of type Vec.
+    /// It is the widest of the block scalar and the vector scalar, so that a matrix stored in single
+    /// precision applied to a double precision vector accumulates in double precision.
+    template<class Vec> struct AccumulationReal { using type = Real; };
+    template<class Real2> struct AccumulationReal<FullVector<Real2> > { using type = std::common_type_t<Real, Real2>; };
+
 
     /** Product of the matrix with a templated vector res = this * vec*/
     //template<class Real2, class V1, class V2>
@@ -1202,7 +1208,7 @@ public:
     template< sofa::type::trait::is_vector V1, sofa::type::trait::is_vector V2>
     void mul( V2& result, const V1& v ) const
     {
-        this-> template tmul< Real, V2, V1 >(result, v);
+        this-> template tmul< typename AccumulationReal<V2>::type, V2, V1 >(result, v);
     }
 
 
@@ -1241,7 +1247,7 @@ public:
     template< typename V1, typename V2 >
     void addMul( V1& res, const V2& v ) const
     {
-        taddMul< Real,V1,V2 >( res, v );
+        taddMul< typename AccumulationReal<V1>::type,V1,V2 >( res, v );
     }
 
     /// @}
@@ -47,17 +47,18 @@ void solveDiagonalSystem(
 /// D is a diagonal matrix
 /// x is the solution vector
 /// b is the right-hand side vector
-/// The diagonal matrix is stored as the list of the inverse of the entries in the diagonal
-template<typename Real>
+/// The diagonal matrix is stored as the list of the inverse of the entries in the diagonal, possibly
+/// with a lower precision than the vectors
+template<typename Real, typename MatrixReal>
 void solveDiagonalSystemUsingInvertedValues(
     const sofa::Size systemSize,
     const Real* rightHandSideVector,
     Real* solution,
-    const Real* const Dinv_values)
+    const MatrixReal* const Dinv_values)
 {
     for (sofa::Size i = 0 ; i < systemSize; ++i)
     {
-        solution[i] = rightHandSideVector[i] * Dinv_values[i];
+        solution[i] = rightHandSideVector[i] * static_cast<Real>(Dinv_values[i]);
     }
 }
 
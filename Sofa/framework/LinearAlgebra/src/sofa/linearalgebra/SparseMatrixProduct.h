@@ -39,6 +39,10 @@ namespace sofa::linearalgebra
  *
  * To compute the product, the method computeProduct must be called.
  *
+ * The intersection is stored by groups of consecutive values of the result sharing the same list
+ * of pairs of indices (see Intersection::Group). When the matrices are made of blocks (e.g. 3x3 or
+ * 6x6), the values of a row of a block are computed together, loading the indices only once.
+ *
  * Based on:
  * Saupin, G., Duriez, C. and Grisoni, L., 2007, November. Embedded multigrid approach for real-time volumetric deformation. In International Symposium on Visual Computing (pp. 149-159). Springer, Berlin, Heidelberg.
  * and
@@ -84,13 +88,73 @@ public:
         using PairIndex = std::pair<Index, Index>;
         // A list of pairs of indices
         using ListPairIndex = sofa::type::vector<PairIndex>;
-        /// Each element of this vector gives the list of values from matrix A and B to multiply together and accumulate
-        /// them into the matrix C at the same location in the values vector
-        using ValuesIntersection = sofa::type::vector<ListPairIndex>;
 
-        ValuesIntersection intersection;
+        /// Maximum number of values of the result in a group
+        static constexpr Index MaxGroupWidth = 6;
+
+        /**
+         * Consecutive values of the result computed from the same list of pairs of indices, up to
+         * a constant shift of the indices from one value to the next. If the matrices are made of
+         * blocks, it is typically the case of the values in a row (or a column) of a block. The
+         * list of pairs is stored only once for the whole group.
+         */
+        struct Group
+        {
+            /// Index of the first value of the group in the values vector of the matrix C
+            Index firstValue {};
+            /// Number of consecutive values in the group
+            Index width {};
+            /// Shift of the indices in the values vector of the matrix A from one value to the next
+            Index lhsShift {};
+            /// Shift of the indices in the values vector of the matrix B from one value to the next
+            Index rhsShift {};
+            /// The pairs of indices of the first value of the group are in [firstPair, lastPair)
+            Index firstPair {};
+            Index lastPair {};
+        };
+
+        /// Pairs of indices of all the groups, stored contiguously
+        ListPairIndex pairs;
+        sofa::type::vector<Group> groups;
+        /// Number of scalar products required to compute the groups before the i-th group.
+        /// Used to distribute the groups among threads with a balanced work.
+        sofa::type::vector<Index> cumulatedCost;
+
+        void clear()
+        {
+            pairs.clear();
+            groups.clear();
+            cumulatedCost.clear();
+        }
+
+        /// Number of values of the matrix C
+        [[nodiscard]] Index getNbValues() const
+        {
+            return groups.empty() ? 0 : groups.back().firstValue + groups.back().width;
+        }
+
+        /**
+         * Call f(valueIndex, lhsIndex, rhsIndex) for each scalar product, value by value, in the
+         * order of the values vector of the matrix C
+         */
+        template<class Function>
+        void forEachProduct(Function f) const
+        {
+            for (const auto& group : groups)
+            {
+                for (Index i = 0; i < group.width; ++i)
+                {
+                    for (Index p = group.firstPair; p < group.lastPair; ++p)
+                    {
+                        f(group.firstValue + i, pairs[p].first + i * group.lhsShift, pairs[p].second + i * group.rhsShift);
+                    }
+                }
+            }
+        }
     };
 
+    [[nodiscard]] const Intersection& getIntersection() const { return m_intersectionAB; }
+
 protected:
     ProductResult m_productResult; /// Result of LHS * RHS
 
@@ -98,6 +162,9 @@ protected:
     void computeIntersection();
     virtual void computeProductFromIntersection();
 
+    /// Compute the values of the groups [firstGroup, lastGroup) of the intersection
+    void computeGroups(Index firstGroup, Index lastGroup);
+
     Intersection m_intersectionAB;
 
 };
@@ -23,6 +23,7 @@
 #include <sofa/linearalgebra/SparseMatrixProduct.h>
 #include <Eigen/Sparse>
 #include <sofa/type/vector.h>
+#include <algorithm>
 
 
 namespace sofa::linearalgebra::sparsematrixproduct
@@ -116,6 +117,59 @@ std::ostream& operator<<(std::ostream& o, IndexValueProduct<Scalar>& p)
     return o;
 }
 
+/**
+ * Split a list of tasks into nbRanges contiguous ranges of similar costs.
+ * cumulatedCost[i] is the cost of the tasks before the i-th task, and cumulatedCost.back() is the
+ * total cost. The returned vector contains the nbRanges + 1 boundaries of the ranges.
+ */
+inline sofa::type::vector<Eigen::Index> makeBalancedRanges(
+    const sofa::type::vector<Eigen::Index>& cumulatedCost, Eigen::Index nbRanges)
+{
+    sofa::type::vector<Eigen::Index> boundaries(nbRanges + 1, 0);
+    if (cumulatedCost.empty())
+    {
+        return boundaries;
+    }
+
+    const auto nbTasks = static_cast<Eigen::Index>(cumulatedCost.size()) - 1;
+    const auto totalCost = cumulatedCost.back();
+    for (Eigen::Index i = 1; i < nbRanges; ++i)
+    {
+        const auto targetCost = totalCost * i / nbRanges;
+        const auto it = std::lower_bound(cumulatedCost.begin(), cumulatedCost.end(), targetCost);
+        boundaries[i] = std::clamp<Eigen::Index>(std::distance(cumulatedCost.begin(), it), boundaries[i - 1], nbTasks);
+    }
+    boundaries[nbRanges] = nbTasks;
+    return boundaries;
+}
+
+/**
+ * Accumulate the scalar products of a group of consecutive values of the result. Width is the
+ * number of values in the group if it is known at compile time, 0 otherwise. MaxWidth is an upper
+ * bound of the number of values.
+ */
+template<Eigen::Index Width, Eigen::Index MaxWidth = Width, class Group, class PairIndex, class LhsScalar, class RhsScalar, class ResultScalar>
+void computeGroup(const Group& group, const PairIndex* pairs,
+    const LhsScalar* lhs, const RhsScalar* rhs, ResultScalar* result)
+{
+    static_assert(MaxWidth > 0);
+    const Eigen::Index width = Width > 0 ? Width : group.width;
+    assert(width <= MaxWidth);
+
+    ResultScalar values[MaxWidth] {};
+    for (Eigen::Index p = group.firstPair; p < group.lastPair; ++p)
+    {
+        const auto* l = lhs + pairs[p].first;
+        const auto* r = rhs + pairs[p].second;
+        for (Eigen::Index i = 0; i < width; ++i)
+        {
+            values[i] += l[i * group.lhsShift] * r[i * group.rhsShift];
+        }
+    }
+
+    std::copy_n(values, width, result + group.firstValue);
+}
+
 template<class ScalarLhs, class ScalarRhs>
 IndexValueProduct<decltype(ScalarLhs{} * ScalarRhs{})>
 operator*(const IndexedValue<ScalarLhs>& lhs, const IndexedValue<ScalarRhs>& rhs)
@@ -249,12 +303,13 @@ void SparseMatrixProduct<Lhs, Rhs, ResultType>::computeIntersection()
     const LocalResult product = lhs * rhs;
 
     const auto productNonZeros = product.nonZeros();
-    m_intersectionAB.intersection.clear();
-    m_intersectionAB.intersection.reserve(productNonZeros);
+
+    sofa::type::vector<typename Intersection::ListPairIndex> valuesIntersection;
+    valuesIntersection.reserve(productNonZeros);
 
     for (Eigen::Index i = 0; i < productNonZeros; ++i)
     {
-        m_intersectionAB.intersection.push_back(product.valuePtr()[i].getIndices());
+        valuesIntersection.push_back(product.valuePtr()[i].getIndices());
 
         //depending on the storage scheme, Eigen can change the order of the lhs and rhs
         //Note: the condition has been determined empirically, using unit tests
@@ -262,7 +317,7 @@ void SparseMatrixProduct<Lhs, Rhs, ResultType>::computeIntersection()
         if constexpr ((Lhs::IsRowMajor && Rhs::IsRowMajor && ResultType::IsRowMajor)
             || ((Lhs::IsRowMajor || Rhs::IsRowMajor) && !ResultType::IsRowMajor))
         {
-            for (auto& [lhsIndex, rhsIndex] : m_intersectionAB.intersection.back())
+            for (auto& [lhsIndex, rhsIndex] : valuesIntersection.back())
             {
                 std::swap(lhsIndex, rhsIndex);
             }
@@ -271,7 +326,7 @@ void SparseMatrixProduct<Lhs, Rhs, ResultType>::computeIntersection()
 #if !defined(NDEBUG)
         const auto lhsNonZeros = m_lhs->nonZeros();
         const auto rhsNonZeros = m_rhs->nonZeros();
-        for (const auto& [lhsIndex, rhsIndex] : m_intersectionAB.intersection.back())
+        for (const auto& [lhsIndex, rhsIndex] : valuesIntersection.back())
         {
             assert(lhsIndex < lhsNonZeros);
             assert(rhsIndex < rhsNonZeros);
@@ -279,30 +334,92 @@ void SparseMatrixProduct<Lhs, Rhs, ResultType>::computeIntersection()
 #endif
     }
 
+    // Gather the consecutive values which are computed from the same pairs of indices, up to a
+    // constant shift
+    const auto isShifted = [](const typename Intersection::ListPairIndex& first,
+        const typename Intersection::ListPairIndex& other, Index lhsShift, Index rhsShift)
+    {
+        if (first.size() != other.size())
+        {
+            return false;
+        }
+        for (std::size_t p = 0; p < first.size(); ++p)
+        {
+            if (other[p].first != first[p].first + lhsShift || other[p].second != first[p].second + rhsShift)
+            {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    m_intersectionAB.clear();
+    m_intersectionAB.cumulatedCost.push_back(0);
+
+    for (Eigen::Index i = 0; i < productNonZeros;)
+    {
+        const auto& first = valuesIntersection[i];
+
+        typename Intersection::Group group;
+        group.firstValue = i;
+        group.width = 1;
+        if (!first.empty() && i + 1 < productNonZeros && !valuesIntersection[i + 1].empty())
+        {
+            group.lhsShift = valuesIntersection[i + 1].front().first - first.front().first;
+            group.rhsShift = valuesIntersection[i + 1].front().second - first.front().second;
+            while (i + group.width < productNonZeros
+                && group.width < Intersection::MaxGroupWidth
+                && isShifted(first, valuesIntersection[i + group.width], group.width * group.lhsShift, group.width * group.rhsShift))
+            {
+                ++group.width;
+            }
+        }
+        if (group.width == 1)
+        {
+            group.lhsShift = 0;
+            group.rhsShift = 0;
+        }
+
+        group.firstPair = static_cast<Index>(m_intersectionAB.pairs.size());
+        m_intersectionAB.pairs.insert(m_intersectionAB.pairs.end(), first.begin(), first.end());
+        group.lastPair = static_cast<Index>(m_intersectionAB.pairs.size());
+
+        m_intersectionAB.groups.push_back(group);
+        m_intersectionAB.cumulatedCost.push_back(m_intersectionAB.cumulatedCost.back()
+            + group.width * static_cast<Index>(first.size()));
+
+        i += group.width;
+    }
+
     m_productResult = product.template cast<ResultScalar>();
 }
 
 template<class Lhs, class Rhs, class ResultType>
 void SparseMatrixProduct<Lhs, Rhs, ResultType>::computeProductFromIntersection()
 {
-    assert(m_intersectionAB.intersection.size() == m_productResult.nonZeros());
+    assert(m_intersectionAB.getNbValues() == m_productResult.nonZeros());
 
-    auto* lhs_ptr = m_lhs->valuePtr();
-    auto* rhs_ptr = m_rhs->valuePtr();
-    auto* product_ptr = m_productResult.valuePtr();
+    computeGroups(0, static_cast<Index>(m_intersectionAB.groups.size()));
+}
 
-    [[maybe_unused]] const auto lhsNonZeros = m_lhs->nonZeros();
-    [[maybe_unused]] const auto rhsNonZeros = m_rhs->nonZeros();
+template<class Lhs, class Rhs, class ResultType>
+void SparseMatrixProduct<Lhs, Rhs, ResultType>::computeGroups(Index firstGroup, Index lastGroup)
+{
+    const auto* lhs_ptr = m_lhs->valuePtr();
+    const auto* rhs_ptr = m_rhs->valuePtr();
+    auto* product_ptr = m_productResult.valuePtr();
+    const auto* pairs = m_intersectionAB.pairs.data();
 
-    for (const auto& pairs : m_intersectionAB.intersection)
+    for (Index g = firstGroup; g < lastGroup; ++g)
     {
-        auto& value = *product_ptr++;
-        value = 0;
-        for (const auto& [lhsIndex, rhsIndex] : pairs)
+        const auto& group = m_intersectionAB.groups[g];
+        switch (group.width)
         {
-            assert(lhsIndex < lhsNonZeros);
-            assert(rhsIndex < rhsNonZeros);
-            value += lhs_ptr[lhsIndex] * rhs_ptr[rhsIndex];
+            case 1: sparsematrixproduct::computeGroup<1>(group, pairs, lhs_ptr, rhs_ptr, product_ptr); break;
+            case 2: sparsematrixproduct::computeGroup<2>(group, pairs, lhs_ptr, rhs_ptr, product_ptr); break;
+            case 3: sparsematrixproduct::computeGroup<3>(group, pairs, lhs_ptr, rhs_ptr, product_ptr); break;
+            case 6: sparsematrixproduct::computeGroup<6>(group, pairs, lhs_ptr, rhs_ptr, product_ptr); break;
+            default: sparsematrixproduct::computeGroup<0, Intersection::MaxGroupWidth>(group, pairs, lhs_ptr, rhs_ptr, product_ptr); break;
         }
     }
 }
@@ -0,0 +1,107 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+
+#include <sofa/linearalgebra/SparseMatrixProduct.h>
+#include <sofa/type/fixed_array.h>
+
+namespace sofa::linearalgebra
+{
+
+/**
+ * Given three matrices, compute the product A*B*C.
+ * As in SparseMatrixProduct, the first computation determines the list of values of A, B and C
+ * to multiply together to obtain each value of the result. This list remains valid as long as the
+ * sparsity patterns of the three matrices do not change. The following computations use this list
+ * to compute the product in a single pass, without computing the intermediate product B*C.
+ *
+ * This is the case of the projection J^T*K*J of a matrix K by a mapping J. Compared to two
+ * successive SparseMatrixProduct, no intermediate matrix is written and read back, but the products
+ * shared by several values of the result are not factorized anymore: the list of triplets of indices
+ * can be much larger than the lists of pairs of indices of both products.
+ *
+ * To compute the product, the method computeProduct must be called.
+ */
+template<class A, class B, class C, class IntermediateType, class ResultType>
+class SparseMatrixTripleProduct
+{
+public:
+
+    using ACleaned = std::decay_t<A>;
+    using BCleaned = std::decay_t<B>;
+    using CCleaned = std::decay_t<C>;
+    using ResultCleaned = std::decay_t<ResultType>;
+
+    using ResultScalar = typename ResultCleaned::Scalar;
+
+    /// Left side of the product A*B*C
+    const ACleaned* m_a { nullptr };
+    /// Middle of the product A*B*C
+    const BCleaned* m_b { nullptr };
+    /// Right side of the product A*B*C
+    const CCleaned* m_c { nullptr };
+
+    using Index = Eigen::Index;
+
+    void computeProduct(bool forceComputeIntersection = false);
+
+    [[nodiscard]] const ResultType& getProductResult() const { return m_productResult; }
+
+    void invalidateIntersection();
+
+    SparseMatrixTripleProduct(A* a, B* b, C* c) : m_a(a), m_b(b), m_c(c) {}
+    SparseMatrixTripleProduct() = default;
+    virtual ~SparseMatrixTripleProduct() = default;
+
+    struct Intersection
+    {
+        /// Three indices: in the values vectors of the matrices A, B and C
+        using TripletIndex = sofa::type::fixed_array<Index, 3>;
+
+        /// Triplets of indices of all the values of the result, stored contiguously
+        sofa::type::vector<TripletIndex> triplets;
+
+        /// The triplets of the i-th value of the result are in [offsets[i], offsets[i+1]).
+        /// It is also the cost of computing the values before the i-th value.
+        sofa::type::vector<Index> offsets;
+    };
+
+    [[nodiscard]] const Intersection& getIntersection() const { return m_intersectionABC; }
+
+protected:
+    ResultType m_productResult; /// Result of A * B * C
+
+    bool m_hasComputedIntersection { false };
+    void computeIntersection();
+    virtual void computeProductFromIntersection();
+
+    /// Compute the values [firstValue, lastValue) of the result
+    void computeValues(Index firstValue, Index lastValue);
+
+    Intersection m_intersectionABC;
+
+    /// Products used to compute the intersection
+    SparseMatrixProduct<B, C, IntermediateType> m_productBC;
+    SparseMatrixProduct<A, IntermediateType, ResultType> m_productABC;
+};
+
+}// sofa::linearalgebra
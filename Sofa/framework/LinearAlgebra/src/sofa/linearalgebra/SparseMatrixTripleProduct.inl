@@ -0,0 +1,139 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+#include <sofa/linearalgebra/SparseMatrixTripleProduct.h>
+#include <sofa/linearalgebra/SparseMatrixProduct.inl>
+#include <numeric>
+
+namespace sofa::linearalgebra
+{
+
+template<class A, class B, class C, class IntermediateType, class ResultType>
+void SparseMatrixTripleProduct<A, B, C, IntermediateType, ResultType>::computeProduct(bool forceComputeIntersection)
+{
+    if (forceComputeIntersection)
+    {
+        m_hasComputedIntersection = false;
+    }
+
+    if (m_hasComputedIntersection == false)
+    {
+        computeIntersection();
+        m_hasComputedIntersection = true;
+    }
+    else
+    {
+        computeProductFromIntersection();
+    }
+}
+
+template<class A, class B, class C, class IntermediateType, class ResultType>
+void SparseMatrixTripleProduct<A, B, C, IntermediateType, ResultType>::computeIntersection()
+{
+    m_productBC.m_lhs = m_b;
+    m_productBC.m_rhs = m_c;
+    m_productBC.computeProduct(true);
+
+    m_productABC.m_lhs = m_a;
+    m_productABC.m_rhs = &m_productBC.getProductResult();
+    m_productABC.computeProduct(true);
+
+    // pairs of indices in B and C of each value of B*C, stored contiguously
+    const auto& intersectionBC = m_productBC.getIntersection();
+    const auto nbValuesBC = intersectionBC.getNbValues();
+    sofa::type::vector<Index> offsetsBC(nbValuesBC + 1, 0);
+    intersectionBC.forEachProduct([&offsetsBC](Index value, Index, Index)
+    {
+        ++offsetsBC[value + 1];
+    });
+    std::partial_sum(offsetsBC.begin(), offsetsBC.end(), offsetsBC.begin());
+
+    typename SparseMatrixProduct<B, C, IntermediateType>::Intersection::ListPairIndex pairsBC;
+    pairsBC.reserve(offsetsBC.back());
+    intersectionBC.forEachProduct([&pairsBC](Index, Index b, Index c)
+    {
+        pairsBC.emplace_back(b, c);
+    });
+
+    // expand each product A*(B*C) into the products A*B*C
+    const auto& intersectionABC = m_productABC.getIntersection();
+    auto& offsets = m_intersectionABC.offsets;
+    offsets.assign(intersectionABC.getNbValues() + 1, 0);
+    intersectionABC.forEachProduct([&offsets, &offsetsBC](Index value, Index, Index bc)
+    {
+        offsets[value + 1] += offsetsBC[bc + 1] - offsetsBC[bc];
+    });
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+    auto& triplets = m_intersectionABC.triplets;
+    triplets.clear();
+    triplets.reserve(offsets.back());
+    intersectionABC.forEachProduct([&triplets, &offsetsBC, &pairsBC](Index, Index a, Index bc)
+    {
+        for (Index p = offsetsBC[bc]; p < offsetsBC[bc + 1]; ++p)
+        {
+            triplets.push_back({a, pairsBC[p].first, pairsBC[p].second});
+        }
+    });
+
+    m_productResult = m_productABC.getProductResult();
+    assert(static_cast<Index>(offsets.size()) == m_productResult.nonZeros() + 1);
+}
+
+template<class A, class B, class C, class IntermediateType, class ResultType>
+void SparseMatrixTripleProduct<A, B, C, IntermediateType, ResultType>::computeProductFromIntersection()
+{
+    assert(static_cast<Index>(m_intersectionABC.offsets.size()) == m_productResult.nonZeros() + 1);
+
+    computeValues(0, m_productResult.nonZeros());
+}
+
+template<class A, class B, class C, class IntermediateType, class ResultType>
+void SparseMatrixTripleProduct<A, B, C, IntermediateType, ResultType>::computeValues(Index firstValue, Index lastValue)
+{
+    const auto* a_ptr = m_a->valuePtr();
+    const auto* b_ptr = m_b->valuePtr();
+    const auto* c_ptr = m_c->valuePtr();
+    auto* product_ptr = m_productResult.valuePtr();
+
+    const auto* offsets = m_intersectionABC.offsets.data();
+    const auto* triplets = m_intersectionABC.triplets.data();
+
+    for (Index i = firstValue; i < lastValue; ++i)
+    {
+        ResultScalar value = 0;
+        for (Index t = offsets[i]; t < offsets[i + 1]; ++t)
+        {
+            const auto& triplet = triplets[t];
+            value += a_ptr[triplet[0]] * b_ptr[triplet[1]] * c_ptr[triplet[2]];
+        }
+        product_ptr[i] = value;
+    }
+}
+
+template<class A, class B, class C, class IntermediateType, class ResultType>
+void SparseMatrixTripleProduct<A, B, C, IntermediateType, ResultType>::invalidateIntersection()
+{
+    m_hasComputedIntersection = false;
+}
+
+}
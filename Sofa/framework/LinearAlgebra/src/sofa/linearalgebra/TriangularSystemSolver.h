@@ -40,15 +40,16 @@ namespace sofa::linearalgebra
 /// \param solutionVector The solution vector
 /// \param CSR_rows The array storing the starting index of each row in the data array.
 /// \param CSR_columns The array storing the column indices of the nonzero values in the data array.
-/// \param CSR_values The array containing the nonzero values of the matrix
-template<typename Real, typename Integer>
+/// \param CSR_values The array containing the nonzero values of the matrix. They can be stored with a
+/// lower precision than the vectors: the substitution is accumulated in the precision of the vectors.
+template<typename Real, typename Integer, typename MatrixReal>
 void solveLowerUnitriangularSystemCSR(
     const sofa::Size systemSize,
     const Real* rightHandSideVector,
     Real* solutionVector,
     const Integer* const CSR_rows,
     const Integer* const CSR_columns,
-    const Real* const CSR_values
+    const MatrixReal* const CSR_values
     )
 {
     for (sofa::Size i = 0; i < systemSize; ++i)
@@ -56,7 +57,7 @@ void solveLowerUnitriangularSystemCSR(
         Real x_i = rightHandSideVector[i];
         for (Integer p = CSR_rows[i]; p < CSR_rows[i + 1]; ++p)
         {
-            x_i -= CSR_values[p] * solutionVector[CSR_columns[p]];
+            x_i -= static_cast<Real>(CSR_values[p]) * solutionVector[CSR_columns[p]];
         }
         solutionVector[i] = x_i;
     }
@@ -75,15 +76,16 @@ void solveLowerUnitriangularSystemCSR(
 /// \param solutionVector The solution vector
 /// \param CSR_rows The array storing the starting index of each row in the data array.
 /// \param CSR_columns The array storing the column indices of the nonzero values in the data array.
-/// \param CSR_values The array containing the nonzero values of the matrix
-template<typename Real, typename Integer>
+/// \param CSR_values The array containing the nonzero values of the matrix. They can be stored with a
+/// lower precision than the vectors: the substitution is accumulated in the precision of the vectors.
+template<typename Real, typename Integer, typename MatrixReal>
 void solveUpperUnitriangularSystemCSR(
     const sofa::Size systemSize,
     const Real* rightHandSideVector,
     Real* solutionVector,
     const Integer* const CSR_rows,
     const Integer* const CSR_columns,
-    const Real* const CSR_values
+    const MatrixReal* const CSR_values
     )
 {
     for (sofa::Size i = systemSize - 1; i != static_cast<sofa::Size>(-1); --i)
@@ -91,7 +93,7 @@ void solveUpperUnitriangularSystemCSR(
         Real x_i = rightHandSideVector[i];
         for (Integer p = CSR_rows[i]; p < CSR_rows[i + 1]; ++p)
         {
-            x_i -= CSR_values[p] * solutionVector[CSR_columns[p]];
+            x_i -= static_cast<Real>(CSR_values[p]) * solutionVector[CSR_columns[p]];
         }
         solutionVector[i] = x_i;
     }
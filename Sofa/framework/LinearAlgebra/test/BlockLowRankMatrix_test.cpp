@@ -0,0 +1,223 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/linearalgebra/BlockLowRankMatrix.h>
+#include <sofa/helper/system/FileRepository.h>
+#include <sofa/helper/system/FileSystem.h>
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+namespace sofa
+{
+
+namespace
+{
+
+/// Smooth kernel on points along a line: the tiles far from the diagonal have a low numerical rank
+std::vector<double> kernelMatrix(sofa::Size n)
+{
+    std::vector<double> dense(std::size_t(n) * n);
+    for (sofa::Index i = 0; i < n; ++i)
+    {
+        for (sofa::Index j = 0; j < n; ++j)
+        {
+            dense[std::size_t(i) * n + j] = 1.0 / (1.0 + std::abs(double(i) - double(j)));
+        }
+    }
+    return dense;
+}
+
+/// Maximum difference between the compressed matrix and the dense one
+double maxError(const linearalgebra::BlockLowRankMatrix& m, const std::vector<double>& dense)
+{
+    double error = 0;
+    for (sofa::Index i = 0; i < m.size(); ++i)
+    {
+        for (sofa::Index j = 0; j < m.size(); ++j)
+        {
+            error = std::max(error, std::abs(m.element(i, j) - dense[std::size_t(i) * m.size() + j]));
+        }
+    }
+    return error;
+}
+
+}
+
+TEST(BlockLowRankMatrix, denseStorage)
+{
+    constexpr sofa::Size n = 100;
+    std::vector<double> dense = kernelMatrix(n);
+    dense[3 * n + 70] = 5; // not symmetric
+
+    linearalgebra::BlockLowRankMatrix m;
+    linearalgebra::BlockLowRankMatrix::Options options;
+    options.singlePrecision = false;
+    options.symmetric = false;
+    options.tileSize = 32;
+    m.compress(dense.data(), n, options);
+
+    EXPECT_EQ(m.size(), n);
+    EXPECT_FALSE(m.isSymmetric());
+    EXPECT_EQ(m.getNbLowRankTiles(), 0u);
+    EXPECT_EQ(maxError(m, dense), 0.);
+    EXPECT_GE(m.memorySize(), n * n * sizeof(double));
+}
+
+TEST(BlockLowRankMatrix, symmetricSinglePrecision)
+{
+    constexpr sofa::Size n = 100;
+    const std::vector<double> dense = kernelMatrix(n);
+
+    linearalgebra::BlockLowRankMatrix m;
+    linearalgebra::BlockLowRankMatrix::Options options;
+    options.tileSize = 32;
+    m.compress(dense.data(), n, options);
+
+    EXPECT_TRUE(m.isSinglePrecision());
+    EXPECT_TRUE(m.isSymmetric());
+    EXPECT_LT(maxError(m, dense), 1e-7);
+    // lower part only, in float
+    EXPECT_LT(m.memorySize(), n * n * sizeof(float) * 6 / 10);
+
+    float block[6];
+    m.getBlock(40, 10, 2, 3, block);
+    for (sofa::Index r = 0; r < 2; ++r)
+    {
+        for (sofa::Index c = 0; c < 3; ++c)
+        {
+            EXPECT_FLOAT_EQ(block[r * 3 + c], static_cast<float>(dense[(40 + r) * n + 10 + c]));
+        }
+    }
+}
+
+TEST(BlockLowRankMatrix, lowRankTiles)
+{
+    constexpr sofa::Size n = 256;
+    const std::vector<double> dense = kernelMatrix(n);
+
+    linearalgebra::BlockLowRankMatrix packed;
+    linearalgebra::BlockLowRankMatrix::Options options;
+    options.tileSize = 32;
+    packed.compress(dense.data(), n, options);
+
+    linearalgebra::BlockLowRankMatrix m;
+    options.tolerance = 1e-5;
+    m.compress(dense.data(), n, options);
+
+    EXPECT_GT(m.getNbLowRankTiles(), 0u);
+    EXPECT_LT(m.memorySize(), packed.memorySize() / 2);
+    EXPECT_LT(maxError(m, dense), 1e-5);
+}
+
+TEST(BlockLowRankMatrix, saveAndMap)
+{
+    constexpr sofa::Size n = 150;
+    const std::vector<double> dense = kernelMatrix(n);
+
+    linearalgebra::BlockLowRankMatrix m;
+    linearalgebra::BlockLowRankMatrix::Options options;
+    options.tileSize = 32;
+    options.tolerance = 1e-5;
+    m.compress(dense.data(), n, options);
+
+    const std::string filename = helper::system::FileSystem::append(helper::system::FileRepository().getTempPath(), "BlockLowRankMatrix_test.blr");
+    ASSERT_TRUE(m.save(filename));
+    EXPECT_TRUE(linearalgebra::BlockLowRankMatrix::isBlockLowRankFile(filename));
+
+    {
+        linearalgebra::BlockLowRankMatrix loaded;
+        ASSERT_TRUE(loaded.load(filename));
+        EXPECT_TRUE(loaded.isMapped());
+        EXPECT_EQ(loaded.size(), n);
+        EXPECT_EQ(loaded.memorySize(), m.memorySize());
+        EXPECT_EQ(loaded.getNbLowRankTiles(), m.getNbLowRankTiles());
+        for (sofa::Index i = 0; i < n; ++i)
+        {
+            for (sofa::Index j = 0; j < n; ++j)
+            {
+                EXPECT_EQ(loaded.element(i, j), m.element(i, j));
+            }
+        }
+    }
+
+    helper::system::FileSystem::removeFile(filename);
+}
+
+TEST(BlockLowRankMatrix, rejectCorruptedFile)
+{
+    constexpr sofa::Size n = 150;
+    const std::vector<double> dense = kernelMatrix(n);
+
+    linearalgebra::BlockLowRankMatrix m;
+    linearalgebra::BlockLowRankMatrix::Options options;
+    options.tileSize = 32;
+    options.tolerance = 1e-5;
+    m.compress(dense.data(), n, options);
+
+    const std::string filename = helper::system::FileSystem::append(helper::system::FileRepository().getTempPath(), "BlockLowRankMatrix_corrupted_test.blr");
+    ASSERT_TRUE(m.save(filename));
+
+    std::vector<char> content;
+    {
+        std::ifstream in(filename, std::ifstream::binary);
+        content.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    ASSERT_EQ(content.size(), m.memorySize());
+
+    const auto write = [&filename](const std::vector<char>& values)
+    {
+        std::ofstream out(filename, std::ofstream::binary | std::ofstream::trunc);
+        out.write(values.data(), static_cast<std::streamsize>(values.size()));
+    };
+
+    // truncated values of the last tile
+    write(std::vector<char>(content.begin(), content.end() - 1));
+    {
+        linearalgebra::BlockLowRankMatrix loaded;
+        EXPECT_FALSE(loaded.load(filename));
+        EXPECT_TRUE(loaded.empty());
+    }
+
+    // offset of the first tile past the end of the file (the offset is the first field of the tile, after the header)
+    {
+        std::vector<char> corrupted = content;
+        const std::uint64_t offset = content.size();
+        std::memcpy(corrupted.data() + 32, &offset, sizeof(offset));
+        write(corrupted);
+        linearalgebra::BlockLowRankMatrix loaded;
+        EXPECT_FALSE(loaded.load(filename));
+    }
+
+    // the original file is still accepted
+    write(content);
+    {
+        linearalgebra::BlockLowRankMatrix loaded;
+        EXPECT_TRUE(loaded.load(filename));
+    }
+
+    helper::system::FileSystem::removeFile(filename);
+}
+
+}
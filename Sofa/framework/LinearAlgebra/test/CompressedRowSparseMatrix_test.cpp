@@ -20,6 +20,7 @@
 * Contact information: contact@sofa-framework.org                             *
 ******************************************************************************/
 #include <sofa/linearalgebra/CompressedRowSparseMatrix.h>
+#include <sofa/linearalgebra/FullVector.h>
 
 #include <Eigen/Sparse>
 
@@ -354,3 +355,51 @@ TEST(CompressedRowSparseMatrix, emptyMatrixGetRowRange)
     EXPECT_EQ(range.first, sofa::linearalgebra::CompressedRowSparseMatrixMechanical<SReal>::s_invalidIndex);
     EXPECT_EQ(range.second, sofa::linearalgebra::CompressedRowSparseMatrixMechanical<SReal>::s_invalidIndex);
 }
+
+/// A matrix of single precision blocks applied to double precision vectors accumulates in double precision:
+/// the products are the same as with the same matrix stored in double precision
+TEST(CompressedRowSparseMatrix, mixedPrecisionProduct)
+{
+    constexpr sofa::Index nbBlocks = 40;
+    sofa::linearalgebra::CompressedRowSparseMatrix<sofa::type::Mat<3, 3, float> > Af;
+    sofa::linearalgebra::CompressedRowSparseMatrix<sofa::type::Mat<3, 3, double> > Ad;
+    Af.resize(3 * nbBlocks, 3 * nbBlocks);
+    Ad.resize(3 * nbBlocks, 3 * nbBlocks);
+
+    sofa::testing::LinearCongruentialRandomGenerator lcg(96547);
+    for (sofa::Index r = 0; r < 3 * nbBlocks; ++r)
+    {
+        // dense rows, so that an accumulation in single precision would lose the small entries of the vector
+        for (sofa::Index c = 0; c < 3 * nbBlocks; ++c)
+        {
+            const float value = static_cast<float>(lcg.generateInRange(-1., 1.));
+            Af.add(r, c, value);
+            Ad.add(r, c, static_cast<double>(value));
+        }
+    }
+    Af.compress();
+    Ad.compress();
+
+    sofa::linearalgebra::FullVector<double> v(3 * nbBlocks);
+    for (sofa::Index i = 0; i < v.size(); ++i)
+    {
+        v[i] = 1.0 + 1e-10 * i;
+    }
+
+    sofa::linearalgebra::FullVector<double> resultF, resultD;
+    Af.mul(resultF, v);
+    Ad.mul(resultD, v);
+    ASSERT_EQ(resultF.size(), resultD.size());
+    for (sofa::Index i = 0; i < resultD.size(); ++i)
+    {
+        EXPECT_NEAR(resultF[i], resultD[i], 1e-13 * (1 + std::abs(resultD[i]))) << "mul at " << i;
+    }
+
+    // res += A * v
+    Af.addMul(resultF, v);
+    Ad.addMul(resultD, v);
+    for (sofa::Index i = 0; i < resultD.size(); ++i)
+    {
+        EXPECT_NEAR(resultF[i], resultD[i], 1e-13 * (1 + std::abs(resultD[i]))) << "addMul at " << i;
+    }
+}
@@ -21,6 +21,8 @@
 ******************************************************************************/
 #include <Sofa.LinearAlgebra.Testing/SparseMatrixProduct_test.h>
 #include <sofa/linearalgebra/SparseMatrixProduct.inl>
+#include <sofa/linearalgebra/SparseMatrixTripleProduct.inl>
+#include <random>
 
 namespace sofa
 {
@@ -57,4 +59,89 @@ INSTANTIATE_TYPED_TEST_SUITE_P(
     TestSparseMatrixProductImplementations
 );
 
+/// Random sparse matrix made of dense blocks of size BlockSize x BlockSize
+template<int BlockSize, int Options>
+Eigen::SparseMatrix<double, Options> makeBlockMatrix(Eigen::Index nbBlockRows, Eigen::Index nbBlockCols, double density, unsigned int seed)
+{
+    std::mt19937 generator(seed);
+    std::uniform_real_distribution<double> value(-1, 1);
+    std::bernoulli_distribution isNonZero(density);
+
+    std::vector<Eigen::Triplet<double> > triplets;
+    for (Eigen::Index bi = 0; bi < nbBlockRows; ++bi)
+    {
+        for (Eigen::Index bj = 0; bj < nbBlockCols; ++bj)
+        {
+            if (isNonZero(generator))
+            {
+                for (int i = 0; i < BlockSize; ++i)
+                    for (int j = 0; j < BlockSize; ++j)
+                        triplets.emplace_back(bi * BlockSize + i, bj * BlockSize + j, value(generator));
+            }
+        }
+    }
+
+    Eigen::SparseMatrix<double, Options> matrix(nbBlockRows * BlockSize, nbBlockCols * BlockSize);
+    matrix.setFromTriplets(triplets.begin(), triplets.end());
+    return matrix;
+}
+
+template<class Product>
+void checkProductValues(const Product& product, const Eigen::SparseMatrix<double, Eigen::RowMajor>& expected)
+{
+    const Eigen::SparseMatrix<double, Eigen::RowMajor> result = product.getProductResult();
+    EXPECT_EQ(result.nonZeros(), expected.nonZeros());
+    EXPECT_NEAR((result - expected).norm(), 0, 1e-10 * expected.norm());
+}
+
+TEST(SparseMatrixProduct, blockMatrices)
+{
+    using RowMajor = Eigen::SparseMatrix<double, Eigen::RowMajor>;
+    using ColMajor = Eigen::SparseMatrix<double, Eigen::ColMajor>;
+
+    RowMajor A = makeBlockMatrix<3, Eigen::RowMajor>(40, 30, 0.2, 0);
+    ColMajor B = makeBlockMatrix<3, Eigen::ColMajor>(30, 50, 0.2, 1);
+
+    linearalgebra::SparseMatrixProduct<RowMajor, ColMajor, RowMajor> product(&A, &B);
+    product.computeProduct();
+    product.computeProduct(); //uses the intersection
+
+    checkProductValues(product, RowMajor(A * B));
+
+    // the values in a row of a block are computed together: the pairs of indices are stored
+    // at most once for 3 values
+    const auto& intersection = product.getIntersection();
+    EXPECT_EQ(intersection.getNbValues(), product.getProductResult().nonZeros());
+    EXPECT_LE(intersection.groups.size() * 3, static_cast<std::size_t>(intersection.getNbValues()));
+    EXPECT_LE(static_cast<Eigen::Index>(intersection.pairs.size()) * 3, intersection.cumulatedCost.back());
+}
+
+TEST(SparseMatrixTripleProduct, projection)
+{
+    using RowMajor = Eigen::SparseMatrix<double, Eigen::RowMajor>;
+    using ColMajor = Eigen::SparseMatrix<double, Eigen::ColMajor>;
+    using Transposed = const Eigen::Transpose<const RowMajor>;
+
+    RowMajor K = makeBlockMatrix<3, Eigen::RowMajor>(30, 30, 0.1, 2);
+    RowMajor J = makeBlockMatrix<3, Eigen::RowMajor>(30, 20, 0.1, 3);
+    const RowMajor& constJ = J;
+    Transposed JT = constJ.transpose();
+
+    linearalgebra::SparseMatrixTripleProduct<Transposed, RowMajor, RowMajor, ColMajor, RowMajor> product(&JT, &K, &J);
+    product.computeProduct();
+    checkProductValues(product, RowMajor(J.transpose() * K * J));
+
+    // modify the values of J, but not its pattern
+    for (Eigen::Index i = 0; i < J.nonZeros(); ++i)
+    {
+        J.valuePtr()[i] *= 2;
+    }
+    product.computeProduct(); //uses the intersection
+    checkProductValues(product, RowMajor(J.transpose() * K * J));
+
+    const auto& intersection = product.getIntersection();
+    EXPECT_EQ(intersection.offsets.size(), product.getProductResult().nonZeros() + 1);
+    EXPECT_EQ(intersection.triplets.size(), intersection.offsets.back());
+}
+
 }
@@ -72,13 +72,14 @@ This loop triggers the following steps:
 DefaultAnimationLoop::DefaultAnimationLoop(simulation::Node* _m_node)
     : Inherit()
     , d_parallelODESolving(initData(&d_parallelODESolving, false, "parallelODESolving", "If true, solves all the ODEs in parallel"))
+    , d_parallelForceFields(initData(&d_parallelForceFields, false, "parallelForceFields", "If true, computes the force fields of a same node in parallel, each one accumulating in its own force vector"))
 {
     SOFA_UNUSED(_m_node);
-    this->addUpdateCallback("parallelODESolving", {&d_parallelODESolving},
+    this->addUpdateCallback("parallelODESolving", {&d_parallelODESolving, &d_parallelForceFields},
     [this](const core::DataTracker& tracker) -> sofa::core::objectmodel::ComponentState
     {
         SOFA_UNUSED(tracker);
-        if (d_parallelODESolving.getValue())
+        if (d_parallelODESolving.getValue() || d_parallelForceFields.getValue())
         {
             simulation::TaskScheduler* taskScheduler = simulation::MainTaskSchedulerFactory::createInRegistry();
             assert(taskScheduler);
@@ -315,6 +316,11 @@ void DefaultAnimationLoop::step(const core::ExecParams* params, SReal dt)
     simulation::Visitor::printNode("Step");
 #endif
 
+    // the parameters given to the visitors of the step request the parallel computation of the force fields
+    core::ExecParams stepParams(*params);
+    stepParams.setParallelForceFields(d_parallelForceFields.getValue());
+    params = &stepParams;
+
     propagateAnimateBeginEvent(params, dt);
     animate(params, dt);
     updateSimulationContext(params, dt, m_node->getTime());
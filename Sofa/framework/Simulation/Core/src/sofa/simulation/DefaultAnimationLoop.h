@@ -55,6 +55,7 @@ protected:
 
 public:
     Data<bool> d_parallelODESolving; ///< If true, solves all the ODEs in parallel
+    Data<bool> d_parallelForceFields; ///< If true, computes the force fields of a same node in parallel
 
     void init() override;
 
@@ -0,0 +1,378 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+#include <sofa/simulation/config.h>
+#include <sofa/simulation/ParallelForEach.h>
+#include <sofa/simulation/TaskScheduler.h>
+#include <sofa/simulation/Locks.h>
+#include <sofa/linearalgebra/CompressedRowSparseMatrixGeneric.h>
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <numeric>
+#include <thread>
+
+
+namespace sofa::simulation
+{
+
+/**
+ * Assemble a CompressedRowSparseMatrix from blocks added concurrently by several threads.
+ *
+ * Each thread accumulates its blocks in its own buffer of triplets, without any lock. The buffers
+ * are then merged into the matrix by compress(): a counting sort on the row indices distributes
+ * the triplets of all the buffers into rows, then each row is sorted on the column indices and the
+ * duplicated blocks are summed. Both steps are executed in parallel if a task scheduler is provided.
+ *
+ * If a pattern is provided with setPattern(), the blocks which already exist in the pattern are
+ * directly accumulated in the matrix, under the lock of their row. Only the blocks outside of the
+ * pattern are buffered. It is the fast path when the sparsity pattern does not change between two
+ * assemblies.
+ *
+ * add() can be called concurrently, but not concurrently with the other methods.
+ *
+ * This class is a building block only: the linear systems (e.g. MatrixLinearSystem) still assemble their
+ * matrices sequentially through their matrix accumulators, and do not use it.
+ */
+template<class TMatrix>
+class ParallelCompressedRowSparseMatrixBuilder
+{
+public:
+    using Matrix = TMatrix;
+    using Block = typename Matrix::Block;
+    using Index = typename Matrix::Index;
+    using traits = typename Matrix::traits;
+
+    struct Triplet
+    {
+        Index row;
+        Index col;
+        Block value;
+    };
+
+    /// The task scheduler used to compress the buffers. If null, the compression is sequential.
+    TaskScheduler* taskScheduler { nullptr };
+
+    ParallelCompressedRowSparseMatrixBuilder() = default;
+    ParallelCompressedRowSparseMatrixBuilder(const ParallelCompressedRowSparseMatrixBuilder&) = delete;
+    ParallelCompressedRowSparseMatrixBuilder& operator=(const ParallelCompressedRowSparseMatrixBuilder&) = delete;
+
+    /// Accumulate a block. Thread-safe.
+    void add(Index row, Index col, const Block& value)
+    {
+        if (m_pattern && addInPattern(row, col, value))
+        {
+            return;
+        }
+
+        ThreadBuffer& buffer = getThreadBuffer();
+        buffer.triplets.push_back({row, col, value});
+        buffer.maxRow = std::max(buffer.maxRow, row);
+        buffer.maxCol = std::max(buffer.maxCol, col);
+    }
+
+    /**
+     * Enable the row-locked insertion in the existing pattern of a matrix. The matrix is compressed,
+     * and must not be modified outside of this builder until compress() is called on it.
+     * A null pointer disables the fast path.
+     */
+    void setPattern(Matrix* matrix)
+    {
+        m_pattern = matrix;
+        m_rowLocks.reset();
+        if (m_pattern)
+        {
+            m_pattern->compress();
+            m_rowLocks = std::make_unique<SpinLock[]>(m_pattern->rowIndex.size());
+        }
+    }
+
+    Matrix* getPattern() const { return m_pattern; }
+
+    /// Number of blocks buffered since the last call to compress() or clear()
+    std::size_t getNbBufferedBlocks() const
+    {
+        return std::accumulate(m_buffers.begin(), m_buffers.end(), std::size_t{0},
+            [](std::size_t sum, const ThreadBuffer& buffer) { return sum + buffer.triplets.size(); });
+    }
+
+    /// Discard the buffered blocks. The memory of the buffers is kept for the next assembly.
+    void clear()
+    {
+        for (auto& buffer : m_buffers)
+        {
+            buffer.clear();
+        }
+    }
+
+    /**
+     * Add the buffered blocks to the matrix, and clear the buffers. The blocks already in the matrix
+     * are kept. The matrix is enlarged if a buffered block is out of its bounds.
+     */
+    void compress(Matrix& matrix)
+    {
+        matrix.compress();
+
+        const std::size_t nbBufferedBlocks = getNbBufferedBlocks();
+        if (nbBufferedBlocks == 0)
+        {
+            return;
+        }
+
+        Index nbRows = matrix.nBlockRow;
+        Index nbCols = matrix.nBlockCol;
+        for (const auto& buffer : m_buffers)
+        {
+            nbRows = std::max(nbRows, buffer.maxRow + 1);
+            nbCols = std::max(nbCols, buffer.maxCol + 1);
+        }
+
+        const std::size_t nbBuffers = m_buffers.size();
+
+        // number of blocks of each buffer in each row
+        m_rowCounts.resize(nbBuffers);
+        forEachIndex(0, nbBuffers, [this, nbRows](std::size_t b)
+        {
+            auto& counts = m_rowCounts[b];
+            counts.assign(nbRows, 0);
+            for (const auto& t : m_buffers[b].triplets)
+            {
+                ++counts[t.row];
+            }
+        });
+
+        // number of existing blocks in each row
+        m_existingCounts.assign(nbRows, 0);
+        const auto nbExistingRows = static_cast<Index>(matrix.rowIndex.size());
+        for (Index r = 0; r < nbExistingRows; ++r)
+        {
+            m_existingCounts[matrix.rowIndex[r]] = matrix.rowBegin[r + 1] - matrix.rowBegin[r];
+        }
+
+        // offset of each row in the sorted array, and offset of each buffer in each row
+        m_rowOffsets.resize(nbRows + 1);
+        m_rowOffsets[0] = 0;
+        for (Index r = 0; r < nbRows; ++r)
+        {
+            std::size_t offset = m_rowOffsets[r] + m_existingCounts[r];
+            for (std::size_t b = 0; b < nbBuffers; ++b)
+            {
+                const auto count = m_rowCounts[b][r];
+                m_rowCounts[b][r] = offset;
+                offset += count;
+            }
+            m_rowOffsets[r + 1] = offset;
+        }
+
+        // scatter the existing blocks, then the buffered blocks, in their rows
+        m_sorted.resize(m_rowOffsets[nbRows]);
+        forEachIndex(0, static_cast<std::size_t>(nbExistingRows), [this, &matrix](std::size_t r)
+        {
+            const Index row = matrix.rowIndex[r];
+            auto offset = m_rowOffsets[row];
+            for (Index k = matrix.rowBegin[r]; k < matrix.rowBegin[r + 1]; ++k)
+            {
+                m_sorted[offset++] = {row, matrix.colsIndex[k], matrix.colsValue[k]};
+            }
+        });
+        forEachIndex(0, nbBuffers, [this](std::size_t b)
+        {
+            auto& offsets = m_rowCounts[b];
+            for (const auto& t : m_buffers[b].triplets)
+            {
+                m_sorted[offsets[t.row]++] = t;
+            }
+        });
+
+        // sort each row on the column indices, and sum the duplicated blocks
+        m_rowSizes.resize(nbRows);
+        forEachIndex(0, static_cast<std::size_t>(nbRows), [this](std::size_t r)
+        {
+            const auto begin = m_sorted.begin() + m_rowOffsets[r];
+            const auto end = m_sorted.begin() + m_rowOffsets[r + 1];
+            std::stable_sort(begin, end, [](const Triplet& a, const Triplet& b) { return a.col < b.col; });
+
+            auto last = begin;
+            for (auto it = begin; it != end;)
+            {
+                Triplet merged = *it;
+                for (++it; it != end && it->col == merged.col; ++it)
+                {
+                    merged.value += it->value;
+                }
+                if constexpr (Matrix::Policy::CompressZeros)
+                {
+                    if (traits::empty(merged.value))
+                    {
+                        continue;
+                    }
+                }
+                *last++ = merged;
+            }
+            m_rowSizes[r] = static_cast<Index>(std::distance(begin, last));
+        });
+
+        // build the compressed structure
+        matrix.nBlockRow = nbRows;
+        matrix.nBlockCol = nbCols;
+        matrix.rowIndex.clear();
+        matrix.rowBegin.clear();
+        matrix.rowBegin.push_back(0);
+        for (Index r = 0; r < nbRows; ++r)
+        {
+            if (m_rowSizes[r] > 0)
+            {
+                matrix.rowIndex.push_back(r);
+                matrix.rowBegin.push_back(matrix.rowBegin.back() + m_rowSizes[r]);
+            }
+        }
+        matrix.colsIndex.resize(matrix.rowBegin.back());
+        matrix.colsValue.resize(matrix.rowBegin.back());
+        forEachIndex(0, matrix.rowIndex.size(), [this, &matrix](std::size_t r)
+        {
+            auto src = m_sorted.begin() + m_rowOffsets[matrix.rowIndex[r]];
+            for (Index k = matrix.rowBegin[r]; k < matrix.rowBegin[r + 1]; ++k, ++src)
+            {
+                matrix.colsIndex[k] = src->col;
+                matrix.colsValue[k] = src->value;
+            }
+        });
+        matrix.skipCompressZero = true;
+
+        clear();
+
+        if (m_pattern == &matrix)
+        {
+            m_rowLocks = std::make_unique<SpinLock[]>(matrix.rowIndex.size());
+        }
+    }
+
+protected:
+
+    struct ThreadBuffer
+    {
+        std::thread::id owner;
+        sofa::type::vector<Triplet> triplets;
+        Index maxRow { -1 };
+        Index maxCol { -1 };
+
+        void clear()
+        {
+            triplets.clear();
+            maxRow = -1;
+            maxCol = -1;
+        }
+    };
+
+    /// Returns the buffer of the calling thread. The lock is only taken the first time a thread
+    /// adds a block in this builder.
+    ThreadBuffer& getThreadBuffer()
+    {
+        struct Cache
+        {
+            const ParallelCompressedRowSparseMatrixBuilder* builder { nullptr };
+            std::uint64_t builderId { 0 };
+            ThreadBuffer* buffer { nullptr };
+        };
+        thread_local Cache cache;
+
+        if (cache.builder != this || cache.builderId != m_id)
+        {
+            ScopedLock lock(m_buffersLock);
+            const auto threadId = std::this_thread::get_id();
+            auto it = std::find_if(m_buffers.begin(), m_buffers.end(),
+                [threadId](const ThreadBuffer& buffer) { return buffer.owner == threadId; });
+            if (it == m_buffers.end())
+            {
+                it = m_buffers.emplace(m_buffers.end());
+                it->owner = threadId;
+            }
+            cache = { this, m_id, &*it };
+        }
+        return *cache.buffer;
+    }
+
+    /// Accumulate the block in the pattern if it exists, under the lock of its row
+    bool addInPattern(Index row, Index col, const Block& value)
+    {
+        const auto& rowIndex = m_pattern->rowIndex;
+        const auto rowIt = std::lower_bound(rowIndex.begin(), rowIndex.end(), row);
+        if (rowIt == rowIndex.end() || *rowIt != row)
+        {
+            return false;
+        }
+        const auto r = std::distance(rowIndex.begin(), rowIt);
+
+        const auto colsBegin = m_pattern->colsIndex.begin() + m_pattern->rowBegin[r];
+        const auto colsEnd = m_pattern->colsIndex.begin() + m_pattern->rowBegin[r + 1];
+        const auto colIt = std::lower_bound(colsBegin, colsEnd, col);
+        if (colIt == colsEnd || *colIt != col)
+        {
+            return false;
+        }
+
+        ScopedLock lock(m_rowLocks[r]);
+        m_pattern->colsValue[std::distance(m_pattern->colsIndex.begin(), colIt)] += value;
+        return true;
+    }
+
+    template<class Function>
+    void forEachIndex(std::size_t first, std::size_t last, const Function& f)
+    {
+        if (taskScheduler && taskScheduler->getThreadCount() > 1)
+        {
+            parallelForEach(*taskScheduler, first, last, f);
+        }
+        else
+        {
+            forEach(first, last, f);
+        }
+    }
+
+    static std::uint64_t newBuilderId()
+    {
+        static std::atomic<std::uint64_t> counter { 0 };
+        return ++counter;
+    }
+
+    /// Identifies this builder in the cache of the threads, even if another builder is later
+    /// allocated at the same address
+    const std::uint64_t m_id { newBuilderId() };
+
+    /// One buffer per thread. A deque keeps the buffers at the same address when a thread is added.
+    std::deque<ThreadBuffer> m_buffers;
+    SpinLock m_buffersLock;
+
+    Matrix* m_pattern { nullptr };
+    std::unique_ptr<SpinLock[]> m_rowLocks;
+
+    /// Temporary arrays used during compression
+    sofa::type::vector<sofa::type::vector<std::size_t> > m_rowCounts;
+    sofa::type::vector<Index> m_existingCounts;
+    sofa::type::vector<std::size_t> m_rowOffsets;
+    sofa::type::vector<Index> m_rowSizes;
+    sofa::type::vector<Triplet> m_sorted;
+};
+
+}
@@ -0,0 +1,129 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/simulation/ParallelForceAccumulation.h>
+
+#include <sofa/core/behavior/BaseForceField.h>
+#include <sofa/core/behavior/BaseMechanicalState.h>
+#include <sofa/simulation/CpuTaskStatus.h>
+#include <sofa/simulation/MainTaskSchedulerFactory.h>
+#include <sofa/simulation/TaskScheduler.h>
+
+#include <algorithm>
+
+namespace sofa::simulation
+{
+
+void ParallelForceAccumulation::accumulate(const core::ExecParams* params, core::MultiVecDerivId res,
+                                           const std::function<void(core::behavior::BaseForceField*, core::MultiVecDerivId)>& f)
+{
+    const std::size_t nbForceFields = m_forceFields.size();
+    if (nbForceFields == 0)
+    {
+        return;
+    }
+
+    TaskScheduler* taskScheduler = MainTaskSchedulerFactory::createInRegistry();
+    if (nbForceFields == 1 || taskScheduler == nullptr || taskScheduler->getThreadCount() < 1)
+    {
+        for (auto* forceField : m_forceFields)
+        {
+            f(forceField, res);
+        }
+        m_forceFields.clear();
+        return;
+    }
+
+    // A force field may refer several times to the same state (e.g. an interaction force field between a state
+    // and itself), so each state is zeroed, allocated and reduced only once per force field.
+    m_states.resize(nbForceFields);
+    for (std::size_t i = 1; i < nbForceFields; ++i)
+    {
+        auto& states = m_states[i];
+        states.clear();
+        for (auto* state : m_forceFields[i]->getMechanicalStates())
+        {
+            if (std::find(states.begin(), states.end(), state) == states.end())
+            {
+                states.push_back(state);
+            }
+        }
+    }
+
+    // The vectors are allocated sequentially, as it modifies the list of vectors of the states.
+    // A vector is available only if it is available in all the states of the force field.
+    m_buffers.resize(nbForceFields);
+    for (std::size_t i = 1; i < nbForceFields; ++i)
+    {
+        core::VecDerivId& buffer = m_buffers[i];
+        buffer = core::VecDerivId(core::VecDerivId::V_FIRST_DYNAMIC_INDEX);
+
+        for (auto* state : m_states[i])
+        {
+            state->vAvail(params, buffer);
+        }
+        for (auto* state : m_states[i])
+        {
+            state->vAlloc(params, buffer);
+        }
+    }
+
+    CpuTaskStatus status;
+    for (std::size_t i = 0; i < nbForceFields; ++i)
+    {
+        taskScheduler->addTask(status, [this, i, params, res, &f]()
+        {
+            if (i == 0)
+            {
+                f(m_forceFields[0], res);
+                return;
+            }
+
+            for (auto* state : m_states[i])
+            {
+                state->vOp(params, m_buffers[i]); // buffer = 0
+            }
+            f(m_forceFields[i], core::MultiVecDerivId(m_buffers[i]));
+        });
+    }
+    taskScheduler->workUntilDone(&status);
+
+    // The buffers are freed only once all of them have been added to res
+    for (std::size_t i = 1; i < nbForceFields; ++i)
+    {
+        for (auto* state : m_states[i])
+        {
+            const core::VecDerivId resId = res.getId(state);
+            state->vOp(params, resId, resId, m_buffers[i]); // res += buffer
+        }
+    }
+    for (std::size_t i = 1; i < nbForceFields; ++i)
+    {
+        for (auto* state : m_states[i])
+        {
+            state->vFree(params, m_buffers[i]);
+        }
+    }
+
+    m_forceFields.clear();
+}
+
+} // namespace sofa::simulation
@@ -0,0 +1,69 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+
+#include <sofa/simulation/config.h>
+#include <sofa/core/MultiVecId.h>
+#include <sofa/core/behavior/fwd.h>
+
+#include <functional>
+#include <vector>
+
+namespace sofa::simulation
+{
+
+/**
+ * Accumulation of the forces of several force fields in parallel.
+ *
+ * The force fields are collected by a visitor on a node, then computed as tasks of the main task
+ * scheduler. The first force field accumulates directly in the destination vector, the other ones
+ * in temporary vectors of their mechanical states. These vectors are allocated before the tasks
+ * and freed after, which keeps their memory in the states for the next accumulations. The
+ * temporary vectors are finally added to the destination vector, in the order of the force fields,
+ * so that the result does not depend on the scheduling.
+ *
+ * The parallel accumulation is only used by the force visitors whose parameters request it (see
+ * ExecParams::parallelForceFields), as the animation loops do during their step when their
+ * parallelForceFields option is enabled.
+ */
+class SOFA_SIMULATION_CORE_API ParallelForceAccumulation
+{
+public:
+
+    /// Add a force field to the list of the force fields to accumulate
+    void add(core::behavior::BaseForceField* forceField) { m_forceFields.push_back(forceField); }
+
+    bool empty() const { return m_forceFields.empty(); }
+
+    /// Call f(forceField, fId) for all the added force fields, in parallel, fId being the vector in which
+    /// forceField must accumulate. Everything is accumulated in res, and the list of force fields is cleared.
+    void accumulate(const core::ExecParams* params, core::MultiVecDerivId res,
+                    const std::function<void(core::behavior::BaseForceField*, core::MultiVecDerivId)>& f);
+
+private:
+    std::vector<core::behavior::BaseForceField*> m_forceFields;
+    std::vector<core::VecDerivId> m_buffers;
+    /// States of each force field, without duplicates
+    std::vector<std::vector<core::behavior::BaseMechanicalState*> > m_states;
+};
+
+} // namespace sofa::simulation
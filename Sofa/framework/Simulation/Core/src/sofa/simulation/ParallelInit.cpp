@@ -0,0 +1,299 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/simulation/ParallelInit.h>
+
+#include <sofa/simulation/InitVisitor.h>
+#include <sofa/simulation/Node.h>
+#include <sofa/simulation/TaskScheduler.h>
+#include <sofa/simulation/CpuTaskStatus.h>
+#include <sofa/core/DataEngine.h>
+#include <sofa/core/objectmodel/BaseData.h>
+#include <sofa/core/objectmodel/BaseLink.h>
+#include <sofa/core/objectmodel/BaseObject.h>
+#include <sofa/helper/ScopedAdvancedTimer.h>
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace sofa::simulation
+{
+
+namespace
+{
+
+/// Record the nodes in the order they are visited by a top-down traversal
+class NodeOrderVisitor : public Visitor
+{
+public:
+    explicit NodeOrderVisitor(const core::ExecParams* params) : Visitor(params) {}
+
+    Result processNodeTopDown(simulation::Node* node) override
+    {
+        nodes.push_back(node);
+        return RESULT_CONTINUE;
+    }
+
+    const char* getClassName() const override { return "NodeOrderVisitor"; }
+
+    std::vector<Node*> nodes;
+};
+
+/// Node owning the given Data owner or linked Base, if any
+Node* getOwnerNode(core::objectmodel::Base* base)
+{
+    if (!base)
+    {
+        return nullptr;
+    }
+    if (auto* object = base->toBaseObject())
+    {
+        return dynamic_cast<Node*>(object->getContext());
+    }
+    return dynamic_cast<Node*>(base->toBaseNode());
+}
+
+/**
+ * Nodes connected to @p base through its Data (first) and its Links (second).
+ *
+ * The Data references are the owners of all the Data and engines upstream of the Data of @p base in the
+ * data dependency graph, not only of their direct parents: reading a Data updates all its inputs, for
+ * instance a Data connected to the output of an engine, which reads the Data connected to its inputs.
+ * All the Data of an engine are followed, because engines usually declare their inputs in init().
+ * @p visited contains the DDG nodes already collected, so that they are followed only once.
+ */
+void collectReferences(core::objectmodel::Base* base, std::vector<Node*>& dataReferences, std::vector<Node*>& linkReferences,
+                       std::unordered_set<core::objectmodel::DDGNode*>& visited)
+{
+    std::vector<core::objectmodel::DDGNode*> pending(base->getDataFields().begin(), base->getDataFields().end());
+    while (!pending.empty())
+    {
+        core::objectmodel::DDGNode* ddgNode = pending.back();
+        pending.pop_back();
+        for (core::objectmodel::DDGNode* input : ddgNode->getInputs())
+        {
+            if (!visited.insert(input).second)
+            {
+                continue;
+            }
+            if (auto* data = dynamic_cast<core::objectmodel::BaseData*>(input))
+            {
+                dataReferences.push_back(getOwnerNode(data->getOwner()));
+                if (auto* engine = dynamic_cast<core::DataEngine*>(data->getOwner()))
+                {
+                    for (auto* engineData : engine->getDataFields())
+                    {
+                        if (visited.insert(engineData).second)
+                        {
+                            pending.push_back(engineData);
+                        }
+                    }
+                }
+            }
+            else if (auto* engine = dynamic_cast<core::objectmodel::BaseObject*>(input))
+            {
+                dataReferences.push_back(getOwnerNode(engine));
+            }
+            pending.push_back(input);
+        }
+    }
+    for (const auto* link : base->getLinks())
+    {
+        for (std::size_t i = 0; i < link->getSize(); ++i)
+        {
+            linkReferences.push_back(getOwnerNode(link->getLinkedBase(i)));
+        }
+    }
+}
+
+} // anonymous namespace
+
+InitSchedule computeInitSchedule(Node* node, const core::ExecParams* params)
+{
+    InitSchedule schedule;
+
+    NodeOrderVisitor orderVisitor(params);
+    node->execute(orderVisitor);
+    schedule.nodes = std::move(orderVisitor.nodes);
+
+    const std::size_t nbNodes = schedule.nodes.size();
+    schedule.predecessors.resize(nbNodes);
+    schedule.sequential.resize(nbNodes, false);
+
+    std::unordered_map<const Node*, std::size_t> indices;
+    for (std::size_t i = 0; i < nbNodes; ++i)
+    {
+        indices[schedule.nodes[i]] = i;
+    }
+
+    const auto addDependency = [&schedule, &indices](std::size_t i, const Node* other)
+    {
+        const auto it = indices.find(other);
+        if (it == indices.end() || it->second == i)
+        {
+            return;
+        }
+        // the node initialized last in the sequential traversal depends on the other one
+        const auto [before, after] = std::minmax(i, it->second);
+        schedule.predecessors[after].push_back(before);
+    };
+
+    // last node having a Data connected to a Data of a given node
+    std::unordered_map<const Node*, std::size_t> lastDataReader;
+
+    for (std::size_t i = 0; i < nbNodes; ++i)
+    {
+        Node* current = schedule.nodes[i];
+
+        for (const auto* parent : current->getParents())
+        {
+            addDependency(i, dynamic_cast<const Node*>(parent));
+        }
+
+        std::vector<Node*> dataReferences, linkReferences;
+        std::unordered_set<core::objectmodel::DDGNode*> visited;
+        collectReferences(current, dataReferences, linkReferences, visited);
+        for (const auto& object : current->object)
+        {
+            collectReferences(object.get(), dataReferences, linkReferences, visited);
+            if (!object->isInitThreadSafe())
+            {
+                schedule.sequential[i] = true;
+            }
+        }
+
+        for (const Node* reference : linkReferences)
+        {
+            addDependency(i, reference);
+        }
+        for (const Node* reference : dataReferences)
+        {
+            if (!reference || reference == current)
+            {
+                continue;
+            }
+            addDependency(i, reference);
+
+            const auto [it, inserted] = lastDataReader.try_emplace(reference, i);
+            if (!inserted && it->second != i)
+            {
+                addDependency(i, schedule.nodes[it->second]);
+                it->second = i;
+            }
+        }
+    }
+
+    for (auto& predecessors : schedule.predecessors)
+    {
+        std::sort(predecessors.begin(), predecessors.end());
+        predecessors.erase(std::unique(predecessors.begin(), predecessors.end()), predecessors.end());
+    }
+
+    return schedule;
+}
+
+void parallelInit(Node* node, const core::ExecParams* params, TaskScheduler& taskScheduler)
+{
+    SCOPED_TIMER("ParallelInit");
+
+    const InitSchedule schedule = computeInitSchedule(node, params);
+    const std::size_t nbNodes = schedule.nodes.size();
+
+    InitVisitor initVisitor(params);
+
+    // The schedule is split in segments delimited by the nodes which must be initialized sequentially.
+    // Inside a segment, a node is initialized in a task as soon as its predecessors of the segment are done.
+    std::size_t segmentBegin = 0;
+    while (segmentBegin < nbNodes)
+    {
+        if (schedule.sequential[segmentBegin])
+        {
+            initVisitor.processNodeTopDown(schedule.nodes[segmentBegin]);
+            ++segmentBegin;
+            continue;
+        }
+
+        std::size_t segmentEnd = segmentBegin;
+        while (segmentEnd < nbNodes && !schedule.sequential[segmentEnd])
+        {
+            ++segmentEnd;
+        }
+
+        const std::size_t segmentSize = segmentEnd - segmentBegin;
+        std::vector<std::vector<std::size_t> > successors(segmentSize);
+        const auto remaining = std::make_unique<std::atomic<std::size_t>[]>(segmentSize);
+        for (std::size_t i = segmentBegin; i < segmentEnd; ++i)
+        {
+            std::size_t nbPredecessors = 0;
+            for (const std::size_t predecessor : schedule.predecessors[i])
+            {
+                if (predecessor >= segmentBegin)
+                {
+                    successors[predecessor - segmentBegin].push_back(i - segmentBegin);
+                    ++nbPredecessors;
+                }
+            }
+            remaining[i - segmentBegin].store(nbPredecessors);
+        }
+
+        CpuTaskStatus status;
+        std::function<void(std::size_t)> initNode;
+        initNode = [&](std::size_t local)
+        {
+            initVisitor.processNodeTopDown(schedule.nodes[segmentBegin + local]);
+            for (const std::size_t successor : successors[local])
+            {
+                if (remaining[successor].fetch_sub(1) == 1)
+                {
+                    taskScheduler.addTask(status, [&initNode, successor]() { initNode(successor); });
+                }
+            }
+        };
+
+        // list the ready nodes before starting any task, since a finished task decrements the counters of its successors
+        std::vector<std::size_t> ready;
+        for (std::size_t local = 0; local < segmentSize; ++local)
+        {
+            if (remaining[local].load() == 0)
+            {
+                ready.push_back(local);
+            }
+        }
+        for (const std::size_t local : ready)
+        {
+            taskScheduler.addTask(status, [&initNode, local]() { initNode(local); });
+        }
+        taskScheduler.workUntilDone(&status);
+
+        segmentBegin = segmentEnd;
+    }
+
+    for (auto it = schedule.nodes.rbegin(); it != schedule.nodes.rend(); ++it)
+    {
+        initVisitor.processNodeBottomUp(*it);
+    }
+}
+
+} // namespace sofa::simulation
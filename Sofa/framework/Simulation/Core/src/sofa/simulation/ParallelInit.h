@@ -0,0 +1,73 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+
+#include <sofa/simulation/config.h>
+#include <sofa/core/fwd.h>
+
+#include <vector>
+
+namespace sofa::simulation
+{
+
+class Node;
+class TaskScheduler;
+
+/**
+ * Dependencies between the nodes of a (sub)graph for their initialization.
+ *
+ * A node depends on a node initialized before it in the sequential traversal if:
+ *  - it is one of its parents,
+ *  - a Link of the node or of one of its components points to the other node or to one of its components,
+ *  - a Data of the node or of one of its components depends, directly or through other Data and engines, on a
+ *    Data or an engine of the other node,
+ *  - both nodes have a Data depending, directly or not, on a Data of the same third node (the update of a Data
+ *    is not thread-safe).
+ */
+struct SOFA_SIMULATION_CORE_API InitSchedule
+{
+    /// Nodes in the order of the sequential traversal of InitVisitor
+    std::vector<Node*> nodes;
+
+    /// For each node, the indices of the nodes which must be initialized before it
+    std::vector<std::vector<std::size_t> > predecessors;
+
+    /// For each node, true if it contains a component which cannot be initialized concurrently with
+    /// other components (see BaseObject::isInitThreadSafe)
+    std::vector<bool> sequential;
+};
+
+/// Compute the initialization dependencies of the nodes of the graph starting at @p node
+SOFA_SIMULATION_CORE_API InitSchedule computeInitSchedule(Node* node, const core::ExecParams* params);
+
+/**
+ * Initialize the graph starting at @p node, like InitVisitor, but calling the init() methods of the
+ * components of independent nodes in parallel.
+ *
+ * The nodes are initialized in tasks, as soon as all the nodes they depend on are initialized. A node
+ * containing a component which is not thread-safe is initialized alone, after all the nodes preceding it
+ * in the sequential traversal. As in the sequential traversal, all the bwdInit() methods are called
+ * after all the init() methods, in the reverse order of the traversal.
+ */
+SOFA_SIMULATION_CORE_API void parallelInit(Node* node, const core::ExecParams* params, TaskScheduler& taskScheduler);
+
+} // namespace sofa::simulation
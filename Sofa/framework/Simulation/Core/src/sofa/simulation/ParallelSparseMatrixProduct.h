@@ -21,6 +21,7 @@
 ******************************************************************************/
 #pragma once
 #include <sofa/linearalgebra/SparseMatrixProduct.inl>
+#include <sofa/linearalgebra/SparseMatrixTripleProduct.inl>
 #include <sofa/simulation/ParallelForEach.h>
 #include <sofa/simulation/TaskScheduler.h>
 
@@ -28,39 +29,61 @@
 namespace sofa::simulation
 {
 
+/**
+ * Parallel version of SparseMatrixProduct. The groups of the intersection are distributed among
+ * the threads in contiguous ranges of the values of the result, each range requiring about the
+ * same number of scalar products.
+ */
 template<class Lhs, class Rhs, class ResultType>
 class ParallelSparseMatrixProduct
     : public linearalgebra::SparseMatrixProduct<Lhs, Rhs, ResultType>
 {
 public:
     using linearalgebra::SparseMatrixProduct<Lhs, Rhs, ResultType>::SparseMatrixProduct;
+    using Index = typename linearalgebra::SparseMatrixProduct<Lhs, Rhs, ResultType>::Index;
     TaskScheduler* taskScheduler { nullptr };
 
     void computeProductFromIntersection() override
     {
-        assert(this->m_intersectionAB.intersection.size() == this->m_productResult.nonZeros());
+        assert(this->m_intersectionAB.getNbValues() == this->m_productResult.nonZeros());
         assert(taskScheduler);
 
-        auto* lhs_ptr = this->m_lhs->valuePtr();
-        auto* rhs_ptr = this->m_rhs->valuePtr();
-        auto* product_ptr = this->m_productResult.valuePtr();
+        const auto boundaries = linearalgebra::sparsematrixproduct::makeBalancedRanges(
+            this->m_intersectionAB.cumulatedCost, std::max(1u, taskScheduler->getThreadCount()));
 
-        parallelForEachRange(*taskScheduler,
-            this->m_intersectionAB.intersection.begin(), this->m_intersectionAB.intersection.end(),
-            [lhs_ptr, rhs_ptr, product_ptr, this](const auto& range)
+        parallelForEach(*taskScheduler, Index{0}, static_cast<Index>(boundaries.size()) - 1,
+            [&boundaries, this](Index range)
             {
-                auto i = std::distance(this->m_intersectionAB.intersection.begin(), range.start);
-                auto* p = product_ptr + i;
+                this->computeGroups(boundaries[range], boundaries[range + 1]);
+            });
+    }
+};
+
+/**
+ * Parallel version of SparseMatrixTripleProduct. The values of the result are distributed among
+ * the threads in contiguous ranges requiring about the same number of scalar products.
+ */
+template<class A, class B, class C, class IntermediateType, class ResultType>
+class ParallelSparseMatrixTripleProduct
+    : public linearalgebra::SparseMatrixTripleProduct<A, B, C, IntermediateType, ResultType>
+{
+public:
+    using linearalgebra::SparseMatrixTripleProduct<A, B, C, IntermediateType, ResultType>::SparseMatrixTripleProduct;
+    using Index = typename linearalgebra::SparseMatrixTripleProduct<A, B, C, IntermediateType, ResultType>::Index;
+    TaskScheduler* taskScheduler { nullptr };
 
-                for (auto it = range.start; it != range.end; ++it)
-                {
-                    auto& value = *p++;
-                    value = 0;
-                    for (const auto& [lhsIndex, rhsIndex] : *it)
-                    {
-                        value += lhs_ptr[lhsIndex] * rhs_ptr[rhsIndex];
-                    }
-                }
+    void computeProductFromIntersection() override
+    {
+        assert(static_cast<Index>(this->m_intersectionABC.offsets.size()) == this->m_productResult.nonZeros() + 1);
+        assert(taskScheduler);
+
+        const auto boundaries = linearalgebra::sparsematrixproduct::makeBalancedRanges(
+            this->m_intersectionABC.offsets, std::max(1u, taskScheduler->getThreadCount()));
+
+        parallelForEach(*taskScheduler, Index{0}, static_cast<Index>(boundaries.size()) - 1,
+            [&boundaries, this](Index range)
+            {
+                this->computeValues(boundaries[range], boundaries[range + 1]);
             });
     }
 };
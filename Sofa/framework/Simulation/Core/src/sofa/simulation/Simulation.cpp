@@ -23,6 +23,9 @@
 #include <sofa/simulation/PrintVisitor.h>
 #include <sofa/simulation/ExportGnuplotVisitor.h>
 #include <sofa/simulation/InitVisitor.h>
+#include <sofa/simulation/ParallelInit.h>
+#include <sofa/simulation/MainTaskSchedulerFactory.h>
+#include <sofa/simulation/TaskScheduler.h>
 #include <sofa/simulation/AnimateVisitor.h>
 #include <sofa/simulation/MechanicalVisitor.h>
 #include <sofa/simulation/UpdateContextVisitor.h>
@@ -139,7 +142,21 @@ void init(Node* node)
 
     // apply the init() and bwdInit() methods to all the components.
     // and put the VisualModels in a separate graph, rooted at getVisualRoot()
-    node->execute<InitVisitor>(params);
+    const auto* animationLoop = node->getContext()->getRootContext()->get<sofa::core::behavior::BaseAnimationLoop>(sofa::core::objectmodel::BaseContext::Local);
+    if (animationLoop && animationLoop->d_parallelInit.getValue())
+    {
+        TaskScheduler* taskScheduler = MainTaskSchedulerFactory::createInRegistry();
+        assert(taskScheduler);
+        if (taskScheduler->getThreadCount() < 1)
+        {
+            taskScheduler->init(0);
+        }
+        parallelInit(node, params, *taskScheduler);
+    }
+    else
+    {
+        node->execute<InitVisitor>(params);
+    }
 
     SimulationInitDoneEvent endInit;
     PropagateEventVisitor pe{params, &endInit};
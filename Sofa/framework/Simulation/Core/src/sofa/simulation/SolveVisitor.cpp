@@ -107,6 +107,9 @@ SolveVisitor::SolveVisitor(const sofa::core::ExecParams* params, SReal _dt, sofa
         , m_parallelSolve(_parallelSolve)
         , m_computeForceIsolatedInteractionForceFields(computeForceIsolatedInteractionForceFields)
 {
+    // the solvers of a sleeping node have nothing to solve
+    canAccessSleepingNode = false;
+
     if (m_parallelSolve)
     {
         initializeTaskScheduler();
@@ -116,6 +119,8 @@ SolveVisitor::SolveVisitor(const sofa::core::ExecParams* params, SReal _dt, sofa
 SolveVisitor::SolveVisitor(const sofa::core::ExecParams* params, SReal _dt, bool free, bool _parallelSolve, bool computeForceIsolatedInteractionForceFields)
 : Visitor(params), dt(_dt), m_parallelSolve(_parallelSolve), m_computeForceIsolatedInteractionForceFields(computeForceIsolatedInteractionForceFields)
 {
+    canAccessSleepingNode = false;
+
     if(free)
     {
         x = sofa::core::vec_id::write_access::freePosition;
@@ -38,8 +38,27 @@ Visitor::Result MechanicalComputeDfVisitor::fwdMappedMechanicalState(simulation:
     return RESULT_CONTINUE;
 }
 
+Visitor::Result MechanicalComputeDfVisitor::processNodeTopDown(simulation::Node* node, VisitorContext* ctx)
+{
+    const Result result = MechanicalVisitor::processNodeTopDown(node, ctx);
+
+    // compute the force fields collected in fwdForceField
+    m_forceAccumulation.accumulate(this->params, res, [this](core::behavior::BaseForceField* ff, core::MultiVecDerivId fId)
+    {
+        ff->addDForce(this->mparams, fId);
+    });
+
+    return result;
+}
+
 Visitor::Result MechanicalComputeDfVisitor::fwdForceField(simulation::Node* /*node*/, core::behavior::BaseForceField* ff)
 {
+    if (m_parallelForces)
+    {
+        m_forceAccumulation.add(ff);
+        return RESULT_CONTINUE;
+    }
+
     ff->addDForce(this->mparams, res);
     return RESULT_CONTINUE;
 }
@@ -22,6 +22,7 @@
 #pragma once
 
 #include <sofa/simulation/MechanicalVisitor.h>
+#include <sofa/simulation/ParallelForceAccumulation.h>
 
 namespace sofa::simulation::mechanicalvisitor
 {
@@ -36,6 +37,7 @@ public:
     bool accumulate; ///< Accumulate everything back to the DOFs through the mappings
     MechanicalComputeDfVisitor(const sofa::core::MechanicalParams* mparams, sofa::core::MultiVecDerivId res)
             : MechanicalVisitor(mparams) , res(res), accumulate(true)
+            , m_parallelForces(mparams->parallelForceFields())
     {
 #ifdef SOFA_DUMP_VISITOR_INFO
         setReadWriteVectors();
@@ -43,11 +45,14 @@ public:
     }
     MechanicalComputeDfVisitor(const sofa::core::MechanicalParams* mparams, sofa::core::MultiVecDerivId res, bool accumulate)
             : MechanicalVisitor(mparams) , res(res), accumulate(accumulate)
+            , m_parallelForces(mparams->parallelForceFields())
     {
 #ifdef SOFA_DUMP_VISITOR_INFO
         setReadWriteVectors();
 #endif
     }
+    using MechanicalVisitor::processNodeTopDown;
+    Result processNodeTopDown(simulation::Node* node, VisitorContext* ctx) override;
     Result fwdMechanicalState(simulation::Node* /*node*/,sofa::core::behavior::BaseMechanicalState* mm) override;
     Result fwdMappedMechanicalState(simulation::Node* /*node*/,sofa::core::behavior::BaseMechanicalState* mm) override;
     Result fwdForceField(simulation::Node* /*node*/,sofa::core::behavior::BaseForceField* ff) override;
@@ -70,6 +75,11 @@ public:
         addWriteVector(res);
     }
 #endif
+
+protected:
+    /// If true, the force fields of a node are collected, then computed in parallel (see ParallelForceAccumulation)
+    bool m_parallelForces;
+    ParallelForceAccumulation m_forceAccumulation;
 };
 
 } // namespace sofa::simulation::mechanicalvisitor
@@ -41,8 +41,27 @@ Visitor::Result MechanicalComputeForceVisitor::fwdMappedMechanicalState(simulati
 }
 
 
+Visitor::Result MechanicalComputeForceVisitor::processNodeTopDown(simulation::Node* node, VisitorContext* ctx)
+{
+    const Result result = MechanicalVisitor::processNodeTopDown(node, ctx);
+
+    // compute the force fields collected in fwdForceField
+    m_forceAccumulation.accumulate(this->params, res, [this](core::behavior::BaseForceField* ff, core::MultiVecDerivId fId)
+    {
+        ff->addForce(this->mparams, fId);
+    });
+
+    return result;
+}
+
 Visitor::Result MechanicalComputeForceVisitor::fwdForceField(simulation::Node* /*node*/, core::behavior::BaseForceField* ff)
 {
+    if (m_parallelForces)
+    {
+        m_forceAccumulation.add(ff);
+        return RESULT_CONTINUE;
+    }
+
     ff->addForce(this->mparams, res);
 
     return RESULT_CONTINUE;
@@ -0,0 +1,194 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <gtest/gtest.h>
+#include <sofa/simulation/MainTaskSchedulerFactory.h>
+#include <sofa/simulation/ParallelCompressedRowSparseMatrixBuilder.h>
+#include <sofa/type/Mat.h>
+
+#include <random>
+
+
+namespace sofa
+{
+
+template<class TBlock>
+class ParallelCompressedRowSparseMatrixBuilder_test : public ::testing::Test
+{
+public:
+    using Matrix = linearalgebra::CompressedRowSparseMatrixGeneric<TBlock>;
+    using Builder = simulation::ParallelCompressedRowSparseMatrixBuilder<Matrix>;
+    using Triplet = typename Builder::Triplet;
+    using Index = typename Matrix::Index;
+
+    static constexpr Index nbRows = 200;
+    static constexpr Index nbCols = 150;
+
+    static TBlock makeBlock(double v)
+    {
+        TBlock block;
+        if constexpr (std::is_arithmetic_v<TBlock>)
+            block = v;
+        else
+            block.fill(v);
+        return block;
+    }
+
+    static sofa::type::vector<Triplet> makeTriplets(std::size_t nbTriplets, unsigned int seed)
+    {
+        std::mt19937 generator(seed);
+        std::uniform_int_distribution<Index> row(0, nbRows - 1);
+        std::uniform_int_distribution<Index> col(0, nbCols - 1);
+        std::uniform_int_distribution<int> value(1, 10);
+
+        sofa::type::vector<Triplet> triplets;
+        for (std::size_t i = 0; i < nbTriplets; ++i)
+        {
+            triplets.push_back({row(generator), col(generator), makeBlock(value(generator))});
+        }
+        return triplets;
+    }
+
+    /// Add the triplets from the threads of the task scheduler
+    static void parallelAdd(simulation::TaskScheduler* taskScheduler, Builder& builder, const sofa::type::vector<Triplet>& triplets)
+    {
+        simulation::parallelForEach(*taskScheduler, triplets.begin(), triplets.end(),
+            [&builder](const Triplet& t)
+            {
+                builder.add(t.row, t.col, t.value);
+            });
+    }
+
+    static void expectEqual(const Matrix& actual, const Matrix& expected)
+    {
+        EXPECT_EQ(actual.rowBSize(), expected.rowBSize());
+        EXPECT_EQ(actual.colBSize(), expected.colBSize());
+        EXPECT_EQ(actual.getRowIndex(), expected.getRowIndex());
+        EXPECT_EQ(actual.getRowBegin(), expected.getRowBegin());
+        EXPECT_EQ(actual.getColsIndex(), expected.getColsIndex());
+        EXPECT_EQ(actual.getColsValue(), expected.getColsValue());
+    }
+
+    void SetUp() override
+    {
+        taskScheduler = simulation::MainTaskSchedulerFactory::createInRegistry();
+        taskScheduler->init(4);
+    }
+
+    simulation::TaskScheduler* taskScheduler { nullptr };
+};
+
+using BlockTypes = ::testing::Types<double, type::Mat3x3d>;
+TYPED_TEST_SUITE(ParallelCompressedRowSparseMatrixBuilder_test, BlockTypes);
+
+TYPED_TEST(ParallelCompressedRowSparseMatrixBuilder_test, compress)
+{
+    using Matrix = typename TestFixture::Matrix;
+
+    const auto triplets = TestFixture::makeTriplets(5000, 42);
+
+    Matrix expected(TestFixture::nbRows, TestFixture::nbCols);
+    for (const auto& t : triplets)
+    {
+        expected.addBlock(t.row, t.col, t.value);
+    }
+    expected.compress();
+
+    for (auto* scheduler : { static_cast<simulation::TaskScheduler*>(nullptr), this->taskScheduler })
+    {
+        typename TestFixture::Builder builder;
+        builder.taskScheduler = scheduler;
+        TestFixture::parallelAdd(this->taskScheduler, builder, triplets);
+        EXPECT_EQ(builder.getNbBufferedBlocks(), triplets.size());
+
+        Matrix actual(TestFixture::nbRows, TestFixture::nbCols);
+        builder.compress(actual);
+        EXPECT_EQ(builder.getNbBufferedBlocks(), 0);
+
+        TestFixture::expectEqual(actual, expected);
+    }
+}
+
+TYPED_TEST(ParallelCompressedRowSparseMatrixBuilder_test, compressIntoNonEmptyMatrix)
+{
+    using Matrix = typename TestFixture::Matrix;
+
+    const auto existing = TestFixture::makeTriplets(1000, 1);
+    const auto triplets = TestFixture::makeTriplets(2000, 2);
+
+    Matrix expected(TestFixture::nbRows, TestFixture::nbCols);
+    Matrix actual(TestFixture::nbRows, TestFixture::nbCols);
+    for (const auto& t : existing)
+    {
+        expected.addBlock(t.row, t.col, t.value);
+        actual.addBlock(t.row, t.col, t.value);
+    }
+    for (const auto& t : triplets)
+    {
+        expected.addBlock(t.row, t.col, t.value);
+    }
+    expected.compress();
+
+    typename TestFixture::Builder builder;
+    builder.taskScheduler = this->taskScheduler;
+    TestFixture::parallelAdd(this->taskScheduler, builder, triplets);
+    builder.compress(actual);
+
+    TestFixture::expectEqual(actual, expected);
+}
+
+TYPED_TEST(ParallelCompressedRowSparseMatrixBuilder_test, pattern)
+{
+    using Matrix = typename TestFixture::Matrix;
+
+    const auto triplets = TestFixture::makeTriplets(3000, 3);
+
+    typename TestFixture::Builder builder;
+    builder.taskScheduler = this->taskScheduler;
+
+    Matrix actual(TestFixture::nbRows, TestFixture::nbCols);
+    TestFixture::parallelAdd(this->taskScheduler, builder, triplets);
+    builder.compress(actual);
+
+    // Second assembly with the same sparsity: all the blocks are accumulated in the pattern
+    builder.setPattern(&actual);
+    TestFixture::parallelAdd(this->taskScheduler, builder, triplets);
+    EXPECT_EQ(builder.getNbBufferedBlocks(), 0);
+
+    // A block outside of the pattern is buffered
+    const auto newBlock = TestFixture::makeBlock(1);
+    Matrix expected(TestFixture::nbRows + 1, TestFixture::nbCols);
+    for (const auto& t : triplets)
+    {
+        expected.addBlock(t.row, t.col, t.value);
+        expected.addBlock(t.row, t.col, t.value);
+    }
+    expected.addBlock(TestFixture::nbRows, 0, newBlock);
+    expected.compress();
+
+    builder.add(TestFixture::nbRows, 0, newBlock);
+    EXPECT_EQ(builder.getNbBufferedBlocks(), 1);
+    builder.compress(actual);
+
+    TestFixture::expectEqual(actual, expected);
+}
+
+}
@@ -0,0 +1,300 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <gtest/gtest.h>
+#include <sofa/simulation/DefaultAnimationLoop.h>
+#include <sofa/simulation/MainTaskSchedulerFactory.h>
+#include <sofa/simulation/Node.h>
+#include <sofa/simulation/ParallelInit.h>
+#include <sofa/simulation/Simulation.h>
+#include <sofa/simulation/TaskScheduler.h>
+#include <sofa/simulation/graph/DAGSimulation.h>
+#include <sofa/core/DataEngine.h>
+#include <sofa/core/objectmodel/BaseObject.h>
+#include <sofa/testing/ScopedTaskScheduler.h>
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+namespace sofa
+{
+
+namespace
+{
+
+struct InitLog
+{
+    std::mutex mutex;
+    std::vector<const core::objectmodel::BaseObject*> init;
+    std::vector<const core::objectmodel::BaseObject*> bwdInit;
+    std::atomic<int> running { 0 };
+    std::atomic<bool> concurrentSequentialInit { false };
+    std::atomic<bool> bwdInitBeforeInit { false };
+};
+
+class InitRecorder : public core::objectmodel::BaseObject
+{
+public:
+    SOFA_CLASS(InitRecorder, core::objectmodel::BaseObject);
+
+    Data<int> d_value;
+    InitLog* log { nullptr };
+    bool threadSafe { true };
+    std::size_t nbComponents { 0 };
+
+    void init() override
+    {
+        const int alreadyRunning = log->running.fetch_add(1);
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        if (!threadSafe && (alreadyRunning > 0 || log->running.load() > 1))
+        {
+            log->concurrentSequentialInit = true;
+        }
+        {
+            std::lock_guard lock(log->mutex);
+            log->init.push_back(this);
+        }
+        log->running.fetch_sub(1);
+    }
+
+    void bwdInit() override
+    {
+        std::lock_guard lock(log->mutex);
+        if (log->init.size() != nbComponents)
+        {
+            log->bwdInitBeforeInit = true;
+        }
+        log->bwdInit.push_back(this);
+    }
+
+    bool isInitThreadSafe() const override { return threadSafe; }
+
+protected:
+    InitRecorder() : d_value(initData(&d_value, 0, "value", "value")) {}
+};
+
+/// A component which does not declare whether its init() is thread-safe
+class DefaultComponent : public core::objectmodel::BaseObject
+{
+public:
+    SOFA_CLASS(DefaultComponent, core::objectmodel::BaseObject);
+};
+
+/// Copy its input to its output. As most engines, it declares its input and output in init().
+class CopyEngine : public core::DataEngine
+{
+public:
+    SOFA_CLASS(CopyEngine, core::DataEngine);
+
+    Data<int> d_input;
+    Data<int> d_output;
+
+    void init() override
+    {
+        addInput(&d_input);
+        addOutput(&d_output);
+    }
+
+    void doUpdate() override
+    {
+        d_output.setValue(d_input.getValue());
+    }
+
+protected:
+    CopyEngine()
+        : d_input(initData(&d_input, 0, "input", "input"))
+        , d_output(initData(&d_output, 0, "output", "output"))
+    {}
+};
+
+struct ParallelInit_test : public ::testing::Test
+{
+    static constexpr std::size_t nbComponents = 7;
+
+    InitLog log;
+    simulation::Node::SPtr root;
+    std::map<std::string, InitRecorder::SPtr> recorders;
+
+    void addRecorder(simulation::Node::SPtr node, const std::string& name, bool threadSafe = true)
+    {
+        auto recorder = core::objectmodel::New<InitRecorder>();
+        recorder->setName(name);
+        recorder->log = &log;
+        recorder->threadSafe = threadSafe;
+        recorder->nbComponents = nbComponents;
+        node->addObject(recorder);
+        recorders[name] = recorder;
+    }
+
+    /// root
+    ///  |- A (a) -- A1 (a1)
+    ///  |- B (b) -- B1 (b1, value connected to a1.value)
+    ///  |- C (c, not thread-safe)
+    ///  |- D (d) -- D1 (d1)
+    void SetUp() override
+    {
+        root = simulation::getSimulation()->createNewGraph("root");
+        const auto a = root->createChild("A");
+        const auto b = root->createChild("B");
+        const auto c = root->createChild("C");
+        const auto d = root->createChild("D");
+        addRecorder(a, "a");
+        addRecorder(a->createChild("A1"), "a1");
+        addRecorder(b, "b");
+        addRecorder(b->createChild("B1"), "b1");
+        addRecorder(c, "c", false);
+        addRecorder(d, "d");
+        addRecorder(d->createChild("D1"), "d1");
+
+        recorders["b1"]->d_value.setParent(&recorders["a1"]->d_value);
+    }
+
+    void TearDown() override
+    {
+        simulation::node::unload(root);
+    }
+
+    std::size_t initRank(const std::string& name) const
+    {
+        const auto it = std::find(log.init.begin(), log.init.end(), recorders.at(name).get());
+        return static_cast<std::size_t>(std::distance(log.init.begin(), it));
+    }
+
+    void checkInitialization()
+    {
+        ASSERT_EQ(log.init.size(), nbComponents);
+        EXPECT_EQ(log.bwdInit.size(), nbComponents);
+        for (const auto& [name, recorder] : recorders)
+        {
+            EXPECT_EQ(std::count(log.init.begin(), log.init.end(), recorder.get()), 1) << name;
+        }
+
+        // parents before children
+        EXPECT_LT(initRank("a"), initRank("a1"));
+        EXPECT_LT(initRank("b"), initRank("b1"));
+        EXPECT_LT(initRank("d"), initRank("d1"));
+
+        // connected Data
+        EXPECT_LT(initRank("a1"), initRank("b1"));
+
+        EXPECT_FALSE(log.concurrentSequentialInit);
+        EXPECT_FALSE(log.bwdInitBeforeInit);
+    }
+};
+
+TEST_F(ParallelInit_test, schedule)
+{
+    const auto schedule = simulation::computeInitSchedule(root.get(), core::execparams::defaultInstance());
+    ASSERT_EQ(schedule.nodes.size(), 8);
+
+    const auto index = [&schedule](const std::string& name)
+    {
+        const auto it = std::find_if(schedule.nodes.begin(), schedule.nodes.end(),
+                                     [&name](const simulation::Node* n) { return n->getName() == name; });
+        return static_cast<std::size_t>(std::distance(schedule.nodes.begin(), it));
+    };
+    const auto dependsOn = [&schedule](std::size_t node, std::size_t other)
+    {
+        const auto& predecessors = schedule.predecessors[node];
+        return std::find(predecessors.begin(), predecessors.end(), other) != predecessors.end();
+    };
+
+    EXPECT_TRUE(dependsOn(index("A1"), index("A")));
+    EXPECT_TRUE(dependsOn(index("B1"), index("A1")));
+    EXPECT_FALSE(dependsOn(index("B"), index("A")));
+    EXPECT_FALSE(dependsOn(index("D1"), index("B1")));
+
+    EXPECT_TRUE(schedule.sequential[index("C")]);
+    EXPECT_FALSE(schedule.sequential[index("D")]);
+}
+
+TEST_F(ParallelInit_test, scheduleThroughEngines)
+{
+    /// root
+    ///  |- ...
+    ///  |- E (e, value connected to g.output)
+    ///  |- G (g, input connected to a1.value)
+    addRecorder(root->createChild("E"), "e");
+    const auto g = core::objectmodel::New<CopyEngine>();
+    root->createChild("G")->addObject(g);
+    g->d_input.setParent(&recorders["a1"]->d_value);
+    recorders["e"]->d_value.setParent(&g->d_output);
+
+    const auto schedule = simulation::computeInitSchedule(root.get(), core::execparams::defaultInstance());
+    ASSERT_EQ(schedule.nodes.size(), 10);
+
+    const auto index = [&schedule](const std::string& name)
+    {
+        const auto it = std::find_if(schedule.nodes.begin(), schedule.nodes.end(),
+                                     [&name](const simulation::Node* n) { return n->getName() == name; });
+        return static_cast<std::size_t>(std::distance(schedule.nodes.begin(), it));
+    };
+    const auto dependsOn = [&schedule](std::size_t node, std::size_t other)
+    {
+        const auto& predecessors = schedule.predecessors[node];
+        return std::find(predecessors.begin(), predecessors.end(), other) != predecessors.end();
+    };
+    ASSERT_LT(index("E"), index("G"));
+
+    // E reads a1.value through the engine of the sibling node G
+    EXPECT_TRUE(dependsOn(index("E"), index("A1")));
+    EXPECT_TRUE(dependsOn(index("G"), index("E")));
+    // E and B1 both read a1.value
+    EXPECT_TRUE(dependsOn(index("E"), index("B1")));
+    EXPECT_FALSE(dependsOn(index("E"), index("D1")));
+}
+
+TEST_F(ParallelInit_test, sequentialByDefault)
+{
+    root->createChild("E")->addObject(core::objectmodel::New<DefaultComponent>());
+
+    const auto schedule = simulation::computeInitSchedule(root.get(), core::execparams::defaultInstance());
+    ASSERT_EQ(schedule.nodes.size(), 9);
+    EXPECT_EQ(schedule.nodes.back()->getName(), "E");
+    EXPECT_TRUE(schedule.sequential.back());
+    EXPECT_FALSE(schedule.sequential[0]);
+}
+
+TEST_F(ParallelInit_test, parallelInit)
+{
+    const testing::ScopedTaskScheduler taskScheduler(4);
+
+    simulation::parallelInit(root.get(), core::execparams::defaultInstance(), *taskScheduler);
+    checkInitialization();
+}
+
+TEST_F(ParallelInit_test, initRootWithParallelInit)
+{
+    const auto animationLoop = core::objectmodel::New<simulation::DefaultAnimationLoop>();
+    animationLoop->d_parallelInit.setValue(true);
+    root->addObject(animationLoop);
+
+    // the scheduler is initialized by initRoot if needed
+    const testing::ScopedTaskScheduler taskScheduler(0);
+    simulation::node::initRoot(root.get());
+    checkInitialization();
+}
+
+} // anonymous namespace
+
+} // namespace sofa
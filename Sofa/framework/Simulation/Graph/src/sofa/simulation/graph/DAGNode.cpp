@@ -24,9 +24,53 @@
 #include <sofa/helper/Factory.inl>
 #include <sofa/core/Mapping.h>
 
+#include <atomic>
+#include <unordered_map>
+
 namespace sofa::simulation::graph
 {
 
+namespace
+{
+
+/// incremented each time a parent/child relation is modified
+std::atomic<std::size_t> s_graphGeneration { 1 };
+
+/// Buffers used by the DAG traversals, reused from one traversal to another.
+/// Visitors can be run from another visitor, so there is one set of buffers per nesting level and per thread.
+struct TraversalBuffers
+{
+    std::vector<unsigned char> status;
+    std::vector<DAGNode*> executedNodes;
+};
+
+class TraversalBuffersScope
+{
+public:
+    TraversalBuffersScope()
+    {
+        if (s_depth == s_buffers.size())
+            s_buffers.push_back(std::make_unique<TraversalBuffers>());
+        m_buffers = s_buffers[s_depth++].get();
+    }
+    ~TraversalBuffersScope()
+    {
+        m_buffers->executedNodes.clear();
+        --s_depth;
+    }
+    TraversalBuffers& get() { return *m_buffers; }
+
+private:
+    TraversalBuffers* m_buffers { nullptr };
+    static thread_local std::vector<std::unique_ptr<TraversalBuffers>> s_buffers;
+    static thread_local std::size_t s_depth;
+};
+
+thread_local std::vector<std::unique_ptr<TraversalBuffers>> TraversalBuffersScope::s_buffers;
+thread_local std::size_t TraversalBuffersScope::s_depth = 0;
+
+}
+
 /// get all down objects respecting specified class_info and tags
 class GetDownObjectsVisitor : public Visitor
 {
@@ -129,6 +173,7 @@ DAGNode::DAGNode(const std::string& name, DAGNode* parent)
 
 DAGNode::~DAGNode()
 {
+    ++s_graphGeneration;
     for (ChildIterator it = child.begin(), itend = child.end(); it != itend; ++it)
     {
         const DAGNode::SPtr dagnode = sofa::core::objectmodel::SPtr_static_cast<DAGNode>(*it);
@@ -601,10 +646,19 @@ void DAGNode::doExecuteVisitor(simulation::Visitor* action, bool precomputedOrde
             // that can have ancestors in another branch that is not pruned...
             // An already pruned node is ignored.
 
-            NodeList executedNodes;
+            // The traversal follows the plan of this node, which avoids looking for the parents in the descendancy
+            // and allocating the statuses for each visitor.
+            const std::shared_ptr<const TraversalPlan> plan = getTraversalPlan();
+
+            TraversalBuffersScope buffers;
+            NodeList& executedNodes = buffers.get().executedNodes;
             {
-                StatusMap statusMap;
-                executeVisitorTopDown( action, executedNodes, statusMap, this );
+                std::vector<unsigned char>& status = buffers.get().status;
+                status.assign(plan->nodes.size(), NOT_VISITED);
+                executedNodes.reserve(plan->nodes.size());
+
+                TraversalState state { *plan, status, executedNodes, this, nullptr };
+                executeVisitorTopDown( action, state, 0 );
             }
             executeVisitorBottomUp( action, executedNodes );
         }
@@ -701,6 +755,152 @@ void DAGNode::executeVisitorTopDown(simulation::Visitor* action, NodeList& execu
 }
 
 
+void DAGNode::executeVisitorTopDown(simulation::Visitor* action, TraversalState& state, unsigned int index )
+{
+    if ( state.statusMap )
+    {
+        // the graph has been modified during the traversal, the plan cannot be used anymore
+        executeVisitorTopDown( action, state.executedNodes, *state.statusMap, state.visitorRoot );
+        return;
+    }
+
+    const TraversalPlan& plan = state.plan;
+    std::vector<unsigned char>& status = state.status;
+
+    if ( status[index] != NOT_VISITED )
+    {
+        return; // skipped (already visited)
+    }
+
+    if( !this->isActive() || ( this->isSleeping() && !action->canAccessSleepingNode ) )
+    {
+        // do not execute the visitor on this node
+        status[index] = PRUNED;
+        return;
+    }
+
+    // same rules as the traversal without plan: a child is visited once all its parents have been visited,
+    // and it is pruned if all its parents are pruned
+    bool allParentsPruned = true;
+    bool hasParent = false;
+
+    for ( unsigned int p = plan.parentBegin[index], pend = plan.parentBegin[index+1]; p < pend; ++p )
+    {
+        const unsigned char parentStatus = status[plan.parents[p]];
+        if ( parentStatus == NOT_VISITED )
+            return; // skipped for now... the other parent should come later
+
+        allParentsPruned = allParentsPruned && ( parentStatus == PRUNED );
+        hasParent = true;
+    }
+
+    if ( allParentsPruned && hasParent )
+    {
+        // do not execute the visitor on this node, but continue the recursion anyway
+        status[index] = PRUNED;
+    }
+    else
+    {
+        const Visitor::Result result = action->processNodeTopDown(this);
+        status[index] = ( result == simulation::Visitor::RESULT_PRUNE ? PRUNED : VISITED );
+        state.executedNodes.push_back(this);
+    }
+
+    const bool reversed = action->childOrderReversed(this);
+    const unsigned int cbegin = plan.childBegin[index], cend = plan.childBegin[index+1];
+    for ( unsigned int c = 0; c < cend - cbegin && plan.generation == getGraphGeneration(); ++c )
+    {
+        const unsigned int i = plan.children[ reversed ? cend - 1 - c : cbegin + c ];
+        plan.nodes[i]->executeVisitorTopDown( action, state, i );
+    }
+
+    if ( plan.generation != getGraphGeneration() )
+    {
+        // The graph has been modified by the visitor: finish the traversal with the current children.
+        // Children which were already traversed are skipped.
+        if ( !state.statusMap )
+        {
+            state.statusMap = std::make_unique<StatusMap>();
+            for ( std::size_t i = 0; i < plan.nodes.size(); ++i )
+            {
+                if ( status[i] != NOT_VISITED )
+                    (*state.statusMap)[plan.nodes[i]] = VisitedStatus(status[i]);
+            }
+        }
+
+        if( reversed )
+            for(unsigned int i = unsigned(child.size()); i>0;)
+                static_cast<DAGNode*>(child[--i].get())->executeVisitorTopDown(action,state.executedNodes,*state.statusMap,state.visitorRoot);
+        else
+            for(unsigned int i = 0; i<child.size(); ++i)
+                static_cast<DAGNode*>(child[i].get())->executeVisitorTopDown(action,state.executedNodes,*state.statusMap,state.visitorRoot);
+    }
+}
+
+
+std::size_t DAGNode::getGraphGeneration()
+{
+    return s_graphGeneration.load(std::memory_order_relaxed);
+}
+
+std::shared_ptr<const DAGNode::TraversalPlan> DAGNode::getTraversalPlan()
+{
+    const std::size_t generation = getGraphGeneration();
+
+    std::lock_guard lock(_traversalPlanMutex);
+    if ( _traversalPlan && _traversalPlan->generation == generation )
+        return _traversalPlan;
+
+    auto plan = std::make_shared<TraversalPlan>();
+    plan->generation = generation;
+
+    // number the nodes of the sub-graph (the numbering does not change the traversal order, which follows the children order)
+    std::unordered_map<const DAGNode*, unsigned int> indices;
+    plan->nodes.push_back(this);
+    indices[this] = 0;
+    for ( std::size_t n = 0; n < plan->nodes.size(); ++n )
+    {
+        const DAGNode* node = plan->nodes[n];
+        for ( unsigned int i = 0; i < node->child.size(); ++i )
+        {
+            DAGNode* c = static_cast<DAGNode*>(node->child[i].get());
+            if ( indices.emplace(c, unsigned(plan->nodes.size())).second )
+                plan->nodes.push_back(c);
+        }
+    }
+
+    const std::size_t nbNodes = plan->nodes.size();
+    plan->parentBegin.reserve(nbNodes + 1);
+    plan->childBegin.reserve(nbNodes + 1);
+    for ( std::size_t n = 0; n < nbNodes; ++n )
+    {
+        const DAGNode* node = plan->nodes[n];
+
+        plan->parentBegin.push_back(unsigned(plan->parents.size()));
+        if ( n != 0 ) // the parents of the visitor root are not considered
+        {
+            const LinkParents::Container& parents = node->l_parents.getValue();
+            for ( unsigned int i = 0; i < parents.size(); ++i )
+            {
+                // parents outside of the sub-graph are ignored
+                const auto it = indices.find(parents[i]);
+                if ( it != indices.end() )
+                    plan->parents.push_back(it->second);
+            }
+        }
+
+        plan->childBegin.push_back(unsigned(plan->children.size()));
+        for ( unsigned int i = 0; i < node->child.size(); ++i )
+            plan->children.push_back(indices[static_cast<DAGNode*>(node->child[i].get())]);
+    }
+    plan->parentBegin.push_back(unsigned(plan->parents.size()));
+    plan->childBegin.push_back(unsigned(plan->children.size()));
+
+    _traversalPlan = std::move(plan);
+    return _traversalPlan;
+}
+
+
 // warning nodes that are dynamically created during the traversal, but that have not been traversed during the top-down, won't be traversed during the bottom-up
 // TODO is it what we want?
 // otherwise it is possible to restart from top, go to leaves and running bottom-up action while going up
@@ -716,6 +916,7 @@ void DAGNode::executeVisitorBottomUp( simulation::Visitor* action, NodeList& exe
 
 void DAGNode::setDirtyDescendancy()
 {
+    ++s_graphGeneration;
     _descendancy.clear();
     const LinkParents::Container &parents = l_parents.getValue();
     for ( unsigned int i = 0; i < parents.size() ; i++ )
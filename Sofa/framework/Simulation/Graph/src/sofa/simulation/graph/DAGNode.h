@@ -25,6 +25,10 @@
 #include <sofa/core/objectmodel/Link.h>
 #include <sofa/simulation/Visitor.h>
 
+#include <memory>
+#include <mutex>
+#include <vector>
+
 namespace sofa::simulation::graph
 {
 
@@ -194,16 +198,52 @@ protected:
     typedef std::map<DAGNode*,StatusStruct> StatusMap;
 
     /// list of DAGNode*
-    typedef std::list<DAGNode*> NodeList;
+    typedef std::vector<DAGNode*> NodeList;
 
     /// the ordered list of Node to traverse from this Node
     NodeList _precomputedTraversalOrder;
 
+    /// Flattened description of the sub-graph below a node, used for the DAG traversals started from this node.
+    /// Nodes are identified by their index in 'nodes', the parents outside of the sub-graph are discarded.
+    /// A plan is only valid while the graph generation is unchanged.
+    struct TraversalPlan
+    {
+        std::size_t generation { 0 };
+        NodeList nodes; ///< nodes of the sub-graph, the first one is the root
+        std::vector<unsigned int> parentBegin; ///< range of the parents of node i in 'parents'
+        std::vector<unsigned int> parents;
+        std::vector<unsigned int> childBegin; ///< range of the children of node i in 'children', in the child order
+        std::vector<unsigned int> children;
+    };
+
+    /// state of a DAG traversal following a TraversalPlan
+    struct TraversalState
+    {
+        const TraversalPlan& plan;
+        std::vector<unsigned char>& status; ///< VisitedStatus of each node of the plan
+        NodeList& executedNodes;
+        DAGNode* visitorRoot;
+        /// if the graph is modified during the traversal, the remaining nodes are traversed using this map
+        std::unique_ptr<StatusMap> statusMap;
+    };
+
+    /// the plan of the DAG traversals started from this node, rebuilt when the graph is modified
+    std::shared_ptr<const TraversalPlan> _traversalPlan;
+    std::mutex _traversalPlanMutex;
+
+    /// return an up-to-date traversal plan of the sub-graph starting from this node
+    std::shared_ptr<const TraversalPlan> getTraversalPlan();
+
+    /// counter incremented each time the structure of any graph is modified
+    static std::size_t getGraphGeneration();
+
     /// @internal performing only the top-down traversal on a DAG
     /// @executedNodes will be fill with the DAGNodes where the top-down action is processed
     /// @statusMap the visitor's flag map
     /// @visitorRoot node from where the visitor has been run
     void executeVisitorTopDown(simulation::Visitor* action, NodeList& executedNodes, StatusMap& statusMap, DAGNode* visitorRoot );
+    /// @internal same as above, following the traversal plan of the visitor root. This node is the node 'index' of the plan.
+    void executeVisitorTopDown(simulation::Visitor* action, TraversalState& state, unsigned int index );
     void executeVisitorBottomUp(simulation::Visitor* action, NodeList& executedNodes );
     /// @}
 
@@ -289,6 +289,66 @@ Expected output: RABCDEEDCBAR
 
 
 
+    /**
+     * The CreateChildVisitor struct creates a child node named X when traversing the node A
+     */
+    struct CreateChildVisitor : public TestVisitor
+    {
+        Result processNodeTopDown(simulation::Node* node) override
+        {
+            if( node->getName() == "A" )
+                node->createChild("X");
+            return TestVisitor::processNodeTopDown(node);
+        }
+    };
+
+
+    /// the traversals must take into account the modifications of the graph done between them or during them
+    void traverse_modifiedGraph()
+    {
+        const Node::SPtr root = sofa::simulation::getSimulation()->createNewGraph("");
+        root->setName("R");
+        const Node::SPtr A = root->createChild("A");
+        const Node::SPtr B = root->createChild("B");
+
+        TestVisitor t;
+        t.execute( root.get() );
+        EXPECT_EQ( t.topdown, "RAB" );
+
+        // diamond
+        const Node::SPtr C = A->createChild("C");
+        B->addChild(C);
+        t.clear();
+        t.execute( root.get() );
+        EXPECT_EQ( t.topdown, "RABC" );
+
+        // from a sub-graph, the parents outside of the sub-graph are ignored
+        t.clear();
+        t.execute( A.get() );
+        EXPECT_EQ( t.topdown, "AC" );
+        EXPECT_EQ( t.bottomup, "CA" );
+
+        // an inactive node is not traversed, neither the children whose parents are all pruned
+        A->setActive(false);
+        t.clear();
+        t.execute( root.get() );
+        EXPECT_EQ( t.topdown, "RBC" );
+        A->setActive(true);
+
+        B->removeChild(C);
+        t.clear();
+        t.execute( root.get() );
+        EXPECT_EQ( t.topdown, "RACB" );
+        EXPECT_EQ( t.bottomup, "BCAR" );
+
+        // a node created during the traversal is traversed
+        CreateChildVisitor c;
+        c.execute( root.get() );
+        EXPECT_EQ( c.topdown, "RACXB" );
+        EXPECT_EQ( c.bottomup, "BXCAR" );
+    }
+
+
     static void getObjectByPath( Node::SPtr node, const std::string& searchpath, const std::string& objpath )
     {
         void *foundObj = node->getObject(classid(Dummy), searchpath);
@@ -377,6 +437,12 @@ TEST_F( DAG_test, traverse )
     traverse_morecomplex2();
 }
 
+TEST_F( DAG_test, traverse_modifiedGraph )
+{
+    EXPECT_MSG_NOEMIT(Error) ;
+    traverse_modifiedGraph();
+}
+
 TEST(DAGNodeTest, objectDestruction_singleObject)
 {
     EXPECT_MSG_NOEMIT(Error) ;
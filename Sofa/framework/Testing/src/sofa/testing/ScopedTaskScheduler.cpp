@@ -0,0 +1,47 @@
+﻿/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/testing/ScopedTaskScheduler.h>
+#include <sofa/simulation/MainTaskSchedulerFactory.h>
+
+namespace sofa::testing
+{
+
+ScopedTaskScheduler::ScopedTaskScheduler(const unsigned int nbThreads)
+: m_taskScheduler(simulation::MainTaskSchedulerFactory::createInRegistry())
+{
+    m_previousThreadCount = m_taskScheduler->getThreadCount();
+    m_taskScheduler->init(nbThreads);
+}
+
+ScopedTaskScheduler::~ScopedTaskScheduler()
+{
+    if (m_previousThreadCount > 0)
+    {
+        m_taskScheduler->init(m_previousThreadCount);
+    }
+    else
+    {
+        m_taskScheduler->stop();
+    }
+}
+
+}
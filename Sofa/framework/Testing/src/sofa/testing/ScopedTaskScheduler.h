@@ -0,0 +1,53 @@
+﻿/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+#include <sofa/testing/config.h>
+#include <sofa/simulation/TaskScheduler.h>
+
+namespace sofa::testing
+{
+
+/**
+ * Initialize the main task scheduler with a given number of threads, and restore its number of
+ * threads when the object is destroyed, so that a test does not change the scheduler used by the
+ * following tests.
+ */
+struct SOFA_TESTING_API ScopedTaskScheduler
+{
+    ScopedTaskScheduler() = delete;
+    ScopedTaskScheduler(const ScopedTaskScheduler&) = delete;
+    void operator=(const ScopedTaskScheduler&) = delete;
+
+    explicit ScopedTaskScheduler(unsigned int nbThreads);
+
+    ~ScopedTaskScheduler();
+
+    simulation::TaskScheduler* get() const { return m_taskScheduler; }
+    simulation::TaskScheduler* operator->() const { return m_taskScheduler; }
+    simulation::TaskScheduler& operator*() const { return *m_taskScheduler; }
+
+private:
+    simulation::TaskScheduler* m_taskScheduler { nullptr };
+    unsigned int m_previousThreadCount { 0 };
+};
+
+}
@@ -636,8 +636,6 @@ void PersistentFrictionContact<TCollisionModel1,TCollisionModel2>::createRespons
 
     activateConstraint();
 
-    this->parent = group;
-
     double mu_ = this->mu.getValue();
 
     if (this->m_constraint)
@@ -676,35 +674,38 @@ void PersistentFrictionContact<TCollisionModel1,TCollisionModel2>::createRespons
             }
         }
 
-        if (this->parent)
+        if (this->parent != group)
         {
-            this->parent->removeObject(this);
-
-            if (map1 && !use_mapper_for_state1)
-                map1->getContext()->removeObject(this->m_constraint);
-            else
+            if (this->parent)
             {
-                if (map2 && !use_mapper_for_state2)
-                    map2->getContext()->removeObject(this->m_constraint);
+                this->parent->removeObject(this);
+
+                if (map1 && !use_mapper_for_state1)
+                    map1->getContext()->removeObject(this->m_constraint);
                 else
-                    this->parent->removeObject(this->m_constraint);
+                {
+                    if (map2 && !use_mapper_for_state2)
+                        map2->getContext()->removeObject(this->m_constraint);
+                    else
+                        this->parent->removeObject(this->m_constraint);
+                }
             }
-        }
-
-        this->parent = group;
 
-        if (this->parent)
-        {
-            this->parent->addObject(this);
+            this->parent = group;
 
-            if (map1 && !use_mapper_for_state1)
-                map1->getContext()->addObject(this->m_constraint);
-            else
+            if (this->parent)
             {
-                if (map2 && !use_mapper_for_state2)
-                    map2->getContext()->addObject(this->m_constraint);
+                this->parent->addObject(this);
+
+                if (map1 && !use_mapper_for_state1)
+                    map1->getContext()->addObject(this->m_constraint);
                 else
-                    this->parent->addObject(this->m_constraint);
+                {
+                    if (map2 && !use_mapper_for_state2)
+                        map2->getContext()->addObject(this->m_constraint);
+                    else
+                        this->parent->addObject(this->m_constraint);
+                }
             }
         }
     }
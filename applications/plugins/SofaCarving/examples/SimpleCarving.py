@@ -69,7 +69,7 @@ def createScene(root):
     T.addObject('TriangleSetGeometryAlgorithms', template="Vec3d", name="GeomAlgo")
     T.addObject('Tetra2TriangleTopologicalMapping', input="@../topo", output="@Container")
     
-    T.addObject('TriangleCollisionModel', tags="CarvingSurface")
+    T.addObject('TriangleCollisionModel', tags="CarvingSurface", localTopologyUpdate=True)
 
     Visu = T.addChild('VisualModel')
     Visu.addObject('OglModel', name="Visual", material="Default Diffuse 1 0 1 0 1 Ambient 0 1 1 1 1 Specular 1 1 1 0 1 Emissive 0 1 1 0 1 Shininess 1 100")
@@ -41,6 +41,9 @@ namespace sofa::component::collision
 * The tool performing the carving need to be represented by a collision model @sa toolCollisionModel
 * The surface to be carved are also mapped on collision models @sa surfaceCollisionModels
 * Detecting the collision is done using the scene Intersection and NarrowPhaseDetection pipeline.
+* Enabling the localTopologyUpdate option of the carved TriangleCollisionModel makes the removed elements only
+* trigger a local update of its bounding tree instead of a full rebuild at the next collision detection. The visual
+* models still recompute their normals and buffers over the whole mesh after each removal.
 */
 class SOFA_SOFACARVING_API CarvingManager : public core::behavior::BaseController
 {
@@ -21,8 +21,16 @@
 ******************************************************************************/
 #include <sofa/testing/NumericTest.h>
 #include <sofa/type/Vec.h>
+#include <sofa/helper/io/Mesh.h>
+#include <sofa/helper/system/FileSystem.h>
+#include <sofa/simulation/MainTaskSchedulerFactory.h>
+#include <sofa/simulation/TaskScheduler.h>
 
 #include <SofaDistanceGrid/DistanceGrid.h>
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <thread>
 using sofa::component::container::DistanceGrid ;
 
 namespace sofa
@@ -72,6 +80,181 @@ struct DistanceGrid_test : public sofa::testing::NumericTest<SReal>
                           DistanceGrid::Coord(mx,my,mz),
                           DistanceGrid::Coord(ex,ey,ez)) ;
     }
+
+    /// Triangulated cube of the given half-size
+    static void createCube(sofa::helper::io::Mesh& mesh, SReal dim)
+    {
+        auto& vertices = mesh.getVertices();
+        for (int i=0; i<8; ++i)
+            vertices.push_back(type::Vec3((i&1)?dim:-dim, (i&2)?dim:-dim, (i&4)?dim:-dim));
+        // outward oriented quads
+        const int quads[6][4] = { {0,2,3,1}, {4,5,7,6}, {0,1,5,4}, {2,6,7,3}, {0,4,6,2}, {1,3,7,5} };
+        auto& facets = mesh.getFacets();
+        for (const auto& q : quads)
+        {
+            facets.push_back({ { (sofa::Index)q[0], (sofa::Index)q[1], (sofa::Index)q[2] } });
+            facets.push_back({ { (sofa::Index)q[0], (sofa::Index)q[2], (sofa::Index)q[3] } });
+        }
+    }
+
+    void checkFastSweepingCube()
+    {
+        sofa::helper::io::Mesh mesh;
+        createCube(mesh, 1.0);
+
+        const DistanceGrid::Coord pmin(-2,-2,-2), pmax(2,2,2);
+        DistanceGrid exact(33, 33, 33, pmin, pmax);
+        exact.calcCubeDistance(1.0, 0);
+
+        DistanceGrid sequential(33, 33, 33, pmin, pmax);
+        sequential.calcDistanceFastSweeping(&mesh);
+
+        simulation::TaskScheduler* taskScheduler = simulation::MainTaskSchedulerFactory::createInRegistry();
+        taskScheduler->init(4);
+        DistanceGrid parallel(33, 33, 33, pmin, pmax);
+        parallel.calcDistanceFastSweeping(&mesh, 1.0, taskScheduler);
+
+        const SReal cellWidth = sequential.getCellWidth()[0];
+        for (int i=0; i<sequential.size(); ++i)
+        {
+            // the result does not depend on the number of threads
+            EXPECT_EQ(sequential[i], parallel[i]);
+            // first order approximation of the euclidean distance
+            EXPECT_NEAR(sequential[i], exact[i], 1.5*cellWidth);
+            if (std::abs(exact[i]) > cellWidth)
+                EXPECT_EQ(sequential[i] < 0, exact[i] < 0);
+        }
+    }
+
+    /// Write a cube mesh in an empty directory
+    static std::string writeCubeFile(const std::string& dir)
+    {
+        std::filesystem::remove_all(dir);
+        const std::string meshFile = helper::system::FileSystem::append(dir, "cube.obj");
+        helper::system::FileSystem::ensureFolderForFileExists(meshFile);
+        sofa::helper::io::Mesh mesh;
+        createCube(mesh, 1.0);
+        std::ofstream out(meshFile);
+        for (const auto& v : mesh.getVertices())
+            out << "v " << v << "\n";
+        for (const auto& f : mesh.getFacets())
+            out << "f " << f[0][0]+1 << " " << f[0][1]+1 << " " << f[0][2]+1 << "\n";
+        return meshFile;
+    }
+
+    void checkCache()
+    {
+        const std::string dir = (std::filesystem::temp_directory_path() / "DistanceGrid_test").string();
+        const std::string meshFile = writeCubeFile(dir);
+
+        DistanceGrid::BuildOptions options;
+        options.fastSweeping = true;
+        options.cacheDirectory = helper::system::FileSystem::append(dir, "cache");
+
+        DistanceGrid* computed = DistanceGrid::load(meshFile, 1.0, 0.0, 16, 16, 16, DistanceGrid::Coord(), DistanceGrid::Coord(), options);
+        ASSERT_NE(computed, nullptr);
+        std::vector<std::string> files;
+        helper::system::FileSystem::listDirectory(options.cacheDirectory, files, "dgrid");
+        EXPECT_EQ(files.size(), 1u);
+
+        DistanceGrid* cached = DistanceGrid::load(meshFile, 1.0, 0.0, 16, 16, 16, DistanceGrid::Coord(), DistanceGrid::Coord(), options);
+        ASSERT_NE(cached, nullptr);
+        EXPECT_EQ(cached->getNx(), 16);
+        EXPECT_EQ(cached->getPMin(), computed->getPMin());
+        EXPECT_EQ(cached->getBBMax(), computed->getBBMax());
+        EXPECT_EQ(cached->meshPts.size(), computed->meshPts.size());
+        for (int i=0; i<computed->size(); ++i)
+            EXPECT_EQ((*cached)[i], (*computed)[i]);
+
+        // other parameters use another cache file
+        DistanceGrid* other = DistanceGrid::load(meshFile, 2.0, 0.0, 16, 16, 16, DistanceGrid::Coord(), DistanceGrid::Coord(), options);
+        files.clear();
+        helper::system::FileSystem::listDirectory(options.cacheDirectory, files, "dgrid");
+        EXPECT_EQ(files.size(), 2u);
+
+        // an invalid cache is replaced by the grid computed again
+        const std::string cacheFile = helper::system::FileSystem::append(options.cacheDirectory, files[0]);
+        const auto cacheSize = std::filesystem::file_size(cacheFile);
+        {
+            std::ofstream out(cacheFile, std::ios::trunc);
+            out << "invalid";
+        }
+        for (const SReal scale : { 1.0, 2.0 })
+        {
+            DistanceGrid* grid = DistanceGrid::load(meshFile, scale, 0.0, 16, 16, 16, DistanceGrid::Coord(), DistanceGrid::Coord(), options);
+            ASSERT_NE(grid, nullptr);
+            grid->release();
+        }
+        EXPECT_EQ(std::filesystem::file_size(cacheFile), cacheSize);
+
+        // so are a cache computed for another grid size and a truncated cache
+        DistanceGrid::BuildOptions smallOptions = options;
+        smallOptions.cacheDirectory = helper::system::FileSystem::append(dir, "smallCache");
+        DistanceGrid* small = DistanceGrid::load(meshFile, 1.0, 0.0, 8, 8, 8, DistanceGrid::Coord(), DistanceGrid::Coord(), smallOptions);
+        ASSERT_NE(small, nullptr);
+        small->release();
+        std::vector<std::string> smallFiles;
+        helper::system::FileSystem::listDirectory(smallOptions.cacheDirectory, smallFiles, "dgrid");
+        ASSERT_EQ(smallFiles.size(), 1u);
+        std::filesystem::copy_file(helper::system::FileSystem::append(smallOptions.cacheDirectory, smallFiles[0]), cacheFile,
+                                   std::filesystem::copy_options::overwrite_existing);
+        const std::string otherCacheFile = helper::system::FileSystem::append(options.cacheDirectory, files[1]);
+        std::filesystem::resize_file(otherCacheFile, cacheSize - sizeof(SReal));
+        for (const SReal scale : { 1.0, 2.0 })
+        {
+            DistanceGrid* grid = DistanceGrid::load(meshFile, scale, 0.0, 16, 16, 16, DistanceGrid::Coord(), DistanceGrid::Coord(), options);
+            ASSERT_NE(grid, nullptr);
+            EXPECT_EQ(grid->getNx(), 16);
+            EXPECT_EQ(grid->meshPts.size(), computed->meshPts.size());
+            grid->release();
+        }
+        EXPECT_EQ(std::filesystem::file_size(cacheFile), cacheSize);
+        EXPECT_EQ(std::filesystem::file_size(otherCacheFile), cacheSize);
+
+        // no temporary file is left
+        files.clear();
+        helper::system::FileSystem::listDirectory(options.cacheDirectory, files);
+        EXPECT_EQ(files.size(), 2u);
+
+        computed->release();
+        cached->release();
+        other->release();
+        std::filesystem::remove_all(dir);
+    }
+
+    /// The components initialized in parallel share the same grid
+    void checkConcurrentLoadShared()
+    {
+        const std::string dir = (std::filesystem::temp_directory_path() / "DistanceGrid_test_shared").string();
+        const std::string meshFile = writeCubeFile(dir);
+
+        std::vector<DistanceGrid*> grids(8, nullptr);
+        std::vector<std::thread> loaders;
+        for (std::size_t i=0; i<grids.size(); ++i)
+        {
+            loaders.emplace_back([&grids, &meshFile, i]()
+            {
+                grids[i] = DistanceGrid::loadShared(meshFile, 1.0, 0.0, 8, 8, 8, DistanceGrid::Coord(), DistanceGrid::Coord());
+            });
+        }
+        for (auto& loader : loaders)
+            loader.join();
+
+        ASSERT_NE(grids[0], nullptr);
+        for (const DistanceGrid* grid : grids)
+            EXPECT_EQ(grid, grids[0]);
+
+        // the grid is deleted with its last reference, released concurrently
+        std::atomic<int> nbDeleted { 0 };
+        std::vector<std::thread> releasers;
+        for (DistanceGrid* grid : grids)
+            releasers.emplace_back([grid, &nbDeleted]() { if (grid->release()) ++nbDeleted; });
+        for (auto& releaser : releasers)
+            releaser.join();
+        EXPECT_EQ(nbDeleted, 1);
+
+        std::filesystem::remove_all(dir);
+    }
 };
 
 TEST_F(DistanceGrid_test, chekcValidConstructorsCube) {
@@ -95,6 +278,17 @@ TEST_F(DistanceGrid_test, chekcInvalidConstructorsCube) {
     }
 }
 
+TEST_F(DistanceGrid_test, fastSweepingCube) {
+    this->checkFastSweepingCube();
+}
+
+TEST_F(DistanceGrid_test, cache) {
+    this->checkCache();
+}
+
+TEST_F(DistanceGrid_test, concurrentLoadShared) {
+    this->checkConcurrentLoadShared();
+}
 
 } // __distance_grid__
 } // container
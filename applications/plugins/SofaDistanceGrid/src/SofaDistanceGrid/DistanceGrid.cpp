@@ -25,13 +25,28 @@
 #include <sofa/core/visual/VisualParams.h>
 
 #include <sofa/helper/io/Mesh.h>
+#include <sofa/helper/system/FileSystem.h>
+#include <sofa/helper/system/MappedFile.h>
 
 #if SOFADISTANCEGRID_HAVE_MINIFLOWVR
 #include <flowvr/render/mesh.h>
 #endif
 
+#include <sofa/simulation/ParallelForEach.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
 #include <fstream>
+#include <functional>
+#include <mutex>
+#include <random>
 #include <sstream>
+#include <system_error>
+#include <thread>
 
 #include <sofa/helper/logging/Messaging.h>
 
@@ -54,6 +69,19 @@ namespace _distancegrid_
 
 using namespace defaulttype;
 
+namespace
+{
+
+/// Protects the shared grids and their reference counts, used by components initialized in parallel.
+/// Recursive, as the destructor of a grid is called by release().
+std::recursive_mutex& getSharedMutex()
+{
+    static std::recursive_mutex mutex;
+    return mutex;
+}
+
+} // namespace
+
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
@@ -94,6 +122,7 @@ DistanceGrid::DistanceGrid(int nx, int ny, int nz, Coord pmin, Coord pmax)
 
 DistanceGrid::~DistanceGrid()
 {
+    std::lock_guard<std::recursive_mutex> lock(getSharedMutex());
     std::map<DistanceGridParams, DistanceGrid*>& shared = getShared();
     std::map<DistanceGridParams, DistanceGrid*>::iterator it = shared.begin();
     while (it != shared.end() && it->second != this) ++it;
@@ -104,6 +133,7 @@ DistanceGrid::~DistanceGrid()
 /// Add one reference to this grid. Note that loadShared already does this.
 DistanceGrid* DistanceGrid::addRef()
 {
+    std::lock_guard<std::recursive_mutex> lock(getSharedMutex());
     ++m_nbRef;
     return this;
 }
@@ -111,6 +141,7 @@ DistanceGrid* DistanceGrid::addRef()
 /// Release one reference, deleting this grid if this is the last
 bool DistanceGrid::release()
 {
+    std::lock_guard<std::recursive_mutex> lock(getSharedMutex());
     if (--m_nbRef != 0)
         return false;
     delete this;
@@ -120,7 +151,8 @@ bool DistanceGrid::release()
 //todo(dmarchal) we should make a loader for that...
 DistanceGrid* DistanceGrid::load(const std::string& filename,
                                  double scale, double sampling,
-                                 int nx, int ny, int nz, Coord pmin, Coord pmax)
+                                 int nx, int ny, int nz, Coord pmin, Coord pmax,
+                                 const BuildOptions& options)
 {
     double absscale=fabs(scale);
     if (filename == "#cube")
@@ -235,6 +267,18 @@ DistanceGrid* DistanceGrid::load(const std::string& filename,
     }
     else if (filename.length()>4 && filename.substr(filename.length()-4) == ".obj")
     {
+        std::string cacheFilename;
+        if (!options.cacheDirectory.empty())
+        {
+            cacheFilename = getCacheFilename(options.cacheDirectory, filename, scale, sampling, nx, ny, nz, pmin, pmax, options.fastSweeping);
+            DistanceGrid* grid = cacheFilename.empty() ? NULL : loadCache(cacheFilename, nx, ny, nz);
+            if (grid)
+            {
+                msg_info("DistanceGrid")<< "Distance field of " << filename << " loaded from cache " << cacheFilename;
+                return grid;
+            }
+        }
+
         Mesh* mesh = Mesh::Create(filename);
         const auto & vertices = mesh->getVertices();
 
@@ -270,7 +314,10 @@ DistanceGrid* DistanceGrid::load(const std::string& filename,
             }
         }
         DistanceGrid* grid = new DistanceGrid(nx, ny, nz, pmin, pmax);
-        grid->calcDistance(mesh, scale);
+        if (options.fastSweeping)
+            grid->calcDistanceFastSweeping(mesh, scale, options.taskScheduler);
+        else
+            grid->calcDistance(mesh, scale);
         if (sampling)
             grid->sampleSurface(sampling);
         else
@@ -281,6 +328,8 @@ DistanceGrid* DistanceGrid::load(const std::string& filename,
         }
         grid->computeBBox();
         delete mesh;
+        if (!cacheFilename.empty() && !grid->saveCache(cacheFilename))
+            msg_warning("DistanceGrid")<< "Could not write distance field cache " << cacheFilename;
         return grid;
     }
     else
@@ -595,22 +644,15 @@ void DistanceGrid::calcCubeDistance(SReal dim, int np)
     m_bbmax = Coord( dim, dim, dim);
 }
 
-/// Compute distance field from given mesh
-void DistanceGrid::calcDistance(sofa::helper::io::Mesh* mesh, double scale)
+/// Initialize the distance of the grid points at the ends of the edges crossing the mesh,
+/// and mark them as inside or outside points
+void DistanceGrid::initSurfaceDistance(sofa::helper::io::Mesh* mesh, double scale)
 {
-    m_fmm_status.resize(m_nxnynz);
-    m_fmm_heap.resize(m_nxnynz);
-    m_fmm_heap_size = 0;
-    dmsg_info("DistanceGrid")<< "FMM: Init.";
-
-    std::fill(m_fmm_status.begin(), m_fmm_status.end(), FMM_FAR);
-    std::fill(m_dists.begin(), m_dists.end(), maxDist());
-
     const auto& vertices = mesh->getVertices();
     const auto& facets = mesh->getFacets();
 
     // Initialize distance of edges crossing triangles
-    dmsg_info("DistanceGrid")<< "FMM: Initialize distance of edges crossing triangles.";
+    dmsg_info("DistanceGrid")<< "Initialize distance of edges crossing triangles.";
 
     for (unsigned int i=0; i<facets.size(); i++)
     {
@@ -794,6 +836,20 @@ void DistanceGrid::calcDistance(sofa::helper::io::Mesh* mesh, double scale)
                     }
          }
     }
+}
+
+/// Compute distance field from given mesh
+void DistanceGrid::calcDistance(sofa::helper::io::Mesh* mesh, double scale)
+{
+    m_fmm_status.resize(m_nxnynz);
+    m_fmm_heap.resize(m_nxnynz);
+    m_fmm_heap_size = 0;
+    dmsg_info("DistanceGrid")<< "FMM: Init.";
+
+    std::fill(m_fmm_status.begin(), m_fmm_status.end(), FMM_FAR);
+    std::fill(m_dists.begin(), m_dists.end(), maxDist());
+
+    initSurfaceDistance(mesh, scale);
 
     // Update known points neighbors
     for (int z=0, ind=0; z<m_nz; z++)
@@ -996,6 +1052,140 @@ void DistanceGrid::calcDistance(sofa::helper::io::Mesh* mesh, double scale)
     msg_info("DistanceGrid")<< "FMM: DONE. "<< nbin << " points inside ( " << (nbin*100)/size() <<" % )";
 }
 
+/// Compute distance field from given mesh, with a fast sweeping method
+void DistanceGrid::calcDistanceFastSweeping(sofa::helper::io::Mesh* mesh, double scale, simulation::TaskScheduler* taskScheduler)
+{
+    m_fmm_status.resize(m_nxnynz);
+    dmsg_info("DistanceGrid")<< "FSM: Init.";
+
+    std::fill(m_fmm_status.begin(), m_fmm_status.end(), FMM_FAR);
+    std::fill(m_dists.begin(), m_dists.end(), maxDist());
+
+    initSurfaceDistance(mesh, scale);
+
+    // Gauss-Seidel sweeps in the 8 diagonal directions, repeated until no distance changes.
+    // Within a sweep, the points of a plane x+y+z=cst (in the sweep direction) only depend
+    // on the previous plane, so each plane is processed in parallel. The updates are the
+    // same as a sequential sweep in lexicographic order, whatever the number of threads.
+    const int nbPlanes = m_nx+m_ny+m_nz-2;
+    std::atomic<bool> changed;
+    int nbIterations = 0;
+    do
+    {
+        changed = false;
+        for (int dir=0; dir<8; ++dir)
+        {
+            const bool flipx = (dir&1)!=0, flipy = (dir&2)!=0, flipz = (dir&4)!=0;
+            for (int plane=0; plane<nbPlanes; ++plane)
+            {
+                auto sweepSlice = [&](int sz)
+                {
+                    bool updated = false;
+                    const int z = flipz ? m_nz-1-sz : sz;
+                    const int sy0 = std::max(0, plane-sz-(m_nx-1));
+                    const int sy1 = std::min(m_ny-1, plane-sz);
+                    for (int sy=sy0; sy<=sy1; ++sy)
+                    {
+                        const int sx = plane-sz-sy;
+                        const int y = flipy ? m_ny-1-sy : sy;
+                        const int x = flipx ? m_nx-1-sx : sx;
+                        updated |= fsm_update(x, y, z);
+                    }
+                    if (updated) changed = true;
+                };
+                const int sz0 = std::max(0, plane-(m_nx-1)-(m_ny-1));
+                const int sz1 = std::min(m_nz-1, plane);
+                if (taskScheduler != nullptr && sz1-sz0 >= 8)
+                    simulation::parallelForEach(*taskScheduler, sz0, sz1+1, sweepSlice);
+                else
+                    for (int sz=sz0; sz<=sz1; ++sz)
+                        sweepSlice(sz);
+            }
+        }
+        ++nbIterations;
+    }
+    while (changed && nbIterations < 16);
+
+    // Finalize distances
+    int nbin = 0;
+    for (int ind=0; ind<m_nxnynz; ind++)
+    {
+        if (m_fmm_status[ind] == FMM_KNOWN_IN || m_fmm_status[ind] == FSM_IN)
+        {
+            m_dists[ind] = -m_dists[ind];
+            ++nbin;
+        }
+    }
+    msg_info("DistanceGrid")<< "FSM: DONE in " << nbIterations << " iterations. "<< nbin << " points inside ( " << (nbin*100)/size() <<" % )";
+}
+
+/// Update the distance of one point from its neighbors, solving the upwind discretization of |grad d| = 1.
+/// Points initialized from the mesh are kept, other points take the side (inside or outside) of their closest neighbor.
+bool DistanceGrid::fsm_update(int x, int y, int z)
+{
+    const int ind = index(x,y,z);
+    if (m_fmm_status[ind] == FMM_KNOWN_IN || m_fmm_status[ind] == FMM_KNOWN_OUT)
+        return false;
+
+    // closest neighbor distance along each axis
+    SReal a[3];
+    int n[3];
+    const int offset[3] = { 1, m_nx, m_nxny };
+    const int pos[3] = { x, y, z };
+    const int dim[3] = { m_nx, m_ny, m_nz };
+    for (int c=0; c<3; ++c)
+    {
+        a[c] = maxDist();
+        n[c] = -1;
+        if (pos[c] > 0 && m_dists[ind-offset[c]] < a[c])
+        {
+            a[c] = m_dists[ind-offset[c]];
+            n[c] = ind-offset[c];
+        }
+        if (pos[c] < dim[c]-1 && m_dists[ind+offset[c]] < a[c])
+        {
+            a[c] = m_dists[ind+offset[c]];
+            n[c] = ind+offset[c];
+        }
+    }
+
+    // sort the axis by increasing distance
+    int order[3] = { 0, 1, 2 };
+    if (a[order[1]] < a[order[0]]) std::swap(order[0], order[1]);
+    if (a[order[2]] < a[order[1]]) std::swap(order[1], order[2]);
+    if (a[order[1]] < a[order[0]]) std::swap(order[0], order[1]);
+
+    const int c0 = order[0];
+    if (n[c0] < 0)
+        return false; // no known neighbor yet
+
+    // solve sum_c ((d-a_c)/h_c)^2 = 1 using the closest axis first
+    SReal d = a[c0] + m_cellWidth[c0];
+    SReal sw = 0, swa = 0, swa2 = 0;
+    for (int i=0; i<3; ++i)
+    {
+        const int c = order[i];
+        if (i > 0 && (n[c] < 0 || d <= a[c]))
+            break;
+        const SReal w = m_invCellWidth[c]*m_invCellWidth[c];
+        sw += w;
+        swa += w*a[c];
+        swa2 += w*a[c]*a[c];
+        if (i > 0)
+        {
+            const SReal delta = swa*swa - sw*(swa2-1);
+            d = (swa + helper::rsqrt(rmax(delta, (SReal)0))) / sw;
+        }
+    }
+
+    if (d >= m_dists[ind])
+        return false;
+    m_dists[ind] = d;
+    const int side = m_fmm_status[n[c0]];
+    m_fmm_status[ind] = (side == FMM_KNOWN_IN || side == FSM_IN) ? FSM_IN : FSM_OUT;
+    return true;
+}
+
 inline void DistanceGrid::fmm_swap(int entry1, int entry2)
 {
     int ind1 = m_fmm_heap[entry1];
@@ -1236,7 +1426,8 @@ void DistanceGrid::sampleSurface(double sampling)
 
 
 DistanceGrid* DistanceGrid::loadShared(const std::string& filename,
-                                       double scale, double sampling, int nx, int ny, int nz, Coord pmin, Coord pmax)
+                                       double scale, double sampling, int nx, int ny, int nz, Coord pmin, Coord pmax,
+                                       const BuildOptions& options)
 {
     DistanceGridParams params;
     params.filename = filename;
@@ -1247,16 +1438,174 @@ DistanceGrid* DistanceGrid::loadShared(const std::string& filename,
     params.nz = nz;
     params.pmin = pmin;
     params.pmax = pmax;
-    std::map<DistanceGridParams, DistanceGrid*>& shared = getShared();
-    std::map<DistanceGridParams, DistanceGrid*>::iterator it = shared.find(params);
-    if (it != shared.end())
+    params.fastSweeping = options.fastSweeping;
+    {
+        std::lock_guard<std::recursive_mutex> lock(getSharedMutex());
+        std::map<DistanceGridParams, DistanceGrid*>::iterator it = getShared().find(params);
+        if (it != getShared().end())
+            return it->second->addRef();
+    }
+
+    // the grid is computed without the lock, as the computation may run other tasks of the scheduler
+    DistanceGrid* grid = load(filename, scale, sampling, nx, ny, nz, pmin, pmax, options);
+    if (!grid)
+        return NULL;
+
+    std::lock_guard<std::recursive_mutex> lock(getSharedMutex());
+    auto [it, inserted] = getShared().try_emplace(params, grid);
+    if (!inserted)
+    {
+        // another component loaded the same grid in the meantime
+        delete grid;
         return it->second->addRef();
-    else
+    }
+    return grid;
+}
+
+
+namespace
+{
+
+/// FNV-1a hash, stable across platforms and runs
+struct CacheKey
+{
+    std::uint64_t value = 14695981039346656037ull;
+    void add(const void* data, std::size_t size)
+    {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        for (std::size_t i=0; i<size; ++i)
+        {
+            value ^= bytes[i];
+            value *= 1099511628211ull;
+        }
+    }
+    template<class T>
+    void add(const T& v) { add(&v, sizeof(T)); }
+};
+
+const char cacheMagic[8] = { 'S','D','G','R','I','D','0','1' };
+
+} // namespace
+
+std::string DistanceGrid::getCacheFilename(const std::string& cacheDirectory, const std::string& filename,
+                                           double scale, double sampling, int nx, int ny, int nz,
+                                           const Coord& pmin, const Coord& pmax, bool fastSweeping)
+{
+    std::ifstream in(filename.c_str(), std::ios::in | std::ios::binary);
+    if (!in.is_open())
+        return std::string();
+    CacheKey key;
+    char buffer[65536];
+    while (in.read(buffer, sizeof(buffer)) || in.gcount() > 0)
+        key.add(buffer, (std::size_t)in.gcount());
+    key.add(scale); key.add(sampling);
+    key.add(nx); key.add(ny); key.add(nz);
+    for (int c=0; c<3; ++c) { key.add(pmin[c]); key.add(pmax[c]); }
+    key.add(fastSweeping);
+    key.add(sizeof(SReal));
+
+    std::ostringstream name;
+    name << helper::system::FileSystem::stripDirectory(filename) << '-' << std::hex << key.value << ".dgrid";
+    return helper::system::FileSystem::append(cacheDirectory, name.str());
+}
+
+DistanceGrid* DistanceGrid::loadCache(const std::string& cacheFilename, int nx, int ny, int nz)
+{
+    // the cache is replaced by a rename when it is written again, so the mapped content never changes
+    helper::system::MappedFile file;
+    if (!file.open(cacheFilename))
+        return NULL;
+
+    const std::size_t headerSize = sizeof(cacheMagic) + sizeof(std::uint32_t) + 3*sizeof(int) + 4*sizeof(Coord) + sizeof(std::uint64_t);
+    if (file.size() < headerSize || !std::equal(cacheMagic, cacheMagic+sizeof(cacheMagic), file.data()))
+    {
+        msg_warning("DistanceGrid")<< "Invalid distance field cache " << cacheFilename;
+        return NULL;
+    }
+    const char* in = file.data() + sizeof(cacheMagic);
+    const auto read = [&in](void* value, std::size_t size) { std::memcpy(value, in, size); in += size; };
+
+    std::uint32_t realSize = 0;
+    int cacheNx = 0, cacheNy = 0, cacheNz = 0;
+    Coord pmin, pmax, bbmin, bbmax;
+    std::uint64_t nbPts = 0;
+    read(&realSize, sizeof(realSize));
+    read(&cacheNx, sizeof(int)); read(&cacheNy, sizeof(int)); read(&cacheNz, sizeof(int));
+    read(pmin.ptr(), sizeof(Coord)); read(pmax.ptr(), sizeof(Coord));
+    read(bbmin.ptr(), sizeof(Coord)); read(bbmax.ptr(), sizeof(Coord));
+    read(&nbPts, sizeof(nbPts));
+
+    bool valid = realSize == sizeof(SReal) && nx > 0 && ny > 0 && nz > 0
+        && cacheNx == nx && cacheNy == ny && cacheNz == nz;
+    for (int c=0; c<3; ++c)
+        valid = valid && pmin[c] < pmax[c];
+    if (!valid)
     {
-        return shared[params] = load(filename, scale, sampling, nx, ny, nz, pmin, pmax);
+        msg_warning("DistanceGrid")<< "Distance field cache " << cacheFilename << " does not match the requested grid";
+        return NULL;
     }
+    const std::size_t nbDists = (std::size_t)nx*(std::size_t)ny*(std::size_t)nz;
+    const std::size_t distsSize = nbDists*sizeof(SReal);
+    const std::size_t dataSize = file.size() - headerSize;
+    if (dataSize < distsSize || nbPts > (dataSize - distsSize) / sizeof(Coord)
+        || dataSize - distsSize != nbPts*sizeof(Coord))
+    {
+        msg_warning("DistanceGrid")<< "Truncated distance field cache " << cacheFilename;
+        return NULL;
+    }
+
+    DistanceGrid* grid = new DistanceGrid(nx, ny, nz, pmin, pmax);
+    grid->m_bbmin = bbmin;
+    grid->m_bbmax = bbmax;
+    read(grid->m_dists.data(), distsSize);
+    grid->meshPts.resize((std::size_t)nbPts);
+    if (nbPts > 0)
+        read(grid->meshPts.data(), (std::size_t)nbPts*sizeof(Coord));
+    return grid;
 }
 
+bool DistanceGrid::saveCache(const std::string& cacheFilename) const
+{
+    helper::system::FileSystem::ensureFolderForFileExists(cacheFilename);
+    // Write a temporary file first, so that concurrent runs never read a partial cache. Its name is unique to this
+    // writer, so that concurrent writers do not write into the same file.
+    std::random_device randomDevice;
+    std::ostringstream tmpSuffix;
+    tmpSuffix << ".tmp" << std::hex << std::hash<std::thread::id>{}(std::this_thread::get_id()) << '_' << randomDevice() << randomDevice();
+    const std::string tmpFilename = cacheFilename + tmpSuffix.str();
+    {
+        std::ofstream out(tmpFilename.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!out.is_open())
+            return false;
+        const std::uint32_t realSize = sizeof(SReal);
+        const std::uint64_t nbPts = meshPts.size();
+        out.write(cacheMagic, sizeof(cacheMagic));
+        out.write((const char*)&realSize, sizeof(realSize));
+        out.write((const char*)&m_nx, sizeof(int)); out.write((const char*)&m_ny, sizeof(int)); out.write((const char*)&m_nz, sizeof(int));
+        out.write((const char*)m_pmin.data(), sizeof(Coord)); out.write((const char*)m_pmax.data(), sizeof(Coord));
+        out.write((const char*)m_bbmin.data(), sizeof(Coord)); out.write((const char*)m_bbmax.data(), sizeof(Coord));
+        out.write((const char*)&nbPts, sizeof(nbPts));
+        out.write((const char*)m_dists.data(), m_nxnynz*sizeof(SReal));
+        if (nbPts > 0)
+            out.write((const char*)meshPts.data(), nbPts*sizeof(Coord));
+        if (!out)
+        {
+            out.close();
+            std::remove(tmpFilename.c_str());
+            return false;
+        }
+    }
+
+    // unlike std::rename, replaces an existing cache on all platforms
+    std::error_code error;
+    std::filesystem::rename(tmpFilename, cacheFilename, error);
+    if (error)
+    {
+        std::remove(tmpFilename.c_str());
+        return false;
+    }
+    return true;
+}
 
 SReal DistanceGrid::quickeval(const Coord& x) const
 {
@@ -1389,6 +1738,7 @@ bool DistanceGrid::DistanceGridParams::operator==(const DistanceGridParams& v) c
     if (!(pmax[0]  == v.pmax[0] )) return false;
     if (!(pmax[1]  == v.pmax[1] )) return false;
     if (!(pmax[2]  == v.pmax[2] )) return false;
+    if (!(fastSweeping == v.fastSweeping)) return false;
     return true;
 }
 
@@ -1418,6 +1768,8 @@ bool DistanceGrid::DistanceGridParams::operator<(const DistanceGridParams& v) co
     if (pmax[1]  > v.pmax[1] ) return true;
     if (pmax[2]  < v.pmax[2] ) return false;
     if (pmax[2]  > v.pmax[2] ) return true;
+    if (fastSweeping < v.fastSweeping) return false;
+    if (fastSweeping > v.fastSweeping) return true;
     return false;
 }
 
@@ -1447,6 +1799,8 @@ bool DistanceGrid::DistanceGridParams::operator>(const DistanceGridParams& v) co
     if (pmax[1]  < v.pmax[1] ) return true;
     if (pmax[2]  > v.pmax[2] ) return false;
     if (pmax[2]  < v.pmax[2] ) return true;
+    if (fastSweeping > v.fastSweeping) return false;
+    if (fastSweeping < v.fastSweeping) return true;
     return false;
 }
 
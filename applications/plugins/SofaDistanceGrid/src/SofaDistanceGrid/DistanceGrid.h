@@ -33,6 +33,11 @@ namespace sofa::helper::io
     class Mesh ;
 }
 
+namespace sofa::simulation
+{
+    class TaskScheduler ;
+}
+
 
 ////// DistanceGrid declaration
 namespace sofa
@@ -52,6 +57,18 @@ using sofa::helper::io::Mesh;
 using sofa::type::Vec3 ;
 typedef Vec3 Coord;
 
+/// Options used when the distance field is computed from a mesh
+struct DistanceGridBuildOptions
+{
+    /// use the fast sweeping method instead of the fast marching method
+    bool fastSweeping = false;
+    /// task scheduler running the fast sweeping method, or nullptr to run it sequentially
+    simulation::TaskScheduler* taskScheduler = nullptr;
+    /// if not empty, distance fields computed from meshes are saved in this directory,
+    /// and loaded back instead of recomputed by later runs with the same mesh and parameters
+    std::string cacheDirectory;
+};
+
 class SOFA_SOFADISTANCEGRID_API DistanceGrid
 {
 public:
@@ -59,6 +76,7 @@ public:
     typedef type::Vec3 Coord;
     typedef type::vector<SReal> VecSReal;
     typedef type::vector<Coord> VecCoord;
+    typedef DistanceGridBuildOptions BuildOptions;
 
     DistanceGrid(int m_nx, int m_ny, int m_nz, Coord m_pmin, Coord m_pmax);
 
@@ -69,16 +87,18 @@ public:
     static DistanceGrid* load(const std::string& filename,
                               double scale=1.0, double sampling=0.0,
                               int m_nx=64, int m_ny=64, int m_nz=64,
-                              Coord m_pmin = Coord(), Coord m_pmax = Coord());
+                              Coord m_pmin = Coord(), Coord m_pmax = Coord(),
+                              const BuildOptions& options = BuildOptions());
 
     static DistanceGrid* loadVTKFile(const std::string& filename,
                                      double scale=1.0, double sampling=0.0);
 
-    /// Load or reuse a distance grid
+    /// Load or reuse a distance grid. Can be called concurrently, as the grids are shared between components.
     static DistanceGrid* loadShared(const std::string& filename,
                                     double scale=1.0, double sampling=0.0,
                                     int m_nx=64, int m_ny=64, int m_nz=64,
-                                    Coord m_pmin = Coord(), Coord m_pmax = Coord());
+                                    Coord m_pmin = Coord(), Coord m_pmax = Coord(),
+                                    const BuildOptions& options = BuildOptions());
 
     /// Add one reference to this grid. Note that loadShared already does this.
     DistanceGrid* addRef();
@@ -92,6 +112,11 @@ public:
     /// Compute distance field from given mesh
     void calcDistance(Mesh* mesh, double scale=1.0);
 
+    /// Compute distance field from given mesh, with a fast sweeping method solving |grad d| = 1.
+    /// Distances are euclidean, whereas calcDistance propagates them along the grid axes.
+    /// The sweeps are run in parallel if a task scheduler is given, with the same result.
+    void calcDistanceFastSweeping(Mesh* mesh, double scale=1.0, simulation::TaskScheduler* taskScheduler=nullptr);
+
     /// Compute distance field for a cube of the given half-size.
     /// Also create a mesh of points using np points per axis
     void calcCubeDistance(SReal dim=1, int np=5);
@@ -233,15 +258,28 @@ protected:
     SReal m_cubeDim; ///< Cube dimension (!=0 if this is actually a cube
 
     /// Fast Marching Method Update
-    enum Status { FMM_FRONT0 = 0, FMM_FAR = -1, FMM_KNOWN_OUT = -2, FMM_KNOWN_IN = -3 };
+    enum Status { FMM_FRONT0 = 0, FMM_FAR = -1, FMM_KNOWN_OUT = -2, FMM_KNOWN_IN = -3, FSM_OUT = -4, FSM_IN = -5 };
     type::vector<int> m_fmm_status;
     type::vector<int> m_fmm_heap;
     int m_fmm_heap_size;
 
+    void initSurfaceDistance(Mesh* mesh, double scale);
+
     int fmm_pop();
     void fmm_push(int index);
     void fmm_swap(int entry1, int entry2);
 
+    /// Fast Sweeping Method Update
+    bool fsm_update(int x, int y, int z);
+
+    /// On-disk cache of the distance fields computed from meshes
+    static std::string getCacheFilename(const std::string& cacheDirectory, const std::string& filename,
+                                        double scale, double sampling, int nx, int ny, int nz,
+                                        const Coord& pmin, const Coord& pmax, bool fastSweeping);
+    /// Returns NULL, and the grid is computed again, if the cache is missing, truncated or was built for another grid size
+    static DistanceGrid* loadCache(const std::string& cacheFilename, int nx, int ny, int nz);
+    bool saveCache(const std::string& cacheFilename) const;
+
     /// Grid shared resources
     struct DistanceGridParams
     {
@@ -250,6 +288,7 @@ protected:
         double sampling;
         int nx,ny,nz;
         Coord pmin,pmax;
+        bool fastSweeping;
         bool operator==(const DistanceGridParams& v) const ;
         bool operator<(const DistanceGridParams& v) const ;
         bool operator>(const DistanceGridParams& v) const ;
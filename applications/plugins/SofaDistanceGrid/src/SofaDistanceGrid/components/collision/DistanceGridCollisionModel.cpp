@@ -27,6 +27,8 @@
 #include <sofa/core/visual/VisualParams.h>
 #include <sofa/core/ObjectFactory.h>
 #include <sofa/helper/Factory.inl>
+#include <sofa/simulation/MainTaskSchedulerFactory.h>
+#include <sofa/simulation/TaskScheduler.h>
 #include <sofa/component/collision/geometry/CubeModel.h>
 #include <sofa/component/collision/response/mapper/BarycentricContactMapper.inl>
 #include <sofa/component/collision/response/mapper/RigidContactMapper.inl>
@@ -64,6 +66,21 @@ using namespace defaulttype;
 using namespace sofa::component::collision::geometry;
 using namespace sofa::component::collision::response::mapper;
 
+/// Options used to compute the distance fields of meshes
+static DistanceGrid::BuildOptions buildOptions(bool fastSweeping, const std::string& cacheDirectory)
+{
+    DistanceGrid::BuildOptions options;
+    options.fastSweeping = fastSweeping;
+    options.cacheDirectory = cacheDirectory;
+    if (fastSweeping)
+    {
+        options.taskScheduler = simulation::MainTaskSchedulerFactory::createInRegistry();
+        if (options.taskScheduler->getThreadCount() < 1)
+            options.taskScheduler->init(0);
+    }
+    return options;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
@@ -80,6 +97,8 @@ RigidDistanceGridCollisionModel::RigidDistanceGridCollisionModel()
     , ny( initData( &ny, 64, "ny", "number of values on Y axis") )
     , nz( initData( &nz, 64, "nz", "number of values on Z axis") )
     , dumpfilename( initData( &dumpfilename, "dumpfilename","write distance grid to specified file"))
+    , fastSweeping( initData( &fastSweeping, false, "fastSweeping", "compute the distance field of meshes with the fast sweeping method, in parallel using the task scheduler, instead of the fast marching method"))
+    , cacheDirectory( initData( &cacheDirectory, "cacheDirectory", "if not empty, distance fields computed from meshes are saved in this directory and reused by later runs with the same mesh and parameters"))
     , usePoints( initData( &usePoints, true, "usePoints", "use mesh vertices for collision detection"))
     , flipNormals( initData( &flipNormals, false, "flipNormals", "reverse surface direction, i.e. points are considered in collision if they move outside of the object instead of inside"))
     , showMeshPoints( initData( &showMeshPoints, true, "showMeshPoints", "Enable rendering of mesh points"))
@@ -119,7 +138,7 @@ void RigidDistanceGridCollisionModel::init()
     if (sampling.getValue()!=0.0) msg_info()<<" sampling="<<sampling.getValue();
     if (box.getValue()[0][0]<box.getValue()[1][0]) msg_info()<<" bbox=<"<<box.getValue()[0]<<">-<"<<box.getValue()[0]<<">";
 
-    grid = DistanceGrid::loadShared(fileRigidDistanceGrid.getFullPath(), scale.getValue(), sampling.getValue(), nx.getValue(),ny.getValue(),nz.getValue(),box.getValue()[0],box.getValue()[1]);
+    grid = DistanceGrid::loadShared(fileRigidDistanceGrid.getFullPath(), scale.getValue(), sampling.getValue(), nx.getValue(),ny.getValue(),nz.getValue(),box.getValue()[0],box.getValue()[1], buildOptions(fastSweeping.getValue(), cacheDirectory.getValue()));
     if (grid->getNx() != this->nx.getValue())
         this->nx.setValue(grid->getNx());
     if (grid->getNy() != this->ny.getValue())
@@ -442,6 +461,8 @@ FFDDistanceGridCollisionModel::FFDDistanceGridCollisionModel()
     , ny( initData( &ny, 64, "ny", "number of values on Y axis") )
     , nz( initData( &nz, 64, "nz", "number of values on Z axis") )
     , dumpfilename( initData( &dumpfilename, "dumpfilename","write distance grid to specified file"))
+    , fastSweeping( initData( &fastSweeping, false, "fastSweeping", "compute the distance field of meshes with the fast sweeping method, in parallel using the task scheduler, instead of the fast marching method"))
+    , cacheDirectory( initData( &cacheDirectory, "cacheDirectory", "if not empty, distance fields computed from meshes are saved in this directory and reused by later runs with the same mesh and parameters"))
     , usePoints( initData( &usePoints, true, "usePoints", "use mesh vertices for collision detection"))
     , singleContact( initData( &singleContact, false, "singleContact", "keep only the deepest contact in each cell"))
 {
@@ -482,7 +503,7 @@ void FFDDistanceGridCollisionModel::init()
     if (sampling.getValue()!=0.0) msg_info()<<" sampling="<<sampling.getValue();
     if (box.getValue()[0][0]<box.getValue()[1][0]) msg_info()<<" bbox=<"<<box.getValue()[0]<<">-<"<<box.getValue()[0]<<">";
 
-    grid = DistanceGrid::loadShared(fileFFDDistanceGrid.getFullPath(), scale.getValue(), sampling.getValue(), nx.getValue(),ny.getValue(),nz.getValue(),box.getValue()[0],box.getValue()[1]);
+    grid = DistanceGrid::loadShared(fileFFDDistanceGrid.getFullPath(), scale.getValue(), sampling.getValue(), nx.getValue(),ny.getValue(),nz.getValue(),box.getValue()[0],box.getValue()[1], buildOptions(fastSweeping.getValue(), cacheDirectory.getValue()));
     if (!dumpfilename.getValue().empty())
     {
         msg_info() << "Dump grid to "<<dumpfilename.getValue();
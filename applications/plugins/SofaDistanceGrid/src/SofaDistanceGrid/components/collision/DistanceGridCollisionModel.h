@@ -134,6 +134,8 @@ public:
     Data< int > ny; ///< number of values on Y axis
     Data< int > nz; ///< number of values on Z axis
     sofa::core::objectmodel::DataFileName dumpfilename;
+    Data< bool > fastSweeping; ///< compute the distance field of meshes with the fast sweeping method, in parallel using the task scheduler
+    Data< std::string > cacheDirectory; ///< if not empty, distance fields computed from meshes are saved in this directory and reused by later runs
 
     Data< bool > usePoints; ///< use mesh vertices for collision detection
     Data< bool > flipNormals; ///< reverse surface direction, i.e. points are considered in collision if they move outside of the object instead of inside
@@ -436,6 +438,8 @@ protected:
     Data< int > ny; ///< number of values on Y axis
     Data< int > nz; ///< number of values on Z axis
     sofa::core::objectmodel::DataFileName dumpfilename;
+    Data< bool > fastSweeping; ///< compute the distance field of meshes with the fast sweeping method, in parallel using the task scheduler
+    Data< std::string > cacheDirectory; ///< if not empty, distance fields computed from meshes are saved in this directory and reused by later runs
 
     core::behavior::MechanicalState<defaulttype::Vec3Types>* ffd;
     core::topology::BaseMeshTopology* ffdMesh;
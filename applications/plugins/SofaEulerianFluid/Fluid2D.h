@@ -62,6 +62,8 @@ public:
     sofa::core::objectmodel::Data<vec2> f_dir; ///< initial fluid surface normal
     sofa::core::objectmodel::Data<real> f_tstart; ///< starting time for fluid source
     sofa::core::objectmodel::Data<real> f_tstop; ///< stopping time for fluid source
+    sofa::core::objectmodel::Data<bool> f_multigrid; ///< use a multigrid preconditioned conjugate gradient to compute the pressure
+    sofa::core::objectmodel::Data<bool> f_parallel; ///< run the grid update in parallel using the task scheduler
 protected:
     Fluid2D();
     ~Fluid2D() override;
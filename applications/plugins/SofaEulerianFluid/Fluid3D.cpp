@@ -23,6 +23,7 @@
 #include <sofa/core/visual/VisualParams.h>
 #include <sofa/gl/template.h>
 #include <sofa/core/ObjectFactory.h>
+#include <sofa/simulation/MainTaskSchedulerFactory.h>
 #include <iostream>
 #include <cstring>
 #include <sofa/type/BoundingBox.h>
@@ -58,7 +59,9 @@ Fluid3D::Fluid3D():
     f_height ( initData(&f_height, 5.0f, "height", "initial fluid height") ),
     f_dir ( initData(&f_dir, vec3(0,1,0), "dir", "initial fluid surface normal") ),
     f_tstart ( initData(&f_tstart, 0.0f, "tstart", "starting time for fluid source") ),
-    f_tstop ( initData(&f_tstop, 60.0f, "tstop", "stopping time for fluid source") )
+    f_tstop ( initData(&f_tstop, 60.0f, "tstop", "stopping time for fluid source") ),
+    f_multigrid ( initData(&f_multigrid, false, "multigrid", "use a multigrid preconditioned conjugate gradient to compute the pressure") ),
+    f_parallel ( initData(&f_parallel, false, "parallel", "run the grid update in parallel using the task scheduler") )
 {
     fluid = new Grid3D;
     fnext = new Grid3D;
@@ -74,6 +77,16 @@ Fluid3D::~Fluid3D()
 
 void Fluid3D::init()
 {
+    if (f_parallel.getValue())
+    {
+        sofa::simulation::TaskScheduler* taskScheduler = sofa::simulation::MainTaskSchedulerFactory::createInRegistry();
+        if (taskScheduler->getThreadCount() < 1)
+        {
+            taskScheduler->init(0);
+            msg_info() << "Task scheduler initialized on " << taskScheduler->getThreadCount() << " threads";
+        }
+    }
+
     int& nx = *f_nx.beginEdit();
     int& ny = *f_ny.beginEdit();
     int& nz = *f_nz.beginEdit();
@@ -103,6 +116,8 @@ void Fluid3D::reset()
 void Fluid3D::updatePosition(SReal dt)
 {
     fnext->gravity = getContext()->getGravity()/f_cellwidth.getValue();
+    fnext->multigrid = f_multigrid.getValue();
+    fnext->task_scheduler = f_parallel.getValue() ? sofa::simulation::MainTaskSchedulerFactory::createInRegistry() : NULL;
     fnext->step(fluid, ftemp, (real)dt);
     Grid3D* p = fluid; fluid=fnext; fnext=p;
 }
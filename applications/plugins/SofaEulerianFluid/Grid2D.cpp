@@ -22,6 +22,7 @@
 #include <iostream>
 #include <SofaEulerianFluid/Grid2D.h>
 #include <sofa/core/visual/VisualParams.h>
+#include <sofa/simulation/ParallelForEach.h>
 #include <cstring>
 
 
@@ -76,6 +77,31 @@ const unsigned long* Grid2D::obstacles = NULL;
       }                                       \
 }
 
+// Same as FOR_INNER_CELLS, with rows processed in parallel if a task
+// scheduler is set. cmd must only write to the current cell.
+
+#define PARALLEL_FOR_INNER_CELLS(grid,cmd)    \
+{                                             \
+  forEachRow(task_scheduler, 1, ny-1, [&](int y) \
+  {                                           \
+    int ind = index(1,y);                     \
+      for (int x=1;x<nx-1;x++,ind+=index(1,0))\
+      {                                       \
+    cmd;                                  \
+      }                                       \
+  });                                         \
+}
+
+template<class Function>
+static void forEachRow(sofa::simulation::TaskScheduler* taskScheduler, int begin, int end, Function f)
+{
+    if (taskScheduler != NULL)
+        sofa::simulation::parallelForEach(*taskScheduler, begin, end, f);
+    else
+        for (int i=begin; i<end; i++)
+            f(i);
+}
+
 // Surface cells  are inner  cells and borders  between a  fluid inner
 // cell and an empty out cell (right or bottom side)
 
@@ -94,6 +120,7 @@ Grid2D::Grid2D()
       fdata(NULL), pressure(NULL), levelset(NULL),
       t(0), tend(60),
       max_pressure(0.0),
+      multigrid(false), mg_solver(NULL), task_scheduler(NULL),
       fmm_status(NULL),
       fmm_heap(NULL),
       fmm_heap_size(0)
@@ -109,6 +136,7 @@ Grid2D::~Grid2D()
     if (levelset!=NULL) delete[] levelset;
     if (fmm_status!=NULL) delete[] fmm_status;
     if (fmm_heap!=NULL) delete[] fmm_heap;
+    if (mg_solver!=NULL) delete mg_solver;
 }
 
 void Grid2D::clear(int _nx, int _ny)
@@ -573,7 +601,7 @@ void Grid2D::step_forces(const Grid2D* prev, Grid2D* /*temp*/, real dt, real /*d
 
     vec2 f(0,-5*dt);
 
-    FOR_INNER_CELLS(fdata,
+    PARALLEL_FOR_INNER_CELLS(fdata,
     {
         vec2 u = f;
         int p0 = fdata[ind].type;
@@ -720,7 +748,7 @@ void Grid2D::step_advect(const Grid2D* /*prev*/, Grid2D* temp, real dt, real /*d
 
     memset(temp->fdata,0,temp->ncell*sizeof(Cell));
 
-    FOR_INNER_CELLS(temp->fdata,
+    PARALLEL_FOR_INNER_CELLS(temp->fdata,
     {
         // X Axis
         vec2 px( x-0.5f - dt*(fdata[ind].u[0]),
@@ -749,7 +777,7 @@ void Grid2D::step_diffuse(const Grid2D* /*prev*/, Grid2D* temp, real /*dt*/, rea
     real a = diff;
     real inv_c = 1.0f / (1.0001f + 4*a);
 
-    FOR_INNER_CELLS(fdata,
+    PARALLEL_FOR_INNER_CELLS(fdata,
     {
         fdata[ind].u = (temp->fdata[ind].u +
         (temp->fdata[ind+index(-1,0)].u+temp->fdata[ind+index(1,0)].u+
@@ -779,6 +807,39 @@ void Grid2D::step_project(const Grid2D* prev, Grid2D* temp, real dt, real /*diff
 
     real a = -1.0f/dt;
 
+    if (multigrid)
+    {
+        // Same system, solved by a multigrid preconditioned conjugate gradient
+        if (mg_solver==NULL) mg_solver = new MultigridPressureSolver;
+        mg_solver->taskScheduler = task_scheduler;
+        mg_solver->resize(nx,ny);
+
+        PARALLEL_FOR_INNER_CELLS(b,
+        {
+            int type = fdata[ind].type;
+            if (type>0)
+            {
+                mg_solver->setCellType(ind, MultigridPressureSolver::CELL_FLUID);
+                b[ind] = a*(fdata[ind+index(1,0)].u[0]-fdata[ind].u[0] + fdata[ind+index(0,1)].u[1]-fdata[ind].u[1]);
+            }
+            else if (type==PART_EMPTY)
+                mg_solver->setCellType(ind, MultigridPressureSolver::CELL_AIR);
+        });
+        mg_solver->buildHierarchy(); // only rebuilt when the cell types changed
+
+        FOR_ALL_CELLS(pressure,
+        {
+            if (fdata[ind].type>0)
+                pressure[ind] = prev->pressure[ind]; // use previous pressure as initial estimate
+            else pressure[ind] = 0;
+        });
+
+        mg_solver->solve(b, pressure, 0.0001f, 100);
+
+        step_apply_pressure(prev, dt);
+        return;
+    }
+
     real b_norm2 = 0.0;
 
     //  int nbdiag[7]={0,0,0,0,0,0,0};
@@ -877,15 +938,20 @@ void Grid2D::step_project(const Grid2D* prev, Grid2D* temp, real dt, real /*diff
         });
     }
 
+    step_apply_pressure(prev, dt);
+}
+
+void Grid2D::step_apply_pressure(const Grid2D* prev, real dt)
+{
     // Now apply pressure back to velocity
-    a = dt;
+    real a = dt;
 
     real max_speed = 0.5f/dt;
 
     //max_pressure = 0.0f;
     max_pressure = prev->max_pressure;
 
-    FOR_INNER_CELLS(fdata,
+    PARALLEL_FOR_INNER_CELLS(fdata,
     {
         if (fdata[ind].type>=PART_EMPTY)
         {
@@ -22,6 +22,7 @@
 #include <iostream>
 #include <SofaEulerianFluid/Grid3D.h>
 #include <sofa/core/visual/VisualParams.h>
+#include <sofa/simulation/ParallelForEach.h>
 #include <cstring>
 
 // set to true/false to activate extra verbose FMM.
@@ -81,6 +82,32 @@ const unsigned long* Grid3D::obstacles = NULL;
       }                                         \
 }
 
+// Same as FOR_INNER_CELLS, with z-slabs processed in parallel if a task
+// scheduler is set. cmd must only write to the current cell.
+
+#define PARALLEL_FOR_INNER_CELLS(grid,cmd)      \
+{                                               \
+  forEachSlab(task_scheduler, 1, nz-1, [&](int z) \
+  {                                             \
+    int ind = index(1,1,z);                     \
+    for (int y=1;y<ny-1;y++,ind+=index(2,0,0))  \
+      for (int x=1;x<nx-1;x++,ind+=index(1,0,0))\
+      {                                         \
+    cmd;                                    \
+      }                                         \
+  });                                           \
+}
+
+template<class Function>
+static void forEachSlab(sofa::simulation::TaskScheduler* taskScheduler, int begin, int end, Function f)
+{
+    if (taskScheduler != NULL)
+        sofa::simulation::parallelForEach(*taskScheduler, begin, end, f);
+    else
+        for (int i=begin; i<end; i++)
+            f(i);
+}
+
 // Surface cells  are inner  cells and borders  between a  fluid inner
 // cell and an empty out cell (right or bottom side)
 
@@ -101,6 +128,7 @@ Grid3D::Grid3D()
       t(0), tend(60),
       max_pressure(0.0),
       gravity(0,-5,0),
+      multigrid(false), mg_solver(NULL), task_scheduler(NULL),
       fmm_status(NULL),
       fmm_heap(NULL),
       fmm_heap_size(0)
@@ -116,6 +144,7 @@ Grid3D::~Grid3D()
     if (levelset!=NULL) delete[] levelset;
     if (fmm_status!=NULL) delete[] fmm_status;
     if (fmm_heap!=NULL) delete[] fmm_heap;
+    if (mg_solver!=NULL) delete mg_solver;
 }
 
 void Grid3D::clear(int _nx, int _ny, int _nz)
@@ -607,7 +636,7 @@ void Grid3D::step_forces(const Grid3D* prev, Grid3D* /*temp*/, real dt, real /*d
     //vec3 f(0,0,-9.81*dt/scale);
     vec3 f = gravity * dt; //(0,-5*dt,0);
 
-    FOR_INNER_CELLS(fdata,
+    PARALLEL_FOR_INNER_CELLS(fdata,
     {
         vec3 u = f;
         int p0 = fdata[ind].type;
@@ -835,7 +864,7 @@ void Grid3D::step_advect(const Grid3D* /*prev*/, Grid3D* temp, real dt, real /*d
 
     memset(temp->fdata,0,temp->ncell*sizeof(Cell));
 
-    FOR_INNER_CELLS(temp->fdata,
+    PARALLEL_FOR_INNER_CELLS(temp->fdata,
     {
         // X Axis
         vec3 px( x-0.5f - dt*(fdata[ind].u[0]),
@@ -871,7 +900,7 @@ void Grid3D::step_diffuse(const Grid3D* /*prev*/, Grid3D* temp, real /*dt*/, rea
     real a = diff;
     real inv_c = 1.0f / (1.0001f + 6*a);
 
-    FOR_INNER_CELLS(fdata,
+    PARALLEL_FOR_INNER_CELLS(fdata,
     {
         fdata[ind].u = (temp->fdata[ind].u +
         (temp->fdata[ind+index(-1,0,0)].u+temp->fdata[ind+index(1,0,0)].u+
@@ -902,6 +931,39 @@ void Grid3D::step_project(const Grid3D* prev, Grid3D* temp, real dt, real /*diff
 
     real a = -1.0f/dt;
 
+    if (multigrid)
+    {
+        // Same system, solved by a multigrid preconditioned conjugate gradient
+        if (mg_solver==NULL) mg_solver = new MultigridPressureSolver;
+        mg_solver->taskScheduler = task_scheduler;
+        mg_solver->resize(nx,ny,nz);
+
+        PARALLEL_FOR_INNER_CELLS(b,
+        {
+            int type = fdata[ind].type;
+            if (type>0)
+            {
+                mg_solver->setCellType(ind, MultigridPressureSolver::CELL_FLUID);
+                b[ind] = a*(fdata[ind+index(1,0,0)].u[0]-fdata[ind].u[0] + fdata[ind+index(0,1,0)].u[1]-fdata[ind].u[1] + fdata[ind+index(0,0,1)].u[2]-fdata[ind].u[2]);
+            }
+            else if (type==PART_EMPTY)
+                mg_solver->setCellType(ind, MultigridPressureSolver::CELL_AIR);
+        });
+        mg_solver->buildHierarchy(); // only rebuilt when the cell types changed
+
+        FOR_ALL_CELLS(pressure,
+        {
+            if (fdata[ind].type>0)
+                pressure[ind] = prev->pressure[ind]; // use previous pressure as initial estimate
+            else pressure[ind] = 0;
+        });
+
+        mg_solver->solve(b, pressure, 0.000001f, 100);
+
+        step_apply_pressure(prev, dt);
+        return;
+    }
+
     double b_norm2 = 0.0;
 
     //  int nbdiag[7]={0,0,0,0,0,0,0};
@@ -1002,15 +1064,20 @@ void Grid3D::step_project(const Grid3D* prev, Grid3D* temp, real dt, real /*diff
         });
     }
 
+    step_apply_pressure(prev, dt);
+}
+
+void Grid3D::step_apply_pressure(const Grid3D* prev, real dt)
+{
     // Now apply pressure back to velocity
-    a = dt;
+    real a = dt;
 
     real max_speed = 0.5f/dt;
 
     //max_pressure = 0.0;
     max_pressure = prev->max_pressure;
 
-    FOR_INNER_CELLS(fdata,
+    PARALLEL_FOR_INNER_CELLS(fdata,
     {
         if (fdata[ind].type>=PART_EMPTY)
         {
@@ -23,6 +23,7 @@
 #define SOFA_COMPONENT_BEHAVIORMODEL_EULERIANFLUID_GRID3D_H
 #include "config.h"
 
+#include <SofaEulerianFluid/MultigridPressureSolver.h>
 #include <sofa/type/Vec.h>
 #include <sofa/type/Mat.h>
 #include <sofa/helper/rmath.h>
@@ -83,6 +84,13 @@ public:
 
     static const unsigned long* obstacles;
 
+    /// use a multigrid preconditioned conjugate gradient in step_project instead of the plain conjugate gradient
+    bool multigrid;
+    MultigridPressureSolver* mg_solver;
+
+    /// if not NULL, the stencil loops are run in parallel over z-slabs
+    sofa::simulation::TaskScheduler* task_scheduler;
+
     Grid3D();
     ~Grid3D();
 
@@ -285,6 +293,7 @@ public:
     void step_advect(const Grid3D* prev, Grid3D* temp, real dt, real diff);
     void step_diffuse(const Grid3D* prev, Grid3D* temp, real dt, real diff);
     void step_project(const Grid3D* prev, Grid3D* temp, real dt, real diff);
+    void step_apply_pressure(const Grid3D* prev, real dt);
     void step_color(const Grid3D* prev, Grid3D* temp, real dt, real diff);
 
     // internal helper function
@@ -0,0 +1,309 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <SofaEulerianFluid/MultigridPressureSolver.h>
+#include <algorithm>
+
+namespace sofa
+{
+
+namespace component
+{
+
+namespace behaviormodel
+{
+
+namespace eulerianfluid
+{
+
+MultigridPressureSolver::MultigridPressureSolver()
+    : nbSmoothingSteps(2), nbCoarsestSteps(20), taskScheduler(nullptr), dim(3)
+{
+}
+
+void MultigridPressureSolver::resize(int nx, int ny, int nz)
+{
+    dim = (nz > 1) ? 3 : 2;
+    if (!levels.empty() && levels[0].nx == nx && levels[0].ny == ny && levels[0].nz == nz)
+    {
+        cellTypes.assign(levels[0].ncell, (signed char)CELL_WALL);
+        return;
+    }
+
+    levels.resize(1);
+    Level& l = levels[0];
+    l.nx = nx; l.ny = ny; l.nz = nz;
+    l.nxny = nx*ny; l.ncell = l.nxny*nz;
+    l.z0 = (dim == 3) ? 1 : 0;
+    l.z1 = (dim == 3) ? nz-1 : 1;
+    l.scale = 1;
+    l.type.assign(l.ncell, (signed char)CELL_WALL);
+    cellTypes.assign(l.ncell, (signed char)CELL_WALL);
+    hierarchyTypes.clear();
+}
+
+void MultigridPressureSolver::computeDiagonal(Level& l)
+{
+    l.diag.assign(l.ncell, 0);
+    l.invdiag.assign(l.ncell, 0);
+    l.x.assign(l.ncell, 0);
+    l.b.assign(l.ncell, 0);
+    l.r.assign(l.ncell, 0);
+    forInnerCells(l, [&](int ind, int, int, int)
+    {
+        if (l.type[ind] != CELL_FLUID) return;
+        int n = (l.type[ind-1] != CELL_WALL) + (l.type[ind+1] != CELL_WALL)
+              + (l.type[ind-l.nx] != CELL_WALL) + (l.type[ind+l.nx] != CELL_WALL);
+        if (dim == 3)
+            n += (l.type[ind-l.nxny] != CELL_WALL) + (l.type[ind+l.nxny] != CELL_WALL);
+        if (n == 0)
+        {
+            // isolated cell: no flux can go through it
+            l.type[ind] = CELL_WALL;
+            return;
+        }
+        l.diag[ind] = (real)n;
+        l.invdiag[ind] = 1.0f/n;
+    });
+}
+
+bool MultigridPressureSolver::buildHierarchy()
+{
+    // the coarse grids only depend on the cell types, which usually change much less often than the pressure
+    if (!hierarchyTypes.empty() && hierarchyTypes == cellTypes)
+        return false;
+    hierarchyTypes = cellTypes;
+
+    levels.resize(1);
+    levels[0].type = cellTypes;
+    computeDiagonal(levels[0]);
+
+    // number of fine faces for each coarse face
+    const real faceScale = (dim == 3) ? 4.0f : 2.0f;
+
+    for (;;)
+    {
+        const Level& f = levels.back();
+        const int inx = f.nx-2, iny = f.ny-2, inz = f.nz-2;
+        int minSize = std::min(inx, iny);
+        if (dim == 3) minSize = std::min(minSize, inz);
+        if (minSize < 4) break;
+
+        Level c;
+        c.nx = (inx+1)/2+2;
+        c.ny = (iny+1)/2+2;
+        c.nz = (dim == 3) ? (inz+1)/2+2 : 1;
+        c.nxny = c.nx*c.ny; c.ncell = c.nxny*c.nz;
+        c.z0 = (dim == 3) ? 1 : 0;
+        c.z1 = (dim == 3) ? c.nz-1 : 1;
+        c.scale = f.scale*faceScale;
+        c.type.assign(c.ncell, (signed char)CELL_WALL);
+
+        // coarse inner cell X covers the fine cells 2X-1 and 2X
+        const int nz2 = (dim == 3) ? 2 : 1;
+        forInnerCells(c, [&](int ind, int x, int y, int z)
+        {
+            bool air = false, fluid = false;
+            for (int dz=0; dz<nz2; ++dz)
+                for (int dy=0; dy<2; ++dy)
+                    for (int dx=0; dx<2; ++dx)
+                    {
+                        const int t = f.type[f.index(2*x-1+dx, 2*y-1+dy, (dim == 3) ? 2*z-1+dz : 0)];
+                        if (t == CELL_AIR) air = true;
+                        else if (t == CELL_FLUID) fluid = true;
+                    }
+            c.type[ind] = (signed char)(air ? CELL_AIR : fluid ? CELL_FLUID : CELL_WALL);
+        });
+        computeDiagonal(c);
+        levels.push_back(std::move(c));
+    }
+    return true;
+}
+
+void MultigridPressureSolver::smooth(Level& l, int parity)
+{
+    const real invscale = 1.0f/l.scale;
+    real* x = l.x.data();
+    forInnerCells(l, [&](int ind, int cx, int cy, int cz)
+    {
+        if (((cx+cy+cz)&1) != parity || l.type[ind] != CELL_FLUID) return;
+        real sum = x[ind-1] + x[ind+1] + x[ind-l.nx] + x[ind+l.nx];
+        if (dim == 3)
+            sum += x[ind-l.nxny] + x[ind+l.nxny];
+        x[ind] = (l.b[ind]*invscale + sum)*l.invdiag[ind];
+    });
+}
+
+void MultigridPressureSolver::vcycle(int level)
+{
+    Level& l = levels[level];
+
+    if (level+1 == (int)levels.size())
+    {
+        for (int i=0; i<nbCoarsestSteps; ++i)
+        {
+            smooth(l, 0);
+            smooth(l, 1);
+        }
+        for (int i=0; i<nbCoarsestSteps; ++i)
+        {
+            smooth(l, 1);
+            smooth(l, 0);
+        }
+        return;
+    }
+
+    for (int i=0; i<nbSmoothingSteps; ++i)
+    {
+        smooth(l, 0);
+        smooth(l, 1);
+    }
+
+    forInnerCells(l, [&](int ind, int, int, int)
+    {
+        l.r[ind] = (l.type[ind] == CELL_FLUID) ? l.b[ind] - apply(l, l.x.data(), ind) : 0;
+    });
+
+    // restriction: sum of the children residuals
+    Level& c = levels[level+1];
+    const int nz2 = (dim == 3) ? 2 : 1;
+    forInnerCells(c, [&](int ind, int x, int y, int z)
+    {
+        real sum = 0;
+        if (c.type[ind] == CELL_FLUID)
+        {
+            for (int dz=0; dz<nz2; ++dz)
+                for (int dy=0; dy<2; ++dy)
+                    for (int dx=0; dx<2; ++dx)
+                        sum += l.r[l.index(2*x-1+dx, 2*y-1+dy, (dim == 3) ? 2*z-1+dz : 0)];
+        }
+        c.b[ind] = sum;
+        c.x[ind] = 0;
+    });
+
+    vcycle(level+1);
+
+    // prolongation: inject the coarse correction in the fluid children
+    forInnerCells(l, [&](int ind, int x, int y, int z)
+    {
+        if (l.type[ind] == CELL_FLUID)
+            l.x[ind] += c.x[c.index((x+1)/2, (y+1)/2, (dim == 3) ? (z+1)/2 : 0)];
+    });
+
+    for (int i=0; i<nbSmoothingSteps; ++i)
+    {
+        smooth(l, 1);
+        smooth(l, 0);
+    }
+}
+
+int MultigridPressureSolver::solve(const real* b, real* p, real tolerance2, int maxIterations)
+{
+    Level& f = levels[0];
+    // the residual is stored in the right hand side of the finest grid, and
+    // the preconditioned residual in its solution vector
+    real* res = f.b.data();
+    real* z = f.x.data();
+    d.assign(f.ncell, 0);
+    q.assign(f.ncell, 0);
+
+    const double b_norm2 = sumInnerCells(f, [&](int ind, int, int, int) -> double
+    {
+        if (f.type[ind] != CELL_FLUID)
+        {
+            p[ind] = 0;
+            return 0.0;
+        }
+        return (double)b[ind]*b[ind];
+    });
+
+    double err = sumInnerCells(f, [&](int ind, int, int, int) -> double
+    {
+        z[ind] = 0;
+        if (f.type[ind] != CELL_FLUID)
+        {
+            res[ind] = 0;
+            return 0.0;
+        }
+        const real ri = b[ind] - apply(f, p, ind);
+        res[ind] = ri;
+        return (double)ri*ri;
+    });
+
+    const double min_err = tolerance2*b_norm2;
+    if (err <= min_err)
+        return 0;
+
+    vcycle(0);
+    double rz = sumInnerCells(f, [&](int ind, int, int, int) -> double
+    {
+        d[ind] = z[ind];
+        return (double)res[ind]*z[ind];
+    });
+
+    int step;
+    for (step=0; step<maxIterations; ++step)
+    {
+        const double dq = sumInnerCells(f, [&](int ind, int, int, int) -> double
+        {
+            if (f.type[ind] != CELL_FLUID) return 0.0;
+            const real Ad = apply(f, d.data(), ind);
+            q[ind] = Ad;
+            return (double)d[ind]*Ad;
+        });
+        if (dq <= 0) break;
+        const real alpha = (real)(rz/dq);
+
+        err = sumInnerCells(f, [&](int ind, int, int, int) -> double
+        {
+            p[ind] += alpha*d[ind];
+            res[ind] -= alpha*q[ind];
+            z[ind] = 0;
+            return (double)res[ind]*res[ind];
+        });
+        if (err <= min_err)
+        {
+            ++step;
+            break;
+        }
+
+        vcycle(0);
+        const double rz_new = sumInnerCells(f, [&](int ind, int, int, int) -> double
+        {
+            return (double)res[ind]*z[ind];
+        });
+        const real beta = (real)(rz_new/rz);
+        rz = rz_new;
+        forInnerCells(f, [&](int ind, int, int, int)
+        {
+            d[ind] = z[ind] + beta*d[ind];
+        });
+    }
+    return step;
+}
+
+} // namespace eulerianfluid
+
+} // namespace behaviormodel
+
+} // namespace component
+
+} // namespace sofa
@@ -0,0 +1,233 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#ifndef SOFA_COMPONENT_BEHAVIORMODEL_EULERIANFLUID_MULTIGRIDPRESSURESOLVER_H
+#define SOFA_COMPONENT_BEHAVIORMODEL_EULERIANFLUID_MULTIGRIDPRESSURESOLVER_H
+#include "config.h"
+
+#include <sofa/simulation/TaskScheduler.h>
+#include <sofa/simulation/ParallelForEach.h>
+#include <vector>
+
+namespace sofa
+{
+
+namespace component
+{
+
+namespace behaviormodel
+{
+
+namespace eulerianfluid
+{
+
+/// Pressure Poisson solver shared by Grid2D and Grid3D.
+///
+/// Solves A p = b where A is the 5 (2D) or 7 (3D) points negative laplacian
+/// restricted to the fluid cells, with wall faces removed (free-slip) and
+/// air neighbours held at p = 0. The system is solved with a conjugate
+/// gradient preconditioned by one symmetric multigrid V-cycle
+/// (McAdams et al., "A parallel multigrid Poisson solver for fluids
+/// simulation on large grids", 2010):
+/// - coarse cells group 2x2(x2) fine cells, they are air if any child is
+///   air, fluid if any other child is fluid, and walls otherwise;
+/// - restriction sums the children residuals, prolongation injects the
+///   coarse correction back (R = P^T) and the coarse operator is the
+///   rediscretized laplacian scaled by the number of fine faces per coarse
+///   face, so that the V-cycle stays symmetric positive definite;
+/// - red-black Gauss-Seidel is used as smoother, in reverse color order
+///   after the coarse grid correction.
+///
+/// 2D grids are handled as 3D grids with nz = 1.
+/// If a task scheduler is given, all the loops are run in parallel over
+/// z-slabs (y rows in 2D). The dot products are accumulated per slab and
+/// then summed in order, so the result does not depend on the number of
+/// threads.
+class SOFA_EULERIAN_FLUID_API MultigridPressureSolver
+{
+public:
+    typedef float real;
+
+    enum { CELL_WALL=-1, CELL_AIR=0, CELL_FLUID=1 };
+
+    MultigridPressureSolver();
+
+    /// Resize the finest grid, all cells are initialized as walls.
+    /// Border cells must stay walls.
+    /// The hierarchy is kept if the size does not change, until buildHierarchy is called.
+    void resize(int nx, int ny, int nz=1);
+
+    /// Set the type of a cell of the finest grid (CELL_WALL, CELL_AIR or CELL_FLUID)
+    void setCellType(int ind, int type)
+    {
+        cellTypes[ind] = (signed char)type;
+    }
+
+    /// Build the coarse grids from the cell types of the finest grid.
+    /// The hierarchy is only rebuilt if the size or the cell types changed since the last build.
+    /// @return true if the hierarchy was rebuilt
+    bool buildHierarchy();
+
+    /// Solve A p = b, using the initial value of p as first estimate.
+    /// Iterations stop when |r|^2 <= tolerance2*|b|^2. Entries of p outside of the fluid
+    /// are set to 0 for inner cells, they must already be 0 on the borders.
+    /// @return the number of iterations
+    int solve(const real* b, real* p, real tolerance2, int maxIterations);
+
+    /// Number of grids in the hierarchy
+    int getNbLevels() const { return (int)levels.size(); }
+
+    /// Number of iterations (for the multigrid preconditioner) of the smoother before and after the coarse grid correction
+    int nbSmoothingSteps;
+    /// Number of symmetric smoothing iterations on the coarsest grid
+    int nbCoarsestSteps;
+    /// If not null, the loops are run in parallel using this task scheduler
+    sofa::simulation::TaskScheduler* taskScheduler;
+
+protected:
+
+    struct Level
+    {
+        int nx,ny,nz,nxny,ncell;
+        int z0,z1; ///< range of inner slabs along the last axis
+        real scale; ///< scale of the operator compared to the finest grid
+        std::vector<signed char> type;
+        std::vector<real> diag; ///< number of non-wall neighbours of fluid cells
+        std::vector<real> invdiag;
+        std::vector<real> x, b, r;
+        int index(int x, int y, int z) const { return x + y*nx + z*nxny; }
+    };
+
+    std::vector<Level> levels;
+    int dim;
+
+    /// cell types of the finest grid set since the last resize
+    std::vector<signed char> cellTypes;
+    /// cell types of the finest grid the hierarchy was built from, empty if it must be rebuilt
+    std::vector<signed char> hierarchyTypes;
+
+    /// conjugate gradient directions (the residual and preconditioned residual are
+    /// stored in the right hand side and solution of the finest grid)
+    std::vector<real> d, q;
+    std::vector<double> partial;
+
+    /// Call f(s) for all the inner slabs (along z in 3D, y in 2D) of the given level
+    template<class F>
+    void forSlabs(const Level& l, F f);
+
+    /// Call f(ind, x, y, z) for all the inner cells of the slab s of the given level
+    template<class F>
+    void forSlabCells(const Level& l, int s, F f) const;
+
+    /// Call f(ind, x, y, z) for all the inner cells of the given level, by slabs
+    template<class F>
+    void forInnerCells(const Level& l, F f);
+
+    /// Call f(ind, x, y, z) for all the inner cells of the given level, by slabs,
+    /// and return the sum of the values returned by f, in a deterministic order
+    template<class F>
+    double sumInnerCells(const Level& l, F f);
+
+    /// Compute the diagonal of the operator of the level
+    void computeDiagonal(Level& l);
+    /// Apply the operator of the level on the fluid cell ind
+    real apply(const Level& l, const real* x, int ind) const
+    {
+        real sum = x[ind-1] + x[ind+1] + x[ind-l.nx] + x[ind+l.nx];
+        if (dim == 3)
+            sum += x[ind-l.nxny] + x[ind+l.nxny];
+        return l.scale*(l.diag[ind]*x[ind] - sum);
+    }
+    /// One Gauss-Seidel sweep over the cells of the given parity
+    void smooth(Level& l, int parity);
+    /// Approximate A x = b on the given level and its coarser grids, starting from x = 0
+    void vcycle(int level);
+};
+
+template<class F>
+void MultigridPressureSolver::forSlabCells(const Level& l, int s, F f) const
+{
+    if (dim == 3)
+    {
+        for (int y=1; y<l.ny-1; ++y)
+        {
+            int ind = l.index(1,y,s);
+            for (int x=1; x<l.nx-1; ++x, ++ind)
+                f(ind, x, y, s);
+        }
+    }
+    else
+    {
+        int ind = l.index(1,s,0);
+        for (int x=1; x<l.nx-1; ++x, ++ind)
+            f(ind, x, s, 0);
+    }
+}
+
+template<class F>
+void MultigridPressureSolver::forSlabs(const Level& l, F f)
+{
+    const int s0 = (dim == 3) ? l.z0 : 1;
+    const int s1 = (dim == 3) ? l.z1 : l.ny-1;
+    if (taskScheduler != nullptr && s1-s0 > 1)
+        sofa::simulation::parallelForEach(*taskScheduler, s0, s1, f);
+    else
+        for (int s=s0; s<s1; ++s)
+            f(s);
+}
+
+template<class F>
+void MultigridPressureSolver::forInnerCells(const Level& l, F f)
+{
+    forSlabs(l, [&](int s)
+    {
+        forSlabCells(l, s, f);
+    });
+}
+
+template<class F>
+double MultigridPressureSolver::sumInnerCells(const Level& l, F f)
+{
+    partial.assign((dim == 3) ? l.nz : l.ny, 0.0);
+    forSlabs(l, [&](int s)
+    {
+        double sum = 0.0;
+        forSlabCells(l, s, [&](int ind, int x, int y, int z)
+        {
+            sum += f(ind, x, y, z);
+        });
+        partial[s] = sum;
+    });
+    double sum = 0.0;
+    for (double p : partial)
+        sum += p;
+    return sum;
+}
+
+} // namespace eulerianfluid
+
+} // namespace behaviormodel
+
+} // namespace component
+
+} // namespace sofa
+
+#endif
@@ -0,0 +1,345 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/testing/BaseTest.h>
+#include <sofa/testing/ScopedTaskScheduler.h>
+
+#include <SofaEulerianFluid/MultigridPressureSolver.h>
+#include <SofaEulerianFluid/Grid2D.h>
+#include <SofaEulerianFluid/Grid3D.h>
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace
+{
+
+using sofa::component::behaviormodel::eulerianfluid::MultigridPressureSolver;
+using sofa::component::behaviormodel::eulerianfluid::Grid2D;
+using sofa::component::behaviormodel::eulerianfluid::Grid3D;
+typedef MultigridPressureSolver::real real;
+
+/// Pressure Poisson problem in a box: walls on the borders, air in the cells above airHeight,
+/// and fluid elsewhere. The right hand side is computed from a known random pressure.
+struct PoissonProblem
+{
+    int nx, ny, nz, nxny, dim;
+    std::vector<int> type;
+    std::vector<real> expected;
+    std::vector<real> b;
+
+    PoissonProblem(int _nx, int _ny, int _nz, int airHeight)
+        : nx(_nx), ny(_ny), nz(_nz), nxny(_nx*_ny), dim(_nz > 1 ? 3 : 2)
+        , type(nx*ny*nz, MultigridPressureSolver::CELL_WALL), expected(nx*ny*nz, 0), b(nx*ny*nz, 0)
+    {
+        std::mt19937 generator(42);
+        std::uniform_real_distribution<real> distribution(-1, 1);
+        const int z0 = (dim == 3) ? 1 : 0;
+        const int z1 = (dim == 3) ? nz-1 : 1;
+        for (int z=z0; z<z1; ++z)
+            for (int y=1; y<ny-1; ++y)
+                for (int x=1; x<nx-1; ++x)
+                {
+                    const int ind = x + y*nx + z*nxny;
+                    if (y >= airHeight)
+                        type[ind] = MultigridPressureSolver::CELL_AIR;
+                    else
+                    {
+                        type[ind] = MultigridPressureSolver::CELL_FLUID;
+                        expected[ind] = distribution(generator);
+                    }
+                }
+        for (int ind=0; ind<(int)type.size(); ++ind)
+            if (type[ind] == MultigridPressureSolver::CELL_FLUID)
+                b[ind] = (real)apply(expected, ind);
+    }
+
+    /// Negative laplacian, without the wall faces and with p = 0 in the air
+    double apply(const std::vector<real>& p, int ind) const
+    {
+        double result = 0;
+        for (int n : neighbours())
+        {
+            if (type[ind+n] != MultigridPressureSolver::CELL_WALL)
+                result += p[ind];
+            if (type[ind+n] == MultigridPressureSolver::CELL_FLUID)
+                result -= p[ind+n];
+        }
+        return result;
+    }
+
+    std::vector<int> neighbours() const
+    {
+        if (dim == 3)
+            return { -1, 1, -nx, nx, -nxny, nxny };
+        return { -1, 1, -nx, nx };
+    }
+
+    void setup(MultigridPressureSolver& solver) const
+    {
+        solver.resize(nx, ny, nz);
+        for (int ind=0; ind<(int)type.size(); ++ind)
+            solver.setCellType(ind, type[ind]);
+        solver.buildHierarchy();
+    }
+
+    double residualNorm2(const std::vector<real>& p) const
+    {
+        double norm2 = 0;
+        for (int ind=0; ind<(int)type.size(); ++ind)
+            if (type[ind] == MultigridPressureSolver::CELL_FLUID)
+            {
+                const double r = b[ind] - apply(p, ind);
+                norm2 += r*r;
+            }
+        return norm2;
+    }
+
+    double rhsNorm2() const
+    {
+        double norm2 = 0;
+        for (real v : b)
+            norm2 += (double)v*v;
+        return norm2;
+    }
+};
+
+struct MultigridPressureSolver_test : public sofa::testing::BaseTest
+{
+    void checkSolve(int nx, int ny, int nz)
+    {
+        const PoissonProblem problem(nx, ny, nz, ny*3/4);
+        MultigridPressureSolver solver;
+        problem.setup(solver);
+        EXPECT_GT(solver.getNbLevels(), 2);
+
+        const real tolerance2 = 1e-10f;
+        std::vector<real> p(problem.b.size(), 0);
+        const double initialResidual = problem.residualNorm2(p);
+        const int nbIterations = solver.solve(problem.b.data(), p.data(), tolerance2, 100);
+
+        // the multigrid preconditioner makes the number of iterations almost independent of the grid size
+        EXPECT_LT(nbIterations, 20);
+        EXPECT_LT(problem.residualNorm2(p), 1e-6 * initialResidual);
+        EXPECT_LE(problem.residualNorm2(p), 2 * tolerance2 * problem.rhsNorm2());
+
+        double maxError = 0;
+        for (std::size_t i=0; i<p.size(); ++i)
+            maxError = std::max(maxError, (double)std::abs(p[i] - problem.expected[i]));
+        EXPECT_LT(maxError, 1e-2);
+    }
+
+    void checkParallelSolve(int nx, int ny, int nz)
+    {
+        const PoissonProblem problem(nx, ny, nz, ny*3/4);
+        MultigridPressureSolver sequential;
+        problem.setup(sequential);
+        std::vector<real> p0(problem.b.size(), 0);
+        const int nbIterations0 = sequential.solve(problem.b.data(), p0.data(), 1e-10f, 100);
+
+        sofa::testing::ScopedTaskScheduler taskScheduler(4);
+        MultigridPressureSolver parallel;
+        parallel.taskScheduler = taskScheduler.get();
+        problem.setup(parallel);
+        std::vector<real> p1(problem.b.size(), 0);
+        const int nbIterations1 = parallel.solve(problem.b.data(), p1.data(), 1e-10f, 100);
+
+        // the dot products are summed in the same order: the results are the same
+        EXPECT_EQ(nbIterations0, nbIterations1);
+        EXPECT_EQ(p0, p1);
+    }
+};
+
+TEST_F(MultigridPressureSolver_test, solvePoissonProblem2D)
+{
+    checkSolve(66, 66, 1);
+}
+
+TEST_F(MultigridPressureSolver_test, solvePoissonProblem3D)
+{
+    checkSolve(34, 34, 34);
+}
+
+TEST_F(MultigridPressureSolver_test, parallelSolve2D)
+{
+    checkParallelSolve(66, 66, 1);
+}
+
+TEST_F(MultigridPressureSolver_test, parallelSolve3D)
+{
+    checkParallelSolve(34, 34, 34);
+}
+
+/// The hierarchy is only rebuilt when the size or the cell types change, and the solve does not depend on it
+TEST_F(MultigridPressureSolver_test, reuseHierarchy)
+{
+    const PoissonProblem problem(34, 34, 34, 34*3/4);
+    MultigridPressureSolver solver;
+    solver.resize(problem.nx, problem.ny, problem.nz);
+    for (int ind=0; ind<(int)problem.type.size(); ++ind)
+        solver.setCellType(ind, problem.type[ind]);
+    EXPECT_TRUE(solver.buildHierarchy());
+    std::vector<real> p0(problem.b.size(), 0);
+    solver.solve(problem.b.data(), p0.data(), 1e-10f, 100);
+
+    // same cell types: the hierarchy is kept, and gives the same solution
+    solver.resize(problem.nx, problem.ny, problem.nz);
+    for (int ind=0; ind<(int)problem.type.size(); ++ind)
+        solver.setCellType(ind, problem.type[ind]);
+    EXPECT_FALSE(solver.buildHierarchy());
+    std::vector<real> p1(problem.b.size(), 0);
+    solver.solve(problem.b.data(), p1.data(), 1e-10f, 100);
+    EXPECT_EQ(p0, p1);
+
+    // an inner cell becomes a wall
+    solver.resize(problem.nx, problem.ny, problem.nz);
+    for (int ind=0; ind<(int)problem.type.size(); ++ind)
+        solver.setCellType(ind, problem.type[ind]);
+    solver.setCellType(1 + problem.nx + problem.nxny, MultigridPressureSolver::CELL_WALL);
+    EXPECT_TRUE(solver.buildHierarchy());
+
+    // another size
+    const PoissonProblem other(18, 18, 18, 18*3/4);
+    solver.resize(other.nx, other.ny, other.nz);
+    for (int ind=0; ind<(int)other.type.size(); ++ind)
+        solver.setCellType(ind, other.type[ind]);
+    EXPECT_TRUE(solver.buildHierarchy());
+    std::vector<real> p2(other.b.size(), 0);
+    solver.solve(other.b.data(), p2.data(), 1e-10f, 100);
+    EXPECT_LE(other.residualNorm2(p2), 2 * 1e-10 * other.rhsNorm2());
+}
+
+/// Grids of a fluid in the lower half of a box, with random initial velocities
+template<class TGrid>
+struct FluidGrids
+{
+    TGrid grids[3];
+    TGrid* fluid { &grids[0] };
+    TGrid* next { &grids[1] };
+    TGrid* temp { &grids[2] };
+
+    template<class... Sizes>
+    FluidGrids(bool multigrid, sofa::simulation::TaskScheduler* taskScheduler, Sizes... sizes)
+    {
+        for (TGrid& grid : grids)
+        {
+            grid.clear(sizes...);
+            grid.multigrid = multigrid;
+            grid.task_scheduler = taskScheduler;
+        }
+        fluid->seed((real)fluid->ny/2);
+
+        std::mt19937 generator(42);
+        std::uniform_real_distribution<real> distribution(-1, 1);
+        for (int ind=0; ind<fluid->ncell; ++ind)
+            for (auto& u : fluid->fdata[ind].u)
+                u = distribution(generator);
+    }
+
+    /// Project the initial velocities only
+    void project()
+    {
+        next->step_init(fluid, temp, 0.04f, 0.00001f);
+        for (int ind=0; ind<fluid->ncell; ++ind)
+            next->fdata[ind].u = fluid->fdata[ind].u;
+        next->step_project(fluid, temp, 0.04f, 0.00001f);
+        std::swap(fluid, next);
+    }
+
+    /// Run the whole steps of the simulation
+    void step(int nbSteps)
+    {
+        for (int i=0; i<nbSteps; ++i)
+        {
+            next->step(fluid, temp, 0.04f, 0.00001f);
+            std::swap(fluid, next);
+        }
+    }
+};
+
+template<class TGrid>
+void expectSameVelocities(const TGrid& grid0, const TGrid& grid1, double tolerance)
+{
+    ASSERT_EQ(grid0.ncell, grid1.ncell);
+    for (int ind=0; ind<grid0.ncell; ++ind)
+        for (std::size_t c=0; c<grid0.fdata[ind].u.size(); ++c)
+            EXPECT_NEAR(grid0.fdata[ind].u[c], grid1.fdata[ind].u[c], tolerance) << "cell " << ind;
+}
+
+template<class TGrid>
+void expectSameGrids(const TGrid& grid0, const TGrid& grid1)
+{
+    ASSERT_EQ(grid0.ncell, grid1.ncell);
+    for (int ind=0; ind<grid0.ncell; ++ind)
+    {
+        EXPECT_EQ(grid0.fdata[ind].u, grid1.fdata[ind].u) << "cell " << ind;
+        EXPECT_EQ(grid0.fdata[ind].type, grid1.fdata[ind].type) << "cell " << ind;
+        EXPECT_EQ(grid0.pressure[ind], grid1.pressure[ind]) << "cell " << ind;
+        EXPECT_EQ(grid0.levelset[ind], grid1.levelset[ind]) << "cell " << ind;
+    }
+}
+
+TEST_F(MultigridPressureSolver_test, projectionAgreesWithConjugateGradient2D)
+{
+    FluidGrids<Grid2D> cg(false, nullptr, 34, 34);
+    FluidGrids<Grid2D> mg(true, nullptr, 34, 34);
+    cg.project();
+    mg.project();
+    expectSameVelocities(*cg.fluid, *mg.fluid, 1e-2);
+}
+
+TEST_F(MultigridPressureSolver_test, projectionAgreesWithConjugateGradient3D)
+{
+    FluidGrids<Grid3D> cg(false, nullptr, 18, 18, 18);
+    FluidGrids<Grid3D> mg(true, nullptr, 18, 18, 18);
+    cg.project();
+    mg.project();
+    expectSameVelocities(*cg.fluid, *mg.fluid, 1e-2);
+}
+
+TEST_F(MultigridPressureSolver_test, parallelStencils2D)
+{
+    sofa::testing::ScopedTaskScheduler taskScheduler(4);
+    for (bool multigrid : { false, true })
+    {
+        FluidGrids<Grid2D> sequential(multigrid, nullptr, 34, 34);
+        FluidGrids<Grid2D> parallel(multigrid, taskScheduler.get(), 34, 34);
+        sequential.step(5);
+        parallel.step(5);
+        expectSameGrids(*sequential.fluid, *parallel.fluid);
+    }
+}
+
+TEST_F(MultigridPressureSolver_test, parallelStencils3D)
+{
+    sofa::testing::ScopedTaskScheduler taskScheduler(4);
+    for (bool multigrid : { false, true })
+    {
+        FluidGrids<Grid3D> sequential(multigrid, nullptr, 18, 18, 18);
+        FluidGrids<Grid3D> parallel(multigrid, taskScheduler.get(), 18, 18, 18);
+        sequential.step(5);
+        parallel.step(5);
+        expectSameGrids(*sequential.fluid, *parallel.fluid);
+    }
+}
+
+}
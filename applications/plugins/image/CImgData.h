@@ -1,6 +1,7 @@
 #pragma once 
 
 #include <CImgPlugin/SOFACImg.h>
+#include <image/TiledImage.h>
 
 // datatypes
 #include <sofa/type/fixed_array.h>
@@ -50,45 +51,99 @@ struct Image : public BaseImage
     /// the 5 dimension labels of an image ( x, y, z, spectrum=nb channels , time )
     typedef enum{ DIMENSION_X=0, DIMENSION_Y, DIMENSION_Z, DIMENSION_S /* spectrum = nb channels*/, DIMENSION_T /*4th dimension = time*/, NB_DimensionLabel } DimensionLabel;
 
+    typedef TiledImageStorage<T> TiledStorage;
+    typedef typename TiledStorage::ScopedCImgList ScopedCImgList;
+    typedef typename TiledStorage::ScopedCImg ScopedCImg;
+
 protected:
     cimg_library::CImgList<T> img; // list of images along temporal dimension. Each image is 4-dimensional (x,y,z,s) where s is the spectrum (e.g. channels for color images, vector or tensor values, etc.)
 
+    /// out-of-core storage of the image, shared between the copies of the image. When set, img is empty.
+    /// The copies in memory of a tiled image are kept by the storage, so they are shared by these copies too.
+    std::shared_ptr<const TiledStorage> tiles;
+
+    /// the image in memory is about to be modified: it is not a copy of the tiled storage anymore
+    void detachTiles()
+    {
+        if(!tiles) return;
+        img.assign(*tiles->getScopedCImgList());
+        tiles.reset();
+    }
+
 public:
     static const char* Name();
 
     ///constructors/destructors
     Image() {}
-    Image(const Image<T>& _img, bool shared=false) : img(_img.getCImgList(), shared) {}
+    Image(const Image<T>& _img, bool shared=false) : tiles(_img.tiles) { if(!tiles) img.assign(_img.getCImgList(), shared); }
     Image( const cimg_library::CImg<T>& _img ) : img(_img) {}
 
     /// copy operators
+    /// A tiled image is copied by sharing its storage: it is loaded in memory only if needed
     Image<T>& operator=(const Image<T>& im)
     {
-        if(im.getCImgList().size()) img.assign(im.getCImgList());
+        if(im.tiles) { setTiles(im.tiles); }
+        else if(im.getCImgList().size()) { detachTiles(); img.assign(im.getCImgList()); }
         return *this;
     }
     Image<T>& assign(const Image<T>& im, const bool shared=false)
     {
-        if(im.getCImgList().size()) img.assign(im.getCImgList(),shared);
+        if(im.tiles) { setTiles(im.tiles); }
+        else if(im.getCImgList().size()) { detachTiles(); img.assign(im.getCImgList(),shared); }
         return *this;
     }
 
 
-    void clear() { img.assign(); }
+    void clear() { img.assign(); tiles.reset(); }
     ~Image() override { clear(); }
 
     //accessors
-    cimg_library::CImgList<T>& getCImgList() { return img; }
-    const cimg_library::CImgList<T>& getCImgList() const { return img; }
+    /// non-const access to a tiled image loads it in memory, and detaches it from its storage
+    cimg_library::CImgList<T>& getCImgList() { detachTiles(); return img; }
+    /// const access to a tiled image loads all its times in memory, and keeps this copy until releaseCImgList is called.
+    /// Prefer getScopedCImgList, getScopedCImg or the brick accessors of the tiled storage, which do not keep the image in memory.
+    const cimg_library::CImgList<T>& getCImgList() const
+    {
+        if(!tiles) return img;
+        return tiles->pinCImgList();
+    }
+
+    /// read access to the whole image in memory. A tiled image is loaded in memory only as long as the returned
+    /// pointer (or another one to the same copy) is kept: the copy is shared by the concurrent readers.
+    ScopedCImgList getScopedCImgList() const
+    {
+        if(!tiles) return ScopedCImgList(ScopedCImgList(), &img); // not owning
+        return tiles->getScopedCImgList();
+    }
+
+    /// read access to the image at time t in memory. Only this time of a tiled image is loaded, as long as the
+    /// returned pointer is kept.
+    ScopedCImg getScopedCImg(const unsigned int t=0) const
+    {
+        if(!tiles) return ScopedCImg(ScopedCImg(), &getCImg(t)); // not owning
+        return tiles->getScopedCImg(t);
+    }
+
+    /// release the copies in memory of a tiled image kept by the const getCImgList/getCImg of all the images
+    /// sharing its storage. The references they returned are not valid anymore.
+    void releaseCImgList() const
+    {
+        if(tiles) tiles->releasePinned();
+    }
 
     cimg_library::CImg<T>& getCImg(const unsigned int t=0) {
+        cimg_library::CImgList<T>& img = getCImgList();
         if (t>=img.size())   {
             assert(img._data != nullptr);
             return *img._data;
         }
         return img(t);
     }
+    /// const access to a tiled image loads only the image at time t in memory, and keeps this copy until
+    /// releaseCImgList is called (the ImageContainer calls it at the end of each time step).
     const cimg_library::CImg<T>& getCImg(const unsigned int t=0) const {
+        if(tiles) return tiles->pinCImg(t);
+        const cimg_library::CImgList<T>& img = getCImgList();
         if (t>=img.size())   {
             assert(img._data != nullptr);
             return *img._data;
@@ -96,7 +151,23 @@ public:
         return img(t);
     }
 
-    inline bool isEmpty() const {return img.size()==0;}
+    /// out-of-core storage
+    bool isTiled() const { return tiles != nullptr; }
+    const std::shared_ptr<const TiledStorage>& getTiles() const { return tiles; }
+    /// replace the image by a tiled storage. The image in memory is released.
+    void setTiles(std::shared_ptr<const TiledStorage> storage)
+    {
+        img.assign();
+        tiles=std::move(storage);
+    }
+    /// true if the image is in memory
+    bool isMaterialized() const
+    {
+        if(!tiles) return img.size()!=0;
+        return tiles->isMaterialized();
+    }
+
+    inline bool isEmpty() const {return img.size()==0 && (!tiles || tiles->getDimensions()[4]==0);}
 
     /// check if image coordinates are inside bounds
     template<class t>
@@ -106,6 +177,11 @@ public:
         if(x<0) return false;
         if(y<0) return false;
         if(z<0) return false;
+        if(!img.size())
+        {
+            const imCoord& dim = tiles->getDimensions();
+            return x<(t)dim[0] && y<(t)dim[1] && z<(t)dim[2];
+        }
         if(x>=(t)img(0).width()) return false;
         if(y>=(t)img(0).height()) return false;
         if(z>=(t)img(0).depth()) return false;
@@ -115,7 +191,11 @@ public:
     imCoord getDimensions() const
     {
         imCoord dim;
-        if(!img.size()) dim.fill(0);
+        if(!img.size())
+        {
+            if(tiles) dim=tiles->getDimensions();
+            else dim.fill(0);
+        }
         else
         {
             dim[0]=img(0).width();
@@ -130,6 +210,7 @@ public:
     //affectors
     void setDimensions(const imCoord& dim) override
     {
+        detachTiles();
         cimglist_for(img,l) img(l).resize(dim[0],dim[1],dim[2],dim[3]);
         if(img.size()>dim[4]) img.remove(dim[4],img.size()-1);
         else if(img.size()<dim[4]) img.insert(dim[4]-img.size(),cimg_library::CImg<T>(dim[0],dim[1],dim[2],dim[3]));
@@ -137,6 +218,7 @@ public:
 
     void fill(const SReal val) override
     {
+        detachTiles();
         cimglist_for(img,l) img(l).fill((T)val);
     }
 
@@ -156,9 +238,11 @@ public:
 
     bool operator == ( const Image<T>& other ) const
     {
-        if( img.size() != other.img.size() ) return false;
-        for( unsigned t=0 ; t<img.size() ; ++t )
-            if( img[t] != other.img[t] ) return false;
+        if( tiles && tiles==other.tiles ) return true;
+        const ScopedCImgList img = getScopedCImgList(), otherImg = other.getScopedCImgList();
+        if( img->size() != otherImg->size() ) return false;
+        for( unsigned t=0 ; t<img->size() ; ++t )
+            if( (*img)[t] != (*otherImg)[t] ) return false;
         return true;
     }
 
@@ -179,6 +263,8 @@ public:
     */
     cimg_library::CImg<unsigned int> get_histogram(T& value_min, T& value_max, const unsigned int dimx, const bool mergeChannels=false) const
     {
+        const ScopedCImgList scopedImg = getScopedCImgList();
+        const cimg_library::CImgList<T>& img = *scopedImg;
         if(!img.size()) return cimg_library::CImg<unsigned int>();
         const unsigned int s=mergeChannels?1:img(0).spectrum();
         cimg_library::CImg<unsigned int> res(dimx,1,1,s,0);
@@ -229,15 +315,23 @@ public:
         return res;
     }
 
+    // returns the box [x0,x1]x[y0,y1]x[z0,z1] at time t, with all the channels
+    // a tiled image is read brick by brick, without being loaded in memory
+    cimg_library::CImg<T> get_crop(const unsigned int x0,const unsigned int y0,const unsigned int z0,const unsigned int x1,const unsigned int y1,const unsigned int z1,const unsigned int t=0) const
+    {
+        if(tiles) return tiles->getCrop(type::Vec<3,unsigned int>(x0,y0,z0),type::Vec<3,unsigned int>(x1,y1,z1),t<tiles->getDimensions()[4]?t:0);
+        return getCImg(t).get_crop(x0,y0,z0,0,x1,y1,z1,getCImg(t).spectrum()-1);
+    }
+
     // returns an image corresponding to a plane indexed by "coord" along "axis" and inside a bounding box
     cimg_library::CImg<T> get_plane(const unsigned int coord,const unsigned int axis,const type::Mat<2,3,unsigned int>& ROI,const unsigned int t=0, const bool mergeChannels=false) const
     {
         if(mergeChannels)    return get_plane(coord,axis,ROI,t,false).norm();
         else
         {
-            if(axis==0)       return getCImg(t).get_crop(coord,ROI[0][1],ROI[0][2],0,coord,ROI[1][1],ROI[1][2],getCImg(t).spectrum()-1).permute_axes("zyxc");
-            else if(axis==1)  return getCImg(t).get_crop(ROI[0][0],coord,ROI[0][2],0,ROI[1][0],coord,ROI[1][2],getCImg(t).spectrum()-1).permute_axes("xzyc");
-            else              return getCImg(t).get_crop(ROI[0][0],ROI[0][1],coord,0,ROI[1][0],ROI[1][1],coord,getCImg(t).spectrum()-1);
+            if(axis==0)       return get_crop(coord,ROI[0][1],ROI[0][2],coord,ROI[1][1],ROI[1][2],t).permute_axes("zyxc");
+            else if(axis==1)  return get_crop(ROI[0][0],coord,ROI[0][2],ROI[1][0],coord,ROI[1][2],t).permute_axes("xzyc");
+            else              return get_crop(ROI[0][0],ROI[0][1],coord,ROI[1][0],ROI[1][1],coord,t);
         }
     }
 
@@ -344,8 +438,8 @@ public:
     /// \returns an approximative size in bytes, useful for debugging
     size_t approximativeSizeInBytes() const
     {
-        if( img.is_empty() ) return 0;
-        return img(0).width()*img(0).height()*img(0).depth()*img(0).spectrum()*img.size()*sizeof(T);
+        const imCoord dim = getDimensions();
+        return size_t(dim[0])*dim[1]*dim[2]*dim[3]*dim[4]*sizeof(T);
     }
 
 };
@@ -147,7 +147,8 @@ protected:
 
 		if((*in)->isEmpty()) return;
 
-        const cimg_library::CImgList<Ti>& inimg = (*in)->getCImgList();
+        const auto scopedInimg = (*in)->getScopedCImgList();
+        const cimg_library::CImgList<Ti>& inimg = *scopedInimg;
         cimg_library::CImgList<To>& img = (*out)->getCImgList();
         if(updateImage) img.assign(inimg);	// copy
         if(updateTransform) (*outT)->operator=(*inT);	// copy
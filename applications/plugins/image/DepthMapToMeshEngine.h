@@ -159,14 +159,16 @@ protected:
         waTriangles tri(this->triangles);
 
         // get image at time t
-        const cimg_library::CImg<T>& img = in->getCImg(this->time);
+        const auto scopedImg = in->getScopedCImg(this->time);
+        const cimg_library::CImg<T>& img = *scopedImg;
         Real f = this->depthFactor.getValue();
 
 #if IMAGE_HAVE_SOFA_GL == 1
         // update texture
         if(texture && !inTex->isEmpty())
         {
-            const cimg_library::CImg<T>& tex = inTex->getCImg(this->time);
+            const auto scopedTex = inTex->getScopedCImg(this->time);
+            const cimg_library::CImg<T>& tex = *scopedTex;
             cimg_library::CImg<unsigned char> plane=convertToUC( tex.get_resize(texture_res,texture_res,1,-100,1) );
             cimg_forXY(plane,x,y)
             {
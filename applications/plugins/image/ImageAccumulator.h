@@ -127,7 +127,7 @@ protected:
         if(out->isEmpty()) {t0=CTime::getTime(); outT->operator=(inT);}
         else { count++; t=CTime::getTime(); outT->getScaleT()=0.000001*(t-t0)/(Real)count; } // update time scale to fit acquisition rate
 
-        out->getCImgList().push_back(in->getCImg(0));
+        out->getCImgList().push_back(*in->getScopedCImg(0));
     }
 
     void handleEvent(sofa::core::objectmodel::Event *event) override
@@ -26,6 +26,10 @@
 #include <sofa/type/Vec.h>
 #include <sofa/helper/rmath.h>
 #include <sofa/type/Mat.h>
+#include <sofa/simulation/ParallelForEach.h>
+#include <algorithm>
+#include <map>
+#include <mutex>
 #include <set>
 #include <vector>
 
@@ -47,62 +51,104 @@
 /**
 *  Move points to the centroid of their voronoi region
 *  returns true if points have moved
+*  Centroids are accumulated in a single pass over the image, by slices (in parallel if a task scheduler is given).
+*  Voxel coordinates are integers, so that the centroids do not depend on the number of threads.
 */
 
 template<typename real>
-bool Lloyd (std::vector<sofa::type::Vec<3,real> >& pos,const std::vector<unsigned int>& voronoiIndex, cimg_library::CImg<unsigned int>& voronoi)
+bool Lloyd (std::vector<sofa::type::Vec<3,real> >& pos,const std::vector<unsigned int>& voronoiIndex, cimg_library::CImg<unsigned int>& voronoi, sofa::simulation::TaskScheduler* taskScheduler=nullptr)
 {
     typedef sofa::type::Vec<3,real> Coord;
-    unsigned int nbp=pos.size();
+    typedef sofa::type::Vec<3,int> iCoord;
+    const unsigned int nbp=pos.size();
+    if(!nbp) return false;
     bool moved=false;
 
-#ifdef _OPENMP
-#pragma omp parallel for
-#endif
-#ifdef WIN32
-	for(long int i=0; i<nbp; i++)
-#else
-    for (unsigned int i=0; i<nbp; i++)
-#endif
+    // point of each voronoi index
+    const unsigned int maxIndex = *std::max_element(voronoiIndex.begin(),voronoiIndex.end());
+    std::vector<int> point(maxIndex+1,-1);
+    for (unsigned int i=0; i<nbp; i++) point[voronoiIndex[i]]=i;
+
+    // sum of coordinates, number of voxels and bounding box of each voronoi region
+    struct Region
     {
-        // compute centroid
-        Coord C,p;
-        unsigned int count=0;
-        bool valid=true;
+        long long sum[3] = {0,0,0};
+        std::size_t count = 0;
+        iCoord bbmin, bbmax;
+    };
+    std::vector<Region> regions(nbp);
+    std::mutex mutex;
+
+    auto accumulate = [&](const sofa::simulation::Range<int>& range)
+    {
+        std::vector<Region> local(nbp);
+        for (int z=range.start; z<range.end; z++) cimg_forXY(voronoi,x,y)
+        {
+            const unsigned int v=voronoi(x,y,z);
+            if(v>maxIndex || point[v]<0) continue;
+            Region& r=local[point[v]];
+            if(!r.count) r.bbmin=r.bbmax=iCoord(x,y,z);
+            else for (unsigned int j=0; j<3; j++) { r.bbmin[j]=std::min(r.bbmin[j],iCoord(x,y,z)[j]); r.bbmax[j]=std::max(r.bbmax[j],iCoord(x,y,z)[j]); }
+            r.sum[0]+=x; r.sum[1]+=y; r.sum[2]+=z;
+            r.count++;
+        }
 
-        cimg_forXYZ(voronoi,x,y,z) if (voronoi(x,y,z)==voronoiIndex[i])
+        std::lock_guard<std::mutex> lock(mutex);
+        for (unsigned int i=0; i<nbp; i++) if(local[i].count)
         {
-            C+=Coord(x,y,z);
-            count++;
+            Region& r=regions[i];
+            if(!r.count) { r.bbmin=local[i].bbmin; r.bbmax=local[i].bbmax; }
+            else for (unsigned int j=0; j<3; j++) { r.bbmin[j]=std::min(r.bbmin[j],local[i].bbmin[j]); r.bbmax[j]=std::max(r.bbmax[j],local[i].bbmax[j]); }
+            for (unsigned int j=0; j<3; j++) r.sum[j]+=local[i].sum[j];
+            r.count+=local[i].count;
         }
-        if(!count) goto stop;
-        C/=(real)count;
+    };
+    if(taskScheduler) sofa::simulation::parallelForEachRange(*taskScheduler, 0, voronoi.depth(), accumulate);
+    else sofa::simulation::forEachRange(0, voronoi.depth(), accumulate);
+
+    // occupancy of the voxels by the points
+    auto voxelOffset = [&voronoi](const Coord& p) { return voronoi.offset((int)sofa::helper::round(p[0]),(int)sofa::helper::round(p[1]),(int)sofa::helper::round(p[2])); };
+    std::map<long,unsigned int> occupancy;
+    for (unsigned int i=0; i<nbp; i++) occupancy[voxelOffset(pos[i])]++;
+    auto isOccupied = [&](const Coord& p, const unsigned int i) { const long off=voxelOffset(p); return occupancy[off] > (voxelOffset(pos[i])==off ? 1u : 0u); };
+
+    for (unsigned int i=0; i<nbp; i++)
+    {
+        const Region& r=regions[i];
+        if(!r.count) continue;
+
+        // compute centroid
+        Coord C,p;
+        for (unsigned int j=0; j<3; j++) C[j]=(real)r.sum[j]/(real)r.count;
 
         // check validity
+        bool valid=true;
         for (unsigned int j=0; j<3; j++) p[j]=sofa::helper::round(C[j]);
         if (voronoi(p[0],p[1],p[2])!=voronoiIndex[i]) valid=false; // out of voronoi
-        else { for (unsigned int j=0; j<nbp; j++) if(i!=j) if(sofa::helper::round(pos[j][0])==p[0]) if(sofa::helper::round(pos[j][1])==p[1]) if(sofa::helper::round(pos[j][2])==p[2]) valid=false; } // check occupancy
+        else if (isOccupied(p,i)) valid=false; // check occupancy
 
+        bool found=true;
         while(!valid)  // get closest unoccupied point in voronoi
         {
             real dmin=cimg_library::cimg::type<real>::max();
-            cimg_forXYZ(voronoi,x,y,z) if (voronoi(x,y,z)==voronoiIndex[i])
+            for (int z=r.bbmin[2]; z<=r.bbmax[2]; z++) for (int y=r.bbmin[1]; y<=r.bbmax[1]; y++) for (int x=r.bbmin[0]; x<=r.bbmax[0]; x++) if (voronoi(x,y,z)==voronoiIndex[i])
             {
                 real d2=(C-Coord(x,y,z)).norm2();
                 if(dmin>d2) { dmin=d2; p=Coord(x,y,z); }
             }
-            if(dmin==cimg_library::cimg::type<real>::max()) goto stop;// no point found
-            bool val2=true; for (unsigned int j=0; j<nbp; j++) if(i!=j) if(sofa::helper::round(pos[j][0])==p[0]) if(sofa::helper::round(pos[j][1])==p[1]) if(sofa::helper::round(pos[j][2])==p[2]) val2=false; // check occupancy
-            if(val2) valid=true;
+            if(dmin==cimg_library::cimg::type<real>::max()) { found=false; break; } // no point found
+            if(!isOccupied(p,i)) valid=true;
             else voronoi(p[0],p[1],p[2])=0;
         }
+        if(!found) continue;
 
         if(pos[i][0]!=p[0] || pos[i][1]!=p[1] || pos[i][2]!=p[2]) // set new position if different
         {
+            occupancy[voxelOffset(pos[i])]--;
+            occupancy[voxelOffset(p)]++;
             pos[i] = p;
             moved=true;
         }
-stop: ;
     }
 
     return moved;
@@ -570,6 +616,277 @@ void parallelMarching(cimg_library::CImg<real>& distances, cimg_library::CImg<un
     }
 }
 
+/**
+* Compute exact euclidean distances to the seeds, in three separable passes along the axes. Each pass computes, for each line
+* of the image, the lower envelope of the parabolas centered on the voxels of the line
+* (cf "Distance Transforms of Sampled Functions", Felzenszwalb and Huttenlocher, 2012).
+* Unlike fast marching, distances are straight-line distances: they do not go around the concavities of the object.
+* distances should be initialized (<0 outside the object, >=0 inside, and = 0 for seeds)
+* Lines are independent, and processed in parallel if a task scheduler is given: the result does not depend on the number of threads.
+* @returns @param voronoi and @param distances
+*/
+template<typename real>
+void euclideanDistanceTransform(cimg_library::CImg<real>& distances, cimg_library::CImg<unsigned int>& voronoi, const sofa::type::Vec<3, real>& voxelSize, sofa::simulation::TaskScheduler* taskScheduler=nullptr)
+{
+    const real inf = std::numeric_limits<real>::infinity();
+    const int dim[3] = {distances.width(), distances.height(), distances.depth()};
+    const long stride[3] = {1, (long)dim[0], (long)dim[0]*dim[1]};
+
+    // squared distances and closest seeds, computed on the whole grid
+    cimg_library::CImg<real> d2(dim[0],dim[1],dim[2]);
+    cimg_library::CImg<unsigned int> closest(voronoi);
+    cimg_foroff(d2,off) d2[off] = (distances[off]==0 && voronoi[off]) ? (real)0 : inf;
+
+    for (unsigned int axis=0; axis<3; axis++)
+    {
+        const int n = dim[axis];
+        const int n1 = dim[(axis+1)%3];
+        const real h = voxelSize[axis];
+
+        auto transformLines = [&](const sofa::simulation::Range<int>& range)
+        {
+            std::vector<real> f(n), envelopeBounds(n+1);
+            std::vector<unsigned int> seed(n);
+            std::vector<int> envelope(n);
+
+            for (int line=range.start; line<range.end; line++)
+            {
+                const long first = (line%n1)*stride[(axis+1)%3] + (line/n1)*stride[(axis+2)%3];
+                for (int q=0; q<n; q++) { f[q]=d2[first+q*stride[axis]]; seed[q]=closest[first+q*stride[axis]]; }
+
+                // lower envelope of the parabolas
+                int k=-1;
+                for (int q=0; q<n; q++)
+                {
+                    if(f[q]==inf) continue;
+                    const real fq = f[q] + (q*h)*(q*h);
+                    real s = -inf;
+                    while(k>=0)
+                    {
+                        const int v = envelope[k];
+                        s = (fq - f[v] - (v*h)*(v*h)) / (2*h*(q-v));
+                        if(s<=envelopeBounds[k]) k--;
+                        else break;
+                    }
+                    if(k<0) s=-inf;
+                    k++;
+                    envelope[k]=q;
+                    envelopeBounds[k]=s;
+                    envelopeBounds[k+1]=inf;
+                }
+                if(k<0) continue; // no seed on this line
+
+                for (int q=0, j=0; q<n; q++)
+                {
+                    while(envelopeBounds[j+1] < q*h) j++;
+                    const int v = envelope[j];
+                    d2[first+q*stride[axis]] = (q-v)*h*(q-v)*h + f[v];
+                    closest[first+q*stride[axis]] = seed[v];
+                }
+            }
+        };
+
+        const int nbLines = dim[(axis+1)%3]*dim[(axis+2)%3];
+        if(taskScheduler) sofa::simulation::parallelForEachRange(*taskScheduler, 0, nbLines, transformLines);
+        else sofa::simulation::forEachRange(0, nbLines, transformLines);
+    }
+
+    // distances inside the object
+    cimg_foroff(distances,off) if(distances[off]>=0 && d2[off]!=inf)
+    {
+        distances[off] = std::sqrt(d2[off]);
+        voronoi[off] = closest[off];
+    }
+}
+
+
+/**
+* Conservative rasterization of primitives (triangles or edges) in an image: all the voxels intersected by a primitive are drawn.
+* A voxel (x,y,z) is the unit cube centered on the integer image coordinates (x,y,z), so that no voxel crossed by a
+* primitive is missed whatever its size, unlike subdivision-based rasterization.
+* The image is split in slabs along z, rasterized independently (in parallel if a task scheduler is given). In each slab, voxels
+* are drawn by the primitives in their order: the result does not depend on the number of threads.
+* @param getBoundingBox(i,min,max) returns the bounding box of primitive i in image coordinates
+* @param drawPrimitive(i,min,max) draws primitive i in the voxels between min and max (included)
+*/
+template<typename real, class BoundingBoxFunction, class DrawPrimitiveFunction>
+void rasterizeBySlabs(const unsigned int nbPrimitives, const sofa::type::Vec<3,int>& dim, BoundingBoxFunction getBoundingBox, DrawPrimitiveFunction drawPrimitive, sofa::simulation::TaskScheduler* taskScheduler=nullptr)
+{
+    typedef sofa::type::Vec<3,real> Coord;
+    typedef sofa::type::Vec<3,int> iCoord;
+    if(!nbPrimitives || dim[0]<=0 || dim[1]<=0 || dim[2]<=0) return;
+
+    // voxels intersected by the bounding boxes of the primitives
+    std::vector<iCoord> bbmin(nbPrimitives), bbmax(nbPrimitives);
+    std::vector<bool> visible(nbPrimitives,true);
+    for (unsigned int i=0; i<nbPrimitives; i++)
+    {
+        Coord pmin,pmax;
+        getBoundingBox(i,pmin,pmax);
+        for (unsigned int j=0; j<3; j++)
+        {
+            bbmin[i][j] = std::max(0, (int)std::ceil(pmin[j]-(real)0.5));
+            bbmax[i][j] = std::min(dim[j]-1, (int)std::floor(pmax[j]+(real)0.5));
+            if(bbmin[i][j]>bbmax[i][j]) visible[i]=false;
+        }
+    }
+
+    // primitives of each slab, in their order
+    const int slabThickness = std::max(1, dim[2]/64);
+    const int nbSlabs = (dim[2]+slabThickness-1)/slabThickness;
+    std::vector<std::vector<unsigned int> > slabs(nbSlabs);
+    for (unsigned int i=0; i<nbPrimitives; i++) if(visible[i])
+        for (int s=bbmin[i][2]/slabThickness; s<=bbmax[i][2]/slabThickness; s++)
+            slabs[s].push_back(i);
+
+    auto rasterizeSlabs = [&](const sofa::simulation::Range<int>& range)
+    {
+        for (int s=range.start; s<range.end; s++)
+            for (const unsigned int i : slabs[s])
+            {
+                iCoord vmin=bbmin[i], vmax=bbmax[i];
+                vmin[2]=std::max(vmin[2],s*slabThickness);
+                vmax[2]=std::min(vmax[2],(s+1)*slabThickness-1);
+                drawPrimitive(i,vmin,vmax);
+            }
+    };
+    if(taskScheduler) sofa::simulation::parallelForEachRange(*taskScheduler, 0, nbSlabs, rasterizeSlabs);
+    else sofa::simulation::forEachRange(0, nbSlabs, rasterizeSlabs);
+}
+
+/// separating axis test between a triangle and a box given by its center and half size
+template<typename real>
+bool triangleBoxOverlap(const sofa::type::Vec<3,real>& center, const sofa::type::Vec<3,real>& halfSize, const sofa::type::Vec<3,real>& p0, const sofa::type::Vec<3,real>& p1, const sofa::type::Vec<3,real>& p2)
+{
+    typedef sofa::type::Vec<3,real> Coord;
+    const Coord v[3] = {p0-center, p1-center, p2-center};
+    const Coord e[3] = {v[1]-v[0], v[2]-v[1], v[0]-v[2]};
+
+    auto separates = [&](const Coord& axis)
+    {
+        const real d0=sofa::type::dot(v[0],axis), d1=sofa::type::dot(v[1],axis), d2=sofa::type::dot(v[2],axis);
+        const real r = halfSize[0]*std::abs(axis[0]) + halfSize[1]*std::abs(axis[1]) + halfSize[2]*std::abs(axis[2]);
+        return std::min({d0,d1,d2}) > r || std::max({d0,d1,d2}) < -r;
+    };
+
+    for (unsigned int i=0; i<3; i++)
+    {
+        Coord u; u[i]=1;
+        if(separates(u)) return false; // box faces
+        for (unsigned int j=0; j<3; j++) if(separates(sofa::type::cross(u,e[j]))) return false; // edge-edge
+    }
+    return !separates(sofa::type::cross(e[0],e[1])); // triangle plane
+}
+
+/// separating axis test between a segment and a box given by its center and half size
+template<typename real>
+bool segmentBoxOverlap(const sofa::type::Vec<3,real>& center, const sofa::type::Vec<3,real>& halfSize, const sofa::type::Vec<3,real>& p0, const sofa::type::Vec<3,real>& p1)
+{
+    typedef sofa::type::Vec<3,real> Coord;
+    const Coord v0 = p0-center, v1 = p1-center, e = p1-p0;
+
+    auto separates = [&](const Coord& axis)
+    {
+        const real d0=sofa::type::dot(v0,axis), d1=sofa::type::dot(v1,axis);
+        const real r = halfSize[0]*std::abs(axis[0]) + halfSize[1]*std::abs(axis[1]) + halfSize[2]*std::abs(axis[2]);
+        return std::min(d0,d1) > r || std::max(d0,d1) < -r;
+    };
+
+    for (unsigned int i=0; i<3; i++)
+    {
+        Coord u; u[i]=1;
+        if(separates(u) || separates(sofa::type::cross(u,e))) return false;
+    }
+    return true;
+}
+
+/**
+* Conservative rasterization of triangles given in image coordinates (see rasterizeBySlabs).
+* draw(x,y,z,i,w) is called for each voxel intersected by triangle i,
+* where w are the barycentric coordinates of the projection of the voxel center on the triangle.
+*/
+template<typename real, class DrawFunction>
+void rasterizeTriangles(const std::vector<sofa::type::fixed_array<sofa::type::Vec<3,real>,3> >& triangles, const sofa::type::Vec<3,int>& dim, DrawFunction draw, sofa::simulation::TaskScheduler* taskScheduler=nullptr)
+{
+    typedef sofa::type::Vec<3,real> Coord;
+    typedef sofa::type::Vec<3,int> iCoord;
+    const Coord halfSize((real)0.5,(real)0.5,(real)0.5);
+
+    rasterizeBySlabs<real>(triangles.size(), dim,
+        [&triangles](const unsigned int i, Coord& pmin, Coord& pmax)
+        {
+            for (unsigned int j=0; j<3; j++)
+            {
+                pmin[j] = std::min({triangles[i][0][j], triangles[i][1][j], triangles[i][2][j]});
+                pmax[j] = std::max({triangles[i][0][j], triangles[i][1][j], triangles[i][2][j]});
+            }
+        },
+        [&](const unsigned int i, const iCoord& vmin, const iCoord& vmax)
+        {
+            const Coord& p0=triangles[i][0];
+            const Coord e1=triangles[i][1]-p0, e2=triangles[i][2]-p0;
+            const real d11=sofa::type::dot(e1,e1), d12=sofa::type::dot(e1,e2), d22=sofa::type::dot(e2,e2);
+            const real det=d11*d22-d12*d12;
+
+            for (int z=vmin[2]; z<=vmax[2]; z++) for (int y=vmin[1]; y<=vmax[1]; y++) for (int x=vmin[0]; x<=vmax[0]; x++)
+            {
+                const Coord c(x,y,z);
+                if(!triangleBoxOverlap(c,halfSize,p0,triangles[i][1],triangles[i][2])) continue;
+
+                Coord w((real)1/3,(real)1/3,(real)1/3); // degenerate triangle
+                if(det>std::numeric_limits<real>::epsilon()*d11*d22)
+                {
+                    const real c1=sofa::type::dot(c-p0,e1), c2=sofa::type::dot(c-p0,e2);
+                    w[1]=std::max((real)0,(d22*c1-d12*c2)/det);
+                    w[2]=std::max((real)0,(d11*c2-d12*c1)/det);
+                    w[0]=std::max((real)0,1-w[1]-w[2]);
+                    w/=w[0]+w[1]+w[2];
+                }
+                draw(x,y,z,i,w);
+            }
+        },
+        taskScheduler);
+}
+
+/**
+* Conservative rasterization of edges given in image coordinates (see rasterizeBySlabs).
+* draw(x,y,z,i,u) is called for each voxel intersected by edge i,
+* where u is the parameter of the projection of the voxel center on the edge.
+*/
+template<typename real, class DrawFunction>
+void rasterizeEdges(const std::vector<sofa::type::fixed_array<sofa::type::Vec<3,real>,2> >& edges, const sofa::type::Vec<3,int>& dim, DrawFunction draw, sofa::simulation::TaskScheduler* taskScheduler=nullptr)
+{
+    typedef sofa::type::Vec<3,real> Coord;
+    typedef sofa::type::Vec<3,int> iCoord;
+    const Coord halfSize((real)0.5,(real)0.5,(real)0.5);
+
+    rasterizeBySlabs<real>(edges.size(), dim,
+        [&edges](const unsigned int i, Coord& pmin, Coord& pmax)
+        {
+            for (unsigned int j=0; j<3; j++)
+            {
+                pmin[j] = std::min(edges[i][0][j], edges[i][1][j]);
+                pmax[j] = std::max(edges[i][0][j], edges[i][1][j]);
+            }
+        },
+        [&](const unsigned int i, const iCoord& vmin, const iCoord& vmax)
+        {
+            const Coord& p0=edges[i][0];
+            const Coord e=edges[i][1]-p0;
+            const real l2=e.norm2();
+
+            for (int z=vmin[2]; z<=vmax[2]; z++) for (int y=vmin[1]; y<=vmax[1]; y++) for (int x=vmin[0]; x<=vmax[0]; x++)
+            {
+                const Coord c(x,y,z);
+                if(!segmentBoxOverlap(c,halfSize,p0,edges[i][1])) continue;
+                const real u = l2>0 ? std::clamp(sofa::type::dot(c-p0,e)/l2,(real)0,(real)1) : (real)0.5;
+                draw(x,y,z,i,u);
+            }
+        },
+        taskScheduler);
+}
+
+
 /**
 * Initialize null distances and voronoi value (=point index) from a position in image coordinates
 * and returns list of seed (=trial) points to be used in dijkstra or fast marching algorithms
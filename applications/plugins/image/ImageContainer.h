@@ -99,6 +99,24 @@ struct ImageContainerSpecialization< defaulttype::Image<T> >
                 }
     }
 
+    /// move the loaded image to an out-of-core tiled storage
+    static void toTiles( ImageContainerT* container )
+    {
+        typename ImageContainerT::waImage wimage(container->image);
+        if( wimage->isEmpty() || wimage->isTiled() ) return;
+
+        const std::size_t cacheSize = std::size_t(container->cacheSize.getValue()) << 20;
+        auto tiles = defaulttype::TiledImageStorage<T>::fromCImgList( wimage->getCImgList(), container->brickSize.getValue(), cacheSize, container->tileFile.getValue() );
+        if( !tiles )
+        {
+            msg_warning(container) << "The image cannot be stored out-of-core: it is kept in memory";
+            return;
+        }
+        wimage->setTiles( std::move(tiles) );
+        msg_info(container) << "Image stored out-of-core in " << wimage->getTiles()->getFilename()
+                            << " (" << wimage->getTiles()->getNbBricks() << " bricks of " << container->brickSize.getValue() << "^3 voxels)";
+    }
+
     static bool load( ImageContainerT* container, std::string fname )
     {
         typedef typename ImageContainerT::Real Real;
@@ -341,6 +359,15 @@ public:
     */
     Data<unsigned int> nFrames; ///< The number of frames of the sequence to be loaded. Default is the entire sequence.
 
+    /**
+    * If true, the loaded image is moved to a file split in bricks, read on demand through a cache of bounded size.
+    * The image is loaded in memory again only by the components that access all its voxels.
+    */
+    Data<bool> outOfCore; ///< store the image out-of-core, in bricks
+    Data<unsigned int> brickSize; ///< number of voxels of the bricks along each axis
+    Data<unsigned int> cacheSize; ///< maximum size of the bricks kept in memory (in MB)
+    Data<std::string> tileFile; ///< file where the bricks are stored, removed with the image. It must not exist. A temporary file is used if empty.
+
     ImageContainer() : Inherited()
       , image(initData(&image,ImageTypes(),"image","image"))
       , transform(initData(&transform, "transform" , "12-param vector for trans, rot, scale, ..."))
@@ -348,6 +375,10 @@ public:
       , drawBB(initData(&drawBB,false,"drawBB","draw bounding box"))
       , sequence(initData(&sequence, false, "sequence", "load a sequence of images"))
       , nFrames (initData(&nFrames, "numberOfFrames", "The number of frames of the sequence to be loaded. Default is the entire sequence."))
+      , outOfCore(initData(&outOfCore, false, "outOfCore", "store the image out-of-core, in bricks read on demand"))
+      , brickSize(initData(&brickSize, 64u, "brickSize", "number of voxels of the bricks along each axis (out-of-core storage)"))
+      , cacheSize(initData(&cacheSize, 256u, "cacheSize", "maximum size of the bricks kept in memory, in MB (out-of-core storage)"))
+      , tileFile(initData(&tileFile, std::string(), "tileFile", "file where the bricks are stored, removed with the image. An existing file is not overwritten. A temporary file is used if empty (out-of-core storage)"))
       , transformIsSet (false)
     {
         this->addAlias(&image, "inputImage");
@@ -468,10 +499,10 @@ protected:
         }
         fname=sofa::helper::system::DataRepository.getFile(fname);
 
-        if(sequence.getValue())
-            return loadSequence(fname);
-        else
-            return load(fname);
+        const bool loaded = sequence.getValue() ? loadSequence(fname) : load(fname);
+        if(loaded && outOfCore.getValue())
+            ImageContainerSpecialization<ImageTypes>::toTiles( this );
+        return loaded;
     }
 
     bool load(std::string fname)
@@ -492,7 +523,12 @@ protected:
     void handleEvent(sofa::core::objectmodel::Event *event) override
     {
         if (simulation::AnimateEndEvent::checkEventType(event))
+        {
             loadCamera();
+            // the copies in memory of a tiled image read during the time step are not kept
+            raImage rimage(this->image);
+            if(rimage->isTiled()) rimage->releaseCImgList();
+        }
     }
 
 
@@ -71,7 +71,8 @@ struct ImageCoordValuesFromPositionsSpecialization<defaulttype::Image<T>>
 
         typename ImageCoordValuesFromPositionsT::raImage in(This.image);
         if(in->isEmpty()) return;
-        const cimg_library::CImg<T>& img = in->getCImg(This.time);
+        const auto scopedImg = in->getScopedCImg(This.time);
+        const cimg_library::CImg<T>& img = *scopedImg;
 
         typename ImageCoordValuesFromPositionsT::waValues val(This.values);
         Coord outval (This.outValue.getValue(),This.outValue.getValue(),This.outValue.getValue());
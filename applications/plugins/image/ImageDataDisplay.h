@@ -100,7 +100,8 @@ protected:
         dim[InImageTypes::DIMENSION_S] = dat.size()?dat[0].size():1;
         out->setDimensions(dim);
 
-        const cimg_library::CImg<Ti>& inImg=in->getCImg();
+        const auto scopedInImg=in->getScopedCImg();
+        const cimg_library::CImg<Ti>& inImg=*scopedInImg;
         cimg_library::CImg<To>& outImg=out->getCImg();
         outImg.fill(0);
 
@@ -99,7 +99,7 @@ struct ImageExporterSpecialization<defaulttype::Image<T>>
             double offsetT=(double)rtransform->getOffsetT();
             double scaleT=(double)rtransform->getScaleT();
             int isPerspective=rtransform->isPerspective();
-            cimg_library::save_metaimage<T,double>(rimage->getCImgList(),fname.c_str(),scale,translation,affine,offsetT,scaleT,isPerspective);
+            cimg_library::save_metaimage<T,double>(*rimage->getScopedCImgList(),fname.c_str(),scale,translation,affine,offsetT,scaleT,isPerspective);
         }
         else if(fname.find(".nfo")!=std::string::npos || fname.find(".NFO")!=std::string::npos || fname.find(".Nfo")!=std::string::npos)
         {
@@ -112,18 +112,18 @@ struct ImageExporterSpecialization<defaulttype::Image<T>>
             fileStream << "voxelSize: " << rtransform->getScale()[0] << " " << rtransform->getScale()[1]<< " " << rtransform->getScale()[2]<< std::endl;
             fileStream.close();
             std::string imgName (fname);  imgName.replace(imgName.find_last_of('.')+1,imgName.size(),"raw");
-            cimg_library::CImg<unsigned char> ucimg = rimage->getCImg(exporter.m_time);
+            cimg_library::CImg<unsigned char> ucimg = *rimage->getScopedCImg(exporter.m_time);
             ucimg.save_raw(imgName.c_str());
         }
         else if	(fname.find(".cimg")!=std::string::npos || fname.find(".CIMG")!=std::string::npos || fname.find(".Cimg")!=std::string::npos || fname.find(".CImg")!=std::string::npos)
-            rimage->getCImgList().save_cimg(fname.c_str());
+            rimage->getScopedCImgList()->save_cimg(fname.c_str());
         else if(fname.find(".avi")!=std::string::npos || fname.find(".mov")!=std::string::npos || fname.find(".asf")!=std::string::npos || fname.find(".divx")!=std::string::npos || fname.find(".flv")!=std::string::npos || fname.find(".mpg")!=std::string::npos || fname.find(".m1v")!=std::string::npos || fname.find(".m2v")!=std::string::npos || fname.find(".m4v")!=std::string::npos || fname.find(".mjp")!=std::string::npos || fname.find(".mkv")!=std::string::npos || fname.find(".mpe")!=std::string::npos || fname.find(".movie")!=std::string::npos || fname.find(".ogm")!=std::string::npos || fname.find(".ogg")!=std::string::npos || fname.find(".qt")!=std::string::npos || fname.find(".rm")!=std::string::npos || fname.find(".vob")!=std::string::npos || fname.find(".wmv")!=std::string::npos || fname.find(".xvid")!=std::string::npos || fname.find(".mpeg")!=std::string::npos )
-            rimage->getCImgList().save_ffmpeg_external(fname.c_str());
+            rimage->getScopedCImgList()->save_ffmpeg_external(fname.c_str());
         else if (fname.find(".hdr")!=std::string::npos || fname.find(".nii")!=std::string::npos)
         {
             float voxsize[3];
             for(unsigned int i=0; i<3; i++) voxsize[i]=(float)rtransform->getScale()[i];
-            rimage->getCImg(exporter.m_time).save_analyze(fname.c_str(),voxsize);
+            rimage->getScopedCImg(exporter.m_time)->save_analyze(fname.c_str(),voxsize);
 
             //once CImg wrote the data, we complete them with a header containing spatial transformation
             typedef struct
@@ -196,11 +196,11 @@ struct ImageExporterSpecialization<defaulttype::Image<T>>
             float translation[3];
             for(unsigned int i=0; i<3; i++) voxsize[i]=(float)rtransform->getScale()[i];
             for(unsigned int i=0; i<3; i++) translation[i]=(float)rtransform->getTranslation()[i];
-            save_inr(rimage->getCImg(exporter.m_time),NULL,fname.c_str(),voxsize,translation);
+            save_inr(*rimage->getScopedCImg(exporter.m_time),NULL,fname.c_str(),voxsize,translation);
         }
-        else rimage->getCImg(exporter.m_time).save(fname.c_str());
+        else rimage->getScopedCImg(exporter.m_time)->save(fname.c_str());
 
-        msg_info(&exporter) << "Saved image " << fname <<" ("<< rimage->getCImg(exporter.m_time).pixel_type() <<")" ;
+        msg_info(&exporter) << "Saved image " << fname <<" ("<< cimg_library::CImg<T>::pixel_type() <<")" ;
 
         return true;
     }
@@ -188,7 +188,9 @@ protected:
 
 		if(in->isEmpty()) return;
 
-        const cimg_library::CImgList<Ti>& inimg = in->getCImgList();
+        // a tiled input is loaded in memory only during the update
+        const typename InImageTypes::ScopedCImgList scopedInImg = in->getScopedCImgList();
+        const cimg_library::CImgList<Ti>& inimg = *scopedInImg;
         cimg_library::CImgList<To>& img = out->getCImgList();
         if(updateImage) img.assign(inimg);	// copy
         if(updateTransform) outT->operator=(inT);	// copy
@@ -115,7 +115,11 @@ protected:
 
         if(in1->isEmpty() || in2->isEmpty()) return;
 
-        const cimg_library::CImgList<T>& inimg1 = in1->getCImgList() , inimg2 = in2->getCImgList();
+        if(in1->isTiled() && in2->isTiled() && streamTiles(*in1->getTiles(),*in2->getTiles(),*out)) return;
+
+        // the tiled inputs are loaded in memory only during the operation
+        const typename ImageTypes::ScopedCImgList scopedImg1 = in1->getScopedCImgList() , scopedImg2 = in2->getScopedCImgList();
+        const cimg_library::CImgList<T>& inimg1 = *scopedImg1 , &inimg2 = *scopedImg2;
         cimg_library::CImgList<T>& img = out->getCImgList();
         img.assign(inimg1);	// copy
 
@@ -161,6 +165,38 @@ protected:
         }
     }
 
+    /// voxel-wise operations on out-of-core images, processed brick by brick without loading the images in memory
+    /// @return false if the operation cannot be streamed
+    bool streamTiles(const defaulttype::TiledImageStorage<T>& in1, const defaulttype::TiledImageStorage<T>& in2, ImageTypes& out)
+    {
+        typedef defaulttype::TiledImageStorage<T> TiledStorage;
+        typedef typename TiledStorage::BrickCoord BrickCoord;
+
+        const unsigned int op = this->operation.getValue().getSelectedId();
+        if(op!=ADDITION && op!=SUBTRACTION && op!=MULTIPLICATION && op!=DIVISION) return false;
+        if(in1.getDimensions()!=in2.getDimensions() || in1.getBrickSize()!=in2.getBrickSize()) return false;
+
+        auto storage = std::make_shared<TiledStorage>(in1.getDimensions(), in1.getBrickSize(), in1.getCacheSizeInBytes());
+        if(!storage->isValid()) return false;
+
+        in1.forEachBrick([&](const BrickCoord& b, unsigned int t, const cimg_library::CImg<T>& brick1)
+        {
+            cimg_library::CImg<T> brick(brick1);
+            const auto brick2 = in2.getBrick(b,t);
+            switch(op)
+            {
+            case ADDITION:            brick+=*brick2;            break;
+            case SUBTRACTION:         brick-=*brick2;            break;
+            case MULTIPLICATION:      brick.mul(*brick2);        break;
+            case DIVISION:            brick.div(*brick2);        break;
+            default:            break;
+            }
+            storage->setBrick(b,t,brick);
+        });
+        out.setTiles(storage);
+        return true;
+    }
+
 };
 
 
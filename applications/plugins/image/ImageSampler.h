@@ -35,6 +35,8 @@
 
 #include <sofa/type/Vec.h>
 #include <sofa/helper/OptionsGroup.h>
+#include <sofa/simulation/MainTaskSchedulerFactory.h>
+#include <sofa/simulation/TaskScheduler.h>
 
 #if IMAGE_HAVE_SOFA_GL == 1
 #include <sofa/gl/gl.h>
@@ -46,6 +48,7 @@
 #define FASTMARCHING 0
 #define DIJKSTRA 1
 #define PARALLELMARCHING 2
+#define EUCLIDEAN 3
 
 namespace sofa
 {
@@ -92,7 +95,8 @@ struct ImageSamplerSpecialization<defaulttype::Image<T>>
         // get transform and image at time t
         typename ImageSamplerT::raImage in(sampler->image);
         typename ImageSamplerT::raTransform inT(sampler->transform);
-        const cimg_library::CImg<T>& inimg = in->getCImg(sampler->time);
+        const auto scopedInimg = in->getScopedCImg(sampler->time);
+        const cimg_library::CImg<T>& inimg = *scopedInimg;
 
         // data access
         typename ImageSamplerT::waPositions pos(sampler->position);       pos.clear();
@@ -152,6 +156,34 @@ struct ImageSamplerSpecialization<defaulttype::Image<T>>
     }
 
 
+    /// update distances and voronoi regions from the seeds in trial
+    template<typename Real>
+    static void computeDistances( ImageSamplerT* sampler, const unsigned int method, std::set<std::pair<Real,sofa::type::Vec<3,int> > >& trial, cimg_library::CImg<Real>& dist, cimg_library::CImg<unsigned int>& voronoi,
+                                  const cimg_library::CImg<T>* biasFactor, const unsigned int pmmIter, const SReal pmmTol )
+    {
+        const sofa::type::Vec<3,Real>& voxelSize = sampler->transform.getValue().getScale();
+        switch(method)
+        {
+        case FASTMARCHING : fastMarching<Real,T>(trial,dist, voronoi, voxelSize,biasFactor ); break;
+        case DIJKSTRA : dijkstra<Real,T>(trial,dist, voronoi, voxelSize, biasFactor); break;
+        case PARALLELMARCHING : parallelMarching<Real,T>(dist, voronoi, voxelSize, pmmIter, pmmTol, biasFactor); break;
+        case EUCLIDEAN :
+            if(biasFactor)
+            {
+                msg_warning(sampler) << "Biased distances are not supported by the euclidean distance transform: using fast marching";
+                fastMarching<Real,T>(trial,dist, voronoi, voxelSize,biasFactor );
+            }
+            else
+            {
+                // distances are recomputed from all the seeds (voxels with null distances)
+                trial.clear();
+                euclideanDistanceTransform<Real>(dist, voronoi, voxelSize, sampler->parallel.getValue() ? simulation::MainTaskSchedulerFactory::createInRegistry() : nullptr);
+            }
+            break;
+        default : msg_error(sampler) << "Unknown Distance Field Computation Method" ; break;
+        };
+    }
+
     static void uniformSampling( ImageSamplerT* sampler,const unsigned int nb=0,  const bool bias=false, const unsigned int lloydIt=100,const unsigned int method=FASTMARCHING, const unsigned int pmmIter = std::numeric_limits<unsigned int>::max(), const SReal pmmTol = 10 )
     {
         typedef typename ImageSamplerT::Real Real;
@@ -164,7 +196,8 @@ struct ImageSamplerSpecialization<defaulttype::Image<T>>
         // get transform and image at time t
         typename ImageSamplerT::raImage in(sampler->image);
         typename ImageSamplerT::raTransform inT(sampler->transform);
-        const cimg_library::CImg<T>& inimg = in->getCImg(sampler->time);
+        const auto scopedInimg = in->getScopedCImg(sampler->time);
+        const cimg_library::CImg<T>& inimg = *scopedInimg;
         const cimg_library::CImg<T>* biasFactor=bias?&inimg:NULL;
 
         // data access
@@ -200,13 +233,7 @@ struct ImageSamplerSpecialization<defaulttype::Image<T>>
         }
         if(fpos.size())
         {
-            switch(method)
-            {
-            case FASTMARCHING : fastMarching<Real,T>(trial,dist, voronoi, sampler->transform.getValue().getScale(),biasFactor ); break;
-            case DIJKSTRA : dijkstra<Real,T>(trial,dist, voronoi, sampler->transform.getValue().getScale(), biasFactor); break;
-            case PARALLELMARCHING : parallelMarching<Real,T>(dist, voronoi, sampler->transform.getValue().getScale(), pmmIter, pmmTol, biasFactor); break;
-            default : msg_error(sampler) << "Unknown Distance Field Computation Method" ; break;
-            };
+            computeDistances(sampler,method,trial,dist,voronoi,biasFactor,pmmIter,pmmTol);
         }
 
         // farthest point sampling using geodesic distances
@@ -221,13 +248,7 @@ struct ImageSamplerSpecialization<defaulttype::Image<T>>
                 pos_voronoiIndex.push_back(fpos_VoxelIndex.size()+pos_VoxelIndex.size()+1);
                 pos_VoxelIndex.push_back(pmax);
                 AddSeedPoint<Real>(trial,dist,voronoi, pos_VoxelIndex.back(),pos_voronoiIndex.back());
-                switch(method)
-                {
-                case FASTMARCHING : fastMarching<Real,T>(trial,dist, voronoi, sampler->transform.getValue().getScale(),biasFactor ); break;
-                case DIJKSTRA : dijkstra<Real,T>(trial,dist, voronoi, sampler->transform.getValue().getScale(), biasFactor); break;
-                case PARALLELMARCHING : parallelMarching<Real,T>(dist, voronoi, sampler->transform.getValue().getScale(), pmmIter, pmmTol, biasFactor); break;
-                default : msg_error(sampler) << "Unknown Distance Field Computation Method" ; break;
-                };
+                computeDistances(sampler,method,trial,dist,voronoi,biasFactor,pmmIter,pmmTol);
             }
             else break;
         }
@@ -238,20 +259,14 @@ struct ImageSamplerSpecialization<defaulttype::Image<T>>
 
         while(!converged)
         {
-            if(Lloyd<Real>(pos_VoxelIndex,pos_voronoiIndex,voronoi)) // one lloyd iteration
+            if(Lloyd<Real>(pos_VoxelIndex,pos_voronoiIndex,voronoi,sampler->parallel.getValue() ? simulation::MainTaskSchedulerFactory::createInRegistry() : nullptr)) // one lloyd iteration
             {
                 // recompute distance from scratch
                 cimg_foroff(dist,off) if(dist[off]!=-1) dist[off]=cimg_library::cimg::type<Real>::max();
                 for(unsigned int i=0; i<fpos_voronoiIndex.size(); i++) AddSeedPoint<Real>(trial,dist,voronoi, fpos_VoxelIndex[i], fpos_voronoiIndex[i]);
                 for(unsigned int i=0; i<pos_voronoiIndex.size(); i++) AddSeedPoint<Real>(trial,dist,voronoi, pos_VoxelIndex[i], pos_voronoiIndex[i]);
 
-                switch(method)
-                {
-                case FASTMARCHING : fastMarching<Real,T>(trial,dist, voronoi, sampler->transform.getValue().getScale(),biasFactor ); break;
-                case DIJKSTRA : dijkstra<Real,T>(trial,dist, voronoi, sampler->transform.getValue().getScale(), biasFactor); break;
-                case PARALLELMARCHING : parallelMarching<Real,T>(dist, voronoi, sampler->transform.getValue().getScale(), pmmIter, pmmTol, biasFactor); break;
-                default : msg_error(sampler) << "Unknown Distance Field Computation Method" ; break;
-                };
+                computeDistances(sampler,method,trial,dist,voronoi,biasFactor,pmmIter,pmmTol);
                 it++; if(it>=lloydIt) converged=true;
             }
             else converged=true;
@@ -279,7 +294,8 @@ struct ImageSamplerSpecialization<defaulttype::Image<T>>
         // get transform and image at time t
         typename ImageSamplerT::raImage in(sampler->image);
         typename ImageSamplerT::raTransform inT(sampler->transform);
-        const cimg_library::CImg<T>& inimg = in->getCImg(sampler->time);
+        const auto scopedInimg = in->getScopedCImg(sampler->time);
+        const cimg_library::CImg<T>& inimg = *scopedInimg;
         const cimg_library::CImg<T>* biasFactor=bias?&inimg:NULL;
 
         // data access
@@ -315,13 +331,7 @@ struct ImageSamplerSpecialization<defaulttype::Image<T>>
         }
         if(fpos.size())
         {
-            switch(method)
-            {
-            case FASTMARCHING : fastMarching<Real,T>(trial,dist, voronoi, sampler->transform.getValue().getScale(),biasFactor ); break;
-            case DIJKSTRA : dijkstra<Real,T>(trial,dist, voronoi, sampler->transform.getValue().getScale(), biasFactor); break;
-            case PARALLELMARCHING : parallelMarching<Real,T>(dist, voronoi, sampler->transform.getValue().getScale(), pmmIter, pmmTol, biasFactor); break;
-            default : msg_error(sampler) << "Unknown Distance Field Computation Method" ; break;
-            };
+            computeDistances(sampler,method,trial,dist,voronoi,biasFactor,pmmIter,pmmTol);
         }
 
         // new points
@@ -345,13 +355,7 @@ struct ImageSamplerSpecialization<defaulttype::Image<T>>
                 newpos_voronoiIndex.push_back(fpos_VoxelIndex.size()+pos_VoxelIndex.size()+newpos_VoxelIndex.size()+1);
                 newpos_VoxelIndex.push_back(pmax);
                 AddSeedPoint<Real>(trial,dist,voronoi, newpos_VoxelIndex.back(),newpos_voronoiIndex.back());
-                switch(method)
-                {
-                case FASTMARCHING : fastMarching<Real,T>(trial,dist, voronoi, sampler->transform.getValue().getScale(),biasFactor ); break;
-                case DIJKSTRA : dijkstra<Real,T>(trial,dist, voronoi, sampler->transform.getValue().getScale(), biasFactor); break;
-                case PARALLELMARCHING : parallelMarching<Real,T>(dist, voronoi, sampler->transform.getValue().getScale(), pmmIter, pmmTol, biasFactor); break;
-                default : msg_error(sampler) << "Unknown Distance Field Computation Method" ; break;
-                };
+                computeDistances(sampler,method,trial,dist,voronoi,biasFactor,pmmIter,pmmTol);
             }
 
             // lloyd iterations for the N points
@@ -360,20 +364,14 @@ struct ImageSamplerSpecialization<defaulttype::Image<T>>
 
             while(!converged)
             {
-                if(Lloyd<Real>(newpos_VoxelIndex,newpos_voronoiIndex,voronoi))
+                if(Lloyd<Real>(newpos_VoxelIndex,newpos_voronoiIndex,voronoi,sampler->parallel.getValue() ? simulation::MainTaskSchedulerFactory::createInRegistry() : nullptr))
                 {
                     // recompute distance from scratch
                     cimg_foroff(dist,off) if(dist[off]!=-1) dist[off]=cimg_library::cimg::type<Real>::max();
                     for(unsigned int i=0; i<fpos_VoxelIndex.size(); i++) AddSeedPoint<Real>(trial,dist,voronoi, fpos_VoxelIndex[i], fpos_voronoiIndex[i]);
                     for(unsigned int i=0; i<pos_VoxelIndex.size(); i++)  AddSeedPoint<Real>(trial,dist,voronoi, pos_VoxelIndex[i], pos_voronoiIndex[i]);
                     for(unsigned int i=0; i<newpos_VoxelIndex.size(); i++) AddSeedPoint<Real>(trial,dist,voronoi, newpos_VoxelIndex[i], newpos_voronoiIndex[i]);
-                    switch(method)
-                    {
-                    case FASTMARCHING : fastMarching<Real,T>(trial,dist, voronoi, sampler->transform.getValue().getScale(),biasFactor ); break;
-                    case DIJKSTRA : dijkstra<Real,T>(trial,dist, voronoi, sampler->transform.getValue().getScale(), biasFactor); break;
-                    case PARALLELMARCHING : parallelMarching<Real,T>(dist, voronoi, sampler->transform.getValue().getScale(), pmmIter, pmmTol, biasFactor); break;
-                    default : msg_error(sampler) << "Unknown Distance Field Computation Method" ; break;
-                    };
+                    computeDistances(sampler,method,trial,dist,voronoi,biasFactor,pmmIter,pmmTol);
                     it++; if(it>=lloydIt) converged=true;
                 }
                 else converged=true;
@@ -463,6 +461,7 @@ public:
     Data<helper::OptionsGroup> method; ///< method (param)
     Data< bool > computeRecursive; ///< if true: insert nodes recursively and build the graph
     Data< ParamTypes > param; ///< Parameters
+    Data< bool > parallel; ///< use the task scheduler for Lloyd relaxation and euclidean distance transforms
     /**@}*/
 
     //@name sample data (points+connectivity)
@@ -516,6 +515,7 @@ public:
       , method ( initData ( &method,"method","method (param)" ) )
       , computeRecursive(initData(&computeRecursive,false,"computeRecursive","if true: insert nodes recursively and build the graph"))
       , param ( initData ( &param,"param","Parameters" ) )
+      , parallel(initData(&parallel,false,"parallel","use the task scheduler for Lloyd relaxation and euclidean distance transforms"))
       , position(initData(&position,SeqPositions(),"position","output positions"))
       , fixedPosition(initData(&fixedPosition,SeqPositions(),"fixedPosition","user defined sample positions"))
       , edges(initData(&edges,SeqEdges(),"edges","edges connecting neighboring nodes"))
@@ -536,7 +536,7 @@ public:
         f_listening.setValue(true);
 
         helper::OptionsGroup methodOptions{"0 - Regular sampling (at voxel center(0) or corners (1)) "
-                                          ,"1 - Uniform sampling using Fast Marching and Lloyd relaxation (nbSamples | bias distances=false | nbiterations=100  | FastMarching(0)/Dijkstra(1)/ParallelMarching(2)=1 | PMM max iter | PMM tolerance)"
+                                          ,"1 - Uniform sampling using Fast Marching and Lloyd relaxation (nbSamples | bias distances=false | nbiterations=100  | FastMarching(0)/Dijkstra(1)/ParallelMarching(2)/Euclidean(3)=1 | PMM max iter | PMM tolerance)"
                                           };
         methodOptions.setSelectedItem(REGULAR);
         method.setValue(methodOptions);
@@ -546,6 +546,16 @@ public:
 
     void init() override
     {
+        if(parallel.getValue())
+        {
+            simulation::TaskScheduler* taskScheduler = simulation::MainTaskSchedulerFactory::createInRegistry();
+            if(taskScheduler->getThreadCount() < 1)
+            {
+                taskScheduler->init(0);
+                msg_info() << "Task scheduler initialized on " << taskScheduler->getThreadCount() << " threads";
+            }
+        }
+
         addInput(&image);
         addInput(&transform);
         addInput(&fixedPosition);
@@ -122,7 +122,8 @@ protected:
         raTransform inT(this->transform);
         raImage in(this->image);
         if(in->isEmpty()) return;
-        const cimg_library::CImg<T>& img = in->getCImg(this->time);
+        const auto scopedImg = in->getScopedCImg(this->time);
+        const cimg_library::CImg<T>& img = *scopedImg;
 
         Real d = d_density.getValue();
         bool mult = d_mult.getValue();
@@ -103,7 +103,7 @@ public:
     void update()
     {
         if(!img) return;
-        if(!img->getCImgList().size()) return;
+        if(img->isEmpty()) return;
 
         T vmin,vmax;
         histogram = img->get_histogram(vmin,vmax,dimx,mergeChannels);
@@ -231,7 +231,7 @@ public:
     void setTime(const Real t, bool repeat=true)
     {
         if(!this->img )  return;
-        unsigned int size = this->img->getCImgList().size();
+        unsigned int size = this->img->getDimensions()[4];
         if(!t || !this->transform) return;
         Real t2=this->transform->toImage(t) ;
         if(repeat) t2-=(Real)((int)((int)t2/size)*size);
@@ -261,18 +261,17 @@ public:
     cimg_library::CImg<T> get_point(const Coord& p) const
     {
         if(!this->img) return cimg_library::CImg<T>();
-        if(!this->img->getCImgList().size()) return cimg_library::CImg<T>();
+        if(this->img->isEmpty()) return cimg_library::CImg<T>();
         if(this->time>=this->img->getDimensions()[4]) return cimg_library::CImg<T>();
         for(unsigned int i=0; i<3; i++) if(p[i]<0 || p[i]>this->img->getDimensions()[i]-1) return cimg_library::CImg<T>();
-        cimg_library::CImg<T> ret(1,1,1,this->img->getDimensions()[3]);
-        cimg_forC(ret,c) ret(0,0,0,c)=this->img->getCImg(this->time).atXYZC((unsigned int)helper::round(p[0]),(unsigned int)helper::round(p[1]),(unsigned int)helper::round(p[2]),c);
-        return ret;
+        const unsigned int x=(unsigned int)helper::round(p[0]), y=(unsigned int)helper::round(p[1]), z=(unsigned int)helper::round(p[2]);
+        return this->img->get_crop(x,y,z,x,y,z,this->time);
     }
     // returns slice image
     cimg_library::CImg<T> get_slice(const unsigned int index,const unsigned int axis,const type::Mat<2,3,unsigned int>& roi) const
     {
         if(!this->img) return cimg_library::CImg<T>();
-        if(!this->img->getCImgList().size()) return cimg_library::CImg<T>();
+        if(this->img->isEmpty()) return cimg_library::CImg<T>();
         if(index>=this->img->getDimensions()[axis] || this->time>=this->img->getDimensions()[4]) return cimg_library::CImg<T>();			// discard out of volume planes
         if((this->img->getDimensions()[0]==1 && axis!=0) || (this->img->getDimensions()[1]==1 && axis!=1) || (this->img->getDimensions()[2]==1 && axis!=2)) return cimg_library::CImg<T>();  // discard unit width/height images
         return this->img->get_plane(index,axis,roi,this->time,this->mergeChannels);
@@ -288,7 +287,7 @@ public:
     cimg_library::CImg<unsigned char> get_slicedModels(const unsigned int index,const unsigned int axis,const type::Mat<2,3,unsigned int>& roi) const
     {
         if(!this->img) return cimg_library::CImg<unsigned char>();
-        if(!this->img->getCImgList().size()) return cimg_library::CImg<unsigned char>();
+        if(this->img->isEmpty()) return cimg_library::CImg<unsigned char>();
         if(index>=this->img->getDimensions()[axis] || this->time>=this->img->getDimensions()[4]) return cimg_library::CImg<unsigned char>();			// discard out of volume planes
         if((this->img->getDimensions()[0]==1 && axis!=0) || (this->img->getDimensions()[1]==1 && axis!=1) || (this->img->getDimensions()[2]==1 && axis!=2)) return cimg_library::CImg<unsigned char>();  // discard unit width/height images
 
@@ -71,7 +71,8 @@ struct ImageValuesFromPositionsSpecialization<defaulttype::Image<T>>
 
         typename ImageValuesFromPositionsT::raImage in(This.image);
         if(in->isEmpty()) return;
-        const cimg_library::CImg<T>& img = in->getCImg(This.time);
+        const auto scopedImg = in->getScopedCImg(This.time);
+        const cimg_library::CImg<T>& img = *scopedImg;
 
         typename ImageValuesFromPositionsT::waValues val(This.values);
         Real outval=This.outValue.getValue();
@@ -477,7 +477,7 @@ protected:
                     for(ip[y] = 0; ip[y] < dims[y]; ip[y] += sampling[y])
                     {
                         Coord base = rtransform->fromImage(ip);
-                        cimg_library::CImg<T> vect = rimage->getCImg(rplane->getTime()).get_vector_at(ip[0],ip[1],ip[2]);
+                        cimg_library::CImg<T> vect = rimage->get_crop(ip[0],ip[1],ip[2],ip[0],ip[1],ip[2],rplane->getTime()).get_vector_at(0,0,0);
                         Coord relativeVec((double)vect[0], (double)vect[1], (double)vect[2]);
                         vparams->drawTool()->drawArrow(base,base+relativeVec*size,size*relativeVec.norm()/10,colour);
                     }
@@ -515,7 +515,7 @@ protected:
 
                         Coord base = rtransform->fromImage(ip);
 
-                        cimg_library::CImg<T> vector = rimage->getCImg(rplane->getTime()).get_vector_at(ip[0], ip[1], ip[2]);
+                        cimg_library::CImg<T> vector = rimage->get_crop(ip[0], ip[1], ip[2], ip[0], ip[1], ip[2], rplane->getTime()).get_vector_at(0, 0, 0);
 
                         //CImg::get_tensor_at() assumes a different tensor input than we expect.
                         // That is why we are generating the tensor manually from the vector instead.
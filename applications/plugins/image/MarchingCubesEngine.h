@@ -121,7 +121,8 @@ protected:
 		raTransform inT(this->transform);
 
         // get image at time t
-        const cimg_library::CImg<T>& img = in->getCImg(this->time);
+        const auto scopedImg = in->getScopedCImg(this->time);
+        const cimg_library::CImg<T>& img = *scopedImg;
 
         // get subdivision
         type::Vec<3,int> r((int)this->subdiv.getValue()[0],(int)this->subdiv.getValue()[1],(int)this->subdiv.getValue()[2]);
@@ -220,6 +220,9 @@ protected:
 
         cimg_library::CImgList<T>& img = out->getCImgList();
 
+        // the tiled inputs are loaded in memory only during the update
+        std::vector<typename ImageTypes::ScopedCImgList> inImgs(nb);
+        for(unsigned int j=0; j<nb; j++) inImgs[j] = raImage(this->inputImages[j])->getScopedCImgList();
 
 #ifdef _OPENMP
         #pragma omp parallel for
@@ -233,7 +236,7 @@ protected:
             for(unsigned int j=0; j<nb; j++) // store values at p from input images
             {
                 raImage in(this->inputImages[j]);
-                const cimg_library::CImgList<T>& inImg = in->getCImgList();
+                const cimg_library::CImgList<T>& inImg = *inImgs[j];
                 const imCoord indim=in->getDimensions();
 
                 raTransform inT(this->inputTransforms[j]);
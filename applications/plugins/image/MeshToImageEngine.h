@@ -37,6 +37,9 @@
 #include <sofa/type/Quat.h>
 #include <Eigen/SVD>
 #include <sofa/core/objectmodel/vectorData.h>
+#include <sofa/simulation/MainTaskSchedulerFactory.h>
+#include <sofa/simulation/TaskScheduler.h>
+#include "ImageAlgorithms.h"
 
 #ifdef _OPENMP
 #include <omp.h>
@@ -72,6 +75,8 @@ public:
     Data< bool > rotateImage; ///< orient the image bounding box according to the mesh (OBB)
     Data< unsigned int > padSize; ///< size of border in number of voxels
     Data< unsigned int > subdiv; ///< number of subdivisions for face rasterization (if needed, increase to avoid holes)
+    Data< bool > conservativeRasterization; ///< rasterize all the voxels intersected by the faces and edges (no hole, subdiv is not used)
+    Data< bool > parallel; ///< use the task scheduler for conservative rasterization
 
     typedef _ImageTypes ImageTypes;
     typedef typename ImageTypes::T T;
@@ -131,6 +136,8 @@ public:
       , rotateImage(initData(&rotateImage,false,"rotateImage","orient the image bounding box according to the mesh (OBB)"))
       , padSize(initData(&padSize,(unsigned int)(0),"padSize","size of border in number of voxels"))
       , subdiv(initData(&subdiv,(unsigned int)(4),"subdiv","number of subdivisions for face rasterization (if needed, increase to avoid holes)"))
+      , conservativeRasterization(initData(&conservativeRasterization,false,"conservativeRasterization","rasterize all the voxels intersected by the faces and edges (no hole, subdiv is not used)"))
+      , parallel(initData(&parallel,false,"parallel","use the task scheduler for conservative rasterization"))
       , image(initData(&image,ImageTypes(),"image",""))
       , transform(initData(&transform,TransformType(),"transform",""))
       , vf_positions(this, "position", "input positions for mesh ", core::objectmodel::DataEngineDataType::DataEngineInput)
@@ -171,6 +178,16 @@ public:
 
     void init() override
     {
+        if(parallel.getValue())
+        {
+            simulation::TaskScheduler* taskScheduler = simulation::MainTaskSchedulerFactory::createInRegistry();
+            if(taskScheduler->getThreadCount() < 1)
+            {
+                taskScheduler->init(0);
+                msg_info() << "Task scheduler initialized on " << taskScheduler->getThreadCount() << " threads";
+            }
+        }
+
         // backward compatibility (if InsideValue is not set: use first value)
         for( size_t meshId=0; meshId<vf_InsideValues.size() ; ++meshId )
             if(!this->vf_InsideValues[meshId]->isSet() && this->vf_values[meshId]->isSet())
@@ -426,13 +443,20 @@ protected:
 
         /// colors definition
         const T FillColor = (T)getValue(meshId,0);
-        const T InsideColor = (T)this->vf_InsideValues[meshId]->getValue();
 
         /// draw surface
         cimg_library::CImg<bool> mask;
         mask.assign( im.width(), im.height(), im.depth(), 1 );
         mask.fill(false);
 
+        if(this->conservativeRasterization.getValue())
+        {
+            msg_info() <<"Voxelizing edges and triangles (mesh "<<meshId<<")";
+            rasterizeConservatively( meshId, im, mask, tr );
+            fillInside( meshId, im, mask );
+            return;
+        }
+
         // draw edges
         msg_info() <<"Voxelizing edges (mesh "<<meshId<<")";
 
@@ -505,7 +529,16 @@ protected:
             draw_triangle(im,mask,pts[0],pts[1],pts[2],currentColor,subdivValue);
         }
 
-        /// fill inside
+        fillInside( meshId, im, mask );
+    }
+
+
+    /// fill the voxels of mesh 'meshId' which are not connected to the exterior through the unmasked voxels
+    void fillInside( const unsigned int &meshId, cimg_library::CImg<T>& im, cimg_library::CImg<bool>& mask )
+    {
+        raTriangles tri(*this->vf_triangles[meshId]);
+        const T InsideColor = (T)this->vf_InsideValues[meshId]->getValue();
+
         if(this->vf_FillInside[meshId]->getValue())
         {
             msg_info_when(!isClosed(tri.ref())) <<"mesh["<<meshId<<"] might be open, let's try to fill it anyway";
@@ -520,6 +553,96 @@ protected:
     }
 
 
+    /// rasterize all the voxels intersected by the edges and triangles of mesh 'meshId' (see rasterizeTriangles)
+    /// as in rasterizeAndFill, the primitives of the rois are drawn last, with the roi values
+    void rasterizeConservatively( const unsigned int &meshId, cimg_library::CImg<T>& im, cimg_library::CImg<bool>& mask, const waTransform& tr )
+    {
+        raPositions pos(*this->vf_positions[meshId]);
+        raTriangles tri(*this->vf_triangles[meshId]);
+        raEdges edg(*this->vf_edges[meshId]);
+        raIndex roiIndices(*this->vf_roiIndices[meshId]);
+        const bool interpolate = this->vf_values[meshId]->getValue().size()>1;
+        const T FillColor = (T)getValue(meshId,0);
+        const type::Vec<3,int> dim(im.width(),im.height(),im.depth());
+        simulation::TaskScheduler* taskScheduler = parallel.getValue() ? simulation::MainTaskSchedulerFactory::createInRegistry() : nullptr;
+
+        // values read before the parallel rasterization
+        std::vector<Coord> points(pos.size());
+        std::vector<ValueType> values(interpolate?pos.size():0);
+        for(size_t i=0; i<pos.size(); i++)
+        {
+            points[i] = tr->toImage(Coord(pos[i]));
+            if(interpolate) values[i] = getValue(meshId,i);
+        }
+
+        // color of a primitive: value of the last roi containing all its vertices, or FillColor
+        auto getColor = [&](const auto& primitive, bool& isRoi)
+        {
+            T color = FillColor;
+            isRoi = false;
+            for(size_t r=0;r<roiIndices.size();++r)
+            {
+                bool inRoi = true;
+                for(size_t j=0; j<primitive.size(); j++) if(std::find(roiIndices[r].begin(), roiIndices[r].end(), primitive[j])==roiIndices[r].end()) { inRoi=false; break; }
+                if (inRoi) { color = (T)getROIValue(meshId,r); isRoi=true; }
+            }
+            return color;
+        };
+
+        // edges, then edges of the rois
+        {
+            std::vector<type::fixed_array<Coord,2> > primitives, roiPrimitives;
+            std::vector<unsigned int> indices;
+            std::vector<T> roiColors;
+            for(size_t i=0; i<edg.size(); i++)
+            {
+                bool isRoi;
+                const T color = getColor(edg[i],isRoi);
+                const type::fixed_array<Coord,2> p(points[edg[i][0]],points[edg[i][1]]);
+                if(isRoi) { roiPrimitives.push_back(p); roiColors.push_back(color); }
+                else { primitives.push_back(p); indices.push_back(i); }
+            }
+
+            rasterizeEdges<Real>(primitives, dim, [&](int x, int y, int z, unsigned int i, Real u)
+            {
+                im(x,y,z) = interpolate ? (T)(values[edg[indices[i]][0]]*(1.0-u) + values[edg[indices[i]][1]]*u) : FillColor;
+                mask(x,y,z) = true;
+            }, taskScheduler);
+            rasterizeEdges<Real>(roiPrimitives, dim, [&](int x, int y, int z, unsigned int i, Real)
+            {
+                im(x,y,z) = roiColors[i];
+                mask(x,y,z) = true;
+            }, taskScheduler);
+        }
+
+        // triangles, then triangles of the rois
+        {
+            std::vector<type::fixed_array<Coord,3> > primitives, roiPrimitives;
+            std::vector<unsigned int> indices;
+            std::vector<T> roiColors;
+            for(size_t i=0; i<tri.size(); i++)
+            {
+                bool isRoi;
+                const T color = getColor(tri[i],isRoi);
+                const type::fixed_array<Coord,3> p(points[tri[i][0]],points[tri[i][1]],points[tri[i][2]]);
+                if(isRoi) { roiPrimitives.push_back(p); roiColors.push_back(color); }
+                else { primitives.push_back(p); indices.push_back(i); }
+            }
+
+            rasterizeTriangles<Real>(primitives, dim, [&](int x, int y, int z, unsigned int i, const Coord& w)
+            {
+                const auto& t = tri[indices[i]];
+                im(x,y,z) = interpolate ? (T)(values[t[0]]*w[0] + values[t[1]]*w[1] + values[t[2]]*w[2]) : FillColor;
+                mask(x,y,z) = true;
+            }, taskScheduler);
+            rasterizeTriangles<Real>(roiPrimitives, dim, [&](int x, int y, int z, unsigned int i, const Coord&)
+            {
+                im(x,y,z) = roiColors[i];
+                mask(x,y,z) = true;
+            }, taskScheduler);
+        }
+    }
+
     /// retrieve input value of vertex 'index' of mesh 'meshId'
     ValueType getValue( const unsigned int &meshId, const unsigned int &index ) const
     {
@@ -0,0 +1,478 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+
+#include <CImgPlugin/SOFACImg.h>
+
+#include <sofa/type/Vec.h>
+#include <sofa/helper/logging/Messaging.h>
+
+#include <filesystem>
+#include <fstream>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <unordered_map>
+
+namespace sofa
+{
+
+namespace defaulttype
+{
+
+//-----------------------------------------------------------------------------------------------//
+/// Out-of-core storage of a 5d image, split in cubic bricks stored in a file
+//-----------------------------------------------------------------------------------------------//
+
+/**
+ * The image is split into bricks of brickSize^3 voxels (smaller at the borders), each brick holding
+ * all the channels of its voxels at a given time. The bricks are stored in a binary file, and read on
+ * demand through a LRU cache whose size is bounded. Only the bricks of the cache are in memory.
+ *
+ * Once filled, a storage is meant to be shared (see Image::setTiles): the images referencing the same
+ * storage are copies of each other, until one of them is modified (copy-on-write). The copies in memory of
+ * the whole image or of a time are also shared by these images: see getScopedCImgList and pinCImg.
+ *
+ * Reading and writing bricks is thread-safe.
+ */
+template<typename _T>
+class TiledImageStorage
+{
+public:
+    typedef _T T;
+    typedef cimg_library::CImg<T> CImgT;
+    typedef type::Vec<5,unsigned int> imCoord; // [x,y,z,s,t]
+    typedef type::Vec<3,unsigned int> BrickCoord;
+    typedef std::shared_ptr<const cimg_library::CImgList<T> > ScopedCImgList;
+    typedef std::shared_ptr<const CImgT> ScopedCImg;
+
+    /**
+     * @param dim dimensions of the image
+     * @param brickSize number of voxels of a brick along each axis
+     * @param cacheSizeInBytes maximum size of the bricks kept in memory
+     * @param filename file where the bricks are stored. If empty, a file with a unique name is created in the
+     * temporary directory. The file is created by the storage, and removed when the storage is destroyed. An
+     * existing file is never overwritten: the storage is then invalid (see isValid).
+     */
+    TiledImageStorage(const imCoord& dim, unsigned int brickSize, std::size_t cacheSizeInBytes, const std::string& filename = std::string())
+        : m_dim(dim)
+        , m_brickSize(std::max(brickSize, 1u))
+        , m_cacheSizeInBytes(cacheSizeInBytes)
+        , m_filename(filename)
+    {
+        for (unsigned int i = 0; i < 3; ++i)
+        {
+            m_nbBricks[i] = (m_dim[i] + m_brickSize - 1) / m_brickSize;
+        }
+
+        if (m_filename.empty())
+        {
+            std::random_device random;
+            do
+            {
+                m_filename = (std::filesystem::temp_directory_path() / ("sofa_image_tiles_" + std::to_string(random()) + std::to_string(random()) + ".raw")).string();
+            }
+            while (std::filesystem::exists(m_filename));
+        }
+        else if (std::filesystem::exists(m_filename))
+        {
+            msg_error("TiledImageStorage") << "The file " << m_filename << " already exists: it is not overwritten";
+            return;
+        }
+
+        m_file.open(m_filename, std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!m_file.is_open())
+        {
+            msg_error("TiledImageStorage") << "Cannot open " << m_filename;
+        }
+    }
+
+    TiledImageStorage(const TiledImageStorage&) = delete;
+    TiledImageStorage& operator=(const TiledImageStorage&) = delete;
+
+    /// The file created by the storage is removed
+    ~TiledImageStorage()
+    {
+        if (m_file.is_open())
+        {
+            m_file.close();
+            std::error_code error;
+            std::filesystem::remove(m_filename, error);
+        }
+    }
+
+    /// Create a storage from an image in memory
+    /// @return nullptr if the file of the storage cannot be created
+    static std::shared_ptr<TiledImageStorage> fromCImgList(const cimg_library::CImgList<T>& img, unsigned int brickSize, std::size_t cacheSizeInBytes, const std::string& filename = std::string())
+    {
+        imCoord dim;
+        dim.fill(0);
+        if (img.size())
+        {
+            dim = imCoord(img(0).width(), img(0).height(), img(0).depth(), img(0).spectrum(), img.size());
+        }
+
+        auto storage = std::make_shared<TiledImageStorage>(dim, brickSize, cacheSizeInBytes, filename);
+        if (!storage->isValid())
+        {
+            return nullptr;
+        }
+
+        storage->forEachBrickCoord([&storage, &img](const BrickCoord& b, unsigned int t)
+        {
+            const imCoord origin = storage->getBrickOrigin(b, t);
+            const imCoord size = storage->getBrickDimensions(b, t);
+            storage->setBrick(b, t, img(t).get_crop(origin[0], origin[1], origin[2], 0,
+                origin[0] + size[0] - 1, origin[1] + size[1] - 1, origin[2] + size[2] - 1, size[3] - 1));
+        });
+        return storage;
+    }
+
+    const imCoord& getDimensions() const { return m_dim; }
+    unsigned int getBrickSize() const { return m_brickSize; }
+    const BrickCoord& getNbBricks() const { return m_nbBricks; }
+    const std::string& getFilename() const { return m_filename; }
+
+    /// False if the file of the storage could not be created. The bricks of an invalid storage are zeros.
+    bool isValid() const { return m_file.is_open(); }
+
+    std::size_t getCacheSizeInBytes() const { return m_cacheSizeInBytes; }
+    void setCacheSizeInBytes(std::size_t size)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_cacheSizeInBytes = size;
+        evict();
+    }
+
+    /// Size of the bricks currently in memory
+    std::size_t getCachedSizeInBytes() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_cachedSizeInBytes;
+    }
+
+    /// Coordinates of the first voxel of a brick, in the image
+    imCoord getBrickOrigin(const BrickCoord& b, unsigned int t) const
+    {
+        return imCoord(b[0] * m_brickSize, b[1] * m_brickSize, b[2] * m_brickSize, 0, t);
+    }
+
+    /// Dimensions of a brick, smaller than brickSize at the borders of the image
+    imCoord getBrickDimensions(const BrickCoord& b, unsigned int t) const
+    {
+        imCoord size(0, 0, 0, m_dim[3], 1);
+        for (unsigned int i = 0; i < 3; ++i)
+        {
+            size[i] = std::min(m_brickSize, m_dim[i] - b[i] * m_brickSize);
+        }
+        SOFA_UNUSED(t);
+        return size;
+    }
+
+    /// Brick containing a voxel
+    BrickCoord getBrickCoord(unsigned int x, unsigned int y, unsigned int z) const
+    {
+        return BrickCoord(x / m_brickSize, y / m_brickSize, z / m_brickSize);
+    }
+
+    /// Read a brick, from the cache if possible
+    std::shared_ptr<const CImgT> getBrick(const BrickCoord& b, unsigned int t) const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        const std::size_t index = getBrickIndex(b, t);
+        auto it = m_cache.find(index);
+        if (it != m_cache.end())
+        {
+            m_lru.splice(m_lru.begin(), m_lru, it->second.second);
+            return it->second.first;
+        }
+
+        const imCoord size = getBrickDimensions(b, t);
+        auto brick = std::make_shared<CImgT>(size[0], size[1], size[2], size[3], (T)0);
+        m_file.clear();
+        m_file.seekg(getBrickOffset(index));
+        m_file.read(reinterpret_cast<char*>(brick->data()), brick->size() * sizeof(T));
+        m_file.clear(); // bricks never written are zeros, read after the end of the file
+
+        insertInCache(index, brick);
+        return brick;
+    }
+
+    /// Write a brick. Its dimensions must be the ones given by getBrickDimensions.
+    void setBrick(const BrickCoord& b, unsigned int t, const CImgT& brick)
+    {
+        const imCoord size = getBrickDimensions(b, t);
+        if ((unsigned int)brick.width() != size[0] || (unsigned int)brick.height() != size[1] || (unsigned int)brick.depth() != size[2] || (unsigned int)brick.spectrum() != size[3])
+        {
+            msg_error("TiledImageStorage") << "Wrong dimensions of brick " << b << " at time " << t;
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        const std::size_t index = getBrickIndex(b, t);
+        m_file.clear();
+        m_file.seekp(getBrickOffset(index));
+        m_file.write(reinterpret_cast<const char*>(brick.data()), brick.size() * sizeof(T));
+        m_file.flush();
+
+        auto it = m_cache.find(index);
+        if (it != m_cache.end())
+        {
+            m_cachedSizeInBytes -= it->second.first->size() * sizeof(T);
+            m_lru.erase(it->second.second);
+            m_cache.erase(it);
+        }
+        insertInCache(index, std::make_shared<CImgT>(brick));
+    }
+
+    /// Value of a voxel. Reads the brick containing the voxel if it is not in the cache.
+    T at(unsigned int x, unsigned int y, unsigned int z, unsigned int c = 0, unsigned int t = 0) const
+    {
+        const BrickCoord b = getBrickCoord(x, y, z);
+        const auto brick = getBrick(b, t);
+        return (*brick)(x - b[0] * m_brickSize, y - b[1] * m_brickSize, z - b[2] * m_brickSize, c);
+    }
+
+    /// Copy the box [min,max] of the image at time t, with all its channels, reading only the bricks it intersects.
+    /// The voxels outside the image are zeros.
+    CImgT getCrop(const type::Vec<3,unsigned int>& min, const type::Vec<3,unsigned int>& max, unsigned int t) const
+    {
+        CImgT crop(max[0] - min[0] + 1, max[1] - min[1] + 1, max[2] - min[2] + 1, m_dim[3], (T)0);
+        if (t >= m_dim[4])
+        {
+            return crop;
+        }
+
+        BrickCoord bmin, bmax;
+        for (unsigned int i = 0; i < 3; ++i)
+        {
+            if (min[i] >= m_dim[i])
+            {
+                return crop;
+            }
+            bmin[i] = min[i] / m_brickSize;
+            bmax[i] = std::min(max[i] / m_brickSize, m_nbBricks[i] - 1);
+        }
+
+        for (unsigned int bz = bmin[2]; bz <= bmax[2]; ++bz)
+            for (unsigned int by = bmin[1]; by <= bmax[1]; ++by)
+                for (unsigned int bx = bmin[0]; bx <= bmax[0]; ++bx)
+                {
+                    const BrickCoord b(bx, by, bz);
+                    const imCoord origin = getBrickOrigin(b, t);
+                    crop.draw_image(int(origin[0]) - int(min[0]), int(origin[1]) - int(min[1]), int(origin[2]) - int(min[2]), 0, *getBrick(b, t));
+                }
+        return crop;
+    }
+
+    /// Call f(brickCoord, t) for all the bricks of the image
+    template<class Function>
+    void forEachBrickCoord(Function f) const
+    {
+        for (unsigned int t = 0; t < m_dim[4]; ++t)
+            for (unsigned int bz = 0; bz < m_nbBricks[2]; ++bz)
+                for (unsigned int by = 0; by < m_nbBricks[1]; ++by)
+                    for (unsigned int bx = 0; bx < m_nbBricks[0]; ++bx)
+                        f(BrickCoord(bx, by, bz), t);
+    }
+
+    /// Stream over the bricks: call f(brickCoord, t, brick) for all the bricks of the image
+    template<class Function>
+    void forEachBrick(Function f) const
+    {
+        forEachBrickCoord([this, &f](const BrickCoord& b, unsigned int t)
+        {
+            f(b, t, *getBrick(b, t));
+        });
+    }
+
+    /// Copy the whole image in memory
+    void materialize(cimg_library::CImgList<T>& img) const
+    {
+        img.assign(m_dim[4], m_dim[0], m_dim[1], m_dim[2], m_dim[3]);
+        forEachBrick([this, &img](const BrickCoord& b, unsigned int t, const CImgT& brick)
+        {
+            const imCoord origin = getBrickOrigin(b, t);
+            img(t).draw_image(origin[0], origin[1], origin[2], 0, brick);
+        });
+    }
+
+    /// Copy the image at time t in memory
+    void materialize(CImgT& frame, unsigned int t) const
+    {
+        frame.assign(m_dim[0], m_dim[1], m_dim[2], m_dim[3]);
+        for (unsigned int bz = 0; bz < m_nbBricks[2]; ++bz)
+            for (unsigned int by = 0; by < m_nbBricks[1]; ++by)
+                for (unsigned int bx = 0; bx < m_nbBricks[0]; ++bx)
+                {
+                    const BrickCoord b(bx, by, bz);
+                    const imCoord origin = getBrickOrigin(b, t);
+                    frame.draw_image(origin[0], origin[1], origin[2], 0, *getBrick(b, t));
+                }
+    }
+
+    /// The whole image in memory. It is loaded once for all the readers, and released with the last reference.
+    ScopedCImgList getScopedCImgList() const
+    {
+        std::lock_guard<std::mutex> lock(m_materializationMutex);
+        ScopedCImgList list = m_materializedList.lock();
+        if (!list)
+        {
+            auto newList = std::make_shared<cimg_library::CImgList<T> >();
+            materialize(*newList);
+            list = std::move(newList);
+            m_materializedList = list;
+        }
+        return list;
+    }
+
+    /// The image at time t in memory, or at time 0 if t is out of range. It is loaded once for all the
+    /// readers, unless the whole image is already in memory, and released with the last reference.
+    ScopedCImg getScopedCImg(unsigned int t) const
+    {
+        std::lock_guard<std::mutex> lock(m_materializationMutex);
+        return getScopedCImgLocked(t);
+    }
+
+    /// Keep the whole image in memory, until releasePinned is called.
+    /// Used by the const accessors of Image which return references.
+    const cimg_library::CImgList<T>& pinCImgList() const
+    {
+        const ScopedCImgList list = getScopedCImgList();
+        std::lock_guard<std::mutex> lock(m_materializationMutex);
+        if (!m_pinnedList) m_pinnedList = list;
+        return *m_pinnedList;
+    }
+
+    /// Keep the image at time t in memory, until releasePinned is called
+    const CImgT& pinCImg(unsigned int t) const
+    {
+        std::lock_guard<std::mutex> lock(m_materializationMutex);
+        ScopedCImg& frame = m_pinnedFrames[getTime(t)];
+        if (!frame) frame = getScopedCImgLocked(t);
+        return *frame;
+    }
+
+    /// Release the copies kept by pinCImgList and pinCImg, for all the images sharing this storage.
+    /// The references they returned are not valid anymore.
+    void releasePinned() const
+    {
+        std::lock_guard<std::mutex> lock(m_materializationMutex);
+        m_pinnedList.reset();
+        m_pinnedFrames.clear();
+    }
+
+    /// True if the whole image or one of its times is in memory
+    bool isMaterialized() const
+    {
+        std::lock_guard<std::mutex> lock(m_materializationMutex);
+        if (!m_materializedList.expired()) return true;
+        for (const auto& frame : m_materializedFrames)
+            if (!frame.second.expired()) return true;
+        return false;
+    }
+
+protected:
+
+    unsigned int getTime(unsigned int t) const { return t < m_dim[4] ? t : 0; }
+
+    /// m_materializationMutex must be locked
+    ScopedCImg getScopedCImgLocked(unsigned int t) const
+    {
+        t = getTime(t);
+        if (const ScopedCImgList list = m_materializedList.lock())
+        {
+            return ScopedCImg(list, &(*list)(t));
+        }
+        std::weak_ptr<const CImgT>& materializedFrame = m_materializedFrames[t];
+        ScopedCImg frame = materializedFrame.lock();
+        if (!frame)
+        {
+            auto newFrame = std::make_shared<CImgT>();
+            materialize(*newFrame, t);
+            frame = std::move(newFrame);
+            materializedFrame = frame;
+        }
+        return frame;
+    }
+
+    std::size_t getBrickIndex(const BrickCoord& b, unsigned int t) const
+    {
+        return ((std::size_t(t) * m_nbBricks[2] + b[2]) * m_nbBricks[1] + b[1]) * m_nbBricks[0] + b[0];
+    }
+
+    /// All the bricks have the same size in the file, the ones at the borders are not full
+    std::streamoff getBrickOffset(std::size_t index) const
+    {
+        return std::streamoff(index * std::size_t(m_brickSize) * m_brickSize * m_brickSize * m_dim[3] * sizeof(T));
+    }
+
+    void insertInCache(std::size_t index, std::shared_ptr<const CImgT> brick) const
+    {
+        m_lru.push_front(index);
+        m_cachedSizeInBytes += brick->size() * sizeof(T);
+        m_cache.emplace(index, std::make_pair(std::move(brick), m_lru.begin()));
+        evict();
+    }
+
+    /// Remove the least recently used bricks, keeping at least the last one
+    void evict() const
+    {
+        while (m_cachedSizeInBytes > m_cacheSizeInBytes && m_lru.size() > 1)
+        {
+            auto it = m_cache.find(m_lru.back());
+            m_cachedSizeInBytes -= it->second.first->size() * sizeof(T);
+            m_cache.erase(it);
+            m_lru.pop_back();
+        }
+    }
+
+    imCoord m_dim;
+    unsigned int m_brickSize;
+    BrickCoord m_nbBricks;
+
+    std::size_t m_cacheSizeInBytes;
+    mutable std::size_t m_cachedSizeInBytes { 0 };
+    mutable std::list<std::size_t> m_lru; ///< indices of the cached bricks, the most recently used first
+    mutable std::unordered_map<std::size_t, std::pair<std::shared_ptr<const CImgT>, std::list<std::size_t>::iterator> > m_cache;
+
+    std::string m_filename;
+    mutable std::fstream m_file;
+    mutable std::mutex m_mutex;
+
+    /// copies in memory of the whole image and of its times, alive as long as a reader references them
+    mutable std::weak_ptr<const cimg_library::CImgList<T> > m_materializedList;
+    mutable std::map<unsigned int, std::weak_ptr<const CImgT> > m_materializedFrames;
+    /// copies kept until releasePinned is called
+    mutable ScopedCImgList m_pinnedList;
+    mutable std::map<unsigned int, ScopedCImg> m_pinnedFrames;
+    /// protects the copies in memory. Locked before m_mutex, when a copy is loaded.
+    mutable std::mutex m_materializationMutex;
+};
+
+} // namespace defaulttype
+
+} // namespace sofa
@@ -66,7 +66,8 @@ struct TransferFunctionSpecialization<defaulttype::Image<Ti>,defaulttype::Image<
         typename TransferFunctionT::raParam p(This.param);
         typename TransferFunctionT::raImagei in(This.inputImage);
         if(in->isEmpty()) return;
-        const cimg_library::CImgList<Ti>& inimg = in->getCImgList();
+        const auto scopedInimg = in->getScopedCImgList();
+        const cimg_library::CImgList<Ti>& inimg = *scopedInimg;
 
         typename TransferFunctionT::waImageo out(This.outputImage);
         typename TransferFunctionT::imCoord dim=in->getDimensions();
@@ -75,7 +76,7 @@ struct TransferFunctionSpecialization<defaulttype::Image<Ti>,defaulttype::Image<
 
         if (p.empty()) //no parameters provided to the filter: the image is just copied as it is
         {
-            img.assign(in->getCImgList());
+            img.assign(inimg);
             return;
         }
 
@@ -89,7 +90,7 @@ struct TransferFunctionSpecialization<defaulttype::Image<Ti>,defaulttype::Image<
             break;
 
         default:
-            img.assign(in->getCImgList());	// copy
+            img.assign(inimg);	// copy
             break;
         }
     }
@@ -232,7 +232,7 @@ protected:
         raTransform inT(this->transform);
 
         // get image at time t
-        cimg_library::CImg<T> img = in->getCImg(this->time);
+        cimg_library::CImg<T> img = *in->getScopedCImg(this->time);
 
         T mx = img.max()+1;
 
@@ -248,7 +248,7 @@ protected:
         }
         else        // use voronoi of the background to add surface details
         {
-            cimg_library::CImg<T> bkg = inb->getCImg(this->time);
+            cimg_library::CImg<T> bkg = *inb->getScopedCImg(this->time);
             cimg_forXYZ(img,x,y,z)
                     if(img(x,y,z)==0)
                         img(x,y,z)=mx+bkg(x,y,z)-1;
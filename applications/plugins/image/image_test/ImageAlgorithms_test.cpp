@@ -0,0 +1,199 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/testing/BaseTest.h>
+#include <sofa/simulation/MainTaskSchedulerFactory.h>
+#include <image/ImageAlgorithms.h>
+
+namespace sofa {
+
+/**  Test suite for the parallel image algorithms.
+Compare the euclidean distance transform to brute force distances, check that conservative rasterization has no hole,
+that Lloyd relaxation moves the points to the centroids of their voronoi regions, and that the results do not depend on the task scheduler.
+  */
+struct ImageAlgorithms_test : public sofa::testing::BaseTest
+{
+    typedef type::Vec<3,SReal> Coord;
+    typedef type::Vec<3,int> iCoord;
+
+    simulation::TaskScheduler* taskScheduler { nullptr };
+
+    void doSetUp() override
+    {
+        taskScheduler = simulation::MainTaskSchedulerFactory::createInRegistry();
+        if(taskScheduler->getThreadCount() < 1) taskScheduler->init(4);
+    }
+
+    void testEuclideanDistanceTransform()
+    {
+        const Coord voxelSize(0.7,1.3,1.);
+        cimg_library::CImg<SReal> distances(17,11,9,1,cimg_library::cimg::type<SReal>::max());
+        cimg_library::CImg<unsigned int> voronoi(17,11,9,1,0);
+
+        // hole in the object
+        for(int z=2;z<5;z++) for(int y=3;y<6;y++) for(int x=4;x<9;x++) distances(x,y,z)=-1;
+
+        const type::vector<iCoord> seeds { iCoord(0,0,0), iCoord(16,10,8), iCoord(10,2,7), iCoord(3,9,1) };
+        for(unsigned int i=0; i<seeds.size(); i++)
+        {
+            distances(seeds[i][0],seeds[i][1],seeds[i][2])=0;
+            voronoi(seeds[i][0],seeds[i][1],seeds[i][2])=i+1;
+        }
+
+        cimg_library::CImg<SReal> parallelDistances(distances);
+        cimg_library::CImg<unsigned int> parallelVoronoi(voronoi);
+        euclideanDistanceTransform<SReal>(distances,voronoi,voxelSize);
+        euclideanDistanceTransform<SReal>(parallelDistances,parallelVoronoi,voxelSize,taskScheduler);
+        EXPECT_TRUE(distances==parallelDistances);
+        EXPECT_TRUE(voronoi==parallelVoronoi);
+
+        cimg_forXYZ(distances,x,y,z)
+        {
+            if(x>=4 && x<9 && y>=3 && y<6 && z>=2 && z<5)
+            {
+                EXPECT_EQ(distances(x,y,z),-1);
+                EXPECT_EQ(voronoi(x,y,z),0u);
+                continue;
+            }
+            SReal dmin=std::numeric_limits<SReal>::max();
+            for(const iCoord& s : seeds) dmin=std::min(dmin, Coord((x-s[0])*voxelSize[0],(y-s[1])*voxelSize[1],(z-s[2])*voxelSize[2]).norm());
+            EXPECT_NEAR(distances(x,y,z),dmin,1e-10);
+
+            const iCoord& s = seeds[voronoi(x,y,z)-1];
+            EXPECT_NEAR(Coord((x-s[0])*voxelSize[0],(y-s[1])*voxelSize[1],(z-s[2])*voxelSize[2]).norm(),dmin,1e-10);
+        }
+    }
+
+    void testConservativeRasterization()
+    {
+        const iCoord dim(20,20,40);
+        std::vector<type::fixed_array<Coord,3> > triangles;
+        triangles.push_back(type::fixed_array<Coord,3>(Coord(-2,1.3,0.2),Coord(18.4,4.1,35.7),Coord(5.5,19.6,12.1)));
+        triangles.push_back(type::fixed_array<Coord,3>(Coord(3.3,3.3,3.3),Coord(15.2,16.7,4.1),Coord(4.4,15.8,38.2)));
+        triangles.push_back(type::fixed_array<Coord,3>(Coord(10,10,10),Coord(10.2,10.1,10.3),Coord(10.1,10.4,10.2))); // smaller than a voxel
+
+        cimg_library::CImg<int> image(dim[0],dim[1],dim[2],1,-1), parallelImage(image);
+        rasterizeTriangles<SReal>(triangles, dim, [&](int x, int y, int z, unsigned int i, const Coord& w)
+        {
+            image(x,y,z)=i;
+            EXPECT_NEAR(w[0]+w[1]+w[2],1.,1e-10);
+        });
+        rasterizeTriangles<SReal>(triangles, dim, [&](int x, int y, int z, unsigned int i, const Coord&) { parallelImage(x,y,z)=i; }, taskScheduler);
+        EXPECT_TRUE(image==parallelImage);
+
+        // the voxels containing points of a triangle are drawn, by this triangle or a next one
+        for(unsigned int i=0; i<triangles.size(); i++)
+            for(SReal u=0; u<=1; u+=0.01) for(SReal v=0; u+v<=1; v+=0.01)
+            {
+                const Coord p = triangles[i][0]*(1-u-v) + triangles[i][1]*u + triangles[i][2]*v;
+                const iCoord voxel(std::lround(p[0]),std::lround(p[1]),std::lround(p[2]));
+                if(!image.containsXYZC(voxel[0],voxel[1],voxel[2])) continue;
+                ASSERT_GE(image(voxel[0],voxel[1],voxel[2]),(int)i);
+            }
+    }
+
+    void testLloydCentroids()
+    {
+        // two boxes of 5x5x3 voxels
+        cimg_library::CImg<unsigned int> voronoi(10,5,3,1,1);
+        cimg_forXYZ(voronoi,x,y,z) if(x>=5) voronoi(x,y,z)=2;
+
+        std::vector<Coord> pos { Coord(0,0,0), Coord(9,4,2) };
+        const std::vector<unsigned int> voronoiIndex { 1, 2 };
+
+        EXPECT_TRUE(Lloyd<SReal>(pos,voronoiIndex,voronoi,taskScheduler));
+        EXPECT_EQ(pos[0],Coord(2,2,1));
+        EXPECT_EQ(pos[1],Coord(7,2,1));
+
+        // the points are already at the centroids
+        EXPECT_FALSE(Lloyd<SReal>(pos,voronoiIndex,voronoi,taskScheduler));
+    }
+
+    void testLloydNonConvexRegion()
+    {
+        // region 1 is L-shaped, its centroid (1.96,1.96) is in region 2
+        cimg_library::CImg<unsigned int> voronoi(7,7,1,1,1);
+        cimg_forXY(voronoi,x,y) if(x>=2 && y>=2) voronoi(x,y)=2;
+
+        std::vector<Coord> pos { Coord(0,6,0), Coord(6,6,0) };
+        const std::vector<unsigned int> voronoiIndex { 1, 2 };
+
+        EXPECT_TRUE(Lloyd<SReal>(pos,voronoiIndex,voronoi));
+        EXPECT_EQ(voronoi((int)pos[0][0],(int)pos[0][1],(int)pos[0][2]),1u);
+        EXPECT_LT((pos[0]-Coord(1.96,1.96,0)).norm(),1.);
+        EXPECT_EQ(pos[1],Coord(4,4,0));
+    }
+
+    void testLloydParallel()
+    {
+        cimg_library::CImg<SReal> distances(23,17,13,1,cimg_library::cimg::type<SReal>::max());
+        cimg_library::CImg<unsigned int> voronoi(23,17,13,1,0);
+
+        std::vector<Coord> pos { Coord(0,0,0), Coord(22,16,12), Coord(11,3,6), Coord(4,14,2), Coord(19,8,10), Coord(5,5,11) };
+        std::vector<unsigned int> voronoiIndex;
+        for(unsigned int i=0; i<pos.size(); i++)
+        {
+            distances((int)pos[i][0],(int)pos[i][1],(int)pos[i][2])=0;
+            voronoi((int)pos[i][0],(int)pos[i][1],(int)pos[i][2])=i+1;
+            voronoiIndex.push_back(i+1);
+        }
+        euclideanDistanceTransform<SReal>(distances,voronoi,Coord(1,1,1));
+
+        std::vector<Coord> parallelPos(pos);
+        cimg_library::CImg<unsigned int> parallelVoronoi(voronoi);
+        const bool moved = Lloyd<SReal>(pos,voronoiIndex,voronoi);
+        const bool parallelMoved = Lloyd<SReal>(parallelPos,voronoiIndex,parallelVoronoi,taskScheduler);
+
+        EXPECT_TRUE(moved);
+        EXPECT_EQ(moved,parallelMoved);
+        EXPECT_EQ(pos,parallelPos);
+        EXPECT_TRUE(voronoi==parallelVoronoi);
+        for(unsigned int i=0; i<pos.size(); i++)
+            EXPECT_EQ(voronoi((int)pos[i][0],(int)pos[i][1],(int)pos[i][2]),voronoiIndex[i]);
+    }
+};
+
+TEST_F(ImageAlgorithms_test, euclideanDistanceTransform)
+{
+    testEuclideanDistanceTransform();
+}
+
+TEST_F(ImageAlgorithms_test, conservativeRasterization)
+{
+    testConservativeRasterization();
+}
+
+TEST_F(ImageAlgorithms_test, lloydCentroids)
+{
+    testLloydCentroids();
+}
+
+TEST_F(ImageAlgorithms_test, lloydNonConvexRegion)
+{
+    testLloydNonConvexRegion();
+}
+
+TEST_F(ImageAlgorithms_test, lloydParallel)
+{
+    testLloydParallel();
+}
+
+}// namespace sofa
@@ -26,6 +26,10 @@
 
 #include <image/ImageContainer.h>
 #include <image/ImageViewer.h>
+#include <image/ImageFilter.h>
+#include <image/MergeImages.h>
+#include <image/ImageSampler.h>
+#include <image/ImageValuesFromPositions.h>
 #include "TestImageEngine.h"
 
 #include <sofa/testing/BaseTest.h>
@@ -234,6 +238,82 @@ struct ImageEngine_test : public sofa::testing::BaseTest
         ASSERT_EQ(&imageContainer->image.getValue(),&imageEngine->inputImage.getValue());
         ASSERT_EQ(&imageEngine->outputImage.getValue(),&imageViewer->image.getValue());
     }
+
+    /// Chain of engines reading an image stored out-of-core: the image must not stay in memory after their update
+    void testTiledImageChain()
+    {
+        typedef defaulttype::Image<unsigned char> Image;
+        typedef sofa::component::container::ImageContainer< Image > ImageContainer;
+        typedef sofa::component::engine::ImageFilter< Image, Image > ImageFilter;
+        typedef sofa::component::engine::MergeImages< Image > MergeImages;
+        typedef sofa::component::engine::ImageSampler< Image > ImageSampler;
+        typedef sofa::component::engine::ImageValuesFromPositions< Image > ImageValuesFromPositions;
+
+        root = sofa::simulation::getSimulation()->createNewGraph("root");
+
+        const auto imageContainer = sofa::modeling::addNew<ImageContainer>(root);
+        imageContainer->m_filename.setValue(std::string(IMAGETEST_SCENES_DIR) + "/" + "beam.raw");
+        imageContainer->outOfCore.setValue(true);
+        imageContainer->brickSize.setValue(8);
+        imageContainer->cacheSize.setValue(1);
+
+        const auto filter = sofa::modeling::addNew<ImageFilter>(root);
+        sofa::modeling::setDataLink(&imageContainer->image,&filter->inputImage);
+        sofa::modeling::setDataLink(&imageContainer->transform,&filter->inputTransform);
+
+        const auto merge = sofa::modeling::addNew<MergeImages>(root);
+        merge->nbImages.setValue(2);
+        merge->inputImages.resize(2);
+        merge->inputTransforms.resize(2);
+        sofa::modeling::setDataLink(&imageContainer->image,merge->inputImages[0]);
+        sofa::modeling::setDataLink(&imageContainer->transform,merge->inputTransforms[0]);
+        sofa::modeling::setDataLink(&filter->outputImage,merge->inputImages[1]);
+        sofa::modeling::setDataLink(&filter->outputTransform,merge->inputTransforms[1]);
+
+        const auto sampler = sofa::modeling::addNew<ImageSampler>(root);
+        sofa::modeling::setDataLink(&imageContainer->image,&sampler->image);
+        sofa::modeling::setDataLink(&imageContainer->transform,&sampler->transform);
+
+        const auto values = sofa::modeling::addNew<ImageValuesFromPositions>(root);
+        sofa::modeling::setDataLink(&imageContainer->image,&values->image);
+        sofa::modeling::setDataLink(&imageContainer->transform,&values->transform);
+        sofa::modeling::setDataLink(&sampler->position,&values->position);
+
+        sofa::simulation::node::initRoot(root.get());
+
+        const Image& image = imageContainer->image.getValue();
+        ASSERT_TRUE(image.isTiled());
+        ASSERT_FALSE(image.isEmpty());
+
+        EXPECT_FALSE(filter->outputImage.getValue().isEmpty());
+        EXPECT_FALSE(merge->image.getValue().isEmpty());
+        EXPECT_FALSE(sampler->position.getValue().empty());
+        EXPECT_EQ(values->values.getValue().size(), sampler->position.getValue().size());
+
+        // only the bricks of the cache are resident
+        EXPECT_FALSE(image.isMaterialized());
+        EXPECT_LE(image.getTiles()->getCachedSizeInBytes(), std::size_t(1) << 20);
+
+        EXPECT_TRUE(filter->outputImage.getValue() == image);
+        EXPECT_FALSE(image.isMaterialized());
+
+        // a read access during a time step loads one time of the image, released at the end of the step
+        EXPECT_TRUE(image.getCImg(0) == filter->outputImage.getValue().getCImg(0));
+        EXPECT_TRUE(image.isMaterialized());
+        sofa::simulation::node::animate(root.get(),0.5);
+        EXPECT_FALSE(image.isMaterialized());
+
+        // the input of an engine is a copy of the image, sharing its storage: its read accesses are released too
+        const Image& input = values->image.getValue();
+        ASSERT_EQ(input.getTiles(), image.getTiles());
+        EXPECT_TRUE(input.getCImg(0) == image.getCImg(0));
+        EXPECT_TRUE(image.isMaterialized());
+        values->position.setValue(sampler->position.getValue());
+        EXPECT_EQ(values->values.getValue().size(), sampler->position.getValue().size());
+        sofa::simulation::node::animate(root.get(),0.5);
+        EXPECT_FALSE(input.isMaterialized());
+        EXPECT_FALSE(image.isMaterialized());
+    }
 };
 
 // Test
@@ -252,6 +332,11 @@ TEST_F(ImageEngine_test , testImageViewer )
     ASSERT_NO_THROW(this->testImageViewer());
 }
 
+TEST_F(ImageEngine_test , testTiledImageChain )
+{
+    this->testTiledImageChain();
+}
+
 
 }// namespace sofa
 
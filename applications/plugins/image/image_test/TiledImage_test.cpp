@@ -0,0 +1,195 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/testing/BaseTest.h>
+#include <image/ImageTypes.h>
+
+#include <thread>
+
+namespace sofa {
+
+/**  Test suite for the out-of-core storage of images.
+Split an image in bricks, and check that the voxels read through the cache are the ones of the image,
+whatever the size of the cache. Then check that the images sharing a storage are copied on write, and that
+they are loaded in memory only while they are accessed as a whole.
+  */
+struct TiledImage_test : public sofa::testing::BaseTest
+{
+    typedef defaulttype::Image<float> Image;
+    typedef Image::TiledStorage TiledStorage;
+
+    cimg_library::CImgList<float> img;
+
+    void doSetUp() override
+    {
+        img.assign(2,13,7,5,2);
+        float value = 0;
+        cimglist_for(img,l) cimg_forXYZC(img(l),x,y,z,c) img(l)(x,y,z,c) = value++;
+    }
+
+    void testBricks(const std::size_t cacheSize)
+    {
+        const auto tiles = TiledStorage::fromCImgList(img, 4, cacheSize);
+        EXPECT_EQ(tiles->getNbBricks(), TiledStorage::BrickCoord(4,2,2));
+        EXPECT_EQ(tiles->getBrickDimensions(TiledStorage::BrickCoord(3,1,1),0), TiledStorage::imCoord(1,3,1,2,1));
+
+        cimglist_for(img,l) cimg_forXYZC(img(l),x,y,z,c)
+        {
+            ASSERT_EQ(tiles->at(x,y,z,c,l), img(l)(x,y,z,c));
+            // a brick is kept even if it is larger than the cache
+            ASSERT_LE(tiles->getCachedSizeInBytes(), std::max<std::size_t>(cacheSize, 4*4*4*2*sizeof(float)));
+        }
+
+        cimg_library::CImgList<float> materialized;
+        tiles->materialize(materialized);
+        ASSERT_EQ(materialized.size(), img.size());
+        cimglist_for(img,l) EXPECT_TRUE(materialized(l) == img(l));
+
+        cimg_library::CImg<float> frame;
+        tiles->materialize(frame, 1);
+        EXPECT_TRUE(frame == img(1));
+
+        const std::string filename = tiles->getFilename();
+        EXPECT_TRUE(std::filesystem::exists(filename));
+    }
+
+    void testCopyOnWrite()
+    {
+        Image image;
+        image.setTiles(TiledStorage::fromCImgList(img, 4, 1024));
+        EXPECT_TRUE(image.isTiled());
+        EXPECT_FALSE(image.isMaterialized());
+        EXPECT_EQ(image.getDimensions(), Image::imCoord(13,7,5,2,2));
+        EXPECT_TRUE(image.isInside(12,6,4));
+        EXPECT_FALSE(image.isInside(13,6,4));
+
+        Image copy(image);
+        EXPECT_EQ(copy.getTiles(), image.getTiles());
+        EXPECT_TRUE(copy == image);
+
+        // read access loads the image at the given time, and keeps the storage
+        const Image& constCopy = copy;
+        EXPECT_EQ(constCopy.getCImg(1)(3,2,1,1), img(1)(3,2,1,1));
+        EXPECT_TRUE(constCopy.getCImg(1) == img(1));
+        EXPECT_TRUE(constCopy.getCImg(0) == img(0));
+        EXPECT_EQ(&constCopy.getCImg(1), &constCopy.getCImg(1));
+        EXPECT_TRUE(copy.isTiled());
+        EXPECT_TRUE(copy.isMaterialized());
+        EXPECT_TRUE(image.isMaterialized());
+
+        // the copies in memory are shared by the images sharing the storage, and released by any of them
+        const Image& constImage = image;
+        EXPECT_EQ(&constImage.getCImg(1), &constCopy.getCImg(1));
+        constImage.releaseCImgList();
+        EXPECT_FALSE(copy.isMaterialized());
+
+        // write access detaches the image from its storage
+        copy.getCImg(1)(3,2,1,1) = -1;
+        EXPECT_FALSE(copy.isTiled());
+        EXPECT_EQ(image.getTiles()->at(3,2,1,1,1), img(1)(3,2,1,1));
+        EXPECT_FALSE(copy == image);
+    }
+
+    void testScopedAccess()
+    {
+        Image image;
+        image.setTiles(TiledStorage::fromCImgList(img, 4, 1024));
+        {
+            const auto list = image.getScopedCImgList();
+            EXPECT_TRUE(image.isMaterialized());
+            EXPECT_EQ(image.getScopedCImgList(), list);
+            EXPECT_TRUE((*list)(1) == img(1));
+        }
+        EXPECT_FALSE(image.isMaterialized());
+
+        // only the image at the given time is loaded, as long as it is referenced
+        {
+            const auto frame = image.getScopedCImg(1);
+            EXPECT_TRUE(*frame == img(1));
+            EXPECT_TRUE(image.isMaterialized());
+            EXPECT_EQ(image.getScopedCImg(1), frame);
+
+            // the copy of the whole image is reused when it is loaded
+            const auto list = image.getScopedCImgList();
+            EXPECT_EQ(image.getScopedCImg(1).get(), &(*list)(1));
+        }
+        EXPECT_FALSE(image.isMaterialized());
+
+        // the planes are read brick by brick
+        const type::Mat<2,3,unsigned int> roi(type::Vec<3,unsigned int>(1,2,0), type::Vec<3,unsigned int>(12,6,4));
+        EXPECT_TRUE(image.get_plane(2,2,roi,1) == img(1).get_crop(1,2,2,0,12,6,2,1));
+        EXPECT_TRUE(image.get_plane(5,0,roi,0) == img(0).get_crop(5,2,0,0,5,6,4,1).permute_axes("zyxc"));
+        EXPECT_FALSE(image.isMaterialized());
+
+        // the concurrent readers share the same copy in memory
+        const Image& constImage = image;
+        std::vector<const cimg_library::CImgList<float>*> lists(4, nullptr);
+        std::vector<std::thread> readers;
+        for(std::size_t i=0; i<lists.size(); ++i)
+            readers.emplace_back([&constImage, &lists, i]() { lists[i] = &constImage.getCImgList(); });
+        for(auto& reader : readers) reader.join();
+        for(const auto* list : lists) EXPECT_EQ(list, lists[0]);
+        EXPECT_TRUE(*lists[0] == img);
+        EXPECT_TRUE(image.isTiled());
+    }
+};
+
+TEST_F(TiledImage_test, bricksInLargeCache)
+{
+    testBricks(1<<20);
+}
+
+TEST_F(TiledImage_test, bricksInSmallCache)
+{
+    testBricks(0);
+}
+
+TEST_F(TiledImage_test, copyOnWrite)
+{
+    testCopyOnWrite();
+}
+
+TEST_F(TiledImage_test, scopedAccess)
+{
+    testScopedAccess();
+}
+
+TEST_F(TiledImage_test, fileLifetime)
+{
+    const std::string filename = (std::filesystem::temp_directory_path() / "sofa_TiledImage_test.raw").string();
+    std::filesystem::remove(filename);
+    {
+        const auto tiles = TiledStorage::fromCImgList(img, 4, 0, filename);
+        ASSERT_NE(tiles, nullptr);
+        EXPECT_TRUE(std::filesystem::exists(filename));
+
+        // an existing file is not overwritten
+        {
+            EXPECT_MSG_EMIT(Error);
+            EXPECT_EQ(TiledStorage::fromCImgList(img, 4, 0, filename), nullptr);
+        }
+        EXPECT_EQ(tiles->at(3,2,1,1,1), img(1)(3,2,1,1));
+    }
+    // the file is removed with the storage
+    EXPECT_FALSE(std::filesystem::exists(filename));
+}
+
+}// namespace sofa
@@ -0,0 +1,198 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include "BenchmarkScenes.h"
+
+#include <sofa/simpleapi/SimpleApi.h>
+#include <sofa/simulation/MainTaskSchedulerFactory.h>
+#include <sofa/simulation/TaskScheduler.h>
+#include <sofa/simulation/graph/DAGSimulation.h>
+
+namespace sofa::benchmarks
+{
+
+void applyDefaultArguments(benchmark::internal::Benchmark* b, const std::vector<int64_t>& sizes)
+{
+    b->ArgsProduct({ sizes, defaultThreadCounts })->ArgNames({ "n", "threads" })->Unit(benchmark::kMicrosecond);
+}
+
+void setNumberOfThreads(int64_t nbThreads)
+{
+    simulation::TaskScheduler* taskScheduler = simulation::MainTaskSchedulerFactory::createInRegistry();
+    if (taskScheduler->getThreadCount() != static_cast<unsigned int>(nbThreads))
+    {
+        taskScheduler->init(static_cast<unsigned int>(nbThreads));
+    }
+}
+
+simulation::Node::SPtr createRoot()
+{
+    static const bool componentsLoaded = sofa::simpleapi::importPlugin("Sofa.Component");
+    SOFA_UNUSED(componentsLoaded);
+
+    simulation::Node::SPtr root = sofa::simulation::getSimulation()->createNewGraph("root");
+    root->setGravity({ 0, 0, 0 });
+    root->setDt(0.01);
+    sofa::simpleapi::createObject(root, "DefaultAnimationLoop");
+    sofa::simpleapi::createObject(root, "DefaultVisualManagerLoop");
+    return root;
+}
+
+namespace
+{
+std::string gridResolution(int64_t n)
+{
+    return sofa::simpleapi::str(n) + " " + sofa::simpleapi::str(n) + " " + sofa::simpleapi::str(2 * n);
+}
+}
+
+simulation::Node::SPtr addTetrahedralBeam(simulation::Node::SPtr parent, const std::string& name, int64_t n)
+{
+    const simulation::Node::SPtr beam = sofa::simpleapi::createChild(parent, name);
+    sofa::simpleapi::createObject(beam, "RegularGridTopology", {
+        {"name", "grid"}, {"n", gridResolution(n)}, {"min", "0 0 0"}, {"max", "1 1 2"} });
+
+    const simulation::Node::SPtr tetra = sofa::simpleapi::createChild(beam, "Tetrahedra");
+    sofa::simpleapi::createObject(tetra, "MechanicalObject", { {"name", "dofs"}, {"template", "Vec3"}, {"position", "@../grid.position"} });
+    sofa::simpleapi::createObject(tetra, "TetrahedronSetTopologyContainer", { {"name", "topology"} });
+    sofa::simpleapi::createObject(tetra, "TetrahedronSetTopologyModifier");
+    sofa::simpleapi::createObject(tetra, "TetrahedronSetGeometryAlgorithms", { {"template", "Vec3"} });
+    sofa::simpleapi::createObject(tetra, "Hexa2TetraTopologicalMapping", { {"input", "@../grid"}, {"output", "@topology"} });
+    return tetra;
+}
+
+simulation::Node::SPtr addHexahedralBeam(simulation::Node::SPtr parent, const std::string& name, int64_t n)
+{
+    const simulation::Node::SPtr beam = sofa::simpleapi::createChild(parent, name);
+    sofa::simpleapi::createObject(beam, "RegularGridTopology", {
+        {"name", "grid"}, {"n", gridResolution(n)}, {"min", "0 0 0"}, {"max", "1 1 2"} });
+    sofa::simpleapi::createObject(beam, "MechanicalObject", { {"name", "dofs"}, {"template", "Vec3"} });
+    return beam;
+}
+
+simulation::Node::SPtr addCollisionSheet(simulation::Node::SPtr parent, const std::string& name, int64_t n, SReal z)
+{
+    const simulation::Node::SPtr sheet = sofa::simpleapi::createChild(parent, name);
+    const std::string height = sofa::simpleapi::str(z);
+    sofa::simpleapi::createObject(sheet, "RegularGridTopology", {
+        {"name", "grid"}, {"n", sofa::simpleapi::str(n) + " " + sofa::simpleapi::str(n) + " 1"},
+        {"min", "0 0 " + height}, {"max", "1 1 " + height} });
+    sofa::simpleapi::createObject(sheet, "MechanicalObject", { {"name", "dofs"}, {"template", "Vec3"} });
+    sofa::simpleapi::createObject(sheet, "TriangleCollisionModel");
+    sofa::simpleapi::createObject(sheet, "LineCollisionModel");
+    sofa::simpleapi::createObject(sheet, "PointCollisionModel");
+    return sheet;
+}
+
+void perturbVector(core::behavior::BaseMechanicalState* state, core::VecId v, SReal amplitude, std::mt19937& generator)
+{
+    std::uniform_real_distribution<SReal> distribution(-amplitude, amplitude);
+    std::vector<SReal> buffer(state->getMatrixSize());
+    state->copyToBuffer(buffer.data(), core::ConstVecId(v), static_cast<unsigned int>(buffer.size()));
+    for (auto& value : buffer)
+    {
+        value += distribution(generator);
+    }
+    state->copyFromBuffer(v, buffer.data(), static_cast<unsigned int>(buffer.size()));
+}
+
+void randomizeVector(core::behavior::BaseMechanicalState* state, core::VecDerivId v, SReal amplitude, std::mt19937& generator)
+{
+    state->vRealloc(core::execparams::defaultInstance(), v);
+
+    std::uniform_real_distribution<SReal> distribution(-amplitude, amplitude);
+    std::vector<SReal> buffer(state->getMatrixSize());
+    for (auto& value : buffer)
+    {
+        value = distribution(generator);
+    }
+    state->copyFromBuffer(v, buffer.data(), static_cast<unsigned int>(buffer.size()));
+}
+
+namespace
+{
+/// Visit the couples (i, j) of connected nodes of the 7-point stencil, with their stiffness
+template<class Callable>
+void forEachStencilEdge(int64_t n, Callable&& callable)
+{
+    const auto index = [n](int64_t x, int64_t y, int64_t z) { return x + n * (y + n * z); };
+    for (int64_t z = 0; z < n; ++z)
+    {
+        for (int64_t y = 0; y < n; ++y)
+        {
+            for (int64_t x = 0; x < n; ++x)
+            {
+                const auto i = index(x, y, z);
+                // the stiffness varies deterministically to avoid a trivially uniform matrix
+                const SReal k = 1 + 0.1 * static_cast<SReal>(i % 7);
+                if (x + 1 < n) callable(i, index(x + 1, y, z), k);
+                if (y + 1 < n) callable(i, index(x, y + 1, z), k);
+                if (z + 1 < n) callable(i, index(x, y, z + 1), k);
+            }
+        }
+    }
+}
+}
+
+void assembleGridStiffness(linearalgebra::CompressedRowSparseMatrix<type::Mat3x3>& matrix, int64_t n)
+{
+    const auto nbNodes = static_cast<linearalgebra::BaseMatrix::Index>(n * n * n);
+    matrix.resizeBlock(nbNodes, nbNodes);
+
+    for (linearalgebra::BaseMatrix::Index i = 0; i < nbNodes; ++i)
+    {
+        matrix.addBlock(i, i, type::Mat3x3::Identity());
+    }
+    forEachStencilEdge(n, [&matrix](int64_t i, int64_t j, SReal k)
+    {
+        type::Mat3x3 block = type::Mat3x3::Identity() * k;
+        block[0][1] = block[1][0] = 0.1 * k;
+        matrix.addBlock(i, i, block);
+        matrix.addBlock(j, j, block);
+        matrix.addBlock(i, j, -block);
+        matrix.addBlock(j, i, -block);
+    });
+    matrix.compress();
+}
+
+void assembleGridStiffness(linearalgebra::CompressedRowSparseMatrix<SReal>& matrix, int64_t n)
+{
+    const auto nbNodes = static_cast<linearalgebra::BaseMatrix::Index>(n * n * n);
+    matrix.resize(3 * nbNodes, 3 * nbNodes);
+
+    for (linearalgebra::BaseMatrix::Index i = 0; i < 3 * nbNodes; ++i)
+    {
+        matrix.add(i, i, 1.);
+    }
+    forEachStencilEdge(n, [&matrix](int64_t i, int64_t j, SReal k)
+    {
+        for (int d = 0; d < 3; ++d)
+        {
+            matrix.add(3 * i + d, 3 * i + d, k);
+            matrix.add(3 * j + d, 3 * j + d, k);
+            matrix.add(3 * i + d, 3 * j + d, -k);
+            matrix.add(3 * j + d, 3 * i + d, -k);
+        }
+    });
+    matrix.compress();
+}
+
+} // namespace sofa::benchmarks
@@ -0,0 +1,81 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+
+#include <sofa/simulation/Node.h>
+#include <sofa/core/behavior/BaseMechanicalState.h>
+#include <sofa/linearalgebra/CompressedRowSparseMatrix.h>
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <string>
+
+/// Generation of the deterministic inputs shared by all the benchmarks.
+///
+/// Each benchmark is parameterized by a problem size (the number of grid nodes along one
+/// axis, or a number of constraints) and a number of threads used to initialize the main
+/// task scheduler. All the pseudo-random values are drawn from a generator seeded with
+/// randomSeed, so that two runs of the same binary work on the exact same inputs.
+namespace sofa::benchmarks
+{
+
+inline constexpr std::mt19937::result_type randomSeed = 20240601;
+
+/// Sizes and thread counts used by default by the benchmarks
+inline const std::vector<int64_t> defaultGridSizes { 4, 8, 16 };
+inline const std::vector<int64_t> defaultThreadCounts { 1, 4 };
+
+/// Register the default {size, threads} argument product on a benchmark
+void applyDefaultArguments(benchmark::internal::Benchmark* b, const std::vector<int64_t>& sizes = defaultGridSizes);
+
+/// (Re)initialize the main task scheduler with the given number of threads
+void setNumberOfThreads(int64_t nbThreads);
+
+/// Create a root node with the animation and visual loops, all the SOFA components being loaded
+simulation::Node::SPtr createRoot();
+
+/// Add to @p parent a beam of n x n x 2n grid nodes, discretized in tetrahedra.
+/// Returns the node containing the tetrahedral topology and its MechanicalObject.
+simulation::Node::SPtr addTetrahedralBeam(simulation::Node::SPtr parent, const std::string& name, int64_t n);
+
+/// Add to @p parent a beam of n x n x 2n grid nodes, discretized in hexahedra.
+/// Returns the node containing the grid topology and its MechanicalObject.
+simulation::Node::SPtr addHexahedralBeam(simulation::Node::SPtr parent, const std::string& name, int64_t n);
+
+/// Add to @p parent a square sheet of n x n triangulated grid nodes at height @p z, with
+/// triangle, line and point collision models.
+simulation::Node::SPtr addCollisionSheet(simulation::Node::SPtr parent, const std::string& name, int64_t n, SReal z);
+
+/// Add to each scalar of the vector @p v of @p state a uniform random value in [-amplitude, amplitude]
+void perturbVector(core::behavior::BaseMechanicalState* state, core::VecId v, SReal amplitude, std::mt19937& generator);
+
+/// Fill the vector @p v of @p state with uniform random values in [-amplitude, amplitude].
+/// The vector is allocated if needed.
+void randomizeVector(core::behavior::BaseMechanicalState* state, core::VecDerivId v, SReal amplitude, std::mt19937& generator);
+
+/// Assemble the 7-point stencil stiffness of a n x n x n grid of 3D nodes: a sparse symmetric
+/// positive definite matrix with a structure similar to an assembled FEM stiffness matrix.
+void assembleGridStiffness(linearalgebra::CompressedRowSparseMatrix<type::Mat3x3>& matrix, int64_t n);
+void assembleGridStiffness(linearalgebra::CompressedRowSparseMatrix<SReal>& matrix, int64_t n);
+
+} // namespace sofa::benchmarks
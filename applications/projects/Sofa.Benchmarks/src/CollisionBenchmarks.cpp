@@ -0,0 +1,78 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include "BenchmarkScenes.h"
+
+#include <sofa/core/collision/Pipeline.h>
+#include <sofa/simpleapi/SimpleApi.h>
+
+namespace sofa::benchmarks
+{
+
+namespace
+{
+
+/// Time the collision detection (broad and narrow phases) between two close triangulated
+/// sheets of n x n nodes, using the given narrow phase component
+void CollisionDetection(benchmark::State& state, const std::string& narrowPhase)
+{
+    setNumberOfThreads(state.range(1));
+    std::mt19937 generator(randomSeed);
+
+    const auto n = state.range(0);
+    const auto root = createRoot();
+    sofa::simpleapi::createObject(root, "CollisionPipeline");
+    sofa::simpleapi::createObject(root, "BruteForceBroadPhase");
+    sofa::simpleapi::createObject(root, narrowPhase);
+    sofa::simpleapi::createObject(root, "MinProximityIntersection", { {"alarmDistance", "0.1"}, {"contactDistance", "0.02"} });
+    sofa::simpleapi::createObject(root, "CollisionResponse");
+
+    addCollisionSheet(root, "Lower", n, 0);
+    const auto upper = addCollisionSheet(root, "Upper", n, 0.05);
+    sofa::simulation::node::initRoot(root.get());
+
+    auto* pipeline = root->getTreeObject<core::collision::Pipeline>();
+    if (!pipeline)
+    {
+        state.SkipWithError("Failed to create the scene");
+        return;
+    }
+
+    // the upper sheet is wrinkled so that the proximities are not all identical
+    perturbVector(upper->getMechanicalState(), core::vec_id::write_access::position, 0.02, generator);
+
+    for (auto _ : state)
+    {
+        pipeline->computeCollisionReset();
+        pipeline->computeCollisionDetection();
+    }
+
+    state.counters["triangles"] = static_cast<double>(2 * 2 * (n - 1) * (n - 1));
+
+    sofa::simulation::node::unload(root);
+}
+
+} // anonymous namespace
+
+BENCHMARK_CAPTURE(CollisionDetection, BVHNarrowPhase, std::string("BVHNarrowPhase"))->Apply([](auto* b) { applyDefaultArguments(b, { 8, 16, 32 }); });
+BENCHMARK_CAPTURE(CollisionDetection, DirectSAPNarrowPhase, std::string("DirectSAPNarrowPhase"))->Apply([](auto* b) { applyDefaultArguments(b, { 8, 16, 32 }); });
+
+} // namespace sofa::benchmarks
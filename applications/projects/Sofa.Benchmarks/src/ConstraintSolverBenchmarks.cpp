@@ -0,0 +1,126 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include "BenchmarkScenes.h"
+
+#include <sofa/component/constraint/lagrangian/model/UnilateralConstraintResolution.h>
+#include <sofa/component/constraint/lagrangian/solver/GenericConstraintProblem.h>
+#include <sofa/component/constraint/lagrangian/solver/GenericConstraintSolver.h>
+
+namespace sofa::benchmarks
+{
+
+namespace
+{
+
+using component::constraint::lagrangian::solver::GenericConstraintProblem;
+using component::constraint::lagrangian::solver::GenericConstraintSolver;
+
+/// Number of constraints used by the constraint solver benchmarks
+const std::vector<int64_t> constraintSizes { 64, 256, 1024 };
+
+/// Fill @p problem with n unilateral constraints: a symmetric diagonally dominant banded
+/// compliance matrix and violated free interpenetrations
+void buildUnilateralProblem(GenericConstraintProblem& problem, int64_t n, std::mt19937& generator)
+{
+    static constexpr int64_t bandwidth = 16;
+
+    problem.clear(static_cast<int>(n));
+    problem.W.clear();
+
+    std::uniform_real_distribution<SReal> coupling(-0.1, 0.1);
+    std::uniform_real_distribution<SReal> interpenetration(-0.01, 0.001);
+    for (int64_t i = 0; i < n; ++i)
+    {
+        for (int64_t j = std::max<int64_t>(0, i - bandwidth); j < i; ++j)
+        {
+            const SReal w = coupling(generator);
+            problem.W.set(i, j, w);
+            problem.W.set(j, i, w);
+        }
+    }
+
+    for (int64_t i = 0; i < n; ++i)
+    {
+        SReal diagonal = 1;
+        for (int64_t j = std::max<int64_t>(0, i - bandwidth); j < std::min<int64_t>(n, i + bandwidth + 1); ++j)
+        {
+            if (j != i)
+            {
+                diagonal += std::abs(problem.W.element(i, j));
+            }
+        }
+        problem.W.set(i, i, diagonal);
+        problem.dFree.set(i, interpenetration(generator));
+        problem.constraintsResolutions[i] = new component::constraint::lagrangian::model::UnilateralConstraintResolution();
+    }
+}
+
+enum class ConstraintAlgorithm { GaussSeidel, NNCG };
+
+void runConstraintProblem(benchmark::State& state, ConstraintAlgorithm algorithm)
+{
+    setNumberOfThreads(state.range(1));
+    std::mt19937 generator(randomSeed);
+
+    const GenericConstraintSolver::SPtr solver = core::objectmodel::New<GenericConstraintSolver>();
+
+    GenericConstraintProblem problem;
+    buildUnilateralProblem(problem, state.range(0), generator);
+    problem.tolerance = 1e-10;
+    problem.maxIterations = 100;
+
+    int iterations = 0;
+    for (auto _ : state)
+    {
+        problem.f.clear();
+        if (algorithm == ConstraintAlgorithm::GaussSeidel)
+        {
+            problem.gaussSeidel(0, solver.get());
+        }
+        else
+        {
+            problem.NNCG(solver.get());
+        }
+        iterations = problem.currentIterations;
+        benchmark::DoNotOptimize(problem.getF());
+    }
+
+    state.counters["iterations"] = iterations;
+    state.counters["error"] = problem.currentError;
+}
+
+void GenericConstraintProblem_gaussSeidel(benchmark::State& state)
+{
+    runConstraintProblem(state, ConstraintAlgorithm::GaussSeidel);
+}
+
+void GenericConstraintProblem_NNCG(benchmark::State& state)
+{
+    runConstraintProblem(state, ConstraintAlgorithm::NNCG);
+}
+
+} // anonymous namespace
+
+BENCHMARK(GenericConstraintProblem_gaussSeidel)->Apply([](auto* b) { applyDefaultArguments(b, constraintSizes); });
+BENCHMARK(GenericConstraintProblem_NNCG)->Apply([](auto* b) { applyDefaultArguments(b, constraintSizes); });
+
+} // namespace sofa::benchmarks
@@ -0,0 +1,129 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include "BenchmarkScenes.h"
+
+#include <sofa/core/behavior/BaseForceField.h>
+#include <sofa/core/MechanicalParams.h>
+#include <sofa/core/topology/BaseMeshTopology.h>
+#include <sofa/simpleapi/SimpleApi.h>
+
+namespace sofa::benchmarks
+{
+
+namespace
+{
+
+enum class ForceFieldKernel { AddForce, AddDForce };
+
+/// Time addForce or addDForce of the force field @p className on a beam made of tetrahedra or hexahedra.
+/// The rest shape is perturbed so that the corotational methods compute non-trivial rotations.
+void runForceField(benchmark::State& state, const std::string& className, const std::string& method,
+                   bool tetrahedra, ForceFieldKernel kernel)
+{
+    setNumberOfThreads(state.range(1));
+    std::mt19937 generator(randomSeed);
+
+    const auto root = createRoot();
+    const auto node = tetrahedra ? addTetrahedralBeam(root, "Beam", state.range(0))
+                                 : addHexahedralBeam(root, "Beam", state.range(0));
+    sofa::simpleapi::createObject(node, className, {
+        {"method", method}, {"youngModulus", "1e4"}, {"poissonRatio", "0.3"} });
+    sofa::simulation::node::initRoot(root.get());
+
+    auto* mstate = node->getMechanicalState();
+    auto* forceField = node->getTreeObject<core::behavior::BaseForceField>();
+    auto* topology = node->getMeshTopology();
+    if (!mstate || !forceField || !topology)
+    {
+        state.SkipWithError("Failed to create the scene");
+        return;
+    }
+
+    perturbVector(mstate, core::vec_id::write_access::position, 0.05, generator);
+
+    core::MechanicalParams mparams;
+    mparams.setKFactor(1.0);
+    mparams.setDx(core::vec_id::read_access::dx);
+    randomizeVector(mstate, core::vec_id::write_access::dx, 0.01, generator);
+    mstate->vRealloc(&mparams, core::vec_id::write_access::dforce);
+
+    // a first call performs the lazy initializations (rotations, stiffness matrices)
+    forceField->addForce(&mparams, core::vec_id::write_access::force);
+
+    for (auto _ : state)
+    {
+        if (kernel == ForceFieldKernel::AddForce)
+        {
+            forceField->addForce(&mparams, core::vec_id::write_access::force);
+        }
+        else
+        {
+            forceField->addDForce(&mparams, core::vec_id::write_access::dforce);
+        }
+    }
+
+    const auto nbElements = tetrahedra ? topology->getNbTetrahedra() : topology->getNbHexahedra();
+    state.SetItemsProcessed(state.iterations() * nbElements);
+    state.counters["elements"] = nbElements;
+
+    sofa::simulation::node::unload(root);
+}
+
+void TetrahedronFEMForceField_addForce(benchmark::State& state, const std::string& method)
+{
+    runForceField(state, "TetrahedronFEMForceField", method, true, ForceFieldKernel::AddForce);
+}
+
+void TetrahedronFEMForceField_addDForce(benchmark::State& state, const std::string& method)
+{
+    runForceField(state, "TetrahedronFEMForceField", method, true, ForceFieldKernel::AddDForce);
+}
+
+void HexahedronFEMForceField_addForce(benchmark::State& state, const std::string& method)
+{
+    runForceField(state, "HexahedronFEMForceField", method, false, ForceFieldKernel::AddForce);
+}
+
+void HexahedronFEMForceField_addDForce(benchmark::State& state, const std::string& method)
+{
+    runForceField(state, "HexahedronFEMForceField", method, false, ForceFieldKernel::AddDForce);
+}
+
+} // anonymous namespace
+
+BENCHMARK_CAPTURE(TetrahedronFEMForceField_addForce, small, std::string("small"))->Apply([](auto* b) { applyDefaultArguments(b); });
+BENCHMARK_CAPTURE(TetrahedronFEMForceField_addForce, large, std::string("large"))->Apply([](auto* b) { applyDefaultArguments(b); });
+BENCHMARK_CAPTURE(TetrahedronFEMForceField_addForce, polar, std::string("polar"))->Apply([](auto* b) { applyDefaultArguments(b); });
+BENCHMARK_CAPTURE(TetrahedronFEMForceField_addForce, svd, std::string("svd"))->Apply([](auto* b) { applyDefaultArguments(b); });
+
+BENCHMARK_CAPTURE(TetrahedronFEMForceField_addDForce, small, std::string("small"))->Apply([](auto* b) { applyDefaultArguments(b); });
+BENCHMARK_CAPTURE(TetrahedronFEMForceField_addDForce, large, std::string("large"))->Apply([](auto* b) { applyDefaultArguments(b); });
+BENCHMARK_CAPTURE(TetrahedronFEMForceField_addDForce, polar, std::string("polar"))->Apply([](auto* b) { applyDefaultArguments(b); });
+BENCHMARK_CAPTURE(TetrahedronFEMForceField_addDForce, svd, std::string("svd"))->Apply([](auto* b) { applyDefaultArguments(b); });
+
+BENCHMARK_CAPTURE(HexahedronFEMForceField_addForce, large, std::string("large"))->Apply([](auto* b) { applyDefaultArguments(b); });
+BENCHMARK_CAPTURE(HexahedronFEMForceField_addForce, polar, std::string("polar"))->Apply([](auto* b) { applyDefaultArguments(b); });
+
+BENCHMARK_CAPTURE(HexahedronFEMForceField_addDForce, large, std::string("large"))->Apply([](auto* b) { applyDefaultArguments(b); });
+BENCHMARK_CAPTURE(HexahedronFEMForceField_addDForce, polar, std::string("polar"))->Apply([](auto* b) { applyDefaultArguments(b); });
+
+} // namespace sofa::benchmarks
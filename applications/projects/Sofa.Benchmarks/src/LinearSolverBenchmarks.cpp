@@ -0,0 +1,137 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include "BenchmarkScenes.h"
+
+#include <sofa/component/linearsolver/direct/SparseLDLSolver.h>
+#include <sofa/component/linearsolver/iterative/CGLinearSolver.h>
+#include <sofa/linearalgebra/FullVector.h>
+
+namespace sofa::benchmarks
+{
+
+namespace
+{
+
+using ScalarMatrix = linearalgebra::CompressedRowSparseMatrix<SReal>;
+using BlockMatrix = linearalgebra::CompressedRowSparseMatrix<type::Mat3x3>;
+using Vector = linearalgebra::FullVector<SReal>;
+
+void fillRandom(Vector& v, linearalgebra::BaseMatrix::Index size, std::mt19937& generator)
+{
+    std::uniform_real_distribution<SReal> distribution(-1, 1);
+    v.resize(size);
+    for (linearalgebra::BaseMatrix::Index i = 0; i < size; ++i)
+    {
+        v[i] = distribution(generator);
+    }
+}
+
+/// Numerical factorization of a grid stiffness matrix (the symbolic factorization is reused between iterations)
+void SparseLDLSolver_invert(benchmark::State& state)
+{
+    setNumberOfThreads(state.range(1));
+
+    ScalarMatrix matrix;
+    assembleGridStiffness(matrix, state.range(0));
+
+    using Solver = component::linearsolver::direct::SparseLDLSolver<ScalarMatrix, Vector>;
+    const Solver::SPtr solver = core::objectmodel::New<Solver>();
+    solver->init();
+
+    for (auto _ : state)
+    {
+        solver->invert(matrix);
+    }
+
+    state.SetItemsProcessed(state.iterations() * matrix.rowSize());
+    state.counters["rows"] = static_cast<double>(matrix.rowSize());
+    state.counters["nnz"] = static_cast<double>(matrix.colsValue.size());
+}
+
+/// Forward and backward substitutions with a factorized grid stiffness matrix
+void SparseLDLSolver_solve(benchmark::State& state)
+{
+    setNumberOfThreads(state.range(1));
+    std::mt19937 generator(randomSeed);
+
+    ScalarMatrix matrix;
+    assembleGridStiffness(matrix, state.range(0));
+
+    using Solver = component::linearsolver::direct::SparseLDLSolver<ScalarMatrix, Vector>;
+    const Solver::SPtr solver = core::objectmodel::New<Solver>();
+    solver->init();
+    solver->invert(matrix);
+
+    Vector x, b;
+    fillRandom(b, matrix.rowSize(), generator);
+    x.resize(matrix.rowSize());
+
+    for (auto _ : state)
+    {
+        solver->solve(matrix, x, b);
+        benchmark::DoNotOptimize(x.ptr());
+    }
+
+    state.SetItemsProcessed(state.iterations() * matrix.rowSize());
+    state.counters["rows"] = static_cast<double>(matrix.rowSize());
+}
+
+/// A fixed number of conjugate gradient iterations on a block grid stiffness matrix
+void CGLinearSolver_solve(benchmark::State& state)
+{
+    static constexpr unsigned int nbIterations = 25;
+
+    setNumberOfThreads(state.range(1));
+    std::mt19937 generator(randomSeed);
+
+    BlockMatrix matrix;
+    assembleGridStiffness(matrix, state.range(0));
+
+    using Solver = component::linearsolver::iterative::CGLinearSolver<BlockMatrix, Vector>;
+    const Solver::SPtr solver = core::objectmodel::New<Solver>();
+    solver->d_maxIter.setValue(nbIterations);
+    // the tolerances are set to zero so that all the iterations are always performed
+    solver->d_tolerance.setValue(0);
+    solver->d_smallDenominatorThreshold.setValue(0);
+    solver->init();
+
+    Vector x, b;
+    fillRandom(b, matrix.rowSize(), generator);
+    x.resize(matrix.rowSize());
+
+    for (auto _ : state)
+    {
+        solver->solve(matrix, x, b);
+        benchmark::DoNotOptimize(x.ptr());
+    }
+
+    state.SetItemsProcessed(state.iterations() * nbIterations);
+    state.counters["rows"] = static_cast<double>(matrix.rowSize());
+}
+
+} // anonymous namespace
+
+BENCHMARK(SparseLDLSolver_invert)->Apply([](auto* b) { applyDefaultArguments(b); });
+BENCHMARK(SparseLDLSolver_solve)->Apply([](auto* b) { applyDefaultArguments(b); });
+BENCHMARK(CGLinearSolver_solve)->Apply([](auto* b) { applyDefaultArguments(b); });
+
+} // namespace sofa::benchmarks
@@ -0,0 +1,111 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include "BenchmarkScenes.h"
+
+#include <sofa/core/BaseMapping.h>
+#include <sofa/core/MechanicalParams.h>
+#include <sofa/simpleapi/SimpleApi.h>
+
+#include <sstream>
+
+namespace sofa::benchmarks
+{
+
+namespace
+{
+
+enum class MappingKernel { Apply, ApplyJT };
+
+/// Time apply or applyJT of a BarycentricMapping embedding random points (8 per grid node)
+/// in a tetrahedral or hexahedral beam
+void runBarycentricMapping(benchmark::State& state, bool tetrahedra, MappingKernel kernel)
+{
+    setNumberOfThreads(state.range(1));
+    std::mt19937 generator(randomSeed);
+
+    const auto n = state.range(0);
+    const auto root = createRoot();
+    const auto node = tetrahedra ? addTetrahedralBeam(root, "Beam", n) : addHexahedralBeam(root, "Beam", n);
+
+    const auto nbEmbeddedPoints = 8 * n * n * 2 * n;
+    std::uniform_real_distribution<SReal> distribution(0.01, 0.99);
+    std::ostringstream positions;
+    for (int64_t i = 0; i < nbEmbeddedPoints; ++i)
+    {
+        positions << distribution(generator) << ' ' << distribution(generator) << ' ' << 2 * distribution(generator) << ' ';
+    }
+
+    const auto embedded = sofa::simpleapi::createChild(node, "Embedded");
+    sofa::simpleapi::createObject(embedded, "MechanicalObject", {
+        {"name", "points"}, {"template", "Vec3"}, {"position", positions.str()} });
+    sofa::simpleapi::createObject(embedded, "BarycentricMapping", { {"input", "@../dofs"}, {"output", "@points"} });
+    sofa::simulation::node::initRoot(root.get());
+
+    auto* mapping = embedded->mechanicalMapping.get();
+    auto* parentState = node->getMechanicalState();
+    auto* childState = embedded->getMechanicalState();
+    if (!mapping || !parentState || !childState)
+    {
+        state.SkipWithError("Failed to create the scene");
+        return;
+    }
+
+    perturbVector(parentState, core::vec_id::write_access::position, 0.05, generator);
+    randomizeVector(childState, core::vec_id::write_access::force, 1.0, generator);
+
+    core::MechanicalParams mparams;
+    for (auto _ : state)
+    {
+        if (kernel == MappingKernel::Apply)
+        {
+            mapping->apply(&mparams, core::vec_id::write_access::position, core::vec_id::read_access::position);
+        }
+        else
+        {
+            mapping->applyJT(&mparams, core::vec_id::write_access::force, core::vec_id::read_access::force);
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * nbEmbeddedPoints);
+    state.counters["points"] = static_cast<double>(nbEmbeddedPoints);
+
+    sofa::simulation::node::unload(root);
+}
+
+void BarycentricMapping_apply(benchmark::State& state, bool tetrahedra)
+{
+    runBarycentricMapping(state, tetrahedra, MappingKernel::Apply);
+}
+
+void BarycentricMapping_applyJT(benchmark::State& state, bool tetrahedra)
+{
+    runBarycentricMapping(state, tetrahedra, MappingKernel::ApplyJT);
+}
+
+} // anonymous namespace
+
+BENCHMARK_CAPTURE(BarycentricMapping_apply, tetrahedra, true)->Apply([](auto* b) { applyDefaultArguments(b); });
+BENCHMARK_CAPTURE(BarycentricMapping_apply, grid, false)->Apply([](auto* b) { applyDefaultArguments(b); });
+BENCHMARK_CAPTURE(BarycentricMapping_applyJT, tetrahedra, true)->Apply([](auto* b) { applyDefaultArguments(b); });
+BENCHMARK_CAPTURE(BarycentricMapping_applyJT, grid, false)->Apply([](auto* b) { applyDefaultArguments(b); });
+
+} // namespace sofa::benchmarks
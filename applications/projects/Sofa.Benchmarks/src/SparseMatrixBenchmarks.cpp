@@ -0,0 +1,146 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include "BenchmarkScenes.h"
+
+#include <sofa/linearalgebra/FullVector.h>
+#include <sofa/simulation/MainTaskSchedulerFactory.h>
+#include <sofa/simulation/ParallelSparseMatrixProduct.h>
+
+#include <Eigen/Sparse>
+
+namespace sofa::benchmarks
+{
+
+namespace
+{
+
+using ScalarMatrix = linearalgebra::CompressedRowSparseMatrix<SReal>;
+using BlockMatrix = linearalgebra::CompressedRowSparseMatrix<type::Mat3x3>;
+using Vector = linearalgebra::FullVector<SReal>;
+using EigenMatrix = Eigen::SparseMatrix<SReal, Eigen::RowMajor>;
+
+EigenMatrix toEigen(const ScalarMatrix& matrix)
+{
+    std::vector<Eigen::Triplet<SReal> > triplets;
+    triplets.reserve(matrix.colsValue.size());
+    for (std::size_t r = 0; r < matrix.rowIndex.size(); ++r)
+    {
+        for (auto i = matrix.rowBegin[r]; i < matrix.rowBegin[r + 1]; ++i)
+        {
+            triplets.emplace_back(matrix.rowIndex[r], matrix.colsIndex[i], matrix.colsValue[i]);
+        }
+    }
+    EigenMatrix eigenMatrix(matrix.rowSize(), matrix.colSize());
+    eigenMatrix.setFromTriplets(triplets.begin(), triplets.end());
+    return eigenMatrix;
+}
+
+/// Sparse matrix-vector product with 3x3 blocks
+void CompressedRowSparseMatrix_mulVector(benchmark::State& state)
+{
+    setNumberOfThreads(state.range(1));
+    std::mt19937 generator(randomSeed);
+
+    BlockMatrix matrix;
+    assembleGridStiffness(matrix, state.range(0));
+
+    std::uniform_real_distribution<SReal> distribution(-1, 1);
+    Vector v(matrix.colSize()), result(matrix.rowSize());
+    for (linearalgebra::BaseMatrix::Index i = 0; i < v.size(); ++i)
+    {
+        v[i] = distribution(generator);
+    }
+
+    for (auto _ : state)
+    {
+        matrix.mul(result, v);
+        benchmark::DoNotOptimize(result.ptr());
+    }
+
+    state.SetItemsProcessed(state.iterations() * matrix.colsValue.size());
+    state.counters["blocks"] = static_cast<double>(matrix.colsValue.size());
+}
+
+/// Sparse matrix-matrix product of the scalar CRS format (symbolic and numeric phases)
+void CompressedRowSparseMatrix_mulMatrix(benchmark::State& state)
+{
+    setNumberOfThreads(state.range(1));
+
+    ScalarMatrix matrix;
+    assembleGridStiffness(matrix, state.range(0));
+
+    for (auto _ : state)
+    {
+        ScalarMatrix result;
+        matrix.mul(result, matrix);
+        benchmark::DoNotOptimize(result.colsValue.data());
+    }
+
+    state.counters["nnz"] = static_cast<double>(matrix.colsValue.size());
+}
+
+/// Numeric phase of the Eigen-based sparse matrix-matrix product, the intersection being
+/// computed once before the timing loop as it is done in the linear systems
+template<class Product>
+void runSparseMatrixProduct(benchmark::State& state, Product& product)
+{
+    ScalarMatrix matrix;
+    assembleGridStiffness(matrix, state.range(0));
+    const EigenMatrix eigenMatrix = toEigen(matrix);
+
+    product.m_lhs = &eigenMatrix;
+    product.m_rhs = &eigenMatrix;
+    product.computeProduct();
+
+    for (auto _ : state)
+    {
+        product.computeProduct();
+        benchmark::DoNotOptimize(product.getProductResult().valuePtr());
+    }
+
+    state.SetItemsProcessed(state.iterations() * product.getProductResult().nonZeros());
+    state.counters["nnz"] = static_cast<double>(product.getProductResult().nonZeros());
+}
+
+void SparseMatrixProduct_sequential(benchmark::State& state)
+{
+    setNumberOfThreads(state.range(1));
+    linearalgebra::SparseMatrixProduct<EigenMatrix, EigenMatrix, EigenMatrix> product;
+    runSparseMatrixProduct(state, product);
+}
+
+void SparseMatrixProduct_parallel(benchmark::State& state)
+{
+    setNumberOfThreads(state.range(1));
+    simulation::ParallelSparseMatrixProduct<EigenMatrix, EigenMatrix, EigenMatrix> product;
+    product.taskScheduler = simulation::MainTaskSchedulerFactory::createInRegistry();
+    runSparseMatrixProduct(state, product);
+}
+
+} // anonymous namespace
+
+BENCHMARK(CompressedRowSparseMatrix_mulVector)->Apply([](auto* b) { applyDefaultArguments(b); });
+BENCHMARK(CompressedRowSparseMatrix_mulMatrix)->Apply([](auto* b) { applyDefaultArguments(b); });
+BENCHMARK(SparseMatrixProduct_sequential)->Apply([](auto* b) { applyDefaultArguments(b); });
+BENCHMARK(SparseMatrixProduct_parallel)->Apply([](auto* b) { applyDefaultArguments(b); });
+
+} // namespace sofa::benchmarks
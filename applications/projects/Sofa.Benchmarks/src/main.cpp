@@ -0,0 +1,48 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/component/init.h>
+#include <sofa/simulation/graph/init.h>
+
+#include <benchmark/benchmark.h>
+
+/// Run the benchmarks of the SOFA core kernels.
+///
+/// All the options of Google Benchmark are supported. To track the results over time, export them in JSON:
+///     Sofa.Benchmarks --benchmark_out=results.json --benchmark_out_format=json
+/// A subset of the kernels can be selected with a regular expression:
+///     Sofa.Benchmarks --benchmark_filter=TetrahedronFEMForceField
+int main(int argc, char** argv)
+{
+    sofa::simulation::graph::init();
+    sofa::component::init();
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+    {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+
+    sofa::simulation::graph::cleanup();
+    return 0;
+}
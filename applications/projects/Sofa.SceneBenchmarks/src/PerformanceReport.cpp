@@ -0,0 +1,247 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include "PerformanceReport.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace sofa::scenebenchmarks
+{
+
+using json = sofa::helper::json;
+
+namespace
+{
+
+/// Percentile of sorted samples, linearly interpolated between the closest ranks
+double percentile(const std::vector<double>& sorted, double p)
+{
+    if (sorted.empty())
+    {
+        return 0;
+    }
+    const double rank = p * static_cast<double>(sorted.size() - 1);
+    const auto lower = static_cast<std::size_t>(std::floor(rank));
+    const auto upper = std::min(lower + 1, sorted.size() - 1);
+    const double weight = rank - static_cast<double>(lower);
+    return (1 - weight) * sorted[lower] + weight * sorted[upper];
+}
+
+/// Scale factor converting a median absolute deviation into a standard deviation, for normally distributed samples
+constexpr double madToStandardDeviation = 1.4826;
+
+/// Status of a metric whose lower values are better
+std::string compareMetric(double current, double reference, double tolerance)
+{
+    if (current - reference > tolerance)
+    {
+        return "regression";
+    }
+    if (reference - current > tolerance)
+    {
+        return "improvement";
+    }
+    return "unchanged";
+}
+
+} // anonymous namespace
+
+Statistics computeStatistics(std::vector<double> samples)
+{
+    Statistics statistics;
+    if (samples.empty())
+    {
+        return statistics;
+    }
+
+    std::sort(samples.begin(), samples.end());
+    statistics.count = samples.size();
+    statistics.min = samples.front();
+    statistics.max = samples.back();
+    statistics.mean = std::accumulate(samples.begin(), samples.end(), 0.) / static_cast<double>(samples.size());
+    statistics.median = percentile(samples, 0.5);
+    statistics.p95 = percentile(samples, 0.95);
+
+    std::vector<double> deviations(samples.size());
+    std::transform(samples.begin(), samples.end(), deviations.begin(),
+                   [median = statistics.median](double v) { return std::abs(v - median); });
+    std::sort(deviations.begin(), deviations.end());
+    statistics.mad = percentile(deviations, 0.5);
+
+    return statistics;
+}
+
+json makeReport(const std::vector<SceneMeasures>& measures)
+{
+    json report;
+    report["scenes"] = json::array();
+
+    for (const auto& scene : measures)
+    {
+        json sceneReport;
+        sceneReport["scene"] = scene.scene;
+        sceneReport["success"] = scene.success;
+        sceneReport["steps"] = scene.nbSteps;
+        sceneReport["initDuration"] = scene.initDuration;
+        sceneReport["peakMemory"] = scene.peakMemory;
+        sceneReport["timers"] = json::object();
+
+        for (const auto& [name, samples] : scene.timings)
+        {
+            const Statistics statistics = computeStatistics(samples);
+            sceneReport["timers"][name] = {
+                {"count", statistics.count},
+                {"min", statistics.min},
+                {"max", statistics.max},
+                {"mean", statistics.mean},
+                {"median", statistics.median},
+                {"p95", statistics.p95},
+                {"mad", statistics.mad}
+            };
+        }
+        report["scenes"].push_back(sceneReport);
+    }
+
+    return report;
+}
+
+json compareReports(const json& report, const json& baseline, const ComparisonThresholds& thresholds)
+{
+    json comparison;
+    comparison["scenes"] = json::array();
+    unsigned int nbRegressions = 0;
+
+    const auto findBaselineScene = [&baseline](const std::string& scene) -> const json*
+    {
+        if (!baseline.contains("scenes"))
+        {
+            return nullptr;
+        }
+        for (const auto& s : baseline["scenes"])
+        {
+            if (s.value("scene", "") == scene)
+            {
+                return &s;
+            }
+        }
+        return nullptr;
+    };
+
+    for (const auto& scene : report.value("scenes", json::array()))
+    {
+        const std::string sceneName = scene.value("scene", "");
+        json sceneComparison;
+        sceneComparison["scene"] = sceneName;
+
+        if (!scene.value("success", false))
+        {
+            sceneComparison["status"] = "failed";
+            ++nbRegressions;
+            comparison["scenes"].push_back(sceneComparison);
+            continue;
+        }
+
+        const json* reference = findBaselineScene(sceneName);
+        if (!reference || !reference->value("success", false))
+        {
+            sceneComparison["status"] = "new";
+            comparison["scenes"].push_back(sceneComparison);
+            continue;
+        }
+
+        bool sceneRegressed = false;
+        sceneComparison["timers"] = json::object();
+        const json& referenceTimers = (*reference)["timers"];
+        for (const auto& [name, timer] : scene["timers"].items())
+        {
+            if (!referenceTimers.contains(name))
+            {
+                sceneComparison["timers"][name] = { {"status", "new"} };
+                continue;
+            }
+
+            const json& referenceTimer = referenceTimers[name];
+            const double median = timer.value("median", 0.);
+            const double p95 = timer.value("p95", 0.);
+            const double referenceMedian = referenceTimer.value("median", 0.);
+            const double referenceP95 = referenceTimer.value("p95", 0.);
+            const double noise = thresholds.noiseFactor * madToStandardDeviation
+                * std::max(timer.value("mad", 0.), referenceTimer.value("mad", 0.));
+
+            const std::string medianStatus = compareMetric(median, referenceMedian,
+                std::max({ thresholds.relativeTolerance * referenceMedian, noise, thresholds.minimumDelta }));
+            const std::string p95Status = compareMetric(p95, referenceP95,
+                std::max({ thresholds.p95RelativeTolerance * referenceP95, noise, thresholds.minimumDelta }));
+
+            std::string status = "unchanged";
+            if (medianStatus == "regression" || p95Status == "regression")
+            {
+                status = "regression";
+                sceneRegressed = true;
+                ++nbRegressions;
+            }
+            else if (medianStatus == "improvement")
+            {
+                status = "improvement";
+            }
+
+            sceneComparison["timers"][name] = {
+                {"status", status},
+                {"median", median}, {"baselineMedian", referenceMedian},
+                {"p95", p95}, {"baselineP95", referenceP95}
+            };
+        }
+
+        const auto peakMemory = scene.value("peakMemory", std::size_t{0});
+        const auto referencePeakMemory = reference->value("peakMemory", std::size_t{0});
+        if (peakMemory > 0 && referencePeakMemory > 0)
+        {
+            const std::string memoryStatus = compareMetric(static_cast<double>(peakMemory), static_cast<double>(referencePeakMemory),
+                thresholds.memoryTolerance * static_cast<double>(referencePeakMemory));
+            if (memoryStatus == "regression")
+            {
+                sceneRegressed = true;
+                ++nbRegressions;
+            }
+            sceneComparison["peakMemory"] = {
+                {"status", memoryStatus}, {"value", peakMemory}, {"baseline", referencePeakMemory}
+            };
+        }
+
+        sceneComparison["status"] = sceneRegressed ? "regression" : "unchanged";
+        comparison["scenes"].push_back(sceneComparison);
+    }
+
+    comparison["regressions"] = nbRegressions;
+    comparison["thresholds"] = {
+        {"relativeTolerance", thresholds.relativeTolerance},
+        {"p95RelativeTolerance", thresholds.p95RelativeTolerance},
+        {"noiseFactor", thresholds.noiseFactor},
+        {"minimumDelta", thresholds.minimumDelta},
+        {"memoryTolerance", thresholds.memoryTolerance}
+    };
+
+    return comparison;
+}
+
+} // namespace sofa::scenebenchmarks
@@ -0,0 +1,72 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+
+#include "SceneBenchmark.h"
+
+#include <json.h>
+
+namespace sofa::scenebenchmarks
+{
+
+/// Robust statistics of a series of durations
+struct Statistics
+{
+    std::size_t count { 0 };
+    double min { 0 };
+    double max { 0 };
+    double mean { 0 };
+    double median { 0 };
+    double p95 { 0 };
+    /// Median absolute deviation, a measure of the noise which is not sensitive to the outliers
+    double mad { 0 };
+};
+
+Statistics computeStatistics(std::vector<double> samples);
+
+/// Thresholds deciding if a difference with the baseline is a regression.
+///
+/// A timer regresses if its median (respectively 95th percentile) increases by more than:
+///  - relativeTolerance (respectively p95RelativeTolerance) times the baseline value,
+///  - noiseFactor standard deviations, estimated from the largest median absolute deviation
+///    of the baseline and of the current run,
+///  - minimumDelta milliseconds.
+/// The peak memory regresses if it increases by more than memoryTolerance times the baseline value.
+struct ComparisonThresholds
+{
+    double relativeTolerance { 0.1 };
+    double p95RelativeTolerance { 0.2 };
+    double noiseFactor { 3 };
+    double minimumDelta { 0.05 };
+    double memoryTolerance { 0.1 };
+};
+
+/// Machine-readable report of the measures: for each scene, the statistics of each timer and the peak memory
+sofa::helper::json makeReport(const std::vector<SceneMeasures>& measures);
+
+/// Compare a report to a baseline report (both created by makeReport).
+/// The result lists for each scene the status ("regression", "improvement", "unchanged", "new"
+/// or "failed") of each timer and of the peak memory, and the total number of regressions.
+sofa::helper::json compareReports(const sofa::helper::json& report, const sofa::helper::json& baseline,
+                                  const ComparisonThresholds& thresholds);
+
+} // namespace sofa::scenebenchmarks
@@ -0,0 +1,185 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include "SceneBenchmark.h"
+
+#include <sofa/helper/AdvancedTimer.h>
+#include <sofa/helper/logging/Messaging.h>
+#include <sofa/simulation/Node.h>
+#include <sofa/simulation/Simulation.h>
+
+#include <json.h>
+
+#include <chrono>
+#include <fstream>
+#include <sstream>
+
+namespace sofa::scenebenchmarks
+{
+
+using sofa::helper::AdvancedTimer;
+using json = sofa::helper::json;
+
+namespace
+{
+
+double elapsedMilliseconds(const std::chrono::steady_clock::time_point& start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+void flattenTimer(const json& node, const std::string& path, std::map<std::string, double>& timings)
+{
+    for (const auto& [key, value] : node.items())
+    {
+        if (key == "Values" || !value.is_object())
+        {
+            continue;
+        }
+
+        const std::string childPath = path.empty() ? key : path + "/" + key;
+        const auto values = value.find("Values");
+        if (values != value.end() && values->contains("Total") && (*values)["Total"].is_number())
+        {
+            timings[childPath] += (*values)["Total"].get<double>();
+        }
+        flattenTimer(value, childPath, timings);
+    }
+}
+
+/// Append the timings of one step to the series, keeping all the series of the same length
+void appendStep(SceneMeasures& measures, const std::map<std::string, double>& stepTimings, unsigned int stepIndex)
+{
+    for (const auto& [name, duration] : stepTimings)
+    {
+        auto& series = measures.timings[name];
+        series.resize(stepIndex, 0.);
+        series.push_back(duration);
+    }
+    for (auto& [name, series] : measures.timings)
+    {
+        series.resize(stepIndex + 1, 0.);
+    }
+}
+
+} // anonymous namespace
+
+void parseTimerOutput(const std::string& timerOutput, std::map<std::string, double>& timings)
+{
+    const json output = json::parse(timerOutput, nullptr, false);
+    if (output.is_discarded() || !output.is_object())
+    {
+        return;
+    }
+
+    // the root object has a single entry, named after the step number
+    for (const auto& [stepNumber, step] : output.items())
+    {
+        SOFA_UNUSED(stepNumber);
+        flattenTimer(step, "", timings);
+    }
+}
+
+SceneMeasures runScene(const std::string& filename, unsigned int nbSteps, unsigned int nbWarmupSteps)
+{
+    SceneMeasures measures;
+    measures.scene = filename;
+
+    resetPeakMemory();
+
+    const auto initStart = std::chrono::steady_clock::now();
+    const simulation::Node::SPtr root = sofa::simulation::node::load(filename, false);
+    if (!root)
+    {
+        msg_error("SceneBenchmark") << "Cannot load the scene " << filename;
+        return measures;
+    }
+    sofa::simulation::node::initRoot(root.get());
+    measures.initDuration = elapsedMilliseconds(initStart);
+
+    AdvancedTimer::clearData(AdvancedTimer::IdTimer(animateTimerName));
+    AdvancedTimer::setEnabled(animateTimerName, true);
+    AdvancedTimer::setInterval(animateTimerName, 1);
+    AdvancedTimer::setOutputType(animateTimerName, "json");
+
+    for (unsigned int i = 0; i < nbWarmupSteps + nbSteps; ++i)
+    {
+        const auto stepStart = std::chrono::steady_clock::now();
+
+        AdvancedTimer::begin(animateTimerName);
+        sofa::simulation::node::animate(root.get());
+        const std::string timerOutput = AdvancedTimer::end(animateTimerName, root->getTime(), root->getDt());
+
+        const double stepDuration = elapsedMilliseconds(stepStart);
+
+        if (i < nbWarmupSteps)
+        {
+            continue;
+        }
+
+        std::map<std::string, double> stepTimings;
+        parseTimerOutput(timerOutput, stepTimings);
+        stepTimings[stepTimerName] = stepDuration;
+        appendStep(measures, stepTimings, i - nbWarmupSteps);
+    }
+
+    AdvancedTimer::setEnabled(animateTimerName, false);
+
+    measures.nbSteps = nbSteps;
+    measures.peakMemory = getPeakMemory();
+    measures.success = true;
+
+    sofa::simulation::node::unload(root);
+    return measures;
+}
+
+void resetPeakMemory()
+{
+#if defined(__linux__)
+    // writing 5 to clear_refs resets the peak resident set size (Linux >= 4.0)
+    std::ofstream clearRefs("/proc/self/clear_refs");
+    if (clearRefs)
+    {
+        clearRefs << "5";
+    }
+#endif
+}
+
+std::size_t getPeakMemory()
+{
+#if defined(__linux__)
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line))
+    {
+        if (line.rfind("VmHWM:", 0) == 0)
+        {
+            std::istringstream stream(line.substr(6));
+            std::size_t peak = 0;
+            stream >> peak;
+            return peak;
+        }
+    }
+#endif
+    return 0;
+}
+
+} // namespace sofa::scenebenchmarks
@@ -0,0 +1,77 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+
+#include <cstddef>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace sofa::scenebenchmarks
+{
+
+/// Name of the AdvancedTimer used to measure each animation step (the same as the one used by BatchGUI)
+inline const std::string animateTimerName = "Animate";
+
+/// Name of the timing series containing the wall-clock duration of the whole animation step
+inline const std::string stepTimerName = "step";
+
+/// Timings collected during the headless run of a scene
+struct SceneMeasures
+{
+    std::string scene;
+    unsigned int nbSteps { 0 };
+
+    /// Duration of the loading and the initialization of the scene (ms)
+    double initDuration { 0 };
+
+    /// For each timer (the step itself and each AdvancedTimer step, identified by its path in
+    /// the timer hierarchy), the duration measured at each animation step (ms).
+    /// A timer not triggered during a step is recorded with a zero duration.
+    std::map<std::string, std::vector<double> > timings;
+
+    /// Peak resident memory of the process during the run of the scene (kB). 0 if not available.
+    std::size_t peakMemory { 0 };
+
+    bool success { false };
+};
+
+/// Load and initialize the scene @p filename, then run @p nbWarmupSteps animation steps which
+/// are not measured, followed by @p nbSteps measured animation steps.
+///
+/// The steps are measured with the AdvancedTimer "Animate", in JSON output mode, exactly like
+/// BatchGUI does when runSofa is called with the options -g batch -o json. The hierarchy of the
+/// JSON output is flattened into timer paths such as "TOTAL/AnimateVisitor/Mechanical".
+SceneMeasures runScene(const std::string& filename, unsigned int nbSteps, unsigned int nbWarmupSteps);
+
+/// Flatten a JSON output of the AdvancedTimer (one animation step) into @p timings, as the
+/// total duration of each timer step (ms) indexed by its path in the timer hierarchy
+void parseTimerOutput(const std::string& timerOutput, std::map<std::string, double>& timings);
+
+/// Reset the peak resident memory of the process, when supported by the system (Linux)
+void resetPeakMemory();
+
+/// Peak resident memory of the process since its start or since the last call to resetPeakMemory (kB).
+/// Returns 0 if not supported by the system.
+std::size_t getPeakMemory();
+
+} // namespace sofa::scenebenchmarks
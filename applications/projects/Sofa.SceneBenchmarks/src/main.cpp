@@ -0,0 +1,207 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include "PerformanceReport.h"
+#include "SceneBenchmark.h"
+
+#include <sofa/component/init.h>
+#include <sofa/helper/logging/Messaging.h>
+#include <sofa/helper/system/FileRepository.h>
+#include <sofa/helper/system/FileSystem.h>
+#include <sofa/helper/system/PluginManager.h>
+#include <sofa/simulation/graph/init.h>
+
+#include <cxxopts.hpp>
+
+#include <fstream>
+#include <iostream>
+
+using sofa::helper::system::DataRepository;
+using sofa::helper::system::FileSystem;
+using namespace sofa::scenebenchmarks;
+
+namespace
+{
+
+/// Read a list of scenes, one per line. The relative paths are resolved from the directory of the list,
+/// then from the data repository.
+std::vector<std::string> readSceneList(const std::string& listFilename)
+{
+    std::vector<std::string> scenes;
+    std::ifstream list(listFilename);
+    if (!list)
+    {
+        msg_error("SceneBenchmarks") << "Cannot read the scene list " << listFilename;
+        return scenes;
+    }
+
+    const std::string listDirectory = FileSystem::getParentDirectory(listFilename);
+    std::string line;
+    while (std::getline(list, line))
+    {
+        line.erase(0, line.find_first_not_of(" \t\r"));
+        line.erase(line.find_last_not_of(" \t\r") + 1);
+        if (line.empty() || line[0] == '#')
+        {
+            continue;
+        }
+
+        std::string scene = FileSystem::cleanPath(line);
+        if (!FileSystem::isAbsolute(scene) && FileSystem::exists(FileSystem::append(listDirectory, scene)))
+        {
+            scene = FileSystem::append(listDirectory, scene);
+        }
+        scenes.push_back(scene);
+    }
+    return scenes;
+}
+
+bool writeJson(const sofa::helper::json& content, const std::string& filename)
+{
+    std::ofstream out(filename);
+    if (!out)
+    {
+        msg_error("SceneBenchmarks") << "Cannot write " << filename;
+        return false;
+    }
+    out << content.dump(4) << std::endl;
+    return true;
+}
+
+}
+
+/// Run a list of scenes headlessly for a fixed number of steps, and report the statistics of the
+/// duration of the steps, of each AdvancedTimer step, and the peak memory of each scene.
+///
+/// Record a baseline:
+///     Sofa.SceneBenchmarks --list scenes.txt --output baseline.json
+/// Compare a new build to the baseline (the exit code is 1 if a regression is detected):
+///     Sofa.SceneBenchmarks --list scenes.txt --output report.json --baseline baseline.json --comparison comparison.json
+int main(int argc, char** argv)
+{
+    unsigned int nbSteps = 100;
+    unsigned int nbWarmupSteps = 10;
+    std::string sceneList;
+    std::string outputFilename = "scene_benchmarks.json";
+    std::string baselineFilename;
+    std::string comparisonFilename = "scene_benchmarks_comparison.json";
+    std::vector<std::string> plugins;
+    std::vector<std::string> scenes;
+    ComparisonThresholds thresholds;
+
+    cxxopts::Options options("Sofa.SceneBenchmarks", "Scene-level performance regression harness");
+    options.add_options()
+        ("h,help", "Display this help message")
+        ("n,steps", "Number of measured animation steps", cxxopts::value<unsigned int>(nbSteps)->default_value("100"))
+        ("w,warmup", "Number of animation steps run before the measures", cxxopts::value<unsigned int>(nbWarmupSteps)->default_value("10"))
+        ("s,list", "File containing a list of scenes", cxxopts::value<std::string>(sceneList))
+        ("o,output", "JSON report of the measures", cxxopts::value<std::string>(outputFilename)->default_value("scene_benchmarks.json"))
+        ("b,baseline", "JSON report used as a reference", cxxopts::value<std::string>(baselineFilename))
+        ("c,comparison", "JSON result of the comparison with the baseline", cxxopts::value<std::string>(comparisonFilename)->default_value("scene_benchmarks_comparison.json"))
+        ("l,load", "Load the given plugins", cxxopts::value<std::vector<std::string>>(plugins))
+        ("tolerance", "Relative tolerance on the median", cxxopts::value<double>(thresholds.relativeTolerance)->default_value("0.1"))
+        ("p95tolerance", "Relative tolerance on the 95th percentile", cxxopts::value<double>(thresholds.p95RelativeTolerance)->default_value("0.2"))
+        ("noise", "Number of standard deviations of noise tolerated", cxxopts::value<double>(thresholds.noiseFactor)->default_value("3"))
+        ("mindelta", "Differences below this duration (ms) are ignored", cxxopts::value<double>(thresholds.minimumDelta)->default_value("0.05"))
+        ("memorytolerance", "Relative tolerance on the peak memory", cxxopts::value<double>(thresholds.memoryTolerance)->default_value("0.1"))
+        ("scenes", "Scenes to run", cxxopts::value<std::vector<std::string>>(scenes));
+    options.parse_positional("scenes");
+    options.positional_help("[scenes...]");
+
+    try
+    {
+        const auto result = options.parse(argc, argv);
+        if (result.count("help"))
+        {
+            std::cout << options.help() << std::endl;
+            return 0;
+        }
+    }
+    catch (const cxxopts::exceptions::exception& e)
+    {
+        std::cerr << e.what() << std::endl << options.help() << std::endl;
+        return 2;
+    }
+
+    sofa::simulation::graph::init();
+    sofa::component::init();
+
+    auto& pluginManager = sofa::helper::system::PluginManager::getInstance();
+    for (const auto& plugin : plugins)
+    {
+        pluginManager.loadPlugin(plugin);
+    }
+    pluginManager.init();
+
+    if (!sceneList.empty())
+    {
+        const auto listedScenes = readSceneList(sceneList);
+        scenes.insert(scenes.end(), listedScenes.begin(), listedScenes.end());
+    }
+    if (scenes.empty())
+    {
+        msg_error("SceneBenchmarks") << "No scene to run";
+        return 2;
+    }
+
+    std::vector<SceneMeasures> measures;
+    for (auto scene : scenes)
+    {
+        DataRepository.findFile(scene);
+        msg_info("SceneBenchmarks") << "Running " << nbSteps << " steps of " << scene;
+        measures.push_back(runScene(scene, nbSteps, nbWarmupSteps));
+    }
+
+    const sofa::helper::json report = makeReport(measures);
+    if (!writeJson(report, outputFilename))
+    {
+        return 2;
+    }
+
+    int exitCode = 0;
+    if (!baselineFilename.empty())
+    {
+        std::ifstream baselineFile(baselineFilename);
+        const sofa::helper::json baseline = sofa::helper::json::parse(baselineFile, nullptr, false);
+        if (!baselineFile || baseline.is_discarded())
+        {
+            msg_error("SceneBenchmarks") << "Cannot read the baseline " << baselineFilename;
+            return 2;
+        }
+
+        const sofa::helper::json comparison = compareReports(report, baseline, thresholds);
+        writeJson(comparison, comparisonFilename);
+
+        const unsigned int nbRegressions = comparison["regressions"].get<unsigned int>();
+        if (nbRegressions > 0)
+        {
+            msg_error("SceneBenchmarks") << nbRegressions << " performance regression(s) detected, see " << comparisonFilename;
+            exitCode = 1;
+        }
+        else
+        {
+            msg_info("SceneBenchmarks") << "No performance regression detected";
+        }
+    }
+
+    sofa::simulation::graph::cleanup();
+    return exitCode;
+}
@@ -0,0 +1,191 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <gtest/gtest.h>
+
+#include "PerformanceReport.h"
+
+namespace
+{
+
+using sofa::helper::json;
+using namespace sofa::scenebenchmarks;
+
+TEST(PerformanceReport_test, statisticsOfOddNumberOfSamples)
+{
+    const Statistics statistics = computeStatistics({ 5, 1, 3, 2, 4 });
+
+    EXPECT_EQ(statistics.count, 5u);
+    EXPECT_DOUBLE_EQ(statistics.min, 1);
+    EXPECT_DOUBLE_EQ(statistics.max, 5);
+    EXPECT_DOUBLE_EQ(statistics.mean, 3);
+    EXPECT_DOUBLE_EQ(statistics.median, 3);
+    EXPECT_DOUBLE_EQ(statistics.p95, 4.8); // interpolated between 4 and 5
+    EXPECT_DOUBLE_EQ(statistics.mad, 1); // deviations 2 2 0 1 1
+}
+
+TEST(PerformanceReport_test, statisticsOfEvenNumberOfSamples)
+{
+    const Statistics statistics = computeStatistics({ 4, 2, 1, 3 });
+
+    EXPECT_EQ(statistics.count, 4u);
+    EXPECT_DOUBLE_EQ(statistics.mean, 2.5);
+    EXPECT_DOUBLE_EQ(statistics.median, 2.5);
+    EXPECT_DOUBLE_EQ(statistics.p95, 3.85);
+    EXPECT_DOUBLE_EQ(statistics.mad, 1); // deviations 1.5 0.5 0.5 1.5
+}
+
+TEST(PerformanceReport_test, statisticsAreNotSensitiveToOutliers)
+{
+    const Statistics statistics = computeStatistics({ 1, 1, 1, 1, 100 });
+
+    EXPECT_DOUBLE_EQ(statistics.median, 1);
+    EXPECT_DOUBLE_EQ(statistics.mad, 0);
+    EXPECT_DOUBLE_EQ(statistics.max, 100);
+}
+
+TEST(PerformanceReport_test, statisticsOfNoSamples)
+{
+    const Statistics statistics = computeStatistics({});
+
+    EXPECT_EQ(statistics.count, 0u);
+    EXPECT_DOUBLE_EQ(statistics.median, 0);
+}
+
+TEST(PerformanceReport_test, report)
+{
+    SceneMeasures measures;
+    measures.scene = "scene.scn";
+    measures.nbSteps = 3;
+    measures.peakMemory = 1000;
+    measures.success = true;
+    measures.timings[stepTimerName] = { 3, 1, 2 };
+
+    const json report = makeReport({ measures });
+
+    ASSERT_EQ(report["scenes"].size(), 1u);
+    const json& scene = report["scenes"][0];
+    EXPECT_EQ(scene["scene"].get<std::string>(), "scene.scn");
+    EXPECT_EQ(scene["steps"].get<unsigned int>(), 3u);
+    EXPECT_EQ(scene["peakMemory"].get<std::size_t>(), 1000u);
+    EXPECT_EQ(scene["timers"][stepTimerName]["count"].get<std::size_t>(), 3u);
+    EXPECT_DOUBLE_EQ(scene["timers"][stepTimerName]["median"].get<double>(), 2);
+    EXPECT_DOUBLE_EQ(scene["timers"][stepTimerName]["min"].get<double>(), 1);
+}
+
+/// Report of a single scene with a single timer
+json makeSceneReport(double median, double p95, double mad, std::size_t peakMemory = 0)
+{
+    json scene;
+    scene["scene"] = "scene.scn";
+    scene["success"] = true;
+    scene["peakMemory"] = peakMemory;
+    scene["timers"] = json::object();
+    scene["timers"]["step"] = { {"median", median}, {"p95", p95}, {"mad", mad} };
+
+    json report;
+    report["scenes"] = json::array({ scene });
+    return report;
+}
+
+std::string compareStep(const json& report, const json& baseline)
+{
+    const json comparison = compareReports(report, baseline, ComparisonThresholds());
+    return comparison["scenes"][0]["timers"]["step"]["status"].get<std::string>();
+}
+
+TEST(PerformanceReport_test, medianRelativeTolerance)
+{
+    const json baseline = makeSceneReport(10, 12, 0);
+
+    // the default relative tolerance of the median is 10%
+    EXPECT_EQ(compareStep(makeSceneReport(10.5, 12, 0), baseline), "unchanged");
+    EXPECT_EQ(compareStep(makeSceneReport(11.5, 12, 0), baseline), "regression");
+    EXPECT_EQ(compareStep(makeSceneReport(8.5, 12, 0), baseline), "improvement");
+}
+
+TEST(PerformanceReport_test, p95RelativeTolerance)
+{
+    const json baseline = makeSceneReport(10, 20, 0);
+
+    // the default relative tolerance of the 95th percentile is 20%
+    EXPECT_EQ(compareStep(makeSceneReport(10, 23, 0), baseline), "unchanged");
+    EXPECT_EQ(compareStep(makeSceneReport(10, 25, 0), baseline), "regression");
+
+    // a lower 95th percentile alone is not an improvement
+    EXPECT_EQ(compareStep(makeSceneReport(10, 15, 0), baseline), "unchanged");
+}
+
+TEST(PerformanceReport_test, noiseTolerance)
+{
+    // 3 standard deviations, estimated from the largest MAD: 3 * 1.4826 * 1 = 4.45
+    EXPECT_EQ(compareStep(makeSceneReport(14, 14, 1), makeSceneReport(10, 14, 0)), "unchanged");
+    EXPECT_EQ(compareStep(makeSceneReport(14, 14, 0), makeSceneReport(10, 14, 1)), "unchanged");
+    EXPECT_EQ(compareStep(makeSceneReport(15, 15, 1), makeSceneReport(10, 15, 0)), "regression");
+}
+
+TEST(PerformanceReport_test, minimumDelta)
+{
+    // 40% slower, but only 0.04ms
+    EXPECT_EQ(compareStep(makeSceneReport(0.14, 0.14, 0), makeSceneReport(0.1, 0.1, 0)), "unchanged");
+    EXPECT_EQ(compareStep(makeSceneReport(0.2, 0.2, 0), makeSceneReport(0.1, 0.1, 0)), "regression");
+}
+
+TEST(PerformanceReport_test, regressionsAreCounted)
+{
+    json report = makeSceneReport(20, 20, 0, 1500);
+    report["scenes"][0]["timers"]["newTimer"] = { {"median", 1.}, {"p95", 1.}, {"mad", 0.} };
+
+    json failedScene;
+    failedScene["scene"] = "failed.scn";
+    failedScene["success"] = false;
+    report["scenes"].push_back(failedScene);
+
+    json newScene;
+    newScene["scene"] = "new.scn";
+    newScene["success"] = true;
+    report["scenes"].push_back(newScene);
+
+    const json comparison = compareReports(report, makeSceneReport(10, 10, 0, 1000), ComparisonThresholds());
+
+    ASSERT_EQ(comparison["scenes"].size(), 3u);
+    const json& scene = comparison["scenes"][0];
+    EXPECT_EQ(scene["status"].get<std::string>(), "regression");
+    EXPECT_EQ(scene["timers"]["step"]["status"].get<std::string>(), "regression");
+    EXPECT_EQ(scene["timers"]["newTimer"]["status"].get<std::string>(), "new");
+    EXPECT_EQ(scene["peakMemory"]["status"].get<std::string>(), "regression");
+    EXPECT_EQ(comparison["scenes"][1]["status"].get<std::string>(), "failed");
+    EXPECT_EQ(comparison["scenes"][2]["status"].get<std::string>(), "new");
+
+    // the step timer, the peak memory and the failed scene
+    EXPECT_EQ(comparison["regressions"].get<unsigned int>(), 3u);
+}
+
+TEST(PerformanceReport_test, identicalReports)
+{
+    const json report = makeSceneReport(10, 12, 0.5, 1000);
+    const json comparison = compareReports(report, report, ComparisonThresholds());
+
+    EXPECT_EQ(comparison["scenes"][0]["status"].get<std::string>(), "unchanged");
+    EXPECT_EQ(comparison["regressions"].get<unsigned int>(), 0u);
+}
+
+} // namespace
@@ -57,6 +57,7 @@ typedef void* ID;           ///< Type used for IDs
 #define API_PLUGIN_MISSING_SYMBOL -21   ///< Error while loading SOFA plugin. Plugin library has missing symbol such as: initExternalModule
 #define API_PLUGIN_FILE_NOT_FOUND -22   ///< Error while loading SOFA plugin. Plugin library file not found
 #define API_PLUGIN_LOADING_FAILED -23   ///< Error while loading SOFA plugin. Plugin library loading fail for another unknown reason.
+#define API_CHECKPOINT_FAILED -30       ///< Error while saving or restoring a simulation checkpoint.
 
 /// Internal implementation sub-class
 class SofaPhysicsSimulation;
@@ -98,6 +99,12 @@ public:
     /// Reset the simulation to its initial state
     void reset();
 
+    /// Save the whole simulation state in the binary checkpoint file @param filename. Return error code.
+    int saveCheckpoint(const char* filename);
+
+    /// Restore the simulation state from the binary checkpoint file @param filename, written from the same scene. Return error code.
+    int loadCheckpoint(const char* filename);
+
     /// Send an event to the simulation for custom controls
     /// (such as switching active instrument)
     void sendValue(const char* name, double value);
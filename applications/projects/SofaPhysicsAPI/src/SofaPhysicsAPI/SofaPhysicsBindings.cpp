@@ -148,6 +148,28 @@ void sofaPhysicsAPI_reset(void* api_ptr)
 }
 
 
+int sofaPhysicsAPI_saveCheckpoint(void* api_ptr, const char* filename)
+{
+    SofaPhysicsAPI* api = (SofaPhysicsAPI*)api_ptr;
+    if (api) {
+        return api->saveCheckpoint(filename);
+    }
+    else
+        return API_NULL;
+}
+
+
+int sofaPhysicsAPI_loadCheckpoint(void* api_ptr, const char* filename)
+{
+    SofaPhysicsAPI* api = (SofaPhysicsAPI*)api_ptr;
+    if (api) {
+        return api->loadCheckpoint(filename);
+    }
+    else
+        return API_NULL;
+}
+
+
 
 float sofaPhysicsAPI_time(void* api_ptr)
 {
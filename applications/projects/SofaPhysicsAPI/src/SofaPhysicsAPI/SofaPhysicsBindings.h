@@ -59,6 +59,8 @@ EXPORT_API void sofaPhysicsAPI_start(void* api_ptr); ///< Method to start simula
 EXPORT_API void sofaPhysicsAPI_stop(void* api_ptr); ///< Method to stop simulation
 EXPORT_API void sofaPhysicsAPI_step(void* api_ptr); ///< Method to perform a single simulation step
 EXPORT_API void sofaPhysicsAPI_reset(void* api_ptr); ///< Method to reset current simulation
+EXPORT_API int sofaPhysicsAPI_saveCheckpoint(void* api_ptr, const char* filename); ///< Method to save the current simulation state in the binary checkpoint file @param filename. Return error code.
+EXPORT_API int sofaPhysicsAPI_loadCheckpoint(void* api_ptr, const char* filename); ///< Method to restore the simulation state from the binary checkpoint file @param filename. Return error code.
 
 EXPORT_API float sofaPhysicsAPI_time(void* api_ptr); ///< Getter to the current simulation time
 EXPORT_API float sofaPhysicsAPI_timeStep(void* api_ptr); ///< Getter to the current simulation time stepping
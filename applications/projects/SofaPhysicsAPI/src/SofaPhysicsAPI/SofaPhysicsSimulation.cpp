@@ -53,6 +53,7 @@
 #include <sofa/simpleapi/SimpleApi.h>
 
 #include <sofa/component/init.h>
+#include <sofa/component/playback/SimulationCheckpoint.h>
 
 SofaPhysicsAPI::SofaPhysicsAPI(bool useGUI, int GUIFramerate)
     : impl(new SofaPhysicsSimulation(useGUI, GUIFramerate))
@@ -148,6 +149,16 @@ void SofaPhysicsAPI::reset()
     impl->reset();
 }
 
+int SofaPhysicsAPI::saveCheckpoint(const char* filename)
+{
+    return impl->saveCheckpoint(filename);
+}
+
+int SofaPhysicsAPI::loadCheckpoint(const char* filename)
+{
+    return impl->loadCheckpoint(filename);
+}
+
 void SofaPhysicsAPI::resetView()
 {
     impl->resetView();
@@ -608,6 +619,29 @@ void SofaPhysicsSimulation::reset()
     }
 }
 
+int SofaPhysicsSimulation::saveCheckpoint(const char* filename)
+{
+    if (!getScene())
+        return API_SCENE_NULL;
+
+    if (!sofa::component::playback::saveCheckpoint(getScene(), filename))
+        return API_CHECKPOINT_FAILED;
+
+    return API_SUCCESS;
+}
+
+int SofaPhysicsSimulation::loadCheckpoint(const char* filename)
+{
+    if (!getScene())
+        return API_SCENE_NULL;
+
+    if (!sofa::component::playback::loadCheckpoint(getScene(), filename))
+        return API_CHECKPOINT_FAILED;
+
+    this->update();
+    return API_SUCCESS;
+}
+
 void SofaPhysicsSimulation::resetView()
 {
     if (getScene() && currentCamera)
@@ -63,6 +63,10 @@ public:
     void stop();
     void step();
     void reset();
+    /// Save the whole simulation state in the binary checkpoint file @param filename. Return error code.
+    int saveCheckpoint(const char* filename);
+    /// Restore the simulation state from the binary checkpoint file @param filename. Return error code.
+    int loadCheckpoint(const char* filename);
     void resetView();
     void sendValue(const char* name, double value);
     void drawGL();